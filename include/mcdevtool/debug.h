@@ -15,6 +15,8 @@
 
 #include <nlohmann/json_fwd.hpp>
 
+#include "reload.h"
+
 namespace MCDevTool::Debug {
     inline constexpr uint16_t IPC_JSON_REQUEST_TYPE  = 100;
     inline constexpr uint16_t IPC_JSON_RESPONSE_TYPE = 101;
@@ -119,6 +121,8 @@ namespace MCDevTool::Debug {
         void setProcessId(int processId);
         void setModDirs(const std::vector<std::filesystem::path>& modDirs);
         void setModDirs(std::vector<std::filesystem::path>&& modDirs);
+        // 需在 start() 之前设置
+        void setWatchOptions(HotReload::WatchOptions options);
 
         // 热更新触发（在文件修改后重新进入前台时调用）
         virtual void onHotReloadTriggered();
@@ -138,6 +142,7 @@ namespace MCDevTool::Debug {
         std::optional<std::thread>         processWatcherThread;
         std::optional<std::thread>         fileWatcherThread;
         std::vector<std::filesystem::path> mModDirs;
+        HotReload::WatchOptions            mWatchOptions;
         std::atomic<bool>                  mStopFlag = false;
     };
 } // namespace MCDevTool::Debug
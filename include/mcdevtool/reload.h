@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <optional>
 #include <atomic>
+#include <string>
 
 namespace MCDevTool::HotReload {
     // 文件过滤谓词。注意：它在防抖之前对每条系统通知调用，
@@ -14,10 +15,48 @@ namespace MCDevTool::HotReload {
     // 内容校验、诊断输出等带副作用的逻辑应放在 onFileChanged 中——那里已经过防抖。
     using FileWatchPredicate = std::function<bool(const std::filesystem::path&)>;
 
+    // 监听排除规则，路径均相对于监听根目录并使用 '/' 分隔：
+    // - 不含 '/' 的模式匹配任意层级的文件/目录名，如 ".git"、"node_modules"、"*.tmp"；
+    // - 含 '/' 的模式锚定在根目录，如 "build/**"、"assets/cache"；
+    // - '*' 与 '?' 不跨越 '/'，'**' 可跨越多级目录。
+    // 目录一旦被排除，其整棵子树都被排除。
+    class WatchExcludeFilter {
+    public:
+        WatchExcludeFilter() = default;
+        explicit WatchExcludeFilter(const std::vector<std::string>& globs);
+
+        [[nodiscard]] bool empty() const { return mNameGlobs.empty() && mAnchoredGlobs.empty(); }
+
+        // relativePath 为相对监听根目录的通用路径
+        [[nodiscard]] bool isExcluded(std::string_view relativePath) const;
+        [[nodiscard]] bool isExcluded(const std::filesystem::path& root, const std::filesystem::path& path) const;
+
+    private:
+        std::vector<std::string> mNameGlobs;
+        std::vector<std::string> mAnchoredGlobs;
+    };
+
+    struct WatchOptions {
+        // 排除规则在注册监听时生效：Linux 下被排除的目录不会注册 inotify 监听；
+        // Windows 的递归 ReadDirectoryChangesW 无法剪枝子树，只能在谓词之前于用户态丢弃。
+        std::vector<std::string> excludeGlobs;
+        // 测试注入点：处理某监听根目录的一批通知前调用，返回 true 时按通知队列溢出处理（对该根目录做对比重扫）
+        std::function<bool(const std::filesystem::path& root)> overflowProbe;
+    };
+
+    std::optional<std::thread> watchAndReloadFiles(
+        const std::vector<std::filesystem::path>&                modDirs,
+        const std::function<void(const std::filesystem::path&)>& onFileChanged,
+        FileWatchPredicate                                       shouldWatchFile,
+        std::atomic<bool>*                                       stopFlag = nullptr
+    );
+
+    // 通知缓冲区溢出（事件丢失）时，仅对溢出的监听根目录做一次 mtime 对比重扫，补发被修改的文件
     std::optional<std::thread> watchAndReloadFiles(
         const std::vector<std::filesystem::path>&                modDirs,
         const std::function<void(const std::filesystem::path&)>& onFileChanged,
         FileWatchPredicate                                       shouldWatchFile,
+        const WatchOptions&                                      options,
         std::atomic<bool>*                                       stopFlag = nullptr
     );
 
@@ -64,10 +64,10 @@ namespace mcp {
                     return false;
                 }
 
-                int id = id_.load(std::memory_order_relaxed);
-
+                // Wait for pending data rather than for the next send, so events queued while the previous batch was
+                // being written are not left behind.
                 bool result = cv_.wait_for(lk, timeout, [&] {
-                    return cid_.load(std::memory_order_relaxed) == id || closed_.load(std::memory_order_acquire);
+                    return !message_.empty() || closed_.load(std::memory_order_acquire);
                 });
 
                 if (closed_.load(std::memory_order_acquire)) {
@@ -81,6 +81,7 @@ namespace mcp {
                 // Only copy the message if there is one
                 if (!message_.empty()) {
                     message_copy.swap(message_);
+                    total_pending_bytes_.fetch_sub(message_copy.size(), std::memory_order_relaxed);
                 } else {
                     return true; // No message but condition satisfied
                 }
@@ -112,13 +113,19 @@ namespace mcp {
                     return false;
                 }
 
-                // Efficiently set the message and allocate space as needed
-                if (message.size() > message_.capacity()) {
-                    message_.reserve(message.size() + 64); // Pre-allocate extra space to avoid frequent reallocations
+                // Events accumulate until the stream writer takes them; overwriting would silently lose a message
+                // whenever two arrive before the writer wakes up. A reader that stops draining hits the cap instead,
+                // and the process-wide cap keeps many such sessions from adding up.
+                if (message_.size() + message.size() > max_pending_bytes) {
+                    return false;
                 }
-                message_ = message;
+                if (total_pending_bytes_.fetch_add(message.size(), std::memory_order_relaxed) + message.size()
+                    > max_total_pending_bytes) {
+                    total_pending_bytes_.fetch_sub(message.size(), std::memory_order_relaxed);
+                    return false;
+                }
+                message_ += message;
 
-                cid_.store(id_.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
                 cv_.notify_one(); // Notify waiting threads
                 return true;
             } catch (...) {
@@ -133,6 +140,10 @@ namespace mcp {
             }
 
             try {
+                // Nobody reads a closed dispatcher; give its backlog back to the process-wide budget.
+                std::lock_guard<std::mutex> lk(m_);
+                total_pending_bytes_.fetch_sub(message_.size(), std::memory_order_relaxed);
+                std::string().swap(message_);
                 cv_.notify_all();
             } catch (...) {
                 // Ignore exceptions
@@ -154,13 +165,14 @@ namespace mcp {
         }
 
     private:
-        mutable std::mutex                    m_;
-        std::condition_variable               cv_;
-        std::atomic<int>                      id_{0};
-        std::atomic<int>                      cid_{-1};
-        std::string                           message_;
-        std::atomic<bool>                     closed_{false};
-        std::chrono::steady_clock::time_point last_activity_{std::chrono::steady_clock::now()};
+        mutable std::mutex                     m_;
+        std::condition_variable                cv_;
+        static constexpr std::size_t           max_pending_bytes       = 1024 * 1024;     // Per session.
+        static constexpr std::size_t           max_total_pending_bytes = 8 * 1024 * 1024; // All sessions together.
+        static inline std::atomic<std::size_t> total_pending_bytes_{0};
+        std::string                            message_;
+        std::atomic<bool>                      closed_{false};
+        std::chrono::steady_clock::time_point  last_activity_{std::chrono::steady_clock::now()};
     };
 
     /**
@@ -319,8 +331,9 @@ namespace mcp {
          * @brief Send a request (or notification) to a client
          * @param session_id The session ID of the client
          * @param req The request to send
+         * @return false if the session does not exist, is closed, or has too much undelivered data
          */
-        void send_request(const std::string& session_id, const request& req);
+        bool send_request(const std::string& session_id, const request& req);
 
         /**
          * @brief Set mount point for server
@@ -402,7 +415,7 @@ namespace mcp {
         void handle_jsonrpc(const httplib::Request& req, httplib::Response& res);
 
         // Send a JSON-RPC message to a client
-        void send_jsonrpc(const std::string& session_id, const json& message);
+        bool send_jsonrpc(const std::string& session_id, const json& message);
 
         // Process a JSON-RPC request
         json process_request(const request& req, const std::string& session_id);
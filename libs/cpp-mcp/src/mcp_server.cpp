@@ -853,11 +853,11 @@ namespace mcp {
         return response::create_success(req.id, result).to_json();
     }
 
-    void server::send_jsonrpc(const std::string& session_id, const json& message) {
+    bool server::send_jsonrpc(const std::string& session_id, const json& message) {
         // Check if session ID is valid
         if (session_id.empty()) {
             LOG_WARNING("Cannot send message to empty session_id");
-            return;
+            return false;
         }
 
         // Get session dispatcher
@@ -867,7 +867,7 @@ namespace mcp {
             auto                        it = session_dispatchers_.find(session_id);
             if (it == session_dispatchers_.end()) {
                 LOG_ERROR("Session not found: ", session_id);
-                return;
+                return false;
             }
             dispatcher = it->second;
         }
@@ -875,7 +875,7 @@ namespace mcp {
         // Confirm dispatcher is still valid
         if (!dispatcher || dispatcher->is_closed()) {
             LOG_WARNING("Cannot send to closed session: ", session_id);
-            return;
+            return false;
         }
 
         // Send message
@@ -886,10 +886,11 @@ namespace mcp {
         if (!result) {
             LOG_ERROR("Failed to send message to session: ", session_id);
         }
+        return result;
     }
 
-    void server::send_request(const std::string& session_id, const request& req) {
-        send_jsonrpc(session_id, req.to_json());
+    bool server::send_request(const std::string& session_id, const request& req) {
+        return send_jsonrpc(session_id, req.to_json());
     }
 
     bool server::is_session_initialized(const std::string& session_id) const {
@@ -1186,8 +1187,18 @@ namespace mcp {
 
                     bool result = dispatcher->wait_event(&sink);
                     if (!result) {
-                        LOG_WARNING("Streamable HTTP: SSE stream closed for session ", session_id);
-                        return false;
+                        // A quiet stream times out regularly; only a closed session or a failed write ends it.
+                        if (dispatcher->is_closed() || !running_) {
+                            LOG_WARNING("Streamable HTTP: SSE stream closed for session ", session_id);
+                            return false;
+                        }
+                        // SSE comment as a heartbeat: keeps client read timeouts from firing and finds dead peers.
+                        static constexpr char heartbeat[] = ": keepalive\r\n\r\n";
+                        if (!sink.write(heartbeat, sizeof(heartbeat) - 1)) {
+                            dispatcher->close();
+                            return false;
+                        }
+                        return true;
                     }
 
                     dispatcher->update_activity();
@@ -625,6 +625,7 @@ namespace MCDevTool::Debug {
             [this](const std::filesystem::path& path) {
                 return this->shouldWatchFile(path);
             },
+            mWatchOptions,
             &mStopFlag
         );
         if (!fileWatcherThread.has_value()) {
@@ -684,6 +685,10 @@ namespace MCDevTool::Debug {
         mModDirs = std::move(modDirs);
     }
 
+    void HotReloadWatcherTask::setWatchOptions(HotReload::WatchOptions options) {
+        mWatchOptions = std::move(options);
+    }
+
     void HotReloadWatcherTask::onHotReloadTriggered() {}
 
     void HotReloadWatcherTask::onFileChanged(const std::filesystem::path& filePath) {}
@@ -1,12 +1,20 @@
 #include "mcdevtool/reload.h"
+#include "mcdevtool/utils.h"
 
 #ifdef _WIN32
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <iostream>
+#include <string>
 #include <thread>
 #include <atomic>
 #include <vector>
@@ -19,9 +27,221 @@
 
 namespace MCDevTool::HotReload {
 
+    namespace fs = std::filesystem;
+
+    // ------------------------------------------------------------
+    // 排除规则
+
+    namespace {
+        bool globCharEquals(char lhs, char rhs) {
 #ifdef _WIN32
+            // Windows 文件系统大小写不敏感
+            const auto lower = [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+            return lower(lhs) == lower(rhs);
+#else
+            return lhs == rhs;
+#endif
+        }
 
-    namespace fs = std::filesystem;
+        bool globMatch(std::string_view pattern, std::string_view text) {
+            if (pattern.empty()) {
+                return text.empty();
+            }
+            if (pattern.starts_with("**")) {
+                const auto rest = pattern.substr(2);
+                // "**/" 同样匹配零级目录
+                if (rest.starts_with('/') && globMatch(rest.substr(1), text)) {
+                    return true;
+                }
+                for (size_t i = 0; i <= text.size(); ++i) {
+                    if (globMatch(rest, text.substr(i))) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            if (pattern.front() == '*') {
+                const auto rest = pattern.substr(1);
+                for (size_t i = 0; i <= text.size(); ++i) {
+                    if (globMatch(rest, text.substr(i))) {
+                        return true;
+                    }
+                    if (i < text.size() && text[i] == '/') {
+                        break;
+                    }
+                }
+                return false;
+            }
+            if (text.empty()) {
+                return false;
+            }
+            const bool matched = pattern.front() == '?' ? text.front() != '/' : globCharEquals(pattern.front(), text.front());
+            return matched && globMatch(pattern.substr(1), text.substr(1));
+        }
+    } // namespace
+
+    WatchExcludeFilter::WatchExcludeFilter(const std::vector<std::string>& globs) {
+        for (auto glob : globs) {
+            std::replace(glob.begin(), glob.end(), '\\', '/');
+            while (glob.starts_with("./")) {
+                glob.erase(0, 2);
+            }
+            while (!glob.empty() && glob.front() == '/') {
+                glob.erase(0, 1);
+            }
+            while (!glob.empty() && glob.back() == '/') {
+                glob.pop_back();
+            }
+            if (glob.empty()) {
+                continue;
+            }
+            if (glob.find('/') == std::string::npos) {
+                mNameGlobs.push_back(std::move(glob));
+            } else {
+                mAnchoredGlobs.push_back(std::move(glob));
+            }
+        }
+    }
+
+    bool WatchExcludeFilter::isExcluded(std::string_view relativePath) const {
+        size_t start = 0;
+        while (start <= relativePath.size()) {
+            size_t end = relativePath.find('/', start);
+            if (end == std::string_view::npos) {
+                end = relativePath.size();
+            }
+            const auto name = relativePath.substr(start, end - start);
+            if (!name.empty() && name != ".") {
+                for (const auto& glob : mNameGlobs) {
+                    if (globMatch(glob, name)) {
+                        return true;
+                    }
+                }
+                // 锚定规则对每一级前缀求值，使被排除目录下的整棵子树一并排除
+                const auto prefix = relativePath.substr(0, end);
+                for (const auto& glob : mAnchoredGlobs) {
+                    if (globMatch(glob, prefix)) {
+                        return true;
+                    }
+                }
+            }
+            start = end + 1;
+        }
+        return false;
+    }
+
+    bool WatchExcludeFilter::isExcluded(const fs::path& root, const fs::path& path) const {
+        if (empty()) {
+            return false;
+        }
+        const auto relative = path.lexically_relative(root);
+        if (relative.empty() || *relative.begin() == "..") {
+            return false;
+        }
+        return isExcluded(Utils::pathToGenericUtf8(relative));
+    }
+
+#if defined(_WIN32) || defined(__linux__)
+
+    // 防抖时间间隔（毫秒）
+    static constexpr int DEBOUNCE_MS = 100;
+
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    namespace {
+        // 监听根目录下被谓词接受的文件的最后写入时间，用于事件丢失后的对比重扫
+        using FileSnapshot = std::unordered_map<fs::path::string_type, fs::file_time_type>;
+
+        // 防抖后回调；仅在监听线程内使用
+        class ChangeDispatcher {
+        public:
+            explicit ChangeDispatcher(const std::function<void(const fs::path&)>& onFileChanged)
+            : mOnFileChanged(onFileChanged) {}
+
+            void dispatch(const fs::path& path, std::chrono::steady_clock::time_point now) {
+                auto [it, inserted] = mLastTriggerTime.try_emplace(path.native(), now);
+                if (!inserted) {
+                    if (now - it->second < std::chrono::milliseconds(DEBOUNCE_MS)) {
+                        return;
+                    }
+                    it->second = now;
+                }
+                try {
+                    mOnFileChanged(path);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error in onFileChanged callback: " << e.what() << std::endl;
+                }
+            }
+
+        private:
+            std::function<void(const fs::path&)>                                              mOnFileChanged;
+            std::unordered_map<fs::path::string_type, std::chrono::steady_clock::time_point> mLastTriggerTime;
+        };
+
+        void recordWriteTime(FileSnapshot& snapshot, const fs::path& path) {
+            std::error_code ec;
+            const auto      writeTime = fs::last_write_time(path, ec);
+            if (!ec) {
+                snapshot[path.native()] = writeTime;
+            }
+        }
+
+        // 从 start 开始遍历 root 的子树（剪枝排除目录）并刷新快照；changed 非空时收集新增或写入时间变化的文件
+        void scanWatchTree(
+            const fs::path&           root,
+            const fs::path&           start,
+            const WatchExcludeFilter& exclude,
+            const FileWatchPredicate& shouldWatchFile,
+            FileSnapshot&             snapshot,
+            std::vector<fs::path>*    changed
+        ) {
+            std::error_code                ec;
+            fs::recursive_directory_iterator it(start, fs::directory_options::skip_permission_denied, ec);
+            for (const fs::recursive_directory_iterator end; !ec && it != end; it.increment(ec)) {
+                std::error_code statusEc;
+                const auto&     entry = *it;
+                if (exclude.isExcluded(root, entry.path())) {
+                    it.disable_recursion_pending();
+                    continue;
+                }
+                if (!entry.is_regular_file(statusEc) || (shouldWatchFile && !shouldWatchFile(entry.path()))) {
+                    continue;
+                }
+                const auto writeTime = entry.last_write_time(statusEc);
+                if (statusEc) {
+                    continue;
+                }
+                auto [slot, inserted] = snapshot.try_emplace(entry.path().native(), writeTime);
+                if (!inserted && slot->second == writeTime) {
+                    continue;
+                }
+                slot->second = writeTime;
+                if (changed) {
+                    changed->push_back(entry.path());
+                }
+            }
+        }
+
+        void rescanWatchTree(
+            const fs::path&           root,
+            const fs::path&           start,
+            const WatchExcludeFilter& exclude,
+            const FileWatchPredicate& shouldWatchFile,
+            FileSnapshot&             snapshot,
+            ChangeDispatcher&         dispatcher
+        ) {
+            std::vector<fs::path> changed;
+            scanWatchTree(root, start, exclude, shouldWatchFile, snapshot, &changed);
+            const auto now = std::chrono::steady_clock::now();
+            for (const auto& path : changed) {
+                dispatcher.dispatch(path, now);
+            }
+        }
+    } // namespace
+
+#endif
+
+#ifdef _WIN32
 
     struct WatchItem {
         fs::path          dir;
@@ -29,6 +249,7 @@ namespace MCDevTool::HotReload {
         OVERLAPPED        ov{};
         std::vector<BYTE> buffer;
         HANDLE            eventHandle = nullptr;
+        FileSnapshot      snapshot;
 
         // 禁止拷贝，但允许移动
         WatchItem()                            = default;
@@ -39,7 +260,8 @@ namespace MCDevTool::HotReload {
           hDir(std::exchange(other.hDir, INVALID_HANDLE_VALUE)),
           ov(other.ov),
           buffer(std::move(other.buffer)),
-          eventHandle(std::exchange(other.eventHandle, nullptr)) {
+          eventHandle(std::exchange(other.eventHandle, nullptr)),
+          snapshot(std::move(other.snapshot)) {
             // 重置 ov 的 hEvent 指向自己
             ov.hEvent = eventHandle;
         }
@@ -50,6 +272,7 @@ namespace MCDevTool::HotReload {
                 ov          = other.ov;
                 buffer      = std::move(other.buffer);
                 eventHandle = std::exchange(other.eventHandle, nullptr);
+                snapshot    = std::move(other.snapshot);
                 ov.hEvent   = eventHandle;
             }
             return *this;
@@ -59,11 +282,6 @@ namespace MCDevTool::HotReload {
     // 仅监听文件内容修改，不监听新增/删除/重命名
     static constexpr DWORD WATCH_FILTER = FILE_NOTIFY_CHANGE_LAST_WRITE;
 
-    // 防抖时间间隔（毫秒）
-    static constexpr int DEBOUNCE_MS = 100;
-
-    static constexpr DWORD BUFFER_SIZE = 64 * 1024;
-
     // ------------------------------------------------------------
 
     static bool startWatch(WatchItem& item) {
@@ -86,6 +304,7 @@ namespace MCDevTool::HotReload {
         const std::vector<fs::path>&                modDirs,
         const std::function<void(const fs::path&)>& onFileChanged,
         FileWatchPredicate                          shouldWatchFile,
+        const WatchOptions&                         options,
         std::atomic<bool>*                          stopFlag
     ) {
         if (modDirs.empty()) {
@@ -136,7 +355,12 @@ namespace MCDevTool::HotReload {
         }
 
         // 后台监听线程
-        return std::thread([items = std::move(items), onFileChanged, shouldWatchFile = std::move(shouldWatchFile), stopFlag]() mutable {
+        return std::thread([items = std::move(items),
+                            onFileChanged,
+                            shouldWatchFile = std::move(shouldWatchFile),
+                            exclude         = WatchExcludeFilter(options.excludeGlobs),
+                            overflowProbe   = options.overflowProbe,
+                            stopFlag]() mutable {
             std::vector<HANDLE> waitHandles;
             waitHandles.reserve(items.size() + 1);
 
@@ -160,9 +384,13 @@ namespace MCDevTool::HotReload {
                 }
             }
 
+            // 先投递监听再建立快照，快照期间的修改最多被重复通知一次（由防抖吸收）
+            for (auto& i : items) {
+                scanWatchTree(i.dir, i.dir, exclude, shouldWatchFile, i.snapshot, nullptr);
+            }
+
             // 防抖：记录每个文件的最后触发时间
-            std::unordered_map<std::wstring, std::chrono::steady_clock::time_point> lastTriggerTime;
-            std::mutex                                                              debounceMapMutex;
+            ChangeDispatcher dispatcher(onFileChanged);
 
             // 如果有 stopFlag，启动一个辅助线程来检测并触发 stopEvent
             std::thread stopChecker;
@@ -177,6 +405,9 @@ namespace MCDevTool::HotReload {
 
             const DWORD itemStartIndex = stopEvent ? 1 : 0;
 
+            std::vector<BYTE> pending;
+            pending.reserve(BUFFER_SIZE);
+
             while (true) {
                 DWORD result =
                     WaitForMultipleObjects(static_cast<DWORD>(waitHandles.size()), waitHandles.data(), FALSE, INFINITE);
@@ -201,12 +432,32 @@ namespace MCDevTool::HotReload {
 
                 auto& item = items[itemIndex];
 
-                DWORD bytes = 0;
-                if (!GetOverlappedResult(item.hDir, &item.ov, &bytes, FALSE)) {
+                // 通知缓冲区溢出时 ReadDirectoryChangesW 丢弃全部内容并返回 0 字节（或 ERROR_NOTIFY_ENUM_DIR），
+                // 此时缓冲区内容不可解析，只能对该监听根目录做对比重扫
+                DWORD      bytes      = 0;
+                const bool completed  = GetOverlappedResult(item.hDir, &item.ov, &bytes, FALSE);
+                const bool overflowed = (completed ? bytes == 0 : GetLastError() == ERROR_NOTIFY_ENUM_DIR)
+                                     || (overflowProbe && overflowProbe(item.dir));
+
+                // 先复制本批通知并重新投递监听，再处理通知，缩短无监听的窗口
+                pending.clear();
+                if (completed && !overflowed) {
+                    pending.assign(item.buffer.begin(), item.buffer.begin() + bytes);
+                }
+                ZeroMemory(&item.ov, sizeof(item.ov));
+                item.ov.hEvent = item.eventHandle;
+                startWatch(item);
+
+                if (overflowed) {
+                    std::cerr << "[HotReload] Change notifications overflowed, rescanning: " << item.dir << std::endl;
+                    rescanWatchTree(item.dir, item.dir, exclude, shouldWatchFile, item.snapshot, dispatcher);
+                    continue;
+                }
+                if (pending.empty()) {
                     continue;
                 }
 
-                BYTE* ptr = item.buffer.data();
+                BYTE* ptr = pending.data();
                 auto  now = std::chrono::steady_clock::now();
 
                 while (true) {
@@ -220,33 +471,11 @@ namespace MCDevTool::HotReload {
 
                     // 仅处理文件修改事件 (FILE_ACTION_MODIFIED)
                     // 当监听 FILE_NOTIFY_CHANGE_LAST_WRITE 时，Action 仍然是 FILE_ACTION_MODIFIED
-                    if (fni->Action == FILE_ACTION_MODIFIED && (!shouldWatchFile || shouldWatchFile(fullPath))) {
-                        std::wstring pathKey       = fullPath.wstring();
-                        bool         shouldTrigger = false;
-
-                        {
-                            std::lock_guard<std::mutex> lock(debounceMapMutex);
-                            auto                        it = lastTriggerTime.find(pathKey);
-                            if (it == lastTriggerTime.end()) {
-                                shouldTrigger            = true;
-                                lastTriggerTime[pathKey] = now;
-                            } else {
-                                auto elapsed =
-                                    std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second).count();
-                                if (elapsed >= DEBOUNCE_MS) {
-                                    shouldTrigger = true;
-                                    it->second    = now;
-                                }
-                            }
-                        }
-
-                        if (shouldTrigger) {
-                            try {
-                                onFileChanged(fullPath);
-                            } catch (const std::exception& e) {
-                                std::cerr << "Error in onFileChanged callback: " << e.what() << std::endl;
-                            }
-                        }
+                    if (fni->Action == FILE_ACTION_MODIFIED
+                        && (exclude.empty() || !exclude.isExcluded(Utils::pathToGenericUtf8(fs::path(name))))
+                        && (!shouldWatchFile || shouldWatchFile(fullPath))) {
+                        recordWriteTime(item.snapshot, fullPath);
+                        dispatcher.dispatch(fullPath, now);
                     }
 
                     if (fni->NextEntryOffset == 0) {
@@ -255,11 +484,6 @@ namespace MCDevTool::HotReload {
 
                     ptr += fni->NextEntryOffset;
                 }
-
-                // 重新投递监听
-                ZeroMemory(&item.ov, sizeof(item.ov));
-                item.ov.hEvent = item.eventHandle;
-                startWatch(item);
             }
 
             // 等待 stopChecker 线程结束
@@ -284,7 +508,240 @@ namespace MCDevTool::HotReload {
         });
     }
 
-    // ------------------------------------------------------------
+#elif defined(__linux__)
+
+    // 文件写入完成 / 原子保存（重命名覆盖），新目录的创建与移入，以及移出与自身被移动（用于清理失效的监听路径）
+    static constexpr uint32_t INOTIFY_MASK =
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MOVED_FROM | IN_MOVE_SELF | IN_EXCL_UNLINK;
+
+    static constexpr int POLL_INTERVAL_MS = 50;
+
+    namespace {
+        // 每个监听根目录独占一个 inotify 实例，使队列溢出（IN_Q_OVERFLOW）可以精确定位到需要重扫的根目录
+        struct InotifyRoot {
+            fs::path                              dir;
+            int                                   fd = -1;
+            std::unordered_map<int, fs::path>     watchDirs;
+            FileSnapshot                          snapshot;
+        };
+
+        // inotify 不支持递归，逐目录注册；被排除的目录在此剪枝，其事件不会进入内核队列
+        void addWatchTree(InotifyRoot& root, const fs::path& start, const WatchExcludeFilter& exclude) {
+            const auto addWatch = [&root](const fs::path& dir) {
+                const int wd = inotify_add_watch(root.fd, dir.c_str(), INOTIFY_MASK);
+                if (wd >= 0) {
+                    root.watchDirs[wd] = dir;
+                } else if (errno == ENOSPC) {
+                    std::cerr << "[ERROR] inotify watch limit reached (fs.inotify.max_user_watches), skipped: " << dir
+                              << std::endl;
+                }
+            };
+
+            addWatch(start);
+            std::error_code                ec;
+            fs::recursive_directory_iterator it(start, fs::directory_options::skip_permission_denied, ec);
+            for (const fs::recursive_directory_iterator end; !ec && it != end; it.increment(ec)) {
+                std::error_code statusEc;
+                if (it->is_symlink(statusEc) || !it->is_directory(statusEc)) {
+                    continue;
+                }
+                if (exclude.isExcluded(root.dir, it->path())) {
+                    it.disable_recursion_pending();
+                    continue;
+                }
+                addWatch(it->path());
+            }
+        }
+
+        // 目录移走后其子树的 wd 仍然有效，但记录的路径已失效：注销 start 及其子目录的监听。
+        // 若目录移动到树内另一位置，随后的 IN_MOVED_TO 会按新路径重新注册
+        void removeWatchTree(InotifyRoot& root, const fs::path& start) {
+            for (auto it = root.watchDirs.begin(); it != root.watchDirs.end();) {
+                const auto relative = it->second.lexically_relative(start);
+                if (!relative.empty() && *relative.begin() != "..") {
+                    inotify_rm_watch(root.fd, it->first);
+                    it = root.watchDirs.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    } // namespace
+
+    std::optional<std::thread> watchAndReloadFiles(
+        const std::vector<fs::path>&                modDirs,
+        const std::function<void(const fs::path&)>& onFileChanged,
+        FileWatchPredicate                          shouldWatchFile,
+        const WatchOptions&                         options,
+        std::atomic<bool>*                          stopFlag
+    ) {
+        if (modDirs.empty()) {
+            return std::nullopt;
+        }
+
+        WatchExcludeFilter       exclude(options.excludeGlobs);
+        std::vector<InotifyRoot> roots;
+        roots.reserve(modDirs.size());
+
+        for (const auto& dir : modDirs) {
+            if (!fs::exists(dir) || !fs::is_directory(dir)) {
+                continue;
+            }
+
+            InotifyRoot root;
+            root.dir = fs::absolute(dir).lexically_normal();
+            root.fd  = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (root.fd < 0) {
+                continue;
+            }
+            // 在调用线程内注册，函数返回后发生的修改都不会遗漏
+            addWatchTree(root, root.dir, exclude);
+            roots.emplace_back(std::move(root));
+        }
+
+        if (roots.empty()) {
+            return std::nullopt;
+        }
+
+        return std::thread([roots = std::move(roots),
+                            onFileChanged,
+                            shouldWatchFile = std::move(shouldWatchFile),
+                            exclude         = std::move(exclude),
+                            overflowProbe   = options.overflowProbe,
+                            stopFlag]() mutable {
+            for (auto& root : roots) {
+                scanWatchTree(root.dir, root.dir, exclude, shouldWatchFile, root.snapshot, nullptr);
+            }
+
+            ChangeDispatcher dispatcher(onFileChanged);
+
+            std::vector<pollfd> pollFds;
+            pollFds.reserve(roots.size());
+            for (const auto& root : roots) {
+                pollFds.push_back({.fd = root.fd, .events = POLLIN, .revents = 0});
+            }
+
+            // inotify_event 按 4 字节对齐
+            std::vector<uint32_t> storage(BUFFER_SIZE / sizeof(uint32_t));
+            auto*                 buffer = reinterpret_cast<char*>(storage.data());
+
+            while (!stopFlag || !stopFlag->load()) {
+                const int ready = poll(pollFds.data(), pollFds.size(), POLL_INTERVAL_MS);
+                if (ready < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    std::cerr << "[ERROR] poll failed, errno=" << errno << std::endl;
+                    break;
+                }
+                if (ready == 0) {
+                    continue;
+                }
+
+                for (size_t index = 0; index < roots.size(); ++index) {
+                    if ((pollFds[index].revents & POLLIN) == 0) {
+                        continue;
+                    }
+
+                    auto& root       = roots[index];
+                    bool  overflowed = overflowProbe && overflowProbe(root.dir);
+                    while (true) {
+                        const ssize_t bytes = read(root.fd, buffer, BUFFER_SIZE);
+                        if (bytes <= 0) {
+                            break;
+                        }
+
+                        const auto now = std::chrono::steady_clock::now();
+                        for (const char* ptr = buffer; ptr < buffer + bytes;) {
+                            const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                            ptr += sizeof(inotify_event) + event->len;
+
+                            if (event->mask & IN_Q_OVERFLOW) {
+                                overflowed = true;
+                                continue;
+                            }
+                            if (event->mask & IN_IGNORED) {
+                                root.watchDirs.erase(event->wd);
+                                continue;
+                            }
+
+                            const auto watchDir = root.watchDirs.find(event->wd);
+                            if (watchDir == root.watchDirs.end()) {
+                                continue;
+                            }
+                            if (event->mask & IN_MOVE_SELF) {
+                                // 树内移动时 IN_MOVED_TO 已按新路径重新注册，路径仍存在；否则目录已移出（或为根目录本身）
+                                std::error_code ec;
+                                if (!fs::is_directory(watchDir->second, ec)) {
+                                    if (watchDir->second == root.dir) {
+                                        std::cerr << "[HotReload] Watched directory was moved, no longer watched: "
+                                                  << root.dir << std::endl;
+                                    }
+                                    removeWatchTree(root, fs::path(watchDir->second));
+                                }
+                                continue;
+                            }
+                            if (event->len == 0) {
+                                continue;
+                            }
+
+                            const fs::path fullPath = watchDir->second / event->name;
+                            if (exclude.isExcluded(root.dir, fullPath)) {
+                                continue;
+                            }
+
+                            if (event->mask & IN_MOVED_FROM) {
+                                if (event->mask & IN_ISDIR) {
+                                    removeWatchTree(root, fullPath);
+                                } else {
+                                    root.snapshot.erase(fullPath.native());
+                                }
+                                continue;
+                            }
+
+                            if (event->mask & IN_ISDIR) {
+                                // 新目录：注册监听后补扫一次，覆盖注册前已写入的文件
+                                addWatchTree(root, fullPath, exclude);
+                                rescanWatchTree(root.dir, fullPath, exclude, shouldWatchFile, root.snapshot, dispatcher);
+                                continue;
+                            }
+
+                            if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                                && (!shouldWatchFile || shouldWatchFile(fullPath))) {
+                                recordWriteTime(root.snapshot, fullPath);
+                                dispatcher.dispatch(fullPath, now);
+                            }
+                        }
+                    }
+
+                    if (overflowed) {
+                        // 溢出期间可能有目录被创建，重新注册（已存在的监听返回同一 wd）后对比重扫
+                        std::cerr << "[HotReload] Change notifications overflowed, rescanning: " << root.dir
+                                  << std::endl;
+                        addWatchTree(root, root.dir, exclude);
+                        rescanWatchTree(root.dir, root.dir, exclude, shouldWatchFile, root.snapshot, dispatcher);
+                    }
+                }
+            }
+
+            for (const auto& root : roots) {
+                close(root.fd);
+            }
+        });
+    }
+
+#endif
+
+#if defined(_WIN32) || defined(__linux__)
+
+    std::optional<std::thread> watchAndReloadFiles(
+        const std::vector<fs::path>&                modDirs,
+        const std::function<void(const fs::path&)>& onFileChanged,
+        FileWatchPredicate                          shouldWatchFile,
+        std::atomic<bool>*                          stopFlag
+    ) {
+        return watchAndReloadFiles(modDirs, onFileChanged, std::move(shouldWatchFile), WatchOptions{}, stopFlag);
+    }
 
     std::optional<std::thread> watchAndReloadFiles(
         const std::vector<std::string_view>&        modDirs,
@@ -332,6 +789,46 @@ namespace MCDevTool::HotReload {
         );
     }
 
+#else
+
+    std::optional<std::thread> watchAndReloadFiles(
+        const std::vector<std::filesystem::path>&,
+        const std::function<void(const std::filesystem::path&)>&,
+        FileWatchPredicate,
+        std::atomic<bool>*
+    ) = delete;
+
+    std::optional<std::thread> watchAndReloadFiles(
+        const std::vector<std::filesystem::path>&,
+        const std::function<void(const std::filesystem::path&)>&,
+        FileWatchPredicate,
+        const WatchOptions&,
+        std::atomic<bool>*
+    ) = delete;
+
+    std::optional<std::thread> watchAndReloadFiles(
+        const std::vector<std::string_view>&,
+        const std::function<void(const std::filesystem::path&)>&,
+        FileWatchPredicate,
+        std::atomic<bool>*
+    ) = delete;
+
+    std::optional<std::thread> watchAndReloadPyFiles(
+        const std::vector<std::filesystem::path>&,
+        const std::function<void(const std::filesystem::path&)>&,
+        std::atomic<bool>*
+    ) = delete;
+
+    std::optional<std::thread> watchAndReloadPyFiles(
+        const std::vector<std::string_view>&,
+        const std::function<void(const std::filesystem::path&)>&,
+        std::atomic<bool>*
+    ) = delete;
+
+#endif
+
+#ifdef _WIN32
+
     // 监听目标pid进程是否回到前台焦点
     std::optional<std::thread> watchProcessForegroundWindow(
         uint32_t                                      pid,
@@ -367,32 +864,6 @@ namespace MCDevTool::HotReload {
 
 #else // _WIN32
 
-    std::optional<std::thread> watchAndReloadFiles(
-        const std::vector<std::filesystem::path>&,
-        const std::function<void(const std::filesystem::path&)>&,
-        FileWatchPredicate,
-        std::atomic<bool>*
-    ) = delete;
-
-    std::optional<std::thread> watchAndReloadFiles(
-        const std::vector<std::string_view>&,
-        const std::function<void(const std::filesystem::path&)>&,
-        FileWatchPredicate,
-        std::atomic<bool>*
-    ) = delete;
-
-    std::optional<std::thread> watchAndReloadPyFiles(
-        const std::vector<std::filesystem::path>&,
-        const std::function<void(const std::filesystem::path&)>&,
-        std::atomic<bool>*
-    ) = delete;
-
-    std::optional<std::thread> watchAndReloadPyFiles(
-        const std::vector<std::string_view>&,
-        const std::function<void(const std::filesystem::path&)>&,
-        std::atomic<bool>*
-    ) = delete;
-
     std::optional<std::thread> watchProcessForegroundWindow(
         uint32_t,
         const std::function<void(bool isForeground)>&,
@@ -0,0 +1,152 @@
+#include <console_writer.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+namespace {
+    // Records every sink call; optionally holds the writer thread inside its first call, standing in for a terminal
+    // that stopped reading.
+    class RecordingSink {
+    public:
+        explicit RecordingSink(bool stallFirstRun = false) : mStalled(stallFirstRun) {}
+
+        mcdk::ConsoleWriter::Sink sink() {
+            return [this](mcdk::ConsoleColor color, std::string_view text) {
+                mEntered.store(true);
+                mEntered.notify_all();
+                mStalled.wait(true);
+                std::lock_guard lock(mMutex);
+                mRuns.emplace_back(color, std::string(text));
+            };
+        }
+
+        void waitUntilStalled() { mEntered.wait(false); }
+
+        void release() {
+            mStalled.store(false);
+            mStalled.notify_all();
+        }
+
+        std::vector<std::pair<mcdk::ConsoleColor, std::string>> runs() {
+            std::lock_guard lock(mMutex);
+            return mRuns;
+        }
+
+    private:
+        std::atomic<bool>                                       mStalled;
+        std::atomic<bool>                                       mEntered{false};
+        std::mutex                                              mMutex;
+        std::vector<std::pair<mcdk::ConsoleColor, std::string>> mRuns;
+    };
+} // namespace
+
+static bool testColorRunsAreBatched() {
+    RecordingSink       recorder(true);
+    mcdk::ConsoleWriter writer(recorder.sink());
+    writer.write("first", mcdk::ConsoleColor::Default);
+    recorder.waitUntilStalled();
+
+    for (int index = 0; index < 100; ++index) {
+        writer.write("plain " + std::to_string(index), mcdk::ConsoleColor::Default);
+    }
+    for (int index = 0; index < 100; ++index) {
+        writer.write("error " + std::to_string(index), mcdk::ConsoleColor::Red);
+    }
+    writer.write("tail", mcdk::ConsoleColor::Default);
+    recorder.release();
+    writer.flush();
+
+    const auto runs  = recorder.runs();
+    const auto stats = writer.stats();
+    return expect(runs.size() == 4, "one sink call per color run")
+        && expect(runs[0].second == "first\n", "the stalled line is written alone")
+        && expect(runs[1].first == mcdk::ConsoleColor::Default && runs[1].second.starts_with("plain 0\nplain 1\n")
+                      && runs[1].second.ends_with("plain 99\n"),
+                  "plain run keeps arrival order")
+        && expect(runs[2].first == mcdk::ConsoleColor::Red && runs[2].second.ends_with("error 99\n"), "red run")
+        && expect(runs[3].second == "tail\n", "color change starts a new run")
+        && expect(stats.written == 202 && stats.dropped == 0, "nothing dropped below the budget");
+}
+
+static bool testOverflowDropsAndSummarizes() {
+    RecordingSink       recorder(true);
+    mcdk::ConsoleWriter writer(recorder.sink(), {.maxQueuedLines = 10, .maxQueuedBytes = 1024 * 1024});
+    writer.write("first", mcdk::ConsoleColor::Default);
+    recorder.waitUntilStalled();
+
+    // The first line has left the queue, so ten plain lines fit and the other forty are dropped. Red lines may
+    // fill the queue up to twenty.
+    for (int index = 0; index < 50; ++index) {
+        writer.write("flood " + std::to_string(index), mcdk::ConsoleColor::Default);
+    }
+    for (int index = 0; index < 30; ++index) {
+        writer.write("error " + std::to_string(index), mcdk::ConsoleColor::Red);
+    }
+    recorder.release();
+    writer.flush();
+
+    const auto runs  = recorder.runs();
+    const auto stats = writer.stats();
+    return expect(stats.dropped == 60 && stats.written == 21, "overflow drops instead of blocking")
+        && expect(runs.size() == 4, "stalled line, plain run, red run, summary")
+        && expect(runs[1].second.ends_with("flood 9\n"), "the oldest lines are kept")
+        && expect(runs[2].second.ends_with("error 9\n"), "red lines get a larger budget")
+        && expect(runs[3].first == mcdk::ConsoleColor::Yellow
+                      && runs[3].second.find("dropped 60 line") != std::string::npos,
+                  "drops are summarized in one line");
+}
+
+static bool testProducersKeepTheirOrder() {
+    constexpr int THREADS = 4;
+    constexpr int LINES   = 20000;
+
+    RecordingSink       recorder;
+    mcdk::ConsoleWriter writer(recorder.sink(), {.maxQueuedLines = THREADS * LINES, .maxQueuedBytes = 64 << 20});
+    std::vector<std::thread> producers;
+    for (int thread = 0; thread < THREADS; ++thread) {
+        producers.emplace_back([&writer, thread] {
+            const auto color = thread % 2 == 0 ? mcdk::ConsoleColor::Default : mcdk::ConsoleColor::Cyan;
+            for (int index = 0; index < LINES; ++index) {
+                writer.write(std::to_string(thread) + ":" + std::to_string(index), color);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    writer.flush();
+
+    std::vector<int> next(THREADS, 0);
+    bool             ordered = true;
+    for (const auto& [color, text] : recorder.runs()) {
+        std::size_t begin = 0;
+        for (auto end = text.find('\n'); end != std::string::npos; begin = end + 1, end = text.find('\n', begin)) {
+            const auto line   = std::string_view(text).substr(begin, end - begin);
+            const auto colon  = line.find(':');
+            const int  thread = std::stoi(std::string(line.substr(0, colon)));
+            ordered           = ordered && std::stoi(std::string(line.substr(colon + 1))) == next[thread]++
+                   && color == (thread % 2 == 0 ? mcdk::ConsoleColor::Default : mcdk::ConsoleColor::Cyan);
+        }
+    }
+    const auto stats = writer.stats();
+    return expect(ordered, "each producer's lines arrive in order and in their color")
+        && expect(stats.written == THREADS * LINES && stats.dropped == 0, "every line is written")
+        && expect(next == std::vector<int>(THREADS, LINES), "no line is lost");
+}
+
+int main() {
+    const bool passed = testColorRunsAreBatched() && testOverflowDropsAndSummarizes() && testProducersKeepTheirOrder();
+    return passed ? 0 : 1;
+}
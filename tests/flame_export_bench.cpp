@@ -0,0 +1,126 @@
+// Folded-stack, flame graph, pprof and Chrome trace export of synthetic captures with hundreds of thousands of frames:
+// a Native call tree and a densely connected Python call graph. Each is written to a file, as the export does, and
+// timed.
+// Usage: flame_export_bench [frames]
+#include <performance/profile_flame.hpp>
+#include <performance/profile_interchange.hpp>
+#include <performance/profile_store.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using namespace mcdk::performance;
+
+    double millisecondsSince(Clock::time_point begin) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    // Four threads of call trees that branch three ways down to depth 12, numbered breadth-first.
+    nlohmann::json nativeCapture(long long frameCount) {
+        long long  next = 0;
+        const auto tree = [&](const auto& tree, long long depth, long long budget) -> nlohmann::json {
+            auto nodes = nlohmann::json::array();
+            for (long long child = 0; child < 3 && next < budget; ++child) {
+                const auto id = next++;
+                nodes.push_back({
+                    {"id", id}, {"name", "zone_" + std::to_string(id % 5003)}, {"sourceFile", "engine/system.cpp"},
+                    {"sourceLine", id % 900}, {"calls", 1 + id % 7}, {"selfNanoseconds", 1000 + id % 50000},
+                    {"children", depth < 12 ? tree(tree, depth + 1, budget) : nlohmann::json::array()},
+                });
+            }
+            return nodes;
+        };
+        auto threads = nlohmann::json::array();
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.push_back({
+                {"id", std::to_string(thread)}, {"name", "Worker " + std::to_string(thread)},
+                {"roots", tree(tree, 0, frameCount * (thread + 1) / 4)},
+            });
+        }
+        return {{"threads", std::move(threads)}, {"zones", nlohmann::json::array()}};
+    }
+
+    // Layers of functions where each calls the next layer's four nearest functions, so paths multiply.
+    nlohmann::json pythonCapture(long long functionCount) {
+        constexpr long long width = 2000;
+        auto nodes = nlohmann::json::array();
+        auto edges = nlohmann::json::array();
+        for (long long id = 0; id < functionCount; ++id) {
+            const auto layer = id / width;
+            const double total = 10.0 / static_cast<double>(layer + 1) / width;
+            nodes.push_back(nlohmann::json::array({
+                id, "pack/layer_" + std::to_string(layer) + ".py", 1 + id % width, "f" + std::to_string(id), 1, 1,
+                total / 5, total, 1, "Main", "client",
+            }));
+            if (layer == 0) continue;
+            for (long long caller = 0; caller < 4; ++caller) {
+                const auto from = (layer - 1) * width + (id + caller) % width;
+                edges.push_back(nlohmann::json::array({from, id, 1, total / 20, total / 5}));
+            }
+        }
+        return {{"nodes", std::move(nodes)}, {"edges", std::move(edges)}};
+    }
+
+    template <class Write>
+    void timeExport(const char* label, const std::filesystem::path& path, Write&& write) {
+        const auto begin = Clock::now();
+        {
+            std::ofstream output(path, std::ios::binary);
+            write(output);
+        }
+        std::printf(
+            "  %-12s %8.1f ms %9.1f KiB\n", label, millisecondsSince(begin),
+            static_cast<double>(std::filesystem::file_size(path)) / 1024
+        );
+    }
+
+    bool measure(const char* name, ProfilerKind kind, const nlohmann::json& data, const std::filesystem::path& root) {
+        const auto store = buildProfileStore(kind, data);
+        if (!store) {
+            std::cerr << name << " capture did not build\n";
+            return false;
+        }
+        const auto folded = root / (std::string(name) + ".folded");
+        std::printf("%s\n", name);
+        timeExport("folded", folded, [&](std::ostream& output) { writeFoldedStacks(**store, output); });
+        timeExport("flame graph", root / (std::string(name) + ".flame.svg"), [&](std::ostream& output) {
+            writeFlameGraph(**store, name, "bench", output);
+        });
+        timeExport("pprof", root / (std::string(name) + ".pb.gz"), [&](std::ostream& output) {
+            writePprof(**store, output);
+        });
+        if (kind == ProfilerKind::NativeCpu) {
+            timeExport("chrome trace", root / (std::string(name) + ".trace.json"), [&](std::ostream& output) {
+                writeChromeTrace(**store, output);
+            });
+        }
+        std::ifstream lines(folded);
+        long long     stacks = 0;
+        for (std::string line; std::getline(lines, line);) ++stacks;
+        std::printf("  %lld stacks\n", stacks);
+        return stacks > 0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long long frameCount = argc > 1 ? std::atoll(argv[1]) : 300'000;
+    const auto      root       = std::filesystem::temp_directory_path()
+                    / ("mcdev-flame-export-bench-" + std::to_string(Clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(root);
+    bool passed = measure("native", ProfilerKind::NativeCpu, nativeCapture(frameCount), root);
+    passed &= measure("python", ProfilerKind::PythonCpu, pythonCapture(frameCount / 10), root);
+    std::error_code ignored;
+    std::filesystem::remove_all(root, ignored);
+    return passed ? 0 : 1;
+}
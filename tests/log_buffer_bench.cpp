@@ -0,0 +1,113 @@
+// Add/read throughput of LogBuffer under reader contention, compared with the previous deque<std::string> layout.
+// Usage: log_buffer_bench [seconds-per-case] [reader-threads]
+#include <log_buffer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    class DequeLogBuffer {
+    public:
+        DequeLogBuffer(std::size_t capacity, std::size_t clearBatchSize)
+        : mCapacity(capacity),
+          mClearBatchSize(clearBatchSize) {}
+
+        void add(std::string line) {
+            std::lock_guard lock(mMutex);
+            mBuffer.push_back(std::move(line));
+            if (mBuffer.size() > mCapacity) {
+                const auto count = std::min(mClearBatchSize, mBuffer.size());
+                for (std::size_t index = 0; index < count; ++index) {
+                    mBuffer.pop_front();
+                }
+            }
+        }
+
+        std::vector<std::string> getLatest(std::size_t maxCount) {
+            std::lock_guard lock(mMutex);
+            const auto      count = std::min(maxCount, mBuffer.size());
+            return std::vector<std::string>(mBuffer.end() - static_cast<std::ptrdiff_t>(count), mBuffer.end());
+        }
+
+    private:
+        std::deque<std::string> mBuffer;
+        std::size_t             mCapacity;
+        std::size_t             mClearBatchSize;
+        std::mutex              mMutex;
+    };
+
+    struct Result {
+        double addsPerSecond  = 0;
+        double readsPerSecond = 0;
+    };
+
+    template <typename Buffer, typename MakeLine>
+    Result run(Buffer& buffer, MakeLine makeLine, double seconds, int readers) {
+        std::atomic<bool>          stop      = false;
+        std::atomic<std::uint64_t> reads     = 0;
+        std::atomic<std::uint64_t> readLines = 0;
+        std::uint64_t              adds      = 0;
+
+        std::vector<std::thread> readerThreads;
+        for (int index = 0; index < readers; ++index) {
+            readerThreads.emplace_back([&] {
+                std::uint64_t local = 0;
+                std::uint64_t lines = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    lines += buffer.getLatest(100).size();
+                    ++local;
+                }
+                reads += local;
+                readLines += lines;
+            });
+        }
+
+        const auto start    = std::chrono::steady_clock::now();
+        const auto deadline = start + std::chrono::duration<double>(seconds);
+        while (std::chrono::steady_clock::now() < deadline) {
+            for (int batch = 0; batch < 256; ++batch) {
+                buffer.add(makeLine(adds++));
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stop                 = true;
+        for (auto& thread : readerThreads) {
+            thread.join();
+        }
+        return {.addsPerSecond = static_cast<double>(adds) / elapsed, .readsPerSecond = reads / elapsed};
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+    const int    readers = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    const auto makeLine = [](std::uint64_t index) {
+        return "[12:00:00][INFO][Python] tick handler " + std::to_string(index)
+             + " entity=minecraft:zombie pos=(12, 64, -3)";
+    };
+
+    std::cout << "readers=" << readers << " seconds=" << seconds << " capacity=1000 batch=250 read=getLatest(100)\n";
+    for (int readerCount : {0, readers}) {
+        mcdk::LogBuffer ring(1000, 250);
+        DequeLogBuffer  deque(1000, 250);
+        const auto      ringResult  = run(ring, makeLine, seconds, readerCount);
+        const auto      dequeResult = run(deque, makeLine, seconds, readerCount);
+        std::cout << "  readers=" << readerCount << "\n"
+                  << "    arena ring : " << static_cast<std::uint64_t>(ringResult.addsPerSecond) << " adds/s, "
+                  << static_cast<std::uint64_t>(ringResult.readsPerSecond) << " reads/s\n"
+                  << "    deque      : " << static_cast<std::uint64_t>(dequeResult.addsPerSecond) << " adds/s, "
+                  << static_cast<std::uint64_t>(dequeResult.readsPerSecond) << " reads/s\n";
+    }
+    return 0;
+}
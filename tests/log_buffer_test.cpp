@@ -0,0 +1,272 @@
+#include <log_buffer.hpp>
+#include <log_spool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+static std::vector<std::string> toStrings(const mcdk::LogLines& lines) {
+    return {lines.lines.begin(), lines.lines.end()};
+}
+
+static bool testEvictionAndRanges() {
+    mcdk::LogBuffer buffer(5, 2);
+    for (int index = 0; index < 6; ++index) {
+        buffer.add("line" + std::to_string(index));
+    }
+    // The sixth line overflows capacity 5 and evicts one batch of two.
+    const auto latest   = toStrings(buffer.getLatest(10));
+    const auto reversed = toStrings(buffer.getLatestReversed(2));
+    const auto range    = toStrings(buffer.getRange(1, 3));
+    return expect(buffer.size() == 4, "batch eviction keeps capacity - batch + 1 lines")
+        && expect(latest == std::vector<std::string>{"line2", "line3", "line4", "line5"}, "latest is oldest first")
+        && expect(reversed == std::vector<std::string>{"line5", "line4"}, "reversed latest is newest first")
+        && expect(range == std::vector<std::string>{"line3", "line4"}, "tail-relative range [1, 3)")
+        && expect(buffer.getRange(3, 9).empty(), "out-of-range end is rejected");
+}
+
+static bool testChunkRecycling() {
+    mcdk::LogBuffer   buffer(64, 16);
+    const std::string huge(100 * 1024, 'x');
+    buffer.add(huge);
+    buffer.add("");
+    for (int index = 0; index < 20000; ++index) {
+        buffer.add(std::string(static_cast<std::size_t>(index % 300), static_cast<char>('a' + index % 26)));
+    }
+    const auto latest = buffer.getLatest(3);
+    bool       intact = latest.size() == 3;
+    for (int offset = 0; offset < 3 && intact; ++offset) {
+        const int index = 20000 - 3 + offset;
+        intact = latest.lines[static_cast<std::size_t>(offset)]
+              == std::string(static_cast<std::size_t>(index % 300), static_cast<char>('a' + index % 26));
+    }
+    buffer.clear();
+    buffer.add(huge);
+    const auto afterClear = buffer.getLatest(1);
+    return expect(intact, "lines survive chunk recycling byte for byte")
+        && expect(afterClear.size() == 1 && afterClear.lines[0] == huge, "oversized line after clear");
+}
+
+static bool testCursorReads() {
+    mcdk::LogBuffer buffer(5, 2);
+    for (int index = 1; index <= 3; ++index) {
+        buffer.add("line" + std::to_string(index));
+    }
+    const auto first = buffer.getSince(0, 2);
+    const auto rest  = buffer.getSince(first.nextCursor, 10);
+    const auto idle  = buffer.getSince(rest.nextCursor, 10);
+
+    // Lines 4..9 overflow the buffer twice while the reader is away, evicting lines 3 and 4 after line 3 was read.
+    for (int index = 4; index <= 9; ++index) {
+        buffer.add("line" + std::to_string(index));
+    }
+    const auto afterEviction = buffer.getSince(rest.nextCursor, 10);
+    const auto reversed      = buffer.getLatestReversed(2);
+    buffer.clear();
+    const auto afterClear = buffer.getSince(afterEviction.nextCursor, 10);
+    buffer.add("line10");
+    const auto resumed = buffer.getSince(afterClear.nextCursor, 10);
+
+    return expect(toStrings(first.lines) == std::vector<std::string>{"line1", "line2"}, "first page")
+        && expect(first.nextCursor == 2 && first.hasMore && first.dropped == 0, "first page cursor")
+        && expect(toStrings(rest.lines) == std::vector<std::string>{"line3"}, "second page returns only new lines")
+        && expect(rest.nextCursor == 3 && !rest.hasMore, "second page cursor")
+        && expect(idle.lines.empty() && idle.nextCursor == 3, "idle poll returns nothing")
+        && expect(afterEviction.dropped == 1, "unread evicted lines are counted as dropped")
+        && expect(afterEviction.lines.firstSequence == 5, "first retained sequence")
+        && expect(afterEviction.lines.size() == 5 && afterEviction.lines.lines[0] == "line5", "retained tail")
+        && expect(reversed.sequenceAt(0) == 9 && reversed.sequenceAt(1) == 8, "reversed sequence numbers")
+        && expect(afterClear.lines.empty() && afterClear.nextCursor == 9, "sequences survive clear")
+        && expect(toStrings(resumed.lines) == std::vector<std::string>{"line10"}, "cursor resumes after clear")
+        && expect(buffer.getSince(1000, 10).nextCursor == 10, "foreign cursor resynchronizes to the tail");
+}
+
+static std::vector<std::uint64_t> matchedSequences(const mcdk::LogSearchResult& result) {
+    std::vector<std::uint64_t> sequences;
+    for (const auto& line : result.lines) {
+        if (line.match) {
+            sequences.push_back(line.sequence);
+        }
+    }
+    return sequences;
+}
+
+static bool testSearch() {
+    mcdk::LogBuffer indexed(300, 50);
+    mcdk::LogBuffer plain(300, 50);
+    indexed.enableSearchIndex();
+    const char* modules[] = {"Engine", "Developer", "ModA.server", "ModB.client"};
+    for (int index = 0; index < 2000; ++index) {
+        std::string line = "[" + std::string(index % 7 == 0 ? "ERROR" : index % 5 == 0 ? "WARN" : "INFO") + "]["
+                         + modules[index % 4] + "] tick=" + std::to_string(index);
+        if (index % 11 == 0) {
+            line += " Traceback: missing 'item_" + std::to_string(index % 13) + "'";
+        }
+        indexed.add(line);
+        plain.add(line);
+    }
+
+    // Every query must return the same lines with and without the index; only the scanned count may differ.
+    using Mode = mcdk::LogSearchQuery::Mode;
+    const std::vector<mcdk::LogSearchQuery> queries = {
+        {.pattern = "missing"},
+        {.pattern = "MISSING", .ignoreCase = true},
+        {.pattern = "ModB.client", .maxMatches = 7},
+        {.pattern = R"(item_1[02]')", .mode = Mode::Regex},
+        {.pattern = R"(Mod[AB]\.server\] tick=19\d\d)", .mode = Mode::Regex},
+        {.pattern = "tick=18(5|6)0", .mode = Mode::Regex},
+        {.pattern = R"(ERRORx?\])", .mode = Mode::Regex},
+        {.pattern = "engine|developer", .mode = Mode::Regex, .ignoreCase = true, .maxMatches = 1000},
+        {.pattern = "tick", .levelMask = mcdk::logLevelBit(mcdk::LogLevel::Error), .maxMatches = 1000},
+        {.pattern = "no such line"},
+    };
+    bool passed = true;
+    for (std::size_t index = 0; index < queries.size(); ++index) {
+        const auto fast = indexed.search(queries[index]);
+        const auto slow = plain.search(queries[index]);
+        const auto name = "indexed search matches a full scan: " + queries[index].pattern;
+        passed &= expect(fast && slow && matchedSequences(*fast) == matchedSequences(*slow), name.c_str());
+    }
+
+    const auto missing = indexed.search({.pattern = "missing", .maxMatches = 5});
+    const auto errors =
+        indexed.search({.levelMask = mcdk::logLevelBit(mcdk::LogLevel::Error), .contextLines = 1, .maxMatches = 3});
+    const auto invalid = indexed.search({.pattern = "(unclosed", .mode = Mode::Regex});
+
+    passed &= expect(missing && missing->indexed && missing->scannedLines == missing->matchCount,
+                     "the index narrows verification to exact candidates")
+           && expect(missing->truncated && missing->matchCount == 5, "newest matches fill the result first")
+           && expect(missing->lines.back().text.ends_with("tick=1991 Traceback: missing 'item_2'"), "newest last");
+    passed &= expect(errors && matchedSequences(*errors) == std::vector<std::uint64_t>{1982, 1989, 1996},
+                     "level filter keeps only error lines")
+           && expect(errors->lines.size() == 9 && !errors->lines.front().match && errors->lines.front().sequence == 1981,
+                     "context lines surround every match")
+           && expect(!invalid && !invalid.error().empty(), "invalid regex is reported");
+    return passed;
+}
+
+static bool testSpoolHistory() {
+    const auto root = std::filesystem::temp_directory_path()
+                    / ("mcdk-log-spool-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    bool passed = true;
+    {
+        // Tiny segments force rotation; the oldest segments beyond maxSegments are deleted.
+        auto spool = mcdk::LogSpool::createSession(root, {.keepSessions = 2}, {.maxSegmentBytes = 128, .maxSegments = 8});
+        if (!expect(spool.has_value(), "spool session opens")) {
+            return false;
+        }
+        mcdk::LogBuffer buffer(10, 5);
+        buffer.attachSpool(*spool);
+        for (int index = 1; index <= 200; ++index) {
+            buffer.add("line" + std::to_string(index));
+        }
+
+        const auto oldest  = (*spool)->oldestSequence();
+        const auto history = buffer.getSince(0, 30);
+        const auto middle  = (*spool)->read(150, 3);
+        const auto tail    = buffer.getSince(195, 10);
+        const auto direct  = (*spool)->read(oldest, 1000);
+
+        passed &= expect(oldest > 1 && (*spool)->latestSequence() == 200, "rotation keeps the newest segments")
+               && expect(history.lines.size() == 30 && history.lines.firstSequence == oldest, "cursor 0 starts on disk")
+               && expect(history.dropped == oldest - 1 && history.hasMore, "only rotated-out lines are dropped")
+               && expect(toStrings(middle) == std::vector<std::string>{"line150", "line151", "line152"},
+                         "random access through the sidecar index")
+               && expect(toStrings(tail.lines)
+                             == std::vector<std::string>{"line196", "line197", "line198", "line199", "line200"},
+                         "recent lines still come from memory")
+               && expect(direct.lines.size() == 201 - oldest && direct.lines.back() == "line200",
+                         "reads span segment boundaries");
+
+        // A standalone spool numbers its own lines.
+        auto raw = mcdk::LogSpool::open((*spool)->directory() / "raw");
+        if (!expect(raw.has_value(), "standalone spool opens")) {
+            return false;
+        }
+        const auto first  = (*raw)->append("raw1");
+        const auto second = (*raw)->append("raw2");
+        passed &= expect(first == 1 && second == 2, "standalone appends are numbered from 1")
+               && expect(toStrings((*raw)->read(1, 10)) == std::vector<std::string>{"raw1", "raw2"},
+                         "standalone lines read back");
+
+        std::size_t segments = 0;
+        for (const auto& entry : std::filesystem::directory_iterator((*spool)->directory())) {
+            segments += entry.path().extension() == ".log";
+        }
+        passed &= expect(segments == 8, "segment count is capped");
+    }
+    for (int session = 0; session < 3; ++session) {
+        std::filesystem::create_directories(root / ("20000101T00000" + std::to_string(session) + "Z"));
+    }
+    const auto latest = mcdk::LogSpool::createSession(root, {.keepSessions = 2});
+    std::size_t sessions = 0;
+    for ([[maybe_unused]] const auto& entry : std::filesystem::directory_iterator(root)) {
+        ++sessions;
+    }
+    passed &= expect(latest.has_value() && sessions == 2, "old session directories are pruned");
+
+    // Earlier sessions are also pruned oldest first once together they exceed the byte budget.
+    const auto sized = root / "sized";
+    for (int session = 0; session < 4; ++session) {
+        const auto directory = sized / ("20000101T00000" + std::to_string(session) + "Z");
+        std::filesystem::create_directories(directory / "error");
+        std::ofstream(directory / "error" / "segment-000001.log") << std::string(1000, 'x');
+    }
+    const auto capped = mcdk::LogSpool::createSession(sized, {.keepSessions = 10, .maxBytes = 2500});
+    passed &= expect(capped.has_value(), "capped session opens")
+           && expect(!std::filesystem::exists(sized / "20000101T000001Z")
+                         && std::filesystem::exists(sized / "20000101T000002Z")
+                         && std::filesystem::exists(sized / "20000101T000003Z"),
+                     "only the newest sessions within maxBytes are kept")
+           && expect(mcdk::LogSpool::diskUsage(sized) == 2000, "disk usage sums nested files");
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    return passed;
+}
+
+// A backtracking regex takes about ten milliseconds per line here; writers must not wait for it.
+static bool testSearchDoesNotBlockWriters() {
+    using Clock = std::chrono::steady_clock;
+    mcdk::LogBuffer buffer(1000, 100);
+    for (int index = 0; index < 30; ++index) {
+        buffer.add(std::string(22, 'a'));
+    }
+    const mcdk::LogSearchQuery query{.pattern = "(a|aa)*c", .mode = mcdk::LogSearchQuery::Mode::Regex};
+    Clock::duration            searching{};
+    std::thread                searcher([&] {
+        const auto started = Clock::now();
+        (void)buffer.search(query);
+        searching = Clock::now() - started;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Clock::duration slowest{};
+    for (int index = 0; index < 100; ++index) {
+        const auto started = Clock::now();
+        buffer.add("writer line " + std::to_string(index));
+        slowest = std::max(slowest, Clock::now() - started);
+    }
+    searcher.join();
+    const auto found = buffer.search({.pattern = "writer line 99"});
+    return expect(slowest * 4 < searching, "add() does not wait for a slow regex search")
+        && expect(found && found->matchCount == 1, "lines added during a search are searchable afterwards");
+}
+
+int main() {
+    const bool passed = testEvictionAndRanges() && testChunkRecycling() && testCursorReads() && testSearch()
+                     && testSearchDoesNotBlockWriters() && testSpoolHistory();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Line throughput of the stdout classifier and the traceback rewriter, compared with the keyword chain and std::regex
+// they replaced. Pass recorded game logs (one line per log line) to measure a real session; without arguments a
+// synthetic corpus with a typical mix of engine noise, mod output and tracebacks is used.
+// Usage: log_classifier_bench [rounds] [corpus-file...]
+#include <log_classifier.hpp>
+#include <utils.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+    int referenceClassify(const std::string& line) {
+        if (line.find(" [INFO][Engine] ") != std::string::npos) {
+            return 0;
+        }
+        if (line.find("[INFO][Developer]") != std::string::npos) {
+            return 1;
+        }
+        if (mcdk::containsIgnoreCase(line, "SUC")) {
+            return 2;
+        }
+        if (mcdk::containsIgnoreCase(line, "ERROR")) {
+            return 3;
+        }
+        if (mcdk::containsIgnoreCase(line, "WARN")) {
+            return 4;
+        }
+        if (mcdk::containsIgnoreCase(line, "DEBUG")) {
+            return 5;
+        }
+        return 6;
+    }
+
+    std::string referenceRewrite(const std::string& line) {
+        static const std::regex fileRe(R"(File \"([A-Za-z0-9_\.]+)\", line (\d+))");
+        std::string             out;
+        std::size_t             lastPos = 0;
+        for (std::sregex_iterator cur(line.begin(), line.end(), fileRe), end; cur != end; ++cur) {
+            const auto& match = *cur;
+            out.append(line, lastPos, static_cast<std::size_t>(match.position()) - lastPos);
+            std::string slashed = match[1].str();
+            std::replace(slashed.begin(), slashed.end(), '.', '/');
+            out += "File \"" + slashed + ".py\", line " + match[2].str();
+            lastPos = static_cast<std::size_t>(match.position() + match.length());
+        }
+        out.append(line, lastPos);
+        return out;
+    }
+
+    std::vector<std::string> syntheticCorpus() {
+        const std::vector<std::string> templates = {
+            "[12:00:00][INFO][Engine] Chunk (12, -3) loaded in 0.42 ms",
+            "[12:00:00][INFO][Engine] Texture atlas rebuilt: 4096x4096",
+            "[12:00:00][INFO][Python] tick handler entity=minecraft:zombie pos=(12, 64, -3)",
+            "[12:00:00][INFO][Python] player joined: Steve dimension=0",
+            "[12:00:00][INFO][Developer] register system mymod.server.MainSystem",
+            "[12:00:00][ERROR][Python] failed to spawn entity mymod:boss",
+            "[12:00:00][WARN][Python] deprecated api GetEngineCompFactory used",
+            "[12:00:00][DEBUG][Python] state=idle frames=120",
+            "[12:00:00][INFO][Python] load config success",
+            "Traceback (most recent call last):",
+            "  File \"mymod.server.systems.combat\", line 217, in OnTick",
+            "  File \"mymod.common.utils.vector\", line 41, in normalize",
+            "ZeroDivisionError: float division by zero",
+        };
+        std::vector<std::string> corpus;
+        for (int index = 0; index < 20000; ++index) {
+            corpus.push_back(templates[static_cast<std::size_t>(index * 7919) % templates.size()]);
+        }
+        return corpus;
+    }
+
+    template <typename Work>
+    double linesPerSecond(const std::vector<std::string>& corpus, int rounds, Work work) {
+        volatile std::size_t sink  = 0;
+        const auto           start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (const auto& line : corpus) {
+                sink = sink + work(line);
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(corpus.size()) * rounds / elapsed;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+
+    std::vector<std::string> corpus;
+    for (int index = 2; index < argc; ++index) {
+        std::ifstream file(argv[index], std::ios::binary);
+        for (std::string line; std::getline(file, line);) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            corpus.push_back(std::move(line));
+        }
+    }
+    const bool synthetic = corpus.empty();
+    if (synthetic) {
+        corpus = syntheticCorpus();
+    }
+    std::size_t bytes = 0;
+    for (const auto& line : corpus) {
+        bytes += line.size();
+    }
+
+    const auto& classifier = mcdk::logLineClassifier();
+    const auto  report     = [&](const char* name, double perSecond) {
+        std::cout << "  " << name << static_cast<std::uint64_t>(perSecond) << " lines/s, "
+                  << static_cast<std::uint64_t>(perSecond * static_cast<double>(bytes) / corpus.size() / 1e6)
+                  << " MB/s\n";
+    };
+
+    std::cout << "corpus=" << (synthetic ? "synthetic" : "recorded") << " lines=" << corpus.size()
+              << " bytes=" << bytes << " rounds=" << rounds << "\n";
+    report("classifier     : ", linesPerSecond(corpus, rounds, [&](const std::string& line) {
+               return static_cast<std::size_t>(classifier.classify(line));
+           }));
+    report("keyword chain  : ", linesPerSecond(corpus, rounds, [](const std::string& line) {
+               return static_cast<std::size_t>(referenceClassify(line));
+           }));
+    report("rewriter       : ", linesPerSecond(corpus, rounds, [](const std::string& line) {
+               return mcdk::rewriteTracebackFileNames(line).size();
+           }));
+    report("std::regex     : ", linesPerSecond(corpus, rounds, [](const std::string& line) {
+               return referenceRewrite(line).size();
+           }));
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <log_classifier.hpp>
+#include <utils.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+// The keyword chain processStdout used before the classifier existed.
+static mcdk::LogLineKind referenceClassify(const std::string& line) {
+    if (line.find(" [INFO][Engine] ") != std::string::npos) {
+        return mcdk::LogLineKind::EngineNoise;
+    }
+    if (line.find("[INFO][Developer]") != std::string::npos) {
+        return mcdk::LogLineKind::Developer;
+    }
+    if (mcdk::containsIgnoreCase(line, "SUC")) {
+        return mcdk::LogLineKind::Success;
+    }
+    if (mcdk::containsIgnoreCase(line, "ERROR")) {
+        return mcdk::LogLineKind::Error;
+    }
+    if (mcdk::containsIgnoreCase(line, "WARN")) {
+        return mcdk::LogLineKind::Warning;
+    }
+    if (mcdk::containsIgnoreCase(line, "DEBUG")) {
+        return mcdk::LogLineKind::Debug;
+    }
+    return mcdk::LogLineKind::Plain;
+}
+
+// The std::regex rewrite processStderr used before.
+static std::string referenceRewrite(const std::string& line) {
+    static const std::regex fileRe(R"(File \"([A-Za-z0-9_\.]+)\", line (\d+))");
+    std::string             out;
+    std::size_t             lastPos = 0;
+    for (std::sregex_iterator cur(line.begin(), line.end(), fileRe), end; cur != end; ++cur) {
+        const auto& match = *cur;
+        out.append(line, lastPos, static_cast<std::size_t>(match.position()) - lastPos);
+        std::string slashed = match[1].str();
+        std::replace(slashed.begin(), slashed.end(), '.', '/');
+        out += "File \"" + slashed + ".py\", line " + match[2].str();
+        lastPos = static_cast<std::size_t>(match.position() + match.length());
+    }
+    out.append(line, lastPos);
+    return out;
+}
+
+static bool testClassifierMatchesKeywordChain() {
+    const std::vector<std::string> fragments = {
+        " [INFO][Engine] ", "[INFO][Developer]", "[info][engine]", " [INFO][Engin", "SUC", "Success", "sUc",
+        "ERROR",           "Error",             "errOr",          "ERRO",          "WARN", "Warning", "wa",
+        "DEBUG",           "debu",              "[INFO]",         "tick=42",       " ",    "[",       "su",
+    };
+    std::mt19937 random(7);
+    bool         passed = true;
+    for (int round = 0; round < 20000 && passed; ++round) {
+        std::string line;
+        const auto  parts = random() % 5;
+        for (std::uint32_t part = 0; part < parts; ++part) {
+            line += fragments[random() % fragments.size()];
+        }
+        passed = expect(mcdk::logLineClassifier().classify(line) == referenceClassify(line), line.c_str());
+    }
+    return passed
+        && expect(mcdk::logLineClassifier().classify("12:00 [INFO][Engine] Error x") == mcdk::LogLineKind::EngineNoise,
+                  "engine noise wins over keywords")
+        && expect(mcdk::logLineClassifier().classify("[info][engine] x") == mcdk::LogLineKind::Plain,
+                  "engine marker is case-sensitive")
+        && expect(mcdk::logLineClassifier().classify("") == mcdk::LogLineKind::Plain, "empty line");
+}
+
+static bool testTracebackRewrite() {
+    const std::vector<std::string> lines = {
+        R"(  File "mod.server.system", line 42, in Update)",
+        R"(  File "a.b", line 1, in f File "c", line 22)",
+        R"(  File "<string>", line 3)",
+        R"(File "x.y", line )",
+        R"(File "File "p.q", line 9)",
+        R"(File "", line 5)",
+        R"(no traceback here)",
+        "",
+    };
+    bool passed = true;
+    for (const auto& line : lines) {
+        passed &= expect(mcdk::rewriteTracebackFileNames(line) == referenceRewrite(line), line.c_str());
+    }
+    return passed
+        && expect(mcdk::rewriteTracebackFileNames(R"(  File "mod.server.system", line 42, in Update)")
+                      == R"(  File "mod/server/system.py", line 42, in Update)",
+                  "module path becomes a file path");
+}
+
+int main() {
+    const bool passed = testClassifierMatchesKeywordChain() && testTracebackRewrite();
+    return passed ? 0 : 1;
+}
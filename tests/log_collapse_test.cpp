@@ -0,0 +1,104 @@
+#include <log_collapse.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+// Feeds lines one millisecond apart and returns what the pipeline would print.
+static std::vector<std::string>
+collapse(mcdk::LogFloodCollapser& collapser, const std::vector<std::string>& lines, std::int64_t& clockMs) {
+    std::vector<std::string> printed;
+    for (const auto& line : lines) {
+        const auto output = collapser.feed(line, clockMs++);
+        if (output.summary) {
+            printed.push_back(*output.summary);
+        }
+        if (output.emitLine) {
+            printed.push_back(line);
+        }
+    }
+    return printed;
+}
+
+static bool testRuns() {
+    mcdk::LogFloodCollapser  collapser;
+    std::int64_t             clockMs = 0;
+    std::vector<std::string> lines   = {"start"};
+    for (int index = 0; index < 500; ++index) {
+        lines.push_back("[tick] entity count 12");
+    }
+    for (int index = 0; index < 100; ++index) {
+        lines.push_back("[tick] pos " + std::to_string(index) + ".5 speed " + std::to_string(index * 3));
+    }
+    lines.push_back("a");
+    lines.push_back("a");
+    lines.push_back("b");
+
+    auto printed = collapse(collapser, lines, clockMs);
+    if (const auto tail = collapser.flush()) {
+        printed.push_back(*tail);
+    }
+    const std::vector<std::string> expected = {
+        "start",
+        "[tick] entity count 12",
+        "[tick] entity count 12 [repeated 499 times in 0.5s]",
+        "[tick] pos 0.5 speed 0",
+        "[tick] pos 99.5 speed 297 [99 similar lines in 0.1s]",
+        "a",
+        "a", // A single repeat is released as it was.
+        "b",
+    };
+    return expect(printed == expected, "runs collapse to the first line plus one summary")
+        && expect(collapser.collapsedCount() == 499 + 99 + 1, "collapsed line count")
+        && expect(mcdk::LogFloodCollapser::templateOf("v1.20 took 3ms, id=0x1f") == "v# took #ms, id=#x#f",
+                  "numbers are masked");
+}
+
+static bool testLongFloodAndIdle() {
+    mcdk::LogFloodCollapser  collapser({.summaryIntervalMs = 100, .idleFlushMs = 50});
+    std::int64_t             clockMs = 0;
+    std::vector<std::string> lines(251, "spam");
+    const auto               printed = collapse(collapser, lines, clockMs);
+
+    // Repeats 1..250 arrive at 1..250 ms: interim reports close at 101 ms and 202 ms, the rest stays held.
+    const std::vector<std::string> expected = {
+        "spam",
+        "spam [repeated 101 times in 0.1s]",
+        "spam [repeated 101 times in 0.1s]",
+    };
+    const bool interim = expect(printed == expected, "an endless flood is reported periodically");
+    const auto early = collapser.flushIdle(clockMs + 10);
+    const auto late  = collapser.flushIdle(clockMs + 60);
+
+    mcdk::LogFloodCollapser  emitting({.idleFlushMs = 50});
+    std::int64_t             emitClock = 0;
+    std::vector<std::string> emitted   = collapse(emitting, {"spam", "spam", "spam"}, emitClock);
+    const auto               append    = [&](std::string_view summary) { emitted.emplace_back(summary); };
+    const bool quiet   = !emitting.flushIdle(emitClock + 10, append);
+    const bool flushed = emitting.flushIdle(emitClock + 60, append) && !emitting.flushIdle(emitClock + 120, append);
+
+    mcdk::LogFloodCollapser exact({.maskNumbers = false});
+    std::int64_t            exactClock = 0;
+    const auto exactPrinted = collapse(exact, {"frame 1", "frame 2", "frame 2", "frame 2"}, exactClock);
+    return interim && expect(!early, "a run that is still active is not flushed")
+        && expect(late == "spam [repeated 48 times in 0.0s]", "an idle run reports what it held")
+        && expect(!collapser.flushIdle(clockMs + 1000), "nothing is reported twice")
+        && expect(
+               quiet && flushed && emitted == std::vector<std::string>{"spam", "spam [repeated 2 times in 0.0s]"},
+               "an idle run can be emitted under the collapser's lock"
+        )
+        && expect(exactPrinted == std::vector<std::string>{"frame 1", "frame 2"}, "exact mode ignores similar lines")
+        && expect(exact.flush() == "frame 2 [repeated 2 times in 0.0s]", "exact mode still collapses identical lines");
+}
+
+int main() {
+    const bool passed = testRuns() && testLongFloodAndIdle();
+    return passed ? 0 : 1;
+}
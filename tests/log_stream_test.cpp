@@ -0,0 +1,98 @@
+#include <log_buffer.hpp>
+#include <log_stream.hpp>
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+struct Published {
+    std::map<std::string, std::vector<std::vector<mcdk::LogStreamBatch>>> calls; // Per session, one entry per publish.
+    bool                                                                  accept = true;
+};
+
+static mcdk::LogStreamHub::Publisher recordTo(Published& published) {
+    return [&published](const std::string& sessionId, const std::vector<mcdk::LogStreamBatch>& batches) {
+        published.calls[sessionId].push_back(batches);
+        return published.accept;
+    };
+}
+
+static bool testFilteredDelivery() {
+    auto buffer = std::make_shared<mcdk::LogBuffer>(100);
+    buffer->add("before subscribing");
+
+    Published          published;
+    mcdk::LogStreamHub hub(recordTo(published));
+
+    using Mode            = mcdk::LogSearchQuery::Mode;
+    const auto everything = hub.subscribe("a", buffer, {});
+    const auto errors     = hub.subscribe("a", buffer, {.levelMask = mcdk::logLevelBit(mcdk::LogLevel::Error)});
+    const auto pattern    = hub.subscribe("b", buffer, {.pattern = "player\\d+", .mode = Mode::Regex});
+    const auto invalid    = hub.subscribe("b", buffer, {.pattern = "(", .mode = Mode::Regex});
+
+    hub.pump();
+    const bool quiet = expect(published.calls.empty(), "nothing is published without new lines");
+
+    buffer->add("[INFO] player1 joined");
+    buffer->add("[ERROR] script failed");
+    buffer->add("[INFO] tick");
+    hub.pump();
+
+    const auto& sessionA = published.calls["a"];
+    const auto& sessionB = published.calls["b"];
+    return quiet && expect(everything && errors && pattern, "valid subscriptions are accepted")
+        && expect(!invalid, "an invalid regex is rejected")
+        && expect(hub.subscriptionCount() == 3, "three subscriptions")
+        && expect(sessionA.size() == 1 && sessionA[0].size() == 2, "one publish per session carries every batch")
+        && expect(sessionA[0][0].lines.size() == 3 && sessionA[0][0].lines[0].sequence == 2,
+                  "lines written before subscribing are not replayed")
+        && expect(sessionA[0][1].lines.size() == 1 && sessionA[0][1].lines[0].level == mcdk::LogLevel::Error,
+                  "level filter")
+        && expect(sessionA[0][1].cursor == 4, "the cursor covers filtered-out lines too")
+        && expect(sessionB.size() == 1 && sessionB[0][0].lines.size() == 1
+                      && sessionB[0][0].lines[0].text == "[INFO] player1 joined",
+                  "pattern filter")
+        && expect(hub.unsubscribe("a", *errors) && !hub.unsubscribe("b", *everything), "unsubscribe is per session");
+}
+
+static bool testBackpressure() {
+    auto buffer = std::make_shared<mcdk::LogBuffer>(10'000);
+
+    Published          published;
+    mcdk::LogStreamHub hub(recordTo(published), {.maxLinesPerBatch = 50, .maxBacklog = 200, .maxPerSession = 1});
+    const auto         subscription = hub.subscribe("a", buffer, {});
+    const auto         second       = hub.subscribe("a", buffer, {});
+
+    for (int index = 0; index < 1000; ++index) {
+        buffer->add("flood " + std::to_string(index));
+    }
+    hub.pump();
+    hub.pump();
+
+    const auto& calls = published.calls["a"];
+    const bool  limited =
+        expect(subscription && !second, "per-session limit") && expect(calls.size() == 2, "two rounds")
+        && expect(calls[0][0].skipped == 800 && calls[0][0].lines.size() == 50, "a flood skips ahead, then rate-limits")
+        && expect(calls[0][0].lines.front().text == "flood 800", "delivery resumes within the backlog")
+        && expect(calls[1][0].skipped == 0 && calls[1][0].lines.front().text == "flood 850",
+                  "the next round continues where the last one stopped");
+
+    published.accept = false;
+    buffer->add("to a closed session");
+    hub.pump();
+    return limited && expect(hub.subscriptionCount() == 0, "a failed publish drops the session's subscriptions");
+}
+
+int main() {
+    const bool passed = testFilteredDelivery() && testBackpressure();
+    return passed ? 0 : 1;
+}
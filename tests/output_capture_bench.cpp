@@ -0,0 +1,238 @@
+// Drains a synthetic flood-writer child through OutputCapture and reports lines per second, plus how long the child's
+// writes ever blocked on a full pipe. The benchmark re-launches itself as the child.
+// Usage: output_capture_bench [lines] [stall-threshold-ms]
+#include <log_buffer.hpp>
+#include <log_classifier.hpp>
+#include <output_capture.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Child side: writes `lines` log lines in 64-line batches, timing every write. Half of the lines carry the
+    // "[Python] " marker and some look like engine output, like a busy mod does. Reports on stderr when done.
+    int flood(long long lines, double stallMs) {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        std::string batch;
+        double      maxWriteUs = 0;
+        double      stalledMs  = 0;
+        long long   stalls     = 0;
+        const auto  begin      = Clock::now();
+        for (long long index = 0; index < lines;) {
+            batch.clear();
+            for (int line = 0; line < 64 && index < lines; ++line, ++index) {
+                batch += index % 2 == 0 ? "[12:34:56][Python] tick " : "[Engine] render frame ";
+                batch += std::to_string(index);
+                batch += " entity=minecraft:zombie pos=(12.5, 64.0, -3.25)\n";
+            }
+            const auto writeBegin = Clock::now();
+            std::fwrite(batch.data(), 1, batch.size(), stdout);
+            std::fflush(stdout);
+            const double writeUs = std::chrono::duration<double, std::micro>(Clock::now() - writeBegin).count();
+            maxWriteUs           = std::max(maxWriteUs, writeUs);
+            if (writeUs >= stallMs * 1000.0) {
+                ++stalls;
+                stalledMs += writeUs / 1000.0;
+            }
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        std::fprintf(
+            stderr,
+            "flood %lld %.6f %.1f %lld %.3f\n",
+            lines,
+            seconds,
+            maxWriteUs,
+            stalls,
+            stalledMs
+        );
+        return 0;
+    }
+
+    struct Child {
+        mcdk::CaptureHandle out{};
+        mcdk::CaptureHandle err{};
+#ifdef _WIN32
+        HANDLE process = nullptr;
+#else
+        pid_t pid = -1;
+#endif
+    };
+
+    bool spawnFlood(const char* self, long long lines, double stallMs, Child& child) {
+#ifdef _WIN32
+        SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+        HANDLE              outWrite = nullptr;
+        HANDLE              errWrite = nullptr;
+        if (!CreatePipe(&child.out, &outWrite, &sa, 0) || !CreatePipe(&child.err, &errWrite, &sa, 0)) {
+            return false;
+        }
+        SetHandleInformation(child.out, HANDLE_FLAG_INHERIT, 0);
+        SetHandleInformation(child.err, HANDLE_FLAG_INHERIT, 0);
+        char path[MAX_PATH];
+        GetModuleFileNameA(nullptr, path, MAX_PATH);
+        std::string command = "\"" + std::string(path) + "\" --flood " + std::to_string(lines) + " "
+                            + std::to_string(stallMs);
+        STARTUPINFOA        si{};
+        PROCESS_INFORMATION pi{};
+        si.cb         = sizeof(si);
+        si.dwFlags    = STARTF_USESTDHANDLES;
+        si.hStdOutput = outWrite;
+        si.hStdError  = errWrite;
+        const bool ok = CreateProcessA(nullptr, command.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &si, &pi);
+        CloseHandle(outWrite);
+        CloseHandle(errWrite);
+        if (!ok) {
+            return false;
+        }
+        CloseHandle(pi.hThread);
+        child.process = pi.hProcess;
+        return true;
+#else
+        int outPipe[2];
+        int errPipe[2];
+        if (::pipe(outPipe) != 0 || ::pipe(errPipe) != 0) {
+            return false;
+        }
+        const auto linesText = std::to_string(lines);
+        const auto stallText = std::to_string(stallMs);
+        child.pid            = ::fork();
+        if (child.pid == 0) {
+            ::dup2(outPipe[1], STDOUT_FILENO);
+            ::dup2(errPipe[1], STDERR_FILENO);
+            for (const int fd : {outPipe[0], outPipe[1], errPipe[0], errPipe[1]}) {
+                ::close(fd);
+            }
+            ::execl(self, self, "--flood", linesText.c_str(), stallText.c_str(), static_cast<char*>(nullptr));
+            ::_exit(127);
+        }
+        ::close(outPipe[1]);
+        ::close(errPipe[1]);
+        child.out = outPipe[0];
+        child.err = errPipe[0];
+        return child.pid > 0;
+#endif
+    }
+
+    void reap(Child& child) {
+#ifdef _WIN32
+        WaitForSingleObject(child.process, INFINITE);
+        for (const HANDLE handle : {child.process, child.out, child.err}) {
+            CloseHandle(handle);
+        }
+#else
+        int status = 0;
+        ::waitpid(child.pid, &status, 0);
+        ::close(child.out);
+        ::close(child.err);
+#endif
+    }
+
+    struct Case {
+        const char* name;
+        std::size_t readSize;
+        bool        pipeline; // Classify every line and store it in a LogBuffer, as the launcher does.
+    };
+
+    bool run(const char* self, const Case& benchCase, long long lines, double stallMs) {
+        Child child;
+        if (!spawnFlood(self, lines, stallMs, child)) {
+            std::cerr << "Failed to start the flood writer\n";
+            return false;
+        }
+
+        mcdk::LogBuffer     buffer(50'000);
+        std::uint64_t       kept = 0;
+        std::string         report;
+        mcdk::OutputCapture capture({.readSize = benchCase.readSize});
+        const auto          begin = Clock::now();
+        capture.start(
+            child.out,
+            child.err,
+            [&](std::string_view line) {
+                if (!benchCase.pipeline) {
+                    ++kept;
+                    return;
+                }
+                const auto kind = mcdk::logLineClassifier().classify(line);
+                if (kind != mcdk::LogLineKind::EngineNoise) {
+                    buffer.add(line);
+                    ++kept;
+                }
+            },
+            [&](std::string_view line) { report.assign(line); }
+        );
+        capture.join();
+        const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        reap(child);
+
+        std::istringstream childStats(report);
+        std::string        tag;
+        long long          written      = 0;
+        double             childSeconds = 0;
+        double             maxWriteUs   = 0;
+        long long          stalls       = 0;
+        double             stalledMs    = 0;
+        if (!(childStats >> tag >> written >> childSeconds >> maxWriteUs >> stalls >> stalledMs) || tag != "flood") {
+            std::cerr << benchCase.name << ": the flood writer did not report (" << report << ")\n";
+            return false;
+        }
+        const auto stats = capture.stats();
+        std::printf(
+            "%-22s %10.0f lines/s %8.1f MB/s %8llu reads  kept %-9llu "
+            "child max write %8.1f us, %lld stall(s) %.1f ms\n",
+            benchCase.name,
+            static_cast<double>(written) / seconds,
+            static_cast<double>(stats.bytes) / seconds / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(stats.reads),
+            static_cast<unsigned long long>(kept),
+            maxWriteUs,
+            stalls,
+            stalledMs
+        );
+        return stalls == 0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::string_view(argv[1]) == "--flood") {
+        return flood(std::atoll(argv[2]), std::atof(argv[3]));
+    }
+    const long long lines   = argc > 1 ? std::atoll(argv[1]) : 2'000'000;
+    const double    stallMs = argc > 2 ? std::atof(argv[2]) : 50.0;
+
+    const std::vector<Case> cases = {
+        {"4 KiB reads, count", 4 * 1024, false},
+        {"64 KiB reads, count", 64 * 1024, false},
+        {"64 KiB reads, pipeline", 64 * 1024, true},
+    };
+    bool neverStalled = true;
+    for (const auto& benchCase : cases) {
+        neverStalled &= run(argv[0], benchCase, lines, stallMs);
+    }
+    // A stall means the child waited on a full pipe for longer than the threshold: the capture fell behind.
+    return neverStalled ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#include <output_capture.hpp>
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+// Feeds text in chunks of every size from 1 byte up, so each line boundary lands in every position of a read.
+static bool splitsLikeWhole(std::string_view text, const std::vector<std::string>& expected) {
+    for (std::size_t chunk = 1; chunk <= text.size(); ++chunk) {
+        mcdk::LineSplitter       splitter;
+        std::vector<std::string> lines;
+        const auto               collect = [&](std::string_view line) { lines.emplace_back(line); };
+        for (std::size_t offset = 0; offset < text.size(); offset += chunk) {
+            splitter.append(text.substr(offset, chunk), collect);
+        }
+        splitter.finish(collect);
+        if (lines != expected) {
+            std::cerr << "Chunk size " << chunk << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool testSplitter() {
+    const std::string_view text = "first\r\n\nthird line\nno newline at end";
+    const bool             split =
+        expect(splitsLikeWhole(text, {"first", "", "third line", "no newline at end"}), "any read size splits alike");
+
+    mcdk::LineSplitter       python({.filterPython = true});
+    std::vector<std::string> kept;
+    const auto               keep = [&](std::string_view line) { kept.emplace_back(line); };
+    python.append("engine noise\n[12:00:00][Python] hello\r\n[Python]no space\n", keep);
+    python.append("tail [Python] ", keep);
+    python.finish(keep);
+
+    mcdk::LineSplitter       bounded({.maxLineBytes = 8});
+    std::vector<std::string> pieces;
+    const auto               piece = [&](std::string_view line) { pieces.emplace_back(line); };
+    bounded.append("0123456", piece);
+    bounded.append("789", piece);
+    bounded.append("ab\n", piece);
+    return split
+        && expect(kept == std::vector<std::string>{"[12:00:00][Python] hello", "tail [Python] "}, "Python filter")
+        && expect(pieces == std::vector<std::string>{"0123456789", "ab"}, "an overlong pending line is flushed");
+}
+
+namespace {
+    struct TestPipe {
+        mcdk::CaptureHandle read{};
+        mcdk::CaptureHandle write{};
+
+        TestPipe() {
+#ifdef _WIN32
+            CreatePipe(&read, &write, nullptr, 0);
+#else
+            int fds[2] = {-1, -1};
+            if (::pipe(fds) == 0) {
+                read  = fds[0];
+                write = fds[1];
+            }
+#endif
+        }
+
+        void send(std::string_view data) const {
+            while (!data.empty()) {
+#ifdef _WIN32
+                DWORD written = 0;
+                if (!WriteFile(write, data.data(), static_cast<DWORD>(data.size()), &written, nullptr)) return;
+#else
+                const auto written = ::write(write, data.data(), data.size());
+                if (written <= 0) return;
+#endif
+                data.remove_prefix(static_cast<std::size_t>(written));
+            }
+        }
+
+        static void close(mcdk::CaptureHandle handle) {
+#ifdef _WIN32
+            CloseHandle(handle);
+#else
+            ::close(handle);
+#endif
+        }
+    };
+} // namespace
+
+static bool testCapture() {
+    constexpr int LineCount = 20'000;
+    TestPipe      out;
+    TestPipe      err;
+
+    std::vector<std::string> outLines;
+    std::vector<std::string> errLines;
+    mcdk::OutputCapture      capture({.readSize = 4096});
+    capture.start(
+        out.read,
+        err.read,
+        [&](std::string_view line) { outLines.emplace_back(line); },
+        [&](std::string_view line) { errLines.emplace_back(line); }
+    );
+
+    // Both writers run concurrently; with one reader blocked on the other pipe, either would stall on a full pipe.
+    std::thread outWriter([&] {
+        std::string batch;
+        for (int index = 0; index < LineCount; ++index) {
+            batch += "stdout line " + std::to_string(index) + "\r\n";
+            if (batch.size() > 3000) {
+                out.send(batch);
+                batch.clear();
+            }
+        }
+        out.send(batch + "unterminated");
+        TestPipe::close(out.write);
+    });
+    std::thread errWriter([&] {
+        for (int index = 0; index < 100; ++index) {
+            err.send("stderr line " + std::to_string(index) + "\n");
+        }
+        TestPipe::close(err.write);
+    });
+    outWriter.join();
+    errWriter.join();
+    capture.join();
+    TestPipe::close(out.read);
+    TestPipe::close(err.read);
+
+    bool ordered = outLines.size() == LineCount + 1 && errLines.size() == 100;
+    for (int index = 0; ordered && index < LineCount; ++index) {
+        ordered = outLines[static_cast<std::size_t>(index)] == "stdout line " + std::to_string(index);
+    }
+    const auto stats = capture.stats();
+    return expect(ordered, "every line arrives once, in order, without '\\r'")
+        && expect(outLines.back() == "unterminated", "the last unterminated line is delivered at end of file")
+        && expect(errLines.back() == "stderr line 99", "stderr is drained alongside stdout")
+        && expect(stats.lines == LineCount + 101 && stats.reads > 0, "stats count delivered lines");
+}
+
+int main() {
+    const bool passed = testSplitter() && testCapture();
+    return passed ? 0 : 1;
+}
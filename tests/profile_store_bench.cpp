@@ -0,0 +1,167 @@
+// Loads one synthetic Native capture both ways a completed job can come back from disk: parsing the collector JSON
+// and building the columnar store, or mapping the encoded profile. Reports load time, resident memory growth and the
+// first hotspot query after each load. The mapped case runs first so that it cannot reuse the JSON case's heap.
+// Usage: profile_store_bench [zones] [query-limit]
+#include <performance/profile_store.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using namespace mcdk::performance;
+
+    double residentMiB() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        counters.cb = sizeof(counters);
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+        return static_cast<double>(counters.WorkingSetSize) / (1024.0 * 1024.0);
+#else
+        long long     pages    = 0;
+        long long     resident = 0;
+        std::ifstream statm("/proc/self/statm");
+        statm >> pages >> resident;
+        return static_cast<double>(resident) * static_cast<double>(::sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+#endif
+    }
+
+    double millisecondsSince(Clock::time_point begin) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    // Zones spread over a few hundred source locations and eight threads, each thread with a two-level call tree,
+    // which is the shape the Native bridge reports.
+    nlohmann::json nativeCapture(long long zoneCount) {
+        auto zones = nlohmann::json::array();
+        for (long long index = 0; index < zoneCount; ++index) {
+            const auto location = index % 397;
+            zones.push_back({
+                {"id", index},
+                {"name", "Engine::Stage" + std::to_string(location)},
+                {"sourceFile", "engine/src/stage_" + std::to_string(location % 61) + ".cpp"},
+                {"sourceLine", 10 + location},
+                {"threadId", std::to_string(index % 8)},
+                {"threadName", "Worker " + std::to_string(index % 8)},
+                {"calls", 1 + index % 17},
+                {"totalNanoseconds", 1000 + (index * 7919) % 900000},
+                {"selfNanoseconds", 500 + (index * 104729) % 400000},
+                {"meanNanoseconds", 100 + index % 5000},
+                {"maximumNanoseconds", 2000 + (index * 31) % 100000},
+                {"slowestCalls", nlohmann::json::array({{{"startNanoseconds", index}, {"durationNanoseconds", 900}}})},
+            });
+        }
+        auto threads = nlohmann::json::array();
+        for (int thread = 0; thread < 8; ++thread) {
+            auto roots = nlohmann::json::array();
+            for (int root = 0; root < 64; ++root) {
+                auto children = nlohmann::json::array();
+                for (int child = 0; child < 16; ++child) {
+                    children.push_back({{"id", (thread * 64 + root) * 17 + child + 1}, {"name", "child"},
+                        {"sourceFile", "engine/src/tree.cpp"}, {"sourceLine", child}, {"calls", 1},
+                        {"totalNanoseconds", 100}, {"selfNanoseconds", 100}});
+                }
+                roots.push_back({{"id", (thread * 64 + root) * 17}, {"name", "root"}, {"calls", 1},
+                    {"totalNanoseconds", 1600}, {"selfNanoseconds", 0}, {"children", std::move(children)}});
+            }
+            threads.push_back({{"id", std::to_string(thread)}, {"name", "Worker " + std::to_string(thread)},
+                {"calls", zoneCount / 8}, {"totalNanoseconds", zoneCount * 1000}, {"roots", std::move(roots)}});
+        }
+        return {{"zones", std::move(zones)}, {"threads", std::move(threads)}};
+    }
+
+    // What a first /query of the hotspots view does: sort by total time and materialize one page.
+    double firstQuery(const ProfileStore& store, std::size_t limit) {
+        const auto begin = Clock::now();
+        const auto* view = store.view("hotspots");
+        auto        rows = filterRows(store, *view, "");
+        sortRows(store, *view, rows, "total_time", true);
+        std::size_t fields = 0;
+        for (std::size_t index = 0; index < rows.size() && index < limit; ++index) {
+            fields += materializeRecord(store, *view, rows[index]).fields.size();
+        }
+        const double elapsed = millisecondsSince(begin);
+        if (fields == 0) std::cerr << "The hotspot page is empty\n";
+        return elapsed;
+    }
+
+    void report(const char* name, double loadMs, double residentDelta, double queryMs) {
+        std::printf("%-24s load %9.2f ms  resident +%8.1f MiB  first query %8.2f ms\n", name, loadMs, residentDelta, queryMs);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long long   zones = argc > 1 ? std::atoll(argv[1]) : 200'000;
+    const std::size_t limit = argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 50;
+
+    const auto directory = std::filesystem::temp_directory_path()
+                         / ("mcdev-profile-store-bench-" + std::to_string(Clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(directory);
+    {
+        const auto data  = nativeCapture(zones);
+        const auto image = encodeProfile(ProfilerKind::NativeCpu, data);
+        std::ofstream(directory / "data.json", std::ios::binary) << data.dump();
+        std::ofstream(directory / "data.mcprof", std::ios::binary)
+            .write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    }
+    std::printf(
+        "%lld zones: data.json %.1f MiB, data.mcprof %.1f MiB\n",
+        zones,
+        static_cast<double>(std::filesystem::file_size(directory / "data.json")) / (1024.0 * 1024.0),
+        static_cast<double>(std::filesystem::file_size(directory / "data.mcprof")) / (1024.0 * 1024.0)
+    );
+
+    bool loaded = true;
+    {
+        const double before = residentMiB();
+        const auto   begin  = Clock::now();
+        auto         image  = ProfileImage::map(directory / "data.mcprof");
+        auto         store  = image ? openProfileStore(*image) : std::unexpected(image.error());
+        const double loadMs = millisecondsSince(begin);
+        if (store) {
+            const double queryMs = firstQuery(**store, limit);
+            report("mapped data.mcprof", loadMs, residentMiB() - before, queryMs);
+        } else {
+            std::cerr << "Mapping failed: " << store.error().message << '\n';
+            loaded = false;
+        }
+    }
+    {
+        const double  before = residentMiB();
+        const auto    begin  = Clock::now();
+        std::ifstream input(directory / "data.json", std::ios::binary);
+        const auto    data   = nlohmann::json::parse(input, nullptr, false);
+        auto          store  = buildProfileStore(ProfilerKind::NativeCpu, data);
+        const double  loadMs = millisecondsSince(begin);
+        if (store) {
+            const double queryMs = firstQuery(**store, limit);
+            report("parsed data.json", loadMs, residentMiB() - before, queryMs);
+        } else {
+            std::cerr << "Building failed: " << store.error().message << '\n';
+            loaded = false;
+        }
+    }
+    std::error_code ignored;
+    std::filesystem::remove_all(directory, ignored);
+    return loaded ? 0 : 1;
+}
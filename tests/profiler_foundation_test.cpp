@@ -1,23 +1,41 @@
 #include <mc_profiler_mcp.hpp>
 #include <mcp_tool_definitions.hpp>
+#include <performance/collector_rows.hpp>
+#include <performance/profile_filter.hpp>
+#include <performance/profile_flame.hpp>
+#include <performance/profile_frames.hpp>
+#include <performance/profile_interchange.hpp>
+#include <performance/profile_memory.hpp>
+#include <performance/profile_recorder.hpp>
+#include <performance/profile_sampling.hpp>
+#include <performance/profile_store.hpp>
+#include <performance/profile_trend.hpp>
 #include <performance/profiler_runtime_owner.hpp>
 #include <performance/profiler_service_factory.hpp>
+#include <performance/query_cache.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <expected>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include <zlib.h>
+
 namespace {
 
     using namespace mcdk::performance;
@@ -37,6 +55,7 @@ namespace {
         std::expected<JobSnapshot, ProfilerError>  status(const JobId&) const override { return JobSnapshot{}; }
         std::expected<JobSnapshot, ProfilerError>  stop(const JobId&) override { return JobSnapshot{}; }
         std::expected<void, ProfilerError>         discard(const JobId&) override { return {}; }
+        std::expected<JobSnapshot, ProfilerError>  snapshot(const JobId&) override { return JobSnapshot{}; }
         std::expected<QueryPage, ProfilerError> query(const QueryRequest&) const override {
             QueryRecord record{.id = "fake:0"};
             record.fields.emplace("total_time", ProfilerField{1.0, "seconds"});
@@ -50,6 +69,7 @@ namespace {
         std::expected<CompareResult, ProfilerError> compare(const CompareRequest&) const override {
             return CompareResult{};
         }
+        std::expected<TrendResult, ProfilerError> trend(const TrendRequest&) const override { return TrendResult{}; }
         std::expected<DetailResult, ProfilerError> detail(const DetailRequest&) const override {
             return DetailResult{};
         }
@@ -63,6 +83,15 @@ namespace {
         std::expected<Capabilities, ProfilerError>  inspectCapabilities(const DoctorRequest&) override {
             return Capabilities{};
         }
+        std::expected<TriggerSnapshot, ProfilerError> arm(const TriggerRequest& request) override {
+            return TriggerSnapshot{.id = "trigger-fake", .condition = request.condition, .maximumCaptures = request.maximumCaptures};
+        }
+        std::expected<std::vector<TriggerSnapshot>, ProfilerError> triggers() const override {
+            return std::vector<TriggerSnapshot>{TriggerSnapshot{.id = "trigger-fake", .captures = 1, .jobs = {"job"}}};
+        }
+        std::expected<TriggerSnapshot, ProfilerError> disarm(const TriggerId& id) override {
+            return TriggerSnapshot{.id = id, .state = TriggerState::Disarmed};
+        }
         void shutdown() noexcept override {
             if (!stopped_.exchange(true)) {
                 ++shutdownCount_;
@@ -179,10 +208,26 @@ namespace {
             "start help explains temporary memory storage as the default"
         );
         passed &= expect(
-            startHelp && (*startHelp)["structuredContent"]["data"]["optional"].size() == 6
+            startHelp && (*startHelp)["structuredContent"]["data"]["optional"].size() == 11
                 && (*startHelp)["structuredContent"]["data"].contains("bounds"),
             "start help lists all bounded optional fields"
         );
+        passed &= expect(
+            startHelp && (*startHelp)["structuredContent"]["data"]["modes"].value("default", "") == "capture",
+            "start help explains capture and flight recorder modes"
+        );
+        passed &= expect(
+            startHelp && (*startHelp)["structuredContent"]["data"]["engines"].value("default", "") == "tracing"
+                && (*startHelp)["structuredContent"]["data"]["engines"].contains("sampling"),
+            "start help explains the tracing and sampling engines"
+        );
+        const auto snapshotHelp = mcdk::mc_profiler_mcp::tryBuildLocalResult(
+            {{"op", "/help"}, {"args", {{"topic", "/snapshot"}}}}
+        );
+        passed &= expect(
+            snapshotHelp && (*snapshotHelp)["structuredContent"]["data"]["required"].size() == 1,
+            "snapshot help requires the recorder job id"
+        );
         const auto queryHelp = mcdk::mc_profiler_mcp::tryBuildLocalResult(
             {{"op", "/help"}, {"args", {{"topic", "/query"}}}}
         );
@@ -192,6 +237,19 @@ namespace {
                     != std::string::npos,
             "query help documents profiler views and call-tree parent filtering"
         );
+        passed &= expect(
+            queryHelp && (*queryHelp)["structuredContent"]["data"]["filter_grammar"]["syntax"].is_array()
+                && !(*queryHelp)["structuredContent"]["data"]["filter_grammar"]["examples"].empty(),
+            "query help exposes the filter expression grammar"
+        );
+        const auto trendHelp = mcdk::mc_profiler_mcp::tryBuildLocalResult(
+            {{"op", "/help"}, {"args", {{"topic", "/trend"}}}}
+        );
+        passed &= expect(
+            trendHelp && (*trendHelp)["structuredContent"]["data"]["required"].size() == 2
+                && (*trendHelp)["structuredContent"]["data"]["bounds"].contains("candidate_runs"),
+            "trend help bounds the run window and the regression threshold"
+        );
         const auto cleanupHelp = mcdk::mc_profiler_mcp::tryBuildLocalResult(
             {{"op", "/help"}, {"args", {{"topic", "/cleanup"}}}}
         );
@@ -211,8 +269,8 @@ namespace {
             {{"op", "/help"}, {"args", {{"topic", "/export"}}}}
         );
         passed &= expect(
-            exportHelp && (*exportHelp)["structuredContent"]["data"]["formats"].size() == 2,
-            "export help advertises Markdown and SVG"
+            exportHelp && (*exportHelp)["structuredContent"]["data"]["formats"].size() == 7,
+            "export help advertises reports, stack exports, pprof and Chrome traces"
         );
 
         const auto guide  = mcdk::mc_profiler_mcp::tryBuildLocalResult({{"op", "/guide"}});
@@ -327,6 +385,44 @@ namespace {
                 && comparison["structuredContent"]["data"].value("metric", "missing").empty(),
             "runtime adapter accepts bounded compare arguments"
         );
+        const auto armed = mcdk::mc_profiler_mcp::handleRuntimeRequest(
+            owner.provider(),
+            {
+                {"op", "/arm"},
+                {"args", {
+                    {"condition", "tick_time"}, {"tick_ms", 80}, {"consecutive_ticks", 4}, {"max_captures", 2},
+                    {"capture", {{"kind", "python.cpu"}, {"target", "server"}, {"duration_seconds", 10}}},
+                }},
+            }
+        );
+        passed &= expect(
+            armed["structuredContent"].value("ok", false)
+                && armed["structuredContent"]["data"]["trigger"].value("id", "") == "trigger-fake"
+                && armed["structuredContent"]["data"]["trigger"].value("max_captures", 0) == 2,
+            "runtime adapter arms a tick trigger with its capture"
+        );
+        const auto mixed = mcdk::mc_profiler_mcp::handleRuntimeRequest(
+            owner.provider(),
+            {
+                {"op", "/arm"},
+                {"args", {{"condition", "log_pattern"}, {"pattern", "ERROR"}, {"tick_ms", 80}, {"capture", {{"kind", "python.cpu"}}}}},
+            }
+        );
+        const auto badCapture = mcdk::mc_profiler_mcp::handleRuntimeRequest(
+            owner.provider(),
+            {{"op", "/arm"}, {"args", {{"condition", "log_pattern"}, {"pattern", "ERROR"}, {"capture", {{"target", "server"}}}}}}
+        );
+        passed &= expect(
+            mixed["structuredContent"]["error"].value("code", "") == "INVALID_ARGUMENTS"
+                && badCapture["structuredContent"]["error"].value("code", "") == "INVALID_ARGUMENTS",
+            "arm rejects options of the other condition and captures without a kind"
+        );
+        const auto listed = mcdk::mc_profiler_mcp::handleRuntimeRequest(owner.provider(), {{"op", "/triggers"}});
+        passed &= expect(
+            listed["structuredContent"]["data"]["triggers"].size() == 1
+                && listed["structuredContent"]["next_calls"][0]["args"].value("job_id", "") == "job",
+            "trigger listing points at the latest capture a trigger started"
+        );
         return passed;
     }
 
@@ -369,6 +465,7 @@ namespace {
 
         std::atomic<int> startCalls = 0;
         std::atomic<int> collectCalls = 0;
+        std::atomic<bool> boundsSubstituted = false;
         auto service = createProfilerService({
             .executeCode = [&](std::string code, ProfileTarget, std::chrono::milliseconds)
                 -> std::expected<nlohmann::json, GameExecutionError> {
@@ -379,6 +476,9 @@ namespace {
                 }
                 if (code.find("_stats=yappi.get_func_stats()") != std::string::npos) {
                     ++collectCalls;
+                    boundsSubstituted = code.find("_all[:" + std::to_string(CollectorMaximumFunctions) + "]") != std::string::npos
+                        && code.find(">=" + std::to_string(CollectorMaximumCalls)) != std::string::npos
+                        && code.find("@MAX_") == std::string::npos;
                     return nlohmann::json{
                         {"ok", true}, {"clock", "WALL"}, {"elapsed", 1.0}, {"total", 1},
                         {"truncated", false},
@@ -427,10 +527,16 @@ namespace {
 
         passed &= expect(snapshot.state == JobState::Completed, "server deadline completes capture without a stop call");
         passed &= expect(startCalls == 1 && collectCalls == 1, "deadline performs one start and one collect");
+        passed &= expect(boundsSubstituted.load(), "the collector receives the shared capture bounds");
         passed &= expect(
             std::filesystem::is_regular_file(root / "profiles" / started->id / "manifest.json"),
             "manifest is committed after data and summary"
         );
+        passed &= expect(
+            std::filesystem::is_regular_file(root / "profiles" / started->id / "data.mcprof")
+                && !std::filesystem::exists(root / "profiles" / started->id / "data.json"),
+            "disk jobs persist the encoded profile rather than collector JSON"
+        );
         auto page = (*service)->query(QueryRequest{.jobId = started->id, .view = "hotspots", .limit = 20});
         passed &= expect(page && page->records.size() == 1, "completed bounded data is queryable through typed API");
         (*service)->shutdown();
@@ -551,6 +657,11 @@ namespace {
             svg && svg->sha256.size() == 64 && std::filesystem::is_regular_file(svg->path),
             "temporary memory result exports SVG explicitly"
         );
+        const auto memoryTrace = (*service)->exportReport({started->id, ExportFormat::ChromeTrace});
+        passed &= expect(
+            !memoryTrace && memoryTrace.error().code == "EXPORT_FORMAT_UNSUPPORTED",
+            "Chrome trace export is refused for Python memory jobs"
+        );
         if (markdown) {
             std::ifstream input(markdown->path, std::ios::binary);
             const std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
@@ -761,168 +872,1673 @@ namespace {
         return passed;
     }
 
-    bool testNativeCalltreeChildrenUseExactParentId() {
-        const auto root = std::filesystem::temp_directory_path()
-                        / ("mcdev-profiler-calltree-" + std::to_string(
-                            std::chrono::steady_clock::now().time_since_epoch().count()
-                        ));
-        const auto profiles = root / "profiles";
-        const auto jobId = std::string("native-calltree-job");
-        const auto jobDirectory = profiles / jobId;
-        std::error_code ignored;
-        std::filesystem::create_directories(jobDirectory, ignored);
-
-        const auto node = [](std::int64_t id, nlohmann::json children = nlohmann::json::array()) {
-            return nlohmann::json{
-                {"id", id}, {"name", "zone-" + std::to_string(id)}, {"sourceFile", "Engine"},
-                {"sourceLine", 0}, {"calls", 1}, {"totalNanoseconds", 100}, {"selfNanoseconds", 50},
-                {"meanNanoseconds", 100}, {"maximumNanoseconds", 100}, {"children", std::move(children)},
+    bool testFlightRecorderKeepsABoundedWindow() {
+        using Json = nlohmann::json;
+        const auto segment = [](double elapsed, double tickTime, Json extra = Json::array()) {
+            auto nodes = Json::array({
+                Json::array({0, "pack/a.py", 3, "tick", 2, 2, tickTime / 2, tickTime, 1, "Main", "client"}),
+                Json::array({1, "pack/b.py", 9, "step", 4, 4, tickTime / 4, tickTime / 2, 1, "Main", "client"}),
+            });
+            for (auto& row : extra) nodes.push_back(std::move(row));
+            return Json{
+                {"ok", true}, {"clock", "WALL"}, {"elapsed", elapsed}, {"total", nodes.size()}, {"truncated", false},
+                {"targets", Json::array({"client"})}, {"nodes", std::move(nodes)},
+                {"edges", Json::array({Json::array({0, 1, 4, tickTime / 4, tickTime / 2})})},
             };
         };
-        const nlohmann::json data{
-            {"threads", nlohmann::json::array({
-                nlohmann::json{
-                    {"id", "1"}, {"name", "Main"},
-                    {"roots", nlohmann::json::array({
-                        node(39, nlohmann::json::array({node(40)})),
-                        node(390, nlohmann::json::array({node(392)})),
-                    })},
-                },
-            })},
-            {"zones", nlohmann::json::array({
-                nlohmann::json{
-                    {"id", 0}, {"name", "parse"}, {"sourceFile", "engine/json.cpp"}, {"sourceLine", 8},
-                    {"threadId", "1"}, {"threadName", "Main"}, {"calls", 1},
-                    {"totalNanoseconds", 100}, {"selfNanoseconds", 40},
-                    {"meanNanoseconds", 100}, {"maximumNanoseconds", 100},
-                    {"slowestCalls", nlohmann::json::array({
-                        nlohmann::json{{"startNanoseconds", 10}, {"durationNanoseconds", 100}}
-                    })},
-                },
-                nlohmann::json{
-                    {"id", 1}, {"name", "parse"}, {"sourceFile", "engine/json.cpp"}, {"sourceLine", 8},
-                    {"threadId", "2"}, {"threadName", "Worker"}, {"calls", 2},
-                    {"totalNanoseconds", 200}, {"selfNanoseconds", 60},
-                    {"meanNanoseconds", 100}, {"maximumNanoseconds", 150},
-                    {"slowestCalls", nlohmann::json::array({
-                        nlohmann::json{{"startNanoseconds", 20}, {"durationNanoseconds", 150}}
-                    })},
-                },
-            })},
-        };
-        const nlohmann::json manifest{
-            {"job_id", jobId}, {"kind", "native.cpu"}, {"state", "completed"},
-            {"partial", false}, {"created_at", "2026-01-01T00:00:00Z"},
-            {"completed_at", "2026-01-01T00:00:01Z"},
-        };
-        {
-            std::ofstream(jobDirectory / "manifest.json") << manifest.dump();
-            std::ofstream(jobDirectory / "data.json") << data.dump();
-            std::ofstream(jobDirectory / "summary.json") << nlohmann::json::object().dump();
+        const auto origin = FlightRecorder::Clock::time_point{} + std::chrono::hours(1);
+        FlightRecorder recorder(std::chrono::seconds(3), 1024 * 1024);
+        for (int second = 1; second <= 5; ++second) recorder.append(segment(1.0, 0.1 * second), origin + std::chrono::seconds(second));
+        bool passed = expect(
+            recorder.segments() == 3 && std::abs(recorder.covered() - 3.0) < 1e-9,
+            "segments that ended before the window leave the ring"
+        );
+
+        const auto window = recorder.merged();
+        passed &= expect(window["nodes"].size() == 2 && window["edges"].size() == 1, "one function per identity remains");
+        passed &= expect(
+            window["nodes"].size() == 2 && window["nodes"][0][3] == "tick" && window["nodes"][0][4] == 6
+                && std::abs(window["nodes"][0][7].get<double>() - 1.2) < 1e-9,
+            "calls and times of the retained segments are summed"
+        );
+        passed &= expect(
+            window["edges"].size() == 1 && window["edges"][0][0] == 0 && window["edges"][0][1] == 1
+                && window["edges"][0][2] == 12,
+            "calls are merged and renumbered to the merged functions"
+        );
+        passed &= expect(
+            window["recorder"].value("segments", 0) == 3 && window.value("elapsed", 0.0) == 3.0,
+            "the window reports the seconds it covers"
+        );
+        const auto store = buildProfileStore(ProfilerKind::PythonCpu, window);
+        passed &= expect(store && (*store)->view("hotspots")->rows.size() == 2, "a merged window builds a Python CPU profile");
+
+        auto wide = Json::array();
+        for (int index = 2; index < 600; ++index) {
+            wide.push_back(Json::array({index, "pack/wide.py", index, "f" + std::to_string(index), 1, 1, 0.0, 0.001, 1, "Main", nullptr}));
         }
+        FlightRecorder bounded(std::chrono::seconds(60), 64 * 1024);
+        for (int second = 1; second <= 4; ++second) bounded.append(segment(1.0, 1.0, wide), origin + std::chrono::seconds(second));
+        passed &= expect(bounded.segments() == 1, "the oldest segments leave while the ring exceeds its byte budget");
+        const auto boundedWindow = bounded.merged();
+        passed &= expect(
+            boundedWindow["nodes"].size() == 512 && boundedWindow.value("truncated", false)
+                && boundedWindow.value("total", 0) == 600,
+            "a merged window is bounded as one capture is and reports truncation"
+        );
+        return passed;
+    }
 
+    bool testFlightRecorderSnapshotsIntoJobs() {
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-recorder-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        std::atomic<int> drains = 0;
+        std::mutex codesMutex;
+        std::vector<std::string> codes;
         auto service = createProfilerService({
-            .executeCode = {},
+            .executeCode = [&](std::string code, ProfileTarget, std::chrono::milliseconds)
+                -> std::expected<nlohmann::json, GameExecutionError> {
+                {
+                    std::lock_guard lock(codesMutex);
+                    codes.push_back(code);
+                }
+                if (code.find("yappi.start") != std::string::npos) {
+                    return nlohmann::json{{"ok", true}, {"running", true}, {"clock", "WALL"}};
+                }
+                if (code.find("yappi.get_func_stats") != std::string::npos) {
+                    ++drains;
+                    return nlohmann::json{
+                        {"ok", true}, {"clock", "WALL"}, {"elapsed", 0.5}, {"total", 1}, {"truncated", false},
+                        {"targets", nlohmann::json::array()},
+                        {"nodes", nlohmann::json::array({
+                            nlohmann::json::array({0, "pack/foo.py", 12, "tick", 1, 1, 0.01, 0.02, 1, "Main", "client"})
+                        })},
+                        {"edges", nlohmann::json::array()},
+                    };
+                }
+                return nlohmann::json(true);
+            },
             .currentGameProcessId = [] { return std::uint32_t{0}; },
-            .storageRoot = profiles,
+            .storageRoot = root / "profiles",
             .executableDirectory = root,
         });
-        bool passed = expect(service.has_value(), "native calltree fixture service is constructible");
-        if (service) {
-            auto missingParent = (*service)->query(QueryRequest{
-                .jobId = jobId,
-                .view = "calltree-children",
-                .limit = 20,
-            });
-            passed &= expect(
-                !missingParent && missingParent.error().code == "CALLTREE_PARENT_REQUIRED",
-                "calltree child queries require an explicit parent node id"
-            );
-            auto children = (*service)->query(QueryRequest{
-                .jobId = jobId,
-                .view = "calltree-children",
-                .filter = "node:39",
-                .limit = 20,
-            });
-            passed &= expect(
-                children && children->records.size() == 1 && children->records.front().id == "node:40",
-                "calltree child selection does not prefix-match unrelated node ids"
-            );
-            auto rootDetail = (*service)->detail(DetailRequest{
-                .jobId = jobId,
-                .view = "calltree-roots",
-                .recordId = "node:39",
-            });
-            passed &= expect(
-                rootDetail && rootDetail->related.size() == 1 && rootDetail->related.front().id == "node:40",
-                "calltree root detail returns its children without unrelated roots"
-            );
-            auto sources = (*service)->query(QueryRequest{
-                .jobId = jobId,
-                .view = "source-locations",
-                .limit = 20,
+        bool passed = expect(service.has_value(), "flight recorder service is constructible");
+        if (!service) return false;
+
+        auto memory = (*service)->start(StartRequest{.kind = ProfilerKind::PythonMemory, .mode = ProfileMode::Recorder});
+        passed &= expect(
+            !memory && memory.error().code == "RECORDER_KIND_UNSUPPORTED",
+            "flight recorder mode is refused for kinds that cannot be drained"
+        );
+        auto starved = (*service)->start(StartRequest{.mode = ProfileMode::Recorder, .recorderBytes = 1024});
+        passed &= expect(!starved && starved.error().code == "INVALID_RECORDER_BUDGET", "the recorder budget is bounded");
+
+        auto recorder = (*service)->start(StartRequest{
+            .duration = std::chrono::seconds(30), .mode = ProfileMode::Recorder,
+        });
+        passed &= expect(
+            recorder && recorder->mode == ProfileMode::Recorder && recorder->state == JobState::Running,
+            "a flight recorder starts as a running job"
+        );
+        if (!recorder) {
+            (*service)->shutdown();
+            std::error_code ignored;
+            std::filesystem::remove_all(root, ignored);
+            return false;
+        }
+        auto busy = (*service)->start(StartRequest{});
+        passed &= expect(!busy && busy.error().code == "PROFILER_BUSY", "a running recorder owns the profiler");
+
+        auto frozen = (*service)->snapshot(recorder->id);
+        passed &= expect(
+            frozen && frozen->id != recorder->id && frozen->state == JobState::Completed
+                && frozen->mode == ProfileMode::Capture,
+            "snapshot freezes the window into a separate completed job"
+        );
+        auto page = frozen ? (*service)->query(QueryRequest{.jobId = frozen->id, .view = "hotspots"})
+                           : std::expected<QueryPage, ProfilerError>(std::unexpected(frozen.error()));
+        passed &= expect(page && page->records.size() == 1, "a frozen window is queryable like a capture");
+        passed &= expect(
+            (*service)->status(recorder->id).value_or(JobSnapshot{}).state == JobState::Running,
+            "the recorder keeps running after a snapshot"
+        );
+        auto notRecorder = frozen ? (*service)->snapshot(frozen->id)
+                                  : std::expected<JobSnapshot, ProfilerError>(std::unexpected(frozen.error()));
+        passed &= expect(
+            !notRecorder && notRecorder.error().code == "JOB_NOT_RECORDER",
+            "only flight recorders can be snapshotted"
+        );
+
+        (void)(*service)->stop(recorder->id);
+        JobSnapshot stopped;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(4);
+        do {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            stopped = (*service)->status(recorder->id).value_or(JobSnapshot{});
+        } while (stopped.state != JobState::Completed && stopped.state != JobState::Failed
+                 && std::chrono::steady_clock::now() < deadline);
+        passed &= expect(stopped.state == JobState::Completed, "stopping a recorder completes it with its last window");
+        auto finalPage = (*service)->query(QueryRequest{.jobId = recorder->id, .view = "hotspots"});
+        passed &= expect(
+            finalPage && finalPage->records.size() == 1
+                && std::get<std::int64_t>(finalPage->records.front().fields.at("calls").value) == drains.load(),
+            "the recorder's own result sums every drained segment in its window"
+        );
+        {
+            std::lock_guard lock(codesMutex);
+            const auto drain = std::find_if(codes.begin(), codes.end(), [](const std::string& code) {
+                return code.starts_with("import yappi,threading,time") && code.find("get_func_stats") != std::string::npos;
             });
             passed &= expect(
-                sources && sources->records.size() == 1
-                    && std::get<std::int64_t>(sources->records[0].fields.at("total_time").value) == 300
-                    && std::get<std::int64_t>(sources->records[0].fields.at("self_time").value) == 100
-                    && std::get<std::int64_t>(sources->records[0].fields.at("thread_count").value) == 2,
-                "Native source-locations view aggregates the same source across threads"
+                drain != codes.end() && drain->find("yappi.stop()") == std::string::npos
+                    && drain->find("_mcdev_pp_expire") != std::string::npos,
+                "a drain keeps yappi running and renews the game-side lease"
             );
-            auto slowest = (*service)->query(QueryRequest{
-                .jobId = jobId,
-                .view = "slowest-calls",
-                .limit = 20,
+            const auto start = std::find_if(codes.begin(), codes.end(), [](const std::string& code) {
+                return code.find("yappi.start") != std::string::npos;
             });
             passed &= expect(
-                slowest && slowest->records.size() == 2
-                    && std::get<std::int64_t>(slowest->records[0].fields.at("duration").value) == 150,
-                "Native slowest-calls exposes bounded event-level start and duration samples"
+                start != codes.end() && start->find("_timer=None") != std::string::npos,
+                "a recorder has no game-side stop timer"
             );
-            (*service)->shutdown();
         }
+        (*service)->shutdown();
+        std::error_code ignored;
         std::filesystem::remove_all(root, ignored);
         return passed;
     }
 
-    bool testSemanticViewsStructuredTracebackAndCompare() {
-        const auto root = std::filesystem::temp_directory_path()
-                        / ("mcdev-profiler-semantic-" + std::to_string(
-                            std::chrono::steady_clock::now().time_since_epoch().count()
-                        ));
-        const auto profiles = root / "profiles";
-        std::error_code ignored;
-        const auto writeJob = [&](std::string_view id, std::string_view kind, const nlohmann::json& data) {
-            const auto directory = profiles / id;
-            std::filesystem::create_directories(directory, ignored);
-            const nlohmann::json manifest{
-                {"job_id", id}, {"kind", kind}, {"state", "completed"}, {"partial", false},
-                {"created_at", "2026-01-01T00:00:00Z"}, {"completed_at", "2026-01-01T00:00:01Z"},
-            };
-            std::ofstream(directory / "manifest.json") << manifest.dump();
-            std::ofstream(directory / "data.json") << data.dump();
-            std::ofstream(directory / "summary.json") << nlohmann::json::object().dump();
+    bool testSampledStacksFoldIntoCallGraphs() {
+        using Json = nlohmann::json;
+        const Json functions = Json::array({
+            Json::array({"pack/a.py", 1, "main", 1, "MainThread", "client"}),
+            Json::array({"pack/a.py", 9, "tick", 1, "MainThread", "client"}),
+            Json::array({"pack/b.py", 4, "walk", 1, "MainThread", "client"}),
+            Json::array({7, 4, "broken", 1, "MainThread", "client"}),
+        });
+        // main -> tick -> walk -> walk, main -> walk, and rows the fold must skip.
+        const Json stacks = Json::array({
+            Json::array({-1, 0, 0, 10}),
+            Json::array({0, 1, 4, 6}),
+            Json::array({1, 2, 1, 2}),
+            Json::array({2, 2, 1, 1}),
+            Json::array({0, 2, 2, 4}),
+            Json::array({0, 3, 5, 5}),
+            Json::array({5, 1, 1, 1}),
+            Json::array({9, 1, 1, 1}),
+        });
+        const auto folded = foldSampledStacks(Json{
+            {"ok", true}, {"clock", "WALL"}, {"elapsed", 0.2}, {"targets", Json::array({"client"})},
+            {"sampler", {{"interval", 0.005}, {"ticks", 20}, {"dropped", 0}}},
+            {"functions", functions}, {"stacks", stacks},
+        });
+        const auto& nodes = folded["nodes"];
+        bool passed = expect(
+            nodes.size() == 3 && folded.value("total", 0) == 3 && !folded.value("truncated", true),
+            "malformed functions and orphaned stacks are skipped"
+        );
+        passed &= expect(
+            std::abs(folded["sampling"].value("period_seconds", 0.0) - 0.01) < 1e-12
+                && folded["sampling"].value("samples", 0) == 10,
+            "the sample period is measured from the ticks the sampler took"
+        );
+        const auto node = [&](const char* name) {
+            const auto found = std::find_if(nodes.begin(), nodes.end(), [&](const Json& row) { return row[3] == name; });
+            return found == nodes.end() ? Json::array() : *found;
         };
-        const auto cpuNode = [](std::int64_t id, std::string name, double self, double total) {
-            return nlohmann::json::array({
-                id, "pack/perf.py", 12, std::move(name), 10, 10, self, total, 1, "Main", "client"
+        passed &= expect(
+            nodes.size() == 3 && nodes[0][3] == "main" && node("main")[4] == 10
+                && std::abs(node("main")[7].get<double>() - 0.1) < 1e-12 && node("main")[6].get<double>() == 0.0,
+            "a root function's total holds every sample it was on the stack"
+        );
+        passed &= expect(
+            node("walk").size() == 11 && node("walk")[4] == 6 && std::abs(node("walk")[6].get<double>() - 0.04) < 1e-12
+                && std::abs(node("walk")[7].get<double>() - 0.06) < 1e-12,
+            "a recursive function counts its samples once in total and every time in self"
+        );
+        const auto edge = [&](std::int64_t caller, std::int64_t callee) {
+            const auto& edges = folded["edges"];
+            const auto found = std::find_if(edges.begin(), edges.end(), [&](const Json& row) {
+                return row[0] == caller && row[1] == callee;
             });
+            return found == edges.end() ? Json::array() : *found;
         };
-        writeJob(
-            "baseline", "python.cpu",
-            nlohmann::json{
-                {"nodes", nlohmann::json::array({cpuNode(7, "tick", 0.04, 0.10), cpuNode(8, "removed", 0.01, 0.02)})},
-                {"edges", nlohmann::json::array({nlohmann::json::array({7, 8, 2, 0.01, 0.02})})},
-            }
+        const auto walk = node("walk").empty() ? -1 : node("walk")[0].get<std::int64_t>();
+        const auto tick = node("tick").empty() ? -1 : node("tick")[0].get<std::int64_t>();
+        passed &= expect(
+            folded["edges"].size() == 4 && edge(0, walk).size() == 5 && edge(0, walk)[2] == 4
+                && edge(tick, walk)[2] == 2 && edge(walk, walk)[2] == 1
+                && std::abs(edge(0, tick)[3].get<double>() - 0.04) < 1e-12,
+            "calls sum the callee's samples under each caller"
         );
-        writeJob(
-            "candidate", "python.cpu",
-            nlohmann::json{
-                {"nodes", nlohmann::json::array({cpuNode(3, "tick", 0.07, 0.16), cpuNode(4, "added", 0.02, 0.03)})},
-                {"edges", nlohmann::json::array()},
-            }
+        const auto store = buildProfileStore(ProfilerKind::PythonCpu, folded);
+        passed &= expect(
+            store && (*store)->view("hotspots")->rows.size() == 3 && (*store)->view("calls")->rows.size() == 4,
+            "a folded sample trie builds the same Python CPU views as a traced capture"
         );
-        writeJob(
+
+        auto wide = Json::array();
+        auto roots = Json::array();
+        for (int index = 0; index < 600; ++index) {
+            wide.push_back(Json::array({"pack/wide.py", index, "f" + std::to_string(index), 1, "MainThread", nullptr}));
+            roots.push_back(Json::array({-1, index, 1, 1}));
+        }
+        const auto bounded = foldSampledStacks(Json{
+            {"elapsed", 1.0}, {"sampler", {{"interval", 0.01}, {"ticks", 100}, {"dropped", 0}}},
+            {"functions", wide}, {"stacks", roots},
+        });
+        passed &= expect(
+            bounded["nodes"].size() == 512 && bounded.value("truncated", false) && bounded.value("total", 0) == 600,
+            "a folded trie is bounded as one capture is"
+        );
+        const auto dropped = foldSampledStacks(Json{
+            {"elapsed", 1.0}, {"sampler", {{"interval", 0.01}, {"ticks", 100}, {"dropped", 3}}},
+            {"functions", functions}, {"stacks", Json::array({Json::array({-1, 0, 1, 1})})},
+        });
+        passed &= expect(
+            dropped.value("truncated", false) && dropped["sampling"].value("dropped_samples", 0) == 3,
+            "samples the game dropped at its trie bound mark the capture truncated"
+        );
+        return passed;
+    }
+
+    bool testSamplingEngineRunsWithoutYappi() {
+        using Json = nlohmann::json;
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-sampling-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        std::mutex codesMutex;
+        std::vector<std::pair<std::string, ProfileTarget>> codes;
+        auto service = createProfilerService({
+            .executeCode = [&](std::string code, ProfileTarget side, std::chrono::milliseconds)
+                -> std::expected<Json, GameExecutionError> {
+                {
+                    std::lock_guard lock(codesMutex);
+                    codes.emplace_back(code, side);
+                }
+                if (code.find("sys._current_frames()") != std::string::npos) {
+                    return Json{{"ok", true}, {"running", true}, {"clock", "WALL"}};
+                }
+                if (code.find("'stacks':_stacks") != std::string::npos) {
+                    return Json{
+                        {"ok", true}, {"clock", "WALL"}, {"elapsed", 0.5}, {"targets", Json::array({"client", "server"})},
+                        {"sampler", {{"interval", 0.01}, {"ticks", 50}, {"dropped", 0}}},
+                        {"functions", Json::array({
+                            Json::array({"pack/foo.py", 12, "tick", 1, "MainThread", "client"}),
+                            Json::array({"pack/foo.py", 30, "move", 1, "MainThread", "client"}),
+                        })},
+                        {"stacks", Json::array({Json::array({-1, 0, 5, 20}), Json::array({0, 1, 15, 15})})},
+                    };
+                }
+                return Json(true);
+            },
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot = root / "profiles",
+            .executableDirectory = root,
+        });
+        bool passed = expect(service.has_value(), "sampling service is constructible");
+        if (!service) return false;
+
+        auto memory = (*service)->start(StartRequest{.kind = ProfilerKind::PythonMemory, .engine = ProfileEngine::Sampling});
+        passed &= expect(!memory && memory.error().code == "ENGINE_KIND_UNSUPPORTED", "only Python CPU can be sampled");
+        auto cpuClock = (*service)->start(StartRequest{.clock = ProfileClock::Cpu, .engine = ProfileEngine::Sampling});
+        passed &= expect(
+            !cpuClock && cpuClock.error().code == "SAMPLING_CLOCK_UNSUPPORTED",
+            "the sampling engine refuses the CPU clock it cannot measure"
+        );
+        auto slow = (*service)->start(StartRequest{.engine = ProfileEngine::Sampling, .sampleHertz = 5});
+        passed &= expect(!slow && slow.error().code == "INVALID_SAMPLE_RATE", "the sample rate is bounded");
+
+        const auto waitFor = [&](const JobId& id) {
+            JobSnapshot snapshot;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(6);
+            do {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                snapshot = (*service)->status(id).value_or(JobSnapshot{});
+            } while (snapshot.state != JobState::Completed && snapshot.state != JobState::Failed
+                     && std::chrono::steady_clock::now() < deadline);
+            return snapshot;
+        };
+        auto sampled = (*service)->start(StartRequest{
+            .target = ProfileTarget::All, .duration = std::chrono::seconds(1), .engine = ProfileEngine::Sampling,
+            .sampleHertz = 250,
+        });
+        passed &= expect(sampled.has_value(), "a sampling capture starts");
+        if (sampled) {
+            passed &= expect(waitFor(sampled->id).state == JobState::Completed, "a sampling capture completes at its deadline");
+            auto page = (*service)->query(QueryRequest{.jobId = sampled->id, .view = "hotspots"});
+            passed &= expect(
+                page && page->records.size() == 2
+                    && std::get<std::int64_t>(page->records.front().fields.at("calls").value) == 20
+                    && std::abs(std::get<double>(page->records.front().fields.at("total_time").value) - 0.2) < 1e-9,
+                "sampled hotspots count samples and weigh them by the measured period"
+            );
+            auto calls = (*service)->query(QueryRequest{.jobId = sampled->id, .view = "calls"});
+            passed &= expect(calls && calls->records.size() == 1, "sampled stacks become caller and callee rows");
+        }
+
+        auto recorder = (*service)->start(StartRequest{
+            .duration = std::chrono::seconds(30), .mode = ProfileMode::Recorder, .engine = ProfileEngine::Sampling,
+        });
+        passed &= expect(recorder.has_value(), "a sampling flight recorder starts");
+        if (recorder) {
+            auto frozen = (*service)->snapshot(recorder->id);
+            auto page = frozen ? (*service)->query(QueryRequest{.jobId = frozen->id, .view = "hotspots"})
+                               : std::expected<QueryPage, ProfilerError>(std::unexpected(frozen.error()));
+            passed &= expect(page && page->records.size() == 2, "a sampling recorder's window freezes into a queryable job");
+            (void)(*service)->stop(recorder->id);
+            passed &= expect(waitFor(recorder->id).state == JobState::Completed, "a sampling recorder completes when stopped");
+        }
+        {
+            std::lock_guard lock(codesMutex);
+            passed &= expect(
+                std::none_of(codes.begin(), codes.end(), [](const auto& code) {
+                    return code.first.find("yappi") != std::string::npos;
+                }),
+                "the sampling engine never needs yappi in the game"
+            );
+            passed &= expect(
+                std::any_of(codes.begin(), codes.end(), [](const auto& code) {
+                    return code.second == ProfileTarget::Server && code.first.find("_mcdev_pp_sampler") != std::string::npos
+                        && code.first.find("'server'") != std::string::npos;
+                }),
+                "target=all registers the server thread with the sampler"
+            );
+            passed &= expect(
+                std::any_of(codes.begin(), codes.end(), [](const auto& code) {
+                    return code.first.find("'interval':0.004,") != std::string::npos;
+                }),
+                "the sample rate becomes the sampler's interval"
+            );
+        }
+        (*service)->shutdown();
+        std::error_code ignored;
+        std::filesystem::remove_all(root, ignored);
+        return passed;
+    }
+
+    bool testTriggersStartTaggedCaptures() {
+        using Json = nlohmann::json;
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-triggers-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        std::mutex gameMutex;
+        std::vector<Json> drains{
+            Json::array({50.0, 120.0, 130.0, 50.0}), // A streak of two breaks before it reaches three.
+            Json::array({140.0, 150.0, 160.0}),
+        };
+        std::vector<std::string> log{"ERROR before arming"};
+        std::size_t              evicted = 0; // Log lines before this index are gone, like lines a full ring dropped.
+        bool watcherStopped = false;
+        std::size_t ticksDrained = 0;
+        const auto executeCode = [&](std::string code, ProfileTarget, std::chrono::milliseconds)
+            -> std::expected<Json, GameExecutionError> {
+            std::lock_guard lock(gameMutex);
+            if (code.find("_mcdev_tw_tick") != std::string::npos) return Json{{"ok", true}};
+            if (code.find("'intervals':[round") != std::string::npos) {
+                Json intervals = Json::array();
+                if (!drains.empty()) {
+                    intervals = drains.front();
+                    drains.erase(drains.begin());
+                }
+                Json drained{{"ok", true}, {"first", ticksDrained}, {"intervals", intervals}};
+                ticksDrained += intervals.size();
+                return drained;
+            }
+            if (code.find("_mcdev_tw',{}).pop(") != std::string::npos) watcherStopped = true;
+            if (code.find("sys._current_frames()") != std::string::npos) return Json{{"ok", true}, {"clock", "WALL"}};
+            if (code.find("'stacks':_stacks") != std::string::npos) {
+                return Json{
+                    {"ok", true}, {"clock", "WALL"}, {"elapsed", 0.5}, {"targets", Json::array({"server"})},
+                    {"sampler", {{"interval", 0.01}, {"ticks", 50}, {"dropped", 0}}},
+                    {"functions", Json::array({Json::array({"pack/foo.py", 12, "tick", 1, "MainThread", "server"})})},
+                    {"stacks", Json::array({Json::array({-1, 0, 20, 20})})},
+                };
+            }
+            return Json(true);
+        };
+        const auto readGameLog = [&](std::uint64_t cursor, std::size_t maxLines) {
+            std::lock_guard lock(gameMutex);
+            GameLogBatch batch{.nextCursor = std::min<std::uint64_t>(cursor, log.size())};
+            if (batch.nextCursor < evicted) {
+                batch.dropped    = evicted - batch.nextCursor;
+                batch.nextCursor = evicted;
+            }
+            for (; batch.nextCursor < log.size() && batch.lines.size() < maxLines; ++batch.nextCursor) {
+                batch.lines.push_back(log[batch.nextCursor]);
+            }
+            batch.hasMore = batch.nextCursor < log.size();
+            return batch;
+        };
+        auto service = createProfilerService({
+            .executeCode = executeCode,
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot = root / "profiles",
+            .executableDirectory = root,
+            .readGameLog = readGameLog,
+        });
+        bool passed = expect(service.has_value(), "trigger service is constructible");
+        if (!service) return false;
+
+        const StartRequest capture{
+            .target = ProfileTarget::Server, .storage = ProfileStorage::Disk, .duration = std::chrono::seconds(1),
+            .engine = ProfileEngine::Sampling,
+        };
+        auto everySide = (*service)->arm(TriggerRequest{.side = ProfileTarget::All, .capture = capture});
+        auto recorder = (*service)->arm(TriggerRequest{.capture = StartRequest{.mode = ProfileMode::Recorder}});
+        auto regex = (*service)->arm(TriggerRequest{
+            .condition = TriggerCondition::LogPattern, .logPattern = "(", .logRegex = true, .capture = capture,
+        });
+        passed &= expect(
+            !everySide && everySide.error().code == "INVALID_TRIGGER_SIDE" && !recorder
+                && recorder.error().code == "TRIGGER_CAPTURE_INVALID" && !regex
+                && regex.error().code == "INVALID_TRIGGER_PATTERN",
+            "arming validates the watched side, the capture mode and the log pattern"
+        );
+
+        const auto waitFor = [&](auto&& done) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(8);
+            while (!done() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            return done();
+        };
+        const auto triggerState = [&](const TriggerId& id) {
+            const auto all = (*service)->triggers().value_or(std::vector<TriggerSnapshot>{});
+            const auto found = std::find_if(all.begin(), all.end(), [&](const auto& trigger) { return trigger.id == id; });
+            return found == all.end() ? TriggerSnapshot{} : *found;
+        };
+        const auto completed = [&](const JobId& id) {
+            return waitFor([&] { return (*service)->status(id).value_or(JobSnapshot{}).state == JobState::Completed; });
+        };
+
+        auto ticks = (*service)->arm(TriggerRequest{
+            .tickMilliseconds = 100, .consecutiveTicks = 3, .cooldown = std::chrono::seconds(0), .maximumCaptures = 1,
+            .capture = capture,
+        });
+        passed &= expect(ticks && ticks->state == TriggerState::Armed, "a tick trigger arms");
+        if (ticks) {
+            passed &= expect(
+                waitFor([&] { return triggerState(ticks->id).state == TriggerState::Exhausted; }),
+                "a tick trigger fires on its streak and is exhausted by its capture cap"
+            );
+            const auto fired = triggerState(ticks->id);
+            passed &= expect(fired.captures == 1 && fired.jobs.size() == 1, "the trigger records the job it started");
+            if (!fired.jobs.empty()) {
+                passed &= expect(completed(fired.jobs.front()), "a triggered capture completes like any capture");
+                const auto job = (*service)->status(fired.jobs.front());
+                passed &= expect(
+                    job && job->trigger && job->trigger->triggerId == ticks->id
+                        && job->trigger->condition == TriggerCondition::TickTime
+                        && job->trigger->detail.find("3 consecutive ticks (peak 160.0 ms)") != std::string::npos,
+                    "the job is tagged with the trigger and the streak that fired it"
+                );
+            }
+            passed &= expect(waitFor([&] {
+                std::lock_guard lock(gameMutex);
+                return watcherStopped;
+            }), "a finished tick trigger removes its game-side watcher");
+        }
+
+        auto pattern = (*service)->arm(TriggerRequest{
+            .condition = TriggerCondition::LogPattern, .logPattern = "ERROR [a-z]+", .logRegex = true,
+            .cooldown = std::chrono::seconds(3600), .maximumCaptures = 2, .capture = capture,
+        });
+        passed &= expect(pattern.has_value(), "a log pattern trigger arms");
+        if (pattern) {
+            {
+                std::lock_guard lock(gameMutex);
+                log.push_back("INFO tick");
+                log.push_back("ERROR boom in pack/foo.py");
+            }
+            passed &= expect(
+                waitFor([&] { return triggerState(pattern->id).captures == 1; }),
+                "a log line logged after arming fires the trigger"
+            );
+            const auto fired = triggerState(pattern->id);
+            if (!fired.jobs.empty()) {
+                passed &= expect(completed(fired.jobs.front()), "the log-triggered capture completes");
+                const auto job = (*service)->status(fired.jobs.front());
+                passed &= expect(
+                    job && job->trigger && job->trigger->detail.find("ERROR boom") != std::string::npos,
+                    "the job is tagged with the matching log line, not one logged before arming"
+                );
+            }
+            {
+                std::lock_guard lock(gameMutex);
+                log.push_back("ERROR again");
+            }
+            passed &= expect(
+                waitFor([&] { return triggerState(pattern->id).suppressed == 1; }),
+                "a match within the cooldown is counted instead of captured"
+            );
+            passed &= expect(triggerState(pattern->id).captures == 1, "the cooldown holds the capture count");
+            {
+                std::lock_guard lock(gameMutex);
+                log.insert(log.end(), 10, "ERROR lost");
+                evicted = log.size();
+            }
+            passed &= expect(
+                waitFor([&] { return triggerState(pattern->id).missedLogLines == 10; }),
+                "lines evicted before the trigger read them are counted as missed"
+            );
+            {
+                std::lock_guard lock(gameMutex);
+                // Ten read batches: one batch per 500 ms poll would take five seconds to reach the match.
+                log.insert(log.end(), 10 * 1024, "INFO filler");
+                log.push_back("ERROR flood");
+            }
+            const auto floodStart = std::chrono::steady_clock::now();
+            passed &= expect(
+                waitFor([&] { return triggerState(pattern->id).suppressed == 2; })
+                    && std::chrono::steady_clock::now() - floodStart < std::chrono::seconds(3),
+                "a trigger drains a backlog of many batches within one poll instead of one batch per poll"
+            );
+            const auto disarmed = (*service)->disarm(pattern->id);
+            passed &= expect(disarmed && disarmed->state == TriggerState::Disarmed, "a trigger can be disarmed");
+        }
+        (*service)->shutdown();
+
+        auto recovered = createProfilerService({
+            .executeCode = executeCode,
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot = root / "profiles",
+            .executableDirectory = root,
+        });
+        const auto history = recovered ? (*recovered)->history(HistoryRequest{}) : std::expected<HistoryPage, ProfilerError>{};
+        passed &= expect(
+            history && history->jobs.size() == 2 && std::all_of(history->jobs.begin(), history->jobs.end(), [](const auto& job) {
+                return job.trigger.has_value() && !job.trigger->firedAt.empty();
+            }),
+            "committed triggered jobs keep their trigger context across restarts"
+        );
+        if (recovered) (*recovered)->shutdown();
+        std::error_code ignored;
+        std::filesystem::remove_all(root, ignored);
+        return passed;
+    }
+
+    bool testFrameHistogramsKeepPercentiles() {
+        FrameHistogram histogram;
+        for (std::int64_t value = 1; value <= 100'000; ++value) histogram.record(value);
+        const auto near = [](std::int64_t actual, double expected) {
+            return std::abs(static_cast<double>(actual) - expected) <= expected * 0.008;
+        };
+        bool passed = expect(
+            histogram.count() == 100'000 && histogram.minimum() == 1 && histogram.maximum() == 100'000
+                && near(histogram.percentile(50), 50'000) && near(histogram.percentile(99), 99'000)
+                && histogram.percentile(100) == 100'000 && std::abs(histogram.mean() - 50'000.5) < 1e-6,
+            "a frame histogram keeps percentiles within its precision and the exact extremes"
+        );
+        const auto buckets = histogram.buckets();
+        std::uint64_t counted = 0;
+        bool contiguous = true;
+        for (std::size_t index = 0; index < buckets.size(); ++index) {
+            counted += buckets[index].count;
+            if (index > 0) contiguous &= buckets[index].lowest == buckets[index - 1].highest + 1;
+        }
+        passed &= expect(
+            counted == 100'000 && contiguous && buckets.front().lowest == 1 && buckets.back().highest >= 100'000
+                && buckets.size() < 1'500,
+            "histogram buckets cover every value once in a bounded number of buckets"
+        );
+        FrameHistogram exact;
+        exact.record(100);
+        exact.record(-5);
+        passed &= expect(
+            exact.percentile(100) == 100 && exact.minimum() == 0 && FrameHistogram{}.percentile(50) == 0,
+            "small values are exact, negative ones clamp and an empty histogram reports zero"
+        );
+
+        FrameTimeline timeline;
+        const std::array<double, 3> server{10.0, 20.0, 300.0};
+        const std::array<double, 1> client{5.0};
+        timeline.append(ProfileTarget::Server, server, 1.0);
+        timeline.append(ProfileTarget::Client, client, 3.0);
+        timeline.lose(ProfileTarget::Server, 4);
+        const std::array<FrameCpuWindow, 2> windows{
+            FrameCpuWindow{.jobId = "cpu-a", .kind = ProfilerKind::PythonCpu, .start = 0.5, .end = 0.9},
+            FrameCpuWindow{.jobId = "cpu-b", .kind = ProfilerKind::NativeCpu, .start = 0.95, .end = 1.5},
+        };
+        const auto payload = timeline.payload(3.0, windows);
+        const auto& worst = payload["worst"];
+        passed &= expect(
+            worst.size() == 4 && worst[0][0] == "client" && worst[0][3].is_null() && worst[1][0] == "server"
+                && worst[1][2] == 300.0 && worst[1][3] == "cpu-a" && worst[1][4] == "python.cpu"
+                && worst[3][1] == nlohmann::json(1.0 - 0.3 - 0.02) && worst[3][3] == "cpu-a",
+            "worst frames are placed back from their drain and linked to the CPU job they overlap most"
+        );
+        passed &= expect(
+            payload["series"].size() == 3 && payload["series"][1] == nlohmann::json::array({"server", 0, 2, 15.0, 20.0})
+                && payload["sides"][1]["lost"] == 4 && payload["cpu_jobs"].size() == 2,
+            "frames fall into one-second windows and lost frames are counted per side"
+        );
+
+        const auto store = buildProfileStore(ProfilerKind::FrameTime, payload);
+        const auto* frames = store ? (*store)->view("worst-frames") : nullptr;
+        passed &= expect(
+            frames && frames->rows.size() == 4 && (*store)->view("percentiles")
+                && (*store)->view("percentiles")->rows.size() == 2 && (*store)->view("histogram")
+                && (*store)->view("timeseries"),
+            "a frame-time payload builds its four views"
+        );
+        if (frames) {
+            auto slow = FilterExpression::parse("duration > 0.1s and side == server");
+            auto selected = slow && *slow ? (*slow)->select(**store, *frames)
+                                          : std::expected<std::vector<std::uint32_t>, ProfilerError>{};
+            passed &= expect(selected && selected->size() == 1, "frame durations filter with time units");
+        }
+        return passed;
+    }
+
+    bool testFrameTimeJobsRunBesideCpuCaptures() {
+        using Json = nlohmann::json;
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-frames-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        std::mutex gameMutex;
+        std::map<ProfileTarget, std::vector<Json>> drains{
+            {ProfileTarget::Server, {Json::array({16.0, 300.0, 16.0})}},
+            {ProfileTarget::Client, {Json::array({33.0, 34.0, 35.0})}},
+        };
+        std::map<ProfileTarget, std::size_t> ticksDrained;
+        std::map<ProfileTarget, bool> watcherStopped;
+        bool lateFrame = false;
+        auto service = createProfilerService({
+            .executeCode = [&](std::string code, ProfileTarget side, std::chrono::milliseconds)
+                -> std::expected<Json, GameExecutionError> {
+                std::lock_guard lock(gameMutex);
+                if (code.find("_mcdev_tw_tick") != std::string::npos) return Json{{"ok", true}};
+                if (code.find("'intervals':[round") != std::string::npos) {
+                    Json intervals = Json::array();
+                    auto& queued = drains[side];
+                    if (!queued.empty()) {
+                        intervals = queued.front();
+                        queued.erase(queued.begin());
+                    } else if (side == ProfileTarget::Server && lateFrame) {
+                        // Five ticks the watcher dropped, then a frame after the CPU capture ended.
+                        intervals = Json::array({1.0});
+                        ticksDrained[side] += 5;
+                        lateFrame = false;
+                    }
+                    Json drained{{"ok", true}, {"first", ticksDrained[side]}, {"intervals", intervals}};
+                    ticksDrained[side] += intervals.size();
+                    return drained;
+                }
+                if (code.find("_mcdev_tw',{}).pop(") != std::string::npos) watcherStopped[side] = true;
+                if (code.find("sys._current_frames()") != std::string::npos) return Json{{"ok", true}, {"clock", "WALL"}};
+                if (code.find("'stacks':_stacks") != std::string::npos) {
+                    return Json{
+                        {"ok", true}, {"clock", "WALL"}, {"elapsed", 1.0}, {"targets", Json::array({"server"})},
+                        {"sampler", {{"interval", 0.01}, {"ticks", 100}, {"dropped", 0}}},
+                        {"functions", Json::array({Json::array({"pack/foo.py", 12, "tick", 1, "MainThread", "server"})})},
+                        {"stacks", Json::array({Json::array({-1, 0, 20, 20})})},
+                    };
+                }
+                return Json(true);
+            },
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot = root / "profiles",
+            .executableDirectory = root,
+        });
+        bool passed = expect(service.has_value(), "frame-time service is constructible");
+        if (!service) return false;
+
+        const auto waitFor = [&](const JobId& id) {
+            JobSnapshot snapshot;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(8);
+            do {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                snapshot = (*service)->status(id).value_or(JobSnapshot{});
+            } while (snapshot.state != JobState::Completed && snapshot.state != JobState::Failed
+                     && std::chrono::steady_clock::now() < deadline);
+            return snapshot;
+        };
+        auto frames = (*service)->start(StartRequest{
+            .kind = ProfilerKind::FrameTime, .target = ProfileTarget::All, .storage = ProfileStorage::Disk,
+            .duration = std::chrono::seconds(2),
+        });
+        auto cpu = (*service)->start(StartRequest{
+            .target = ProfileTarget::Server, .duration = std::chrono::seconds(1), .engine = ProfileEngine::Sampling,
+        });
+        auto second = (*service)->start(StartRequest{.kind = ProfilerKind::FrameTime, .duration = std::chrono::seconds(1)});
+        passed &= expect(frames && cpu, "a frame-time job runs beside a CPU capture");
+        passed &= expect(!second && second.error().code == "PROFILER_BUSY", "only one frame-time job runs at a time");
+        if (!frames || !cpu) {
+            (*service)->shutdown();
+            return false;
+        }
+        passed &= expect(waitFor(cpu->id).state == JobState::Completed, "the CPU capture completes on its own deadline");
+        {
+            std::lock_guard lock(gameMutex);
+            lateFrame = true;
+        }
+        passed &= expect(waitFor(frames->id).state == JobState::Completed, "the frame-time job completes at its deadline");
+
+        auto percentiles = (*service)->query(QueryRequest{.jobId = frames->id, .view = "percentiles", .sort = "side", .descending = false});
+        passed &= expect(
+            percentiles && percentiles->records.size() == 2
+                && std::get<std::string>(percentiles->records[0].fields.at("side").value) == "client"
+                && std::get<std::int64_t>(percentiles->records[0].fields.at("frames").value) == 3
+                && std::get<std::int64_t>(percentiles->records[1].fields.at("frames").value) == 4
+                && std::get<std::int64_t>(percentiles->records[1].fields.at("lost").value) == 5
+                && std::abs(std::get<double>(percentiles->records[1].fields.at("maximum").value) - 300.0) < 1e-9,
+            "target=all times both sides and counts the ticks a watcher dropped"
+        );
+        auto worst = (*service)->query(QueryRequest{.jobId = frames->id, .view = "worst-frames"});
+        passed &= expect(
+            worst && worst->records.size() == 7
+                && std::abs(std::get<double>(worst->records.front().fields.at("duration").value) - 300.0) < 1e-9
+                && worst->records.front().fields.contains("cpu_job_id")
+                && std::get<std::string>(worst->records.front().fields.at("cpu_job_id").value) == cpu->id,
+            "the slowest frame links to the CPU capture that overlapped it"
+        );
+        if (worst) {
+            const auto late = std::find_if(worst->records.begin(), worst->records.end(), [](const auto& record) {
+                return std::get<double>(record.fields.at("duration").value) == 1.0;
+            });
+            passed &= expect(
+                late != worst->records.end() && !late->fields.contains("cpu_job_id"),
+                "a frame after the CPU capture ended is not linked to it"
+            );
+        }
+        auto folded = (*service)->exportReport(ExportRequest{frames->id, ExportFormat::Folded});
+        passed &= expect(!folded && folded.error().code == "EXPORT_FORMAT_UNSUPPORTED", "frame times have no stacks to export");
+        auto report = (*service)->exportReport(ExportRequest{frames->id, ExportFormat::Markdown});
+        if (report) {
+            std::ifstream input(report->path);
+            const std::string text{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+            passed &= expect(
+                text.find("Frame Time Profile") != std::string::npos && text.find(cpu->id) != std::string::npos,
+                "the report lists the worst frames with their CPU jobs"
+            );
+        } else {
+            passed &= expect(false, "a frame-time job exports a markdown report");
+        }
+        auto compared = (*service)->compare(CompareRequest{
+            .baselineJobId = frames->id, .candidateJobId = frames->id, .view = "percentiles", .metric = "p99",
+        });
+        passed &= expect(compared && compared->matched == 2, "frame-time jobs compare by side");
+        {
+            std::lock_guard lock(gameMutex);
+            passed &= expect(
+                watcherStopped[ProfileTarget::Server] && watcherStopped[ProfileTarget::Client],
+                "a finished frame-time job removes both tick watchers"
+            );
+        }
+        (*service)->shutdown();
+        std::error_code ignored;
+        std::filesystem::remove_all(root, ignored);
+        return passed;
+    }
+
+    bool testMemorySnapshotsFitSiteGrowthAndCallTree() {
+        using Json = nlohmann::json;
+        const std::array<double, 4> seconds{0, 1, 2, 3};
+        const std::array<double, 4> linear{10, 30, 50, 70};
+        const std::array<double, 4> step{0, 1000, 1000, 1000};
+        const std::array<double, 2> sameTime{1, 1};
+        const auto line = fitGrowth(seconds, linear);
+        const auto jump = fitGrowth(seconds, step);
+        bool passed = expect(
+            line && std::abs(line->slope - 20) < 1e-9 && std::abs(line->intercept - 10) < 1e-9
+                && std::abs(line->rSquared - 1) < 1e-9 && jump && std::abs(jump->rSquared - 0.6) < 1e-9
+                && !fitGrowth(sameTime, std::span<const double>(linear).first(2)),
+            "growth fits are least-squares lines and a one-off step explains little of its variation"
+        );
+
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-memory-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        const auto cacheFrames = Json::array({Json::array({"pack/cache.py", 20}), Json::array({"pack/main.py", 5})});
+        const auto loadFrames  = Json::array({Json::array({"pack/load.py", 8}), Json::array({"pack/main.py", 5})});
+        std::atomic<int> snapshots{0};
+        auto service = createProfilerService({
+            .executeCode = [&](std::string code, ProfileTarget, std::chrono::milliseconds)
+                -> std::expected<Json, GameExecutionError> {
+                if (code.find("tracemalloc.start") != std::string::npos) return Json{{"ok", true}, {"depth", 8}};
+                if (code.find("_new.append") != std::string::npos) {
+                    // The cache grows by a kilobyte a second; the loader allocated once before the first snapshot.
+                    const auto taken = ++snapshots;
+                    auto sites = taken == 1 ? Json::array({Json::array({0, cacheFrames}), Json::array({1, loadFrames})})
+                                            : Json::array();
+                    return Json{
+                        {"ok", true}, {"elapsed", taken}, {"sizeDiff", 1000 * taken + 500}, {"countDiff", taken + 1},
+                        {"rows", Json::array({Json::array({0, 1000 * taken, taken}), Json::array({1, 500, 1})})},
+                        {"sites", std::move(sites)},
+                    };
+                }
+                if (code.find("_keep=_all[:512]") != std::string::npos) {
+                    return Json{
+                        {"ok", true}, {"elapsed", 3.0}, {"depth", 8}, {"sizeDiff", 3500}, {"countDiff", 4},
+                        {"size", 3800}, {"count", 5}, {"total", 2}, {"truncated", false},
+                        {"rows", Json::array({
+                            Json::array({0, 3000, 3, 3000, 3, cacheFrames, 0}),
+                            Json::array({1, 500, 1, 800, 2, loadFrames, 1}),
+                        })},
+                    };
+                }
+                return Json(true);
+            },
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot = root / "profiles",
+            .executableDirectory = root,
+        });
+        passed &= expect(service.has_value(), "memory snapshot service is constructible");
+        if (!service) return false;
+
+        auto cpu = (*service)->start(StartRequest{.duration = std::chrono::seconds(3), .snapshotInterval = std::chrono::seconds(1)});
+        auto tooSlow = (*service)->start(StartRequest{
+            .kind = ProfilerKind::PythonMemory, .duration = std::chrono::seconds(3), .snapshotInterval = std::chrono::seconds(3),
+        });
+        passed &= expect(
+            !cpu && cpu.error().code == "INVALID_SNAPSHOT_INTERVAL" && !tooSlow && tooSlow.error().code == "INVALID_SNAPSHOT_INTERVAL",
+            "snapshots are only taken by memory jobs, more often than the job lasts"
+        );
+
+        auto memory = (*service)->start(StartRequest{
+            .kind = ProfilerKind::PythonMemory, .duration = std::chrono::seconds(3), .snapshotInterval = std::chrono::seconds(1),
+        });
+        passed &= expect(memory.has_value(), "a memory capture with snapshots starts");
+        if (memory) {
+            JobSnapshot snapshot;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(8);
+            do {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                snapshot = (*service)->status(memory->id).value_or(JobSnapshot{});
+            } while (snapshot.state != JobState::Completed && snapshot.state != JobState::Failed
+                     && std::chrono::steady_clock::now() < deadline);
+            passed &= expect(
+                snapshot.state == JobState::Completed && snapshots.load() == 2,
+                "a memory capture snapshots every interval before its final collection"
+            );
+            const auto field = [](const QueryRecord& record, const std::string& name) {
+                return record.fields.contains(name) ? record.fields.at(name).value : ProfilerFieldValue{};
+            };
+            auto series = (*service)->query(QueryRequest{.jobId = memory->id, .view = "snapshots"});
+            passed &= expect(
+                series && series->records.size() == 3
+                    && std::get<std::int64_t>(field(series->records.front(), "size_diff")) == 3500,
+                "the final collection is the last point of the snapshot series"
+            );
+            auto growth = (*service)->query(QueryRequest{.jobId = memory->id, .view = "growth-rate"});
+            passed &= expect(
+                growth && growth->records.size() == 2 && growth->records[0].id == "site:0"
+                    && std::abs(std::get<double>(field(growth->records[0], "slope")) - 1000) < 1e-6
+                    && std::get<std::string>(field(growth->records[0], "pattern")) == "growing"
+                    && std::get<std::string>(field(growth->records[1], "pattern")) == "plateau"
+                    && std::get<std::int64_t>(field(growth->records[1], "points")) == 3,
+                "a steadily growing site is ranked by slope above one that allocated once"
+            );
+            auto growing = (*service)->query(QueryRequest{
+                .jobId = memory->id, .view = "growth-rate", .filter = "pattern == growing and traceback contains pack/cache.py",
+            });
+            passed &= expect(growing && growing->records.size() == 1, "growth patterns and site tracebacks are filterable");
+
+            auto roots = (*service)->query(QueryRequest{.jobId = memory->id, .view = "calltree-roots"});
+            passed &= expect(
+                roots && roots->records.size() == 1 && roots->records[0].id == "node:0"
+                    && std::get<std::int64_t>(field(roots->records[0], "inclusive_size")) == 3800
+                    && std::get<std::int64_t>(field(roots->records[0], "exclusive_size")) == 0
+                    && std::get<std::int64_t>(field(roots->records[0], "inclusive_size_diff")) == 3500,
+                "the allocation tree roots at the outermost shared frame and sums the sites below it"
+            );
+            auto children = (*service)->query(QueryRequest{.jobId = memory->id, .view = "calltree-children", .filter = "node:0"});
+            passed &= expect(
+                children && children->records.size() == 2
+                    && std::get<std::string>(field(children->records[0], "source_file")) == "pack/cache.py"
+                    && std::get<std::int64_t>(field(children->records[0], "exclusive_size")) == 3000
+                    && std::get<std::int64_t>(field(children->records[1], "exclusive_count")) == 2,
+                "allocation tree children are the sites reached through their parent, largest first"
+            );
+            auto detail = (*service)->detail(DetailRequest{.jobId = memory->id, .view = "calltree-roots", .recordId = "node:0"});
+            passed &= expect(detail && detail->related.size() == 2, "allocation tree detail lists a node's children");
+        }
+        (*service)->shutdown();
+        std::error_code ignored;
+        std::filesystem::remove_all(root, ignored);
+        return passed;
+    }
+
+    bool testNativeCalltreeChildrenUseExactParentId() {
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-calltree-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        const auto profiles = root / "profiles";
+        const auto jobId = std::string("native-calltree-job");
+        const auto jobDirectory = profiles / jobId;
+        std::error_code ignored;
+        std::filesystem::create_directories(jobDirectory, ignored);
+
+        const auto node = [](std::int64_t id, nlohmann::json children = nlohmann::json::array()) {
+            return nlohmann::json{
+                {"id", id}, {"name", "zone-" + std::to_string(id)}, {"sourceFile", "Engine"},
+                {"sourceLine", 0}, {"calls", 1}, {"totalNanoseconds", 100}, {"selfNanoseconds", 50},
+                {"meanNanoseconds", 100}, {"maximumNanoseconds", 100}, {"children", std::move(children)},
+            };
+        };
+        const nlohmann::json data{
+            {"threads", nlohmann::json::array({
+                nlohmann::json{
+                    {"id", "1"}, {"name", "Main"},
+                    {"roots", nlohmann::json::array({
+                        node(39, nlohmann::json::array({node(40)})),
+                        node(390, nlohmann::json::array({node(392)})),
+                    })},
+                },
+            })},
+            {"zones", nlohmann::json::array({
+                nlohmann::json{
+                    {"id", 0}, {"name", "parse"}, {"sourceFile", "engine/json.cpp"}, {"sourceLine", 8},
+                    {"threadId", "1"}, {"threadName", "Main"}, {"calls", 1},
+                    {"totalNanoseconds", 100}, {"selfNanoseconds", 40},
+                    {"meanNanoseconds", 100}, {"maximumNanoseconds", 100},
+                    {"slowestCalls", nlohmann::json::array({
+                        nlohmann::json{{"startNanoseconds", 10}, {"durationNanoseconds", 100}}
+                    })},
+                },
+                nlohmann::json{
+                    {"id", 1}, {"name", "parse"}, {"sourceFile", "engine/json.cpp"}, {"sourceLine", 8},
+                    {"threadId", "2"}, {"threadName", "Worker"}, {"calls", 2},
+                    {"totalNanoseconds", 200}, {"selfNanoseconds", 60},
+                    {"meanNanoseconds", 100}, {"maximumNanoseconds", 150},
+                    {"slowestCalls", nlohmann::json::array({
+                        nlohmann::json{{"startNanoseconds", 20}, {"durationNanoseconds", 150}}
+                    })},
+                },
+            })},
+        };
+        const nlohmann::json manifest{
+            {"job_id", jobId}, {"kind", "native.cpu"}, {"state", "completed"},
+            {"partial", false}, {"created_at", "2026-01-01T00:00:00Z"},
+            {"completed_at", "2026-01-01T00:00:01Z"},
+        };
+        {
+            std::ofstream(jobDirectory / "manifest.json") << manifest.dump();
+            std::ofstream(jobDirectory / "data.json") << data.dump();
+            std::ofstream(jobDirectory / "summary.json") << nlohmann::json::object().dump();
+        }
+
+        auto service = createProfilerService({
+            .executeCode = {},
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot = profiles,
+            .executableDirectory = root,
+        });
+        bool passed = expect(service.has_value(), "native calltree fixture service is constructible");
+        if (service) {
+            auto missingParent = (*service)->query(QueryRequest{
+                .jobId = jobId,
+                .view = "calltree-children",
+                .limit = 20,
+            });
+            passed &= expect(
+                !missingParent && missingParent.error().code == "CALLTREE_PARENT_REQUIRED",
+                "calltree child queries require an explicit parent node id"
+            );
+            auto children = (*service)->query(QueryRequest{
+                .jobId = jobId,
+                .view = "calltree-children",
+                .filter = "node:39",
+                .limit = 20,
+            });
+            passed &= expect(
+                children && children->records.size() == 1 && children->records.front().id == "node:40",
+                "calltree child selection does not prefix-match unrelated node ids"
+            );
+            auto rootDetail = (*service)->detail(DetailRequest{
+                .jobId = jobId,
+                .view = "calltree-roots",
+                .recordId = "node:39",
+            });
+            passed &= expect(
+                rootDetail && rootDetail->related.size() == 1 && rootDetail->related.front().id == "node:40",
+                "calltree root detail returns its children without unrelated roots"
+            );
+            auto sources = (*service)->query(QueryRequest{
+                .jobId = jobId,
+                .view = "source-locations",
+                .limit = 20,
+            });
+            passed &= expect(
+                sources && sources->records.size() == 1
+                    && std::get<std::int64_t>(sources->records[0].fields.at("total_time").value) == 300
+                    && std::get<std::int64_t>(sources->records[0].fields.at("self_time").value) == 100
+                    && std::get<std::int64_t>(sources->records[0].fields.at("thread_count").value) == 2,
+                "Native source-locations view aggregates the same source across threads"
+            );
+            auto slowest = (*service)->query(QueryRequest{
+                .jobId = jobId,
+                .view = "slowest-calls",
+                .limit = 20,
+            });
+            passed &= expect(
+                slowest && slowest->records.size() == 2
+                    && std::get<std::int64_t>(slowest->records[0].fields.at("duration").value) == 150,
+                "Native slowest-calls exposes bounded event-level start and duration samples"
+            );
+            const auto folded = (*service)->exportReport({jobId, ExportFormat::Folded});
+            const auto flame = (*service)->exportReport({jobId, ExportFormat::FlameGraph});
+            std::ifstream foldedFile(folded ? folded->path : std::filesystem::path());
+            const std::string foldedText{std::istreambuf_iterator<char>(foldedFile), {}};
+            passed &= expect(
+                folded && folded->path.filename() == "report.folded" && folded->size == foldedText.size()
+                    && foldedText.find("Main;zone-39 (Engine);zone-40 (Engine) 50\n") != std::string::npos
+                    && foldedText.find("Main;zone-390 (Engine) 50\n") != std::string::npos,
+                "Native call trees export as folded stacks under their thread"
+            );
+            passed &= expect(
+                flame && flame->path.filename() == "report.flame.svg" && flame->sha256.size() == 64,
+                "Native call trees export as a flame graph"
+            );
+            const auto pprof = (*service)->exportReport({jobId, ExportFormat::Pprof});
+            const auto trace = (*service)->exportReport({jobId, ExportFormat::ChromeTrace});
+            std::ifstream traceFile(trace ? trace->path : std::filesystem::path());
+            passed &= expect(
+                pprof && pprof->path.filename() == "report.pb.gz" && pprof->size > 0 && trace
+                    && trace->path.filename() == "report.trace.json"
+                    && nlohmann::json::parse(traceFile, nullptr, false)["traceEvents"].size() > 4,
+                "Native jobs export pprof profiles and Chrome traces"
+            );
+            (*service)->shutdown();
+        }
+        std::filesystem::remove_all(root, ignored);
+        return passed;
+    }
+
+    bool testColumnarStoreKeepsRecordSemantics() {
+        const auto cpuNode = [](std::int64_t id, std::string module, std::string name, double total) {
+            return nlohmann::json::array({id, std::move(module), 3, std::move(name), 1, 1, total / 2, total, 1, "Main", "client"});
+        };
+        const nlohmann::json data{
+            {"nodes", nlohmann::json::array({
+                cpuNode(1, "pack/combat.py", "tick", 0.25),
+                cpuNode(2, "pack/combat.py", "Attack", 0.5),
+                cpuNode(3, "pack/ui.py", "draw", 0.125),
+                nlohmann::json::array({4, "broken"}),
+            })},
+            {"edges", nlohmann::json::array({nlohmann::json::array({1, 99, 2, 0.01, 0.02})})},
+        };
+        const auto built = buildProfileStore(ProfilerKind::PythonCpu, data);
+        if (!expect(built.has_value(), "a collector payload encodes and opens")) return false;
+        const auto& store = **built;
+        const auto* hotspots = store.view("hotspots");
+        const auto* calls = store.view("calls");
+        bool passed = expect(hotspots && calls && !store.view("growth"), "Python CPU builds exactly its own views");
+        if (!passed) return false;
+        passed &= expect(hotspots->rows.size() == 3, "malformed collector rows are skipped");
+
+        const auto* module = store.column(*hotspots, "module");
+        passed &= expect(
+            module && module->text(0) == module->text(1) && module->text(0) != module->text(2),
+            "repeated strings are interned once"
+        );
+        passed &= expect(
+            filterRows(store, *hotspots, "combat/").empty() && filterRows(store, *hotspots, "combat.py").size() == 2,
+            "filters match case-insensitively against field text"
+        );
+        passed &= expect(filterRows(store, *hotspots, "name attack").size() == 1, "filters see the field name too");
+        passed &= expect(filterRows(store, *hotspots, "total_time 0.125").size() == 1, "reals format like streams");
+
+        std::vector<std::uint32_t> rows(hotspots->rows.begin(), hotspots->rows.end());
+        sortRows(store, *hotspots, rows, "total_time", true);
+        passed &= expect(rows == std::vector<std::uint32_t>{1, 0, 2}, "numeric columns sort numerically");
+        sortRows(store, *hotspots, rows, "name", false);
+        passed &= expect(rows == std::vector<std::uint32_t>{1, 2, 0}, "text columns sort by byte order");
+
+        const auto edge = materializeRecord(store, *calls, calls->rows.front());
+        passed &= expect(
+            edge.id == "edge:0" && edge.fields.contains("caller_name") && !edge.fields.contains("callee_name")
+                && std::get<double>(edge.fields.at("total_time").value) == 0.02
+                && edge.fields.at("total_time").unit == "seconds",
+            "absent optional fields are not materialized as empty values"
+        );
+        return passed;
+    }
+
+    bool testProfileImageMapsAndRejectsCorruption() {
+        const nlohmann::json data{
+            {"rows", nlohmann::json::array({
+                nlohmann::json::array({1, 100, 2, 300, 4, nlohmann::json::array({
+                    nlohmann::json::array({"pack/a.py", 3}), nlohmann::json::array({"pack/b.py", 7}),
+                })}),
+                nlohmann::json::array({2, 0, 0, 50, 1, nlohmann::json::array()}),
+            })},
+        };
+        const auto bytes = encodeProfile(ProfilerKind::PythonMemory, data);
+        const auto path  = std::filesystem::temp_directory_path()
+                        / ("mcdev-profile-image-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ) + ".mcprof");
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+        auto image = ProfileImage::map(path);
+        auto mapped = image ? openProfileStore(*image) : std::unexpected(image.error());
+        bool passed = expect(mapped.has_value() && (*mapped)->image->mapped(), "an encoded profile maps from disk");
+        if (passed) {
+            const auto& store = **mapped;
+            const auto* growth = store.view("growth");
+            const auto* retained = store.view("retained");
+            const auto* traceback = growth ? store.column(*growth, "traceback") : nullptr;
+            passed &= expect(
+                store.kind == ProfilerKind::PythonMemory && growth && growth->rows.size() == 1 && retained
+                    && retained->rows.size() == 2 && !store.column(*retained, "size_diff"),
+                "views and projections survive the round trip"
+            );
+            passed &= expect(
+                traceback && cellText(store, *traceback, growth->rows.front()) == "pack/a.py:3 <- pack/b.py:7",
+                "stacks resolve through the mapped frame and string sections"
+            );
+            const auto built = buildProfileStore(ProfilerKind::PythonMemory, data);
+            passed &= expect(
+                built && profileJson(**built) == profileJson(store)
+                    && profileJson(store)["views"]["retained"][1]["fields"]["current_size"]["unit"] == "bytes",
+                "the JSON export of a mapped profile matches the in-memory one"
+            );
+        }
+
+        const auto rejects = [&](std::vector<std::byte> corrupt) {
+            return !openProfileStore(std::make_shared<const ProfileImage>(std::move(corrupt)));
+        };
+        auto truncated = bytes;
+        truncated.resize(truncated.size() - 8);
+        auto foreign = bytes;
+        foreign[0] = std::byte{'X'};
+        auto outside = bytes;
+        std::fill_n(outside.begin() + 32 + 8, 8, std::byte{0xff}); // Offset of the first section.
+        passed &= expect(
+            rejects(truncated) && rejects(foreign) && rejects(outside) && !openProfileStore(nullptr),
+            "truncated, foreign and out-of-bounds images are rejected"
+        );
+
+        // Point the first row of every view past its table; the image still opens, since rows are checked lazily.
+        auto rowOutside = bytes;
+        std::uint32_t sections = 0;
+        std::memcpy(&sections, rowOutside.data() + 16, sizeof(sections));
+        for (std::uint32_t index = 0; index < sections; ++index) {
+            const auto    entry = rowOutside.data() + 32 + index * 24;
+            std::uint32_t type  = 0;
+            std::uint64_t offset = 0;
+            std::uint32_t rows  = 0;
+            std::memcpy(&type, entry, sizeof(type));
+            std::memcpy(&offset, entry + 8, sizeof(offset));
+            if (type != 5) continue;
+            std::memcpy(&rows, rowOutside.data() + offset + 8, sizeof(rows));
+            if (rows > 0) std::fill_n(rowOutside.begin() + static_cast<std::ptrdiff_t>(offset) + 16, 4, std::byte{0xff});
+        }
+        const auto lazy = openProfileStore(std::make_shared<const ProfileImage>(std::move(rowOutside)));
+        passed &= expect(
+            lazy && !(*lazy)->view("growth") && !(*lazy)->view("retained")
+                && !profileJson(**lazy)["views"].contains("growth"),
+            "views whose rows lie outside their table are unavailable once they are first used"
+        );
+        image = {};
+        mapped = {};
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        return passed;
+    }
+
+    bool testTopRowsMatchSortedPrefix() {
+        auto nodes = nlohmann::json::array();
+        for (int id = 0; id < 200; ++id) {
+            nodes.push_back(nlohmann::json::array({
+                id, "pack/perf.py", id % 7, "f" + std::to_string(id % 5), 10, 10, (id % 4) * 0.01, (id % 3) * 0.1,
+                id % 6, "Main", "client",
+            }));
+        }
+        const auto store = buildProfileStore(ProfilerKind::PythonCpu, nlohmann::json{{"nodes", nodes}});
+        const auto* view = store ? (*store)->view("hotspots") : nullptr;
+        if (!expect(view && view->rows.size() == 200, "top-k fixture builds")) return false;
+        bool passed = true;
+        for (const auto field : {"total_time", "name", "calls", "line", "missing"}) {
+            for (const bool descending : {true, false}) {
+                auto sorted = filterRows(**store, *view, "");
+                auto top    = sorted;
+                sortRows(**store, *view, sorted, field, descending);
+                selectTopRows(**store, *view, top, field, descending, 17);
+                passed &= expect(
+                    top.size() == 17 && std::equal(top.begin(), top.end(), sorted.begin()),
+                    "top-k selection keeps the stable sort's leading rows and tie order"
+                );
+            }
+        }
+        return passed;
+    }
+
+    bool testStackExportsFoldCallGraphsAndTracebacks() {
+        const auto folded = [](const std::shared_ptr<const ProfileStore>& store) {
+            std::ostringstream output;
+            writeFoldedStacks(*store, output);
+            std::vector<std::string> lines;
+            std::istringstream       input(output.str());
+            for (std::string line; std::getline(input, line);) lines.push_back(line);
+            std::sort(lines.begin(), lines.end());
+            return lines;
+        };
+        using Lines = std::vector<std::string>;
+
+        // main calls a and b, a calls b, and b calls a; below a, that call back stays with the caller.
+        const nlohmann::json cpu{
+            {"nodes", nlohmann::json::array({
+                nlohmann::json::array({1, "m.py", 1, "main", 1, 1, 0.1, 1.0, 1, "Main", "client"}),
+                nlohmann::json::array({2, "m.py", 2, "a", 1, 1, 0.4, 0.6, 1, "Main", "client"}),
+                nlohmann::json::array({3, "m.py", 3, "b;c", 2, 2, 0.5, 0.5, 1, "Main", "client"}),
+            })},
+            {"edges", nlohmann::json::array({
+                nlohmann::json::array({1, 2, 1, 0.4, 0.6}),
+                nlohmann::json::array({1, 3, 1, 0.3, 0.3}),
+                nlohmann::json::array({2, 3, 1, 0.2, 0.2}),
+                nlohmann::json::array({3, 2, 1, 0.0, 0.1}),
+            })},
+        };
+        const auto cpuStore = buildProfileStore(ProfilerKind::PythonCpu, cpu);
+        if (!expect(cpuStore.has_value(), "stack export CPU fixture builds")) return false;
+        bool passed = expect(
+            folded(*cpuStore) == Lines{
+                "main (m.py:1) 100000000",
+                "main (m.py:1);a (m.py:2) 400000000",
+                "main (m.py:1);a (m.py:2);b,c (m.py:3) 200000000",
+                "main (m.py:1);b,c (m.py:3) 240000000",
+                "main (m.py:1);b,c (m.py:3);a (m.py:2) 60000000",
+            },
+            "Python call graphs fold into stacks weighted by edge time in nanoseconds"
+        );
+
+        const nlohmann::json memory{{"rows", nlohmann::json::array({
+            nlohmann::json::array({1, 100, 1, 100, 1, nlohmann::json::array({
+                nlohmann::json::array({"leaf.py", 5}), nlohmann::json::array({"main.py", 1}),
+            })}),
+            nlohmann::json::array({2, 0, 0, 10, 1, nlohmann::json::array()}),
+            nlohmann::json::array({3, 50, 1, 50, 1, nlohmann::json::array({
+                nlohmann::json::array({"other.py", 7}), nlohmann::json::array({"main.py", 1}),
+            })}),
+            nlohmann::json::array({4, 9, 1, 0, 0, nlohmann::json::array({nlohmann::json::array({"freed.py", 2})})}),
+        })}};
+        const auto memoryStore = buildProfileStore(ProfilerKind::PythonMemory, memory);
+        if (!expect(memoryStore.has_value(), "stack export memory fixture builds")) return false;
+        passed &= expect(
+            folded(*memoryStore) == Lines{
+                "main.py:1;leaf.py:5 100",
+                "main.py:1;other.py:7 50",
+                "unknown allocation site 10",
+            },
+            "retained tracebacks fold outermost frame first, weighted by retained bytes"
+        );
+
+        std::ostringstream svg;
+        writeFlameGraph(**memoryStore, "Memory <flame>", "job", svg);
+        const auto document = svg.str();
+        const auto count = [&](std::string_view needle) {
+            std::size_t found = 0;
+            for (auto at = document.find(needle); at != std::string::npos; at = document.find(needle, at + 1)) ++found;
+            return found;
+        };
+        passed &= expect(
+            document.starts_with("<?xml") && document.ends_with("</svg>\n") && count("Memory &lt;flame&gt;") == 1
+                && count("<title>all\n160 B") == 1 && count("<title>main.py:1\n") == 1
+                && count("<g class=\"f\">") == 5 && count("<script") == 1,
+            "flame graphs draw each merged frame once under an escaped title with their inclusive weight"
+        );
+        // A chain of 300 calls keeps 256 frames below its thread; the 44 deeper ones weigh on the last frame kept.
+        auto chain = nlohmann::json::array();
+        for (std::int64_t id = 299; id >= 0; --id) {
+            chain = nlohmann::json::array({nlohmann::json{
+                {"id", id + 1}, {"name", "depth-" + std::to_string(id)}, {"sourceFile", "deep.cpp"}, {"calls", 1},
+                {"totalNanoseconds", 300 - id}, {"selfNanoseconds", 1}, {"children", std::move(chain)},
+            }});
+        }
+        const nlohmann::json thread{{"id", "1"}, {"name", "Main"}, {"roots", std::move(chain)}};
+        const auto deepStore = buildProfileStore(ProfilerKind::NativeCpu, nlohmann::json{{"threads", {thread}}});
+        if (!expect(deepStore.has_value(), "stack export deep fixture builds")) return false;
+        const auto deep    = folded(*deepStore);
+        const auto frames  = [](const std::string& line) { return std::count(line.begin(), line.end(), ';'); };
+        const auto deepest = std::max_element(deep.begin(), deep.end(), [&](const auto& left, const auto& right) {
+            return frames(left) < frames(right);
+        });
+        passed &= expect(
+            deep.size() == 256 && deepest != deep.end() && frames(*deepest) == 256
+                && deepest->find(";depth-255 ") != std::string::npos && deepest->ends_with(" 45"),
+            "stacks deeper than the limit fold their weight into the deepest frame kept"
+        );
+
+        std::ostringstream empty;
+        writeFlameGraph(**buildProfileStore(ProfilerKind::NativeCpu, nlohmann::json::object()), "Empty", "", empty);
+        passed &= expect(
+            empty.str().find("No stacks were captured.") != std::string::npos,
+            "an empty capture renders a placeholder flame graph"
+        );
+        return passed;
+    }
+
+    // Just enough of the protobuf wire format to read a pprof Profile back.
+    struct ProtoField {
+        std::uint32_t    number = 0;
+        std::uint64_t    integer = 0;
+        std::string_view bytes;
+    };
+
+    std::optional<std::uint64_t> readVarint(std::string_view& input) {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64 && !input.empty(); shift += 7) {
+            const auto byte = static_cast<unsigned char>(input.front());
+            input.remove_prefix(1);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::vector<ProtoField>> readMessage(std::string_view input) {
+        std::vector<ProtoField> fields;
+        while (!input.empty()) {
+            const auto key = readVarint(input);
+            if (!key) return std::nullopt;
+            ProtoField field{.number = static_cast<std::uint32_t>(*key >> 3)};
+            if ((*key & 7) == 0) {
+                const auto value = readVarint(input);
+                if (!value) return std::nullopt;
+                field.integer = *value;
+            } else if ((*key & 7) == 2) {
+                const auto size = readVarint(input);
+                if (!size || *size > input.size()) return std::nullopt;
+                field.bytes = input.substr(0, *size);
+                input.remove_prefix(*size);
+            } else {
+                return std::nullopt;
+            }
+            fields.push_back(field);
+        }
+        return fields;
+    }
+
+    std::string gunzip(std::string_view compressed) {
+        z_stream stream{};
+        if (inflateInit2(&stream, 15 + 16) != Z_OK) return {};
+        std::string output;
+        std::array<char, 4096> buffer{};
+        stream.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+        stream.avail_in = static_cast<uInt>(compressed.size());
+        int status = Z_OK;
+        while (status == Z_OK) {
+            stream.next_out  = reinterpret_cast<Bytef*>(buffer.data());
+            stream.avail_out = static_cast<uInt>(buffer.size());
+            status           = inflate(&stream, Z_NO_FLUSH);
+            output.append(buffer.data(), buffer.size() - stream.avail_out);
+        }
+        inflateEnd(&stream);
+        return status == Z_STREAM_END ? output : std::string();
+    }
+
+    bool testInterchangeExportsReadBack() {
+        const nlohmann::json cpu{
+            {"nodes", nlohmann::json::array({
+                nlohmann::json::array({1, "m.py", 1, "main", 1, 1, 0.25, 1.0, 1, "Main", "client"}),
+                nlohmann::json::array({2, "m.py", 2, "work", 1, 1, 0.75, 0.75, 1, "Main", "client"}),
+            })},
+            {"edges", nlohmann::json::array({nlohmann::json::array({1, 2, 1, 0.75, 0.75})})},
+        };
+        const auto cpuStore = buildProfileStore(ProfilerKind::PythonCpu, cpu);
+        if (!expect(cpuStore.has_value(), "pprof fixture builds")) return false;
+        std::ostringstream compressed;
+        writePprof(**cpuStore, compressed);
+        const auto profile = gunzip(compressed.str());
+        const auto fields  = readMessage(profile);
+        bool passed = expect(fields.has_value() && !fields->empty(), "pprof export is a gzip-compressed protobuf");
+        if (!fields) return false;
+
+        std::vector<std::string_view> strings;
+        std::vector<std::uint64_t>    values;
+        std::size_t                   functions = 0;
+        std::size_t                   locations = 0;
+        std::size_t                   leafDepth = 0;
+        for (const auto& field : *fields) {
+            if (field.number == 6) strings.push_back(field.bytes);
+            if (field.number == 4) ++locations;
+            if (field.number == 5) ++functions;
+            if (field.number != 2) continue;
+            for (const auto& sampleField : readMessage(field.bytes).value_or(std::vector<ProtoField>{})) {
+                auto packed = sampleField.bytes;
+                std::size_t count = 0;
+                while (const auto value = packed.empty() ? std::nullopt : readVarint(packed)) {
+                    if (sampleField.number == 2) values.push_back(*value);
+                    ++count;
+                }
+                if (sampleField.number == 1) leafDepth = std::max(leafDepth, count);
+            }
+        }
+        std::sort(values.begin(), values.end());
+        passed &= expect(
+            !strings.empty() && strings.front().empty()
+                && std::find(strings.begin(), strings.end(), "cpu") != strings.end()
+                && std::find(strings.begin(), strings.end(), "nanoseconds") != strings.end()
+                && std::find(strings.begin(), strings.end(), "work") != strings.end(),
+            "pprof string table starts empty and names the sample type and functions"
+        );
+        passed &= expect(
+            functions == 2 && locations == 2 && leafDepth == 2
+                && values == std::vector<std::uint64_t>{250000000, 750000000},
+            "pprof samples carry each stack's own nanoseconds over deduplicated locations"
+        );
+
+        const auto zone = [](std::int64_t id, const char* thread, std::int64_t start, std::int64_t duration) {
+            return nlohmann::json{
+                {"id", id}, {"name", "zone-" + std::to_string(id)}, {"sourceFile", "engine.cpp"}, {"sourceLine", 4},
+                {"threadId", thread}, {"threadName", std::string("T") + thread}, {"calls", 3},
+                {"totalNanoseconds", 900}, {"selfNanoseconds", 600}, {"meanNanoseconds", 300},
+                {"maximumNanoseconds", 500},
+                {"slowestCalls", nlohmann::json::array({
+                    nlohmann::json{{"startNanoseconds", start}, {"durationNanoseconds", duration}},
+                })},
+            };
+        };
+        const auto node = [](std::int64_t id, std::int64_t total, nlohmann::json children = nlohmann::json::array()) {
+            return nlohmann::json{
+                {"id", id}, {"name", "node-" + std::to_string(id)}, {"sourceFile", "engine.cpp"}, {"calls", 1},
+                {"totalNanoseconds", total}, {"selfNanoseconds", total / 2}, {"children", std::move(children)},
+            };
+        };
+        const nlohmann::json native{
+            {"zones", nlohmann::json::array({zone(1, "7", 2000, 500), zone(2, "8", 4000, 1500)})},
+            {"threads", nlohmann::json::array({
+                nlohmann::json{{"id", "7"}, {"name", "Main"}, {"roots", nlohmann::json::array({
+                    node(10, 1000, nlohmann::json::array({node(11, 600), node(12, 700)})),
+                    node(13, 200),
+                })}},
+            })},
+        };
+        const auto nativeStore = buildProfileStore(ProfilerKind::NativeCpu, native);
+        if (!expect(nativeStore.has_value(), "Chrome trace fixture builds")) return false;
+        std::ostringstream traceText;
+        writeChromeTrace(**nativeStore, traceText);
+        const auto trace = nlohmann::json::parse(traceText.str(), nullptr, false);
+        passed &= expect(trace.is_object() && trace["traceEvents"].is_array(), "Chrome trace export is trace-event JSON");
+        if (!trace.is_object() || !trace["traceEvents"].is_array()) return false;
+
+        std::vector<nlohmann::json> recorded;
+        std::vector<nlohmann::json> calltree;
+        std::size_t                 threadNames = 0;
+        for (const auto& event : trace["traceEvents"]) {
+            if (event["ph"] == "M" && event["name"] == "thread_name") ++threadNames;
+            if (event["ph"] != "X") continue;
+            (event["pid"] == 1 ? recorded : calltree).push_back(event);
+        }
+        passed &= expect(
+            recorded.size() == 2 && recorded[0]["ts"] == 2.0 && recorded[0]["dur"] == 0.5
+                && recorded[1]["ts"] == 4.0 && recorded[1]["tid"] != recorded[0]["tid"]
+                && recorded[0]["args"]["zone_calls"] == 3 && recorded[0]["args"]["zone_self_time_ns"] == 600
+                && threadNames == 4,
+            "recorded slowest calls keep their start times, thread and zone timings"
+        );
+        const auto endOf = [](const nlohmann::json& event) {
+            return event["ts"].get<double>() + event["dur"].get<double>();
+        };
+        passed &= expect(
+            calltree.size() == 4 && calltree[0]["ts"] == 0.0 && calltree[0]["dur"] == 1.0
+                && calltree[1]["ts"] == 0.0 && calltree[1]["dur"] == 0.6
+                && calltree[2]["ts"] == 0.6 && endOf(calltree[2]) <= endOf(calltree[0])
+                && calltree[3]["ts"] == 1.0 && calltree[3]["dur"] == 0.2,
+            "call tree timelines nest children inside their parent and never past its end"
+        );
+
+        std::ostringstream empty;
+        writeChromeTrace(**cpuStore, empty);
+        passed &= expect(
+            nlohmann::json::parse(empty.str(), nullptr, false)["traceEvents"].empty(),
+            "Chrome trace export of a Python capture has no events"
+        );
+        return passed;
+    }
+
+    bool testFilterExpressionsCompileToTypedPredicates() {
+        auto zones = nlohmann::json::array();
+        const auto zone = [&](std::int64_t id, std::string name, std::string file, std::int64_t self) {
+            zones.push_back({
+                {"id", id}, {"name", std::move(name)}, {"sourceFile", std::move(file)}, {"sourceLine", 10 + id},
+                {"threadId", "1"}, {"threadName", "Main"}, {"calls", id * 100}, {"totalNanoseconds", self * 2},
+                {"selfNanoseconds", self}, {"meanNanoseconds", self}, {"maximumNanoseconds", self},
+            });
+        };
+        zone(1, "Combat::Tick", "game/combat/tick.cpp", 3'000'000);
+        zone(2, "Combat::Aim", "game/combat/aim.cpp", 500'000);
+        zone(3, "Render::Frame", "engine/render.cpp", 9'000'000);
+        zone(4, "<module>", "game/<module>.py", 100);
+        const auto store = buildProfileStore(ProfilerKind::NativeCpu, nlohmann::json{{"zones", zones}});
+        const auto* view = store ? (*store)->view("hotspots") : nullptr;
+        if (!expect(view && view->rows.size() == 4, "filter fixture builds")) return false;
+
+        const auto names = [&](std::string_view text) -> std::expected<std::vector<std::string>, std::string> {
+            auto expression = FilterExpression::parse(text);
+            if (!expression) return std::unexpected(expression.error().code);
+            std::vector<std::uint32_t> rows;
+            if (*expression) {
+                auto selected = (*expression)->select(**store, *view);
+                if (!selected) return std::unexpected(selected.error().code);
+                rows = std::move(*selected);
+            } else {
+                rows = filterRows(**store, *view, text);
+            }
+            std::vector<std::string> result;
+            const auto* name = (*store)->column(*view, "name");
+            for (const auto row : rows) result.push_back(cellText(**store, *name, row));
+            return result;
+        };
+        using Names = std::vector<std::string>;
+        bool passed = expect(
+            names("self_time > 2ms and source_file contains COMBAT/") == Names{"Combat::Tick"},
+            "units convert to the column's unit and contains ignores case"
+        );
+        passed &= expect(
+            names("(name ~ '^combat::' or calls == 300) and not name == Combat::Aim")
+                == Names{"Combat::Tick", "Render::Frame"},
+            "regex, boolean operators, grouping and exact text compose"
+        );
+        passed &= expect(
+            names("source_file glob '*.cpp' and self_time <= 0.5ms") == Names{"Combat::Aim"},
+            "glob matches the whole value"
+        );
+        passed &= expect(
+            names("render and self_time>1ms") == Names{"Render::Frame"},
+            "a bare word inside an expression matches like a plain text filter"
+        );
+        passed &= expect(names("<module>") == Names{"<module>"}, "text without a comparison stays a plain filter");
+        passed &= expect(
+            names("self_time > 2mib") == std::unexpected(std::string("FILTER_UNIT_INVALID"))
+                && names("missing > 1") == std::unexpected(std::string("FILTER_FIELD_UNKNOWN"))
+                && names("name > 1") == std::unexpected(std::string("FILTER_OPERATOR_INVALID"))
+                && names("calls > 1 and (") == std::unexpected(std::string("FILTER_INVALID"))
+                && names("name ~ '('") == std::unexpected(std::string("FILTER_INVALID")),
+            "malformed expressions report which part is wrong"
+        );
+        return passed;
+    }
+
+    bool testQueryCacheBoundsAndScopesEntries() {
+        const auto store = buildProfileStore(ProfilerKind::PythonMemory, nlohmann::json{{"rows", nlohmann::json::array()}});
+        const auto other = buildProfileStore(ProfilerKind::PythonMemory, nlohmann::json{{"rows", nlohmann::json::array()}});
+        if (!expect(store && other, "empty profiles build")) return false;
+        QueryCache cache(4096);
+        int computed = 0;
+        const auto rows = [&](std::size_t count) {
+            return [&computed, count] {
+                ++computed;
+                return RowIndex{.rows = std::vector<std::uint32_t>(count, 0)};
+            };
+        };
+        const auto a = QueryCache::key("job", {"query", "a"});
+        cache.obtain<RowIndex>(a, *store, rows(100));
+        cache.obtain<RowIndex>(a, *store, rows(100));
+        bool passed = expect(computed == 1 && cache.size() == 1, "a repeated key is served from the cache");
+
+        cache.obtain<RowIndex>(a, *other, rows(100));
+        passed &= expect(computed == 2, "an entry is never returned for a different store");
+
+        cache.obtain<RowIndex>(QueryCache::key("job", {"query", "b"}), *store, rows(450));
+        cache.obtain<RowIndex>(QueryCache::key("job", {"query", "c"}), *store, rows(450));
+        passed &= expect(
+            cache.bytes() <= 4096 && cache.size() == 2,
+            "the least recently used entry is evicted to stay within the byte bound"
+        );
+        cache.obtain<RowIndex>(QueryCache::key("job", {"query", "c"}), *store, rows(450));
+        passed &= expect(computed == 4, "recently used entries survive eviction");
+        cache.obtain<RowIndex>(QueryCache::key("job", {"query", "huge"}), *store, rows(2000));
+        passed &= expect(cache.size() == 2, "a value larger than the whole cache is not kept");
+
+        cache.obtain<RowIndex>(QueryCache::key("job-2", {"query", "b"}), *store, rows(10));
+        cache.eraseJob("job");
+        passed &= expect(cache.size() == 1, "erasing a job keeps entries of jobs that share its prefix");
+        passed &= expect(
+            QueryCache::key("job", {"a|b", "c"}) != QueryCache::key("job", {"a", "b|c"}),
+            "filter text cannot make two requests share a key"
+        );
+        return passed;
+    }
+
+    bool testSemanticViewsStructuredTracebackAndCompare() {
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-semantic-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        const auto profiles = root / "profiles";
+        std::error_code ignored;
+        const auto writeJob = [&](std::string_view id, std::string_view kind, const nlohmann::json& data) {
+            const auto directory = profiles / id;
+            std::filesystem::create_directories(directory, ignored);
+            const nlohmann::json manifest{
+                {"job_id", id}, {"kind", kind}, {"state", "completed"}, {"partial", false},
+                {"created_at", "2026-01-01T00:00:00Z"}, {"completed_at", "2026-01-01T00:00:01Z"},
+            };
+            std::ofstream(directory / "manifest.json") << manifest.dump();
+            std::ofstream(directory / "data.json") << data.dump();
+            std::ofstream(directory / "summary.json") << nlohmann::json::object().dump();
+        };
+        const auto cpuNode = [](std::int64_t id, std::string name, double self, double total) {
+            return nlohmann::json::array({
+                id, "pack/perf.py", 12, std::move(name), 10, 10, self, total, 1, "Main", "client"
+            });
+        };
+        writeJob(
+            "baseline", "python.cpu",
+            nlohmann::json{
+                {"nodes", nlohmann::json::array({cpuNode(7, "tick", 0.04, 0.10), cpuNode(8, "removed", 0.01, 0.02)})},
+                {"edges", nlohmann::json::array({nlohmann::json::array({7, 8, 2, 0.01, 0.02})})},
+            }
+        );
+        writeJob(
+            "candidate", "python.cpu",
+            nlohmann::json{
+                {"nodes", nlohmann::json::array({cpuNode(3, "tick", 0.07, 0.16), cpuNode(4, "added", 0.02, 0.03)})},
+                {"edges", nlohmann::json::array()},
+            }
+        );
+        writeJob(
             "memory", "python.memory",
             nlohmann::json{
                 {"rows", nlohmann::json::array({
@@ -958,6 +2574,27 @@ namespace {
                     && retained->records[0].fields.contains("current_size"),
                 "memory retained view has distinct current-retention semantics"
             );
+            auto first = (*service)->query(QueryRequest{.jobId = "memory", .view = "retained", .limit = 1});
+            auto second = first && first->nextCursor ? (*service)->query(QueryRequest{
+                .jobId = "memory", .view = "retained", .limit = 1, .cursor = first->nextCursor,
+            }) : std::unexpected(ProfilerError{});
+            passed &= expect(
+                retained && first && second && first->records.size() == 1 && second->records.size() == 1
+                    && first->records[0].id == retained->records[0].id
+                    && second->records[0].id == retained->records[1].id && !second->truncated,
+                "cursor pages resume the cached order of the full query"
+            );
+            auto grown = (*service)->query(QueryRequest{
+                .jobId = "memory", .view = "growth", .filter = "size_diff > 0 and traceback contains pack/a.py", .limit = 20,
+            });
+            auto unknownField = (*service)->query(QueryRequest{
+                .jobId = "memory", .view = "growth", .filter = "self_time > 1ms", .limit = 20,
+            });
+            passed &= expect(
+                grown && grown->records.size() == 1 && grown->totalAvailable == 1 && !unknownField
+                    && unknownField.error().code == "FILTER_FIELD_UNKNOWN",
+                "query filters accept typed expressions and reject fields the view lacks"
+            );
             auto fakeView = (*service)->query(QueryRequest{.jobId = "baseline", .view = "functions", .limit = 20});
             passed &= expect(
                 !fakeView && fakeView.error().code == "VIEW_INVALID",
@@ -991,6 +2628,17 @@ namespace {
                     && std::abs(std::get<double>(tick->fields.at("delta").value) - 0.06) < 0.000001,
                 "compare aligns stable function identities and reports bounded deltas"
             );
+            auto repeated = (*service)->compare(CompareRequest{
+                .baselineJobId = "baseline",
+                .candidateJobId = "candidate",
+                .view = "hotspots",
+                .limit = 20,
+            });
+            passed &= expect(
+                compared && repeated && repeated->records.size() == compared->records.size()
+                    && repeated->matched == compared->matched && repeated->added == compared->added,
+                "a repeated compare reuses its cached sides without changing the result"
+            );
             auto invalidMetric = (*service)->compare(CompareRequest{
                 .baselineJobId = "baseline", .candidateJobId = "candidate",
                 .view = "hotspots", .metric = "line",
@@ -1012,6 +2660,254 @@ namespace {
         return passed;
     }
 
+    bool testTrendStatisticsMatchStudentT() {
+        bool passed = expect(
+            std::abs(studentTwoSided(2.0, 10) - 0.073388) < 1e-6 && std::abs(studentTwoSided(2.228139, 10) - 0.05) < 1e-6
+                && std::abs(studentTwoSided(-1.0, 1) - 0.5) < 1e-9 && studentTwoSided(0, 5) == 1.0,
+            "two-sided t tail probabilities match the distribution"
+        );
+        const std::array<double, 4> before{1, 2, 3, 4};
+        const std::array<double, 4> after{2, 4, 6, 8};
+        const auto welch = trendTest(before, after);
+        passed &= expect(
+            welch && std::abs(welch->baselineVariance - 5.0 / 3.0) < 1e-12 && std::abs(welch->t - std::sqrt(3.0)) < 1e-9
+                && std::abs(welch->degreesOfFreedom - 4.411765) < 1e-6 && std::abs(welch->pValue - 0.151581) < 1e-5,
+            "two candidate groups use Welch's t-test"
+        );
+        const std::array<double, 5> steady{10, 11, 9, 10, 10};
+        const std::array<double, 1> latest{15};
+        const auto single = trendTest(steady, latest);
+        passed &= expect(
+            single && single->degreesOfFreedom == 4 && std::abs(single->pValue - 0.0029655) < 1e-6,
+            "one candidate run is tested against the baseline's prediction interval"
+        );
+        const std::array<double, 2> flat{3, 3};
+        const std::array<double, 1> same{3};
+        const std::array<double, 1> moved{4};
+        passed &= expect(
+            trendTest(flat, same)->pValue == 1.0 && trendTest(flat, moved)->pValue == 0.0
+                && !trendTest(latest, same) && !trendTest(flat, std::span<const double>{}),
+            "noiseless runs are decided exactly and short series are not tested"
+        );
+        return passed;
+    }
+
+    bool testTrendFlagsRegressionsAcrossHistory() {
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-trend-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        const auto profiles = root / "profiles";
+        std::error_code ignored;
+        using Json = nlohmann::json;
+        const auto cpuNode = [](std::int64_t id, std::string name, double self) {
+            return Json::array({id, "pack/perf.py", 10 + id, std::move(name), 10, 10, self, self, 1, "Main", "server"});
+        };
+        // Runs one to six, oldest first; run six is also the newest run of the trend.
+        const auto writeRun = [&](int run, Json nodes, bool partial = false, std::string_view kind = "python.cpu") {
+            const auto id = "run-" + std::to_string(run);
+            const auto directory = profiles / id;
+            std::filesystem::create_directories(directory, ignored);
+            const Json manifest{
+                {"job_id", id}, {"kind", kind}, {"state", "completed"}, {"partial", partial},
+                {"created_at", "2026-01-01T00:00:0" + std::to_string(run) + "Z"}, {"completed_at", "2026-01-01T00:01:00Z"},
+            };
+            std::ofstream(directory / "manifest.json") << manifest.dump();
+            std::ofstream(directory / "data.json") << Json{{"nodes", std::move(nodes)}, {"edges", Json::array()}}.dump();
+            std::ofstream(directory / "summary.json") << Json::object().dump();
+        };
+        const std::array<double, 6> tick{0.050, 0.041, 0.040, 0.039, 0.040, 0.080};
+        const std::array<double, 6> steady{0.010, 0.011, 0.009, 0.010, 0.012, 0.0105};
+        for (int run = 1; run <= 6; ++run) {
+            auto nodes = Json::array({cpuNode(1, "tick", tick[run - 1]), cpuNode(2, "steady", steady[run - 1])});
+            if (run < 6) nodes.push_back(cpuNode(3, "retired", 0.02));
+            if (run == 6) nodes.push_back(cpuNode(4, "spawned", 0.03));
+            if (run >= 5) nodes.push_back(cpuNode(5, "rare", 0.01));
+            writeRun(run, std::move(nodes));
+        }
+        writeRun(7, Json::array({cpuNode(1, "tick", 9.0)}), true);
+        writeRun(8, Json::array(), false, "python.memory");
+
+        auto service = createProfilerService({
+            .executeCode = [](std::string, ProfileTarget, std::chrono::milliseconds)
+                -> std::expected<nlohmann::json, GameExecutionError> { return nlohmann::json(true); },
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot = profiles,
+            .executableDirectory = root,
+        });
+        bool passed = expect(service.has_value(), "trend service is constructible");
+        if (!service) return false;
+
+        auto trend = (*service)->trend(TrendRequest{.view = "hotspots", .metric = "self_time", .runs = 5});
+        passed &= expect(
+            trend && trend->jobIds == std::vector<JobId>{"run-2", "run-3", "run-4", "run-5", "run-6"}
+                && trend->series == 5 && trend->regressed == 1 && trend->improved == 0,
+            "a trend takes the latest committed runs of the kind, skipping partial runs"
+        );
+        if (trend) {
+            const auto verdictOf = [&](std::string_view name) -> std::string {
+                for (const auto& record : trend->records) {
+                    if (std::get<std::string>(record.fields.at("name").value) == name) {
+                        return std::get<std::string>(record.fields.at("verdict").value);
+                    }
+                }
+                return {};
+            };
+            const auto& first = trend->records.front();
+            passed &= expect(
+                std::get<std::string>(first.fields.at("name").value) == "tick"
+                    && std::get<std::string>(first.fields.at("verdict").value) == "regressed"
+                    && std::abs(std::get<double>(first.fields.at("baseline_mean").value) - 0.04) < 1e-12
+                    && std::get<double>(first.fields.at("p_value").value) < 0.001
+                    && first.fields.at("baseline_variance").unit == "seconds^2",
+                "a significant rise past the threshold is ranked first as a regression"
+            );
+            passed &= expect(
+                verdictOf("steady") == "stable" && verdictOf("spawned") == "added" && verdictOf("retired") == "removed"
+                    && verdictOf("rare") == "insufficient",
+                "noise stays stable and identities without enough runs say so"
+            );
+        }
+        auto loose = (*service)->trend(TrendRequest{.view = "hotspots", .metric = "self_time", .runs = 5, .thresholdPercent = 150});
+        passed &= expect(loose && loose->regressed == 0, "a change below the threshold is not flagged");
+        auto pooled = (*service)->trend(TrendRequest{.view = "hotspots", .metric = "self_time", .runs = 6, .candidateRuns = 2});
+        passed &= expect(
+            pooled && pooled->jobIds.front() == "run-1" && pooled->regressed == 0
+                && std::any_of(pooled->records.begin(), pooled->records.end(), [](const auto& record) {
+                       return std::get<std::string>(record.fields.at("name").value) == "tick"
+                           && std::get<std::string>(record.fields.at("verdict").value) == "stable"
+                           && record.fields.contains("candidate_variance");
+                   }),
+            "several candidate runs are tested as a group, so one noisy run is not a regression"
+        );
+        auto tooMany = (*service)->trend(TrendRequest{.view = "hotspots", .runs = 10, .candidateRuns = 8});
+        auto tooFew = (*service)->trend(TrendRequest{.kind = ProfilerKind::NativeCpu, .view = "hotspots"});
+        auto calltree = (*service)->trend(TrendRequest{.view = "calltree-roots"});
+        passed &= expect(
+            !tooMany && tooMany.error().code == "TREND_RUNS_INSUFFICIENT" && tooMany.error().retryable && !tooFew
+                && tooFew.error().code == "TREND_RUNS_INSUFFICIENT" && !calltree
+                && calltree.error().code == "COMPARE_VIEW_INVALID",
+            "a trend needs enough runs and a comparable view"
+        );
+        (*service)->shutdown();
+        std::filesystem::remove_all(root, ignored);
+        return passed;
+    }
+
+    bool testCatalogIndexServesHistoryAndBoundsResidency() {
+        const auto root = std::filesystem::temp_directory_path()
+                        / ("mcdev-profiler-catalog-" + std::to_string(
+                            std::chrono::steady_clock::now().time_since_epoch().count()
+                        ));
+        const auto profiles = root / "profiles";
+        std::error_code ignored;
+        using Json = nlohmann::json;
+        const auto writeJob = [&](std::string_view id, int second) {
+            const auto directory = profiles / id;
+            std::filesystem::create_directories(directory, ignored);
+            const Json manifest{
+                {"job_id", id}, {"kind", "python.cpu"}, {"state", "completed"}, {"partial", false},
+                {"created_at", "2026-01-01T00:00:0" + std::to_string(second) + "Z"}, {"completed_at", "2026-01-01T00:01:00Z"},
+            };
+            std::ofstream(directory / "manifest.json") << manifest.dump();
+            std::ofstream(directory / "data.json") << Json{
+                {"nodes", Json::array({Json::array({1, "pack/perf.py", 10, "tick", 10, 10, 0.5, 0.5, 1, "Main", "server"})})},
+                {"edges", Json::array()},
+            }.dump();
+            std::ofstream(directory / "summary.json") << Json{{"kind", "python.cpu"}, {"total_functions", second}}.dump();
+        };
+        writeJob("job-a", 1);
+        writeJob("job-b", 2);
+        std::filesystem::create_directories(profiles / "job-torn", ignored);
+        const auto create = [&](std::size_t residentJobBytes) {
+            return createProfilerService({
+                .executeCode = [](std::string, ProfileTarget, std::chrono::milliseconds)
+                    -> std::expected<nlohmann::json, GameExecutionError> { return nlohmann::json(true); },
+                .currentGameProcessId = [] { return std::uint32_t{0}; },
+                .storageRoot = profiles,
+                .executableDirectory = root,
+                .residentJobBytes = residentJobBytes,
+            });
+        };
+        const auto historyIds = [](const auto& service) {
+            std::vector<JobId> ids;
+            if (const auto page = service->history(HistoryRequest{})) {
+                for (const auto& job : page->jobs) ids.push_back(job.id);
+            }
+            return ids;
+        };
+        const auto readIndex = [&] {
+            std::ifstream input(profiles / "catalog.json");
+            return Json::parse(input, nullptr, false);
+        };
+
+        auto first = create(1);
+        bool passed = expect(first.has_value(), "catalog service is constructible");
+        if (!first) return false;
+        passed &= expect(
+            historyIds(*first) == std::vector<JobId>{"job-b", "job-a"},
+            "the first history reads the manifests of committed jobs and skips torn directories"
+        );
+        auto index = readIndex();
+        passed &= expect(
+            index.is_object() && index.value("schema", 0) == 1 && index["jobs"].size() == 2
+                && index["jobs"][0].value("job_id", "") == "job-a" && index["jobs"][0].value("stored_bytes", 0) > 0
+                && index["jobs"][0]["summary"].value("total_functions", 0) == 1,
+            "history writes a catalog index with each job's size and summary"
+        );
+
+        // A budget of one byte keeps only the job just queried mapped.
+        const auto query = [&](const JobId& id) {
+            return (*first)->query(QueryRequest{.jobId = id, .view = "hotspots", .limit = 20});
+        };
+        passed &= expect(query("job-a").has_value() && query("job-b").has_value(), "cataloged jobs are queryable");
+        std::filesystem::remove(profiles / "job-a" / "data.json", ignored);
+        const auto evicted = query("job-a");
+        passed &= expect(
+            !evicted && evicted.error().code == "PROFILE_UNAVAILABLE"
+                && evicted.error().message.find("data.json") != std::string::npos,
+            "a job unmapped under the resident budget maps its image again when queried and reports why it cannot"
+        );
+        const auto status = (*first)->status("job-b");
+        passed &= expect(
+            status && status->storedBytes == index["jobs"][1].value("stored_bytes", std::uintmax_t{0}),
+            "a recovered job reports its stored size"
+        );
+        (*first)->shutdown();
+
+        std::filesystem::remove(profiles / "job-b" / "manifest.json", ignored);
+        writeJob("job-c", 3);
+        std::filesystem::remove_all(profiles / "job-a", ignored);
+        auto second = create(256 * 1024 * 1024);
+        passed &= expect(second.has_value(), "a second catalog service is constructible");
+        if (!second) return false;
+        passed &= expect(
+            historyIds(*second) == std::vector<JobId>{"job-c", "job-b"},
+            "a later session serves history from the index, reconciling added and removed directories by name"
+        );
+        passed &= expect(
+            (*second)->query(QueryRequest{.jobId = "job-b", .view = "hotspots"}).has_value(),
+            "a cataloged job is recovered without its manifest"
+        );
+        std::ofstream(profiles / "job-c" / "data.json") << "{";
+        const auto unloaded = (*second)->status("job-c");
+        const auto unreadable = (*second)->query(QueryRequest{.jobId = "job-c", .view = "hotspots"});
+        passed &= expect(
+            unloaded && unloaded->state == JobState::Completed && !unreadable
+                && unreadable.error().code == "PROFILE_UNAVAILABLE",
+            "status recovers a job without loading its profile, which only a query reads"
+        );
+        passed &= expect((*second)->discard("job-c").has_value(), "a recovered job can be discarded");
+        index = readIndex();
+        passed &= expect(
+            index.is_object() && index["jobs"].size() == 1 && index["jobs"][0].value("job_id", "") == "job-b",
+            "discarding a job removes it from the index"
+        );
+        (*second)->shutdown();
+        std::filesystem::remove_all(root, ignored);
+        return passed;
+    }
+
 } // namespace
 
 int main() {
@@ -1024,8 +2920,26 @@ int main() {
     passed      &= testAutomaticDeadlineAndPersistence();
     passed      &= testTemporaryMemoryStorageAndLazyGc();
     passed      &= testPythonCaptureOwnershipTokens();
+    passed      &= testFlightRecorderKeepsABoundedWindow();
+    passed      &= testFlightRecorderSnapshotsIntoJobs();
+    passed      &= testSampledStacksFoldIntoCallGraphs();
+    passed      &= testSamplingEngineRunsWithoutYappi();
+    passed      &= testTriggersStartTaggedCaptures();
+    passed      &= testFrameHistogramsKeepPercentiles();
+    passed      &= testFrameTimeJobsRunBesideCpuCaptures();
+    passed      &= testMemorySnapshotsFitSiteGrowthAndCallTree();
     passed      &= testNativeDoesNotFallbackWithoutDll();
     passed      &= testNativeCalltreeChildrenUseExactParentId();
     passed      &= testSemanticViewsStructuredTracebackAndCompare();
+    passed      &= testTrendStatisticsMatchStudentT();
+    passed      &= testTrendFlagsRegressionsAcrossHistory();
+    passed      &= testCatalogIndexServesHistoryAndBoundsResidency();
+    passed      &= testColumnarStoreKeepsRecordSemantics();
+    passed      &= testProfileImageMapsAndRejectsCorruption();
+    passed      &= testQueryCacheBoundsAndScopesEntries();
+    passed      &= testTopRowsMatchSortedPrefix();
+    passed      &= testFilterExpressionsCompileToTypedPredicates();
+    passed      &= testStackExportsFoldCallGraphsAndTracebacks();
+    passed      &= testInterchangeExportsReadBack();
     return passed ? 0 : 1;
 }
@@ -0,0 +1,141 @@
+// First-page latency of limit-bound profiler queries over a synthetic Python CPU capture. The ordering part is timed
+// both ways, ordering every filtered row and selecting only the page, and the two pages must be identical. Then a
+// service over two persisted captures times a cold first page, the first cursor page and a cold compare.
+// Usage: query_topk_bench [rows] [limit]
+#include <performance/profile_store.hpp>
+#include <performance/profiler_service_factory.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using namespace mcdk::performance;
+
+    double millisecondsSince(Clock::time_point begin) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    // Functions spread over a few thousand modules with heavily repeated timings, so ties are common and the stable
+    // tiebreak matters. The seed shifts timings between the baseline and the candidate capture.
+    nlohmann::json pythonCapture(long long rowCount, long long seed) {
+        auto nodes = nlohmann::json::array();
+        for (long long id = 0; id < rowCount; ++id) {
+            nodes.push_back(nlohmann::json::array({
+                id,
+                "pack/module_" + std::to_string(id % 4093) + ".py",
+                10 + id % 700,
+                "function_" + std::to_string(id),
+                1 + id % 31,
+                1 + id % 31,
+                static_cast<double>((id * 104729 + seed) % 5000) / 1e6,
+                static_cast<double>((id * 7919 + seed * 3) % 20000) / 1e6,
+                1,
+                "Main",
+                "client",
+            }));
+        }
+        return {{"nodes", std::move(nodes)}, {"edges", nlohmann::json::array()}};
+    }
+
+    bool samePage(const std::vector<std::uint32_t>& sorted, const std::vector<std::uint32_t>& top, std::size_t limit) {
+        return top.size() == std::min(limit, sorted.size()) && std::equal(top.begin(), top.end(), sorted.begin());
+    }
+
+    void writeJob(const std::filesystem::path& profiles, const std::string& id, const std::vector<std::byte>& image) {
+        const auto directory = profiles / id;
+        std::filesystem::create_directories(directory);
+        const nlohmann::json manifest{
+            {"schema", 2}, {"job_id", id}, {"kind", "python.cpu"}, {"state", "completed"}, {"partial", false},
+            {"created_at", "2026-01-01T00:00:00Z"}, {"completed_at", "2026-01-01T00:00:01Z"},
+            {"artifacts", nlohmann::json::array({"data.mcprof", "summary.json"})},
+        };
+        std::ofstream(directory / "manifest.json", std::ios::binary) << manifest.dump();
+        std::ofstream(directory / "summary.json", std::ios::binary) << nlohmann::json::object().dump();
+        std::ofstream(directory / "data.mcprof", std::ios::binary)
+            .write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long long   rowCount = argc > 1 ? std::atoll(argv[1]) : 1'000'000;
+    const std::size_t limit    = argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 20;
+
+    const auto baseline  = encodeProfile(ProfilerKind::PythonCpu, pythonCapture(rowCount, 0));
+    const auto candidate = encodeProfile(ProfilerKind::PythonCpu, pythonCapture(rowCount, 17));
+    const auto store     = openProfileStore(std::make_shared<const ProfileImage>(baseline));
+    const auto* view     = store ? (*store)->view("hotspots") : nullptr;
+    if (!view) {
+        std::cerr << "The synthetic capture did not open\n";
+        return 1;
+    }
+    std::printf("%lld rows, first page of %zu\n", rowCount, limit);
+
+    bool identical = true;
+    for (const auto field : {"total_time", "calls", "name"}) {
+        const auto rows = filterRows(**store, *view, "");
+        auto       sorted = rows;
+        auto       begin  = Clock::now();
+        sortRows(**store, *view, sorted, field, true);
+        const double sortMs = millisecondsSince(begin);
+        auto         top    = rows;
+        begin               = Clock::now();
+        selectTopRows(**store, *view, top, field, true, limit);
+        const double topMs = millisecondsSince(begin);
+        identical &= samePage(sorted, top, limit);
+        std::printf("%-12s full sort %9.2f ms  top-k %8.2f ms  speedup %6.1fx\n", field, sortMs, topMs, sortMs / topMs);
+    }
+
+    const auto root = std::filesystem::temp_directory_path()
+                    / ("mcdev-query-topk-bench-" + std::to_string(Clock::now().time_since_epoch().count()));
+    writeJob(root / "profiles", "baseline", baseline);
+    writeJob(root / "profiles", "candidate", candidate);
+    {
+        auto service = createProfilerService({
+            .executeCode          = {},
+            .currentGameProcessId = [] { return std::uint32_t{0}; },
+            .storageRoot          = root / "profiles",
+            .executableDirectory  = root,
+        });
+        if (!service) {
+            std::cerr << "The profiler service did not start: " << service.error().message << '\n';
+            return 1;
+        }
+        // Loading maps the images; it is not part of a query.
+        (void)(*service)->status("baseline");
+        (void)(*service)->status("candidate");
+
+        auto       begin = Clock::now();
+        const auto first = (*service)->query(QueryRequest{.jobId = "baseline", .view = "hotspots", .limit = limit});
+        std::printf("service first page      %9.2f ms\n", millisecondsSince(begin));
+        if (first && first->nextCursor) {
+            begin = Clock::now();
+            const auto next = (*service)->query(QueryRequest{
+                .jobId = "baseline", .view = "hotspots", .limit = limit, .cursor = first->nextCursor,
+            });
+            std::printf("service first cursor    %9.2f ms\n", millisecondsSince(begin));
+            identical &= next.has_value();
+        }
+        begin = Clock::now();
+        const auto compared = (*service)->compare(CompareRequest{
+            .baselineJobId = "baseline", .candidateJobId = "candidate", .view = "hotspots", .limit = limit,
+        });
+        std::printf("service compare         %9.2f ms\n", millisecondsSince(begin));
+        identical &= first.has_value() && compared.has_value();
+    }
+    std::error_code ignored;
+    std::filesystem::remove_all(root, ignored);
+    if (!identical) std::cerr << "Top-k pages differ from the sorted pages\n";
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include <traceback_aggregator.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+static void feedTraceback(mcdk::TracebackAggregator& aggregator, int item, std::int64_t timestampMs) {
+    const std::vector<std::string> lines = {
+        "Traceback (most recent call last):",
+        "  File \"mymod/server/system.py\", line " + std::to_string(40 + item % 3) + ", in OnTick",
+        "    self.spawn(entity)",
+        "  File \"mymod/server/spawn.py\", line 12, in spawn",
+        "    config = CONFIGS[name]",
+        "KeyError: 'item_" + std::to_string(item) + "'",
+    };
+    for (const auto& line : lines) {
+        aggregator.feed(line, timestampMs);
+    }
+}
+
+static bool testParsing() {
+    mcdk::TracebackAggregator aggregator;
+    aggregator.feed("unrelated stderr noise", 1);
+    aggregator.feed("Traceback (most recent call last):", 1);
+    aggregator.feed("  File \"mymod/client/ui.py\", line 7, in Create", 1);
+    aggregator.feed("    return self.root / 0", 1);
+    const auto traceback = aggregator.feed("ZeroDivisionError: integer division or modulo by zero", 1);
+
+    aggregator.feed("Traceback (most recent call last):", 2);
+    aggregator.feed("  File \"mymod/main.py\", line 3", 2);
+    aggregator.feed("    def broken(", 2);
+    aggregator.feed("              ^", 2);
+    const auto syntax = aggregator.feed("SyntaxError: invalid syntax", 2);
+
+    return expect(traceback.has_value(), "traceback is completed by the exception line")
+        && expect(traceback->exceptionType == "ZeroDivisionError", "exception type")
+        && expect(traceback->message == "integer division or modulo by zero", "exception message")
+        && expect(traceback->frames.size() == 1 && traceback->frames[0].file == "mymod/client/ui.py"
+                      && traceback->frames[0].line == 7 && traceback->frames[0].function == "Create"
+                      && traceback->frames[0].source == "return self.root / 0",
+                  "frame fields")
+        && expect(syntax && syntax->exceptionType == "SyntaxError" && syntax->frames.size() == 1
+                      && syntax->frames[0].source == "def broken(",
+                  "syntax error keeps the source line, not the caret")
+        && expect(aggregator.totalCount() == 2, "both tracebacks counted");
+}
+
+static bool testGrouping() {
+    mcdk::TracebackAggregator aggregator(2);
+    for (int tick = 0; tick < 1000; ++tick) {
+        feedTraceback(aggregator, tick, 1000 + tick);
+    }
+    aggregator.feed("Traceback (most recent call last):", 5000);
+    aggregator.feed("  File \"mymod/client/ui.py\", line 7, in Create", 5000);
+    aggregator.feed("AttributeError: 'NoneType' object has no attribute 'root'", 5000);
+
+    const auto recent   = aggregator.groups(mcdk::TracebackAggregator::Order::MostRecent, 10);
+    const auto frequent = aggregator.groups(mcdk::TracebackAggregator::Order::MostFrequent, 1);
+
+    bool passed = expect(recent.size() == 2, "a thousand identical errors become one group")
+               && expect(recent[0].latest.exceptionType == "AttributeError", "most recent group first")
+               && expect(frequent.size() == 1 && frequent[0].count == 1000, "count of the flooding error")
+               && expect(frequent[0].firstSeenMs == 1000 && frequent[0].lastSeenMs == 1999, "first and last seen")
+               && expect(frequent[0].latest.message == "'item_999'", "latest occurrence is kept verbatim")
+               && expect(frequent[0].normalizedMessage == "'?'", "quoted values are masked");
+
+    // A third signature evicts the group that was seen least recently.
+    aggregator.feed("Traceback (most recent call last):", 6000);
+    aggregator.feed("  File \"mymod/common/db.py\", line 88, in load", 6000);
+    aggregator.feed("IOError: [Errno 2] No such file or directory: 'save_12.dat'", 6000);
+    const auto afterEviction = aggregator.groups(mcdk::TracebackAggregator::Order::MostFrequent, 10);
+    passed &= expect(afterEviction.size() == 2 && afterEviction[0].count == 1, "stalest group is evicted")
+           && expect(mcdk::TracebackAggregator::normalizeMessage("id 42 at 0x7ffe12 took 1.5s") == "id # at 0x? took #s",
+                     "numbers and addresses are masked");
+    return passed;
+}
+
+int main() {
+    const bool passed = testParsing() && testGrouping();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include <mcdevtool/reload.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class TempDirectory {
+public:
+    TempDirectory() {
+        const auto suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        path = fs::temp_directory_path() / ("mcdevtool-watch-exclude-" + suffix);
+        fs::create_directories(path);
+    }
+
+    ~TempDirectory() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    fs::path path;
+};
+
+static void touch(const fs::path& path) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path).put('\n');
+}
+
+static bool expect(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "Failed: " << description << '\n';
+    }
+    return condition;
+}
+
+static bool testExcludeFilter() {
+    const MCDevTool::HotReload::WatchExcludeFilter filter({".git", "node_modules/", "*.tmp", "./build/**", "assets/cache"}
+    );
+
+    return expect(filter.isExcluded(".git"), "name glob matches top-level directory")
+        && expect(filter.isExcluded("behavior/.git/objects/ab"), "name glob excludes nested subtree")
+        && expect(filter.isExcluded("node_modules/pkg/index.py"), "trailing slash is ignored")
+        && expect(filter.isExcluded("scripts/a.tmp"), "name glob wildcard matches file name")
+        && expect(filter.isExcluded("build/out/x.py"), "anchored double-star matches across directories")
+        && expect(filter.isExcluded("assets/cache/big.png"), "anchored directory excludes its subtree")
+        && expect(!filter.isExcluded("scripts/build/x.py"), "anchored glob does not match below the root")
+        && expect(!filter.isExcluded("scripts/main.py"), "unrelated path is kept")
+        && expect(!filter.isExcluded("scripts/a.tmpx"), "wildcard must match the whole name")
+        && expect(filter.isExcluded(fs::path("/root/pack"), fs::path("/root/pack/.git/HEAD")), "absolute path overload")
+        && expect(!filter.isExcluded(fs::path("/root/pack"), fs::path("/root/other/.gitx")), "path outside the root")
+        && expect(MCDevTool::HotReload::WatchExcludeFilter().empty(), "default filter is empty");
+}
+
+#ifdef __linux__
+static bool testExcludedDirectoriesAreNotReported() {
+    TempDirectory temp;
+    touch(temp.path / "scripts" / "main.py");
+    touch(temp.path / "node_modules" / "pkg" / "index.py");
+
+    std::mutex            mutex;
+    std::vector<fs::path> changed;
+    std::atomic<bool>     stopFlag = false;
+
+    auto watcher = MCDevTool::HotReload::watchAndReloadFiles(
+        std::vector<fs::path>{temp.path},
+        [&](const fs::path& path) {
+            std::lock_guard lock(mutex);
+            changed.push_back(path);
+        },
+        [](const fs::path& path) { return path.extension() == ".py"; },
+        MCDevTool::HotReload::WatchOptions{.excludeGlobs = {"node_modules"}},
+        &stopFlag
+    );
+    if (!expect(watcher.has_value(), "watcher starts")) {
+        return false;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    touch(temp.path / "node_modules" / "pkg" / "index.py");
+    touch(temp.path / "scripts" / "main.py");
+    touch(temp.path / "scripts" / "added" / "late.py");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+
+    stopFlag = true;
+    watcher->join();
+
+    bool sawMain = false, sawLate = false, sawExcluded = false;
+    for (const auto& path : changed) {
+        sawMain     = sawMain || path.filename() == "main.py";
+        sawLate     = sawLate || path.filename() == "late.py";
+        sawExcluded = sawExcluded || path.filename() == "index.py";
+    }
+    return expect(sawMain, "modified file is reported") && expect(sawLate, "file in a new directory is reported")
+        && expect(!sawExcluded, "file in an excluded directory is not reported");
+}
+
+// A directory renamed inside the tree is reported under its new path; one moved out of the tree is no longer watched.
+static bool testMovedDirectoriesFollowTheirPath() {
+    TempDirectory temp;
+    TempDirectory outside;
+    touch(temp.path / "scripts" / "old" / "a.py");
+    touch(temp.path / "scripts" / "gone" / "b.py");
+
+    std::mutex            mutex;
+    std::vector<fs::path> changed;
+    std::atomic<bool>     stopFlag = false;
+
+    auto watcher = MCDevTool::HotReload::watchAndReloadFiles(
+        std::vector<fs::path>{temp.path},
+        [&](const fs::path& path) {
+            std::lock_guard lock(mutex);
+            changed.push_back(path);
+        },
+        [](const fs::path& path) { return path.extension() == ".py"; },
+        MCDevTool::HotReload::WatchOptions{},
+        &stopFlag
+    );
+    if (!expect(watcher.has_value(), "watcher starts")) {
+        return false;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    fs::rename(temp.path / "scripts" / "old", temp.path / "scripts" / "new");
+    fs::rename(temp.path / "scripts" / "gone", outside.path / "gone");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    {
+        std::lock_guard lock(mutex);
+        changed.clear();
+    }
+    touch(temp.path / "scripts" / "new" / "a.py");
+    touch(outside.path / "gone" / "b.py");
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+
+    stopFlag = true;
+    watcher->join();
+
+    bool sawNew = false, sawStale = false;
+    for (const auto& path : changed) {
+        sawNew   = sawNew || path == temp.path / "scripts" / "new" / "a.py";
+        sawStale = sawStale || path.filename() == "b.py" || path.parent_path().filename() == "old";
+    }
+    return expect(sawNew, "file in a renamed directory is reported under its new path")
+        && expect(!sawStale, "directory moved out of the tree is no longer reported");
+}
+
+// Changes lost with an overflowed notification queue are found by rescanning the root. A modification time set
+// without writing raises no write notification, so only the rescan can report it.
+static bool testOverflowRescansTheRoot() {
+    TempDirectory temp;
+    touch(temp.path / "scripts" / "missed.py");
+
+    std::mutex            mutex;
+    std::vector<fs::path> changed;
+    std::atomic<bool>     stopFlag = false;
+    std::atomic<bool>     overflow = false;
+
+    auto watcher = MCDevTool::HotReload::watchAndReloadFiles(
+        std::vector<fs::path>{temp.path},
+        [&](const fs::path& path) {
+            std::lock_guard lock(mutex);
+            changed.push_back(path);
+        },
+        [](const fs::path& path) { return path.extension() == ".py"; },
+        MCDevTool::HotReload::WatchOptions{.overflowProbe = [&](const fs::path&) { return overflow.exchange(false); }},
+        &stopFlag
+    );
+    if (!expect(watcher.has_value(), "watcher starts")) {
+        return false;
+    }
+
+    const auto reported = [&](const char* name) {
+        std::lock_guard lock(mutex);
+        return std::any_of(changed.begin(), changed.end(), [&](const fs::path& path) { return path.filename() == name; });
+    };
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const auto missed = temp.path / "scripts" / "missed.py";
+    fs::last_write_time(missed, fs::last_write_time(missed) + std::chrono::hours(1));
+    touch(temp.path / "scripts" / "first.py");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const bool missedBeforeOverflow = reported("missed.py");
+
+    overflow = true;
+    touch(temp.path / "scripts" / "second.py");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    stopFlag = true;
+    watcher->join();
+
+    return expect(reported("first.py") && !missedBeforeOverflow, "a timestamp change alone raises no notification")
+        && expect(reported("missed.py"), "an overflowed queue rescans the root and reports what it missed");
+}
+#endif
+
+int main() {
+    bool passed = testExcludeFilter();
+#ifdef __linux__
+    passed = testExcludedDirectoriesAreNotReported() && passed;
+    passed = testMovedDirectoriesFollowTheirPath() && passed;
+    passed = testOverflowRescansTheRoot() && passed;
+#endif
+    return passed ? 0 : 1;
+}
@@ -1,12 +1,12 @@
 #pragma once
 
-#include <string>
+#include <string_view>
 
 #include "console.hpp"
 
 namespace mcdk {
 
-    void printColoredAtomic(const std::string& message, ConsoleColor color);
+    void printColoredAtomic(std::string_view message, ConsoleColor color);
     void printStartupLogo(bool pluginEnvironment);
 
 } // namespace mcdk
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "console.hpp"
+
+namespace mcdk {
+
+    struct ConsoleWriterOptions {
+        // Lines waiting for the terminal beyond either budget are dropped and reported as one summary line. Red and
+        // yellow lines get twice the budget, so a flood of plain output cannot crowd out errors.
+        std::size_t maxQueuedLines = 16384;
+        std::size_t maxQueuedBytes = 4 * 1024 * 1024;
+    };
+
+    struct ConsoleWriterStats {
+        std::uint64_t written = 0; // Lines handed to the sink.
+        std::uint64_t dropped = 0; // Lines discarded by the overflow policy.
+        std::uint64_t runs    = 0; // Sink calls; each one carries a run of consecutive same-color lines.
+    };
+
+    // Moves console output off the threads that produce it. Producers push onto a lock-free MPSC stack and return
+    // immediately; a dedicated writer thread takes everything queued in one exchange, restores arrival order and
+    // hands each run of same-color lines to the sink as a single newline-terminated block.
+    class ConsoleWriter {
+    public:
+        using Sink = std::function<void(ConsoleColor color, std::string_view text)>;
+
+        explicit ConsoleWriter(Sink sink, ConsoleWriterOptions options = {});
+        // Writes everything still queued, then stops the writer thread.
+        ~ConsoleWriter();
+
+        ConsoleWriter(const ConsoleWriter&)            = delete;
+        ConsoleWriter& operator=(const ConsoleWriter&) = delete;
+
+        // Never blocks on the terminal. After shutdown the line is written synchronously instead.
+        void write(std::string line, ConsoleColor color);
+        // Waits until every line queued before the call has reached the sink.
+        void flush();
+
+        [[nodiscard]] ConsoleWriterStats stats() const;
+
+    private:
+        struct Node {
+            Node*        next = nullptr;
+            std::string  text;
+            ConsoleColor color = ConsoleColor::Default;
+        };
+
+        void run();
+        void drain(Node* newestFirst);
+        void emit(ConsoleColor color, std::string_view text);
+
+        Sink                       mSink;
+        ConsoleWriterOptions       mOptions;
+        std::atomic<Node*>         mHead{nullptr};
+        std::atomic<std::size_t>   mQueuedLines{0};
+        std::atomic<std::size_t>   mQueuedBytes{0};
+        std::atomic<std::uint64_t> mAccepted{0};
+        std::atomic<std::uint64_t> mWritten{0};
+        std::atomic<std::uint64_t> mDropped{0};
+        std::atomic<std::uint64_t> mRuns{0};
+        std::atomic<std::uint32_t> mWakeups{0};
+        std::atomic<bool>          mStopping{false};
+        std::atomic<bool>          mStopped{false};
+        std::uint64_t              mReported = 0; // Drops already announced by a summary line; writer thread only.
+        std::mutex                 mSinkMutex;    // Only contended by synchronous writes after shutdown.
+        std::thread                mThread;
+    };
+
+    // Process-wide writer feeding stdout, with colors set through the console API on Windows and ANSI escapes
+    // elsewhere.
+    [[nodiscard]] ConsoleWriter& consoleWriter();
+
+} // namespace mcdk
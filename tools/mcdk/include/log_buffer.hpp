@@ -1,31 +1,111 @@
 #pragma once
 
 #include <cstddef>
-#include <deque>
+#include <cstdint>
+#include <expected>
+#include <memory>
 #include <mutex>
-#include <string>
+#include <string_view>
 #include <vector>
 
+#include <log_search.hpp>
+
 namespace mcdk {
 
+    class LogSpool;
+
+    // A read result: every line is copied into one contiguous block and `lines` views into it.
+    // Returned lines always have consecutive sequence numbers starting at firstSequence (oldest line).
+    struct LogLines {
+        std::unique_ptr<char[]>       text;
+        std::vector<std::string_view> lines;
+        std::uint64_t                 firstSequence = 0;
+        bool                          reversed      = false;
+
+        [[nodiscard]] std::size_t size() const { return lines.size(); }
+        [[nodiscard]] bool        empty() const { return lines.empty(); }
+
+        [[nodiscard]] std::uint64_t sequenceAt(std::size_t index) const {
+            return firstSequence + (reversed ? lines.size() - 1 - index : index);
+        }
+    };
+
+    struct LogSinceResult {
+        LogLines      lines;
+        std::uint64_t nextCursor = 0;     // Pass back as the cursor of the next call.
+        std::uint64_t dropped    = 0;     // Lines after the cursor that were evicted before this read.
+        bool          hasMore    = false; // maxCount was reached; more lines are already available.
+    };
+
     class LogBuffer {
     public:
         explicit LogBuffer(std::size_t capacity = 1000, std::size_t clearBatchSize = 250);
 
-        void add(std::string line);
+        void add(std::string_view line);
         void clear();
 
-        [[nodiscard]] std::vector<std::string> getLatest(std::size_t maxCount);
-        [[nodiscard]] std::vector<std::string> getLatestReversed(std::size_t maxCount);
-        [[nodiscard]] std::vector<std::string> getRange(std::size_t index, std::size_t endIndex);
-        [[nodiscard]] std::vector<std::string> getRangeReversed(std::size_t index, std::size_t endIndex);
+        [[nodiscard]] std::size_t size() const;
+
+        // Every added line gets the next 64-bit sequence number, starting at 1 and kept across clear().
+        [[nodiscard]] std::uint64_t latestSequence() const;
+
+        // Ranges are tail-relative: index 0 is the newest line.
+        [[nodiscard]] LogLines getLatest(std::size_t maxCount) const;
+        [[nodiscard]] LogLines getLatestReversed(std::size_t maxCount) const;
+        [[nodiscard]] LogLines getRange(std::size_t index, std::size_t endIndex) const;
+        [[nodiscard]] LogLines getRangeReversed(std::size_t index, std::size_t endIndex) const;
+
+        // Returns up to maxCount lines with a sequence greater than cursor, oldest first; cursor 0 starts from the
+        // oldest retained line. Cost is proportional to the number of returned lines. With a spool attached, lines
+        // that were already evicted from memory are read back from disk instead of being reported as dropped.
+        [[nodiscard]] LogSinceResult getSince(std::uint64_t cursor, std::size_t maxCount) const;
+
+        // Builds a trigram index over the retained lines and keeps it up to date on every add(), so search() only
+        // verifies candidate lines instead of the whole buffer. Costs one posting entry per distinct trigram per line.
+        void enableSearchIndex();
+
+        // Mirrors every subsequently added line into spool, keyed by its sequence number.
+        void attachSpool(std::shared_ptr<LogSpool> spool);
+
+        // Returns the newest query.maxMatches matching lines (plus context), oldest first. Fails on an invalid regex.
+        [[nodiscard]] std::expected<LogSearchResult, std::string> search(const LogSearchQuery& query) const;
 
     private:
-        // A deque keeps batched front eviction O(k) without moving every retained log line.
-        std::deque<std::string>  mBuffer;
-        std::size_t              mCapacity;
-        std::size_t              mClearBatchSize;
-        std::mutex               mMutex;
+        struct LineRecord {
+            std::uint32_t chunk       = 0;
+            std::uint32_t offset      = 0;
+            std::uint32_t length      = 0;
+            std::int64_t  timestampMs = 0; // Wall clock, milliseconds since the Unix epoch.
+        };
+
+        struct Chunk {
+            std::unique_ptr<char[]> data;
+            std::uint32_t           capacity  = 0;
+            std::uint32_t           used      = 0;
+            std::uint32_t           liveLines = 0;
+        };
+
+        [[nodiscard]] std::uint32_t     acquireChunk(std::uint32_t length);
+        void                            releaseChunk(std::uint32_t chunk);
+        void                            evictOldest(std::size_t count);
+        [[nodiscard]] LogLines          copyLines(std::size_t first, std::size_t count, bool reversed) const;
+        [[nodiscard]] const LineRecord& recordAt(std::uint64_t sequence) const;
+        [[nodiscard]] std::string_view  lineAt(const LineRecord& record) const;
+
+        // Lines live in a fixed ring of records that point into pooled byte chunks; a chunk returns to the pool
+        // once every line stored in it has been evicted, so steady-state logging does not touch the allocator.
+        std::vector<LineRecord>          mRing;
+        std::size_t                      mHead         = 0;
+        std::size_t                      mSize         = 0;
+        std::uint64_t                    mNextSequence = 1;
+        std::vector<Chunk>               mChunks;
+        std::vector<std::uint32_t>       mFreeChunks;
+        std::uint32_t                    mActiveChunk;
+        std::size_t                      mCapacity;
+        std::size_t                      mClearBatchSize;
+        std::unique_ptr<LogTrigramIndex> mIndex;
+        std::shared_ptr<LogSpool>        mSpool;
+        mutable std::mutex               mMutex;
     };
 
 } // namespace mcdk
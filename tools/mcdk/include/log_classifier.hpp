@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mcdk {
+
+    // Console category of a game stdout line, in the precedence the console uses when several markers appear.
+    enum class LogLineKind : std::uint8_t {
+        EngineNoise, // " [INFO][Engine] " lines, hidden from the console.
+        Developer,   // "[INFO][Developer]"
+        Success,     // "SUC", any case
+        Error,       // "ERROR", any case
+        Warning,     // "WARN", any case
+        Debug,       // "DEBUG", any case
+        Plain,
+    };
+
+    // Matches every stdout marker in a single pass over the line with an Aho-Corasick automaton compiled into a dense
+    // transition table over ASCII-case-folded bytes. Case-sensitive markers are confirmed in place when the folded
+    // automaton reports them.
+    class LogLineClassifier {
+    public:
+        LogLineClassifier();
+
+        // Bit `1 << LogLineKind` is set for every marker present in the line.
+        [[nodiscard]] std::uint32_t scan(std::string_view line) const;
+        [[nodiscard]] LogLineKind   classify(std::string_view line) const;
+
+    private:
+        struct Pattern {
+            std::string_view text;
+            LogLineKind      kind;
+            bool             caseSensitive;
+        };
+
+        static constexpr std::size_t PATTERN_COUNT = 6;
+
+        std::array<Pattern, PATTERN_COUNT> mPatterns;
+        std::vector<std::uint32_t>         mTable;   // [row + byte] -> next row; high bit set if it ends a pattern
+        std::vector<std::uint8_t>          mOutputs; // [state] -> bit per pattern index ending here
+    };
+
+    // Shared immutable instance; construction happens once on first use.
+    [[nodiscard]] const LogLineClassifier& logLineClassifier();
+
+    // Rewrites `File "pkg.module", line N` traceback locations to `File "pkg/module.py", line N`.
+    [[nodiscard]] std::string rewriteTracebackFileNames(std::string_view line);
+
+} // namespace mcdk
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mcdk {
+
+    struct LogCollapseOptions {
+        bool         maskNumbers       = true; // Lines that differ only in their numbers count as repeats too.
+        std::int64_t summaryIntervalMs = 1000; // A run that keeps going is reported at least this often.
+        std::int64_t idleFlushMs       = 250;  // flushIdle() reports a run once no repeat arrived for this long.
+    };
+
+    // Collapses runs of consecutive repeated lines. The first line of a run passes through; the repeats are held back
+    // and reported as one summary line: the newest repeat followed by " [repeated N times in T s]", or
+    // " [N similar lines in T s]" when only their numbers matched. A single held-back repeat is released verbatim.
+    class LogFloodCollapser {
+    public:
+        struct Output {
+            std::optional<std::string> summary;         // Report for the repeats held so far; emit it first.
+            bool                       emitLine = true; // False when the fed line was absorbed into the current run.
+        };
+
+        explicit LogFloodCollapser(LogCollapseOptions options = {});
+
+        Output feed(std::string_view line);
+        Output feed(std::string_view line, std::int64_t timestampMs);
+
+        // Reports held repeats once the run has been quiet for idleFlushMs; the run itself stays open.
+        [[nodiscard]] std::optional<std::string> flushIdle(std::int64_t nowMs);
+        // As above, but hands the report to emit before feed() can run again, so a line fed concurrently is printed
+        // after the summary of the repeats that came before it. emit must not feed this collapser.
+        bool flushIdle(std::int64_t nowMs, const std::function<void(std::string_view summary)>& emit);
+        // Reports held repeats unconditionally, e.g. when the stream ends.
+        [[nodiscard]] std::optional<std::string> flush();
+
+        // Total number of lines absorbed into runs.
+        [[nodiscard]] std::uint64_t collapsedCount() const;
+
+        // The line with every run of digits (including a decimal point inside it) replaced by '#'.
+        [[nodiscard]] static std::string templateOf(std::string_view line);
+
+    private:
+        std::optional<std::string> takeSummary();
+
+        LogCollapseOptions mOptions;
+        std::string        mKey;     // Template (or verbatim text) shared by the current run.
+        std::string        mFirst;   // The line that opened the run.
+        std::string        mLast;    // Newest held-back repeat.
+        std::string        mScratch; // Template of the line being fed, reused to avoid an allocation per line.
+        bool               mHasRun         = false;
+        bool               mVaried         = false; // Some held-back repeat is not identical to mFirst.
+        std::uint64_t      mHeld           = 0;
+        std::int64_t       mHeldSinceMs    = 0;
+        std::int64_t       mLastSeenMs     = 0;
+        std::uint64_t      mCollapsedTotal = 0;
+        mutable std::mutex mMutex;
+    };
+
+} // namespace mcdk
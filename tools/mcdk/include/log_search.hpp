@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mcdk {
+
+    enum class LogLevel : std::uint8_t {
+        Debug,
+        Info,
+        Warning,
+        Error,
+    };
+
+    // Same keyword precedence the console colouring uses: ERROR, then WARN, then DEBUG; everything else is Info.
+    [[nodiscard]] LogLevel                detectLogLevel(std::string_view line);
+    [[nodiscard]] std::optional<LogLevel> parseLogLevel(std::string_view name);
+    // Lowercase names as MCP logging uses them: "debug", "info", "warning", "error".
+    [[nodiscard]] std::string_view        logLevelName(LogLevel level);
+
+    [[nodiscard]] constexpr std::uint32_t logLevelBit(LogLevel level) {
+        return std::uint32_t{1} << static_cast<std::uint32_t>(level);
+    }
+
+    struct LogSearchQuery {
+        enum class Mode : std::uint8_t {
+            Substring,
+            Regex,
+        };
+
+        std::string                 pattern;
+        Mode                        mode         = Mode::Substring;
+        bool                        ignoreCase   = false;
+        std::uint32_t               levelMask    = 0; // logLevelBit() flags; 0 accepts every level.
+        std::optional<std::int64_t> sinceMs;          // Inclusive bounds, milliseconds since the Unix epoch.
+        std::optional<std::int64_t> untilMs;
+        std::size_t                 contextLines = 0;
+        std::size_t                 maxMatches   = 100;
+    };
+
+    struct LogSearchLine {
+        std::uint64_t sequence    = 0;
+        std::int64_t  timestampMs = 0;
+        std::string   text;
+        bool          match = false; // false for context lines.
+    };
+
+    struct LogSearchResult {
+        std::vector<LogSearchLine> lines;        // Oldest first; context windows of adjacent matches are merged.
+        std::size_t                matchCount   = 0;
+        std::size_t                scannedLines = 0;     // Lines that were actually verified against the pattern.
+        bool                       truncated    = false; // Older matches may exist beyond maxMatches.
+        bool                       indexed      = false; // Candidates came from the trigram index.
+    };
+
+    // A compiled query pattern plus the literals every matching line must contain, used to prefilter candidates.
+    class LogMatcher {
+    public:
+        [[nodiscard]] static std::expected<LogMatcher, std::string> compile(const LogSearchQuery& query);
+
+        [[nodiscard]] bool matches(std::string_view line) const;
+
+        // ASCII-lowercased literals; empty when the pattern offers nothing to prefilter on (e.g. a top-level '|').
+        [[nodiscard]] const std::vector<std::string>& requiredLiterals() const { return mLiterals; }
+
+    private:
+        LogMatcher() = default;
+
+        std::string               mPattern;
+        std::optional<std::regex> mRegex;
+        bool                      mIgnoreCase = false;
+        std::vector<std::string>  mLiterals;
+    };
+
+    // Maps every ASCII-case-folded byte trigram to the ascending sequence numbers of the lines containing it.
+    // Lines must be added in sequence order; evicted sequences are trimmed lazily in batches.
+    class LogTrigramIndex {
+    public:
+        void add(std::uint64_t sequence, std::string_view line);
+        void evictBefore(std::uint64_t oldestSequence, std::size_t liveLines);
+        void clear();
+
+        // Ascending candidate sequences that contain every trigram of every literal. std::nullopt means the literals
+        // are too short to constrain the search and every line has to be scanned.
+        [[nodiscard]] std::optional<std::vector<std::uint64_t>> candidates(const std::vector<std::string>& literals)
+            const;
+
+    private:
+        void compact();
+
+        std::unordered_map<std::uint32_t, std::vector<std::uint64_t>> mPostings;
+        std::vector<std::uint32_t>                                    mScratch;
+        std::uint64_t                                                 mOldestSequence      = 0;
+        std::size_t                                                   mEvictedSinceCompact = 0;
+    };
+
+} // namespace mcdk
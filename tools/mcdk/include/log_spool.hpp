@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <log_buffer.hpp>
+
+namespace mcdk {
+
+    struct LogSpoolOptions {
+        std::uint64_t maxSegmentBytes = 8 * 1024 * 1024; // Rotate once the active segment would grow past this.
+        std::size_t   maxSegments     = 32;              // Oldest segments are deleted beyond this count.
+    };
+
+    // What createSession() keeps of earlier runs: at most keepSessions session directories, including the new one,
+    // and as many of the newest earlier sessions as fit in maxBytes together. The running session is bounded by the
+    // segment limits of its spools, so the spool root never holds much more than maxBytes plus one session.
+    struct LogRetention {
+        std::size_t   keepSessions = 10;
+        std::uint64_t maxBytes     = 512 * 1024 * 1024;
+    };
+
+    // Append-only on-disk copy of a session's log lines.
+    //
+    // Lines are written to numbered segment files (`segment-000001.log`, one '\n'-terminated line per entry) next to
+    // a sidecar index (`segment-000001.idx`: 8-byte magic, the first sequence number, then one uint32 end offset per
+    // line). Reads map both files and copy out only the requested lines, so the whole session stays queryable without
+    // being held in memory.
+    class LogSpool {
+    public:
+        ~LogSpool();
+
+        LogSpool(const LogSpool&)            = delete;
+        LogSpool& operator=(const LogSpool&) = delete;
+
+        [[nodiscard]] static std::expected<std::shared_ptr<LogSpool>, std::string>
+        open(const std::filesystem::path& directory, LogSpoolOptions options = {});
+
+        // Opens a fresh timestamped session directory below root after pruning the session directories left behind
+        // by earlier runs down to retention.
+        [[nodiscard]] static std::expected<std::shared_ptr<LogSpool>, std::string>
+        createSession(const std::filesystem::path& root, LogRetention retention = {}, LogSpoolOptions options = {});
+
+        // Bytes of every file below directory, e.g. what the spool root currently holds on disk.
+        [[nodiscard]] static std::uint64_t diskUsage(const std::filesystem::path& directory);
+
+        // Sequence numbers must increase; a gap (lines that were never spooled) starts a new segment.
+        void append(std::uint64_t sequence, std::string_view line);
+        // For a spool that is not mirroring a LogBuffer: appends with the sequence after latestSequence().
+        std::uint64_t append(std::string_view line);
+
+        // Both return 0 while the spool is empty.
+        [[nodiscard]] std::uint64_t oldestSequence() const;
+        [[nodiscard]] std::uint64_t latestSequence() const;
+
+        // Up to maxCount consecutive lines starting at firstSequence, oldest first. Stops early at a gap or when the
+        // requested sequence is no longer on disk.
+        [[nodiscard]] LogLines read(std::uint64_t firstSequence, std::size_t maxCount) const;
+
+        [[nodiscard]] const std::filesystem::path& directory() const { return mDirectory; }
+
+    private:
+        struct Segment {
+            std::uint32_t number        = 0;
+            std::uint64_t firstSequence = 0;
+            std::uint64_t lineCount     = 0;
+            std::uint64_t bytes         = 0;
+        };
+
+        LogSpool(std::filesystem::path directory, LogSpoolOptions options);
+
+        [[nodiscard]] std::filesystem::path segmentPath(std::uint32_t number, const char* extension) const;
+        void                                startSegment(std::uint64_t firstSequence);
+        void                                closeSegment();
+        void                                appendLocked(std::uint64_t sequence, std::string_view line);
+        [[nodiscard]] std::uint64_t         latestSequenceLocked() const;
+
+        std::filesystem::path mDirectory;
+        LogSpoolOptions       mOptions;
+        std::deque<Segment>   mSegments; // Oldest first; the back one is active while mText is open.
+        mutable std::ofstream mText; // Flushed lazily, right before a read maps the active segment.
+        mutable std::ofstream mIndex;
+        bool                  mFailed = false;
+        mutable std::mutex    mMutex;
+    };
+
+} // namespace mcdk
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <log_search.hpp>
+
+namespace mcdk {
+
+    class LogBuffer;
+
+    struct LogStreamOptions {
+        std::chrono::milliseconds interval{200};   // Delivery period; a session gets at most one publish per round.
+        std::size_t               maxLinesPerBatch = 200;  // Per subscription and round; the rest waits a round.
+        std::size_t               maxBacklog       = 2000; // A subscription further behind skips to the newest lines.
+        std::size_t               maxPerSession    = 8;
+        std::size_t               maxSubscriptions = 64;
+    };
+
+    struct LogStreamLine {
+        std::uint64_t sequence = 0;
+        LogLevel      level    = LogLevel::Info;
+        std::string   text;
+    };
+
+    struct LogStreamBatch {
+        std::string                subscriptionId;
+        std::vector<LogStreamLine> lines;
+        std::uint64_t              skipped = 0; // Lines never examined: evicted before delivery or skipped by backlog.
+        std::uint64_t              cursor  = 0; // Sequence of the last line examined; resumable via get_logs_since.
+    };
+
+    // Delivers new LogBuffer lines to subscribers without them polling. A pump thread follows each subscription's
+    // cursor with LogBuffer::getSince, filters the lines and hands every session one publish call per round carrying
+    // all of its batches. Producers are never slowed down: a subscriber that cannot keep up is rate-limited to
+    // maxLinesPerBatch per round and, once maxBacklog behind, skips ahead with the gap reported in `skipped`.
+    class LogStreamHub {
+    public:
+        // Returns false when the session is gone; its subscriptions are then dropped.
+        using Publisher = std::function<bool(const std::string& sessionId, const std::vector<LogStreamBatch>& batches)>;
+
+        explicit LogStreamHub(Publisher publisher, LogStreamOptions options = {});
+        ~LogStreamHub();
+
+        LogStreamHub(const LogStreamHub&)            = delete;
+        LogStreamHub& operator=(const LogStreamHub&) = delete;
+
+        // Starts after `cursor` (0 means from the newest line on). query.pattern, mode, ignoreCase and levelMask
+        // apply; the rest of the query is ignored. Returns the subscription id.
+        [[nodiscard]] std::expected<std::string, std::string> subscribe(
+            const std::string&         sessionId,
+            std::shared_ptr<LogBuffer> buffer,
+            const LogSearchQuery&      query,
+            std::uint64_t              cursor = 0
+        );
+        bool unsubscribe(const std::string& sessionId, const std::string& subscriptionId);
+
+        [[nodiscard]] std::size_t subscriptionCount() const;
+
+        // Runs the pump thread; without it, pump() delivers one round on the caller's thread.
+        void start();
+        void stop();
+        void pump();
+
+    private:
+        struct Subscription {
+            std::string                id;
+            std::string                sessionId;
+            std::shared_ptr<LogBuffer> buffer;
+            LogMatcher                 matcher;
+            std::uint32_t              levelMask = 0;
+            std::uint64_t              cursor    = 0;
+        };
+
+        [[nodiscard]] LogStreamBatch collect(Subscription& subscription) const;
+
+        Publisher                                  mPublisher;
+        LogStreamOptions                           mOptions;
+        std::vector<std::shared_ptr<Subscription>> mSubscriptions; // Creation order.
+        std::uint64_t                              mNextId   = 1;
+        bool                                       mStopping = false;
+        mutable std::mutex                         mMutex;
+        std::mutex                                 mPumpMutex; // Serializes rounds; cursors only move inside one.
+        std::condition_variable                    mWake;
+        std::thread                                mThread;
+    };
+
+} // namespace mcdk
@@ -11,6 +11,7 @@
 namespace mcdk {
 
     class LogBuffer;
+    class TracebackAggregator;
 
     class MCPServer {
     public:
@@ -31,6 +32,7 @@ namespace mcdk {
 
         void setLogBuffer(std::shared_ptr<LogBuffer> buffer);
         void setErrBuffer(std::shared_ptr<LogBuffer> buffer);
+        void setTracebackAggregator(std::shared_ptr<TracebackAggregator> aggregator);
         void setCodeExecuteHandler(CodeExecuteHandler handler);
         void setProfilerHandler(ProfilerHandler handler);
         void setReloadGameHandler(BoolParamHandler handler);
@@ -6,9 +6,17 @@
 
 namespace mcdk::mcp_tool_definitions {
 
+    // Clients that relay the server's SSE stream (mcdk_stdio_bridge) start following it after this call succeeds.
+    inline constexpr auto SubscribeLogsName = "subscribe_logs";
+
     [[nodiscard]] mcp::tool              buildGetLatestLogsTool();
     [[nodiscard]] mcp::tool              buildGetLogRangeTool();
     [[nodiscard]] mcp::tool              buildGetLatestErrorLogsTool();
+    [[nodiscard]] mcp::tool              buildGetLogsSinceTool();
+    [[nodiscard]] mcp::tool              buildSearchLogsTool();
+    [[nodiscard]] mcp::tool              buildSubscribeLogsTool();
+    [[nodiscard]] mcp::tool              buildUnsubscribeLogsTool();
+    [[nodiscard]] mcp::tool              buildGetErrorGroupsTool();
     [[nodiscard]] mcp::tool              buildExecuteCodeTool();
     [[nodiscard]] mcp::tool              buildReloadGameTool();
     [[nodiscard]] mcp::tool              buildCaptureGameWindowTool();
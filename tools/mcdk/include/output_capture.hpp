@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace mcdk {
+
+#ifdef _WIN32
+    using CaptureHandle = void*; // HANDLE of the pipe's read end.
+#else
+    using CaptureHandle = int; // File descriptor of the pipe's read end.
+#endif
+
+    // Lines are handed out as views that stay valid only for the duration of the callback.
+    using CaptureLineHandler = std::function<void(std::string_view line)>;
+
+    struct OutputCaptureOptions {
+        std::size_t readSize     = 64 * 1024; // Bytes requested per read; large reads keep the child's pipe empty.
+        std::size_t maxLineBytes = 1 << 20;   // A longer line is split rather than buffered without bound.
+        bool        filterPython = false;     // Keep only lines containing "[Python] ".
+    };
+
+    // Splits a byte stream into lines without allocating per line: complete lines are passed straight out of the
+    // caller's read buffer and only a trailing partial line is copied into a reused buffer. A trailing '\r' is
+    // dropped from every line.
+    class LineSplitter {
+    public:
+        explicit LineSplitter(OutputCaptureOptions options = {});
+
+        void append(std::string_view data, const CaptureLineHandler& onLine);
+        // Delivers an unterminated last line, e.g. once the writer has closed the pipe.
+        void finish(const CaptureLineHandler& onLine);
+
+    private:
+        void emit(std::string_view line, const CaptureLineHandler& onLine) const;
+
+        OutputCaptureOptions mOptions;
+        std::string          mPending;
+    };
+
+    struct OutputCaptureStats {
+        std::uint64_t bytes = 0;
+        std::uint64_t lines = 0; // Lines handed to a callback, i.e. after filtering.
+        std::uint64_t reads = 0;
+    };
+
+    // Drains a child's stdout and stderr pipes until both writers close, splitting them into lines. Windows reads each
+    // pipe on its own thread; POSIX polls both from one thread. Callbacks for one stream are never concurrent, but on
+    // Windows the two streams' callbacks may run at the same time.
+    class OutputCapture {
+    public:
+        explicit OutputCapture(OutputCaptureOptions options = {});
+        // Cancels pending reads before joining, so an exceptional exit cannot hang on a live child.
+        ~OutputCapture();
+
+        OutputCapture(const OutputCapture&)            = delete;
+        OutputCapture& operator=(const OutputCapture&) = delete;
+
+        // The handles stay owned by the caller and must outlive join().
+        void start(
+            CaptureHandle      stdoutPipe,
+            CaptureHandle      stderrPipe,
+            CaptureLineHandler onStdout,
+            CaptureLineHandler onStderr
+        );
+        // Returns once both pipes reached end of file.
+        void join();
+
+        [[nodiscard]] OutputCaptureStats stats() const;
+
+    private:
+        struct Stream {
+            CaptureHandle      pipe{};
+            CaptureLineHandler onLine;
+            LineSplitter       splitter;
+        };
+
+        void countRead(std::size_t bytes);
+        void cancel() noexcept;
+
+        OutputCaptureOptions       mOptions;
+        Stream                     mStdout;
+        Stream                     mStderr;
+        std::atomic<std::uint64_t> mBytes = 0;
+        std::atomic<std::uint64_t> mLines = 0;
+        std::atomic<std::uint64_t> mReads = 0;
+#ifdef _WIN32
+        void readStream(Stream& stream);
+
+        std::thread mStdoutThread;
+        std::thread mStderrThread;
+#else
+        void pollStreams();
+
+        std::thread mThread;
+        int         mCancelPipe[2] = {-1, -1}; // Self-pipe that wakes poll() on cancellation.
+#endif
+    };
+
+} // namespace mcdk
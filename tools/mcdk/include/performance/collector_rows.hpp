@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace mcdk::performance {
+
+    // The bounds the Python CPU collector applies to one capture: the most expensive functions it keeps and the calls
+    // between them. Flight recorder windows and sampled captures are bounded alike, so every Python CPU job queries the
+    // same way; the collector template receives them through its @MAX_FUNCTIONS@ and @MAX_CALLS@ tokens.
+    inline constexpr std::size_t CollectorMaximumFunctions = 512;
+    inline constexpr std::size_t CollectorMaximumCalls     = 2048;
+
+    // Whether every listed element of a collector row is a number, or a string. The caller checks the row's size.
+    [[nodiscard]] bool numbersAt(const nlohmann::json& row, std::initializer_list<std::size_t> indexes);
+    [[nodiscard]] bool stringsAt(const nlohmann::json& row, std::initializer_list<std::size_t> indexes);
+
+} // namespace mcdk::performance
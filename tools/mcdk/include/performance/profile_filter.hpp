@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "profile_store.hpp"
+
+namespace mcdk::performance {
+
+    // A query filter such as `self_time > 2ms and source_file contains combat/`:
+    //
+    //   expression  := or
+    //   or          := and ("or" and)*
+    //   and         := unary ("and" unary)*
+    //   unary       := "not" unary | "(" expression ")" | comparison | term
+    //   comparison  := field operator value
+    //   operator    := "==" | "=" | "!=" | "<" | "<=" | ">" | ">=" | "contains" | "glob" | "matches" | "~"
+    //   value       := number [unit] | quoted string | word
+    //   term        := quoted string | word          (matches like a plain text filter)
+    //
+    // Keywords are case-insensitive. Ordering compares numeric fields; a number may carry a time (ns, us, ms, s, min)
+    // or size (b, kb, kib, mb, mib, gb, gib) unit and is converted to the field's unit. == and != compare text
+    // exactly; contains, glob (* and ? over the whole value) and matches (ECMAScript regex search) ignore case. A
+    // record without the field never satisfies a comparison on it. Text with no comparison at the start of a clause
+    // stays a plain text filter, so existing filters such as "<module>" keep their meaning.
+    class FilterExpression {
+    public:
+        // nullopt for a plain text filter; an error for text that starts a comparison but does not parse.
+        [[nodiscard]] static std::expected<std::optional<FilterExpression>, ProfilerError> parse(std::string_view text);
+
+        // Binds fields to the view's visible columns and returns the matching rows in view order.
+        [[nodiscard]] std::expected<std::vector<std::uint32_t>, ProfilerError>
+        select(const ProfileStore& store, const ProfileView& view) const;
+
+        enum class Operator : std::uint8_t { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, Contains, Glob, Matches };
+
+        struct Node {
+            enum class Kind : std::uint8_t { And, Or, Not, Compare, Text };
+            Kind          kind = Kind::Text;
+            std::uint32_t left = 0; // Children of And, Or and Not, as indexes into nodes_.
+            std::uint32_t right = 0;
+            Operator      op = Operator::Equal;
+            std::string   field;
+            std::string   value;  // Compared text, or the term of a Text node.
+            bool          quoted = false;
+        };
+
+    private:
+        std::vector<Node> nodes_;
+        std::uint32_t     root_ = 0;
+    };
+
+} // namespace mcdk::performance
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+#include "profile_store.hpp"
+
+namespace mcdk::performance {
+
+    // One frame of a walked stack. Views stay valid until the frame is left.
+    struct StackFrame {
+        std::string_view name; // Empty for a traceback frame, which only has a location.
+        std::string_view file;
+        std::int64_t     line = 0;
+    };
+
+    // Receives stacks as a pre-order sequence of enter, addSelf and leave calls. A frame's own weight may arrive
+    // before or after its children.
+    class StackVisitor {
+    public:
+        virtual ~StackVisitor() = default;
+
+        virtual void enter(const StackFrame& frame) = 0;
+        virtual void addSelf(long double weight)    = 0;
+        virtual void leave()                        = 0;
+    };
+
+    // Stacks of a capture, walked straight from its columns so that only the current path is held: Native call trees
+    // per thread, Python CPU call graphs expanded from their roots with each caller's time split across its callees
+    // by edge time, and Python memory tracebacks weighted by retained bytes. CPU weights are nanoseconds.
+    void walkStacks(const ProfileStore& store, StackVisitor& visitor);
+
+    // One "frame;frame;frame weight" line per stack with a non-zero self weight, the input of flamegraph.pl,
+    // speedscope, inferno and similar tools.
+    void writeFoldedStacks(const ProfileStore& store, std::ostream& output);
+
+    // A self-contained SVG flame graph with click-to-zoom and search. Frames narrower than a tenth of a pixel are
+    // left out, as flamegraph.pl does, which bounds the document for captures with hundreds of thousands of frames.
+    void writeFlameGraph(const ProfileStore& store, std::string_view title, std::string_view subtitle, std::ostream& output);
+
+} // namespace mcdk::performance
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "profiler_types.hpp"
+
+namespace mcdk::performance {
+
+    // Frame or tick durations in an HDR-style log-linear histogram of microseconds: values below 128 are exact, and
+    // every power-of-two range above splits into 128 equal buckets, so a value keeps its first two significant digits
+    // (within 0.8%) from a microsecond to an hour in a few kilobytes, however many frames are recorded.
+    class FrameHistogram {
+    public:
+        struct Bucket {
+            std::int64_t  lowest  = 0; // Microseconds, inclusive.
+            std::int64_t  highest = 0;
+            std::uint64_t count   = 0;
+        };
+
+        // Clamps to 0..1 hour.
+        void record(std::int64_t microseconds);
+
+        [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+        [[nodiscard]] std::int64_t  minimum() const noexcept { return count_ == 0 ? 0 : minimum_; }
+        [[nodiscard]] std::int64_t  maximum() const noexcept { return maximum_; }
+        [[nodiscard]] double        mean() const noexcept;
+        // The highest value equivalent to the one at the percentile (0..100], as HdrHistogram reports it, capped at
+        // the exact maximum; 0 when nothing was recorded.
+        [[nodiscard]] std::int64_t percentile(double percentile) const;
+        // The non-empty buckets, lowest first.
+        [[nodiscard]] std::vector<Bucket> buckets() const;
+
+    private:
+        std::vector<std::uint64_t> counts_; // Grown to the highest bucket recorded.
+        std::uint64_t              count_   = 0;
+        std::int64_t               minimum_ = 0;
+        std::int64_t               maximum_ = 0;
+        long double                sum_     = 0;
+    };
+
+    // A CPU job whose capture window overlapped a frame-time job, in seconds since the frame-time job started.
+    struct FrameCpuWindow {
+        std::string  jobId;
+        ProfilerKind kind  = ProfilerKind::PythonCpu;
+        double       start = 0;
+        double       end   = 0;
+    };
+
+    // What a frame-time job drains from the game's tick watchers, per side: the whole distribution in a
+    // FrameHistogram, one-second windows for the time series and the slowest frames. A drain returns durations
+    // without timestamps, so each frame is placed by counting back from the drain, whose last frame ended as it ran.
+    class FrameTimeline {
+    public:
+        // Adds the durations one drain returned, oldest first; the last one ended end seconds into the job.
+        void append(ProfileTarget side, std::span<const double> milliseconds, double end);
+        // Counts frames the watcher discarded before the host drained them.
+        void lose(ProfileTarget side, std::uint64_t frames);
+
+        // The collector payload buildProfileStore turns into the frame-time views. Worst frames link to the CPU
+        // window they overlap most.
+        [[nodiscard]] nlohmann::json payload(double elapsed, std::span<const FrameCpuWindow> windows) const;
+
+    private:
+        struct Frame {
+            double end      = 0; // Seconds since the job started.
+            double duration = 0; // Milliseconds.
+        };
+        struct Window {
+            std::uint64_t frames  = 0;
+            double        sum     = 0;
+            double        maximum = 0;
+        };
+        struct Side {
+            FrameHistogram                 histogram;
+            std::map<std::int64_t, Window> windows; // By whole second.
+            std::vector<Frame>             worst;   // A min-heap by duration.
+            std::uint64_t                  lost = 0;
+        };
+
+        Side& side(ProfileTarget target);
+
+        std::map<ProfileTarget, Side> sides_;
+    };
+
+} // namespace mcdk::performance
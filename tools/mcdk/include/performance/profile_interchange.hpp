@@ -0,0 +1,21 @@
+#pragma once
+
+#include <iosfwd>
+
+#include "profile_store.hpp"
+
+namespace mcdk::performance {
+
+    // A gzip-compressed pprof profile.proto for `go tool pprof`, Speedscope, Perfetto and similar tools. Every stack
+    // walkStacks reports with its own weight becomes a sample whose locations run leaf first, valued as cpu in
+    // nanoseconds or, for memory captures, inuse_space in bytes. Functions, locations and strings are written as
+    // they are first seen, so only their ids are held. A compression failure marks the stream bad.
+    void writePprof(const ProfileStore& store, std::ostream& output);
+
+    // Chrome trace-event JSON for chrome://tracing and Perfetto, from a Native capture. One process holds the
+    // recorded slowest calls at their real start times, annotated with their zone's timings; the other lays each
+    // thread's call tree out as a timeline of total times, children in capture order inside their parent. Other
+    // capture kinds produce a trace without events.
+    void writeChromeTrace(const ProfileStore& store, std::ostream& output);
+
+} // namespace mcdk::performance
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace mcdk::performance {
+
+    // The least-squares line through one allocation site's bytes over time. rSquared is how much of the variation the
+    // line explains: near 1 for a site that grows or shrinks steadily, near 0 for one that jumped once and stayed.
+    struct GrowthFit {
+        double slope     = 0; // Bytes per second.
+        double intercept = 0;
+        double rSquared  = 0;
+    };
+
+    // Needs two distinct times; values without a time are ignored.
+    [[nodiscard]] std::optional<GrowthFit> fitGrowth(std::span<const double> seconds, std::span<const double> bytes);
+
+    // The periodic tracemalloc snapshots of one Python memory job. Each snapshot returns the largest allocation sites
+    // by bytes held since the job's baseline, under site ids the game keeps for the whole job, and the frames of the
+    // sites it has not reported before. A site outside one snapshot's top rows has no point for that snapshot rather
+    // than a zero, so a slope is fitted over the snapshots that saw it.
+    class MemoryTimeline {
+    public:
+        // Adds one snapshot; malformed rows are skipped.
+        void append(const nlohmann::json& snapshot);
+
+        [[nodiscard]] std::size_t snapshots() const noexcept { return snapshots_.size(); }
+
+        // The collector payload with the final collection as the last point, and the per-snapshot totals and the
+        // fitted sites buildProfileStore turns into the snapshots and growth-rate views. Without snapshots the
+        // payload is returned unchanged.
+        [[nodiscard]] nlohmann::json payload(nlohmann::json collected) const;
+
+    private:
+        struct Point {
+            double       elapsed  = 0;
+            std::int64_t sizeDiff = 0;
+        };
+        struct Site {
+            std::vector<std::pair<std::string, std::int64_t>> frames; // Innermost first.
+            std::vector<Point>                                points;
+        };
+        struct Snapshot {
+            double       elapsed   = 0;
+            std::int64_t sizeDiff  = 0;
+            std::int64_t countDiff = 0;
+            std::size_t  sites     = 0;
+        };
+
+        std::map<std::int64_t, Site> sites_;
+        std::vector<Snapshot>        snapshots_;
+    };
+
+} // namespace mcdk::performance
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace mcdk::performance {
+
+    // The rolling window of a Python CPU flight recorder: payloads the game collector drains periodically, each
+    // covering the time since the previous drain. Segments leave once they end before the window, and the oldest
+    // also leave while the ring exceeds its byte budget, so a recorder left on for a session stays bounded.
+    class FlightRecorder {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        FlightRecorder(Clock::duration window, std::size_t maximumBytes);
+
+        FlightRecorder(const FlightRecorder&)            = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        // Keeps one drained collector payload that ended at end, skipping rows the store would also reject.
+        void append(const nlohmann::json& payload, Clock::time_point end);
+
+        // The retained segments as one collector payload: functions and calls with the same identity are summed, and
+        // the merged result is bounded as the collector bounds one capture.
+        [[nodiscard]] nlohmann::json merged() const;
+
+        [[nodiscard]] std::size_t bytes() const noexcept { return bytes_; }
+        [[nodiscard]] std::size_t segments() const noexcept { return segments_.size(); }
+        // Seconds of profiling the retained segments cover.
+        [[nodiscard]] double covered() const noexcept;
+
+    private:
+        struct Function {
+            std::string  module;
+            std::int64_t line = 0;
+            std::string  name;
+            std::int64_t calls       = 0;
+            std::int64_t actualCalls = 0;
+            double       self        = 0;
+            double       total       = 0;
+            std::int64_t contextId   = 0;
+            std::string  contextName;
+            std::string  target; // Empty when the collector attributed no side.
+        };
+        struct Call {
+            std::uint32_t caller = 0; // Index into the segment's functions.
+            std::uint32_t callee = 0;
+            std::int64_t  calls  = 0;
+            double        self   = 0;
+            double        total  = 0;
+        };
+        struct Segment {
+            Clock::time_point        end;
+            double                   elapsed   = 0;
+            std::int64_t             total     = 0;
+            bool                     truncated = false;
+            std::string              clock;
+            std::vector<std::string> targets;
+            std::vector<Function>    functions;
+            std::vector<Call>        calls;
+            std::size_t              bytes = 0;
+        };
+
+        void evict(Clock::time_point now);
+
+        Clock::duration     window_;
+        std::size_t         maximumBytes_;
+        std::deque<Segment> segments_; // Oldest first.
+        std::size_t         bytes_ = 0;
+    };
+
+} // namespace mcdk::performance
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace mcdk::performance {
+
+    // Folds the stack trie a game-side Python sampler reports into the collector payload yappi captures produce, so
+    // sampled captures build the same hotspots and calls views. Each stack sample stands for the sampler's measured
+    // period of its thread's wall time: a function's total counts the samples it was on the stack once however deeply
+    // it recursed, its self counts the samples it was executing, and its calls count the samples that saw it. A call
+    // from a caller to a callee counts the samples that saw the callee under that caller, again once per sample. The
+    // result is bounded and ranked as the collector bounds one capture, and it carries a sampling object describing
+    // the rate.
+    [[nodiscard]] nlohmann::json foldSampledStacks(const nlohmann::json& payload);
+
+} // namespace mcdk::performance
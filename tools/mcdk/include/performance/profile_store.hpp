@@ -0,0 +1,217 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "profiler_types.hpp"
+
+namespace mcdk::performance {
+
+    using StringId = std::uint32_t;
+
+    // Version 1 of the encoded profile. All integers are little-endian and every block starts on an 8-byte boundary:
+    //
+    //   header         magic "MCDKPROF", u32 version, u32 profiler kind, u32 section count, u32 reserved, u64 size
+    //   section index  per section: u32 type, u32 reserved, u64 offset, u64 size
+    //   strings        u32 count, u32 reserved, u32 offsets[count + 1], UTF-8 bytes
+    //   frames         u32 count, u32 reserved, {u32 file string, u32 reserved, i64 line}[count]
+    //   stacks         u32 count, u32 reserved, u32 frame offsets[count + 1]
+    //   table          u32 rows, u32 column count, {u32 name, u32 unit, u8 type, u8 has presence, u16, u32}[],
+    //                  u32 row ids[rows], then per column i64 cells[rows] and, if present, u8 presence[rows]
+    //   view           u32 name, u32 table, u32 row count, u32 column count, u32 rows[], u32 columns[]
+    inline constexpr std::uint32_t ProfileFormatVersion = 1;
+
+    // The bytes of one encoded profile: owned after a capture finalizes, or mapped read-only from a persisted
+    // artifact so that only the pages a query reads are ever loaded.
+    class ProfileImage {
+    public:
+        explicit ProfileImage(std::vector<std::byte> bytes);
+        ~ProfileImage();
+
+        ProfileImage(const ProfileImage&)            = delete;
+        ProfileImage& operator=(const ProfileImage&) = delete;
+
+        [[nodiscard]] static std::expected<std::shared_ptr<const ProfileImage>, ProfilerError>
+        map(const std::filesystem::path& path);
+
+        [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+        [[nodiscard]] bool                       mapped() const noexcept { return mapped_; }
+
+    private:
+        ProfileImage() = default;
+
+        std::vector<std::byte> owned_;
+        const std::byte*       data_   = nullptr;
+        std::size_t            size_   = 0;
+        bool                   mapped_ = false;
+    };
+
+    // Every identifier, name and path of a capture is stored once, so rows only hold ids and equal strings compare as
+    // equal ids. Views point into the image.
+    class StringTable {
+    public:
+        void attach(std::span<const std::uint32_t> offsets, std::span<const char> bytes) noexcept;
+
+        // Ids and offsets are read from the image unchecked; a corrupt one reads as the empty string.
+        [[nodiscard]] std::string_view view(StringId id) const noexcept {
+            if (id >= size()) return {};
+            const auto begin = offsets_[id];
+            const auto end   = offsets_[id + 1];
+            return begin <= end && end <= bytes_.size() ? std::string_view(bytes_.data() + begin, end - begin)
+                                                        : std::string_view();
+        }
+        [[nodiscard]] std::size_t size() const noexcept { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+        // The reverse index is built on first use; most queries never need it.
+        [[nodiscard]] std::optional<StringId> find(std::string_view value) const;
+
+    private:
+        std::span<const std::uint32_t>                         offsets_;
+        std::span<const char>                                  bytes_;
+        mutable std::once_flag                                 indexed_;
+        mutable std::unordered_map<std::string_view, StringId> index_;
+    };
+
+    // Whether haystack contains the already lower-cased needle, ignoring ASCII case; the text match of filters and
+    // row searches.
+    [[nodiscard]] bool containsFolded(std::string_view haystack, std::string_view lowerNeedle);
+
+    enum class ColumnType : std::uint8_t {
+        Integer,
+        Real,
+        Text,  // StringId into ProfileStore::strings.
+        Stack, // Index into ProfileStore::stackOffsets.
+    };
+
+    // One field of a table. Every cell is eight bytes: integers as is, reals bit-cast, text and stack cells as ids.
+    struct ProfileColumn {
+        std::string                   name;
+        std::string                   unit;
+        ColumnType                    type = ColumnType::Integer;
+        std::span<const std::int64_t> cells;
+        std::span<const std::uint8_t> present; // Empty when every row has a value.
+
+        [[nodiscard]] bool has(std::size_t row) const { return present.empty() || present[row] != 0; }
+        [[nodiscard]] std::int64_t integer(std::size_t row) const { return cells[row]; }
+        [[nodiscard]] double       real(std::size_t row) const { return std::bit_cast<double>(cells[row]); }
+        [[nodiscard]] StringId     text(std::size_t row) const { return static_cast<StringId>(cells[row]); }
+    };
+
+    struct ProfileTable {
+        std::span<const StringId>  ids;
+        std::vector<ProfileColumn> columns;
+
+        [[nodiscard]] std::size_t rows() const noexcept { return ids.size(); }
+    };
+
+    // A queryable view: a row selection and column projection over one table, in the view's natural order.
+    struct ProfileView {
+        std::string                    name;
+        std::uint32_t                  table = 0;
+        std::span<const std::uint32_t> rows;
+        std::vector<std::uint32_t>     columns;
+    };
+
+    struct ProfileFrame {
+        StringId      file = 0;
+        std::uint32_t reserved = 0;
+        std::int64_t  line = 0;
+    };
+    static_assert(sizeof(ProfileFrame) == 16);
+
+    // The typed, columnar form of one completed capture, decoded in place over its image. It never changes after it
+    // is opened, so queries read it without locking.
+    struct ProfileStore {
+        std::shared_ptr<const ProfileImage> image;
+        ProfilerKind                        kind = ProfilerKind::PythonCpu;
+        StringTable                         strings;
+        std::span<const ProfileFrame>       frames;
+        std::span<const std::uint32_t>      stackOffsets; // Stack i spans frames [stackOffsets[i], stackOffsets[i + 1]).
+        std::vector<ProfileTable>           tables;
+        std::vector<ProfileView>            views;
+        // Per view: 0 until its rows are first checked, then 1 if they all lie within its table and -1 if not.
+        mutable std::vector<std::atomic<std::int8_t>> checkedViews;
+
+        // Null when there is no such view or its rows point outside its table.
+        [[nodiscard]] const ProfileView*  view(std::string_view name) const;
+        // Checks the view's row indexes on its first use, so opening a mapped image does not read every view.
+        [[nodiscard]] bool                rowsValid(const ProfileView& view) const;
+        // The frames of one stack cell; empty for an id the image does not hold.
+        [[nodiscard]] std::span<const ProfileFrame> stack(std::int64_t index) const noexcept;
+        [[nodiscard]] const ProfileTable& tableOf(const ProfileView& view) const { return tables[view.table]; }
+        // Only columns projected by the view are visible.
+        [[nodiscard]] const ProfileColumn* column(const ProfileView& view, std::string_view name) const;
+    };
+
+    // Converts the collector payload of one profiler kind into an encoded image. Malformed rows are skipped.
+    [[nodiscard]] std::vector<std::byte> encodeProfile(ProfilerKind kind, const nlohmann::json& data);
+    // Validates the layout and the column indexes of every view. Neither view rows nor cells are read: rows are checked
+    // on each view's first use and string and stack ids where they are resolved, so a mapped image stays unloaded
+    // until a query reads its pages.
+    [[nodiscard]] std::expected<std::shared_ptr<const ProfileStore>, ProfilerError>
+    openProfileStore(std::shared_ptr<const ProfileImage> image);
+    [[nodiscard]] std::expected<std::shared_ptr<const ProfileStore>, ProfilerError>
+    buildProfileStore(ProfilerKind kind, const nlohmann::json& data);
+
+    // Same text as formatting the materialized field value, appended without allocating per cell.
+    void appendCellText(const ProfileStore& store, const ProfileColumn& column, std::size_t row, std::string& output);
+    [[nodiscard]] std::string cellText(const ProfileStore& store, const ProfileColumn& column, std::size_t row);
+    // Integers and finite reals; nullopt for text, stacks and non-finite reals.
+    [[nodiscard]] std::optional<long double> cellNumber(const ProfileColumn& column, std::size_t row);
+    [[nodiscard]] ProfilerField cellField(const ProfileStore& store, const ProfileColumn& column, std::size_t row);
+    [[nodiscard]] QueryRecord   materializeRecord(const ProfileStore& store, const ProfileView& view, std::size_t row);
+    // Every view of the store as {"views": {name: [record, ...]}}, the portable export of a capture.
+    [[nodiscard]] nlohmann::json profileJson(const ProfileStore& store);
+
+    // Whether a row's id, or any visible "<field> <value>" text, contains the already lower-cased needle. A text
+    // column repeats few distinct strings, so each one is matched once per matcher.
+    class RowTextMatcher {
+    public:
+        RowTextMatcher(const ProfileStore& store, const ProfileView& view, std::string_view lowerNeedle);
+
+        [[nodiscard]] bool operator()(std::uint32_t row);
+
+    private:
+        const ProfileStore&                   store_;
+        const ProfileView&                    view_;
+        std::string                           needle_;
+        std::vector<std::vector<std::int8_t>> textMatches_; // Per visible column and string: -1 unknown, 0 or 1.
+        std::string                           text_;
+    };
+
+    // Rows of the view that RowTextMatcher accepts, in view order.
+    [[nodiscard]] std::vector<std::uint32_t>
+    filterRows(const ProfileStore& store, const ProfileView& view, std::string_view lowerNeedle);
+    // Stable sort by one field: numeric when both cells are numeric, textual otherwise, absent cells last when
+    // descending and first when ascending.
+    void sortRows(
+        const ProfileStore&         store,
+        const ProfileView&          view,
+        std::vector<std::uint32_t>& rows,
+        std::string_view            field,
+        bool                        descending
+    );
+    // Leaves only the first count rows of the order sortRows produces, in that order, without ordering the rest.
+    void selectTopRows(
+        const ProfileStore&         store,
+        const ProfileView&          view,
+        std::vector<std::uint32_t>& rows,
+        std::string_view            field,
+        bool                        descending,
+        std::size_t                 count
+    );
+
+} // namespace mcdk::performance
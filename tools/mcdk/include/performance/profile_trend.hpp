@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+namespace mcdk::performance {
+
+    // One metric of one source identity across a run of captures, split into the earlier baseline runs and the
+    // newest candidate runs. Variances are sample variances.
+    struct TrendTest {
+        std::size_t baselineRuns      = 0;
+        std::size_t candidateRuns     = 0;
+        double      baselineMean      = 0;
+        double      baselineVariance  = 0;
+        double      candidateMean     = 0;
+        double      candidateVariance = 0;
+        double      t                 = 0;
+        double      degreesOfFreedom  = 0;
+        double      pValue            = 1; // Two-sided.
+    };
+
+    // Welch's t-test of the candidate mean against the baseline mean. A single candidate run has no variance of its
+    // own, so it is tested against the baseline's prediction interval instead. Needs at least two baseline values
+    // and one candidate value.
+    [[nodiscard]] std::optional<TrendTest> trendTest(std::span<const double> baseline, std::span<const double> candidate);
+
+    // The two-sided tail probability of Student's t distribution, P(|T| >= |t|).
+    [[nodiscard]] double studentTwoSided(double t, double degreesOfFreedom);
+
+} // namespace mcdk::performance
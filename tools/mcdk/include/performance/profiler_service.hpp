@@ -1,6 +1,7 @@
 #pragma once
 
 #include <expected>
+#include <vector>
 
 #include "profiler_types.hpp"
 
@@ -14,9 +15,13 @@ namespace mcdk::performance {
         [[nodiscard]] virtual std::expected<JobSnapshot, ProfilerError>  status(const JobId& id) const              = 0;
         [[nodiscard]] virtual std::expected<JobSnapshot, ProfilerError>  stop(const JobId& id)                      = 0;
         [[nodiscard]] virtual std::expected<void, ProfilerError>         discard(const JobId& id)                   = 0;
+        // Freezes the current window of a running flight recorder into a new completed job; the recorder continues.
+        [[nodiscard]] virtual std::expected<JobSnapshot, ProfilerError>  snapshot(const JobId& id)                  = 0;
         [[nodiscard]] virtual std::expected<QueryPage, ProfilerError>    query(const QueryRequest& request) const   = 0;
         [[nodiscard]] virtual std::expected<CompareResult, ProfilerError>
         compare(const CompareRequest& request) const                                                               = 0;
+        // Tests one comparable view of the latest committed jobs of a kind for regressions, identity by identity.
+        [[nodiscard]] virtual std::expected<TrendResult, ProfilerError> trend(const TrendRequest& request) const    = 0;
         [[nodiscard]] virtual std::expected<DetailResult, ProfilerError> detail(const DetailRequest& request) const = 0;
         [[nodiscard]] virtual std::expected<HistoryPage, ProfilerError>
         history(const HistoryRequest& request) const                                                                = 0;
@@ -24,6 +29,11 @@ namespace mcdk::performance {
         [[nodiscard]] virtual std::expected<CleanupResult, ProfilerError> cleanup(const CleanupRequest& request)    = 0;
         [[nodiscard]] virtual std::expected<Capabilities, ProfilerError>
         inspectCapabilities(const DoctorRequest& request) = 0;
+        // Watches for a trigger's condition and starts its capture, tagged with the trigger context, each time it
+        // holds outside the cooldown until the capture cap is reached. Triggers last for the service's session.
+        [[nodiscard]] virtual std::expected<TriggerSnapshot, ProfilerError> arm(const TriggerRequest& request) = 0;
+        [[nodiscard]] virtual std::expected<std::vector<TriggerSnapshot>, ProfilerError> triggers() const  = 0;
+        [[nodiscard]] virtual std::expected<TriggerSnapshot, ProfilerError> disarm(const TriggerId& id)      = 0;
 
         virtual void shutdown() noexcept = 0;
     };
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <filesystem>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <nlohmann/json_fwd.hpp>
 
@@ -26,6 +28,17 @@ namespace mcdk::performance {
         std::chrono::milliseconds
     )>;
 
+    struct GameLogBatch {
+        std::vector<std::string> lines;
+        std::uint64_t            nextCursor = 0;
+        std::uint64_t            dropped    = 0;     // Lines after the cursor that were evicted before this read.
+        bool                     hasMore    = false; // maxLines was reached; more lines are already available.
+    };
+
+    // Returns up to maxLines game log lines after cursor, oldest first, and the cursor of the last one. A cursor past
+    // the newest line returns no lines and the newest line's cursor.
+    using GameLogReader = std::function<GameLogBatch(std::uint64_t cursor, std::size_t maxLines)>;
+
     struct ProfilerServiceOptions {
         GameCodeExecutor              executeCode;
         std::function<std::uint32_t()> currentGameProcessId;
@@ -33,6 +46,13 @@ namespace mcdk::performance {
         std::filesystem::path         executableDirectory;
         std::function<std::chrono::steady_clock::time_point()> monotonicNow;
         std::chrono::steady_clock::duration memoryIdleTimeout = std::chrono::minutes(20);
+        // Sorted query indexes and comparison sides kept for cursors and repeated requests; 0 disables the cache.
+        std::size_t queryCacheBytes = 64 * 1024 * 1024;
+        // Encoded profiles of committed disk jobs kept mapped; beyond it the least recently queried are unmapped and
+        // mapped again on their next query. Memory jobs are not counted, since they cannot be reloaded.
+        std::size_t residentJobBytes = 256 * 1024 * 1024;
+        // The game log that log pattern triggers watch; without it they cannot be armed.
+        GameLogReader readGameLog;
     };
 
     [[nodiscard]] std::expected<std::shared_ptr<ProfilerService>, ProfilerError>
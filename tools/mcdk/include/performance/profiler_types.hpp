@@ -12,12 +12,14 @@
 
 namespace mcdk::performance {
 
-    using JobId = std::string;
+    using JobId     = std::string;
+    using TriggerId = std::string;
 
     enum class ProfilerKind {
         PythonCpu,
         PythonMemory,
         NativeCpu,
+        FrameTime, // Client frame and server tick durations, timed between the side's game-thread ticks.
     };
 
     enum class ProfileTarget {
@@ -36,6 +38,28 @@ namespace mcdk::performance {
         Disk,
     };
 
+    enum class ProfileMode {
+        Capture,  // Runs until its deadline or stop and completes with everything it captured.
+        Recorder, // Keeps only the last duration in a bounded ring until stopped; snapshot freezes it into a job.
+    };
+
+    enum class ProfileEngine {
+        Tracing,  // yappi records every call of the profiled threads exactly, at a cost on each call.
+        Sampling, // A game-side thread samples the profiled threads' stacks at a fixed rate; calls count samples.
+    };
+
+    enum class TriggerCondition {
+        TickTime,   // The watched side's tick interval stays above a threshold for consecutive ticks.
+        LogPattern, // A new game log line matches a pattern.
+    };
+
+    enum class TriggerState {
+        Armed,
+        Exhausted, // Started its maximum number of captures.
+        Disarmed,
+        Failed,    // Its capture cannot start at all, so it stopped watching.
+    };
+
     enum class JobState {
         Created,
         Starting,
@@ -63,17 +87,60 @@ namespace mcdk::performance {
         std::chrono::seconds duration{15};
         std::size_t          tracebackDepth = 8;
         bool                 collectGarbage = true;
+        ProfileMode          mode           = ProfileMode::Capture;
+        std::size_t          recorderBytes  = 16 * 1024 * 1024; // Ring budget of a flight recorder.
+        ProfileEngine        engine         = ProfileEngine::Tracing;
+        std::uint32_t        sampleHertz    = 100; // Stack samples per second of a sampling engine.
+        // Python memory: the time between snapshots that growth slopes are fitted over; zero takes only the final one.
+        std::chrono::seconds snapshotInterval{0};
+    };
+
+    // Why a trigger started a job, kept with the job so unattended captures explain themselves.
+    struct TriggerContext {
+        TriggerId        triggerId;
+        TriggerCondition condition = TriggerCondition::TickTime;
+        std::string      detail; // The observed streak, or the matching log line.
+        std::string      firedAt;
     };
 
     struct JobSnapshot {
         JobId        id;
         ProfilerKind kind    = ProfilerKind::PythonCpu;
         ProfileStorage storage = ProfileStorage::Memory;
+        ProfileMode  mode    = ProfileMode::Capture;
         JobState     state   = JobState::Created;
         bool         partial = false;
         std::string  statusMessage;
         std::string  createdAt;
         std::string  completedAt;
+        std::uintmax_t storedBytes = 0; // The committed directory's size; 0 until a disk job completes.
+        std::optional<TriggerContext> trigger;
+    };
+
+    struct TriggerRequest {
+        TriggerCondition condition = TriggerCondition::TickTime;
+        ProfileTarget    side      = ProfileTarget::Server; // The side whose ticks are watched.
+        double           tickMilliseconds = 100;
+        std::uint32_t    consecutiveTicks = 3;
+        std::string      logPattern;
+        bool             logRegex = false; // Otherwise logPattern is a case-sensitive substring.
+        std::chrono::seconds cooldown{120}; // Conditions that hold again within this time of a capture are ignored.
+        std::uint32_t    maximumCaptures = 3;
+        StartRequest     capture;
+    };
+
+    struct TriggerSnapshot {
+        TriggerId        id;
+        TriggerCondition condition = TriggerCondition::TickTime;
+        TriggerState     state     = TriggerState::Armed;
+        std::uint32_t    captures        = 0;
+        std::uint32_t    maximumCaptures = 0;
+        std::uint32_t    suppressed      = 0; // Times the condition held during a cooldown or while the profiler was busy.
+        std::uint64_t    missedLogLines  = 0; // Log lines evicted before a log pattern trigger could read them.
+        std::vector<JobId> jobs;
+        std::string      statusMessage;
+        std::string      armedAt;
+        std::string      lastFiredAt;
     };
 
     struct ProfilerStackFrame {
@@ -128,6 +195,29 @@ namespace mcdk::performance {
         bool                     truncated = false;
     };
 
+    // A trend over the last runs completed, non-partial disk jobs of one kind, oldest first: the newest
+    // candidateRuns of them are tested against the runs before.
+    struct TrendRequest {
+        ProfilerKind kind = ProfilerKind::PythonCpu;
+        std::string  view;
+        std::string  metric;
+        std::size_t  runs             = 10;
+        std::size_t  candidateRuns    = 1;
+        double       thresholdPercent = 10;   // The smallest mean change that counts as a regression.
+        double       significance     = 0.05; // The largest p-value that counts as a real change.
+        std::size_t  limit            = 20;
+    };
+
+    struct TrendResult {
+        std::vector<QueryRecord> records;
+        std::vector<JobId>       jobIds; // The runs tested, oldest first.
+        std::string              metric;
+        std::size_t              series    = 0; // Identities seen in any run.
+        std::size_t              regressed = 0;
+        std::size_t              improved  = 0;
+        bool                     truncated = false;
+    };
+
     struct DetailRequest {
         JobId       jobId;
         std::string view;
@@ -153,6 +243,11 @@ namespace mcdk::performance {
     enum class ExportFormat {
         Markdown,
         Svg,
+        Json,        // Every view of the capture in full, for tools outside MCDK.
+        Folded,      // Folded stacks, one "frame;frame weight" line per stack, for external flame graph tools.
+        FlameGraph,  // A self-contained interactive SVG flame graph.
+        Pprof,       // Gzip-compressed pprof profile.proto.
+        ChromeTrace, // Chrome trace-event JSON of Native zone timelines.
     };
 
     struct ExportRequest {
@@ -193,6 +288,10 @@ namespace mcdk::performance {
 
     [[nodiscard]] const char* toString(ProfilerKind value) noexcept;
     [[nodiscard]] const char* toString(ProfileStorage value) noexcept;
+    [[nodiscard]] const char* toString(ProfileMode value) noexcept;
+    [[nodiscard]] const char* toString(ProfileEngine value) noexcept;
+    [[nodiscard]] const char* toString(TriggerCondition value) noexcept;
+    [[nodiscard]] const char* toString(TriggerState value) noexcept;
     [[nodiscard]] const char* toString(JobState value) noexcept;
 
 } // namespace mcdk::performance
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "profile_store.hpp"
+
+namespace mcdk::performance {
+
+    // Rows of one view in a derived order: filtered and sorted for a query, or grouped by a key for lookups.
+    struct RowIndex {
+        std::vector<std::uint32_t> rows;
+        // Rows in the full order. A first page keeps only its leading rows, and then total exceeds rows.size().
+        std::size_t total = 0;
+
+        [[nodiscard]] bool complete() const noexcept { return rows.size() >= total; }
+
+        [[nodiscard]] std::size_t bytes() const noexcept { return rows.capacity() * sizeof(std::uint32_t); }
+    };
+
+    // Least-recently-used results derived from profile stores, bounded by their approximate size. An entry is only
+    // returned for the store it was computed from, so a discarded and reloaded job never sees stale rows, and entries
+    // never keep a store alive.
+    class QueryCache {
+    public:
+        explicit QueryCache(std::size_t maximumBytes) : maximumBytes_(maximumBytes) {}
+
+        QueryCache(const QueryCache&)            = delete;
+        QueryCache& operator=(const QueryCache&) = delete;
+
+        // Keys of one job share its prefix; parts are length-prefixed so no filter text can alias another request.
+        [[nodiscard]] static std::string key(std::string_view jobId, std::initializer_list<std::string_view> parts);
+
+        // The cached value, or compute() run outside the lock and then cached. Callers that miss together each
+        // compute, and the last insert wins. Value reports its footprint through bytes().
+        template <class Value, class Compute>
+        std::shared_ptr<const Value>
+        obtain(const std::string& key, const std::shared_ptr<const ProfileStore>& store, Compute&& compute) {
+            if (auto cached = find<Value>(key, store)) return cached;
+            return insert<Value>(key, store, std::forward<Compute>(compute)());
+        }
+
+        // For callers that decide whether a cached value is sufficient: null on a miss.
+        template <class Value>
+        std::shared_ptr<const Value> find(const std::string& key, const std::shared_ptr<const ProfileStore>& store) {
+            return std::static_pointer_cast<const Value>(lookup(key, store));
+        }
+
+        // Caches value under key, replacing any previous entry, and returns it.
+        template <class Value>
+        std::shared_ptr<const Value>
+        insert(const std::string& key, const std::shared_ptr<const ProfileStore>& store, Value value) {
+            auto shared = std::make_shared<const Value>(std::move(value));
+            remember(key, store, shared, shared->bytes());
+            return shared;
+        }
+
+        void eraseJob(std::string_view jobId);
+
+        [[nodiscard]] std::size_t bytes() const;
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        struct Entry {
+            std::string                       key;
+            std::weak_ptr<const ProfileStore> store;
+            std::shared_ptr<const void>       value;
+            std::size_t                       bytes = 0;
+        };
+        using Entries = std::list<Entry>;
+
+        std::shared_ptr<const void> lookup(const std::string& key, const std::shared_ptr<const ProfileStore>& store);
+        void remember(
+            const std::string&                         key,
+            const std::shared_ptr<const ProfileStore>& store,
+            std::shared_ptr<const void>                value,
+            std::size_t                                bytes
+        );
+        void erase(Entries::iterator entry);
+
+        mutable std::mutex                                      mutex_;
+        Entries                                                 entries_; // Most recently used first.
+        std::unordered_map<std::string_view, Entries::iterator> index_;
+        std::size_t                                             bytes_ = 0;
+        std::size_t                                             maximumBytes_;
+    };
+
+} // namespace mcdk::performance
@@ -18,6 +18,8 @@ namespace mcdk {
         bool shaders   = false;
         bool materials = false;
         bool particles = false;
+        // 相对各监听根目录的排除 glob，如 ".git"、"node_modules"、"build/**"
+        std::vector<std::string> excludeGlobs;
     };
 
     struct WorldSourceConfig {
@@ -76,6 +78,12 @@ namespace mcdk {
         int         serverPort = 19133;
     };
 
+    struct LogCollapseConfig {
+        bool enabled     = false;
+        // 仅数字不同的连续行也视为重复
+        bool maskNumbers = true;
+    };
+
     struct UserConfig {
         std::filesystem::path         gameExecutablePath;
         std::vector<UserModDirConfig> modDirectories;
@@ -89,6 +97,7 @@ namespace mcdk {
         MCDevTool::Style::StyleConfig windowStyle;
         NeteaseConfig                 netease;
         McpServerConfig               mcpServer;
+        LogCollapseConfig             logCollapse;
     };
 
 } // namespace mcdk
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mcdk {
+
+    struct TracebackFrame {
+        std::string   file;
+        std::uint32_t line = 0;
+        std::string   function;
+        std::string   source; // The indented source line printed under the frame, if any.
+    };
+
+    struct PythonTraceback {
+        std::string                 exceptionType;
+        std::string                 message;
+        std::vector<TracebackFrame> frames; // Outermost call first, as Python prints them.
+    };
+
+    // Identical failures collapse into one group. The signature ignores line numbers (hot reload shifts them) and
+    // masks numbers, quoted values and addresses in the message, so "KeyError: 'item_3'" and "KeyError: 'item_7'"
+    // raised from the same call stack share a group.
+    struct TracebackGroup {
+        std::uint64_t   signature = 0;
+        PythonTraceback latest;            // Most recent occurrence, verbatim.
+        std::string     normalizedMessage; // The message as it took part in the signature.
+        std::uint64_t   count       = 0;
+        std::int64_t    firstSeenMs = 0;   // Wall clock, milliseconds since the Unix epoch.
+        std::int64_t    lastSeenMs  = 0;
+    };
+
+    // Incrementally parses Python tracebacks out of a stream of stderr lines and groups them by signature.
+    class TracebackAggregator {
+    public:
+        enum class Order : std::uint8_t {
+            MostRecent,
+            MostFrequent,
+        };
+
+        explicit TracebackAggregator(std::size_t maxGroups = 256);
+
+        // Feeds one stderr line; returns the traceback it completed, if any.
+        std::optional<PythonTraceback> feed(std::string_view line);
+        std::optional<PythonTraceback> feed(std::string_view line, std::int64_t timestampMs);
+
+        [[nodiscard]] std::vector<TracebackGroup> groups(Order order, std::size_t maxCount) const;
+        [[nodiscard]] std::uint64_t               totalCount() const;
+        void                                      clear();
+
+        [[nodiscard]] static std::string   normalizeMessage(std::string_view message);
+        [[nodiscard]] static std::uint64_t signatureOf(const PythonTraceback& traceback);
+
+    private:
+        void record(PythonTraceback traceback, std::int64_t timestampMs);
+
+        std::optional<PythonTraceback>                    mPending;
+        std::unordered_map<std::uint64_t, TracebackGroup> mGroups;
+        std::uint64_t                                     mTotalCount = 0;
+        std::size_t                                       mMaxGroups;
+        mutable std::mutex                                mMutex;
+    };
+
+} // namespace mcdk
@@ -47,6 +47,26 @@ namespace mcdk {
             return directories;
         }
 
+        std::vector<std::string> parseHotReloadExclude(const Json& root) {
+            const auto value = root.find("hot_reload_exclude");
+            if (value == root.end() || value->is_null()) {
+                return {};
+            }
+            if (!value->is_array()) {
+                throw std::runtime_error("hot_reload_exclude 必须为 glob 字符串数组。");
+            }
+
+            std::vector<std::string> globs;
+            globs.reserve(value->size());
+            for (const auto& item : *value) {
+                if (!item.is_string()) {
+                    throw std::runtime_error("hot_reload_exclude 必须为 glob 字符串数组。");
+                }
+                globs.push_back(item.get<std::string>());
+            }
+            return globs;
+        }
+
         WorldSourceConfig parseWorldSource(const Json& root) {
             const auto setting = root.find("world_source_path");
             if (setting == root.end() || (setting->is_string() && setting->get<std::string>() == "auto")) {
@@ -174,6 +194,8 @@ namespace mcdk {
             config.hotReload.particles = root.value("auto_hot_reload_particles", false);
             parseDebugOptions(root, config.debugOptions);
 
+            config.hotReload.excludeGlobs = parseHotReloadExclude(root);
+
             if (const auto debugger = root.find("modpc_debugger"); debugger != root.end() && debugger->is_object()) {
                 config.modPcDebugger.enabled = debugger->value("enabled", false);
                 config.modPcDebugger.port    = debugger->value("port", 5632);
@@ -194,6 +216,10 @@ namespace mcdk {
                 config.mcpServer.serverIp   = mcp->value("server_ip", "localhost");
                 config.mcpServer.serverPort = mcp->value("server_port", 19133);
             }
+            if (const auto collapse = root.find("log_collapse"); collapse != root.end() && collapse->is_object()) {
+                config.logCollapse.enabled     = collapse->value("enabled", false);
+                config.logCollapse.maskNumbers = collapse->value("mask_numbers", true);
+            }
             return config;
         }
 
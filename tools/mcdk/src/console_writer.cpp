@@ -0,0 +1,259 @@
+#include <console_writer.hpp>
+
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace mcdk {
+
+    namespace {
+#ifdef _WIN32
+        WORD consoleAttribute(ConsoleColor color) {
+            switch (color) {
+            case ConsoleColor::Green:
+                return FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+            case ConsoleColor::Red:
+                return FOREGROUND_RED | FOREGROUND_INTENSITY;
+            case ConsoleColor::Blue:
+                return FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+            case ConsoleColor::Yellow:
+                return FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+            case ConsoleColor::Cyan:
+                return FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+            case ConsoleColor::Magenta:
+                return FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+            case ConsoleColor::White:
+                return FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
+            case ConsoleColor::Gray:
+                // 亮灰 = RGB，但不加高亮
+                return FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
+            case ConsoleColor::DarkGray:
+                // 深灰 = 只加高亮，不加 RGB
+                return FOREGROUND_INTENSITY;
+            default:
+                return 0;
+            }
+        }
+
+        void writeConsoleRun(ConsoleColor color, std::string_view text) {
+            const HANDLE               console = GetStdHandle(STD_OUTPUT_HANDLE);
+            CONSOLE_SCREEN_BUFFER_INFO info;
+            // Redirected output has no screen buffer, and Default keeps whatever attributes are current.
+            const bool colored = color != ConsoleColor::Default && console != INVALID_HANDLE_VALUE
+                              && GetConsoleScreenBufferInfo(console, &info);
+            if (colored) {
+                SetConsoleTextAttribute(console, consoleAttribute(color));
+            }
+            std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+            std::cout.flush();
+            if (colored) {
+                // 恢复原色
+                SetConsoleTextAttribute(console, info.wAttributes);
+            }
+        }
+#else
+        std::string_view ansiSequence(ConsoleColor color) {
+            switch (color) {
+            case ConsoleColor::Green:
+                return "\x1b[92m";
+            case ConsoleColor::Red:
+                return "\x1b[91m";
+            case ConsoleColor::Blue:
+                return "\x1b[94m";
+            case ConsoleColor::Yellow:
+                return "\x1b[93m";
+            case ConsoleColor::Cyan:
+                return "\x1b[96m";
+            case ConsoleColor::Magenta:
+                return "\x1b[95m";
+            case ConsoleColor::White:
+                return "\x1b[97m";
+            case ConsoleColor::Black:
+                return "\x1b[30m";
+            case ConsoleColor::Gray:
+                return "\x1b[37m";
+            case ConsoleColor::DarkGray:
+                return "\x1b[90m";
+            default:
+                return {};
+            }
+        }
+
+        void writeConsoleRun(ConsoleColor color, std::string_view text) {
+            static const bool terminal = isatty(STDOUT_FILENO) != 0;
+            const auto        sequence = terminal ? ansiSequence(color) : std::string_view{};
+            if (sequence.empty()) {
+                std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+            } else {
+                // Escapes and text go out in the same write so another writer cannot land in between.
+                std::string block;
+                block.reserve(sequence.size() + text.size() + 4);
+                block.append(sequence).append(text).append("\x1b[0m");
+                std::cout.write(block.data(), static_cast<std::streamsize>(block.size()));
+            }
+            std::cout.flush();
+        }
+#endif
+
+        bool isPriority(ConsoleColor color) { return color == ConsoleColor::Red || color == ConsoleColor::Yellow; }
+    } // namespace
+
+    ConsoleWriter::ConsoleWriter(Sink sink, ConsoleWriterOptions options)
+    : mSink(std::move(sink)),
+      mOptions(options),
+      mThread([this] { run(); }) {}
+
+    ConsoleWriter::~ConsoleWriter() {
+        mStopping.store(true, std::memory_order_release);
+        mWakeups.fetch_add(1, std::memory_order_release);
+        mWakeups.notify_one();
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+        mStopped.store(true, std::memory_order_release);
+        mWritten.notify_all();
+        // Lines pushed between the thread's last exchange and the flag above.
+        std::lock_guard lock(mSinkMutex);
+        drain(mHead.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    void ConsoleWriter::write(std::string line, ConsoleColor color) {
+        if (mStopped.load(std::memory_order_acquire)) {
+            line += '\n';
+            std::lock_guard lock(mSinkMutex);
+            emit(color, line);
+            return;
+        }
+
+        const std::size_t scale = isPriority(color) ? 2 : 1;
+        const std::size_t bytes = line.size() + 1;
+        const auto        lines = mQueuedLines.fetch_add(1, std::memory_order_relaxed) + 1;
+        const auto        total = mQueuedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        if (lines > mOptions.maxQueuedLines * scale || total > mOptions.maxQueuedBytes * scale) {
+            // The terminal is behind: give the reservation back and count the line instead of waiting for room.
+            mQueuedLines.fetch_sub(1, std::memory_order_relaxed);
+            mQueuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        auto* node = new Node{.next = nullptr, .text = std::move(line), .color = color};
+        mAccepted.fetch_add(1, std::memory_order_release);
+        Node* head = mHead.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!mHead.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+        if (head == nullptr) {
+            // Only the push onto an empty queue can find the writer asleep.
+            mWakeups.fetch_add(1, std::memory_order_release);
+            mWakeups.notify_one();
+        }
+    }
+
+    void ConsoleWriter::flush() {
+        const auto target = mAccepted.load(std::memory_order_acquire);
+        for (auto written = mWritten.load(std::memory_order_acquire); written < target;
+             written      = mWritten.load(std::memory_order_acquire)) {
+            if (mStopped.load(std::memory_order_acquire)) {
+                return;
+            }
+            mWritten.wait(written, std::memory_order_acquire);
+        }
+    }
+
+    ConsoleWriterStats ConsoleWriter::stats() const {
+        return {
+            .written = mWritten.load(std::memory_order_relaxed),
+            .dropped = mDropped.load(std::memory_order_relaxed),
+            .runs    = mRuns.load(std::memory_order_relaxed),
+        };
+    }
+
+    void ConsoleWriter::run() {
+        while (true) {
+            // Read the wakeup counter before looking at the queue, so a push that lands after the exchange changes
+            // the value the wait below compares against.
+            const auto wakeups = mWakeups.load(std::memory_order_acquire);
+            if (Node* batch = mHead.exchange(nullptr, std::memory_order_acquire)) {
+                drain(batch);
+                continue;
+            }
+            if (mStopping.load(std::memory_order_acquire)) {
+                return;
+            }
+            mWakeups.wait(wakeups, std::memory_order_acquire);
+        }
+    }
+
+    void ConsoleWriter::drain(Node* newestFirst) {
+        if (newestFirst == nullptr) {
+            return;
+        }
+        // Lines are only dropped while the queue is full, so drops counted by now happened after this batch was
+        // queued and their summary belongs after it. Later drops are reported with the next batch.
+        const auto dropped = mDropped.load(std::memory_order_relaxed);
+
+        // The stack hands lines back newest first; reversing it restores the order they were pushed in.
+        Node*         oldestFirst = nullptr;
+        std::size_t   bytes       = 0;
+        std::uint64_t count       = 0;
+        while (newestFirst != nullptr) {
+            Node* next        = newestFirst->next;
+            newestFirst->next = oldestFirst;
+            oldestFirst       = newestFirst;
+            newestFirst       = next;
+            bytes += oldestFirst->text.size() + 1;
+            ++count;
+        }
+        // Release the budget up front: producers may refill the queue while this batch is on its way out.
+        mQueuedLines.fetch_sub(static_cast<std::size_t>(count), std::memory_order_relaxed);
+        mQueuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+
+        std::string  block;
+        ConsoleColor color = oldestFirst->color;
+        while (oldestFirst != nullptr) {
+            if (oldestFirst->color != color) {
+                emit(color, block);
+                block.clear();
+                color = oldestFirst->color;
+            }
+            block += oldestFirst->text;
+            block += '\n';
+            delete std::exchange(oldestFirst, oldestFirst->next);
+        }
+        emit(color, block);
+
+        if (dropped != mReported) {
+            emit(
+                ConsoleColor::Yellow,
+                "[MCDK] Console is falling behind; dropped " + std::to_string(dropped - mReported) + " line(s)\n"
+            );
+            mReported = dropped;
+        }
+
+        mWritten.fetch_add(count, std::memory_order_release);
+        mWritten.notify_all();
+    }
+
+    void ConsoleWriter::emit(ConsoleColor color, std::string_view text) {
+        try {
+            mSink(color, text);
+        } catch (...) {
+            // A failing terminal must not take the writer thread (and with it the process) down.
+        }
+        mRuns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ConsoleWriter& consoleWriter() {
+        static ConsoleWriter writer(writeConsoleRun);
+        return writer;
+    }
+
+} // namespace mcdk
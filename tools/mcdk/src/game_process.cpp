@@ -15,7 +15,6 @@
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <regex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -27,6 +26,7 @@
 // mcdk modules
 #include <config.hpp>
 #include <console.hpp>
+#include <console_writer.hpp>
 #include <env.hpp>
 #include <hotreload.hpp>
 #include <host_bridge.hpp>
@@ -34,17 +34,21 @@
 #include <jsonui_reload_support.hpp>
 #include <level.hpp>
 #include <log_buffer.hpp>
+#include <log_classifier.hpp>
+#include <log_collapse.hpp>
+#include <log_spool.hpp>
 #include <material_reload_support.hpp>
 #include <mcp_server.hpp>
 #include <mod_dir_config.hpp>
 #include <mod_register.hpp>
+#include <output_capture.hpp>
 #include <particle_reload_support.hpp>
 #include <performance/profiler_runtime_owner.hpp>
 #include <performance/profiler_service_factory.hpp>
 #include <mc_profiler_mcp.hpp>
 #include <shader_reload_support.hpp>
 #include <style_processor.hpp>
-#include <utils.hpp>
+#include <traceback_aggregator.hpp>
 #include <world_project.hpp>
 
 
@@ -58,15 +62,6 @@
 #include <nlohmann/json.hpp>
 
 
-// 默认使用"\n"而非std::endl输出日志，避免大量log的性能开销
-#define _MCDEV_LOG_OUTPUT_ENDL "\n"
-
-#ifdef MCDEV_LOG_FORCE_FLUSH_ENDL
-// 强制使用std::endl
-#undef _MCDEV_LOG_OUTPUT_ENDL
-#define _MCDEV_LOG_OUTPUT_ENDL std::endl
-#endif
-
 #ifdef _WIN32
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
@@ -134,219 +129,35 @@ using mcdk::UserModDirConfig;
 using mcdk::UserStyleProcessor;
 using ConsoleColor = mcdk::ConsoleColor;
 
-static std::mutex g_consoleMutex;
-
-// 线程安全彩色输出
-void mcdk::printColoredAtomic(const std::string& msg, ConsoleColor color) {
-    std::lock_guard<std::mutex> lk(g_consoleMutex);
-    HANDLE                      hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-
-    if (hConsole == INVALID_HANDLE_VALUE) {
-        std::cout << msg << _MCDEV_LOG_OUTPUT_ENDL;
-        return;
-    }
-
-    CONSOLE_SCREEN_BUFFER_INFO info;
-    if (!GetConsoleScreenBufferInfo(hConsole, &info)) {
-        std::cout << msg << _MCDEV_LOG_OUTPUT_ENDL;
-        return;
-    }
-
-    WORD attr = 0;
-
-    switch (color) {
-    case ConsoleColor::Green:
-        attr = FOREGROUND_GREEN | FOREGROUND_INTENSITY;
-        break;
-    case ConsoleColor::Red:
-        attr = FOREGROUND_RED | FOREGROUND_INTENSITY;
-        break;
-    case ConsoleColor::Blue:
-        attr = FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-        break;
-    case ConsoleColor::Yellow:
-        attr = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
-        break;
-    case ConsoleColor::Cyan:
-        attr = FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-        break;
-    case ConsoleColor::Magenta:
-        attr = FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-        break;
-    case ConsoleColor::White:
-        attr = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY;
-        break;
-    case ConsoleColor::Black:
-        attr = 0;
-        break;
-    case ConsoleColor::Gray:
-        // 亮灰 = RGB，但不加高亮
-        attr = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
-        break;
-    case ConsoleColor::DarkGray:
-        // 深灰 = 只加高亮，不加 RGB
-        attr = FOREGROUND_INTENSITY;
-        break;
-    default:
-        break;
-    }
-
-    if (color != ConsoleColor::Default) {
-        SetConsoleTextAttribute(hConsole, attr);
-    }
-
-    std::cout << msg << _MCDEV_LOG_OUTPUT_ENDL;
-
-    if (color == ConsoleColor::Default) {
-        return;
-    }
-    // 恢复原色
-    SetConsoleTextAttribute(hConsole, info.wAttributes);
+// 彩色输出交给独立写线程，调用方（管道读线程等）不会被慢终端阻塞
+void mcdk::printColoredAtomic(std::string_view msg, ConsoleColor color) {
+    mcdk::consoleWriter().write(std::string(msg), color);
 }
 
 void mcdk::printStartupLogo(bool pluginEnv) {
-    std::cout << _MCDEV_LOG_OUTPUT_ENDL;
-    std::cout << "  ███╗   ███╗ ██████╗ ██████╗ ██╗  ██╗\n"
-              << "  ████╗ ████║██╔════╝ ██╔══██╗██║ ██╔╝\n"
-              << "  ██╔████╔██║██║      ██║  ██║█████╔╝\n"
-              << "  ██║╚██╔╝██║██║      ██║  ██║██╔═██╗\n"
-              << "  ██║ ╚═╝ ██║╚██████╗ ██████╔╝██║  ██╗\n"
-              << "  ╚═╝     ╚═╝ ╚═════╝ ╚═════╝ ╚═╝  ╚═╝" << _MCDEV_LOG_OUTPUT_ENDL;
+    printColoredAtomic(
+        "\n"
+        "  ███╗   ███╗ ██████╗ ██████╗ ██╗  ██╗\n"
+        "  ████╗ ████║██╔════╝ ██╔══██╗██║ ██╔╝\n"
+        "  ██╔████╔██║██║      ██║  ██║█████╔╝\n"
+        "  ██║╚██╔╝██║██║      ██║  ██║██╔═██╗\n"
+        "  ██║ ╚═╝ ██║╚██████╗ ██████╔╝██║  ██╗\n"
+        "  ╚═╝     ╚═╝ ╚═════╝ ╚═════╝ ╚═╝  ╚═╝",
+        ConsoleColor::Default
+    );
     printColoredAtomic("  Minecraft Creator Development Kit", ConsoleColor::DarkGray);
     if (pluginEnv) {
         printColoredAtomic("  Kid Studio Core Tool · VSCode Extension: Dofes, Zero123", ConsoleColor::DarkGray);
     } else {
         printColoredAtomic("  Kid Studio Core Tool", ConsoleColor::DarkGray);
     }
-    std::cout << _MCDEV_LOG_OUTPUT_ENDL;
-}
-
-// 进程buffer行处理
-static void processBufferAppend(
-    std::string&                                   lineBuf,
-    const char*                                    buf,
-    size_t                                         len,
-    bool                                           filterPython,
-    const std::function<void(std::string)>&        processLine
-) {
-    lineBuf.append(buf, len);
-
-    size_t consumed = 0;
-    size_t pos      = 0;
-    while ((pos = lineBuf.find('\n', consumed)) != std::string::npos) {
-        std::string line = lineBuf.substr(consumed, pos - consumed);
-        consumed         = pos + 1;
-
-        // 去除行尾可能存在的 '\r'
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
-        }
-
-        // 过滤：若启用只保留 [Python] 则丢弃其它
-        if (filterPython && line.find("[Python] ") == std::string::npos) continue;
-
-        processLine(std::move(line));
-    }
-    if (consumed != 0) {
-        // Remove all completed lines once instead of shifting the string after every newline.
-        lineBuf.erase(0, consumed);
-    }
+    printColoredAtomic("", ConsoleColor::Default);
+    // 后续配置解析仍直接写 std::cout，先让 logo 落地以保证顺序
+    mcdk::consoleWriter().flush();
 }
 
 #ifdef _WIN32
 
-// pipe线程处理函数
-static void
-readPipeThread(HANDLE hPipe, bool filterPython, const std::function<void(std::string)>& processLine) {
-    constexpr DWORD   BUFSZ = 4096;
-    std::string       lineBuf;
-    std::vector<char> buffer(BUFSZ);
-
-    while (true) {
-        DWORD bytesRead = 0;
-        BOOL  ok        = ReadFile(hPipe, buffer.data(), BUFSZ, &bytesRead, NULL);
-        if (!ok) {
-            DWORD err = GetLastError();
-            // ERROR_BROKEN_PIPE (109) 表示写端已关闭并读尽
-            if (err == ERROR_BROKEN_PIPE) {
-                // 处理残留并退出
-                if (!lineBuf.empty()) {
-                    // 没有换行但还有内容，作为最后一行处理
-                    std::string lastLine = lineBuf;
-                    if (!lastLine.empty() && lastLine.back() == '\r') lastLine.pop_back();
-                    if (!(filterPython && lastLine.find("[Python] ") == std::string::npos)) {
-                        processLine(std::move(lastLine));
-                    }
-                    lineBuf.clear();
-                }
-                break;
-            } else {
-                // 其它错误直接退出
-                break;
-            }
-        }
-
-        if (bytesRead == 0) {
-            // 管道关闭或无数据（通常与 ERROR_BROKEN_PIPE 一致）
-            // 处理残留并退出
-            if (!lineBuf.empty()) {
-                std::string lastLine = lineBuf;
-                if (!lastLine.empty() && lastLine.back() == '\r') lastLine.pop_back();
-                if (!(filterPython && lastLine.find("[Python] ") == std::string::npos)) {
-                    processLine(std::move(lastLine));
-                }
-                lineBuf.clear();
-            }
-            break;
-        }
-
-        // 追加并按行处理（会把完整行交给 processLine，残留留在 lineBuf）
-        processBufferAppend(lineBuf, buffer.data(), bytesRead, filterPython, processLine);
-    }
-}
-
-namespace {
-    class PipeReaderThreads {
-    public:
-        ~PipeReaderThreads() {
-            // On exceptional exit, cancel blocking ReadFile calls before joining so thread destruction cannot terminate.
-            cancelAndJoin(mStdout);
-            cancelAndJoin(mStderr);
-        }
-
-        void start(
-            HANDLE                                  stdoutPipe,
-            HANDLE                                  stderrPipe,
-            bool                                    filterPython,
-            const std::function<void(std::string)>& stdoutCallback,
-            const std::function<void(std::string)>& stderrCallback
-        ) {
-            mStdout = std::thread(readPipeThread, stdoutPipe, filterPython, stdoutCallback);
-            mStderr = std::thread(readPipeThread, stderrPipe, filterPython, stderrCallback);
-        }
-
-        void join() {
-            if (mStdout.joinable()) mStdout.join();
-            if (mStderr.joinable()) mStderr.join();
-        }
-
-    private:
-        static void cancelAndJoin(std::thread& thread) noexcept {
-            if (!thread.joinable()) return;
-            CancelSynchronousIo(thread.native_handle());
-            try {
-                thread.join();
-            } catch (...) {
-                // A destructor must not terminate while unwinding; detaching is the last-resort valid thread state.
-                thread.detach();
-            }
-        }
-
-        std::thread mStdout;
-        std::thread mStderr;
-    };
-} // namespace
-
 // 尝试附加调试器到指定进程
 static void debuggerAttachToProcess(DWORD pid, int port) {
     // 执行cmd调用mcdbg.exe附加（如果失败则输出错误信息）
@@ -360,13 +171,16 @@ static void debuggerAttachToProcess(DWORD pid, int port) {
     STARTUPINFOA        si = {sizeof(si)};
     PROCESS_INFORMATION pi = {};
     if (!CreateProcessA(nullptr, cmd.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi)) {
-        std::cerr << "警告：无法启动mcdbg.exe附加调试器，请确保其在环境变量路径中。" << _MCDEV_LOG_OUTPUT_ENDL;
+        printColoredAtomic("警告：无法启动mcdbg.exe附加调试器，请确保其在环境变量路径中。", ConsoleColor::Yellow);
         return;
     }
     // The debugger process continues independently; only its duplicated handles belong to this launcher.
     UniqueHandle debuggerProcess(pi.hProcess);
     UniqueHandle debuggerThread(pi.hThread);
-    std::cout << "调试器已启动，正在附加到进程PID：" << pid << " 端口：" << port << " ..." << _MCDEV_LOG_OUTPUT_ENDL;
+    printColoredAtomic(
+        "调试器已启动，正在附加到进程PID：" + std::to_string(pid) + " 端口：" + std::to_string(port) + " ...",
+        ConsoleColor::Default
+    );
 }
 
 // 将utf8的string转换为utf16的wstring
@@ -479,9 +293,20 @@ void mcdk::launchGameExe(
     auto ipcServer = MCDevTool::Debug::createDebugServer();
     auto logBuffer = std::make_shared<mcdk::LogBuffer>(1000, 250);
     auto errBuffer = std::make_shared<mcdk::LogBuffer>(1000, 400);
+    auto tracebacks = std::make_shared<mcdk::TracebackAggregator>();
+    // 连续重复行折叠（可选）：控制台与日志缓冲只保留首行和一条带计数的汇总行
+    std::shared_ptr<mcdk::LogFloodCollapser> stdoutCollapser;
+    std::shared_ptr<mcdk::LogFloodCollapser> stderrCollapser;
+    std::shared_ptr<mcdk::LogSpool>          rawSpool;
+    std::shared_ptr<mcdk::LogSpool>          rawErrorSpool;
+    if (userConfig.logCollapse.enabled) {
+        const mcdk::LogCollapseOptions collapseOptions{.maskNumbers = userConfig.logCollapse.maskNumbers};
+        stdoutCollapser = std::make_shared<mcdk::LogFloodCollapser>(collapseOptions);
+        stderrCollapser = std::make_shared<mcdk::LogFloodCollapser>(collapseOptions);
+    }
     auto profilerGamePid = std::make_shared<std::atomic<std::uint32_t>>(0);
     auto profilerRuntime = std::make_shared<mcdk::performance::ProfilerRuntimeOwner>(
-        [ipcServer, profilerGamePid, storageRoot = std::filesystem::current_path() / ".mcdev" / "profiles"] {
+        [ipcServer, profilerGamePid, logBuffer, storageRoot = std::filesystem::current_path() / ".mcdev" / "profiles"] {
             return mcdk::performance::createProfilerService({
                 .executeCode = [ipcServer](
                     std::string code,
@@ -517,6 +342,17 @@ void mcdk::launchGameExe(
                 .storageRoot = storageRoot,
                 .executableDirectory = currentExecutableDirectory(),
                 .memoryIdleTimeout = std::chrono::minutes(20),
+                .readGameLog = [logBuffer](std::uint64_t cursor, std::size_t maxLines) {
+                    const auto since = logBuffer->getSince(cursor, maxLines);
+                    mcdk::performance::GameLogBatch batch{
+                        .nextCursor = since.nextCursor,
+                        .dropped    = since.dropped,
+                        .hasMore    = since.hasMore,
+                    };
+                    batch.lines.reserve(since.lines.size());
+                    for (const auto line : since.lines.lines) batch.lines.emplace_back(line);
+                    return batch;
+                },
             });
         }
     );
@@ -529,8 +365,45 @@ void mcdk::launchGameExe(
             "[MCDK] MCP Server " + mcpServerConfig.serverIp + ":" + std::to_string(mcpServerConfig.serverPort),
             ConsoleColor::Green
         );
+        // 日志检索索引只在MCP可用时维护，避免普通运行时的额外开销
+        logBuffer->enableSearchIndex();
+        errBuffer->enableSearchIndex();
+        // 完整会话日志落盘到 .mcdev/logs/<会话>（stdout 在会话根目录，stderr 在 error/），内存缓冲淘汰的行
+        // 仍可通过 get_logs_since 读取。单个会话的各流按段数封顶，历史会话按个数与总字节数一起裁剪
+        const auto logRoot = std::filesystem::current_path() / ".mcdev" / "logs";
+        const mcdk::LogSpoolOptions streamSpool{.maxSegments = 16};
+        const mcdk::LogSpoolOptions errorSpool{.maxSegments = 4};
+        if (auto spool = mcdk::LogSpool::createSession(logRoot, {}, streamSpool)) {
+            if (auto error = mcdk::LogSpool::open((*spool)->directory() / "error", errorSpool)) {
+                errBuffer->attachSpool(std::move(*error));
+            } else {
+                printColoredAtomic("[MCDK] Error log spool disabled: " + error.error(), ConsoleColor::Yellow);
+            }
+            if (stdoutCollapser) {
+                // 会话 spool 与内存缓冲一致（已折叠），两条流折叠前的全部原始行另存到 raw/ 与 error/raw/
+                if (auto raw = mcdk::LogSpool::open((*spool)->directory() / "raw", streamSpool)) {
+                    rawSpool = std::move(*raw);
+                } else {
+                    printColoredAtomic("[MCDK] Raw log spool disabled: " + raw.error(), ConsoleColor::Yellow);
+                }
+                if (auto raw = mcdk::LogSpool::open((*spool)->directory() / "error" / "raw", errorSpool)) {
+                    rawErrorSpool = std::move(*raw);
+                } else {
+                    printColoredAtomic("[MCDK] Raw error log spool disabled: " + raw.error(), ConsoleColor::Yellow);
+                }
+            }
+            printColoredAtomic(
+                "[MCDK] Log spool " + (*spool)->directory().string() + " ("
+                    + std::to_string(mcdk::LogSpool::diskUsage(logRoot) / (1024 * 1024)) + " MiB kept on disk)",
+                ConsoleColor::Green
+            );
+            logBuffer->attachSpool(std::move(*spool));
+        } else {
+            printColoredAtomic("[MCDK] Log spool disabled: " + spool.error(), ConsoleColor::Yellow);
+        }
         mcpServer.setLogBuffer(logBuffer);
         mcpServer.setErrBuffer(errBuffer);
+        mcpServer.setTracebackAggregator(tracebacks);
         mcpServer.setProfilerHandler([profilerRuntime](const nlohmann::json& arguments) {
             return mcdk::mc_profiler_mcp::handleRuntimeRequest(profilerRuntime->provider(), arguments);
         });
@@ -1155,71 +1028,88 @@ void mcdk::launchGameExe(
     errWrite.reset();
 
     // 输出处理回调
-    auto processStdout = [needLogBuffer, logBuffer](std::string line) {
-        // 屏蔽 Engine 噪音行
-        if (line.find(" [INFO][Engine] ") != std::string::npos) {
+    auto printStdout = [needLogBuffer, logBuffer](std::string_view line, mcdk::LogLineKind kind) {
+        // 特殊标记行按类别着色
+        switch (kind) {
+        case mcdk::LogLineKind::EngineNoise:
             return;
-        }
-        // 特殊标记行处理
-        if (line.find("[INFO][Developer]") != std::string::npos) {
+        case mcdk::LogLineKind::Developer:
             printColoredAtomic(line, ConsoleColor::DarkGray);
             return;
-        } else if (mcdk::containsIgnoreCase(line, "SUC")) {
+        case mcdk::LogLineKind::Success:
             printColoredAtomic(line, ConsoleColor::Green);
             return;
-        } else if (mcdk::containsIgnoreCase(line, "ERROR")) {
+        case mcdk::LogLineKind::Error:
             printColoredAtomic(line, ConsoleColor::Red);
             return;
-        } else if (mcdk::containsIgnoreCase(line, "WARN")) {
+        case mcdk::LogLineKind::Warning:
             printColoredAtomic(line, ConsoleColor::Yellow);
             return;
-        } else if (mcdk::containsIgnoreCase(line, "DEBUG")) {
+        case mcdk::LogLineKind::Debug:
             printColoredAtomic(line, ConsoleColor::Cyan);
             return;
+        case mcdk::LogLineKind::Plain:
+            break;
         }
         printColoredAtomic(line, ConsoleColor::Default);
         if (needLogBuffer) {
-            // The callback owns the line, so transfer it into the log buffer without an extra string copy.
-            logBuffer->add(std::move(line));
+            logBuffer->add(line);
+        }
+    };
+    auto processStdout = [printStdout, stdoutCollapser, rawSpool](std::string_view line) {
+        // 单次扫描识别所有标记：屏蔽 Engine 噪音行
+        const auto kind = mcdk::logLineClassifier().classify(line);
+        if (kind == mcdk::LogLineKind::EngineNoise) {
+            return;
+        }
+        if (!stdoutCollapser) {
+            printStdout(line, kind);
+            return;
+        }
+        // 折叠前落盘：任何类别的行（包括随后被折叠或汇总的行）都完整保留在 raw/
+        if (rawSpool) {
+            rawSpool->append(line);
+        }
+        const auto collapsed = stdoutCollapser->feed(line);
+        if (collapsed.summary) {
+            printStdout(*collapsed.summary, mcdk::logLineClassifier().classify(*collapsed.summary));
+        }
+        if (collapsed.emitLine) {
+            printStdout(line, kind);
         }
     };
 
     // stderr 处理回调
-    auto processStderr = [needLogBuffer, logBuffer, errBuffer](std::string line) {
-        static std::regex fileRe(R"(File \"([A-Za-z0-9_\.]+)\", line (\d+))");
-
-        std::string out;
-        out.reserve(line.size());
-
-        std::sregex_iterator cur(line.begin(), line.end(), fileRe);
-        std::sregex_iterator end;
-
-        size_t lastPos = 0;
-
-        for (; cur != end; ++cur) {
-            const std::smatch& m = *cur;
-
-            // 追加前面的普通内容
-            out.append(line, lastPos, m.position() - lastPos);
-
-            // 动态构造替换内容
-            std::string dotted  = m[1].str();
-            std::string slashed = dotted;
-            std::replace(slashed.begin(), slashed.end(), '.', '/');
-            slashed += ".py";
-
-            out += "File \"" + slashed + "\", line " + m[2].str();
-
-            lastPos = m.position() + m.length();
+    auto printStderr = [needLogBuffer, logBuffer, errBuffer](std::string_view line) {
+        printColoredAtomic(line, ConsoleColor::Red);
+        if (needLogBuffer) {
+            logBuffer->add(line);
+            errBuffer->add(line);
         }
+    };
+    auto processStderr = [printStderr, needLogBuffer, tracebacks, stderrCollapser, rawErrorSpool](
+                             std::string_view line
+                         ) {
+        // 将 File "a.b.c", line N 改写为 File "a/b/c.py", line N
+        const std::string out = mcdk::rewriteTracebackFileNames(line);
 
-        // 拼接剩余部分
-        out.append(line, lastPos);
-
-        printColoredAtomic(out, ConsoleColor::Red);
         if (needLogBuffer) {
-            logBuffer->add(out);
-            errBuffer->add(std::move(out));
+            // 逐行解析 traceback，按异常签名聚合（始终使用折叠前的原始行）
+            tracebacks->feed(out);
+        }
+        if (!stderrCollapser) {
+            printStderr(out);
+            return;
+        }
+        if (rawErrorSpool) {
+            rawErrorSpool->append(out);
+        }
+        const auto collapsed = stderrCollapser->feed(out);
+        if (collapsed.summary) {
+            printStderr(*collapsed.summary);
+        }
+        if (collapsed.emitLine) {
+            printStderr(out);
         }
     };
 
@@ -1234,9 +1124,9 @@ void mcdk::launchGameExe(
         }
     }
 
-    // 启动两个线程并行读取（避免任何死锁）
-    PipeReaderThreads pipeReaders;
-    pipeReaders.start(outRead.get(), errRead.get(), filterPython, processStdout, processStderr);
+    // 并行读取 stdout/stderr（避免任何死锁），行以视图形式交给回调，读取路径不按行分配内存
+    mcdk::OutputCapture pipeReaders({.filterPython = filterPython});
+    pipeReaders.start(outRead.get(), errRead.get(), processStdout, processStderr);
 
     if (debuggerPort > 0) {
         // 尝试启动mcdbg调试器附加（在官方调试器之前的历史产物）
@@ -1244,53 +1134,71 @@ void mcdk::launchGameExe(
     }
 
     if (enableAnyHotReload && modDirList != nullptr) {
-        std::cout << "[HotReload] Watchers\n";
+        const MCDevTool::HotReload::WatchOptions watchOptions{.excludeGlobs = userConfig.hotReload.excludeGlobs};
+        printColoredAtomic("[HotReload] Watchers", ConsoleColor::Default);
         if (modDirList) {
             for (const auto& modDirConfig : *modDirList) {
                 if (modDirConfig.hotReload) {
-                    std::cout << "  Mods     " << modDirConfig.getAbsoluteU8String() << "\n";
+                    printColoredAtomic("  Mods     " + modDirConfig.getAbsoluteU8String(), ConsoleColor::Default);
                 }
             }
         }
+        for (const auto& glob : watchOptions.excludeGlobs) {
+            printColoredAtomic("  Exclude  " + glob, ConsoleColor::Default);
+        }
 
         if (enablePyHotReload) {
             pyReloadTask.setProcessId(pid);
+            pyReloadTask.setWatchOptions(watchOptions);
             pyReloadTask.setModDirs(std::vector<std::filesystem::path>(hotReloadDirs));
             pyReloadTask.start();
         }
 
         if (enableUiHotReload && !hotReloadUiDirs.empty()) {
             for (const auto& uiDir : hotReloadUiDirs) {
-                std::cout << "  JsonUi   " << MCDevTool::Utils::pathToGenericUtf8(uiDir) << "\n";
+                printColoredAtomic("  JsonUi   " + MCDevTool::Utils::pathToGenericUtf8(uiDir), ConsoleColor::Default);
             }
             uiReloadTask.setProcessId(pid);
+            uiReloadTask.setWatchOptions(watchOptions);
             uiReloadTask.setModDirs(std::move(hotReloadUiDirs));
             uiReloadTask.start();
         }
 
         if (enableShaderHotReload && !hotReloadShaderDirs.empty()) {
             for (const auto& shaderDir : hotReloadShaderDirs) {
-                std::cout << "  Shaders  " << MCDevTool::Utils::pathToGenericUtf8(shaderDir) << "\n";
+                printColoredAtomic(
+                    "  Shaders  " + MCDevTool::Utils::pathToGenericUtf8(shaderDir),
+                    ConsoleColor::Default
+                );
             }
             shaderReloadTask.setProcessId(pid);
+            shaderReloadTask.setWatchOptions(watchOptions);
             shaderReloadTask.setModDirs(std::move(hotReloadShaderDirs));
             shaderReloadTask.start();
         }
 
         if (enableMaterialHotReload && !hotReloadMaterialDirs.empty()) {
             for (const auto& materialDir : hotReloadMaterialDirs) {
-                std::cout << "  Material " << MCDevTool::Utils::pathToGenericUtf8(materialDir) << "\n";
+                printColoredAtomic(
+                    "  Material " + MCDevTool::Utils::pathToGenericUtf8(materialDir),
+                    ConsoleColor::Default
+                );
             }
             materialReloadTask.setProcessId(pid);
+            materialReloadTask.setWatchOptions(watchOptions);
             materialReloadTask.setModDirs(std::move(hotReloadMaterialDirs));
             materialReloadTask.start();
         }
 
         if (enableParticleHotReload && !hotReloadParticleDirs.empty()) {
             for (const auto& particleDir : hotReloadParticleDirs) {
-                std::cout << "  Particle " << MCDevTool::Utils::pathToGenericUtf8(particleDir) << "\n";
+                printColoredAtomic(
+                    "  Particle " + MCDevTool::Utils::pathToGenericUtf8(particleDir),
+                    ConsoleColor::Default
+                );
             }
             particleReloadTask.setProcessId(pid);
+            particleReloadTask.setWatchOptions(watchOptions);
             particleReloadTask.setModDirs(std::move(hotReloadParticleDirs));
             particleReloadTask.start();
         }
@@ -1299,7 +1207,20 @@ void mcdk::launchGameExe(
 
     // 等待子进程退出（子进程退出后会关闭写端，使 ReadFile 返回
     // ERROR_BROKEN_PIPE）
-    WaitForSingleObject(processHandle.get(), INFINITE);
+    if (stdoutCollapser) {
+        // 折叠开启时定期唤醒：重复行停止后及时输出暂存的汇总行，而不是等到下一条不同的日志
+        while (WaitForSingleObject(processHandle.get(), 250) == WAIT_TIMEOUT) {
+            const auto now   = std::chrono::system_clock::now().time_since_epoch();
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+            // 在折叠器锁内输出：读线程此时送入的新行只能排在汇总行之后
+            stdoutCollapser->flushIdle(nowMs, [&](std::string_view summary) {
+                printStdout(summary, mcdk::logLineClassifier().classify(summary));
+            });
+            stderrCollapser->flushIdle(nowMs, printStderr);
+        }
+    } else {
+        WaitForSingleObject(processHandle.get(), INFINITE);
+    }
 
     DWORD minecraftExitCode = 0;
     if (!GetExitCodeProcess(processHandle.get(), &minecraftExitCode)) {
@@ -1325,6 +1246,16 @@ void mcdk::launchGameExe(
 
     // 等待读线程退出并关闭读端句柄
     pipeReaders.join();
+    if (stdoutCollapser) {
+        if (const auto summary = stdoutCollapser->flush()) {
+            printStdout(*summary, mcdk::logLineClassifier().classify(*summary));
+        }
+        if (const auto summary = stderrCollapser->flush()) {
+            printStderr(*summary);
+        }
+    }
+    // 返回前写完积压的控制台输出
+    mcdk::consoleWriter().flush();
 }
 
 #endif
@@ -1,62 +1,394 @@
 #include <log_buffer.hpp>
 
+#include <log_spool.hpp>
+
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
 #include <utility>
 
 namespace mcdk {
 
+    namespace {
+        constexpr std::uint32_t NO_CHUNK   = std::numeric_limits<std::uint32_t>::max();
+        constexpr std::uint32_t CHUNK_SIZE = 32 * 1024;
+    } // namespace
+
     LogBuffer::LogBuffer(std::size_t capacity, std::size_t clearBatchSize)
-    : mCapacity(capacity),
-      mClearBatchSize(clearBatchSize) {}
+    : mRing(capacity + 1),
+      mActiveChunk(NO_CHUNK),
+      mCapacity(capacity),
+      mClearBatchSize(std::max<std::size_t>(clearBatchSize, 1)) {}
+
+    std::uint32_t LogBuffer::acquireChunk(std::uint32_t length) {
+        const auto    required = std::max(length, CHUNK_SIZE);
+        std::uint32_t chunk    = NO_CHUNK;
+        if (!mFreeChunks.empty()) {
+            chunk = mFreeChunks.back();
+            mFreeChunks.pop_back();
+        } else {
+            chunk = static_cast<std::uint32_t>(mChunks.size());
+            mChunks.emplace_back();
+        }
+        auto& target = mChunks[chunk];
+        if (target.capacity < required) {
+            target.data     = std::make_unique_for_overwrite<char[]>(required);
+            target.capacity = required;
+        }
+        target.used      = 0;
+        target.liveLines = 0;
+        return chunk;
+    }
+
+    void LogBuffer::releaseChunk(std::uint32_t chunk) {
+        auto& target = mChunks[chunk];
+        // Oversized chunks only exist for a single huge line; do not pin that memory in the pool.
+        if (target.capacity > CHUNK_SIZE) {
+            target.data.reset();
+            target.capacity = 0;
+        }
+        target.used      = 0;
+        target.liveLines = 0;
+        mFreeChunks.push_back(chunk);
+    }
+
+    void LogBuffer::evictOldest(std::size_t count) {
+        for (std::size_t index = 0; index < count; ++index) {
+            const auto& record = mRing[mHead];
+            auto&       chunk  = mChunks[record.chunk];
+            if (--chunk.liveLines == 0 && record.chunk != mActiveChunk) {
+                releaseChunk(record.chunk);
+            }
+            mHead = (mHead + 1) % mRing.size();
+        }
+        mSize -= count;
+        if (mIndex) {
+            mIndex->evictBefore(mNextSequence - mSize, mSize);
+        }
+    }
+
+    void LogBuffer::add(std::string_view line) {
+        const auto length =
+            static_cast<std::uint32_t>(std::min<std::size_t>(line.size(), std::numeric_limits<std::uint32_t>::max()));
+        const auto now         = std::chrono::system_clock::now().time_since_epoch();
+        const auto timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
 
-    void LogBuffer::add(std::string line) {
         std::lock_guard lock(mMutex);
-        mBuffer.push_back(std::move(line));
-        if (mBuffer.size() > mCapacity) {
-            const auto count = std::min(mClearBatchSize, mBuffer.size());
-            for (std::size_t index = 0; index < count; ++index) {
-                mBuffer.pop_front();
+        if (mActiveChunk != NO_CHUNK) {
+            auto& active = mChunks[mActiveChunk];
+            if (active.liveLines == 0) {
+                active.used = 0;
+            }
+            if (active.capacity - active.used < length) {
+                if (active.liveLines == 0) {
+                    releaseChunk(mActiveChunk);
+                }
+                mActiveChunk = NO_CHUNK;
             }
         }
+        if (mActiveChunk == NO_CHUNK) {
+            mActiveChunk = acquireChunk(length);
+        }
+
+        auto& chunk = mChunks[mActiveChunk];
+        std::memcpy(chunk.data.get() + chunk.used, line.data(), length);
+        mRing[(mHead + mSize) % mRing.size()] = {
+            .chunk       = mActiveChunk,
+            .offset      = chunk.used,
+            .length      = length,
+            .timestampMs = timestampMs,
+        };
+        if (mIndex) {
+            mIndex->add(mNextSequence, std::string_view(chunk.data.get() + chunk.used, length));
+        }
+        if (mSpool) {
+            mSpool->append(mNextSequence, std::string_view(chunk.data.get() + chunk.used, length));
+        }
+        chunk.used += length;
+        ++chunk.liveLines;
+        ++mSize;
+        ++mNextSequence;
+
+        if (mSize > mCapacity) {
+            evictOldest(std::min(mClearBatchSize, mSize));
+        }
     }
 
     void LogBuffer::clear() {
         std::lock_guard lock(mMutex);
-        mBuffer.clear();
+        mHead        = 0;
+        mSize        = 0;
+        mActiveChunk = NO_CHUNK;
+        mFreeChunks.clear();
+        for (std::uint32_t chunk = 0; chunk < mChunks.size(); ++chunk) {
+            releaseChunk(chunk);
+        }
+        if (mIndex) {
+            mIndex->clear();
+        }
     }
 
-    std::vector<std::string> LogBuffer::getLatest(std::size_t maxCount) {
+    std::size_t LogBuffer::size() const {
         std::lock_guard lock(mMutex);
-        if (maxCount >= mBuffer.size()) {
-            // Keep deque as the internal eviction-friendly storage while preserving the vector-based public API.
-            return std::vector<std::string>(mBuffer.begin(), mBuffer.end());
-        }
-        return std::vector<std::string>(
-            mBuffer.end() - static_cast<std::ptrdiff_t>(maxCount),
-            mBuffer.end()
-        );
+        return mSize;
     }
 
-    std::vector<std::string> LogBuffer::getLatestReversed(std::size_t maxCount) {
-        auto result = getLatest(maxCount);
-        std::ranges::reverse(result);
+    std::uint64_t LogBuffer::latestSequence() const {
+        std::lock_guard lock(mMutex);
+        return mNextSequence - 1;
+    }
+
+    LogLines LogBuffer::copyLines(std::size_t first, std::size_t count, bool reversed) const {
+        LogLines result;
+        result.firstSequence = mNextSequence - mSize + first;
+        result.reversed      = reversed;
+        if (count == 0) {
+            return result;
+        }
+
+        std::size_t totalBytes = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            totalBytes += mRing[(mHead + first + index) % mRing.size()].length;
+        }
+        result.text = std::make_unique_for_overwrite<char[]>(std::max<std::size_t>(totalBytes, 1));
+        result.lines.resize(count);
+
+        char* output = result.text.get();
+        for (std::size_t index = 0; index < count; ++index) {
+            const auto& record = mRing[(mHead + first + index) % mRing.size()];
+            std::memcpy(output, mChunks[record.chunk].data.get() + record.offset, record.length);
+            result.lines[reversed ? count - 1 - index : index] = std::string_view(output, record.length);
+            output += record.length;
+        }
         return result;
     }
 
-    std::vector<std::string> LogBuffer::getRange(std::size_t index, std::size_t endIndex) {
+    LogLines LogBuffer::getLatest(std::size_t maxCount) const {
+        std::lock_guard lock(mMutex);
+        const auto      count = std::min(maxCount, mSize);
+        return copyLines(mSize - count, count, false);
+    }
+
+    LogLines LogBuffer::getLatestReversed(std::size_t maxCount) const {
+        std::lock_guard lock(mMutex);
+        const auto      count = std::min(maxCount, mSize);
+        return copyLines(mSize - count, count, true);
+    }
+
+    LogLines LogBuffer::getRange(std::size_t index, std::size_t endIndex) const {
+        std::lock_guard lock(mMutex);
+        if (mSize == 0 || index >= mSize || endIndex > mSize || index >= endIndex) {
+            return {};
+        }
+        return copyLines(mSize - endIndex, endIndex - index, false);
+    }
+
+    LogLines LogBuffer::getRangeReversed(std::size_t index, std::size_t endIndex) const {
         std::lock_guard lock(mMutex);
-        if (mBuffer.empty() || index >= mBuffer.size() || endIndex > mBuffer.size() || index >= endIndex) {
+        if (mSize == 0 || index >= mSize || endIndex > mSize || index >= endIndex) {
             return {};
         }
-        return std::vector<std::string>(
-            mBuffer.end() - static_cast<std::ptrdiff_t>(endIndex),
-            mBuffer.end() - static_cast<std::ptrdiff_t>(index)
-        );
+        return copyLines(mSize - endIndex, endIndex - index, true);
+    }
+
+    LogSinceResult LogBuffer::getSince(std::uint64_t cursor, std::size_t maxCount) const {
+        std::unique_lock lock(mMutex);
+        const auto       latest = mNextSequence - 1;
+        const auto       oldest = mNextSequence - mSize;
+
+        LogSinceResult result;
+        if (cursor >= latest) {
+            // Nothing new, or a cursor from another session: resynchronize to the current tail.
+            result.lines.firstSequence = mNextSequence;
+            result.nextCursor          = latest;
+            return result;
+        }
+
+        if (mSpool && cursor + 1 < oldest && maxCount > 0) {
+            // The spool never rewrites lines older than the in-memory window, so it can be read without our lock.
+            const auto spool = mSpool;
+            lock.unlock();
+            const auto spoolOldest = spool->oldestSequence();
+            if (spoolOldest != 0 && spoolOldest < oldest) {
+                const auto first = std::max(cursor + 1, spoolOldest);
+                const auto count = std::min<std::uint64_t>(maxCount, oldest - first);
+                result.lines     = spool->read(first, static_cast<std::size_t>(count));
+                if (!result.lines.empty()) {
+                    result.dropped    = first - (cursor + 1);
+                    result.nextCursor = first + result.lines.size() - 1;
+                    result.hasMore    = result.nextCursor < latest;
+                    return result;
+                }
+            }
+            lock.lock();
+        }
+
+        // Re-read the window: other threads may have added (and evicted) lines while the lock was released.
+        const auto tail   = mNextSequence - mSize;
+        const auto first  = std::max(cursor + 1, tail);
+        const auto count  = std::min<std::uint64_t>(maxCount, mNextSequence - first);
+        result            = {};
+        result.dropped    = first - (cursor + 1);
+        result.lines      = copyLines(static_cast<std::size_t>(first - tail), static_cast<std::size_t>(count), false);
+        result.nextCursor = first + count - 1;
+        result.hasMore    = result.nextCursor < mNextSequence - 1;
+        return result;
+    }
+
+    void LogBuffer::attachSpool(std::shared_ptr<LogSpool> spool) {
+        std::lock_guard lock(mMutex);
+        mSpool = std::move(spool);
+    }
+
+    const LogBuffer::LineRecord& LogBuffer::recordAt(std::uint64_t sequence) const {
+        return mRing[(mHead + static_cast<std::size_t>(sequence - (mNextSequence - mSize))) % mRing.size()];
+    }
+
+    std::string_view LogBuffer::lineAt(const LineRecord& record) const {
+        return {mChunks[record.chunk].data.get() + record.offset, record.length};
+    }
+
+    void LogBuffer::enableSearchIndex() {
+        std::lock_guard lock(mMutex);
+        if (mIndex) {
+            return;
+        }
+        mIndex           = std::make_unique<LogTrigramIndex>();
+        const auto first = mNextSequence - mSize;
+        for (auto sequence = first; sequence < mNextSequence; ++sequence) {
+            mIndex->add(sequence, lineAt(recordAt(sequence)));
+        }
+        mIndex->evictBefore(first, mSize);
     }
 
-    std::vector<std::string> LogBuffer::getRangeReversed(std::size_t index, std::size_t endIndex) {
-        auto result = getRange(index, endIndex);
-        std::ranges::reverse(result);
+    std::expected<LogSearchResult, std::string> LogBuffer::search(const LogSearchQuery& query) const {
+        auto matcher = LogMatcher::compile(query);
+        if (!matcher) {
+            return std::unexpected(std::move(matcher.error()));
+        }
+
+        // Only the candidates are copied under the lock; level detection and the pattern, possibly a regex, run after
+        // it is released so that add() on the pipe-reader thread is never held up by a slow query.
+        struct Candidate {
+            std::uint64_t sequence    = 0;
+            std::int64_t  timestampMs = 0;
+            std::size_t   offset      = 0;
+            std::uint32_t length      = 0;
+        };
+        LogSearchResult        result;
+        std::vector<Candidate> snapshot;
+        std::string            text;
+        std::uint64_t          oldest = 0;
+        std::uint64_t          latest = 0;
+        {
+            std::lock_guard lock(mMutex);
+            if (mSize == 0 || query.maxMatches == 0) {
+                return result;
+            }
+            oldest = mNextSequence - mSize;
+            latest = mNextSequence - 1;
+
+            std::optional<std::vector<std::uint64_t>> candidates;
+            if (mIndex) {
+                candidates     = mIndex->candidates(matcher->requiredLiterals());
+                result.indexed = candidates.has_value();
+            }
+            const auto copy = [&](std::uint64_t sequence) {
+                const auto& record = recordAt(sequence);
+                if ((query.sinceMs && record.timestampMs < *query.sinceMs)
+                    || (query.untilMs && record.timestampMs > *query.untilMs)) {
+                    return;
+                }
+                snapshot.push_back({
+                    .sequence    = sequence,
+                    .timestampMs = record.timestampMs,
+                    .offset      = text.size(),
+                    .length      = record.length,
+                });
+                text.append(lineAt(record));
+            };
+            if (candidates) {
+                snapshot.reserve(candidates->size());
+                std::ranges::for_each(*candidates, copy);
+            } else {
+                snapshot.reserve(mSize);
+                for (auto sequence = oldest; sequence <= latest; ++sequence) {
+                    copy(sequence);
+                }
+            }
+        }
+        const auto textOf = [&](const Candidate& candidate) {
+            return std::string_view(text).substr(candidate.offset, candidate.length);
+        };
+
+        // Walk newest to oldest so the most recent matches win when maxMatches cuts the result short.
+        std::vector<std::size_t> matches; // Indexes into snapshot.
+        for (auto index = snapshot.size(); index-- > 0;) {
+            if (matches.size() == query.maxMatches) {
+                result.truncated = true;
+                break;
+            }
+            const auto line = textOf(snapshot[index]);
+            if (query.levelMask != 0 && (query.levelMask & logLevelBit(detectLogLevel(line))) == 0) {
+                continue;
+            }
+            ++result.scannedLines;
+            if (matcher->matches(line)) {
+                matches.push_back(index);
+            }
+        }
+        result.matchCount = matches.size();
+        std::ranges::reverse(matches);
+
+        const auto context = static_cast<std::uint64_t>(query.contextLines);
+        if (context == 0) {
+            for (const auto index : matches) {
+                const auto& match = snapshot[index];
+                result.lines.push_back({
+                    .sequence    = match.sequence,
+                    .timestampMs = match.timestampMs,
+                    .text        = std::string(textOf(match)),
+                    .match       = true,
+                });
+            }
+            return result;
+        }
+
+        // Context lines are read back under the lock; those evicted while the pattern ran are left out.
+        std::lock_guard lock(mMutex);
+        const auto      retained = mNextSequence - mSize;
+        std::uint64_t   emitted  = 0; // One past the last emitted sequence.
+        auto            next     = matches.begin();
+        for (const auto index : matches) {
+            const auto match = snapshot[index].sequence;
+            const auto first = std::max({match - std::min(match, context), oldest, emitted});
+            const auto last  = std::min(match + context, latest);
+            for (auto sequence = first; sequence <= last; ++sequence) {
+                while (next != matches.end() && snapshot[*next].sequence < sequence) {
+                    ++next;
+                }
+                if (next != matches.end() && snapshot[*next].sequence == sequence) {
+                    result.lines.push_back({
+                        .sequence    = sequence,
+                        .timestampMs = snapshot[*next].timestampMs,
+                        .text        = std::string(textOf(snapshot[*next])),
+                        .match       = true,
+                    });
+                } else if (sequence >= retained) {
+                    const auto& record = recordAt(sequence);
+                    result.lines.push_back({
+                        .sequence    = sequence,
+                        .timestampMs = record.timestampMs,
+                        .text        = std::string(lineAt(record)),
+                        .match       = false,
+                    });
+                }
+            }
+            emitted = std::max(emitted, last + 1);
+        }
         return result;
     }
 
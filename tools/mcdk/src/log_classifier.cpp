@@ -0,0 +1,173 @@
+#include <log_classifier.hpp>
+
+#include <bit>
+#include <cstring>
+#include <deque>
+
+namespace mcdk {
+
+    namespace {
+        constexpr std::size_t   ALPHABET   = 256;
+        constexpr std::uint32_t HAS_OUTPUT = 0x8000'0000u;
+
+        constexpr std::array<std::uint8_t, ALPHABET> FOLD = [] {
+            std::array<std::uint8_t, ALPHABET> table{};
+            for (std::size_t byte = 0; byte < ALPHABET; ++byte) {
+                table[byte] = static_cast<std::uint8_t>(byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte);
+            }
+            return table;
+        }();
+
+        constexpr bool isModuleNameChar(char ch) {
+            return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || ch == '_'
+                || ch == '.';
+        }
+
+        constexpr bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+    } // namespace
+
+    LogLineClassifier::LogLineClassifier()
+    : mPatterns{{
+          {" [INFO][Engine] ", LogLineKind::EngineNoise, true},
+          {"[INFO][Developer]", LogLineKind::Developer, true},
+          {"suc", LogLineKind::Success, false},
+          {"error", LogLineKind::Error, false},
+          {"warn", LogLineKind::Warning, false},
+          {"debug", LogLineKind::Debug, false},
+      }} {
+        // Trie over the folded patterns; state 0 is the root and missing edges are filled in below.
+        constexpr std::uint16_t    NONE = 0xFFFF;
+        std::vector<std::uint16_t> next(ALPHABET, NONE);
+        mOutputs.assign(1, 0);
+        for (std::size_t index = 0; index < mPatterns.size(); ++index) {
+            std::uint16_t state = 0;
+            for (const char ch : mPatterns[index].text) {
+                auto& edge = next[state * ALPHABET + FOLD[static_cast<unsigned char>(ch)]];
+                if (edge == NONE) {
+                    edge = static_cast<std::uint16_t>(mOutputs.size());
+                    mOutputs.push_back(0);
+                    next.resize(next.size() + ALPHABET, NONE);
+                }
+                state = next[state * ALPHABET + FOLD[static_cast<unsigned char>(ch)]];
+            }
+            mOutputs[state] |= static_cast<std::uint8_t>(1u << index);
+        }
+
+        // Breadth-first pass turning the trie into a complete DFA: a missing edge follows the failure link, and
+        // every state inherits the outputs of its failure state.
+        std::vector<std::uint16_t> fail(mOutputs.size(), 0);
+        std::deque<std::uint16_t>  queue;
+        for (std::size_t byte = 0; byte < ALPHABET; ++byte) {
+            auto& edge = next[byte];
+            if (edge == NONE) {
+                edge = 0;
+            } else {
+                queue.push_back(edge);
+            }
+        }
+        while (!queue.empty()) {
+            const auto state = queue.front();
+            queue.pop_front();
+            mOutputs[state] |= mOutputs[fail[state]];
+            for (std::size_t byte = 0; byte < ALPHABET; ++byte) {
+                auto&      edge     = next[state * ALPHABET + byte];
+                const auto fallback = next[fail[state] * ALPHABET + byte];
+                if (edge == NONE) {
+                    edge = fallback;
+                } else {
+                    fail[edge] = fallback;
+                    queue.push_back(edge);
+                }
+            }
+        }
+
+        // Final table: case folded in, targets pre-multiplied into row offsets and flagged when they have outputs, so
+        // the scan loop is one dependent load per byte.
+        mTable.resize(next.size());
+        for (std::size_t state = 0; state < mOutputs.size(); ++state) {
+            for (std::size_t byte = 0; byte < ALPHABET; ++byte) {
+                const auto target               = next[state * ALPHABET + FOLD[byte]];
+                mTable[state * ALPHABET + byte] = static_cast<std::uint32_t>(target * ALPHABET)
+                                                | (mOutputs[target] != 0 ? HAS_OUTPUT : 0);
+            }
+        }
+    }
+
+    std::uint32_t LogLineClassifier::scan(std::string_view line) const {
+        std::uint32_t mask  = 0;
+        std::uint32_t entry = 0;
+        for (std::size_t offset = 0; offset < line.size(); ++offset) {
+            entry = mTable[(entry & ~HAS_OUTPUT) + static_cast<unsigned char>(line[offset])];
+            if ((entry & HAS_OUTPUT) == 0) [[likely]] {
+                continue;
+            }
+            for (auto outputs = mOutputs[(entry & ~HAS_OUTPUT) / ALPHABET]; outputs != 0; outputs &= outputs - 1) {
+                const auto& pattern = mPatterns[std::countr_zero(outputs)];
+                const auto  begin   = offset + 1 - pattern.text.size();
+                if (!pattern.caseSensitive
+                    || std::memcmp(line.data() + begin, pattern.text.data(), pattern.text.size()) == 0) {
+                    mask |= 1u << static_cast<std::uint32_t>(pattern.kind);
+                }
+            }
+        }
+        return mask;
+    }
+
+    LogLineKind LogLineClassifier::classify(std::string_view line) const {
+        const auto mask = scan(line);
+        return mask == 0 ? LogLineKind::Plain : static_cast<LogLineKind>(std::countr_zero(mask));
+    }
+
+    const LogLineClassifier& logLineClassifier() {
+        static const LogLineClassifier classifier;
+        return classifier;
+    }
+
+    std::string rewriteTracebackFileNames(std::string_view line) {
+        constexpr std::string_view FILE_PREFIX = "File \"";
+        constexpr std::string_view LINE_INFIX  = "\", line ";
+
+        auto position = line.find(FILE_PREFIX);
+        if (position == std::string_view::npos) {
+            return std::string(line);
+        }
+
+        std::string output;
+        output.reserve(line.size() + 8);
+        std::size_t copied = 0;
+        while (position != std::string_view::npos) {
+            const auto nameBegin = position + FILE_PREFIX.size();
+            auto       cursor    = nameBegin;
+            while (cursor < line.size() && isModuleNameChar(line[cursor])) {
+                ++cursor;
+            }
+            const auto nameEnd = cursor;
+            bool       matched = nameEnd > nameBegin && line.substr(cursor).starts_with(LINE_INFIX);
+            if (matched) {
+                cursor += LINE_INFIX.size();
+                const auto digitsBegin = cursor;
+                while (cursor < line.size() && isDigit(line[cursor])) {
+                    ++cursor;
+                }
+                matched = cursor > digitsBegin;
+            }
+            if (!matched) {
+                position = line.find(FILE_PREFIX, position + 1);
+                continue;
+            }
+
+            output.append(line, copied, position - copied);
+            output += FILE_PREFIX;
+            for (auto index = nameBegin; index < nameEnd; ++index) {
+                output += line[index] == '.' ? '/' : line[index];
+            }
+            output += ".py";
+            output.append(line, nameEnd, cursor - nameEnd);
+            copied   = cursor;
+            position = line.find(FILE_PREFIX, cursor);
+        }
+        output.append(line, copied);
+        return output;
+    }
+
+} // namespace mcdk
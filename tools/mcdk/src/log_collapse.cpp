@@ -0,0 +1,123 @@
+#include <log_collapse.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+namespace mcdk {
+
+    namespace {
+        bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+        void appendTemplate(std::string& out, std::string_view line) {
+            out.clear();
+            for (std::size_t index = 0; index < line.size();) {
+                if (!isDigit(line[index])) {
+                    out += line[index++];
+                    continue;
+                }
+                while (index < line.size()
+                       && (isDigit(line[index])
+                           || (line[index] == '.' && index + 1 < line.size() && isDigit(line[index + 1])))) {
+                    ++index;
+                }
+                out += '#';
+            }
+        }
+
+        std::int64_t nowMs() {
+            const auto now = std::chrono::system_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+        }
+    } // namespace
+
+    LogFloodCollapser::LogFloodCollapser(LogCollapseOptions options) : mOptions(options) {}
+
+    LogFloodCollapser::Output LogFloodCollapser::feed(std::string_view line) { return feed(line, nowMs()); }
+
+    LogFloodCollapser::Output LogFloodCollapser::feed(std::string_view line, std::int64_t timestampMs) {
+        std::lock_guard lock(mMutex);
+        if (mOptions.maskNumbers) {
+            appendTemplate(mScratch, line);
+        } else {
+            mScratch.assign(line);
+        }
+
+        if (mHasRun && mScratch == mKey) {
+            if (mHeld == 0) {
+                mHeldSinceMs = timestampMs;
+            }
+            ++mHeld;
+            ++mCollapsedTotal;
+            mVaried     = mVaried || line != mFirst;
+            mLastSeenMs = timestampMs;
+            mLast.assign(line);
+            Output output{.summary = std::nullopt, .emitLine = false};
+            if (timestampMs - mHeldSinceMs >= mOptions.summaryIntervalMs) {
+                // The flood is still going; report what it has produced so far rather than staying silent.
+                output.summary = takeSummary();
+            }
+            return output;
+        }
+
+        Output output{.summary = takeSummary()};
+        std::swap(mKey, mScratch);
+        mFirst.assign(line);
+        mHasRun     = true;
+        mVaried     = false;
+        mLastSeenMs = timestampMs;
+        return output;
+    }
+
+    std::optional<std::string> LogFloodCollapser::flushIdle(std::int64_t nowMs) {
+        std::lock_guard lock(mMutex);
+        if (mHeld == 0 || nowMs - mLastSeenMs < mOptions.idleFlushMs) {
+            return std::nullopt;
+        }
+        return takeSummary();
+    }
+
+    bool LogFloodCollapser::flushIdle(std::int64_t nowMs, const std::function<void(std::string_view summary)>& emit) {
+        std::lock_guard lock(mMutex);
+        if (mHeld == 0 || nowMs - mLastSeenMs < mOptions.idleFlushMs) {
+            return false;
+        }
+        const auto summary = takeSummary();
+        emit(*summary);
+        return true;
+    }
+
+    std::optional<std::string> LogFloodCollapser::flush() {
+        std::lock_guard lock(mMutex);
+        return takeSummary();
+    }
+
+    std::uint64_t LogFloodCollapser::collapsedCount() const {
+        std::lock_guard lock(mMutex);
+        return mCollapsedTotal;
+    }
+
+    std::string LogFloodCollapser::templateOf(std::string_view line) {
+        std::string result;
+        appendTemplate(result, line);
+        return result;
+    }
+
+    std::optional<std::string> LogFloodCollapser::takeSummary() {
+        if (mHeld == 0) {
+            return std::nullopt;
+        }
+        std::string summary = std::move(mLast);
+        mLast.clear();
+        if (mHeld > 1) {
+            char span[32];
+            std::snprintf(span, sizeof(span), "%.1f", static_cast<double>(mLastSeenMs - mHeldSinceMs) / 1000.0);
+            summary += mVaried ? " [" + std::to_string(mHeld) + " similar lines in " + span + "s]"
+                               : " [repeated " + std::to_string(mHeld) + " times in " + span + "s]";
+        }
+        mHeld   = 0;
+        mVaried = false;
+        return summary;
+    }
+
+} // namespace mcdk
@@ -0,0 +1,364 @@
+#include <log_search.hpp>
+
+#include <log_classifier.hpp>
+#include <utils.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+namespace mcdk {
+
+    namespace {
+        char foldAscii(char ch) { return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch + ('a' - 'A')) : ch; }
+
+        std::uint32_t trigramKey(const char* text) {
+            return static_cast<std::uint32_t>(static_cast<unsigned char>(foldAscii(text[0])))
+                 | static_cast<std::uint32_t>(static_cast<unsigned char>(foldAscii(text[1]))) << 8
+                 | static_cast<std::uint32_t>(static_cast<unsigned char>(foldAscii(text[2]))) << 16;
+        }
+
+        bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+        // Skips a bracket expression starting at pattern[index] == '[' and returns the index just past its ']'.
+        std::size_t skipClass(std::string_view pattern, std::size_t index) {
+            ++index;
+            if (index < pattern.size() && pattern[index] == '^') {
+                ++index;
+            }
+            if (index < pattern.size() && pattern[index] == ']') {
+                ++index;
+            }
+            while (index < pattern.size() && pattern[index] != ']') {
+                index += pattern[index] == '\\' ? 2 : 1;
+            }
+            return std::min(index + 1, pattern.size());
+        }
+
+        // Skips a group starting at pattern[index] == '(' and returns the index just past its ')'.
+        std::size_t skipGroup(std::string_view pattern, std::size_t index) {
+            int depth = 0;
+            while (index < pattern.size()) {
+                const char ch = pattern[index];
+                if (ch == '\\') {
+                    index += 2;
+                    continue;
+                }
+                if (ch == '[') {
+                    index = skipClass(pattern, index);
+                    continue;
+                }
+                if (ch == '(') {
+                    ++depth;
+                } else if (ch == ')' && --depth == 0) {
+                    return index + 1;
+                }
+                ++index;
+            }
+            return pattern.size();
+        }
+
+        // Returns the index past a `{n}`, `{n,}` or `{n,m}` quantifier at pattern[index], or npos if '{' is literal.
+        std::size_t parseBraceQuantifier(std::string_view pattern, std::size_t index, bool& allowsZero) {
+            std::size_t cursor = index + 1;
+            std::size_t digits = 0;
+            allowsZero         = true;
+            while (cursor < pattern.size() && isDigit(pattern[cursor])) {
+                allowsZero = allowsZero && pattern[cursor] == '0';
+                ++cursor;
+                ++digits;
+            }
+            if (digits == 0) {
+                return std::string_view::npos;
+            }
+            if (cursor < pattern.size() && pattern[cursor] == ',') {
+                ++cursor;
+                while (cursor < pattern.size() && isDigit(pattern[cursor])) {
+                    ++cursor;
+                }
+            }
+            if (cursor >= pattern.size() || pattern[cursor] != '}') {
+                return std::string_view::npos;
+            }
+            return cursor + 1;
+        }
+
+        bool hasTopLevelAlternation(std::string_view pattern) {
+            for (std::size_t index = 0; index < pattern.size();) {
+                switch (pattern[index]) {
+                case '\\':
+                    index += 2;
+                    break;
+                case '[':
+                    index = skipClass(pattern, index);
+                    break;
+                case '(':
+                    index = skipGroup(pattern, index);
+                    break;
+                case '|':
+                    return true;
+                default:
+                    ++index;
+                }
+            }
+            return false;
+        }
+
+        // Collects the literal runs outside groups and classes that every match of an ECMAScript pattern must
+        // contain. Anything the extractor does not understand simply ends the current run, so the result may be
+        // weaker than the pattern but never stricter.
+        std::vector<std::string> extractRegexLiterals(std::string_view pattern) {
+            std::vector<std::string> literals;
+            if (hasTopLevelAlternation(pattern)) {
+                return literals;
+            }
+
+            std::string run;
+            const auto  flush = [&] {
+                if (!run.empty()) {
+                    literals.push_back(std::move(run));
+                    run.clear();
+                }
+            };
+
+            for (std::size_t index = 0; index < pattern.size();) {
+                const char ch = pattern[index];
+                switch (ch) {
+                case '\\': {
+                    if (index + 1 >= pattern.size()) {
+                        flush();
+                        return literals;
+                    }
+                    const char escaped = pattern[index + 1];
+                    if (std::isalnum(static_cast<unsigned char>(escaped))) {
+                        // Character classes, assertions, back-references and \x/\u/\c escapes: not a plain literal.
+                        flush();
+                        index += 2;
+                        if (escaped == 'x' || escaped == 'u' || escaped == 'c') {
+                            const std::size_t extra = escaped == 'x' ? 2 : escaped == 'u' ? 4 : 1;
+                            index                   = std::min(index + extra, pattern.size());
+                        }
+                    } else {
+                        run += escaped;
+                        index += 2;
+                    }
+                    continue;
+                }
+                case '[':
+                    flush();
+                    index = skipClass(pattern, index);
+                    continue;
+                case '(':
+                    flush();
+                    index = skipGroup(pattern, index);
+                    continue;
+                case '*':
+                case '?':
+                    // The preceding atom is optional.
+                    if (!run.empty()) {
+                        run.pop_back();
+                    }
+                    flush();
+                    ++index;
+                    continue;
+                case '{': {
+                    bool       allowsZero = false;
+                    const auto end        = parseBraceQuantifier(pattern, index, allowsZero);
+                    if (end == std::string_view::npos) {
+                        run += ch;
+                        ++index;
+                        continue;
+                    }
+                    if (allowsZero && !run.empty()) {
+                        run.pop_back();
+                    }
+                    flush();
+                    index = end;
+                    continue;
+                }
+                case '+':
+                case '.':
+                case '^':
+                case '$':
+                case ')':
+                case ']':
+                case '}':
+                    flush();
+                    ++index;
+                    continue;
+                default:
+                    run += ch;
+                    ++index;
+                }
+            }
+            flush();
+
+            for (auto& literal : literals) {
+                std::ranges::transform(literal, literal.begin(), foldAscii);
+            }
+            return literals;
+        }
+    } // namespace
+
+    LogLevel detectLogLevel(std::string_view line) {
+        const auto mask = logLineClassifier().scan(line);
+        if (mask & (1u << static_cast<std::uint32_t>(LogLineKind::Error))) {
+            return LogLevel::Error;
+        }
+        if (mask & (1u << static_cast<std::uint32_t>(LogLineKind::Warning))) {
+            return LogLevel::Warning;
+        }
+        if (mask & (1u << static_cast<std::uint32_t>(LogLineKind::Debug))) {
+            return LogLevel::Debug;
+        }
+        return LogLevel::Info;
+    }
+
+    std::optional<LogLevel> parseLogLevel(std::string_view name) {
+        std::string lower(name);
+        std::ranges::transform(lower, lower.begin(), foldAscii);
+        if (lower == "error") {
+            return LogLevel::Error;
+        }
+        if (lower == "warn" || lower == "warning") {
+            return LogLevel::Warning;
+        }
+        if (lower == "info") {
+            return LogLevel::Info;
+        }
+        if (lower == "debug") {
+            return LogLevel::Debug;
+        }
+        return std::nullopt;
+    }
+
+    std::string_view logLevelName(LogLevel level) {
+        switch (level) {
+        case LogLevel::Debug:
+            return "debug";
+        case LogLevel::Warning:
+            return "warning";
+        case LogLevel::Error:
+            return "error";
+        case LogLevel::Info:
+            break;
+        }
+        return "info";
+    }
+
+    std::expected<LogMatcher, std::string> LogMatcher::compile(const LogSearchQuery& query) {
+        LogMatcher matcher;
+        matcher.mPattern    = query.pattern;
+        matcher.mIgnoreCase = query.ignoreCase;
+        if (query.mode == LogSearchQuery::Mode::Regex) {
+            auto flags = std::regex::ECMAScript | std::regex::nosubs | std::regex::optimize;
+            if (query.ignoreCase) {
+                flags |= std::regex::icase;
+            }
+            try {
+                matcher.mRegex.emplace(query.pattern, flags);
+            } catch (const std::regex_error& error) {
+                return std::unexpected(std::string("Invalid regex: ") + error.what());
+            }
+            matcher.mLiterals = extractRegexLiterals(query.pattern);
+        } else if (!query.pattern.empty()) {
+            std::string literal = query.pattern;
+            std::ranges::transform(literal, literal.begin(), foldAscii);
+            matcher.mLiterals.push_back(std::move(literal));
+        }
+        return matcher;
+    }
+
+    bool LogMatcher::matches(std::string_view line) const {
+        if (mRegex) {
+            return std::regex_search(line.data(), line.data() + line.size(), *mRegex);
+        }
+        if (mIgnoreCase) {
+            return containsIgnoreCase(line, mPattern);
+        }
+        return line.find(mPattern) != std::string_view::npos;
+    }
+
+    void LogTrigramIndex::add(std::uint64_t sequence, std::string_view line) {
+        if (line.size() < 3) {
+            return;
+        }
+        mScratch.clear();
+        for (std::size_t offset = 0; offset + 3 <= line.size(); ++offset) {
+            mScratch.push_back(trigramKey(line.data() + offset));
+        }
+        std::ranges::sort(mScratch);
+        const auto unique = std::ranges::unique(mScratch);
+        mScratch.erase(unique.begin(), unique.end());
+        for (const auto key : mScratch) {
+            mPostings[key].push_back(sequence);
+        }
+    }
+
+    void LogTrigramIndex::evictBefore(std::uint64_t oldestSequence, std::size_t liveLines) {
+        mEvictedSinceCompact += static_cast<std::size_t>(oldestSequence - std::min(oldestSequence, mOldestSequence));
+        mOldestSequence = oldestSequence;
+        // Trimming every posting list is linear in the index size, so only do it once the dead prefix is at least as
+        // large as the live data; lookups skip dead entries with a binary search meanwhile.
+        if (mEvictedSinceCompact >= std::max<std::size_t>(liveLines, 1)) {
+            compact();
+        }
+    }
+
+    void LogTrigramIndex::compact() {
+        for (auto it = mPostings.begin(); it != mPostings.end();) {
+            auto& sequences = it->second;
+            sequences.erase(sequences.begin(), std::ranges::lower_bound(sequences, mOldestSequence));
+            if (sequences.empty()) {
+                it = mPostings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        mEvictedSinceCompact = 0;
+    }
+
+    void LogTrigramIndex::clear() {
+        mPostings.clear();
+        mEvictedSinceCompact = 0;
+    }
+
+    std::optional<std::vector<std::uint64_t>> LogTrigramIndex::candidates(const std::vector<std::string>& literals
+    ) const {
+        struct Posting {
+            const std::uint64_t* begin;
+            const std::uint64_t* end;
+        };
+        std::vector<Posting> postings;
+        for (const auto& literal : literals) {
+            for (std::size_t offset = 0; offset + 3 <= literal.size(); ++offset) {
+                const auto it = mPostings.find(trigramKey(literal.data() + offset));
+                if (it == mPostings.end()) {
+                    return std::vector<std::uint64_t>{};
+                }
+                const auto& sequences = it->second;
+                const auto  first     = std::ranges::lower_bound(sequences, mOldestSequence);
+                if (first == sequences.end()) {
+                    return std::vector<std::uint64_t>{};
+                }
+                postings.push_back({std::to_address(first), sequences.data() + sequences.size()});
+            }
+        }
+        if (postings.empty()) {
+            return std::nullopt;
+        }
+
+        std::ranges::sort(postings, {}, [](const Posting& posting) { return posting.end - posting.begin; });
+        std::vector<std::uint64_t> result(postings.front().begin, postings.front().end);
+        for (std::size_t index = 1; index < postings.size() && !result.empty(); ++index) {
+            // Both lists are ascending, so each lookup can resume where the previous one stopped.
+            const auto* cursor = postings[index].begin;
+            const auto* end    = postings[index].end;
+            std::erase_if(result, [&](std::uint64_t sequence) {
+                cursor = std::lower_bound(cursor, end, sequence);
+                return cursor == end || *cursor != sequence;
+            });
+        }
+        return result;
+    }
+
+} // namespace mcdk
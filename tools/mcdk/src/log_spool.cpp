@@ -0,0 +1,388 @@
+#include <log_spool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace mcdk {
+
+    namespace {
+        constexpr char          INDEX_MAGIC[8]    = {'M', 'C', 'D', 'K', 'L', 'I', 'X', '1'};
+        constexpr std::uint64_t INDEX_HEADER_SIZE = sizeof(INDEX_MAGIC) + sizeof(std::uint64_t);
+        constexpr std::uint64_t MAX_SEGMENT_BYTES = std::numeric_limits<std::uint32_t>::max();
+
+        // Read-only view of the first `length` bytes of a file; empty if the file cannot be mapped.
+        class MappedFile {
+        public:
+            MappedFile(const std::filesystem::path& path, std::size_t length) {
+                if (length == 0) {
+                    return;
+                }
+#ifdef _WIN32
+                const HANDLE file = CreateFileW(
+                    path.c_str(),
+                    GENERIC_READ,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                    nullptr,
+                    OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL,
+                    nullptr
+                );
+                if (file == INVALID_HANDLE_VALUE) {
+                    return;
+                }
+                const auto   size    = static_cast<std::uint64_t>(length);
+                const HANDLE mapping = CreateFileMappingW(
+                    file,
+                    nullptr,
+                    PAGE_READONLY,
+                    static_cast<DWORD>(size >> 32),
+                    static_cast<DWORD>(size),
+                    nullptr
+                );
+                CloseHandle(file);
+                if (mapping == nullptr) {
+                    return;
+                }
+                mData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, length));
+                CloseHandle(mapping);
+#else
+                const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    return;
+                }
+                void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if (address == MAP_FAILED) {
+                    return;
+                }
+                mData = static_cast<const char*>(address);
+#endif
+                if (mData != nullptr) {
+                    mSize = length;
+                }
+            }
+
+            ~MappedFile() {
+                if (mData == nullptr) {
+                    return;
+                }
+#ifdef _WIN32
+                UnmapViewOfFile(mData);
+#else
+                ::munmap(const_cast<char*>(mData), mSize);
+#endif
+            }
+
+            MappedFile(const MappedFile&)            = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            [[nodiscard]] const char* data() const { return mData; }
+            [[nodiscard]] std::size_t size() const { return mSize; }
+
+        private:
+            const char* mData = nullptr;
+            std::size_t mSize = 0;
+        };
+
+        std::string makeSessionName() {
+            const auto time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            std::tm    utc{};
+#ifdef _WIN32
+            gmtime_s(&utc, &time);
+#else
+            gmtime_r(&time, &utc);
+#endif
+            std::ostringstream output;
+            output << std::put_time(&utc, "%Y%m%dT%H%M%SZ");
+            return output.str();
+        }
+
+        std::uint64_t treeBytes(const std::filesystem::path& directory) {
+            std::error_code ec;
+            std::uint64_t   bytes = 0;
+            for (std::filesystem::recursive_directory_iterator it(directory, ec), end; !ec && it != end;
+                 it.increment(ec)) {
+                if (it->is_regular_file(ec)) {
+                    const auto size = it->file_size(ec);
+                    bytes += ec ? 0 : size;
+                }
+            }
+            return bytes;
+        }
+
+        // Keeps the newest sessions while they fit within both keep and maxBytes, and deletes the rest.
+        void pruneSessions(const std::filesystem::path& root, std::size_t keep, std::uint64_t maxBytes) {
+            std::error_code                    ec;
+            std::vector<std::filesystem::path> sessions;
+            for (const auto& entry : std::filesystem::directory_iterator(root, ec)) {
+                if (entry.is_directory(ec)) {
+                    sessions.push_back(entry.path());
+                }
+            }
+            // Session names are UTC timestamps, so lexical order is chronological.
+            std::ranges::sort(sessions, std::greater{});
+            std::uint64_t kept = 0;
+            for (std::size_t index = 0; index < sessions.size(); ++index) {
+                const auto bytes = index < keep ? treeBytes(sessions[index]) : 0;
+                if (index < keep && kept + bytes <= maxBytes) {
+                    kept += bytes;
+                    continue;
+                }
+                // Once one session is over budget, every older one goes too, so kept sessions stay contiguous.
+                for (; index < sessions.size(); ++index) {
+                    std::filesystem::remove_all(sessions[index], ec);
+                }
+            }
+        }
+    } // namespace
+
+    LogSpool::LogSpool(std::filesystem::path directory, LogSpoolOptions options)
+    : mDirectory(std::move(directory)),
+      mOptions(options) {
+        mOptions.maxSegmentBytes = std::clamp<std::uint64_t>(mOptions.maxSegmentBytes, 1, MAX_SEGMENT_BYTES);
+        mOptions.maxSegments     = std::max<std::size_t>(mOptions.maxSegments, 1);
+    }
+
+    LogSpool::~LogSpool() {
+        std::lock_guard lock(mMutex);
+        closeSegment();
+    }
+
+    std::expected<std::shared_ptr<LogSpool>, std::string>
+    LogSpool::open(const std::filesystem::path& directory, LogSpoolOptions options) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) {
+            return std::unexpected("Cannot create log spool directory: " + ec.message());
+        }
+        return std::shared_ptr<LogSpool>(new LogSpool(directory, options));
+    }
+
+    std::expected<std::shared_ptr<LogSpool>, std::string>
+    LogSpool::createSession(const std::filesystem::path& root, LogRetention retention, LogSpoolOptions options) {
+        // The new session counts towards keepSessions.
+        pruneSessions(root, retention.keepSessions > 0 ? retention.keepSessions - 1 : 0, retention.maxBytes);
+
+        const auto      name = makeSessionName();
+        auto            path = root / name;
+        std::error_code ec;
+        for (int suffix = 2; std::filesystem::exists(path, ec); ++suffix) {
+            path = root / (name + "-" + std::to_string(suffix));
+        }
+        return open(path, options);
+    }
+
+    std::uint64_t LogSpool::diskUsage(const std::filesystem::path& directory) { return treeBytes(directory); }
+
+    std::filesystem::path LogSpool::segmentPath(std::uint32_t number, const char* extension) const {
+        std::ostringstream name;
+        name << "segment-" << std::setw(6) << std::setfill('0') << number << extension;
+        return mDirectory / name.str();
+    }
+
+    void LogSpool::closeSegment() {
+        if (mText.is_open()) {
+            mText.close();
+        }
+        if (mIndex.is_open()) {
+            mIndex.close();
+        }
+    }
+
+    void LogSpool::startSegment(std::uint64_t firstSequence) {
+        closeSegment();
+        const auto number = mSegments.empty() ? 1 : mSegments.back().number + 1;
+
+        mText.open(segmentPath(number, ".log"), std::ios::binary | std::ios::trunc);
+        mIndex.open(segmentPath(number, ".idx"), std::ios::binary | std::ios::trunc);
+        mIndex.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        mIndex.write(reinterpret_cast<const char*>(&firstSequence), sizeof(firstSequence));
+        if (!mText || !mIndex) {
+            // A full disk or a vanished directory must not take the log pipe down; stop spooling instead.
+            closeSegment();
+            mFailed = true;
+            return;
+        }
+        mSegments.push_back({.number = number, .firstSequence = firstSequence});
+
+        std::error_code ec;
+        while (mSegments.size() > mOptions.maxSegments) {
+            std::filesystem::remove(segmentPath(mSegments.front().number, ".log"), ec);
+            std::filesystem::remove(segmentPath(mSegments.front().number, ".idx"), ec);
+            mSegments.pop_front();
+        }
+    }
+
+    void LogSpool::append(std::uint64_t sequence, std::string_view line) {
+        std::lock_guard lock(mMutex);
+        appendLocked(sequence, line);
+    }
+
+    std::uint64_t LogSpool::append(std::string_view line) {
+        std::lock_guard lock(mMutex);
+        const auto      sequence = latestSequenceLocked() + 1;
+        appendLocked(sequence, line);
+        return sequence;
+    }
+
+    void LogSpool::appendLocked(std::uint64_t sequence, std::string_view line) {
+        if (mFailed) {
+            return;
+        }
+        const auto length = std::min<std::uint64_t>(line.size(), mOptions.maxSegmentBytes - 1);
+        const bool rotate = !mText.is_open() || mSegments.empty()
+                         || sequence != mSegments.back().firstSequence + mSegments.back().lineCount
+                         || (mSegments.back().lineCount > 0
+                             && mSegments.back().bytes + length + 1 > mOptions.maxSegmentBytes);
+        if (rotate) {
+            startSegment(sequence);
+            if (mFailed) {
+                return;
+            }
+        }
+
+        auto&      segment   = mSegments.back();
+        const auto endOffset = static_cast<std::uint32_t>(segment.bytes + length + 1);
+        mText.write(line.data(), static_cast<std::streamsize>(length));
+        mText.put('\n');
+        mIndex.write(reinterpret_cast<const char*>(&endOffset), sizeof(endOffset));
+        if (!mText || !mIndex) {
+            closeSegment();
+            mFailed = true;
+            return;
+        }
+        segment.bytes = endOffset;
+        ++segment.lineCount;
+    }
+
+    std::uint64_t LogSpool::oldestSequence() const {
+        std::lock_guard lock(mMutex);
+        return mSegments.empty() || mSegments.front().lineCount == 0 ? 0 : mSegments.front().firstSequence;
+    }
+
+    std::uint64_t LogSpool::latestSequence() const {
+        std::lock_guard lock(mMutex);
+        return latestSequenceLocked();
+    }
+
+    std::uint64_t LogSpool::latestSequenceLocked() const {
+        if (mSegments.empty()) {
+            return 0;
+        }
+        const auto& last = mSegments.back();
+        return last.lineCount == 0 ? last.firstSequence - 1 : last.firstSequence + last.lineCount - 1;
+    }
+
+    LogLines LogSpool::read(std::uint64_t firstSequence, std::size_t maxCount) const {
+        LogLines result;
+        result.firstSequence = firstSequence;
+
+        std::lock_guard lock(mMutex);
+        if (maxCount == 0 || mSegments.empty()) {
+            return result;
+        }
+        if (mText.is_open()) {
+            mText.flush();
+            mIndex.flush();
+        }
+
+        auto segment = std::ranges::upper_bound(mSegments, firstSequence, {}, &Segment::firstSequence);
+        if (segment == mSegments.begin()) {
+            return result;
+        }
+        --segment;
+
+        // Gather each segment's slice first so the output can be one contiguous block, as LogBuffer returns it.
+        struct Slice {
+            std::unique_ptr<MappedFile> text;
+            std::unique_ptr<MappedFile> index;
+            std::uint64_t               firstLine = 0;
+            std::uint64_t               count     = 0;
+            std::uint64_t               beginByte = 0;
+            std::uint64_t               endByte   = 0;
+        };
+        std::vector<Slice> slices;
+        std::uint64_t      next      = firstSequence;
+        std::uint64_t      remaining = maxCount;
+        for (; segment != mSegments.end() && remaining > 0; ++segment) {
+            if (next < segment->firstSequence || next >= segment->firstSequence + segment->lineCount) {
+                break;
+            }
+            Slice slice;
+            slice.firstLine = next - segment->firstSequence;
+            slice.count     = std::min(remaining, segment->lineCount - slice.firstLine);
+            slice.index     = std::make_unique<MappedFile>(
+                segmentPath(segment->number, ".idx"),
+                static_cast<std::size_t>(INDEX_HEADER_SIZE + segment->lineCount * sizeof(std::uint32_t))
+            );
+            slice.text = std::make_unique<MappedFile>(segmentPath(segment->number, ".log"), segment->bytes);
+            if (slice.index->data() == nullptr || slice.text->data() == nullptr
+                || std::memcmp(slice.index->data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+                break;
+            }
+            const auto endOffset = [&](std::uint64_t line) {
+                std::uint32_t value = 0;
+                std::memcpy(&value, slice.index->data() + INDEX_HEADER_SIZE + line * sizeof(value), sizeof(value));
+                return std::uint64_t{value};
+            };
+            slice.beginByte = slice.firstLine == 0 ? 0 : endOffset(slice.firstLine - 1);
+            slice.endByte   = endOffset(slice.firstLine + slice.count - 1);
+            next += slice.count;
+            remaining -= slice.count;
+            slices.push_back(std::move(slice));
+        }
+        if (slices.empty()) {
+            return result;
+        }
+
+        std::size_t totalBytes = 0;
+        std::size_t totalLines = 0;
+        for (const auto& slice : slices) {
+            totalBytes += static_cast<std::size_t>(slice.endByte - slice.beginByte);
+            totalLines += static_cast<std::size_t>(slice.count);
+        }
+        result.text = std::make_unique_for_overwrite<char[]>(std::max<std::size_t>(totalBytes, 1));
+        result.lines.reserve(totalLines);
+
+        char* output = result.text.get();
+        for (const auto& slice : slices) {
+            const auto bytes = static_cast<std::size_t>(slice.endByte - slice.beginByte);
+            std::memcpy(output, slice.text->data() + slice.beginByte, bytes);
+            std::uint64_t begin = 0;
+            for (std::uint64_t line = 0; line < slice.count; ++line) {
+                std::uint32_t end = 0;
+                std::memcpy(
+                    &end,
+                    slice.index->data() + INDEX_HEADER_SIZE + (slice.firstLine + line) * sizeof(end),
+                    sizeof(end)
+                );
+                const auto relativeEnd = end - slice.beginByte;
+                // Every entry ends with the '\n' separator, which is not part of the line.
+                result.lines.emplace_back(output + begin, static_cast<std::size_t>(relativeEnd - 1 - begin));
+                begin = relativeEnd;
+            }
+            output += bytes;
+        }
+        return result;
+    }
+
+} // namespace mcdk
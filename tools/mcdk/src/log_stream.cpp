@@ -0,0 +1,173 @@
+#include <log_stream.hpp>
+
+#include <log_buffer.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace mcdk {
+
+    LogStreamHub::LogStreamHub(Publisher publisher, LogStreamOptions options)
+    : mPublisher(std::move(publisher)),
+      mOptions(options) {}
+
+    LogStreamHub::~LogStreamHub() { stop(); }
+
+    std::expected<std::string, std::string> LogStreamHub::subscribe(
+        const std::string&         sessionId,
+        std::shared_ptr<LogBuffer> buffer,
+        const LogSearchQuery&      query,
+        std::uint64_t              cursor
+    ) {
+        if (!buffer) {
+            return std::unexpected("Log buffer not set");
+        }
+        auto matcher = LogMatcher::compile(query);
+        if (!matcher) {
+            return std::unexpected(matcher.error());
+        }
+        // A cursor from another session (or the future) behaves like 0: start with the next line written.
+        const auto latest = buffer->latestSequence();
+        if (cursor == 0 || cursor > latest) {
+            cursor = latest;
+        }
+
+        std::lock_guard lock(mMutex);
+        if (mSubscriptions.size() >= mOptions.maxSubscriptions) {
+            return std::unexpected("Too many log subscriptions");
+        }
+        const auto perSession = std::ranges::count(mSubscriptions, sessionId, [](const auto& subscription) {
+            return subscription->sessionId;
+        });
+        if (static_cast<std::size_t>(perSession) >= mOptions.maxPerSession) {
+            return std::unexpected("Too many log subscriptions for this session");
+        }
+        auto subscription = std::make_shared<Subscription>(Subscription{
+            .id        = "logs-" + std::to_string(mNextId++),
+            .sessionId = sessionId,
+            .buffer    = std::move(buffer),
+            .matcher   = std::move(*matcher),
+            .levelMask = query.levelMask,
+            .cursor    = cursor,
+        });
+        mSubscriptions.push_back(subscription);
+        return subscription->id;
+    }
+
+    bool LogStreamHub::unsubscribe(const std::string& sessionId, const std::string& subscriptionId) {
+        std::lock_guard lock(mMutex);
+        return std::erase_if(mSubscriptions, [&](const auto& subscription) {
+                   return subscription->id == subscriptionId && subscription->sessionId == sessionId;
+               })
+             > 0;
+    }
+
+    std::size_t LogStreamHub::subscriptionCount() const {
+        std::lock_guard lock(mMutex);
+        return mSubscriptions.size();
+    }
+
+    void LogStreamHub::start() {
+        std::lock_guard lock(mMutex);
+        if (mThread.joinable()) {
+            return;
+        }
+        mStopping = false;
+        mThread   = std::thread([this] {
+            std::unique_lock lock(mMutex);
+            while (!mStopping) {
+                mWake.wait_for(lock, mOptions.interval, [this] { return mStopping; });
+                if (mStopping) {
+                    break;
+                }
+                lock.unlock();
+                pump();
+                lock.lock();
+            }
+        });
+    }
+
+    void LogStreamHub::stop() {
+        {
+            std::lock_guard lock(mMutex);
+            mStopping = true;
+        }
+        mWake.notify_all();
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+    }
+
+    void LogStreamHub::pump() {
+        std::lock_guard pumpLock(mPumpMutex);
+        std::vector<std::shared_ptr<Subscription>> subscriptions;
+        {
+            std::lock_guard lock(mMutex);
+            subscriptions = mSubscriptions;
+        }
+
+        // One publish per session, so a session's transport sees at most one message per round.
+        std::vector<std::pair<std::string, std::vector<LogStreamBatch>>> sessions;
+        for (const auto& subscription : subscriptions) {
+            auto batch = collect(*subscription);
+            if (batch.lines.empty() && batch.skipped == 0) {
+                continue;
+            }
+            auto session = std::ranges::find(sessions, subscription->sessionId, [](const auto& entry) {
+                return entry.first;
+            });
+            if (session == sessions.end()) {
+                session = sessions.insert(sessions.end(), {subscription->sessionId, {}});
+            }
+            session->second.push_back(std::move(batch));
+        }
+
+        for (const auto& [sessionId, batches] : sessions) {
+            if (!mPublisher(sessionId, batches)) {
+                std::lock_guard lock(mMutex);
+                std::erase_if(mSubscriptions, [&](const auto& subscription) {
+                    return subscription->sessionId == sessionId;
+                });
+            }
+        }
+    }
+
+    LogStreamBatch LogStreamHub::collect(Subscription& subscription) const {
+        LogStreamBatch batch;
+        batch.subscriptionId = subscription.id;
+
+        const auto latest = subscription.buffer->latestSequence();
+        if (latest < subscription.cursor) {
+            // Cannot happen with one buffer per session; resynchronize rather than wait for the numbers to catch up.
+            subscription.cursor = latest;
+        }
+        if (latest - subscription.cursor > mOptions.maxBacklog) {
+            const auto resume = latest - mOptions.maxBacklog;
+            batch.skipped += resume - subscription.cursor;
+            subscription.cursor = resume;
+        }
+
+        const auto since = subscription.buffer->getSince(subscription.cursor, mOptions.maxBacklog);
+        batch.skipped += since.dropped;
+        auto cursor = since.lines.empty() ? subscription.cursor : since.lines.firstSequence - 1;
+        for (std::size_t index = 0; index < since.lines.size(); ++index) {
+            const auto text  = since.lines.lines[index];
+            const auto level = detectLogLevel(text);
+            if ((subscription.levelMask == 0 || (subscription.levelMask & logLevelBit(level)) != 0)
+                && subscription.matcher.matches(text)) {
+                if (batch.lines.size() == mOptions.maxLinesPerBatch) {
+                    // Rate limit reached: leave the rest for the next round.
+                    break;
+                }
+                batch.lines.push_back(
+                    {.sequence = since.lines.sequenceAt(index), .level = level, .text = std::string(text)}
+                );
+            }
+            cursor = since.lines.sequenceAt(index);
+        }
+        subscription.cursor = cursor;
+        batch.cursor        = cursor;
+        return batch;
+    }
+
+} // namespace mcdk
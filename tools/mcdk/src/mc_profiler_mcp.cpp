@@ -15,15 +15,20 @@ namespace {
 
     using Json = nlohmann::json;
 
-    constexpr std::array<std::string_view, 13> SupportedOperations = {
+    constexpr std::array<std::string_view, 18> SupportedOperations = {
         "/help",
         "/guide",
         "/doctor",
         "/start",
         "/status",
         "/stop",
+        "/snapshot",
+        "/arm",
+        "/triggers",
+        "/disarm",
         "/query",
         "/compare",
+        "/trend",
         "/detail",
         "/history",
         "/export",
@@ -111,11 +116,12 @@ namespace {
             {"invocation", Json{{"op", "/..."}, {"args", Json::object()}}},
             {"safety",
              Json::array(
-                 {"Every capture has a server-enforced deadline.",
+                 {"Every capture has a server-enforced deadline; a flight recorder instead keeps a byte-bounded rolling window until stopped.",
                   "Query results are filtered, paged, and byte-bounded by the server.",
                   "Memory results expire after 20 minutes without access; the next profiler request runs lazy GC.",
                   "Artifact paths and disk retention are controlled by the server.",
-                  "Only one profiler job is active by default."}
+                  "Only one profiler job is active by default; one frame.time job may run beside it.",
+                  "Armed triggers start captures on their own, within their cooldown and capture cap."}
              )},
             {"initialization",
              "The first mc_profiler operation initializes the shared service and probes mcdev-tracy-bridge.dll beside "
@@ -127,7 +133,7 @@ namespace {
         Json nextCalls = Json::array();
         if (topic.empty()) {
             data["operations"] = SupportedOperations;
-            data["kinds"]      = Json::array({"python.cpu", "python.memory", "native.cpu"});
+            data["kinds"]      = Json::array({"python.cpu", "python.memory", "native.cpu", "frame.time"});
             data["note"]       = "Use /help with args.topic set to an operation or profiler kind for focused help.";
             nextCalls.push_back(nextCall("/guide", Json{{"name", "lag"}}, "Choose a bounded diagnostic workflow."));
             nextCalls.push_back(nextCall("/doctor", Json::object(), "Inspect static runtime capabilities."));
@@ -135,14 +141,20 @@ namespace {
             data["topic"]       = "/start";
             data["required"]    = Json::array({"kind"});
             data["optional"]    = Json::array(
-                {"target", "clock", "duration_seconds", "storage", "traceback_depth", "collect_garbage"}
+                {"target", "clock", "duration_seconds", "storage", "traceback_depth", "collect_garbage",
+                 "snapshot_interval_seconds", "mode", "recorder_budget_mb", "engine", "sample_hz"}
             );
             data["bounds"] = Json{
-                {"duration_seconds", "integer 1..300"},
-                {"target", "Python CPU: client | server | all; Python memory: client control side only; Native: omitted"},
-                {"clock", "cpu | wall; Python CPU only"},
+                {"duration_seconds", "integer 1..300; the rolling window length in recorder mode"},
+                {"mode", "capture | recorder; recorder is Python CPU only"},
+                {"recorder_budget_mb", "integer 1..256, default 16; recorder mode only"},
+                {"target", "Python CPU and frame time: client | server | all; Python memory: client control side only; Native: omitted"},
+                {"clock", "cpu | wall; Python CPU only; sampling measures wall only"},
+                {"engine", "tracing | sampling; Python CPU only"},
+                {"sample_hz", "integer 10..1000, default 100; sampling engine only"},
                 {"traceback_depth", "integer 1..16; Python memory only"},
-                {"collect_garbage", "boolean; Python memory only"},
+                {"collect_garbage", "boolean; Python memory only; applies to every snapshot"},
+                {"snapshot_interval_seconds", "integer 1..duration_seconds-1; Python memory only; omitted takes only the final snapshot"},
             };
             data["example"]     = Json{
                     {"op", "/start"},
@@ -153,9 +165,19 @@ namespace {
                 {"memory", "Temporary in-process result; 20-minute idle TTL refreshed by successful job access, absent from history, and lost on MCDK exit."},
                 {"disk", "Committed result available to history and process-restart recovery."},
             };
+            data["modes"] = Json{
+                {"default", "capture"},
+                {"capture", "Stops at the deadline and completes with the whole capture."},
+                {"recorder", "An always-on flight recorder: keeps only the last duration_seconds within the byte budget and runs until /stop. /snapshot freezes the current window into a new completed job; /stop completes the recorder itself with its last window."},
+            };
+            data["engines"] = Json{
+                {"default", "tracing"},
+                {"tracing", "yappi records every call exactly. Each call pays for the hook, so calls-heavy scripts run noticeably slower while it captures and frame times skew."},
+                {"sampling", "A game-side thread samples the profiled threads' stacks sample_hz times per second. It costs a fixed amount per sample rather than per call, so frame times stay close to normal; calls count samples, times are samples multiplied by the measured sample period, and functions shorter than a period only appear statistically."},
+            };
             data["note"] = "The backend requests stop at the deadline. Native finalization may report cleanup_pending.";
             nextCalls.push_back(nextCall("/doctor", Json::object(), "Check availability before starting."));
-        } else if (topic == "python.cpu" || topic == "python.memory" || topic == "native.cpu") {
+        } else if (topic == "python.cpu" || topic == "python.memory" || topic == "native.cpu" || topic == "frame.time") {
             data["topic"] = topic;
             data["kind"]  = topic;
             if (topic == "native.cpu") {
@@ -199,20 +221,44 @@ namespace {
                      "The bounded index may be truncated; inspect coverage fields and use the .tracy artifact as the "
                      "source of truth."}
                 );
+            } else if (topic == "frame.time") {
+                data["note"] =
+                    "Frame time records how long each server tick and client frame took, from a zero-delay timer on "
+                    "each watched side's game thread, into HDR-style histograms. It runs beside one CPU or memory "
+                    "capture, and its slowest frames link to the capture-mode CPU job whose window they overlap.";
+                data["recommended_views"] = Json::array({"percentiles", "worst-frames", "timeseries", "histogram"});
+                data["view_semantics"] = Json{
+                    {"percentiles", "Per side: frames, lost frames, mean, minimum, p50, p90, p99 and maximum in milliseconds."},
+                    {"histogram", "Per side: each non-empty bucket's lowest and highest duration, its count and the cumulative percent."},
+                    {"timeseries", "Per side and whole second of the job: frames, mean and maximum duration."},
+                    {"worst-frames", "Per side: the 50 slowest frames, when each ended, and the overlapping CPU job if any."},
+                };
+                data["limitations"] = Json::array({
+                    "A duration is the interval between two script timer callbacks of the side, which includes engine work outside Python.",
+                    "Percentiles come from buckets two significant digits wide; minimum and maximum are exact.",
+                    "Frames are placed in time by counting back from each drain, so ends are accurate to about a tick.",
+                    "Flight recorders are not linked, since what they keep is only their last window.",
+                });
             } else if (topic == "python.memory") {
                 data["note"] =
                     "Python memory uses tracemalloc through the client control executor, but tracemalloc observes the "
                     "shared Python interpreter process. Results may contain both client and server allocation paths; "
                     "target=client does not mean client-only allocation isolation.";
                 data["scope"] = "process-wide Python allocations";
-                data["recommended_views"] = Json::array({"growth", "retained"});
+                data["recommended_views"] = Json::array({"growth", "growth-rate", "calltree-roots", "calltree-children", "retained", "snapshots"});
                 data["view_semantics"] = Json{
                     {"growth", "Allocation size/count delta since the baseline snapshot, including releases."},
                     {"retained", "Current retained size/count at collection time."},
+                    {"calltree-roots", "The outermost frames of the allocation call tree built from the captured tracebacks, with inclusive and exclusive retained size, count and size delta."},
+                    {"calltree-children", "Every allocation tree node; filter by one parent node id to expand it."},
+                    {"snapshots", "Per periodic snapshot and the final collection: seconds since start, net size/count delta and sites reported."},
+                    {"growth-rate", "Per allocation site over the snapshots: least-squares slope in bytes/second, r_squared, first, last and peak size delta, and a pattern. growing (slope > 0 with r_squared >= 0.8) separates steady leaks from plateau one-off allocations; insufficient means fewer than 3 points."},
                 };
                 data["limitations"] = Json::array({
                     "tracemalloc cannot attribute shared-interpreter allocations to a client or server thread reliably.",
                     "Tracebacks identify allocation paths, not object ownership or proof of a leak.",
+                    "Each snapshot reports only the 512 largest sites, so a site has no point in snapshots where it was smaller; growth-rate needs snapshot_interval_seconds.",
+                    "The allocation tree covers the captured rows; traceback_depth bounds its depth, so its roots are the outermost frames kept.",
                 });
             } else {
                 data["note"] =
@@ -231,6 +277,33 @@ namespace {
                 data["optional"] = Json::array({"name"});
                 data["note"] = "Omit name to list guides; returned placeholders must be replaced with ids from earlier calls.";
                 data["example"] = Json{{"op", "/guide"}, {"args", {{"name", "native-hotspot"}}}};
+            } else if (topic == "/snapshot") {
+                data["required"] = Json::array({"job_id"});
+                data["note"] = "Freezes the rolling window of a running flight recorder into a new completed job that queries, compares and exports like any capture. The recorder keeps running.";
+                data["example"] = Json{{"op", "/snapshot"}, {"args", {{"job_id", "$start.job.id"}}}};
+            } else if (topic == "/arm") {
+                data["required"] = Json::array({"condition", "capture"});
+                data["optional"] = Json::array({"side", "tick_ms", "consecutive_ticks", "pattern", "regex", "cooldown_seconds", "max_captures"});
+                data["bounds"] = Json{
+                    {"condition", "tick_time | log_pattern"},
+                    {"side", "server | client, default server; tick_time only"},
+                    {"tick_ms", "number 1..10000, default 100; a tick slower than this counts toward the streak"},
+                    {"consecutive_ticks", "integer 1..1200, default 3"},
+                    {"pattern", "string of at most 256 bytes; required for log_pattern"},
+                    {"regex", "boolean, default false; pattern is a case-sensitive substring unless true"},
+                    {"cooldown_seconds", "integer 0..3600, default 120, counted from each capture's start"},
+                    {"max_captures", "integer 1..20, default 3; this trigger is exhausted after this many captures, and arming a new trigger starts a new count"},
+                    {"capture", "the /start args of the capture to run; recorder mode is not allowed"},
+                };
+                data["note"] = "Arms a trigger that starts its capture whenever the condition holds outside its cooldown, for unattended soak tests. tick_time watches the interval between the side's game ticks; log_pattern watches game log lines logged after arming. Jobs it starts carry a trigger object with the trigger id, the observed streak or matching line and when it fired. At most 4 triggers are armed at once, and they last until /disarm or MCDK exits. max_captures bounds each trigger, not the session: a session that re-arms can run up to max_captures more captures per trigger it arms. log_pattern triggers report lines the log dropped before they were read as missed_log_lines.";
+                data["example"] = Json{{"op", "/arm"}, {"args", {{"condition", "tick_time"}, {"tick_ms", 100}, {"consecutive_ticks", 5}, {"max_captures", 3}, {"capture", {{"kind", "python.cpu"}, {"target", "server"}, {"duration_seconds", 10}, {"storage", "disk"}}}}}};
+            } else if (topic == "/triggers") {
+                data["note"] = "Lists this session's triggers with their state, captures, suppressed firings, missed log lines and the jobs they started.";
+                data["example"] = Json{{"op", "/triggers"}, {"args", Json::object()}};
+            } else if (topic == "/disarm") {
+                data["required"] = Json::array({"trigger_id"});
+                data["note"] = "Stops watching; jobs the trigger already started are kept.";
+                data["example"] = Json{{"op", "/disarm"}, {"args", {{"trigger_id", "$arm.trigger.id"}}}};
             } else if (topic == "/status" || topic == "/stop" || topic == "/discard") {
                 data["required"] = Json::array({"job_id"});
                 data["note"] = topic == "/stop"
@@ -245,10 +318,30 @@ namespace {
                 data["bounds"] = Json{{"filter", "string <=256 bytes"}, {"sort", "field name <=64 bytes"}, {"order", "asc | desc"}, {"limit", "integer 1..50"}, {"cursor", "opaque returned cursor <=256 bytes"}};
                 data["views"] = Json{
                     {"python.cpu", Json::array({"hotspots", "calls"})},
-                    {"python.memory", Json::array({"growth", "retained"})},
+                    {"python.memory", Json::array({"growth", "retained", "calltree-roots", "calltree-children", "snapshots", "growth-rate"})},
                     {"native.cpu", Json::array({"threads", "calltree-roots", "calltree-children", "hotspots", "source-locations", "slowest-calls"})},
+                    {"frame.time", Json::array({"percentiles", "histogram", "timeseries", "worst-frames"})},
                 };
-                data["note"] = "calltree-children requires filter to be one complete node id returned by calltree-roots or a preceding child query. Preserve job_id, view, filter, sort, and order when following next_cursor.";
+                data["filter_grammar"] = Json{
+                    {"syntax", Json::array({
+                        "expression := or; or := and ('or' and)*; and := unary ('and' unary)*",
+                        "unary := 'not' unary | '(' expression ')' | field operator value | text",
+                        "operator := == | = | != | < | <= | > | >= | contains | glob | matches | ~",
+                        "value := number[unit] | \"quoted string\" | word",
+                    })},
+                    {"fields", "Any field of the queried view, plus id for the record id."},
+                    {"numbers", "<, <=, >, >=, == and != compare numeric fields. Units convert to the field's unit: ns, us, ms, s, min for time; b, kb, kib, mb, mib, gb, gib for sizes. A bare number is in the field's own unit."},
+                    {"text", "== and != compare text exactly. contains, glob (* and ? over the whole value) and matches or ~ (ECMAScript regex search) ignore case. Quote values with spaces, parentheses, quotes, or any of = ! < > ~."},
+                    {"plain_text", "A filter with no comparison at the start of a clause keeps matching as case-insensitive text over the record id and every field. A bare word inside an expression matches the same way."},
+                    {"missing_fields", "A record without the field never satisfies a comparison on it."},
+                    {"errors", Json::array({"FILTER_INVALID", "FILTER_FIELD_UNKNOWN", "FILTER_OPERATOR_INVALID", "FILTER_UNIT_INVALID"})},
+                    {"examples", Json::array({
+                        "self_time > 2ms and module contains combat/",
+                        "size_diff >= 1mib and not traceback glob '*site-packages*'",
+                        "(name ~ '^tick' or name == update) and calls > 100",
+                    })},
+                };
+                data["note"] = "calltree-children requires filter to be one complete node id returned by calltree-roots or a preceding child query; it does not accept expressions. Preserve job_id, view, filter, sort, and order when following next_cursor.";
                 data["example"] = Json{{"op", "/query"}, {"args", {{"job_id", "$start.job.id"}, {"view", "calltree-children"}, {"filter", "$root.records[0].id"}, {"limit", 20}}}};
             } else if (topic == "/compare") {
                 data["required"] = Json::array({"baseline_job_id", "candidate_job_id", "view"});
@@ -265,22 +358,43 @@ namespace {
                         {"source-locations", Json::array({"calls", "total_time", "self_time", "mean_time", "maximum_time"})},
                         {"threads", Json::array({"calls", "total_time"})},
                     }},
+                    {"frame.time", Json{{"percentiles", Json::array({"mean", "p50", "p90", "p99", "maximum"})}}},
                 };
                 data["note"] = "Both jobs must have the same profiler kind. Results align stable source identities and rank absolute deltas; added and removed entries are explicit.";
                 data["example"] = Json{{"op", "/compare"}, {"args", {{"baseline_job_id", "$history.jobs[1].id"}, {"candidate_job_id", "$history.jobs[0].id"}, {"view", "hotspots"}, {"limit", 20}}}};
+            } else if (topic == "/trend") {
+                data["required"] = Json::array({"kind", "view"});
+                data["optional"] = Json::array({"metric", "runs", "candidate_runs", "threshold_percent", "significance", "limit"});
+                data["bounds"] = Json{
+                    {"kind", "python.cpu | python.memory | native.cpu | frame.time"},
+                    {"view", "a view /compare supports for the kind"},
+                    {"metric", "a metric /compare supports for the view; defaults to the view's primary metric"},
+                    {"runs", "integer 3..50, default 10; the latest completed, non-partial disk jobs of the kind"},
+                    {"candidate_runs", "integer >= 1, default 1; the newest runs tested against the rest, which must be at least 2"},
+                    {"threshold_percent", "number 0..1000, default 10; the smallest mean change that is flagged"},
+                    {"significance", "number (0, 0.5], default 0.05; the largest p-value that is flagged"},
+                    {"limit", "integer 1..50"},
+                };
+                data["note"] = "Tests each identity of the view across the latest runs: the baseline runs give a mean and sample variance, and a two-sided t-test (Welch's, or a prediction interval for one candidate run) decides whether the candidate mean moved. verdict is regressed or improved when the change is significant and at least threshold_percent, otherwise stable; added, removed and insufficient mark identities without enough runs. Runs missing an identity are left out of its statistics. Regressions are ranked first.";
+                data["example"] = Json{{"op", "/trend"}, {"args", {{"kind", "python.cpu"}, {"view", "hotspots"}, {"metric", "self_time"}, {"runs", 10}, {"limit", 20}}}};
             } else if (topic == "/detail") {
                 data["required"] = Json::array({"job_id", "view", "record_id"});
                 data["note"] = "Use a record id and the same view that returned it. Native call-tree detail includes bounded related parent/sibling/child records.";
                 data["example"] = Json{{"op", "/detail"}, {"args", {{"job_id", "$query.job_id"}, {"view", "calltree-children"}, {"record_id", "$query.records[0].id"}}}};
             } else if (topic == "/export") {
                 data["required"] = Json::array({"job_id", "format"});
-                data["formats"] = Json::array({"markdown", "svg"});
-                data["note"] = "Export explicitly writes a report to a server-controlled path, including for memory jobs.";
+                data["formats"] = Json::array({"markdown", "svg", "json", "folded", "flamegraph", "pprof", "chrome_trace"});
+                data["note"] = "Export explicitly writes a report to a server-controlled path, including for memory jobs. "
+                               "folded writes one 'frame;frame weight' line per stack for external flame graph tools; "
+                               "flamegraph writes an interactive SVG flame graph. Stack weights are nanoseconds, or "
+                               "retained bytes for memory jobs. pprof writes a gzip profile.proto; chrome_trace writes "
+                               "trace-event JSON for chrome://tracing or Perfetto and needs a Native CPU job. "
+                               "frame.time jobs have no stacks and export markdown, svg or json only.";
                 data["example"] = Json{{"op", "/export"}, {"args", {{"job_id", "$start.job.id"}, {"format", "markdown"}}}};
             } else if (topic == "/history") {
                 data["optional"] = Json::array({"limit", "cursor"});
                 data["bounds"] = Json{{"limit", "integer 1..50"}, {"cursor", "opaque returned cursor <=256 bytes"}};
-                data["note"] = "History contains disk jobs only; temporary memory jobs are intentionally excluded.";
+                data["note"] = "History contains disk jobs only; temporary memory jobs are intentionally excluded. It is served from the storage root's catalog.json index, and each completed job reports its stored_bytes.";
                 data["example"] = Json{{"op", "/history"}, {"args", {{"limit", 10}}}};
             } else if (topic == "/cleanup") {
                 data["optional"] = Json::array({"dry_run"});
@@ -353,8 +467,9 @@ namespace {
             steps.push_back(Json{{"op", "/start"}, {"args", {{"kind", "python.cpu"}, {"duration_seconds", 15}}}});
             steps.push_back(Json{{"op", "/query"}, {"args", {{"job_id", "$start.job.id"}, {"view", "hotspots"}, {"limit", 20}}}});
         } else if (name == "memory-growth") {
-            steps.push_back(Json{{"op", "/start"}, {"args", {{"kind", "python.memory"}, {"duration_seconds", 20}}}});
-            steps.push_back(Json{{"op", "/query"}, {"args", {{"job_id", "$start.job.id"}, {"view", "growth"}, {"limit", 20}}}});
+            steps.push_back(Json{{"op", "/start"}, {"args", {{"kind", "python.memory"}, {"duration_seconds", 60}, {"snapshot_interval_seconds", 5}}}});
+            steps.push_back(Json{{"op", "/query"}, {"args", {{"job_id", "$start.job.id"}, {"view", "growth-rate"}, {"filter", "pattern == growing"}, {"limit", 20}}}});
+            steps.push_back(Json{{"op", "/query"}, {"args", {{"job_id", "$start.job.id"}, {"view", "calltree-roots"}, {"limit", 20}}}});
         } else if (name == "native-hotspot") {
             steps.push_back(Json{{"op", "/doctor"}, {"args", {{"kind", "native.cpu"}, {"deep", true}}}});
             steps.push_back(Json{{"op", "/start"}, {"args", {{"kind", "native.cpu"}, {"duration_seconds", 15}}}});
@@ -435,11 +550,36 @@ namespace mcdk::mc_profiler_mcp {
                 {"id", job.id},
                 {"kind", toString(job.kind)},
                 {"storage", toString(job.storage)},
+                {"mode", toString(job.mode)},
                 {"state", toString(job.state)},
                 {"partial", job.partial},
                 {"status_message", job.statusMessage},
                 {"created_at", job.createdAt},
                 {"completed_at", job.completedAt.empty() ? Json(nullptr) : Json(job.completedAt)},
+                {"stored_bytes", job.storage == ProfileStorage::Disk && job.state == JobState::Completed
+                    ? Json(job.storedBytes) : Json(nullptr)},
+                {"trigger", job.trigger ? Json{
+                    {"trigger_id", job.trigger->triggerId},
+                    {"condition", toString(job.trigger->condition)},
+                    {"detail", job.trigger->detail},
+                    {"fired_at", job.trigger->firedAt},
+                } : Json(nullptr)},
+            };
+        }
+
+        Json triggerJson(const TriggerSnapshot& trigger) {
+            return Json{
+                {"id", trigger.id},
+                {"condition", toString(trigger.condition)},
+                {"state", toString(trigger.state)},
+                {"captures", trigger.captures},
+                {"max_captures", trigger.maximumCaptures},
+                {"suppressed", trigger.suppressed},
+                {"missed_log_lines", trigger.missedLogLines},
+                {"job_ids", trigger.jobs},
+                {"status_message", trigger.statusMessage},
+                {"armed_at", trigger.armedAt},
+                {"last_fired_at", trigger.lastFiredAt.empty() ? Json(nullptr) : Json(trigger.lastFiredAt)},
             };
         }
 
@@ -493,6 +633,7 @@ namespace mcdk::mc_profiler_mcp {
             if (kind == "python.cpu") return ProfilerKind::PythonCpu;
             if (kind == "python.memory") return ProfilerKind::PythonMemory;
             if (kind == "native.cpu") return ProfilerKind::NativeCpu;
+            if (kind == "frame.time") return ProfilerKind::FrameTime;
             return std::nullopt;
         }
 
@@ -511,6 +652,91 @@ namespace mcdk::mc_profiler_mcp {
             return makeToolResult(std::move(envelope), std::move(summary));
         }
 
+        // Reads the bounded options of a capture, as /start takes them and /arm takes its capture.
+        std::optional<Json> parseStartArgs(std::string_view op, const Json& args, StartRequest& request) {
+            if (!hasOnlyFields(args, {"kind", "target", "clock", "storage", "duration_seconds", "traceback_depth", "collect_garbage", "snapshot_interval_seconds", "mode", "recorder_budget_mb", "engine", "sample_hz"})
+                || !args.contains("kind") || !args["kind"].is_string()) {
+                return staticArgumentError(op, std::string(op == "/start" ? "/start" : "capture") + " requires kind and accepts only bounded profiler options.");
+            }
+            const auto kind = parseKind(args["kind"]);
+            if (!kind) return staticArgumentError(op, "kind must be python.cpu, python.memory, native.cpu, or frame.time.");
+            request.kind = *kind;
+            if (args.contains("target")) {
+                const auto target = parseTarget(args["target"]);
+                if (!target) return staticArgumentError(op, "target must be client, server, or all.");
+                request.target = *target;
+            }
+            if (args.contains("clock")) {
+                if (!args["clock"].is_string()) return staticArgumentError(op, "clock must be cpu or wall.");
+                const auto clock = args["clock"].get<std::string>();
+                if (clock != "cpu" && clock != "wall") return staticArgumentError(op, "clock must be cpu or wall.");
+                request.clock = clock == "cpu" ? ProfileClock::Cpu : ProfileClock::Wall;
+            }
+            if (args.contains("storage")) {
+                if (!args["storage"].is_string()) return staticArgumentError(op, "storage must be memory or disk.");
+                const auto storage = args["storage"].get<std::string>();
+                if (storage != "memory" && storage != "disk") {
+                    return staticArgumentError(op, "storage must be memory or disk.");
+                }
+                request.storage = storage == "disk" ? ProfileStorage::Disk : ProfileStorage::Memory;
+            }
+            if (args.contains("duration_seconds")) {
+                if (!args["duration_seconds"].is_number_integer()) return staticArgumentError(op, "duration_seconds must be an integer.");
+                const auto duration = args["duration_seconds"].get<std::int64_t>();
+                if (duration < 1 || duration > 300) return staticArgumentError(op, "duration_seconds must be between 1 and 300.");
+                request.duration = std::chrono::seconds(duration);
+            }
+            if (args.contains("traceback_depth")) {
+                if (!args["traceback_depth"].is_number_unsigned() && !args["traceback_depth"].is_number_integer()) {
+                    return staticArgumentError(op, "traceback_depth must be an integer from 1 to 16.");
+                }
+                const auto depth = args["traceback_depth"].get<std::int64_t>();
+                if (depth < 1 || depth > 16) return staticArgumentError(op, "traceback_depth must be an integer from 1 to 16.");
+                request.tracebackDepth = static_cast<std::size_t>(depth);
+            }
+            if (args.contains("collect_garbage")) {
+                if (!args["collect_garbage"].is_boolean()) return staticArgumentError(op, "collect_garbage must be boolean.");
+                request.collectGarbage = args["collect_garbage"].get<bool>();
+            }
+            if (args.contains("snapshot_interval_seconds")) {
+                if (!args["snapshot_interval_seconds"].is_number_integer()) return staticArgumentError(op, "snapshot_interval_seconds must be an integer.");
+                const auto interval = args["snapshot_interval_seconds"].get<std::int64_t>();
+                if (interval < 1 || interval >= request.duration.count() || request.kind != ProfilerKind::PythonMemory) {
+                    return staticArgumentError(op, "snapshot_interval_seconds must be at least 1, shorter than duration_seconds, and needs kind=python.memory.");
+                }
+                request.snapshotInterval = std::chrono::seconds(interval);
+            }
+            if (args.contains("mode")) {
+                if (!args["mode"].is_string()) return staticArgumentError(op, "mode must be capture or recorder.");
+                const auto mode = args["mode"].get<std::string>();
+                if (mode != "capture" && mode != "recorder") return staticArgumentError(op, "mode must be capture or recorder.");
+                request.mode = mode == "recorder" ? ProfileMode::Recorder : ProfileMode::Capture;
+            }
+            if (args.contains("recorder_budget_mb")) {
+                if (!args["recorder_budget_mb"].is_number_integer()) return staticArgumentError(op, "recorder_budget_mb must be an integer.");
+                const auto budget = args["recorder_budget_mb"].get<std::int64_t>();
+                if (budget < 1 || budget > 256 || request.mode != ProfileMode::Recorder) {
+                    return staticArgumentError(op, "recorder_budget_mb must be between 1 and 256 and needs mode=recorder.");
+                }
+                request.recorderBytes = static_cast<std::size_t>(budget) * 1024 * 1024;
+            }
+            if (args.contains("engine")) {
+                if (!args["engine"].is_string()) return staticArgumentError(op, "engine must be tracing or sampling.");
+                const auto engine = args["engine"].get<std::string>();
+                if (engine != "tracing" && engine != "sampling") return staticArgumentError(op, "engine must be tracing or sampling.");
+                request.engine = engine == "sampling" ? ProfileEngine::Sampling : ProfileEngine::Tracing;
+            }
+            if (args.contains("sample_hz")) {
+                if (!args["sample_hz"].is_number_integer()) return staticArgumentError(op, "sample_hz must be an integer.");
+                const auto rate = args["sample_hz"].get<std::int64_t>();
+                if (rate < 10 || rate > 1000 || request.engine != ProfileEngine::Sampling) {
+                    return staticArgumentError(op, "sample_hz must be between 10 and 1000 and needs engine=sampling.");
+                }
+                request.sampleHertz = static_cast<std::uint32_t>(rate);
+            }
+            return std::nullopt;
+        }
+
         std::string pathUtf8(const std::filesystem::path& path) {
             const auto value = path.generic_u8string();
             return std::string(reinterpret_cast<const char*>(value.data()), value.size());
@@ -669,7 +895,7 @@ namespace mcdk::mc_profiler_mcp {
             DoctorRequest request;
             if (args.contains("kind")) {
                 request.kind = parseKind(args["kind"]);
-                if (!request.kind) return staticArgumentError(op, "kind must be python.cpu, python.memory, or native.cpu.");
+                if (!request.kind) return staticArgumentError(op, "kind must be python.cpu, python.memory, native.cpu, or frame.time.");
             }
             request.deep = args.value("deep", false);
             if (request.deep && (!request.kind || *request.kind != ProfilerKind::NativeCpu)) {
@@ -689,55 +915,129 @@ namespace mcdk::mc_profiler_mcp {
         }
 
         if (op == "/start") {
-            if (!hasOnlyFields(args, {"kind", "target", "clock", "storage", "duration_seconds", "traceback_depth", "collect_garbage"})
-                || !args.contains("kind") || !args["kind"].is_string()) {
-                return staticArgumentError(op, "/start requires kind and accepts only bounded profiler options.");
-            }
             StartRequest request;
-            const auto kind = parseKind(args["kind"]);
-            if (!kind) return staticArgumentError(op, "kind must be python.cpu, python.memory, or native.cpu.");
-            request.kind = *kind;
-            if (args.contains("target")) {
-                const auto target = parseTarget(args["target"]);
-                if (!target) return staticArgumentError(op, "target must be client, server, or all.");
-                request.target = *target;
+            if (auto invalid = parseStartArgs(op, args, request)) return std::move(*invalid);
+            auto result = (*service)->start(request);
+            if (!result) return domainError(op, result.error());
+            Json data{{"storage", toString(request.storage)}};
+            if (request.kind == ProfilerKind::PythonCpu) data["engine"] = toString(request.engine);
+            if (request.engine == ProfileEngine::Sampling) data["sample_hz"] = request.sampleHertz;
+            if (request.snapshotInterval.count() > 0) data["snapshot_interval_seconds"] = request.snapshotInterval.count();
+            if (request.mode == ProfileMode::Recorder) {
+                data["window_seconds"] = request.duration.count();
+                data["recorder_budget_bytes"] = request.recorderBytes;
+                Json next = Json::array({nextCall("/snapshot", Json{{"job_id", result->id}}, "Freeze the rolling window after a stutter.")});
+                return successResult(op, std::move(data), jobJson(*result), Json::array(), std::move(next), "Flight recorder " + result->id + " started; it runs until stopped.");
             }
-            if (args.contains("clock")) {
-                if (!args["clock"].is_string()) return staticArgumentError(op, "clock must be cpu or wall.");
-                const auto clock = args["clock"].get<std::string>();
-                if (clock != "cpu" && clock != "wall") return staticArgumentError(op, "clock must be cpu or wall.");
-                request.clock = clock == "cpu" ? ProfileClock::Cpu : ProfileClock::Wall;
+            data["deadline_seconds"] = request.duration.count();
+            Json next = Json::array({nextCall("/status", Json{{"job_id", result->id}}, "Observe automatic finalization without extending the deadline.")});
+            return successResult(op, std::move(data), jobJson(*result), Json::array(), std::move(next), "Profiler job " + result->id + " started with a server deadline.");
+        }
+
+        if (op == "/snapshot") {
+            if (!hasOnlyFields(args, {"job_id"}) || !args.contains("job_id") || !args["job_id"].is_string()) {
+                return staticArgumentError(op, "/snapshot requires only string job_id.");
             }
-            if (args.contains("storage")) {
-                if (!args["storage"].is_string()) return staticArgumentError(op, "storage must be memory or disk.");
-                const auto storage = args["storage"].get<std::string>();
-                if (storage != "memory" && storage != "disk") {
-                    return staticArgumentError(op, "storage must be memory or disk.");
+            const auto jobId = args["job_id"].get<std::string>();
+            if (jobId.empty() || jobId.size() > 128) return staticArgumentError(op, "job_id is invalid.");
+            auto result = (*service)->snapshot(jobId);
+            if (!result) return domainError(op, result.error());
+            Json next = Json::array();
+            if (result->state == JobState::Completed) {
+                next.push_back(nextCall("/query", Json{{"job_id", result->id}, {"view", "hotspots"}}, "Inspect the frozen window."));
+            }
+            return successResult(op, Json{{"recorder_job_id", jobId}}, jobJson(*result), Json::array(), std::move(next), "Flight recorder window was frozen into job " + result->id + ".");
+        }
+
+        if (op == "/arm") {
+            if (!hasOnlyFields(args, {"condition", "side", "tick_ms", "consecutive_ticks", "pattern", "regex", "cooldown_seconds", "max_captures", "capture"})
+                || !args.contains("condition") || !args["condition"].is_string()
+                || !args.contains("capture") || !args["capture"].is_object()) {
+                return staticArgumentError(op, "/arm requires condition and a capture object plus optional bounded trigger fields.");
+            }
+            TriggerRequest request;
+            const auto condition = args["condition"].get<std::string>();
+            if (condition != "tick_time" && condition != "log_pattern") {
+                return staticArgumentError(op, "condition must be tick_time or log_pattern.");
+            }
+            request.condition = condition == "log_pattern" ? TriggerCondition::LogPattern : TriggerCondition::TickTime;
+            const bool ticks = request.condition == TriggerCondition::TickTime;
+            if ((!ticks && (args.contains("side") || args.contains("tick_ms") || args.contains("consecutive_ticks")))
+                || (ticks && (args.contains("pattern") || args.contains("regex")))) {
+                return staticArgumentError(op, "side, tick_ms and consecutive_ticks need tick_time; pattern and regex need log_pattern.");
+            }
+            if (args.contains("side")) {
+                const auto side = parseTarget(args["side"]);
+                if (!side || *side == ProfileTarget::All) return staticArgumentError(op, "side must be server or client.");
+                request.side = *side;
+            }
+            if (args.contains("tick_ms")) {
+                if (!args["tick_ms"].is_number()) return staticArgumentError(op, "tick_ms must be a number.");
+                request.tickMilliseconds = args["tick_ms"].get<double>();
+                if (!(request.tickMilliseconds >= 1 && request.tickMilliseconds <= 10000)) {
+                    return staticArgumentError(op, "tick_ms must be between 1 and 10000.");
                 }
-                request.storage = storage == "disk" ? ProfileStorage::Disk : ProfileStorage::Memory;
             }
-            if (args.contains("duration_seconds")) {
-                if (!args["duration_seconds"].is_number_integer()) return staticArgumentError(op, "duration_seconds must be an integer.");
-                const auto duration = args["duration_seconds"].get<std::int64_t>();
-                if (duration < 1 || duration > 300) return staticArgumentError(op, "duration_seconds must be between 1 and 300.");
-                request.duration = std::chrono::seconds(duration);
+            if (args.contains("consecutive_ticks")) {
+                if (!args["consecutive_ticks"].is_number_integer()) return staticArgumentError(op, "consecutive_ticks must be an integer.");
+                const auto count = args["consecutive_ticks"].get<std::int64_t>();
+                if (count < 1 || count > 1200) return staticArgumentError(op, "consecutive_ticks must be between 1 and 1200.");
+                request.consecutiveTicks = static_cast<std::uint32_t>(count);
             }
-            if (args.contains("traceback_depth")) {
-                if (!args["traceback_depth"].is_number_unsigned() && !args["traceback_depth"].is_number_integer()) {
-                    return staticArgumentError(op, "traceback_depth must be an integer from 1 to 16.");
+            if (!ticks) {
+                if (!args.contains("pattern") || !args["pattern"].is_string() || args["pattern"].get_ref<const std::string&>().empty()
+                    || args["pattern"].get_ref<const std::string&>().size() > 256) {
+                    return staticArgumentError(op, "log_pattern needs a pattern string of 1 to 256 bytes.");
+                }
+                request.logPattern = args["pattern"].get<std::string>();
+                if (args.contains("regex")) {
+                    if (!args["regex"].is_boolean()) return staticArgumentError(op, "regex must be boolean.");
+                    request.logRegex = args["regex"].get<bool>();
                 }
-                const auto depth = args["traceback_depth"].get<std::int64_t>();
-                if (depth < 1 || depth > 16) return staticArgumentError(op, "traceback_depth must be an integer from 1 to 16.");
-                request.tracebackDepth = static_cast<std::size_t>(depth);
             }
-            if (args.contains("collect_garbage")) {
-                if (!args["collect_garbage"].is_boolean()) return staticArgumentError(op, "collect_garbage must be boolean.");
-                request.collectGarbage = args["collect_garbage"].get<bool>();
+            if (args.contains("cooldown_seconds")) {
+                if (!args["cooldown_seconds"].is_number_integer()) return staticArgumentError(op, "cooldown_seconds must be an integer.");
+                const auto cooldown = args["cooldown_seconds"].get<std::int64_t>();
+                if (cooldown < 0 || cooldown > 3600) return staticArgumentError(op, "cooldown_seconds must be between 0 and 3600.");
+                request.cooldown = std::chrono::seconds(cooldown);
             }
-            auto result = (*service)->start(request);
+            if (args.contains("max_captures")) {
+                if (!args["max_captures"].is_number_integer()) return staticArgumentError(op, "max_captures must be an integer.");
+                const auto captures = args["max_captures"].get<std::int64_t>();
+                if (captures < 1 || captures > 20) return staticArgumentError(op, "max_captures must be between 1 and 20.");
+                request.maximumCaptures = static_cast<std::uint32_t>(captures);
+            }
+            if (auto invalid = parseStartArgs(op, args["capture"], request.capture)) return std::move(*invalid);
+            auto result = (*service)->arm(request);
             if (!result) return domainError(op, result.error());
-            Json next = Json::array({nextCall("/status", Json{{"job_id", result->id}}, "Observe automatic finalization without extending the deadline.")});
-            return successResult(op, Json{{"deadline_seconds", request.duration.count()}, {"storage", toString(request.storage)}}, jobJson(*result), Json::array(), std::move(next), "Profiler job " + result->id + " started with a server deadline.");
+            Json next = Json::array({nextCall("/triggers", Json::object(), "Check which captures the trigger has started.")});
+            return successResult(op, Json{{"trigger", triggerJson(*result)}}, nullptr, Json::array(), std::move(next), "Profiler trigger " + result->id + " is armed.");
+        }
+
+        if (op == "/triggers") {
+            if (!args.empty()) return staticArgumentError(op, "/triggers accepts no args.");
+            auto result = (*service)->triggers();
+            if (!result) return domainError(op, result.error());
+            Json triggers = Json::array();
+            Json next = Json::array();
+            for (const auto& trigger : *result) {
+                triggers.push_back(triggerJson(trigger));
+                if (!trigger.jobs.empty() && next.size() < 3) {
+                    next.push_back(nextCall("/status", Json{{"job_id", trigger.jobs.back()}}, "Inspect the latest capture this trigger started."));
+                }
+            }
+            return successResult(op, Json{{"triggers", std::move(triggers)}}, nullptr, Json::array(), std::move(next), "Profiler triggers are available in structuredContent.");
+        }
+
+        if (op == "/disarm") {
+            if (!hasOnlyFields(args, {"trigger_id"}) || !args.contains("trigger_id") || !args["trigger_id"].is_string()) {
+                return staticArgumentError(op, "/disarm requires only string trigger_id.");
+            }
+            const auto triggerId = args["trigger_id"].get<std::string>();
+            if (triggerId.empty() || triggerId.size() > 128) return staticArgumentError(op, "trigger_id is invalid.");
+            auto result = (*service)->disarm(triggerId);
+            if (!result) return domainError(op, result.error());
+            return successResult(op, Json{{"trigger", triggerJson(*result)}}, nullptr, Json::array(), Json::array(), "Profiler trigger " + triggerId + " is disarmed.");
         }
 
         if (op == "/status" || op == "/stop" || op == "/discard") {
@@ -755,8 +1055,12 @@ namespace mcdk::mc_profiler_mcp {
             if (!result) return domainError(op, result.error());
             Json next = Json::array();
             if (result->state == JobState::Completed) {
-                const auto view = result->kind == ProfilerKind::PythonMemory ? "growth" : "hotspots";
+                const auto view = result->kind == ProfilerKind::PythonMemory ? "growth"
+                                : result->kind == ProfilerKind::FrameTime    ? "percentiles"
+                                                                             : "hotspots";
                 next.push_back(nextCall("/query", Json{{"job_id", jobId}, {"view", view}}, "Inspect the server-ranked bounded result."));
+            } else if (result->mode == ProfileMode::Recorder && result->state == JobState::Running) {
+                next.push_back(nextCall("/snapshot", Json{{"job_id", jobId}}, "Freeze the rolling window after a stutter."));
             }
             else next.push_back(nextCall("/status", Json{{"job_id", jobId}}, "Check finalization without extending the deadline."));
             return successResult(op, Json::object(), jobJson(*result), Json::array(), std::move(next), "Profiler job status is available in structuredContent.");
@@ -805,7 +1109,7 @@ namespace mcdk::mc_profiler_mcp {
                 {"returned", result->records.size()}, {"truncated", result->truncated},
                 {"next_cursor", result->nextCursor ? Json(*result->nextCursor) : Json(nullptr)},
             };
-            if (request.view == "growth" || request.view == "retained") {
+            if (request.view == "growth" || request.view == "retained" || request.view == "growth-rate" || request.view == "snapshots") {
                 data["scope"] = "process-wide Python allocations";
                 data["control_side"] = "client";
             }
@@ -870,6 +1174,89 @@ namespace mcdk::mc_profiler_mcp {
             );
         }
 
+        if (op == "/trend") {
+            if (!hasOnlyFields(args, {"kind", "view", "metric", "runs", "candidate_runs", "threshold_percent", "significance", "limit"})
+                || !args.contains("kind") || !args.contains("view") || !args["view"].is_string()) {
+                return staticArgumentError(op, "/trend requires kind and view plus optional metric, runs, candidate_runs, threshold_percent, significance and limit.");
+            }
+            TrendRequest request{.view = args["view"].get<std::string>()};
+            const auto kind = parseKind(args["kind"]);
+            if (!kind) return staticArgumentError(op, "kind must be python.cpu, python.memory, native.cpu, or frame.time.");
+            request.kind = *kind;
+            if (request.view.empty() || request.view.size() > 64) return staticArgumentError(op, "view is invalid.");
+            if (args.contains("metric")) {
+                if (!args["metric"].is_string() || args["metric"].get_ref<const std::string&>().empty()
+                    || args["metric"].get_ref<const std::string&>().size() > 64) {
+                    return staticArgumentError(op, "metric must be a non-empty field name of at most 64 bytes.");
+                }
+                request.metric = args["metric"].get<std::string>();
+            }
+            if (args.contains("runs")) {
+                if (!args["runs"].is_number_integer()) return staticArgumentError(op, "runs must be an integer from 3 to 50.");
+                const auto runs = args["runs"].get<std::int64_t>();
+                if (runs < 3 || runs > 50) return staticArgumentError(op, "runs must be an integer from 3 to 50.");
+                request.runs = static_cast<std::size_t>(runs);
+            }
+            if (args.contains("candidate_runs")) {
+                if (!args["candidate_runs"].is_number_integer()) return staticArgumentError(op, "candidate_runs must be an integer.");
+                const auto candidates = args["candidate_runs"].get<std::int64_t>();
+                if (candidates < 1 || candidates + 2 > static_cast<std::int64_t>(request.runs)) {
+                    return staticArgumentError(op, "candidate_runs must be at least 1 and leave at least two baseline runs.");
+                }
+                request.candidateRuns = static_cast<std::size_t>(candidates);
+            }
+            if (args.contains("threshold_percent")) {
+                if (!args["threshold_percent"].is_number()) return staticArgumentError(op, "threshold_percent must be a number.");
+                request.thresholdPercent = args["threshold_percent"].get<double>();
+                if (!(request.thresholdPercent >= 0 && request.thresholdPercent <= 1000)) {
+                    return staticArgumentError(op, "threshold_percent must be between 0 and 1000.");
+                }
+            }
+            if (args.contains("significance")) {
+                if (!args["significance"].is_number()) return staticArgumentError(op, "significance must be a number.");
+                request.significance = args["significance"].get<double>();
+                if (!(request.significance > 0 && request.significance <= 0.5)) {
+                    return staticArgumentError(op, "significance must be above 0 and at most 0.5.");
+                }
+            }
+            if (args.contains("limit")) {
+                if (!args["limit"].is_number_integer()) return staticArgumentError(op, "limit must be an integer from 1 to 50.");
+                const auto limit = args["limit"].get<std::int64_t>();
+                if (limit < 1 || limit > 50) return staticArgumentError(op, "limit must be an integer from 1 to 50.");
+                request.limit = static_cast<std::size_t>(limit);
+            }
+            auto result = (*service)->trend(request);
+            if (!result) return domainError(op, result.error());
+            Json records = Json::array();
+            for (const auto& record : result->records) records.push_back(recordJson(record));
+            Json next = Json::array();
+            if (result->regressed > 0 && result->jobIds.size() >= 2) {
+                next.push_back(nextCall(
+                    "/compare",
+                    Json{{"baseline_job_id", result->jobIds[result->jobIds.size() - 2]}, {"candidate_job_id", result->jobIds.back()}, {"view", request.view}, {"limit", 20}},
+                    "Compare the newest run with the one before it in full."
+                ));
+            }
+            return successResult(
+                op,
+                Json{
+                    {"metric", result->metric},
+                    {"job_ids", result->jobIds},
+                    {"records", std::move(records)},
+                    {"returned", result->records.size()},
+                    {"series", result->series},
+                    {"regressed", result->regressed},
+                    {"improved", result->improved},
+                    {"truncated", result->truncated},
+                },
+                nullptr,
+                Json::array(),
+                std::move(next),
+                result->regressed > 0 ? std::to_string(result->regressed) + " profiler regressions were flagged; details are in structuredContent."
+                                      : "Profiler trend statistics are available in structuredContent."
+            );
+        }
+
         if (op == "/detail") {
             if (!hasOnlyFields(args, {"job_id", "view", "record_id"}) || !args.contains("job_id") || !args["job_id"].is_string()
                 || !args.contains("view") || !args["view"].is_string() || !args.contains("record_id") || !args["record_id"].is_string()) {
@@ -915,12 +1302,29 @@ namespace mcdk::mc_profiler_mcp {
                 return staticArgumentError(op, "/export requires only string job_id and format.");
             }
             const auto format = args["format"].get<std::string>();
-            if (format != "markdown" && format != "svg") return staticArgumentError(op, "format must be markdown or svg.");
+            constexpr std::array<std::pair<std::string_view, ExportFormat>, 7> formats{{
+                {"markdown", ExportFormat::Markdown},
+                {"svg", ExportFormat::Svg},
+                {"json", ExportFormat::Json},
+                {"folded", ExportFormat::Folded},
+                {"flamegraph", ExportFormat::FlameGraph},
+                {"pprof", ExportFormat::Pprof},
+                {"chrome_trace", ExportFormat::ChromeTrace},
+            }};
+            const auto selected = std::find_if(formats.begin(), formats.end(), [&](const auto& entry) {
+                return entry.first == format;
+            });
+            if (selected == formats.end()) {
+                return staticArgumentError(op, "format must be markdown, svg, json, folded, flamegraph, pprof or chrome_trace.");
+            }
             if (args["job_id"].get_ref<const std::string&>().empty()
                 || args["job_id"].get_ref<const std::string&>().size() > 128) {
                 return staticArgumentError(op, "job_id is invalid.");
             }
-            ExportRequest request{args["job_id"].get<std::string>(), format == "svg" ? ExportFormat::Svg : ExportFormat::Markdown};
+            ExportRequest request{
+                args["job_id"].get<std::string>(),
+                selected->second
+            };
             auto result = (*service)->exportReport(request);
             if (!result) return domainError(op, result.error());
             return successResult(op, Json{{"artifact", {{"path", pathUtf8(result->path)}, {"size", result->size}, {"sha256", result->sha256}}}}, nullptr, Json::array(), Json::array(), "Profiler report was written to a server-controlled path.");
@@ -944,12 +1348,18 @@ namespace mcdk::mcp_tool_definitions {
         mcp::tool tool;
         tool.name = std::string(mc_profiler_mcp::ToolName);
         tool.description =
-            "Profiles Minecraft Python CPU, Python memory, and optional Native CPU through one bounded command tool. "
+            "Profiles Minecraft Python CPU, Python memory, optional Native CPU, and server tick and client frame times "
+            "through one bounded command tool. "
             "Native profiles can correlate instrumented Python-facing and engine C++ Tracy zone hierarchies, including "
             "lower-level stages such as data-driven JSON parsing when those zones are emitted. Call /help first. Every "
-            "capture has a server deadline; temporary memory results expire after 20 idle minutes, and Markdown/SVG "
-            "reports are explicit exports. Results are filtered and paged; same-kind captures support bounded "
-            "server-side comparison. Input uses {op:'/...', args:{...}}.";
+            "capture has a server deadline, Python CPU can trace every call or sample stacks at a fixed rate with far less "
+            "overhead, a Python CPU flight recorder keeps a bounded rolling window that /snapshot "
+            "freezes into a job, /arm triggers start tagged captures on tick spikes or log patterns, and Python memory "
+            "builds an allocation call tree and can fit per-site growth slopes over periodic snapshots; temporary memory results expire after 20 idle minutes, and Markdown/SVG/JSON "
+            "reports, folded stacks, flame graphs, pprof profiles and Chrome traces are explicit exports. Results are "
+            "filtered and paged; same-kind captures support bounded server-side comparison, and /trend tests the latest "
+            "disk runs of a kind for significant regressions. Input uses "
+            "{op:'/...', args:{...}}.";
         tool.parameters_schema = {
             {"type", "object"},
             {"required", Json::array({"op"})},
@@ -3,6 +3,9 @@
 #include <algorithm>
 #include <atomic>
 #include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <expected>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -11,8 +14,10 @@
 #include <cstdint>
 #include <functional>
 #include <log_buffer.hpp>
+#include <log_stream.hpp>
 #include <mcp_tool_definitions.hpp>
 #include <mc_profiler_mcp.hpp>
+#include <traceback_aggregator.hpp>
 #include <jsonui_debugger.hpp>
 #include <jsonui_reload_support.hpp>
 #include <nlohmann/json.hpp>
@@ -72,16 +77,18 @@ namespace mcdk {
         using BoolParamHandler = std::function<bool(bool param)>;
 
     private:
-        McpServerConfig              config;
-        std::shared_ptr<LogBuffer>   logBuffer;          // 用于存储日志的缓冲区
-        std::shared_ptr<LogBuffer>   errBuffer;          // 用于存储错误日志的缓冲区
-        std::shared_ptr<mcp::server> server;             // MCP服务器实例
-        CodeExecuteHandler           codeExecuteHandler; // 代码执行处理器
-        ProfilerHandler              profilerHandler;
-        BoolParamHandler             reloadGameHandler;  // 重载游戏/Addon处理器
-        SimpleHandler                reloadUiHandler;    // 重载 UI definition 处理器
+        McpServerConfig                      config;
+        std::shared_ptr<LogBuffer>           logBuffer;          // 用于存储日志的缓冲区
+        std::shared_ptr<LogBuffer>           errBuffer;          // 用于存储错误日志的缓冲区
+        std::shared_ptr<TracebackAggregator> tracebacks;         // 按签名聚合的 Python 异常
+        std::shared_ptr<mcp::server>         server;             // MCP服务器实例
+        std::unique_ptr<LogStreamHub>        logStream;          // 日志订阅推送
+        CodeExecuteHandler                   codeExecuteHandler; // 代码执行处理器
+        ProfilerHandler                      profilerHandler;
+        BoolParamHandler                     reloadGameHandler;  // 重载游戏/Addon处理器
+        SimpleHandler                        reloadUiHandler;    // 重载 UI definition 处理器
         // The process id is published after server startup and read by HTTP worker threads.
-        std::atomic<int>             mcPid = 0;
+        std::atomic<int>                     mcPid = 0;
 
     public:
         explicit Impl(const McpServerConfig& cfg) : config(cfg) {}
@@ -89,6 +96,9 @@ namespace mcdk {
 
         void setLogBuffer(std::shared_ptr<LogBuffer> buffer) { logBuffer = std::move(buffer); }
         void setErrBuffer(std::shared_ptr<LogBuffer> buffer) { errBuffer = std::move(buffer); }
+        void setTracebackAggregator(std::shared_ptr<TracebackAggregator> aggregator) {
+            tracebacks = std::move(aggregator);
+        }
         void setCodeExecuteHandler(CodeExecuteHandler handler) { codeExecuteHandler = std::move(handler); }
         void setProfilerHandler(ProfilerHandler handler) { profilerHandler = std::move(handler); }
         void setReloadGameHandler(BoolParamHandler handler) { reloadGameHandler = std::move(handler); }
@@ -96,14 +106,72 @@ namespace mcdk {
         void setMinecraftProcessId(int pid) { mcPid.store(pid, std::memory_order_relaxed); }
         int  getMinecraftProcessId() const { return mcPid.load(std::memory_order_relaxed); }
 
-        static nlohmann::json _logVectorToJson(const std::vector<std::string>& logVector) {
+        // JSON is built after LogBuffer has released its lock; the buffer only hands out one copied block.
+        static nlohmann::json _logLinesToJson(const LogLines& logLines) {
             nlohmann::json jsonArray = nlohmann::json::array();
-            for (const auto& log : logVector) {
+            for (const auto log : logLines.lines) {
                 jsonArray.push_back({{"type", "text"}, {"text", log}});
             }
             return jsonArray;
         }
 
+        // 一个会话一轮只发一条通知；会话不存在或 SSE 流积压超限时返回 false，由 LogStreamHub 取消其订阅
+        bool _publishLogBatches(const std::string& sessionId, const std::vector<LogStreamBatch>& batches) {
+            LogLevel       maxLevel = LogLevel::Debug;
+            nlohmann::json data     = nlohmann::json::array();
+            for (const auto& batch : batches) {
+                nlohmann::json lines = nlohmann::json::array();
+                for (const auto& line : batch.lines) {
+                    maxLevel = std::max(maxLevel, line.level);
+                    lines.push_back(
+                        {{"sequence", line.sequence}, {"level", logLevelName(line.level)}, {"text", line.text}}
+                    );
+                }
+                data.push_back({
+                    {"subscription_id", batch.subscriptionId},
+                    {"lines", std::move(lines)},
+                    {"skipped", batch.skipped},
+                    {"cursor", batch.cursor},
+                });
+            }
+            return server->send_request(
+                sessionId,
+                mcp::request::create_notification(
+                    "message",
+                    {{"level", logLevelName(maxLevel)},
+                     {"logger", "mcdk.logs"},
+                     {"data", {{"batches", std::move(data)}}}}
+                )
+            );
+        }
+
+        // 解析逗号分隔的日志级别列表（如 "error,warn"），空串表示不过滤
+        static std::expected<std::uint32_t, std::string> _parseLevelMask(const std::string& levels) {
+            std::uint32_t mask = 0;
+            for (size_t begin = 0; begin <= levels.size();) {
+                auto end = levels.find(',', begin);
+                if (end == std::string::npos) {
+                    end = levels.size();
+                }
+                auto name = std::string_view(levels).substr(begin, end - begin);
+                while (!name.empty() && name.front() == ' ') {
+                    name.remove_prefix(1);
+                }
+                while (!name.empty() && name.back() == ' ') {
+                    name.remove_suffix(1);
+                }
+                if (!name.empty()) {
+                    const auto level = parseLogLevel(name);
+                    if (!level) {
+                        return std::unexpected("Unknown log level: " + std::string(name));
+                    }
+                    mask |= logLevelBit(*level);
+                }
+                begin = end + 1;
+            }
+            return mask;
+        }
+
         // 初始化日志相关的工具
         void initLogTool() {
             mcp::tool logTool = mcp_tool_definitions::buildGetLatestLogsTool();
@@ -120,9 +188,9 @@ namespace mcdk {
                         };
                     }
                     if (order == "desc") {
-                        return _logVectorToJson(logBuffer->getLatestReversed(maxCount));
+                        return _logLinesToJson(logBuffer->getLatestReversed(maxCount));
                     }
-                    return _logVectorToJson(logBuffer->getLatest(maxCount));
+                    return _logLinesToJson(logBuffer->getLatest(maxCount));
                 }
             );
 
@@ -141,9 +209,9 @@ namespace mcdk {
                         };
                     }
                     if (order == "desc") {
-                        return _logVectorToJson(logBuffer->getRangeReversed(startIndex, endIndex));
+                        return _logLinesToJson(logBuffer->getRangeReversed(startIndex, endIndex));
                     }
-                    return _logVectorToJson(logBuffer->getRange(startIndex, endIndex));
+                    return _logLinesToJson(logBuffer->getRange(startIndex, endIndex));
                 }
             );
 
@@ -164,9 +232,257 @@ namespace mcdk {
                         };
                     }
                     if (order == "desc") {
-                        return _logVectorToJson(errBuffer->getLatestReversed(maxCount));
+                        return _logLinesToJson(errBuffer->getLatestReversed(maxCount));
+                    }
+                    return _logLinesToJson(errBuffer->getLatest(maxCount));
+                }
+            );
+
+            // 增量日志工具：按序号游标只返回新行，轮询成本与新增行数成正比
+            mcp::tool sinceLogTool = mcp_tool_definitions::buildGetLogsSinceTool();
+
+            server->register_tool(
+                sinceLogTool,
+                [this](const nlohmann::json& params, const std::string& /* session_id */) -> nlohmann::json {
+                    const auto errorResult = [](const std::string& message) {
+                        return nlohmann::json{
+                            {"isError", true},
+                            {"content", nlohmann::json::array({{{"type", "text"}, {"text", message}}})}
+                        };
+                    };
+                    // 单次返回行数有上限：游标落在磁盘 spool 很早的位置时也只读取一页，而不是整个会话历史
+                    size_t maxCount = 200;
+                    if (params.contains("max_count")) {
+                        const auto& value = params["max_count"];
+                        const bool inRange = value.is_number_integer() && value.get<std::int64_t>() >= 1
+                                          && value.get<std::int64_t>() <= 1000;
+                        if (!inRange) {
+                            return errorResult("max_count must be between 1 and 1000");
+                        }
+                        maxCount = value.get<size_t>();
+                    }
+                    std::string stream = "all";
+                    if (params.contains("stream")) {
+                        if (!params["stream"].is_string()
+                            || (params["stream"] != "all" && params["stream"] != "error")) {
+                            return errorResult("stream must be \"all\" or \"error\"");
+                        }
+                        stream = params["stream"].get<std::string>();
+                    }
+                    const uint64_t cursor = params.value("cursor", uint64_t{0});
+                    const auto&    buffer = stream == "error" ? errBuffer : logBuffer;
+                    if (!buffer) {
+                        return errorResult("Log buffer not set");
                     }
-                    return _logVectorToJson(errBuffer->getLatest(maxCount));
+
+                    const auto     since  = buffer->getSince(cursor, maxCount);
+                    nlohmann::json header = {
+                        {"next_cursor", since.nextCursor},
+                        {"first_sequence", since.lines.firstSequence},
+                        {"dropped", since.dropped},
+                        {"has_more", since.hasMore},
+                    };
+                    nlohmann::json content = nlohmann::json::array({{{"type", "text"}, {"text", header.dump()}}});
+                    for (const auto line : since.lines.lines) {
+                        content.push_back({{"type", "text"}, {"text", line}});
+                    }
+                    return nlohmann::json{
+                        {"content", std::move(content)},
+                        {"structuredContent", std::move(header)},
+                    };
+                }
+            );
+
+            // 日志检索工具：子串/正则匹配，支持级别、时间窗口过滤与上下文行，由增量三元组索引预筛候选行
+            mcp::tool searchLogTool = mcp_tool_definitions::buildSearchLogsTool();
+
+            server->register_tool(
+                searchLogTool,
+                [this](const nlohmann::json& params, const std::string& /* session_id */) -> nlohmann::json {
+                    const auto errorResult = [](const std::string& message) {
+                        return nlohmann::json{
+                            {"isError", true},
+                            {"content", nlohmann::json::array({{{"type", "text"}, {"text", message}}})}
+                        };
+                    };
+                    const std::string stream = params.value("stream", "all");
+                    const auto&       buffer = stream == "error" ? errBuffer : logBuffer;
+                    if (!buffer) {
+                        return errorResult("Log buffer not set");
+                    }
+
+                    LogSearchQuery query;
+                    query.pattern      = params.value("pattern", "");
+                    query.mode         = params.value("regex", false) ? LogSearchQuery::Mode::Regex
+                                                                      : LogSearchQuery::Mode::Substring;
+                    query.ignoreCase   = params.value("ignore_case", false);
+                    query.contextLines = std::min<size_t>(params.value("context", size_t{0}), 50);
+                    query.maxMatches   = params.value("max_results", size_t{50});
+                    const auto levelMask = _parseLevelMask(params.value("levels", std::string{}));
+                    if (!levelMask) {
+                        return errorResult(levelMask.error());
+                    }
+                    query.levelMask = *levelMask;
+                    if (params.contains("last_seconds") && params["last_seconds"].is_number()) {
+                        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch()
+                        );
+                        query.sinceMs = now.count()
+                                      - static_cast<std::int64_t>(params["last_seconds"].get<double>() * 1000.0);
+                    }
+
+                    const auto found = buffer->search(query);
+                    if (!found) {
+                        return errorResult(found.error());
+                    }
+
+                    nlohmann::json header = {
+                        {"matches", found->matchCount},
+                        {"scanned", found->scannedLines},
+                        {"truncated", found->truncated},
+                        {"indexed", found->indexed},
+                    };
+                    nlohmann::json content = nlohmann::json::array({{{"type", "text"}, {"text", header.dump()}}});
+                    for (const auto& line : found->lines) {
+                        content.push_back(
+                            {{"type", "text"},
+                             {"text", std::to_string(line.sequence) + (line.match ? ": " : "- ") + line.text}}
+                        );
+                    }
+                    return nlohmann::json{
+                        {"content", std::move(content)},
+                        {"structuredContent", std::move(header)},
+                    };
+                }
+            );
+            // 日志订阅工具：新日志按级别/模式过滤后，以 notifications/message 推送到会话的 SSE 流，免去客户端轮询
+            mcp::tool subscribeLogTool = mcp_tool_definitions::buildSubscribeLogsTool();
+
+            server->register_tool(
+                subscribeLogTool,
+                [this](const nlohmann::json& params, const std::string& session_id) -> nlohmann::json {
+                    const auto errorResult = [](const std::string& message) {
+                        return nlohmann::json{
+                            {"isError", true},
+                            {"content", nlohmann::json::array({{{"type", "text"}, {"text", message}}})}
+                        };
+                    };
+                    const std::string stream = params.value("stream", "all");
+                    const auto&       buffer = stream == "error" ? errBuffer : logBuffer;
+                    if (!buffer) {
+                        return errorResult("Log buffer not set");
+                    }
+                    if (!logStream) {
+                        return errorResult("Log streaming is not running");
+                    }
+
+                    LogSearchQuery query;
+                    query.pattern        = params.value("pattern", "");
+                    query.mode           = params.value("regex", false) ? LogSearchQuery::Mode::Regex
+                                                                        : LogSearchQuery::Mode::Substring;
+                    query.ignoreCase     = params.value("ignore_case", false);
+                    const auto levelMask = _parseLevelMask(params.value("levels", std::string{}));
+                    if (!levelMask) {
+                        return errorResult(levelMask.error());
+                    }
+                    query.levelMask = *levelMask;
+
+                    const auto subscription =
+                        logStream->subscribe(session_id, buffer, query, params.value("cursor", uint64_t{0}));
+                    if (!subscription) {
+                        return errorResult(subscription.error());
+                    }
+                    nlohmann::json result = {{"subscription_id", *subscription}};
+                    return nlohmann::json{
+                        {"content", nlohmann::json::array({{{"type", "text"}, {"text", result.dump()}}})},
+                        {"structuredContent", std::move(result)},
+                    };
+                }
+            );
+
+            mcp::tool unsubscribeLogTool = mcp_tool_definitions::buildUnsubscribeLogsTool();
+
+            server->register_tool(
+                unsubscribeLogTool,
+                [this](const nlohmann::json& params, const std::string& session_id) -> nlohmann::json {
+                    const std::string subscriptionId = params.value("subscription_id", "");
+                    if (!logStream || !logStream->unsubscribe(session_id, subscriptionId)) {
+                        return nlohmann::json{
+                            {"isError", true},
+                            {"content",
+                             nlohmann::json::array(
+                                 {{{"type", "text"}, {"text", "Unknown subscription: " + subscriptionId}}}
+                             )}
+                        };
+                    }
+                    return nlohmann::json{
+                        {"content", nlohmann::json::array({{{"type", "text"}, {"text", "Unsubscribed"}}})}
+                    };
+                }
+            );
+
+            // 异常聚合工具：按签名合并重复的 Python traceback，返回次数与首末出现时间
+            mcp::tool errorGroupsTool = mcp_tool_definitions::buildGetErrorGroupsTool();
+
+            server->register_tool(
+                errorGroupsTool,
+                [this](const nlohmann::json& params, const std::string& /* session_id */) -> nlohmann::json {
+                    if (!tracebacks) {
+                        return nlohmann::json{
+                            {"isError", true},
+                            {"content",
+                             nlohmann::json::array({{{"type", "text"}, {"text", "Traceback aggregator not set"}}})}
+                        };
+                    }
+                    const std::string order         = params.value("order", "recent");
+                    const size_t      maxCount      = params.value("max_count", 20);
+                    const bool        includeFrames = params.value("include_frames", true);
+
+                    const auto groups = tracebacks->groups(
+                        order == "count" ? TracebackAggregator::Order::MostFrequent
+                                         : TracebackAggregator::Order::MostRecent,
+                        maxCount
+                    );
+                    nlohmann::json groupArray = nlohmann::json::array();
+                    for (const auto& group : groups) {
+                        char signature[17];
+                        std::snprintf(
+                            signature,
+                            sizeof(signature),
+                            "%016llx",
+                            static_cast<unsigned long long>(group.signature)
+                        );
+                        nlohmann::json entry = {
+                            {"signature", signature},
+                            {"exception_type", group.latest.exceptionType},
+                            {"message", group.latest.message},
+                            {"normalized_message", group.normalizedMessage},
+                            {"count", group.count},
+                            {"first_seen_ms", group.firstSeenMs},
+                            {"last_seen_ms", group.lastSeenMs},
+                        };
+                        if (includeFrames) {
+                            nlohmann::json frames = nlohmann::json::array();
+                            for (const auto& frame : group.latest.frames) {
+                                frames.push_back({
+                                    {"file", frame.file},
+                                    {"line", frame.line},
+                                    {"function", frame.function},
+                                    {"source", frame.source},
+                                });
+                            }
+                            entry["frames"] = std::move(frames);
+                        }
+                        groupArray.push_back(std::move(entry));
+                    }
+                    nlohmann::json result = {
+                        {"total_errors", tracebacks->totalCount()},
+                        {"groups", std::move(groupArray)},
+                    };
+                    return nlohmann::json{
+                        {"content", nlohmann::json::array({{{"type", "text"}, {"text", result.dump(2)}}})},
+                        {"structuredContent", std::move(result)},
+                    };
                 }
             );
         }
@@ -639,9 +955,21 @@ namespace mcdk {
             srv_conf.port = config.serverPort;
             server        = std::make_shared<mcp::server>(srv_conf);
             server->set_server_info("Minecraft(BE) MCP Server(MCDK)", "0.1.0");
+            // 订阅的日志以 MCP logging 通知推送，需声明 logging 能力（tools 能力由注册工具时自动补上）
+            server->set_capabilities({{"logging", nlohmann::json::object()}});
+            server->register_method(
+                "logging/setLevel",
+                [](const nlohmann::json&, const std::string&) { return nlohmann::json::object(); }
+            );
+            logStream = std::make_unique<LogStreamHub>(
+                [this](const std::string& sessionId, const std::vector<LogStreamBatch>& batches) {
+                    return _publishLogBatches(sessionId, batches);
+                }
+            );
             // 注册API
             initTools();
             server->start(false); // 非阻塞启动
+            logStream->start();
         }
 
         // 停止MCP服务器
@@ -649,6 +977,8 @@ namespace mcdk {
             if (!config.enabled || server.get() == nullptr) {
                 return;
             }
+            // 先停推送线程，它会使用 server
+            logStream.reset();
             server->stop();
             server.reset();
         }
@@ -688,6 +1018,10 @@ namespace mcdk {
 
     void MCPServer::setErrBuffer(std::shared_ptr<LogBuffer> buffer) { mImpl->setErrBuffer(std::move(buffer)); }
 
+    void MCPServer::setTracebackAggregator(std::shared_ptr<TracebackAggregator> aggregator) {
+        mImpl->setTracebackAggregator(std::move(aggregator));
+    }
+
     void MCPServer::setCodeExecuteHandler(CodeExecuteHandler handler) {
         mImpl->setCodeExecuteHandler(std::move(handler));
     }
@@ -36,6 +36,77 @@ Parameters:
 - order: "asc" for oldest to newest, "desc" for newest to oldest
 )";
 
+        constexpr auto GetLogsSinceName        = "get_logs_since";
+        constexpr auto GetLogsSinceDescription = R"(Returns only the game log entries written after a cursor, for cheap polling.
+
+Every log line has a monotonically increasing sequence number. Pass the returned next_cursor back as cursor on the next
+call to receive just the new lines; no window is downloaded twice.
+
+Parameters:
+- cursor: Sequence number of the last line already received (default 0 = start from the oldest line of the session)
+- max_count: Maximum number of lines to return, 1 to 1000 (default 200); has_more is true when more lines are waiting
+- stream: "all" for all logs, "error" for stderr error logs only (default "all")
+
+The first content item is a JSON header {"next_cursor", "first_sequence", "dropped", "has_more"}. Lines that no longer
+fit in memory are read back from the session's on-disk log spool (both streams); dropped counts lines after the cursor
+that are not available anywhere any more, e.g. because the spool is size-capped and rotated them out.)";
+
+        constexpr auto SearchLogsName        = "search_logs";
+        constexpr auto SearchLogsDescription = R"(Searches the retained game log lines by substring or regex.
+
+Parameters:
+- pattern: Text to search for (substring by default)
+- regex: Treat pattern as an ECMAScript regular expression (default false)
+- ignore_case: ASCII case-insensitive matching (default false)
+- levels: Comma-separated levels to keep, e.g. "error,warn" (error, warn, info, debug; default all)
+- last_seconds: Only search lines written in the last N seconds
+- context: Number of lines to include before and after every match (default 0)
+- max_results: Maximum number of matching lines, newest matches win (default 50)
+- stream: "all" for all logs, "error" for stderr error logs only (default "all")
+
+The first content item is a JSON header {"matches", "scanned", "truncated", "indexed"}. Every following item is one
+line formatted as "<sequence><marker> <text>", where marker is ':' for a match and '-' for a context line; the sequence
+numbers are the same cursors used by get_logs_since.)";
+
+        constexpr auto SubscribeLogsDescription = R"(Pushes new game log lines to this MCP session as they are written, instead of polling.
+
+Matching lines are delivered as MCP logging notifications (method "notifications/message", logger "mcdk.logs") on the
+session's server-sent event stream (HTTP GET on the MCP endpoint; mcdk_stdio_bridge opens it automatically). Every
+notification's data is {"batches": [{"subscription_id", "lines": [{"sequence", "level", "text"}], "skipped",
+"cursor"}]}; a session receives at most one notification per 200 ms.
+
+Parameters:
+- pattern: Only deliver lines containing this text (default: every line)
+- regex: Treat pattern as an ECMAScript regular expression (default false)
+- ignore_case: ASCII case-insensitive matching (default false)
+- levels: Comma-separated levels to keep, e.g. "error,warn" (error, warn, info, debug; default all)
+- cursor: Resume after this sequence number, e.g. a get_logs_since next_cursor (default: only lines written from now on)
+- stream: "all" for all logs, "error" for stderr error logs only (default "all")
+
+Backpressure: at most 200 lines per subscription are delivered per notification. A subscription that falls more than
+2000 lines behind skips ahead to the newest lines and reports the gap in skipped; fetch it with get_logs_since if
+needed. A session whose event stream stops draining loses its subscriptions. Returns {"subscription_id"}.)";
+
+        constexpr auto UnsubscribeLogsName        = "unsubscribe_logs";
+        constexpr auto UnsubscribeLogsDescription = R"(Stops a log subscription created by subscribe_logs.
+
+Parameters:
+- subscription_id: The id returned by subscribe_logs)";
+
+        constexpr auto GetErrorGroupsName        = "get_error_groups";
+        constexpr auto GetErrorGroupsDescription = R"(Returns Python tracebacks from stderr grouped by exception signature.
+
+Repeated failures (the same exception type, call stack and message shape) collapse into one group with a count and the
+first/last time they were seen, so an error thrown every tick does not hide the others. The signature ignores line
+numbers and masks numbers and quoted values in the message.
+
+Parameters:
+- order: "recent" for most recently seen first, "count" for most frequent first (default "recent")
+- max_count: Maximum number of groups to return (default 20)
+- include_frames: Include the call stack of the latest occurrence (default true)
+
+Timestamps are milliseconds since the Unix epoch.)";
+
         constexpr auto ExecuteCodeName        = "execute_code";
         constexpr auto ExecuteCodeDescription = R"(Executes provided code in the game environment.
 Parameters:
@@ -105,6 +176,62 @@ Parameters:
             .build();
     }
 
+    mcp::tool buildGetLogsSinceTool() {
+        return mcp::tool_builder(GetLogsSinceName)
+            .with_description(GetLogsSinceDescription)
+            .with_number_param("cursor", "Sequence number of the last line already received", false)
+            .with_number_param("max_count", "Maximum number of log entries to return (1-1000, default 200)", false)
+            .with_string_param("stream", "Log stream (all or error)", false)
+            .with_read_only_hint(true)
+            .build();
+    }
+
+    mcp::tool buildSearchLogsTool() {
+        return mcp::tool_builder(SearchLogsName)
+            .with_description(SearchLogsDescription)
+            .with_string_param("pattern", "Text or regular expression to search for", true)
+            .with_boolean_param("regex", "Treat pattern as a regular expression", false)
+            .with_boolean_param("ignore_case", "Case-insensitive matching", false)
+            .with_string_param("levels", "Comma-separated log levels to keep (error, warn, info, debug)", false)
+            .with_number_param("last_seconds", "Only search lines written in the last N seconds", false)
+            .with_number_param("context", "Lines of context around each match", false)
+            .with_number_param("max_results", "Maximum number of matching lines to return", false)
+            .with_string_param("stream", "Log stream (all or error)", false)
+            .with_read_only_hint(true)
+            .build();
+    }
+
+    mcp::tool buildSubscribeLogsTool() {
+        return mcp::tool_builder(SubscribeLogsName)
+            .with_description(SubscribeLogsDescription)
+            .with_string_param("pattern", "Text or regular expression a line must match", false)
+            .with_boolean_param("regex", "Treat pattern as a regular expression", false)
+            .with_boolean_param("ignore_case", "Case-insensitive matching", false)
+            .with_string_param("levels", "Comma-separated log levels to keep (error, warn, info, debug)", false)
+            .with_number_param("cursor", "Sequence number to resume after", false)
+            .with_string_param("stream", "Log stream (all or error)", false)
+            .with_read_only_hint(true)
+            .build();
+    }
+
+    mcp::tool buildUnsubscribeLogsTool() {
+        return mcp::tool_builder(UnsubscribeLogsName)
+            .with_description(UnsubscribeLogsDescription)
+            .with_string_param("subscription_id", "Subscription id returned by subscribe_logs", true)
+            .with_read_only_hint(true)
+            .build();
+    }
+
+    mcp::tool buildGetErrorGroupsTool() {
+        return mcp::tool_builder(GetErrorGroupsName)
+            .with_description(GetErrorGroupsDescription)
+            .with_string_param("order", "Group order (recent or count)", false)
+            .with_number_param("max_count", "Maximum number of groups to return", false)
+            .with_boolean_param("include_frames", "Include the call stack of the latest occurrence", false)
+            .with_read_only_hint(true)
+            .build();
+    }
+
     mcp::tool buildExecuteCodeTool() {
         return mcp::tool_builder(ExecuteCodeName)
             .with_description(ExecuteCodeDescription)
@@ -155,6 +282,11 @@ Parameters:
             buildGetLatestLogsTool(),
             buildGetLogRangeTool(),
             buildGetLatestErrorLogsTool(),
+            buildGetLogsSinceTool(),
+            buildSearchLogsTool(),
+            buildSubscribeLogsTool(),
+            buildUnsubscribeLogsTool(),
+            buildGetErrorGroupsTool(),
             buildExecuteCodeTool(),
             buildJsonUiDebuggerTool(),
             buildReloadGameTool(),
@@ -0,0 +1,230 @@
+#include <output_capture.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace mcdk {
+
+    namespace {
+        constexpr std::string_view PythonMarker = "[Python] ";
+    }
+
+    LineSplitter::LineSplitter(OutputCaptureOptions options) : mOptions(options) {}
+
+    void LineSplitter::append(std::string_view data, const CaptureLineHandler& onLine) {
+        while (!data.empty()) {
+            const auto* newline = static_cast<const char*>(std::memchr(data.data(), '\n', data.size()));
+            if (newline == nullptr) {
+                mPending.append(data);
+                if (mPending.size() >= mOptions.maxLineBytes) {
+                    emit(mPending, onLine);
+                    mPending.clear();
+                }
+                return;
+            }
+            const auto length = static_cast<std::size_t>(newline - data.data());
+            if (mPending.empty()) {
+                emit(data.substr(0, length), onLine);
+            } else {
+                // Only a line that straddles two reads is copied, and into a buffer that keeps its capacity.
+                mPending.append(data.substr(0, length));
+                emit(mPending, onLine);
+                mPending.clear();
+            }
+            data.remove_prefix(length + 1);
+        }
+    }
+
+    void LineSplitter::finish(const CaptureLineHandler& onLine) {
+        if (!mPending.empty()) {
+            emit(mPending, onLine);
+            mPending.clear();
+        }
+    }
+
+    void LineSplitter::emit(std::string_view line, const CaptureLineHandler& onLine) const {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (mOptions.filterPython && line.find(PythonMarker) == std::string_view::npos) {
+            return;
+        }
+        onLine(line);
+    }
+
+    OutputCapture::OutputCapture(OutputCaptureOptions options)
+    : mOptions(options),
+      mStdout{.pipe = {}, .onLine = {}, .splitter = LineSplitter(options)},
+      mStderr{.pipe = {}, .onLine = {}, .splitter = LineSplitter(options)} {}
+
+    OutputCaptureStats OutputCapture::stats() const {
+        return {
+            .bytes = mBytes.load(std::memory_order_relaxed),
+            .lines = mLines.load(std::memory_order_relaxed),
+            .reads = mReads.load(std::memory_order_relaxed),
+        };
+    }
+
+    void OutputCapture::countRead(std::size_t bytes) {
+        mBytes.fetch_add(bytes, std::memory_order_relaxed);
+        mReads.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void OutputCapture::start(
+        CaptureHandle      stdoutPipe,
+        CaptureHandle      stderrPipe,
+        CaptureLineHandler onStdout,
+        CaptureLineHandler onStderr
+    ) {
+        const auto counted = [this](CaptureLineHandler handler) {
+            return [this, handler = std::move(handler)](std::string_view line) {
+                mLines.fetch_add(1, std::memory_order_relaxed);
+                handler(line);
+            };
+        };
+        mStdout.pipe   = stdoutPipe;
+        mStdout.onLine = counted(std::move(onStdout));
+        mStderr.pipe   = stderrPipe;
+        mStderr.onLine = counted(std::move(onStderr));
+
+#ifdef _WIN32
+        mStdoutThread = std::thread([this] { readStream(mStdout); });
+        mStderrThread = std::thread([this] { readStream(mStderr); });
+#else
+        if (::pipe(mCancelPipe) != 0) {
+            mCancelPipe[0] = mCancelPipe[1] = -1;
+        }
+        mThread = std::thread([this] { pollStreams(); });
+#endif
+    }
+
+#ifdef _WIN32
+
+    void OutputCapture::readStream(Stream& stream) {
+        const auto readSize = static_cast<DWORD>(mOptions.readSize);
+        const auto buffer   = std::make_unique<char[]>(readSize);
+        while (true) {
+            DWORD bytesRead = 0;
+            // ERROR_BROKEN_PIPE, a cancelled read and a zero-byte read all mean the writer is done.
+            if (!ReadFile(stream.pipe, buffer.get(), readSize, &bytesRead, nullptr) || bytesRead == 0) {
+                break;
+            }
+            countRead(bytesRead);
+            stream.splitter.append({buffer.get(), bytesRead}, stream.onLine);
+        }
+        stream.splitter.finish(stream.onLine);
+    }
+
+    void OutputCapture::join() {
+        if (mStdoutThread.joinable()) mStdoutThread.join();
+        if (mStderrThread.joinable()) mStderrThread.join();
+    }
+
+    void OutputCapture::cancel() noexcept {
+        for (auto* thread : {&mStdoutThread, &mStderrThread}) {
+            if (thread->joinable()) {
+                CancelSynchronousIo(thread->native_handle());
+            }
+        }
+    }
+
+    OutputCapture::~OutputCapture() {
+        cancel();
+        for (auto* thread : {&mStdoutThread, &mStderrThread}) {
+            if (!thread->joinable()) continue;
+            try {
+                thread->join();
+            } catch (...) {
+                // A destructor must not terminate while unwinding; detaching is the last-resort valid thread state.
+                thread->detach();
+            }
+        }
+    }
+
+#else
+
+    void OutputCapture::pollStreams() {
+        const auto buffer = std::make_unique<char[]>(mOptions.readSize);
+        Stream*    streams[2] = {&mStdout, &mStderr};
+        pollfd     fds[3]     = {
+            {.fd = mStdout.pipe, .events = POLLIN, .revents = 0},
+            {.fd = mStderr.pipe, .events = POLLIN, .revents = 0},
+            {.fd = mCancelPipe[0], .events = POLLIN, .revents = 0},
+        };
+
+        int open = 2;
+        while (open > 0) {
+            if (::poll(fds, 3, -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (fds[2].revents != 0) {
+                break;
+            }
+            for (int index = 0; index < 2; ++index) {
+                if (fds[index].fd < 0 || fds[index].revents == 0) {
+                    continue;
+                }
+                // POLLHUP may arrive together with the last data, so read until read() itself reports end of file.
+                const auto bytesRead = ::read(fds[index].fd, buffer.get(), mOptions.readSize);
+                if (bytesRead > 0) {
+                    countRead(static_cast<std::size_t>(bytesRead));
+                    streams[index]->splitter.append(
+                        {buffer.get(), static_cast<std::size_t>(bytesRead)},
+                        streams[index]->onLine
+                    );
+                    continue;
+                }
+                if (bytesRead < 0 && (errno == EINTR || errno == EAGAIN)) {
+                    continue;
+                }
+                fds[index].fd = -1; // poll() skips negative descriptors.
+                --open;
+            }
+        }
+        for (auto* stream : streams) {
+            stream->splitter.finish(stream->onLine);
+        }
+    }
+
+    void OutputCapture::join() {
+        if (mThread.joinable()) mThread.join();
+        for (auto& fd : mCancelPipe) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    void OutputCapture::cancel() noexcept {
+        if (mThread.joinable() && mCancelPipe[1] >= 0) {
+            const char wake = 0;
+            [[maybe_unused]] const auto written = ::write(mCancelPipe[1], &wake, 1);
+        }
+    }
+
+    OutputCapture::~OutputCapture() {
+        cancel();
+        try {
+            join();
+        } catch (...) {
+            // A destructor must not terminate while unwinding; detaching is the last-resort valid thread state.
+            mThread.detach();
+        }
+    }
+
+#endif
+
+} // namespace mcdk
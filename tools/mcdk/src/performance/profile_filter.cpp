@@ -0,0 +1,497 @@
+#include <performance/profile_filter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <memory>
+#include <regex>
+#include <unordered_map>
+
+namespace mcdk::performance {
+namespace {
+
+    using Operator = FilterExpression::Operator;
+    using Node     = FilterExpression::Node;
+
+    constexpr std::size_t MaximumDepth = 32;
+
+    ProfilerError filterError(std::string code, std::string message) {
+        return {.code = std::move(code), .message = std::move(message), .retryable = false};
+    }
+
+    std::string lowered(std::string_view value) {
+        std::string result(value);
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char character) {
+            return static_cast<char>(std::tolower(character));
+        });
+        return result;
+    }
+
+    bool operatorCharacter(char character) {
+        return character == '=' || character == '!' || character == '<' || character == '>' || character == '~';
+    }
+
+    struct Token {
+        enum class Kind : std::uint8_t { Word, String, Operator, Open, Close, End };
+        Kind        kind = Kind::End;
+        std::string text;
+        std::size_t position = 0;
+    };
+
+    struct Tokens {
+        std::vector<Token>           tokens; // Up to the first malformed token when error is set.
+        std::optional<ProfilerError> error;
+    };
+
+    // Words run until whitespace, a parenthesis, a quote or an operator character, so `self_time>2ms` splits as
+    // expected and unquoted paths such as combat/ stay one word.
+    Tokens tokenize(std::string_view text) {
+        std::vector<Token> tokens;
+        std::size_t        index = 0;
+        const auto         malformed = [&](std::string message, std::size_t position) {
+            return Tokens{
+                .tokens = std::move(tokens),
+                .error  = filterError("FILTER_INVALID", message + " at filter position " + std::to_string(position) + "."),
+            };
+        };
+        while (index < text.size()) {
+            const char character = text[index];
+            if (std::isspace(static_cast<unsigned char>(character))) {
+                ++index;
+                continue;
+            }
+            Token token{.position = index};
+            if (character == '(' || character == ')') {
+                token.kind = character == '(' ? Token::Kind::Open : Token::Kind::Close;
+                token.text = std::string(1, character);
+                ++index;
+            } else if (character == '"' || character == '\'') {
+                token.kind = Token::Kind::String;
+                ++index;
+                bool closed = false;
+                while (index < text.size()) {
+                    const char next = text[index++];
+                    if (next == character) {
+                        closed = true;
+                        break;
+                    }
+                    if (next == '\\' && index < text.size()) token.text.push_back(text[index++]);
+                    else token.text.push_back(next);
+                }
+                if (!closed) return malformed("Unterminated quoted string", token.position);
+            } else if (operatorCharacter(character)) {
+                token.kind = Token::Kind::Operator;
+                token.text.push_back(character);
+                ++index;
+                if (index < text.size() && text[index] == '=' && character != '~') token.text.push_back(text[index++]);
+                if (token.text == "!") return malformed("Expected !=", token.position);
+            } else {
+                token.kind = Token::Kind::Word;
+                while (index < text.size()) {
+                    const char next = text[index];
+                    if (std::isspace(static_cast<unsigned char>(next)) || next == '(' || next == ')' || next == '"'
+                        || next == '\'' || operatorCharacter(next)) {
+                        break;
+                    }
+                    token.text.push_back(next);
+                    ++index;
+                }
+            }
+            tokens.push_back(std::move(token));
+        }
+        tokens.push_back({.kind = Token::Kind::End, .position = text.size()});
+        return {.tokens = std::move(tokens)};
+    }
+
+    bool keyword(const Token& token, std::string_view word) {
+        return token.kind == Token::Kind::Word && lowered(token.text) == word;
+    }
+
+    std::optional<Operator> operatorOf(const Token& token) {
+        if (token.kind == Token::Kind::Operator) {
+            if (token.text == "==" || token.text == "=") return Operator::Equal;
+            if (token.text == "!=") return Operator::NotEqual;
+            if (token.text == "<") return Operator::Less;
+            if (token.text == "<=") return Operator::LessEqual;
+            if (token.text == ">") return Operator::Greater;
+            if (token.text == ">=") return Operator::GreaterEqual;
+            if (token.text == "~") return Operator::Matches;
+            return std::nullopt;
+        }
+        if (keyword(token, "contains")) return Operator::Contains;
+        if (keyword(token, "glob")) return Operator::Glob;
+        if (keyword(token, "matches")) return Operator::Matches;
+        return std::nullopt;
+    }
+
+    bool fieldName(const Token& token) {
+        if (token.kind != Token::Kind::Word || token.text.empty()) return false;
+        if (!std::isalpha(static_cast<unsigned char>(token.text.front())) && token.text.front() != '_') return false;
+        return std::all_of(token.text.begin(), token.text.end(), [](unsigned char character) {
+            return std::isalnum(character) || character == '_';
+        });
+    }
+
+    // A comparison starts a clause: the whole filter, or after "(", "and", "or" or "not".
+    bool startsComparison(const std::vector<Token>& tokens) {
+        for (std::size_t index = 0; index + 1 < tokens.size(); ++index) {
+            const bool clauseStart = index == 0 || tokens[index - 1].kind == Token::Kind::Open
+                                  || keyword(tokens[index - 1], "and") || keyword(tokens[index - 1], "or")
+                                  || keyword(tokens[index - 1], "not");
+            if (clauseStart && fieldName(tokens[index]) && operatorOf(tokens[index + 1])) return true;
+        }
+        return false;
+    }
+
+    class Parser {
+    public:
+        Parser(const std::vector<Token>& tokens, std::vector<Node>& nodes) : tokens_(tokens), nodes_(nodes) {}
+
+        std::expected<std::uint32_t, ProfilerError> parse() {
+            auto root = disjunction(0);
+            if (root && peek().kind != Token::Kind::End) return unexpected("Unexpected '" + peek().text + "'");
+            return root;
+        }
+
+    private:
+        std::expected<std::uint32_t, ProfilerError> disjunction(std::size_t depth) {
+            return binary(depth, "or", Node::Kind::Or, &Parser::conjunction);
+        }
+
+        std::expected<std::uint32_t, ProfilerError> conjunction(std::size_t depth) {
+            return binary(depth, "and", Node::Kind::And, &Parser::unary);
+        }
+
+        std::expected<std::uint32_t, ProfilerError> binary(
+            std::size_t depth,
+            std::string_view word,
+            Node::Kind kind,
+            std::expected<std::uint32_t, ProfilerError> (Parser::*operand)(std::size_t)
+        ) {
+            auto left = (this->*operand)(depth);
+            while (left && keyword(peek(), word)) {
+                ++next_;
+                auto right = (this->*operand)(depth);
+                if (!right) return right;
+                left = add({.kind = kind, .left = *left, .right = *right});
+            }
+            return left;
+        }
+
+        std::expected<std::uint32_t, ProfilerError> unary(std::size_t depth) {
+            if (depth > MaximumDepth) return unexpected("The filter is nested too deeply");
+            const auto& token = peek();
+            if (keyword(token, "not")) {
+                ++next_;
+                auto operand = unary(depth + 1);
+                if (!operand) return operand;
+                return add({.kind = Node::Kind::Not, .left = *operand});
+            }
+            if (token.kind == Token::Kind::Open) {
+                ++next_;
+                auto inner = disjunction(depth + 1);
+                if (!inner) return inner;
+                if (peek().kind != Token::Kind::Close) return unexpected("Expected ')'");
+                ++next_;
+                return inner;
+            }
+            if (fieldName(token) && next_ + 1 < tokens_.size() && operatorOf(tokens_[next_ + 1])) {
+                const auto op = *operatorOf(tokens_[next_ + 1]);
+                next_ += 2;
+                const auto& value = peek();
+                if (value.kind != Token::Kind::Word && value.kind != Token::Kind::String) {
+                    return unexpected("Expected a value after '" + tokens_[next_ - 1].text + "'");
+                }
+                ++next_;
+                return add({
+                    .kind = Node::Kind::Compare,
+                    .op = op,
+                    .field = token.text,
+                    .value = value.text,
+                    .quoted = value.kind == Token::Kind::String,
+                });
+            }
+            if (token.kind == Token::Kind::Word || token.kind == Token::Kind::String) {
+                ++next_;
+                return add({.kind = Node::Kind::Text, .value = token.text, .quoted = token.kind == Token::Kind::String});
+            }
+            return unexpected(token.kind == Token::Kind::End ? "The filter ends early" : "Unexpected '" + token.text + "'");
+        }
+
+        const Token& peek() const { return tokens_[next_]; }
+
+        std::uint32_t add(Node node) {
+            nodes_.push_back(std::move(node));
+            return static_cast<std::uint32_t>(nodes_.size() - 1);
+        }
+
+        std::unexpected<ProfilerError> unexpected(std::string message) const {
+            return std::unexpected(filterError(
+                "FILTER_INVALID", message + " at filter position " + std::to_string(peek().position) + "."
+            ));
+        }
+
+        const std::vector<Token>& tokens_;
+        std::vector<Node>&        nodes_;
+        std::size_t               next_ = 0;
+    };
+
+    enum class UnitFamily : std::uint8_t { None, Time, Size };
+
+    struct Unit {
+        std::string_view name;
+        UnitFamily       family;
+        long double      scale; // Nanoseconds or bytes.
+    };
+
+    constexpr std::array Units = {
+        Unit{"ns", UnitFamily::Time, 1.0L},
+        Unit{"us", UnitFamily::Time, 1e3L},
+        Unit{"ms", UnitFamily::Time, 1e6L},
+        Unit{"s", UnitFamily::Time, 1e9L},
+        Unit{"min", UnitFamily::Time, 6e10L},
+        Unit{"b", UnitFamily::Size, 1.0L},
+        Unit{"kb", UnitFamily::Size, 1e3L},
+        Unit{"kib", UnitFamily::Size, 1024.0L},
+        Unit{"mb", UnitFamily::Size, 1e6L},
+        Unit{"mib", UnitFamily::Size, 1048576.0L},
+        Unit{"gb", UnitFamily::Size, 1e9L},
+        Unit{"gib", UnitFamily::Size, 1073741824.0L},
+    };
+
+    Unit columnUnit(std::string_view unit) {
+        if (unit == "nanoseconds") return {unit, UnitFamily::Time, 1.0L};
+        if (unit == "milliseconds") return {unit, UnitFamily::Time, 1e6L};
+        if (unit == "seconds") return {unit, UnitFamily::Time, 1e9L};
+        if (unit == "bytes") return {unit, UnitFamily::Size, 1.0L};
+        return {unit, UnitFamily::None, 1.0L};
+    }
+
+    // The literal converted to the column's unit; a bare number is already in it.
+    std::expected<long double, ProfilerError> numberIn(const ProfileColumn& column, std::string_view literal) {
+        const auto* begin = literal.data();
+        const auto* end   = literal.data() + literal.size();
+        if (begin != end && *begin == '+') ++begin;
+        double value = 0;
+        const auto [pointer, error] = std::from_chars(begin, end, value);
+        if (error != std::errc{} || begin == end) {
+            return std::unexpected(filterError(
+                "FILTER_INVALID", "'" + std::string(literal) + "' is not a number for field " + column.name + "."
+            ));
+        }
+        const auto suffix = lowered(std::string_view(pointer, static_cast<std::size_t>(end - pointer)));
+        if (suffix.empty()) return static_cast<long double>(value);
+        const auto target = columnUnit(column.unit);
+        const auto unit   = std::find_if(Units.begin(), Units.end(), [&](const Unit& item) { return item.name == suffix; });
+        if (unit == Units.end() || unit->family != target.family) {
+            return std::unexpected(filterError(
+                "FILTER_UNIT_INVALID",
+                "Unit '" + suffix + "' does not apply to field " + column.name
+                    + (column.unit.empty() ? ", which has no unit." : ", which is measured in " + column.unit + ".")
+            ));
+        }
+        return static_cast<long double>(value) * unit->scale / target.scale;
+    }
+
+    // Case-insensitive match of the whole value against * and ? wildcards.
+    bool globMatches(std::string_view value, std::string_view lowerPattern) {
+        std::size_t text = 0;
+        std::size_t pattern = 0;
+        std::size_t star = std::string_view::npos;
+        std::size_t resume = 0;
+        const auto fold = [](char character) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+        };
+        while (text < value.size()) {
+            if (pattern < lowerPattern.size()
+                && (lowerPattern[pattern] == '?' || lowerPattern[pattern] == fold(value[text]))) {
+                ++text;
+                ++pattern;
+            } else if (pattern < lowerPattern.size() && lowerPattern[pattern] == '*') {
+                star = pattern++;
+                resume = text;
+            } else if (star != std::string_view::npos) {
+                pattern = star + 1;
+                text = ++resume;
+            } else {
+                return false;
+            }
+        }
+        while (pattern < lowerPattern.size() && lowerPattern[pattern] == '*') ++pattern;
+        return pattern == lowerPattern.size();
+    }
+
+    // One node bound to a view. Text results are memoized per distinct string, so a regex runs once per value rather
+    // than once per row.
+    struct Bound {
+        Node::Kind                       kind = Node::Kind::Text;
+        std::uint32_t                    left = 0;
+        std::uint32_t                    right = 0;
+        Operator                         op = Operator::Equal;
+        const ProfileColumn*             column = nullptr; // Null for the record id.
+        long double                      number = 0;
+        bool                             numeric = false;
+        std::optional<StringId>          exact;            // The compared string, when the image holds it.
+        std::string                      pattern;          // Lower-cased for contains and glob.
+        std::optional<std::regex>        regex;
+        std::unique_ptr<RowTextMatcher>  term;
+        std::vector<std::int8_t>         stringMatches;    // -1 unknown, 0 or 1.
+        std::unordered_map<std::int64_t, bool> stackMatches;
+    };
+
+    class Evaluator {
+    public:
+        Evaluator(const ProfileStore& store, const ProfileView& view) : store_(store), view_(view) {}
+
+        std::expected<void, ProfilerError> bind(const std::vector<Node>& nodes) {
+            bound_.resize(nodes.size());
+            for (std::size_t index = 0; index < nodes.size(); ++index) {
+                const auto& node  = nodes[index];
+                auto&       bound = bound_[index];
+                bound.kind  = node.kind;
+                bound.left  = node.left;
+                bound.right = node.right;
+                bound.op    = node.op;
+                if (node.kind == Node::Kind::Text) {
+                    bound.term = std::make_unique<RowTextMatcher>(store_, view_, lowered(node.value));
+                } else if (node.kind == Node::Kind::Compare) {
+                    if (auto result = bindComparison(node, bound); !result) return result;
+                }
+            }
+            return {};
+        }
+
+        bool matches(std::uint32_t index, std::uint32_t row) {
+            auto& node = bound_[index];
+            switch (node.kind) {
+            case Node::Kind::And: return matches(node.left, row) && matches(node.right, row);
+            case Node::Kind::Or: return matches(node.left, row) || matches(node.right, row);
+            case Node::Kind::Not: return !matches(node.left, row);
+            case Node::Kind::Text: return (*node.term)(row);
+            case Node::Kind::Compare: return compare(node, row);
+            }
+            return false;
+        }
+
+    private:
+        std::expected<void, ProfilerError> bindComparison(const Node& node, Bound& bound) {
+            bound.column = store_.column(view_, node.field);
+            if (!bound.column && node.field != "id") {
+                std::string fields = "id";
+                for (const auto column : view_.columns) fields += ", " + store_.tableOf(view_).columns[column].name;
+                return std::unexpected(filterError(
+                    "FILTER_FIELD_UNKNOWN",
+                    "Field " + node.field + " is not part of view " + view_.name + ". Fields: " + fields + "."
+                ));
+            }
+            const bool textual = !bound.column || bound.column->type == ColumnType::Text
+                              || bound.column->type == ColumnType::Stack;
+            const bool ordering = node.op == Operator::Less || node.op == Operator::LessEqual
+                               || node.op == Operator::Greater || node.op == Operator::GreaterEqual;
+            const bool matching = node.op == Operator::Contains || node.op == Operator::Glob || node.op == Operator::Matches;
+            if ((textual && ordering) || (!textual && matching)) {
+                return std::unexpected(filterError(
+                    "FILTER_OPERATOR_INVALID",
+                    textual ? "Field " + node.field + " is text; use ==, !=, contains, glob or matches."
+                            : "Field " + node.field + " is numeric; use ==, !=, <, <=, > or >=."
+                ));
+            }
+            if (!textual) {
+                auto number = numberIn(*bound.column, node.value);
+                if (!number) return std::unexpected(number.error());
+                bound.number  = *number;
+                bound.numeric = true;
+                return {};
+            }
+            if (node.op == Operator::Matches) {
+                try {
+                    bound.regex.emplace(node.value, std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+                } catch (const std::regex_error&) {
+                    return std::unexpected(filterError(
+                        "FILTER_INVALID", "'" + node.value + "' is not a valid regular expression."
+                    ));
+                }
+            } else if (node.op == Operator::Equal || node.op == Operator::NotEqual) {
+                bound.exact   = store_.strings.find(node.value);
+                bound.pattern = node.value;
+            } else {
+                bound.pattern = lowered(node.value);
+            }
+            return {};
+        }
+
+        bool compare(Bound& node, std::uint32_t row) {
+            if (node.numeric) {
+                if (!node.column->has(row)) return false;
+                const auto value = cellNumber(*node.column, row);
+                if (!value) return false;
+                switch (node.op) {
+                case Operator::Equal: return *value == node.number;
+                case Operator::NotEqual: return *value != node.number;
+                case Operator::Less: return *value < node.number;
+                case Operator::LessEqual: return *value <= node.number;
+                case Operator::Greater: return *value > node.number;
+                case Operator::GreaterEqual: return *value >= node.number;
+                default: return false;
+                }
+            }
+            const auto& ids = store_.tableOf(view_).ids;
+            if (node.column && !node.column->has(row)) return false;
+            if (!node.column || node.column->type == ColumnType::Text) {
+                const auto id = node.column ? node.column->text(row) : ids[row];
+                if (node.op == Operator::Equal) return node.exact && id == *node.exact;
+                if (node.op == Operator::NotEqual) return !node.exact || id != *node.exact;
+                if (id >= store_.strings.size()) return textMatches(node, {});
+                if (node.stringMatches.empty()) node.stringMatches.assign(store_.strings.size(), -1);
+                auto& memo = node.stringMatches[id];
+                if (memo < 0) memo = textMatches(node, store_.strings.view(id)) ? 1 : 0;
+                return memo != 0;
+            }
+            const auto stack = node.column->integer(row);
+            if (const auto found = node.stackMatches.find(stack); found != node.stackMatches.end()) return found->second;
+            const auto text    = cellText(store_, *node.column, row);
+            const bool matched = node.op == Operator::Equal      ? text == node.pattern
+                               : node.op == Operator::NotEqual ? text != node.pattern
+                                                                : textMatches(node, text);
+            node.stackMatches.emplace(stack, matched);
+            return matched;
+        }
+
+        static bool textMatches(const Bound& node, std::string_view text) {
+            if (node.op == Operator::Contains) return containsFolded(text, node.pattern);
+            if (node.op == Operator::Glob) return globMatches(text, node.pattern);
+            return std::regex_search(text.begin(), text.end(), *node.regex);
+        }
+
+        const ProfileStore& store_;
+        const ProfileView&  view_;
+        std::vector<Bound>  bound_;
+    };
+
+} // namespace
+
+    std::expected<std::optional<FilterExpression>, ProfilerError> FilterExpression::parse(std::string_view text) {
+        auto [tokens, error] = tokenize(text);
+        // A stray quote or "!" is ordinary text unless the filter already started a comparison before it.
+        if (!startsComparison(tokens)) return std::optional<FilterExpression>{};
+        if (error) return std::unexpected(std::move(*error));
+        FilterExpression expression;
+        auto root = Parser(tokens, expression.nodes_).parse();
+        if (!root) return std::unexpected(root.error());
+        expression.root_ = *root;
+        return std::optional<FilterExpression>{std::move(expression)};
+    }
+
+    std::expected<std::vector<std::uint32_t>, ProfilerError>
+    FilterExpression::select(const ProfileStore& store, const ProfileView& view) const {
+        Evaluator evaluator(store, view);
+        if (auto bound = evaluator.bind(nodes_); !bound) return std::unexpected(bound.error());
+        std::vector<std::uint32_t> result;
+        for (const auto row : view.rows) {
+            if (evaluator.matches(root_, row)) result.push_back(row);
+        }
+        return result;
+    }
+
+} // namespace mcdk::performance
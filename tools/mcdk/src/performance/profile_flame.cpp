@@ -0,0 +1,526 @@
+#include <performance/profile_flame.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mcdk::performance {
+
+    namespace {
+
+        // Stacks deeper than this fold the rest of their weight into the deepest frame kept.
+        constexpr std::size_t MaximumDepth = 256;
+        // A Python call graph is a graph, not a tree: every path through it becomes a stack. Paths are no longer
+        // expanded once this many frames were emitted or their share of the capture drops below MinimumShare.
+        constexpr std::size_t MaximumFrames = 1'000'000;
+        constexpr long double MinimumShare  = 1e-6L;
+        constexpr long double Nanoseconds   = 1e9L;
+        constexpr StringId    UnknownSite   = std::numeric_limits<StringId>::max();
+
+        void walkNative(const ProfileStore& store, StackVisitor& visitor) {
+            const auto* view = store.view("calltree-children");
+            if (!view) return;
+            const auto* threadId = store.column(*view, "thread_id");
+            const auto* depth    = store.column(*view, "depth");
+            const auto* name     = store.column(*view, "name");
+            const auto* file     = store.column(*view, "source_file");
+            const auto* line     = store.column(*view, "source_line");
+            const auto* self     = store.column(*view, "self_time");
+            if (!threadId || !depth || !name || !file || !line || !self) return;
+
+            // Each thread's call tree hangs off a frame named after the thread.
+            std::unordered_map<StringId, std::string> threadLabels;
+            if (const auto* threads = store.view("threads")) {
+                const auto& table      = store.tableOf(*threads);
+                const auto* threadName = store.column(*threads, "name");
+                for (const auto row : threads->rows) {
+                    auto id = store.strings.view(table.ids[row]);
+                    if (!id.starts_with("thread:")) continue;
+                    id.remove_prefix(7);
+                    const auto key = store.strings.find(id);
+                    if (!key) continue;
+                    const auto label = threadName ? store.strings.view(threadName->text(row)) : std::string_view();
+                    threadLabels.emplace(*key, label.empty() ? "thread " + std::string(id) : std::string(label));
+                }
+            }
+
+            // Rows are flattened in pre-order per thread, so the depth column alone closes the frames a row leaves.
+            std::size_t             open = 0;
+            std::optional<StringId> thread;
+            std::string             threadLabel;
+            for (const auto row : view->rows) {
+                if (const auto rowThread = threadId->text(row); rowThread != thread) {
+                    for (; open > 0; --open) visitor.leave();
+                    thread              = rowThread;
+                    const auto labelled = threadLabels.find(rowThread);
+                    threadLabel = labelled != threadLabels.end()
+                                ? labelled->second
+                                : "thread " + std::string(store.strings.view(rowThread));
+                    visitor.enter({.name = threadLabel});
+                    open = 1;
+                }
+                const auto level  = static_cast<std::size_t>(std::max<std::int64_t>(0, depth->integer(row)));
+                const auto weight = static_cast<long double>(std::max<std::int64_t>(0, self->integer(row)));
+                // Below the deepest level kept, a row's ancestor at that level is the frame still open there.
+                if (level >= MaximumDepth) {
+                    for (; open > MaximumDepth + 1; --open) visitor.leave();
+                    visitor.addSelf(weight);
+                    continue;
+                }
+                for (; open > level + 1; --open) visitor.leave();
+                visitor.enter({
+                    .name = store.strings.view(name->text(row)),
+                    .file = store.strings.view(file->text(row)),
+                    .line = line->integer(row),
+                });
+                visitor.addSelf(weight);
+                ++open;
+            }
+            for (; open > 0; --open) visitor.leave();
+        }
+
+        // Each function's total time is split across its callees in proportion to the time spent through each call
+        // edge, and whatever no callee accounts for is its own. Recursion back into a function already on the stack
+        // stays with the caller.
+        void walkPythonCpu(const ProfileStore& store, StackVisitor& visitor) {
+            const auto* hotspots = store.view("hotspots");
+            if (!hotspots) return;
+            const auto* name   = store.column(*hotspots, "name");
+            const auto* module = store.column(*hotspots, "module");
+            const auto* line   = store.column(*hotspots, "line");
+            const auto* total  = store.column(*hotspots, "total_time");
+            if (!name || !module || !line || !total) return;
+            const auto& table = store.tableOf(*hotspots);
+
+            struct Callee {
+                std::uint32_t row  = 0;
+                long double   time = 0;
+            };
+            std::unordered_map<StringId, std::uint32_t> rowOf;
+            for (const auto row : hotspots->rows) rowOf.emplace(table.ids[row], row);
+            std::vector<std::vector<Callee>> callees(table.rows());
+            std::vector<bool>                called(table.rows());
+            const auto* calls    = store.view("calls");
+            const auto* callerId = calls ? store.column(*calls, "caller_id") : nullptr;
+            const auto* calleeId = calls ? store.column(*calls, "callee_id") : nullptr;
+            const auto* edgeTime = calls ? store.column(*calls, "total_time") : nullptr;
+            if (callerId && calleeId && edgeTime) {
+                for (const auto edge : calls->rows) {
+                    const auto caller = rowOf.find(callerId->text(edge));
+                    const auto callee = rowOf.find(calleeId->text(edge));
+                    const auto time   = static_cast<long double>(edgeTime->real(edge)) * Nanoseconds;
+                    if (caller == rowOf.end() || callee == rowOf.end() || caller->second == callee->second) continue;
+                    if (!std::isfinite(time) || time <= 0) continue;
+                    callees[caller->second].push_back({callee->second, time});
+                    called[callee->second] = true;
+                }
+            }
+            for (auto& edges : callees) {
+                std::stable_sort(edges.begin(), edges.end(), [](const Callee& left, const Callee& right) {
+                    return left.time > right.time;
+                });
+            }
+            const auto timeOf = [&](std::uint32_t row) {
+                const auto seconds = static_cast<long double>(total->real(row));
+                return std::isfinite(seconds) && seconds > 0 ? seconds * Nanoseconds : 0.0L;
+            };
+
+            std::vector<std::uint32_t> roots;
+            long double                captured = 0;
+            for (const auto row : hotspots->rows) {
+                if (called[row] || !(timeOf(row) > 0)) continue;
+                roots.push_back(row);
+                captured += timeOf(row);
+            }
+            // A capture taken entirely inside a cycle has no uncalled function; start from the heaviest one.
+            if (roots.empty() && !hotspots->rows.empty()) {
+                const auto heaviest = *std::max_element(
+                    hotspots->rows.begin(), hotspots->rows.end(),
+                    [&](std::uint32_t left, std::uint32_t right) { return timeOf(left) < timeOf(right); }
+                );
+                if (timeOf(heaviest) > 0) {
+                    roots.push_back(heaviest);
+                    captured = timeOf(heaviest);
+                }
+            }
+
+            const auto        minimum = captured * MinimumShare;
+            std::size_t       frames  = 0;
+            std::vector<bool> onStack(table.rows());
+            const auto expand = [&](auto& expand, std::uint32_t row, long double budget, std::size_t level) -> void {
+                visitor.enter({
+                    .name = store.strings.view(name->text(row)),
+                    .file = store.strings.view(module->text(row)),
+                    .line = line->integer(row),
+                });
+                ++frames;
+                onStack[row]      = true;
+                long double spent = 0;
+                const auto  own   = timeOf(row);
+                if (level + 1 < MaximumDepth && own > 0) {
+                    const auto scale = budget / own;
+                    for (const auto& callee : callees[row]) {
+                        if (onStack[callee.row]) continue;
+                        const auto share = std::min(callee.time * scale, budget - spent);
+                        if (share < minimum || share <= 0 || frames >= MaximumFrames) continue;
+                        spent += share;
+                        expand(expand, callee.row, share, level + 1);
+                    }
+                }
+                visitor.addSelf(budget - spent);
+                onStack[row] = false;
+                visitor.leave();
+            };
+            for (const auto root : roots) expand(expand, root, timeOf(root), 0);
+        }
+
+        // Allocation sites weighted by the bytes they still hold. Tracebacks are stored innermost frame first;
+        // ordering them outermost first makes every shared prefix contiguous, so it is entered once.
+        void walkPythonMemory(const ProfileStore& store, StackVisitor& visitor) {
+            const auto* view = store.view("retained");
+            if (!view) return;
+            const auto* size      = store.column(*view, "current_size");
+            const auto* traceback = store.column(*view, "traceback");
+            if (!size || !traceback) return;
+
+            const auto frameLess = [](const ProfileFrame& left, const ProfileFrame& right) {
+                return left.file != right.file ? left.file < right.file : left.line < right.line;
+            };
+            std::vector<std::uint32_t> rows(view->rows.begin(), view->rows.end());
+            std::stable_sort(rows.begin(), rows.end(), [&](std::uint32_t left, std::uint32_t right) {
+                const auto l = store.stack(traceback->integer(left));
+                const auto r = store.stack(traceback->integer(right));
+                return std::lexicographical_compare(l.rbegin(), l.rend(), r.rbegin(), r.rend(), frameLess);
+            });
+
+            std::vector<ProfileFrame> open;
+            std::vector<ProfileFrame> path;
+            for (const auto row : rows) {
+                const auto bytes = size->integer(row);
+                if (bytes <= 0) continue;
+                const auto frames = store.stack(traceback->integer(row));
+                path.assign(frames.rbegin(), frames.rend());
+                if (path.empty()) path.push_back({.file = UnknownSite});
+                if (path.size() > MaximumDepth) path.resize(MaximumDepth);
+
+                std::size_t common = 0;
+                while (common < open.size() && common < path.size() && open[common].file == path[common].file
+                       && open[common].line == path[common].line) {
+                    ++common;
+                }
+                for (; open.size() > common; open.pop_back()) visitor.leave();
+                for (; open.size() < path.size(); open.push_back(path[open.size()])) {
+                    const auto& frame = path[open.size()];
+                    visitor.enter(frame.file == UnknownSite
+                                      ? StackFrame{.name = "unknown allocation site"}
+                                      : StackFrame{.file = store.strings.view(frame.file), .line = frame.line});
+                }
+                visitor.addSelf(static_cast<long double>(bytes));
+            }
+            for (; !open.empty(); open.pop_back()) visitor.leave();
+        }
+
+        std::string frameLabel(const StackFrame& frame) {
+            std::string label(frame.name);
+            if (!frame.file.empty()) {
+                label += label.empty() ? "" : " (";
+                label += frame.file;
+                if (frame.line > 0) label += ':' + std::to_string(frame.line);
+                if (!frame.name.empty()) label += ')';
+            }
+            return label.empty() ? "unknown" : label;
+        }
+
+        // ';' separates frames and the last space precedes the weight; neither may break a line.
+        void appendFoldedFrame(std::string& output, std::string_view label) {
+            for (const char character : label) {
+                output += character == ';' ? ',' : character == '\n' || character == '\r' ? ' ' : character;
+            }
+        }
+
+        class FoldedWriter final : public StackVisitor {
+        public:
+            explicit FoldedWriter(std::ostream& output) : output_(output) {}
+
+            void enter(const StackFrame& frame) override {
+                lengths_.push_back(path_.size());
+                if (!path_.empty()) path_ += ';';
+                appendFoldedFrame(path_, frameLabel(frame));
+                self_.push_back(0);
+            }
+
+            void addSelf(long double weight) override { self_.back() += weight; }
+
+            void leave() override {
+                if (const auto weight = std::llround(self_.back()); weight > 0) output_ << path_ << ' ' << weight << '\n';
+                path_.resize(lengths_.back());
+                lengths_.pop_back();
+                self_.pop_back();
+            }
+
+        private:
+            std::ostream&            output_;
+            std::string              path_;
+            std::vector<std::size_t> lengths_;
+            std::vector<long double> self_;
+        };
+
+        // The first pass of the flame graph: the captured weight and the deepest stack size the canvas.
+        class FlameExtent final : public StackVisitor {
+        public:
+            void enter(const StackFrame&) override {
+                open_.push_back(0);
+                depth_ = std::max(depth_, open_.size());
+            }
+
+            void addSelf(long double weight) override { open_.back() += std::max(weight, 0.0L); }
+
+            void leave() override {
+                const auto inclusive = open_.back();
+                open_.pop_back();
+                (open_.empty() ? total_ : open_.back()) += inclusive;
+            }
+
+            [[nodiscard]] long double total() const noexcept { return total_; }
+            [[nodiscard]] std::size_t depth() const noexcept { return depth_; }
+
+        private:
+            std::vector<long double> open_;
+            long double              total_ = 0;
+            std::size_t              depth_ = 0;
+        };
+
+        void writeEscaped(std::ostream& output, std::string_view text) {
+            for (const char character : text) {
+                switch (character) {
+                case '&': output << "&amp;"; break;
+                case '<': output << "&lt;"; break;
+                case '>': output << "&gt;"; break;
+                case '"': output << "&quot;"; break;
+                default:
+                    output << (static_cast<unsigned char>(character) < 0x20 && character != '\t' ? ' ' : character);
+                }
+            }
+        }
+
+        std::string weightText(long double weight, bool bytes) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(2);
+            if (bytes) {
+                if (weight >= 1024.0L * 1024 * 1024) text << weight / (1024.0L * 1024 * 1024) << " GiB";
+                else if (weight >= 1024.0L * 1024) text << weight / (1024.0L * 1024) << " MiB";
+                else if (weight >= 1024.0L) text << weight / 1024.0L << " KiB";
+                else text << std::llround(weight) << " B";
+            } else {
+                if (weight >= 1e9L) text << weight / 1e9L << " s";
+                else if (weight >= 1e6L) text << weight / 1e6L << " ms";
+                else if (weight >= 1e3L) text << weight / 1e3L << " us";
+                else text << std::llround(weight) << " ns";
+            }
+            return text.str();
+        }
+
+        constexpr double ImageWidth     = 1200;
+        constexpr double Margin         = 10;
+        constexpr double FrameHeight    = 16;
+        constexpr double Header         = 64;
+        constexpr double Footer         = 28;
+        constexpr double CharacterWidth = 7;
+        constexpr double MinimumWidth   = 0.1;
+
+        // The second pass: every frame is drawn when it closes, once its width is known. Only the open stack is held.
+        class FlameRenderer final : public StackVisitor {
+        public:
+            // Byte weights are drawn in the green memory palette, time in the warm CPU palette.
+            FlameRenderer(std::ostream& output, long double total, std::size_t depth, bool bytes)
+                : output_(output),
+                  total_(total),
+                  scale_(total > 0 ? (ImageWidth - 2 * Margin) / total : 0),
+                  bottom_(Header + static_cast<double>(depth) * FrameHeight),
+                  bytes_(bytes) {}
+
+            void enter(const StackFrame& frame) override {
+                const auto x = open_.empty() ? cursor_ : open_.back().x + open_.back().children;
+                open_.push_back({.label = frameLabel(frame), .x = x});
+            }
+
+            void addSelf(long double weight) override { open_.back().self += std::max(weight, 0.0L); }
+
+            void leave() override {
+                auto       frame     = std::move(open_.back());
+                const auto inclusive = frame.self + frame.children;
+                open_.pop_back();
+                draw(frame.label, frame.x, inclusive, open_.size() + 1);
+                (open_.empty() ? cursor_ : open_.back().children) += inclusive;
+            }
+
+            // The root spans the whole capture at depth zero.
+            void finish() { draw("all", 0, total_, 0); }
+
+        private:
+            struct Frame {
+                std::string label;
+                long double x        = 0;
+                long double self     = 0;
+                long double children = 0;
+            };
+
+            void draw(std::string_view label, long double offset, long double weight, std::size_t depth) {
+                const auto width = static_cast<double>(weight * scale_);
+                if (width < MinimumWidth) return;
+                const auto x = Margin + static_cast<double>(offset * scale_);
+                const auto y = bottom_ - static_cast<double>(depth) * FrameHeight;
+
+                // A stable colour per name keeps one function recognisable across the graph.
+                std::uint32_t hash = 2166136261u;
+                for (const char character : label) hash = (hash ^ static_cast<unsigned char>(character)) * 16777619u;
+                const auto red   = bytes_ ? 0 : 205 + hash % 50;
+                const auto green = bytes_ ? 190 + hash % 50 : (hash >> 8) % 230;
+                const auto blue  = bytes_ ? (hash >> 8) % 210 : (hash >> 16) % 55;
+
+                output_ << "<g class=\"f\"><title>";
+                writeEscaped(output_, label);
+                output_ << '\n' << weightText(weight, bytes_) << ", " << (total_ > 0 ? weight * 100 / total_ : 0) << "%</title>"
+                        << "<rect x=\"" << x << "\" y=\"" << y << "\" width=\"" << width << "\" height=\""
+                        << FrameHeight - 1 << "\" fill=\"rgb(" << red << ',' << green << ',' << blue << ")\"/>"
+                        << "<text x=\"" << x + 3 << "\" y=\"" << y + 11.5 << "\">";
+                const auto characters = static_cast<std::size_t>(std::max(0.0, (width - 6) / CharacterWidth));
+                if (characters >= 3) {
+                    writeEscaped(output_, label.size() <= characters ? label : label.substr(0, characters - 2));
+                    if (label.size() > characters) output_ << "..";
+                }
+                output_ << "</text></g>\n";
+            }
+
+            std::ostream&      output_;
+            long double        total_;
+            long double        scale_;
+            double             bottom_;
+            bool               bytes_;
+            long double        cursor_ = 0;
+            std::vector<Frame> open_;
+        };
+
+        // Click a frame to zoom into it, click "Reset zoom" or press Escape to return, and press Ctrl+F or click
+        // "Search" to highlight frames matching a regular expression.
+        constexpr std::string_view FlameScript = R"(<script type="text/ecmascript"><![CDATA[
+(function () {
+  var svg = document.documentElement, left = 10, width = 1180;
+  var frames = [].slice.call(svg.querySelectorAll('g.f'));
+  var details = document.getElementById('details'), matched = document.getElementById('matched');
+  var reset = document.getElementById('reset');
+  frames.forEach(function (g) {
+    var r = g.querySelector('rect');
+    g.x0 = +r.getAttribute('x'); g.w0 = +r.getAttribute('width'); g.y0 = +r.getAttribute('y');
+    g.label = g.querySelector('title').textContent.split('\n')[0];
+  });
+  function fit(g, x, w) {
+    var r = g.querySelector('rect'), t = g.querySelector('text'), n = Math.floor((w - 6) / 7);
+    r.setAttribute('x', x.toFixed(2)); r.setAttribute('width', w.toFixed(2)); t.setAttribute('x', (x + 3).toFixed(2));
+    t.textContent = n < 3 ? '' : g.label.length > n ? g.label.slice(0, n - 2) + '..' : g.label;
+  }
+  function zoom(target) {
+    var x0 = target ? target.x0 : left, w0 = target ? target.w0 : width, scale = width / w0, e = 1e-6;
+    frames.forEach(function (g) {
+      var ancestor = target && g.y0 > target.y0;
+      var show = ancestor ? g.x0 <= x0 + e && g.x0 + g.w0 >= x0 + w0 - e : g.x0 >= x0 - e && g.x0 + g.w0 <= x0 + w0 + e;
+      g.style.display = show ? '' : 'none';
+      if (show) fit(g, ancestor ? left : left + (g.x0 - x0) * scale, ancestor ? width : g.w0 * scale);
+    });
+    reset.style.display = target ? '' : 'none';
+  }
+  function search() {
+    var term = window.prompt('Search frames (regular expression)', ''), pattern = null;
+    if (term === null) return;
+    try { pattern = term === '' ? null : new RegExp(term, 'i'); } catch (error) { return; }
+    var hits = [];
+    frames.forEach(function (g) {
+      var hit = pattern !== null && pattern.test(g.label);
+      g.querySelector('rect').style.fill = hit ? 'rgb(230,0,230)' : '';
+      if (hit) hits.push(g);
+    });
+    hits.sort(function (a, b) { return a.x0 - b.x0; });
+    var covered = 0, end = -1;
+    hits.forEach(function (g) {
+      var start = Math.max(g.x0, end), stop = g.x0 + g.w0;
+      if (stop > start) { covered += stop - start; end = stop; }
+    });
+    matched.textContent = pattern === null ? '' : 'Matched: ' + (100 * covered / width).toFixed(1) + '%';
+  }
+  svg.addEventListener('click', function (event) {
+    var g = event.target.closest ? event.target.closest('g.f') : null;
+    if (event.target.id === 'search') search();
+    else if (event.target.id === 'reset') zoom(null);
+    else if (g) zoom(g);
+  });
+  svg.addEventListener('mouseover', function (event) {
+    var g = event.target.closest ? event.target.closest('g.f') : null;
+    details.textContent = g ? g.querySelector('title').textContent.replace('\n', ' - ') : ' ';
+  });
+  window.addEventListener('keydown', function (event) {
+    if ((event.ctrlKey || event.metaKey) && event.key === 'f') { event.preventDefault(); search(); }
+    else if (event.key === 'Escape') zoom(null);
+  });
+})();
+]]></script>
+)";
+
+    } // namespace
+
+    void walkStacks(const ProfileStore& store, StackVisitor& visitor) {
+        switch (store.kind) {
+        case ProfilerKind::PythonCpu: walkPythonCpu(store, visitor); break;
+        case ProfilerKind::PythonMemory: walkPythonMemory(store, visitor); break;
+        case ProfilerKind::NativeCpu: walkNative(store, visitor); break;
+        case ProfilerKind::FrameTime: break; // Durations only; there are no stacks.
+        }
+    }
+
+    void writeFoldedStacks(const ProfileStore& store, std::ostream& output) {
+        FoldedWriter writer(output);
+        walkStacks(store, writer);
+    }
+
+    void writeFlameGraph(const ProfileStore& store, std::string_view title, std::string_view subtitle, std::ostream& output) {
+        FlameExtent extent;
+        walkStacks(store, extent);
+        const bool memory = store.kind == ProfilerKind::PythonMemory;
+        const auto height = Header + static_cast<double>(extent.depth() + 1) * FrameHeight + Footer;
+
+        output << std::fixed << std::setprecision(2);
+        output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"" << ImageWidth << "\" height=\""
+               << height << "\" viewBox=\"0 0 " << ImageWidth << ' ' << height << "\">\n"
+               << "<style>text{font-family:Verdana,sans-serif;font-size:12px;fill:#111}g.f text{pointer-events:none}"
+               << "g.f:hover rect{stroke:#222;stroke-width:0.5}#search,#reset{cursor:pointer;fill:#2457a6}</style>\n"
+               << "<rect width=\"100%\" height=\"100%\" fill=\"#f8f6f1\"/>\n"
+               << "<text x=\"" << ImageWidth / 2 << "\" y=\"24\" text-anchor=\"middle\" style=\"font-size:17px\">";
+        writeEscaped(output, title);
+        output << "</text>\n<text x=\"" << ImageWidth / 2 << "\" y=\"44\" text-anchor=\"middle\" fill=\"#555\">";
+        writeEscaped(output, subtitle);
+        output << "</text>\n"
+               << "<text id=\"reset\" x=\"" << Margin << "\" y=\"24\" style=\"display:none\">Reset zoom</text>\n"
+               << "<text id=\"search\" x=\"" << ImageWidth - Margin << "\" y=\"24\" text-anchor=\"end\">Search</text>\n"
+               << "<text id=\"matched\" x=\"" << ImageWidth - Margin << "\" y=\"" << height - 10
+               << "\" text-anchor=\"end\"></text>\n"
+               << "<text id=\"details\" x=\"" << Margin << "\" y=\"" << height - 10 << "\"> </text>\n";
+        if (extent.total() > 0) {
+            FlameRenderer renderer(output, extent.total(), extent.depth(), memory);
+            walkStacks(store, renderer);
+            renderer.finish();
+        } else {
+            output << "<text x=\"" << ImageWidth / 2 << "\" y=\"" << Header + FrameHeight
+                   << "\" text-anchor=\"middle\">No stacks were captured.</text>\n";
+        }
+        output << FlameScript << "</svg>\n";
+    }
+
+} // namespace mcdk::performance
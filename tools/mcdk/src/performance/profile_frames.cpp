@@ -0,0 +1,179 @@
+#include <performance/profile_frames.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace mcdk::performance {
+namespace {
+
+    using Json = nlohmann::json;
+
+    constexpr int          SubBucketBits = 7;
+    constexpr std::int64_t SubBuckets    = std::int64_t{1} << SubBucketBits;
+    constexpr std::int64_t MaximumValue  = 3'600'000'000; // One hour in microseconds.
+    // The slowest frames kept per side.
+    constexpr std::size_t MaximumWorstFrames = 50;
+
+    std::size_t bucketOf(std::int64_t value) {
+        if (value < SubBuckets) return static_cast<std::size_t>(value);
+        const auto exponent = std::bit_width(static_cast<std::uint64_t>(value)) - 1;
+        const auto shift    = exponent - SubBucketBits;
+        return static_cast<std::size_t>(SubBuckets * (shift + 1) + ((value >> shift) - SubBuckets));
+    }
+
+    std::pair<std::int64_t, std::int64_t> boundsOf(std::size_t bucket) {
+        const auto index = static_cast<std::int64_t>(bucket);
+        if (index < SubBuckets) return {index, index};
+        const auto shift  = index / SubBuckets - 1;
+        const auto lowest = (SubBuckets + index % SubBuckets) << shift;
+        return {lowest, lowest + (std::int64_t{1} << shift) - 1};
+    }
+
+    double milliseconds(std::int64_t microseconds) { return static_cast<double>(microseconds) / 1000.0; }
+
+    const char* sideName(ProfileTarget side) { return side == ProfileTarget::Server ? "server" : "client"; }
+
+    constexpr auto Slower = [](const auto& left, const auto& right) { return left.duration > right.duration; };
+
+} // namespace
+
+    void FrameHistogram::record(std::int64_t microseconds) {
+        const auto value = std::clamp<std::int64_t>(microseconds, 0, MaximumValue);
+        const auto bucket = bucketOf(value);
+        if (bucket >= counts_.size()) counts_.resize(bucket + 1, 0);
+        ++counts_[bucket];
+        minimum_ = count_ == 0 ? value : std::min(minimum_, value);
+        maximum_ = std::max(maximum_, value);
+        sum_ += value;
+        ++count_;
+    }
+
+    double FrameHistogram::mean() const noexcept {
+        return count_ == 0 ? 0.0 : static_cast<double>(sum_ / static_cast<long double>(count_));
+    }
+
+    std::int64_t FrameHistogram::percentile(double percentile) const {
+        if (count_ == 0) return 0;
+        const auto rank = std::clamp<std::uint64_t>(
+            static_cast<std::uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count_))),
+            1,
+            count_
+        );
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < counts_.size(); ++bucket) {
+            seen += counts_[bucket];
+            if (seen >= rank) return std::min(boundsOf(bucket).second, maximum_);
+        }
+        return maximum_;
+    }
+
+    std::vector<FrameHistogram::Bucket> FrameHistogram::buckets() const {
+        std::vector<Bucket> result;
+        for (std::size_t bucket = 0; bucket < counts_.size(); ++bucket) {
+            if (counts_[bucket] == 0) continue;
+            const auto [lowest, highest] = boundsOf(bucket);
+            result.push_back({.lowest = lowest, .highest = highest, .count = counts_[bucket]});
+        }
+        return result;
+    }
+
+    FrameTimeline::Side& FrameTimeline::side(ProfileTarget target) {
+        return sides_[target == ProfileTarget::Server ? ProfileTarget::Server : ProfileTarget::Client];
+    }
+
+    void FrameTimeline::append(ProfileTarget target, std::span<const double> durations, double end) {
+        auto& entry = side(target);
+        // Counting back from the drain; a drain that ran late only shifts its frames later, never reorders them.
+        for (auto duration = durations.rbegin(); duration != durations.rend(); ++duration) {
+            if (!std::isfinite(*duration) || *duration < 0) continue;
+            const Frame frame{.end = std::max(0.0, end), .duration = *duration};
+            end -= *duration / 1000.0;
+            entry.histogram.record(std::llround(frame.duration * 1000.0));
+            auto& window = entry.windows[static_cast<std::int64_t>(std::floor(frame.end))];
+            ++window.frames;
+            window.sum += frame.duration;
+            window.maximum = std::max(window.maximum, frame.duration);
+            if (entry.worst.size() < MaximumWorstFrames) {
+                entry.worst.push_back(frame);
+                std::push_heap(entry.worst.begin(), entry.worst.end(), Slower);
+            } else if (frame.duration > entry.worst.front().duration) {
+                std::pop_heap(entry.worst.begin(), entry.worst.end(), Slower);
+                entry.worst.back() = frame;
+                std::push_heap(entry.worst.begin(), entry.worst.end(), Slower);
+            }
+        }
+    }
+
+    void FrameTimeline::lose(ProfileTarget target, std::uint64_t frames) { side(target).lost += frames; }
+
+    nlohmann::json FrameTimeline::payload(double elapsed, std::span<const FrameCpuWindow> windows) const {
+        Json sides     = Json::array();
+        Json histogram = Json::array();
+        Json series    = Json::array();
+        Json worst     = Json::array();
+        Json cpuJobs   = Json::array();
+        for (const auto& window : windows) {
+            cpuJobs.push_back(Json::array({window.jobId, toString(window.kind), window.start, window.end}));
+        }
+        for (const auto& [target, entry] : sides_) {
+            const auto name = sideName(target);
+            const auto& values = entry.histogram;
+            sides.push_back(Json{
+                {"side", name},
+                {"frames", values.count()},
+                {"lost", entry.lost},
+                {"mean", values.mean() / 1000.0},
+                {"minimum", milliseconds(values.minimum())},
+                {"p50", milliseconds(values.percentile(50))},
+                {"p90", milliseconds(values.percentile(90))},
+                {"p99", milliseconds(values.percentile(99))},
+                {"maximum", milliseconds(values.maximum())},
+            });
+            std::uint64_t cumulative = 0;
+            for (const auto& bucket : values.buckets()) {
+                cumulative += bucket.count;
+                histogram.push_back(Json::array({
+                    name, milliseconds(bucket.lowest), milliseconds(bucket.highest), bucket.count,
+                    100.0 * static_cast<double>(cumulative) / static_cast<double>(values.count()),
+                }));
+            }
+            for (const auto& [second, window] : entry.windows) {
+                series.push_back(Json::array({
+                    name, second, window.frames, window.sum / static_cast<double>(window.frames), window.maximum,
+                }));
+            }
+            auto frames = entry.worst;
+            std::sort(frames.begin(), frames.end(), Slower);
+            for (const auto& frame : frames) {
+                // The CPU window sharing most of the frame; a frame shorter than the drain jitter can miss by a tick.
+                const FrameCpuWindow* linked = nullptr;
+                double overlap = -1;
+                const auto start = frame.end - frame.duration / 1000.0;
+                for (const auto& window : windows) {
+                    const auto shared = std::min(frame.end, window.end) - std::max(start, window.start);
+                    if (shared >= 0 && shared > overlap) {
+                        linked  = &window;
+                        overlap = shared;
+                    }
+                }
+                worst.push_back(Json::array({
+                    name, frame.end, frame.duration,
+                    linked ? Json(linked->jobId) : Json(nullptr), linked ? Json(toString(linked->kind)) : Json(nullptr),
+                }));
+            }
+        }
+        return Json{
+            {"elapsed", elapsed},
+            {"sides", std::move(sides)},
+            {"histogram", std::move(histogram)},
+            {"series", std::move(series)},
+            {"worst", std::move(worst)},
+            {"cpu_jobs", std::move(cpuJobs)},
+        };
+    }
+
+} // namespace mcdk::performance
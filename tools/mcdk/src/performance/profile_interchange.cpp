@@ -0,0 +1,439 @@
+#include <performance/profile_interchange.hpp>
+
+#include <performance/profile_flame.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <zlib.h>
+
+namespace mcdk::performance {
+
+    namespace {
+
+        // Deflates into a gzip member as bytes arrive; nothing but the window and one output buffer is held. The
+        // fastest level already shrinks profiles severalfold, and its match search is a fraction of the default's.
+        class GzipWriter {
+        public:
+            explicit GzipWriter(std::ostream& output) : output_(output) {
+                valid_ = deflateInit2(&stream_, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+                initialized_ = valid_;
+            }
+
+            ~GzipWriter() {
+                if (initialized_) deflateEnd(&stream_);
+            }
+
+            GzipWriter(const GzipWriter&)            = delete;
+            GzipWriter& operator=(const GzipWriter&) = delete;
+
+            void write(std::string_view bytes) { pump(bytes, Z_NO_FLUSH); }
+
+            void finish() {
+                pump({}, Z_FINISH);
+                if (!valid_) output_.setstate(std::ios::badbit);
+            }
+
+        private:
+            void pump(std::string_view input, int flush) {
+                if (!valid_) return;
+                stream_.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+                stream_.avail_in = static_cast<uInt>(input.size());
+                int status       = Z_OK;
+                do {
+                    stream_.next_out  = reinterpret_cast<Bytef*>(buffer_.data());
+                    stream_.avail_out = static_cast<uInt>(buffer_.size());
+                    status            = deflate(&stream_, flush);
+                    if (status == Z_STREAM_ERROR) {
+                        valid_ = false;
+                        return;
+                    }
+                    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size() - stream_.avail_out));
+                } while (stream_.avail_out == 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+            }
+
+            std::ostream&           output_;
+            z_stream                stream_{};
+            std::array<char, 65536> buffer_{};
+            bool                    valid_       = false;
+            bool                    initialized_ = false;
+        };
+
+        // Protocol buffer wire encoding of the few field kinds profile.proto uses.
+        void appendVarint(std::string& output, std::uint64_t value) {
+            for (; value >= 0x80; value >>= 7) output += static_cast<char>(value | 0x80);
+            output += static_cast<char>(value);
+        }
+
+        void appendInteger(std::string& output, std::uint32_t field, std::uint64_t value) {
+            if (value == 0) return;
+            appendVarint(output, static_cast<std::uint64_t>(field) << 3);
+            appendVarint(output, value);
+        }
+
+        void appendBytes(std::string& output, std::uint32_t field, std::string_view value) {
+            appendVarint(output, static_cast<std::uint64_t>(field) << 3 | 2);
+            appendVarint(output, value.size());
+            output += value;
+        }
+
+        // profile.proto field numbers.
+        enum ProfileField : std::uint32_t {
+            SampleType  = 1,
+            Sample      = 2,
+            Location    = 4,
+            Function    = 5,
+            StringTable = 6,
+            PeriodType  = 11,
+            Period      = 12,
+        };
+
+        // A Profile message is the concatenation of its fields, and repeated fields may interleave, so each function,
+        // location, string and sample is appended the first time it is needed. String indexes follow the order in
+        // which string_table entries appear, starting with the mandatory empty string.
+        class PprofWriter final : public StackVisitor {
+        public:
+            PprofWriter(std::ostream& output, std::string_view type, std::string_view unit) : gzip_(output) {
+                (void)stringOf("");
+                std::string valueType;
+                appendInteger(valueType, 1, stringOf(type));
+                appendInteger(valueType, 2, stringOf(unit));
+                appendBytes(pending_, SampleType, valueType);
+                appendBytes(pending_, PeriodType, valueType);
+                appendInteger(pending_, Period, 1);
+            }
+
+            void enter(const StackFrame& frame) override {
+                path_.push_back(locationOf(frame));
+                self_.push_back(0);
+            }
+
+            void addSelf(long double weight) override { self_.back() += weight; }
+
+            void leave() override {
+                if (const auto weight = std::llround(self_.back()); weight > 0) {
+                    std::string locations;
+                    for (auto location = path_.rbegin(); location != path_.rend(); ++location) {
+                        appendVarint(locations, *location);
+                    }
+                    std::string value;
+                    appendVarint(value, static_cast<std::uint64_t>(weight));
+                    std::string sample;
+                    appendBytes(sample, 1, locations);
+                    appendBytes(sample, 2, value);
+                    appendBytes(pending_, Sample, sample);
+                    flushIfFull();
+                }
+                path_.pop_back();
+                self_.pop_back();
+            }
+
+            void finish() {
+                gzip_.write(pending_);
+                gzip_.finish();
+            }
+
+        private:
+            std::uint64_t stringOf(std::string_view value) {
+                const auto [found, inserted] = strings_.try_emplace(std::string(value), strings_.size());
+                if (inserted) appendBytes(pending_, StringTable, value);
+                return found->second;
+            }
+
+            std::uint64_t functionOf(std::string_view name, std::string_view file) {
+                key_.assign(name).append(1, '\0').append(file);
+                if (const auto found = functions_.find(key_); found != functions_.end()) return found->second;
+                const auto id = functions_.size() + 1;
+                functions_.emplace(key_, id);
+                const auto nameIndex = stringOf(name);
+                std::string function;
+                appendInteger(function, 1, id);
+                appendInteger(function, 2, nameIndex);
+                appendInteger(function, 3, nameIndex);
+                appendInteger(function, 4, stringOf(file));
+                appendBytes(pending_, Function, function);
+                return id;
+            }
+
+            std::uint64_t locationOf(const StackFrame& frame) {
+                locationKey_.assign(frame.name).append(1, '\0').append(frame.file).append(1, '\0');
+                locationKey_ += std::to_string(frame.line);
+                if (const auto found = locations_.find(locationKey_); found != locations_.end()) return found->second;
+                const auto id = locations_.size() + 1;
+                locations_.emplace(locationKey_, id);
+                // A traceback frame has no function name; its location names it.
+                std::string name(frame.name);
+                if (name.empty()) name = std::string(frame.file) + (frame.line > 0 ? ':' + std::to_string(frame.line) : "");
+                const auto function = functionOf(name, frame.file);
+                std::string line;
+                appendInteger(line, 1, function);
+                appendInteger(line, 2, static_cast<std::uint64_t>(std::max<std::int64_t>(0, frame.line)));
+                std::string location;
+                appendInteger(location, 1, id);
+                appendBytes(location, 4, line);
+                appendBytes(pending_, Location, location);
+                return id;
+            }
+
+            void flushIfFull() {
+                if (pending_.size() < 65536) return;
+                gzip_.write(pending_);
+                pending_.clear();
+            }
+
+            GzipWriter                                     gzip_;
+            std::string                                    pending_;
+            std::string                                    key_;
+            std::string                                    locationKey_;
+            std::unordered_map<std::string, std::uint64_t> strings_;
+            std::unordered_map<std::string, std::uint64_t> functions_;
+            std::unordered_map<std::string, std::uint64_t> locations_;
+            std::vector<std::uint64_t>                     path_;
+            std::vector<long double>                       self_;
+        };
+
+        // JSON string text with invalid UTF-8 replaced by U+FFFD, so names from any engine stay loadable.
+        void appendJsonString(std::string& output, std::string_view value) {
+            output += '"';
+            for (std::size_t index = 0; index < value.size();) {
+                const auto byte = static_cast<unsigned char>(value[index]);
+                if (byte < 0x80) {
+                    if (byte == '"' || byte == '\\') {
+                        output += '\\';
+                        output += static_cast<char>(byte);
+                    } else if (byte < 0x20) {
+                        constexpr char hex[] = "0123456789abcdef";
+                        output += "\\u00";
+                        output += hex[byte >> 4];
+                        output += hex[byte & 15];
+                    } else {
+                        output += static_cast<char>(byte);
+                    }
+                    ++index;
+                    continue;
+                }
+                const std::size_t length = byte >= 0xf5 ? 0 : byte >= 0xf0 ? 4 : byte >= 0xe0 ? 3 : byte >= 0xc2 ? 2 : 0;
+                bool valid = length != 0 && index + length <= value.size();
+                for (std::size_t next = 1; valid && next < length; ++next) {
+                    valid = (static_cast<unsigned char>(value[index + next]) & 0xc0) == 0x80;
+                }
+                if (valid) {
+                    output.append(value.substr(index, length));
+                    index += length;
+                } else {
+                    output += "\\ufffd";
+                    ++index;
+                }
+            }
+            output += '"';
+        }
+
+        // Nanoseconds as the microseconds trace events count in, exactly.
+        void appendMicroseconds(std::string& output, std::int64_t nanoseconds) {
+            nanoseconds = std::max<std::int64_t>(0, nanoseconds);
+            const auto fraction = std::to_string(nanoseconds % 1000);
+            output += std::to_string(nanoseconds / 1000);
+            output += '.';
+            output.append(3 - fraction.size(), '0');
+            output += fraction;
+        }
+
+        void appendMember(std::string& output, std::string_view key, std::int64_t value) {
+            output += output.empty() ? "" : ",";
+            appendJsonString(output, key);
+            output += ':';
+            output += std::to_string(value);
+        }
+
+        void appendMember(std::string& output, std::string_view key, std::string_view value) {
+            output += output.empty() ? "" : ",";
+            appendJsonString(output, key);
+            output += ':';
+            appendJsonString(output, value);
+        }
+
+        // Trace events are written one per line between the array brackets as they are produced.
+        class TraceEvents {
+        public:
+            explicit TraceEvents(std::ostream& output) : output_(output) {
+                output_ << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+            }
+
+            // A process_name or thread_name metadata event.
+            void name(std::string_view kind, int process, int thread, std::string_view value) {
+                begin();
+                line_ += "\"name\":";
+                appendJsonString(line_, kind);
+                line_ += ",\"ph\":\"M\",\"pid\":" + std::to_string(process) + ",\"tid\":" + std::to_string(thread);
+                line_ += ",\"args\":{\"name\":";
+                appendJsonString(line_, value);
+                line_ += "}}";
+                output_ << line_;
+            }
+
+            // A complete event; args holds already formatted members.
+            void complete(
+                std::string_view name,
+                std::string_view category,
+                int              process,
+                int              thread,
+                std::int64_t     start,
+                std::int64_t     duration,
+                std::string_view args
+            ) {
+                begin();
+                line_ += "\"name\":";
+                appendJsonString(line_, name);
+                line_ += ",\"cat\":";
+                appendJsonString(line_, category);
+                line_ += ",\"ph\":\"X\",\"pid\":" + std::to_string(process) + ",\"tid\":" + std::to_string(thread);
+                line_ += ",\"ts\":";
+                appendMicroseconds(line_, start);
+                line_ += ",\"dur\":";
+                appendMicroseconds(line_, duration);
+                line_ += ",\"args\":{";
+                line_ += args;
+                line_ += "}}";
+                output_ << line_;
+            }
+
+            void finish() { output_ << "\n]}\n"; }
+
+        private:
+            void begin() {
+                line_.assign(first_ ? "\n{" : ",\n{");
+                first_ = false;
+            }
+
+            std::ostream& output_;
+            std::string   line_;
+            bool          first_ = true;
+        };
+
+        constexpr int RecordedProcess = 1;
+        constexpr int CalltreeProcess = 2;
+
+        std::string sourceOf(std::string_view file, std::int64_t line) {
+            return std::string(file) + (line > 0 ? ':' + std::to_string(line) : "");
+        }
+
+    } // namespace
+
+    void writePprof(const ProfileStore& store, std::ostream& output) {
+        const bool  memory = store.kind == ProfilerKind::PythonMemory;
+        PprofWriter writer(output, memory ? "inuse_space" : "cpu", memory ? "bytes" : "nanoseconds");
+        walkStacks(store, writer);
+        writer.finish();
+    }
+
+    void writeChromeTrace(const ProfileStore& store, std::ostream& output) {
+        TraceEvents events(output);
+        const auto* slowest  = store.kind == ProfilerKind::NativeCpu ? store.view("slowest-calls") : nullptr;
+        const auto* calltree = store.kind == ProfilerKind::NativeCpu ? store.view("calltree-children") : nullptr;
+        const auto* hotspots = store.kind == ProfilerKind::NativeCpu ? store.view("hotspots") : nullptr;
+        if (!slowest || !calltree || !hotspots) {
+            events.finish();
+            return;
+        }
+        const auto text = [&](const ProfileView& view, std::string_view name, std::uint32_t row) {
+            const auto* column = store.column(view, name);
+            return column ? store.strings.view(column->text(row)) : std::string_view();
+        };
+        const auto integer = [&](const ProfileView& view, std::string_view name, std::uint32_t row) {
+            const auto* column = store.column(view, name);
+            return column ? column->integer(row) : std::int64_t{0};
+        };
+
+        // Trace viewers want numeric thread ids; captured ids are text, so threads are numbered as they appear.
+        std::unordered_map<StringId, int> threadIds;
+        const auto threadOf = [&](StringId key, std::string_view name) {
+            const auto [found, inserted] = threadIds.try_emplace(key, static_cast<int>(threadIds.size()) + 1);
+            if (inserted) {
+                const auto label = (name.empty() ? "thread" : std::string(name)) + " (" + std::string(store.strings.view(key)) + ')';
+                for (const auto process : {RecordedProcess, CalltreeProcess}) events.name("thread_name", process, found->second, label);
+            }
+            return found->second;
+        };
+        events.name("process_name", RecordedProcess, 0, "Recorded slowest calls");
+        events.name("process_name", CalltreeProcess, 0, "Call tree (total time per node)");
+
+        std::unordered_map<StringId, std::uint32_t> zones;
+        const auto& zoneTable = store.tableOf(*hotspots);
+        for (const auto row : hotspots->rows) zones.emplace(zoneTable.ids[row], row);
+        const auto* zoneId   = store.column(*slowest, "zone_id");
+        const auto* threadId = store.column(*slowest, "thread_id");
+        std::string args;
+        for (const auto row : zoneId && threadId ? slowest->rows : std::span<const std::uint32_t>()) {
+            args.clear();
+            appendMember(args, "source", sourceOf(text(*slowest, "source_file", row), integer(*slowest, "source_line", row)));
+            if (const auto zone = zones.find(zoneId->text(row)); zone != zones.end()) {
+                appendMember(args, "zone_calls", integer(*hotspots, "calls", zone->second));
+                appendMember(args, "zone_total_time_ns", integer(*hotspots, "total_time", zone->second));
+                appendMember(args, "zone_self_time_ns", integer(*hotspots, "self_time", zone->second));
+                appendMember(args, "zone_mean_time_ns", integer(*hotspots, "mean_time", zone->second));
+                appendMember(args, "zone_maximum_time_ns", integer(*hotspots, "maximum_time", zone->second));
+            }
+            events.complete(
+                text(*slowest, "name", row), "zone", RecordedProcess,
+                threadOf(threadId->text(row), text(*slowest, "thread_name", row)),
+                integer(*slowest, "start_time", row), integer(*slowest, "duration", row), args
+            );
+        }
+
+        // Thread names for the call tree come from the threads view; threads without recorded calls appear here first.
+        std::unordered_map<StringId, std::string_view> threadNames;
+        if (const auto* threads = store.view("threads")) {
+            const auto& table = store.tableOf(*threads);
+            for (const auto row : threads->rows) {
+                auto id = store.strings.view(table.ids[row]);
+                if (!id.starts_with("thread:")) continue;
+                if (const auto key = store.strings.find(id.substr(7))) threadNames.emplace(*key, text(*threads, "name", row));
+            }
+        }
+        struct Open {
+            std::int64_t end    = 0;
+            std::int64_t cursor = 0;
+        };
+        std::vector<Open>       open;
+        std::optional<StringId> thread;
+        std::int64_t            threadCursor = 0;
+        int                     threadTrack  = 0;
+        const auto* calltreeThread           = store.column(*calltree, "thread_id");
+        for (const auto row : calltreeThread ? calltree->rows : std::span<const std::uint32_t>()) {
+            if (const auto rowThread = calltreeThread->text(row); rowThread != thread) {
+                thread       = rowThread;
+                threadCursor = 0;
+                open.clear();
+                const auto threadName = threadNames.find(rowThread);
+                threadTrack = threadOf(rowThread, threadName != threadNames.end() ? threadName->second : std::string_view());
+            }
+            const auto depth = static_cast<std::size_t>(std::max<std::int64_t>(0, integer(*calltree, "depth", row)));
+            if (open.size() > depth) open.resize(depth);
+            auto&      cursor = open.empty() ? threadCursor : open.back().cursor;
+            const auto start  = cursor;
+            // A child never outlasts its parent, even when rounded totals disagree.
+            auto duration = std::max<std::int64_t>(0, integer(*calltree, "total_time", row));
+            if (!open.empty()) duration = std::clamp<std::int64_t>(open.back().end - start, 0, duration);
+            cursor += duration;
+            args.clear();
+            appendMember(args, "source", sourceOf(text(*calltree, "source_file", row), integer(*calltree, "source_line", row)));
+            appendMember(args, "calls", integer(*calltree, "calls", row));
+            appendMember(args, "self_time_ns", integer(*calltree, "self_time", row));
+            appendMember(args, "mean_time_ns", integer(*calltree, "mean_time", row));
+            appendMember(args, "maximum_time_ns", integer(*calltree, "maximum_time", row));
+            events.complete(text(*calltree, "name", row), "calltree", CalltreeProcess, threadTrack, start, duration, args);
+            open.push_back({.end = start + duration, .cursor = start});
+        }
+        events.finish();
+    }
+
+} // namespace mcdk::performance
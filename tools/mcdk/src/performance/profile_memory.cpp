@@ -0,0 +1,144 @@
+#include <performance/profile_memory.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <nlohmann/json.hpp>
+
+namespace mcdk::performance {
+namespace {
+
+    using Json = nlohmann::json;
+
+    // A site needs this many points before its line means anything, and a line must explain this share of the
+    // variation before the site counts as growing or shrinking rather than having settled after a step.
+    constexpr std::size_t MinimumPoints = 3;
+    constexpr double      SteadyFit     = 0.8;
+
+    std::vector<std::pair<std::string, std::int64_t>> framesOf(const Json& frames) {
+        std::vector<std::pair<std::string, std::int64_t>> result;
+        if (!frames.is_array()) return result;
+        for (const auto& frame : frames) {
+            if (!frame.is_array() || frame.size() < 2 || !frame[0].is_string() || !frame[1].is_number_integer()) continue;
+            result.emplace_back(frame[0].get<std::string>().substr(0, 4096), frame[1].get<std::int64_t>());
+        }
+        return result;
+    }
+
+    const char* trendOf(std::size_t points, const GrowthFit& fit, std::int64_t first, std::int64_t last) {
+        if (points < MinimumPoints) return "insufficient";
+        if (fit.rSquared >= SteadyFit && fit.slope > 0 && last > first) return "growing";
+        if (fit.rSquared >= SteadyFit && fit.slope < 0 && last < first) return "shrinking";
+        return "plateau";
+    }
+
+} // namespace
+
+    std::optional<GrowthFit> fitGrowth(std::span<const double> seconds, std::span<const double> bytes) {
+        const auto count = std::min(seconds.size(), bytes.size());
+        if (count < 2) return std::nullopt;
+        double meanTime = 0;
+        double meanBytes = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            meanTime += seconds[index];
+            meanBytes += bytes[index];
+        }
+        meanTime /= static_cast<double>(count);
+        meanBytes /= static_cast<double>(count);
+        double timeSquares = 0;
+        double byteSquares = 0;
+        double products = 0;
+        for (std::size_t index = 0; index < count; ++index) {
+            const auto time = seconds[index] - meanTime;
+            const auto value = bytes[index] - meanBytes;
+            timeSquares += time * time;
+            byteSquares += value * value;
+            products += time * value;
+        }
+        if (!(timeSquares > 0)) return std::nullopt;
+        GrowthFit fit;
+        fit.slope = products / timeSquares;
+        fit.intercept = meanBytes - fit.slope * meanTime;
+        // A site that never changed has nothing to explain; it fits no trend.
+        fit.rSquared = byteSquares > 0 ? std::clamp(products * products / (timeSquares * byteSquares), 0.0, 1.0) : 0.0;
+        return fit;
+    }
+
+    void MemoryTimeline::append(const Json& snapshot) {
+        if (!snapshot.is_object() || !snapshot.value("ok", false)) return;
+        Snapshot entry{
+            .elapsed   = std::max(0.0, snapshot.value("elapsed", 0.0)),
+            .sizeDiff  = snapshot.value("sizeDiff", std::int64_t{0}),
+            .countDiff = snapshot.value("countDiff", std::int64_t{0}),
+        };
+        if (const auto found = snapshot.find("sites"); found != snapshot.end() && found->is_array()) {
+            for (const auto& site : *found) {
+                if (!site.is_array() || site.size() < 2 || !site[0].is_number_integer()) continue;
+                auto& frames = sites_[site[0].get<std::int64_t>()].frames;
+                if (frames.empty()) frames = framesOf(site[1]);
+            }
+        }
+        if (const auto found = snapshot.find("rows"); found != snapshot.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                if (!row.is_array() || row.size() < 3 || !row[0].is_number_integer() || !row[1].is_number_integer()) continue;
+                sites_[row[0].get<std::int64_t>()].points.push_back({.elapsed = entry.elapsed, .sizeDiff = row[1].get<std::int64_t>()});
+                ++entry.sites;
+            }
+        }
+        snapshots_.push_back(entry);
+    }
+
+    Json MemoryTimeline::payload(Json collected) const {
+        if (snapshots_.empty() || !collected.is_object()) return collected;
+        auto sites = sites_;
+        auto snapshots = snapshots_;
+        // The final collection is the last snapshot; its rows name their sites with the same ids.
+        Snapshot last{
+            .elapsed   = std::max(snapshots.back().elapsed, collected.value("elapsed", 0.0)),
+            .sizeDiff  = collected.value("sizeDiff", std::int64_t{0}),
+            .countDiff = collected.value("countDiff", std::int64_t{0}),
+        };
+        if (const auto found = collected.find("rows"); found != collected.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                if (!row.is_array() || row.size() < 7 || !row[6].is_number_integer() || !row[1].is_number_integer()) continue;
+                auto& site = sites[row[6].get<std::int64_t>()];
+                if (site.frames.empty()) site.frames = framesOf(row[5]);
+                site.points.push_back({.elapsed = last.elapsed, .sizeDiff = row[1].get<std::int64_t>()});
+                ++last.sites;
+            }
+        }
+        snapshots.push_back(last);
+
+        Json snapshotRows = Json::array();
+        for (const auto& snapshot : snapshots) {
+            snapshotRows.push_back(Json::array({snapshot.elapsed, snapshot.sizeDiff, snapshot.countDiff, snapshot.sites}));
+        }
+        Json siteRows = Json::array();
+        std::vector<double> seconds;
+        std::vector<double> bytes;
+        for (const auto& [id, site] : sites) {
+            if (site.points.empty()) continue;
+            seconds.clear();
+            bytes.clear();
+            std::int64_t peak = site.points.front().sizeDiff;
+            for (const auto& point : site.points) {
+                seconds.push_back(point.elapsed);
+                bytes.push_back(static_cast<double>(point.sizeDiff));
+                peak = std::max(peak, point.sizeDiff);
+            }
+            const auto fit = fitGrowth(seconds, bytes).value_or(GrowthFit{});
+            const auto first = site.points.front().sizeDiff;
+            const auto latest = site.points.back().sizeDiff;
+            Json frames = Json::array();
+            for (const auto& [file, line] : site.frames) frames.push_back(Json::array({file, line}));
+            siteRows.push_back(Json::array({
+                id, site.points.size(), fit.slope, fit.rSquared, first, latest, peak,
+                trendOf(site.points.size(), fit, first, latest), std::move(frames),
+            }));
+        }
+        collected["snapshots"] = std::move(snapshotRows);
+        collected["sites"] = std::move(siteRows);
+        return collected;
+    }
+
+} // namespace mcdk::performance
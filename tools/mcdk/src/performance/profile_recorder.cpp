@@ -0,0 +1,201 @@
+#include <performance/profile_recorder.hpp>
+#include <performance/collector_rows.hpp>
+
+#include <algorithm>
+#include <initializer_list>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace mcdk::performance {
+namespace {
+
+    using Json = nlohmann::json;
+
+} // namespace
+
+    FlightRecorder::FlightRecorder(Clock::duration window, std::size_t maximumBytes)
+    : window_(window), maximumBytes_(maximumBytes) {}
+
+    void FlightRecorder::append(const nlohmann::json& payload, Clock::time_point end) {
+        Segment segment{.end = end};
+        if (payload.is_object()) {
+            segment.elapsed   = std::max(0.0, payload.value("elapsed", 0.0));
+            segment.total     = payload.value("total", std::int64_t{0});
+            segment.truncated = payload.value("truncated", false);
+            segment.clock     = payload.value("clock", std::string("CPU"));
+            if (const auto found = payload.find("targets"); found != payload.end() && found->is_array()) {
+                for (const auto& target : *found) {
+                    if (target.is_string()) segment.targets.push_back(target.get<std::string>());
+                }
+            }
+        }
+        std::unordered_map<std::int64_t, std::uint32_t> indexes;
+        if (const auto found = payload.find("nodes"); payload.is_object() && found != payload.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                if (!row.is_array() || row.size() < 11 || !numbersAt(row, {0, 2, 4, 5, 6, 7, 8})
+                    || !stringsAt(row, {1, 3, 9})) {
+                    continue;
+                }
+                indexes.emplace(row[0].get<std::int64_t>(), static_cast<std::uint32_t>(segment.functions.size()));
+                segment.functions.push_back({
+                    .module      = row[1].get<std::string>(),
+                    .line        = row[2].get<std::int64_t>(),
+                    .name        = row[3].get<std::string>(),
+                    .calls       = row[4].get<std::int64_t>(),
+                    .actualCalls = row[5].get<std::int64_t>(),
+                    .self        = row[6].get<double>(),
+                    .total       = row[7].get<double>(),
+                    .contextId   = row[8].get<std::int64_t>(),
+                    .contextName = row[9].get<std::string>(),
+                    .target      = row[10].is_string() ? row[10].get<std::string>() : std::string{},
+                });
+                const auto& function = segment.functions.back();
+                segment.bytes += sizeof(Function) + function.module.capacity() + function.name.capacity()
+                               + function.contextName.capacity() + function.target.capacity();
+            }
+        }
+        if (const auto found = payload.find("edges"); payload.is_object() && found != payload.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                if (!row.is_array() || row.size() < 5 || !numbersAt(row, {0, 1, 2, 3, 4})) continue;
+                const auto caller = indexes.find(row[0].get<std::int64_t>());
+                const auto callee = indexes.find(row[1].get<std::int64_t>());
+                if (caller == indexes.end() || callee == indexes.end()) continue;
+                segment.calls.push_back({
+                    .caller = caller->second,
+                    .callee = callee->second,
+                    .calls  = row[2].get<std::int64_t>(),
+                    .self   = row[3].get<double>(),
+                    .total  = row[4].get<double>(),
+                });
+            }
+        }
+        segment.bytes += sizeof(Segment) + segment.calls.size() * sizeof(Call);
+        for (const auto& target : segment.targets) segment.bytes += sizeof(std::string) + target.capacity();
+        bytes_ += segment.bytes;
+        segments_.push_back(std::move(segment));
+        evict(end);
+    }
+
+    double FlightRecorder::covered() const noexcept {
+        return std::accumulate(segments_.begin(), segments_.end(), 0.0, [](double sum, const Segment& segment) {
+            return sum + segment.elapsed;
+        });
+    }
+
+    // A segment stays while any of it overlaps the window, so a snapshot covers at least the window once the
+    // recorder has run that long. The newest segment always stays.
+    void FlightRecorder::evict(Clock::time_point now) {
+        const auto oldest = now - window_;
+        const auto drop   = [&] {
+            bytes_ -= segments_.front().bytes;
+            segments_.pop_front();
+        };
+        while (segments_.size() > 1 && segments_.front().end <= oldest) drop();
+        while (segments_.size() > 1 && bytes_ > maximumBytes_) drop();
+    }
+
+    nlohmann::json FlightRecorder::merged() const {
+        // Functions merge on their source identity and context; the first segment to see one supplies its context id.
+        std::vector<Function>                          functions;
+        std::unordered_map<std::string, std::uint32_t> identities;
+        std::map<std::pair<std::uint32_t, std::uint32_t>, Call> calls;
+        std::string key;
+        std::int64_t largestTotal = 0;
+        bool truncated = false;
+        Json targets = Json::array();
+        for (const auto& segment : segments_) {
+            largestTotal = std::max(largestTotal, segment.total);
+            truncated    = truncated || segment.truncated;
+            for (const auto& target : segment.targets) {
+                if (std::find(targets.begin(), targets.end(), target) == targets.end()) targets.push_back(target);
+            }
+            std::vector<std::uint32_t> merged(segment.functions.size());
+            for (std::size_t index = 0; index < segment.functions.size(); ++index) {
+                const auto& function = segment.functions[index];
+                key.clear();
+                key.append(function.module).push_back('\x1f');
+                key.append(std::to_string(function.line)).push_back('\x1f');
+                key.append(function.name).push_back('\x1f');
+                key.append(function.contextName).push_back('\x1f');
+                key.append(function.target);
+                const auto [found, inserted] = identities.try_emplace(key, static_cast<std::uint32_t>(functions.size()));
+                merged[index] = found->second;
+                if (inserted) {
+                    functions.push_back(function);
+                    continue;
+                }
+                auto& target = functions[found->second];
+                target.calls += function.calls;
+                target.actualCalls += function.actualCalls;
+                target.self += function.self;
+                target.total += function.total;
+            }
+            for (const auto& call : segment.calls) {
+                const auto caller = merged[call.caller];
+                const auto callee = merged[call.callee];
+                auto& target = calls.try_emplace({caller, callee}, Call{.caller = caller, .callee = callee}).first->second;
+                target.calls += call.calls;
+                target.self += call.self;
+                target.total += call.total;
+            }
+        }
+
+        // Ranked by total time as the collector ranks, with equal totals in first-seen order.
+        std::vector<std::uint32_t> order(functions.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t left, std::uint32_t right) {
+            return functions[left].total > functions[right].total;
+        });
+        if (order.size() > CollectorMaximumFunctions) {
+            order.resize(CollectorMaximumFunctions);
+            truncated = true;
+        }
+        std::vector<std::int64_t> ids(functions.size(), -1);
+        Json nodes = Json::array();
+        for (std::size_t rank = 0; rank < order.size(); ++rank) {
+            const auto& function = functions[order[rank]];
+            ids[order[rank]] = static_cast<std::int64_t>(rank);
+            nodes.push_back(Json::array({
+                rank, function.module, function.line, function.name, function.calls, function.actualCalls,
+                function.self, function.total, function.contextId, function.contextName,
+                function.target.empty() ? Json(nullptr) : Json(function.target),
+            }));
+        }
+        std::vector<const Call*> kept;
+        for (const auto& [pair, call] : calls) {
+            if (ids[call.caller] >= 0 && ids[call.callee] >= 0) kept.push_back(&call);
+        }
+        std::stable_sort(kept.begin(), kept.end(), [](const Call* left, const Call* right) {
+            return left->total > right->total;
+        });
+        if (kept.size() > CollectorMaximumCalls) {
+            kept.resize(CollectorMaximumCalls);
+            truncated = true;
+        }
+        Json edges = Json::array();
+        for (const auto* call : kept) {
+            edges.push_back(Json::array({ids[call->caller], ids[call->callee], call->calls, call->self, call->total}));
+        }
+        return Json{
+            {"ok", true},
+            {"clock", segments_.empty() ? std::string("CPU") : segments_.back().clock},
+            {"elapsed", covered()},
+            {"total", std::max<std::int64_t>(largestTotal, static_cast<std::int64_t>(functions.size()))},
+            {"truncated", truncated},
+            {"targets", std::move(targets)},
+            {"nodes", std::move(nodes)},
+            {"edges", std::move(edges)},
+            {"recorder", {
+                {"window_seconds", std::chrono::duration<double>(window_).count()},
+                {"covered_seconds", covered()},
+                {"segments", segments_.size()},
+                {"retained_bytes", bytes_},
+            }},
+        };
+    }
+
+} // namespace mcdk::performance
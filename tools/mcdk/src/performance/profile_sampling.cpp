@@ -0,0 +1,170 @@
+#include <performance/profile_sampling.hpp>
+#include <performance/collector_rows.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace mcdk::performance {
+namespace {
+
+    using Json = nlohmann::json;
+
+    struct Function {
+        Json         row; // [module, line, name, context id, context name, side]
+        std::int64_t selfSamples  = 0;
+        std::int64_t totalSamples = 0;
+    };
+
+    struct Call {
+        std::int64_t samples     = 0;
+        std::int64_t selfSamples = 0;
+    };
+
+    struct Frame {
+        std::int64_t parent   = -1; // Index into the trie's frames, or -1 under the root.
+        std::size_t  function = 0;
+    };
+
+    bool functionRow(const Json& row) {
+        return row.is_array() && row.size() >= 6 && row[0].is_string() && row[1].is_number() && row[2].is_string()
+            && row[3].is_number() && row[4].is_string() && (row[5].is_string() || row[5].is_null());
+    }
+
+    std::int64_t count(const Json& value) {
+        return value.is_number() ? std::max<std::int64_t>(0, value.get<std::int64_t>()) : 0;
+    }
+
+} // namespace
+
+    nlohmann::json foldSampledStacks(const nlohmann::json& payload) {
+        const auto sampler  = payload.is_object() ? payload.value("sampler", Json::object()) : Json::object();
+        const auto interval = std::max(0.0, sampler.is_object() ? sampler.value("interval", 0.0) : 0.0);
+        const auto ticks    = sampler.is_object() ? count(sampler.value("ticks", Json(0))) : 0;
+        const auto dropped  = sampler.is_object() ? count(sampler.value("dropped", Json(0))) : 0;
+        const auto elapsed  = payload.is_object() ? std::max(0.0, payload.value("elapsed", 0.0)) : 0.0;
+        // The sampler sleeps between ticks and waits for the interpreter lock, so its real period is measured.
+        const auto period = ticks > 0 && elapsed > 0 ? elapsed / static_cast<double>(ticks) : interval;
+
+        std::vector<Function> functions;
+        std::vector<std::int64_t> functionIndexes; // Payload index to functions index, -1 when malformed.
+        if (const auto found = payload.find("functions"); payload.is_object() && found != payload.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                functionIndexes.push_back(functionRow(row) ? static_cast<std::int64_t>(functions.size()) : -1);
+                if (functionRow(row)) functions.push_back({.row = row});
+            }
+        }
+
+        // Parents precede their children, so a frame whose parent was skipped is skipped with its subtree.
+        std::vector<Frame> frames;
+        std::vector<std::int64_t> frameIndexes;
+        std::map<std::pair<std::size_t, std::size_t>, Call> calls;
+        std::int64_t samples = 0;
+        if (const auto found = payload.find("stacks"); payload.is_object() && found != payload.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                frameIndexes.push_back(-1);
+                if (!row.is_array() || row.size() < 4 || !row[0].is_number_integer() || !row[1].is_number_integer()) continue;
+                const auto parentAt   = row[0].get<std::int64_t>();
+                const auto functionAt = row[1].get<std::int64_t>();
+                if (functionAt < 0 || functionAt >= static_cast<std::int64_t>(functionIndexes.size())
+                    || functionIndexes[functionAt] < 0 || parentAt >= static_cast<std::int64_t>(frameIndexes.size()) - 1) {
+                    continue;
+                }
+                const auto parent = parentAt < 0 ? std::int64_t{-1} : frameIndexes[parentAt];
+                if (parentAt >= 0 && parent < 0) continue;
+                const Frame frame{.parent = parent, .function = static_cast<std::size_t>(functionIndexes[functionAt])};
+                const auto self  = count(row[2]);
+                const auto total = count(row[3]);
+                // Recursion repeats a function, or a caller and callee pair, further up the same samples.
+                bool recursive     = false;
+                bool recursiveCall = false;
+                for (auto ancestor = parent; ancestor >= 0; ancestor = frames[ancestor].parent) {
+                    recursive = recursive || frames[ancestor].function == frame.function;
+                    recursiveCall = recursiveCall
+                                 || (parent >= 0 && frames[ancestor].parent >= 0
+                                     && frames[ancestor].function == frame.function
+                                     && frames[frames[ancestor].parent].function == frames[parent].function);
+                }
+                auto& function = functions[frame.function];
+                function.selfSamples += self;
+                if (!recursive) function.totalSamples += total;
+                if (parent < 0) samples += total;
+                else {
+                    auto& call = calls[{frames[parent].function, frame.function}];
+                    if (!recursiveCall) call.samples += total;
+                    call.selfSamples += self;
+                }
+                frameIndexes.back() = static_cast<std::int64_t>(frames.size());
+                frames.push_back(frame);
+            }
+        }
+
+        std::vector<std::size_t> order;
+        for (std::size_t index = 0; index < functions.size(); ++index) {
+            if (functions[index].totalSamples > 0) order.push_back(index);
+        }
+        const auto seen = order.size();
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t left, std::size_t right) {
+            return functions[left].totalSamples > functions[right].totalSamples;
+        });
+        bool truncated = dropped > 0;
+        if (order.size() > CollectorMaximumFunctions) {
+            order.resize(CollectorMaximumFunctions);
+            truncated = true;
+        }
+        std::vector<std::int64_t> ids(functions.size(), -1);
+        Json nodes = Json::array();
+        for (std::size_t rank = 0; rank < order.size(); ++rank) {
+            const auto& function = functions[order[rank]];
+            const auto& row      = function.row;
+            ids[order[rank]] = static_cast<std::int64_t>(rank);
+            nodes.push_back(Json::array({
+                rank, row[0], row[1], row[2], function.totalSamples, function.totalSamples,
+                static_cast<double>(function.selfSamples) * period, static_cast<double>(function.totalSamples) * period,
+                row[3], row[4], row[5],
+            }));
+        }
+        std::vector<std::pair<std::pair<std::size_t, std::size_t>, Call>> kept;
+        for (const auto& [pair, call] : calls) {
+            if (ids[pair.first] >= 0 && ids[pair.second] >= 0) kept.emplace_back(pair, call);
+        }
+        std::stable_sort(kept.begin(), kept.end(), [](const auto& left, const auto& right) {
+            return left.second.samples > right.second.samples;
+        });
+        if (kept.size() > CollectorMaximumCalls) {
+            kept.resize(CollectorMaximumCalls);
+            truncated = true;
+        }
+        Json edges = Json::array();
+        for (const auto& [pair, call] : kept) {
+            edges.push_back(Json::array({
+                ids[pair.first], ids[pair.second], call.samples, static_cast<double>(call.selfSamples) * period,
+                static_cast<double>(call.samples) * period,
+            }));
+        }
+        return Json{
+            {"ok", true},
+            {"clock", "WALL"},
+            {"elapsed", elapsed},
+            {"total", seen},
+            {"truncated", truncated},
+            {"targets", payload.is_object() && payload.contains("targets") && payload["targets"].is_array()
+                            ? payload["targets"] : Json::array()},
+            {"nodes", std::move(nodes)},
+            {"edges", std::move(edges)},
+            {"sampling", {
+                {"interval_seconds", interval},
+                {"period_seconds", period},
+                {"ticks", ticks},
+                {"samples", samples},
+                {"dropped_samples", dropped},
+            }},
+        };
+    }
+
+} // namespace mcdk::performance
@@ -0,0 +1,1528 @@
+#include <performance/profile_store.hpp>
+#include <performance/collector_rows.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mcdk::performance {
+namespace {
+
+    using Json = nlohmann::json;
+
+    static_assert(std::endian::native == std::endian::little, "profile images are read in place as little-endian");
+
+    ProfilerError imageError(std::string message) {
+        return {.code = "PROFILE_IMAGE_INVALID", .message = std::move(message), .retryable = false};
+    }
+
+    std::string jsonString(const Json& value, std::string_view key, std::size_t maximum = 4096) {
+        if (!value.is_object() || !value.contains(key) || !value[key].is_string()) return {};
+        auto result = value[key].get<std::string>();
+        if (result.size() > maximum) result.resize(maximum);
+        return result;
+    }
+
+    std::int64_t jsonInteger(const Json& value, std::string_view key) {
+        if (!value.is_object() || !value.contains(key) || !value[key].is_number()) return 0;
+        const auto& number = value[key];
+        if (number.is_number_unsigned()) {
+            const auto unsignedValue = number.get<std::uint64_t>();
+            return unsignedValue > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())
+                 ? std::numeric_limits<std::int64_t>::max()
+                 : static_cast<std::int64_t>(unsignedValue);
+        }
+        if (number.is_number_integer()) return std::max<std::int64_t>(0, number.get<std::int64_t>());
+        return number.get<double>() < 0 ? 0 : static_cast<std::int64_t>(number.get<double>());
+    }
+
+    // The builders fill these growable drafts; encodeDraft then lays them out as one image.
+    class StringPool {
+    public:
+        StringId intern(std::string_view value) {
+            if (const auto found = index_.find(value); found != index_.end()) return found->second;
+            const auto id = static_cast<StringId>(views_.size());
+            views_.push_back(owned_.emplace_back(value));
+            index_.emplace(views_.back(), id);
+            return id;
+        }
+
+        [[nodiscard]] std::optional<StringId> find(std::string_view value) const {
+            const auto found = index_.find(value);
+            return found == index_.end() ? std::nullopt : std::optional<StringId>(found->second);
+        }
+
+        [[nodiscard]] const std::vector<std::string_view>& views() const noexcept { return views_; }
+
+    private:
+        std::deque<std::string>                        owned_;
+        std::vector<std::string_view>                  views_;
+        std::unordered_map<std::string_view, StringId> index_;
+    };
+
+    struct DraftColumn {
+        std::string_view          name;
+        std::string_view          unit;
+        ColumnType                type = ColumnType::Integer;
+        std::vector<std::int64_t> cells;
+        std::vector<std::uint8_t> present;
+    };
+
+    struct DraftTable {
+        std::vector<StringId>    ids;
+        std::vector<DraftColumn> columns;
+
+        [[nodiscard]] std::size_t rows() const noexcept { return ids.size(); }
+    };
+
+    struct DraftView {
+        std::string_view           name;
+        std::uint32_t              table = 0;
+        std::vector<std::uint32_t> rows;
+        std::vector<std::uint32_t> columns;
+    };
+
+    struct Draft {
+        StringPool                 strings;
+        std::vector<ProfileFrame>  frames;
+        std::vector<std::uint32_t> stackOffsets{0};
+        std::vector<DraftTable>    tables;
+        std::vector<DraftView>     views;
+    };
+
+    void fillMissing(DraftColumn& column, std::size_t rows) {
+        if (column.cells.size() >= rows) return;
+        if (column.present.empty()) column.present.assign(column.cells.size(), 1);
+        column.present.resize(rows, 0);
+        column.cells.resize(rows, 0);
+    }
+
+    struct ColumnSpec {
+        std::string_view name;
+        ColumnType       type = ColumnType::Integer;
+        std::string_view unit = {};
+    };
+
+    // Appends one table row at a time. A column that a row never sets is recorded as absent for that row, which is
+    // how optional fields (for example a call edge whose callee was not retained) stay distinguishable from zero.
+    class TableBuilder {
+    public:
+        TableBuilder(Draft& draft, std::initializer_list<ColumnSpec> columns) : draft_(draft) {
+            for (const auto& spec : columns) {
+                auto& column = table_.columns.emplace_back();
+                column.name = spec.name;
+                column.unit = spec.unit;
+                column.type = spec.type;
+            }
+        }
+
+        void row(std::string_view id) {
+            table_.ids.push_back(draft_.strings.intern(id));
+            next_ = 0;
+        }
+
+        void integer(std::string_view name, std::int64_t value) { cell(name) = value; }
+        void real(std::string_view name, double value) { cell(name) = std::bit_cast<std::int64_t>(value); }
+        void text(std::string_view name, std::string_view value) { cell(name) = draft_.strings.intern(value); }
+
+        void frame(std::string_view file, std::int64_t line) {
+            draft_.frames.push_back({.file = draft_.strings.intern(file), .reserved = 0, .line = line});
+        }
+
+        // Closes the stack made of the frames appended since the previous stack.
+        void stack(std::string_view name) {
+            draft_.stackOffsets.push_back(static_cast<std::uint32_t>(draft_.frames.size()));
+            cell(name) = static_cast<std::int64_t>(draft_.stackOffsets.size() - 2);
+        }
+
+        [[nodiscard]] std::size_t rows() const noexcept { return table_.rows(); }
+
+        std::uint32_t finish() {
+            for (auto& column : table_.columns) fillMissing(column, table_.rows());
+            draft_.tables.push_back(std::move(table_));
+            return static_cast<std::uint32_t>(draft_.tables.size() - 1);
+        }
+
+    private:
+        std::int64_t& cell(std::string_view name) {
+            auto& columns = table_.columns;
+            // Rows set their fields in declaration order, so the next column is almost always the one asked for.
+            if (next_ >= columns.size() || columns[next_].name != name) {
+                next_ = static_cast<std::size_t>(std::find_if(columns.begin(), columns.end(), [&](const auto& column) {
+                    return column.name == name;
+                }) - columns.begin());
+            }
+            auto& column = columns.at(next_++);
+            fillMissing(column, table_.rows() - 1);
+            column.cells.push_back(0);
+            if (!column.present.empty()) column.present.push_back(1);
+            return column.cells.back();
+        }
+
+        Draft&      draft_;
+        DraftTable  table_;
+        std::size_t next_ = 0;
+    };
+
+    std::vector<std::uint32_t> allRows(const DraftTable& table) {
+        std::vector<std::uint32_t> rows(table.rows());
+        for (std::size_t index = 0; index < rows.size(); ++index) rows[index] = static_cast<std::uint32_t>(index);
+        return rows;
+    }
+
+    void addView(
+        Draft&                                  draft,
+        std::string_view                        name,
+        std::uint32_t                           table,
+        std::vector<std::uint32_t>              rows,
+        std::initializer_list<std::string_view> hidden = {}
+    ) {
+        DraftView view{.name = name, .table = table, .rows = std::move(rows), .columns = {}};
+        const auto& columns = draft.tables[table].columns;
+        for (std::size_t index = 0; index < columns.size(); ++index) {
+            if (std::find(hidden.begin(), hidden.end(), columns[index].name) == hidden.end()) {
+                view.columns.push_back(static_cast<std::uint32_t>(index));
+            }
+        }
+        draft.views.push_back(std::move(view));
+    }
+
+    void buildPythonCpu(Draft& draft, const Json& data) {
+        const auto validNode = [](const Json& row) {
+            return row.is_array() && row.size() >= 11 && numbersAt(row, {0, 2, 4, 5, 6, 7, 8})
+                && stringsAt(row, {1, 3, 9});
+        };
+        const auto target = [](const Json& row) { return row[10].is_string() ? row[10].get<std::string>() : "unknown"; };
+
+        TableBuilder hotspots(draft, {
+            {"module", ColumnType::Text},
+            {"line"},
+            {"name", ColumnType::Text},
+            {"calls"},
+            {"actual_calls"},
+            {"self_time", ColumnType::Real, "seconds"},
+            {"total_time", ColumnType::Real, "seconds"},
+            {"context_id"},
+            {"context_name", ColumnType::Text},
+            {"target", ColumnType::Text},
+        });
+        std::unordered_map<std::int64_t, const Json*> nodes;
+        if (const auto found = data.find("nodes"); found != data.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                if (!validNode(row)) continue;
+                const auto id = row[0].get<std::int64_t>();
+                nodes.emplace(id, &row);
+                hotspots.row("fn:" + std::to_string(id));
+                hotspots.text("module", row[1].get<std::string>());
+                hotspots.integer("line", row[2].get<std::int64_t>());
+                hotspots.text("name", row[3].get<std::string>());
+                hotspots.integer("calls", row[4].get<std::int64_t>());
+                hotspots.integer("actual_calls", row[5].get<std::int64_t>());
+                hotspots.real("self_time", row[6].get<double>());
+                hotspots.real("total_time", row[7].get<double>());
+                hotspots.integer("context_id", row[8].get<std::int64_t>());
+                hotspots.text("context_name", row[9].get<std::string>());
+                hotspots.text("target", target(row));
+            }
+        }
+        const auto hotspotTable = hotspots.finish();
+        addView(draft, "hotspots", hotspotTable, allRows(draft.tables[hotspotTable]));
+
+        TableBuilder calls(draft, {
+            {"caller_id", ColumnType::Text},
+            {"callee_id", ColumnType::Text},
+            {"caller_name", ColumnType::Text},
+            {"caller_module", ColumnType::Text},
+            {"caller_target", ColumnType::Text},
+            {"callee_name", ColumnType::Text},
+            {"callee_module", ColumnType::Text},
+            {"callee_target", ColumnType::Text},
+            {"calls"},
+            {"self_time", ColumnType::Real, "seconds"},
+            {"total_time", ColumnType::Real, "seconds"},
+        });
+        if (const auto found = data.find("edges"); found != data.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                if (!row.is_array() || row.size() < 5 || !numbersAt(row, {0, 1, 2, 3, 4})) continue;
+                const auto callerId = row[0].get<std::int64_t>();
+                const auto calleeId = row[1].get<std::int64_t>();
+                calls.row("edge:" + std::to_string(calls.rows()));
+                calls.text("caller_id", "fn:" + std::to_string(callerId));
+                calls.text("callee_id", "fn:" + std::to_string(calleeId));
+                if (const auto caller = nodes.find(callerId); caller != nodes.end()) {
+                    calls.text("caller_name", (*caller->second)[3].get<std::string>());
+                    calls.text("caller_module", (*caller->second)[1].get<std::string>());
+                    calls.text("caller_target", target(*caller->second));
+                }
+                if (const auto callee = nodes.find(calleeId); callee != nodes.end()) {
+                    calls.text("callee_name", (*callee->second)[3].get<std::string>());
+                    calls.text("callee_module", (*callee->second)[1].get<std::string>());
+                    calls.text("callee_target", target(*callee->second));
+                }
+                calls.integer("calls", row[2].get<std::int64_t>());
+                calls.real("self_time", row[3].get<double>());
+                calls.real("total_time", row[4].get<double>());
+            }
+        }
+        const auto callTable = calls.finish();
+        addView(draft, "calls", callTable, allRows(draft.tables[callTable]));
+    }
+
+    // One call site of the allocation tree: the same file and line reached through the same outer frames.
+    struct AllocationNode {
+        std::string_view                                                 file;
+        std::int64_t                                                     line = 0;
+        std::map<std::pair<std::string_view, std::int64_t>, std::size_t> children;
+        std::int64_t                                                     inclusiveSize     = 0;
+        std::int64_t                                                     exclusiveSize     = 0;
+        std::int64_t                                                     inclusiveCount    = 0;
+        std::int64_t                                                     exclusiveCount    = 0;
+        std::int64_t                                                     inclusiveSizeDiff = 0;
+        std::int64_t                                                     exclusiveSizeDiff = 0;
+    };
+
+    // Tracebacks are innermost frame first, so a path enters the tree at its outermost frame. A node's inclusive
+    // values sum every allocation whose traceback passes through it and its exclusive values those it made itself.
+    void buildAllocationTree(Draft& draft, const Json& data) {
+        static const Json empty = Json::array();
+        const auto found = data.find("rows");
+        const auto& rows = found != data.end() && found->is_array() ? *found : empty;
+        std::vector<AllocationNode> nodes;
+        std::map<std::pair<std::string_view, std::int64_t>, std::size_t> roots;
+        std::vector<std::pair<std::string_view, std::int64_t>> path;
+        for (const auto& row : rows) {
+            if (!row.is_array() || row.size() < 6 || !numbersAt(row, {1, 2, 3, 4})) continue;
+            const auto sizeDiff     = row[1].get<std::int64_t>();
+            const auto currentSize  = row[3].get<std::int64_t>();
+            const auto currentCount = row[4].get<std::int64_t>();
+            if (sizeDiff == 0 && currentSize == 0) continue;
+            path.clear();
+            if (row[5].is_array()) {
+                for (auto frame = row[5].rbegin(); frame != row[5].rend(); ++frame) {
+                    if (!frame->is_array() || frame->size() < 2 || !(*frame)[0].is_string() || !(*frame)[1].is_number_integer()) continue;
+                    const auto& file = (*frame)[0].get_ref<const std::string&>();
+                    path.emplace_back(std::string_view(file).substr(0, 4096), (*frame)[1].get<std::int64_t>());
+                }
+            }
+            if (path.empty()) path.emplace_back("<unknown>", 0);
+            auto* siblings = &roots;
+            std::size_t node = 0;
+            for (const auto& key : path) {
+                const auto [found, inserted] = siblings->try_emplace(key, nodes.size());
+                if (inserted) nodes.push_back({.file = key.first, .line = key.second});
+                node = found->second;
+                auto& entry = nodes[node];
+                entry.inclusiveSize += currentSize;
+                entry.inclusiveCount += currentCount;
+                entry.inclusiveSizeDiff += sizeDiff;
+                siblings = &entry.children;
+            }
+            nodes[node].exclusiveSize += currentSize;
+            nodes[node].exclusiveCount += currentCount;
+            nodes[node].exclusiveSizeDiff += sizeDiff;
+        }
+
+        TableBuilder tree(draft, {
+            {"parent_id", ColumnType::Text},
+            {"depth"},
+            {"source_file", ColumnType::Text},
+            {"source_line"},
+            {"inclusive_size", ColumnType::Integer, "bytes"},
+            {"exclusive_size", ColumnType::Integer, "bytes"},
+            {"inclusive_count"},
+            {"exclusive_count"},
+            {"inclusive_size_diff", ColumnType::Integer, "bytes"},
+            {"exclusive_size_diff", ColumnType::Integer, "bytes"},
+        });
+        // Flattened in pre-order with the largest retained subtree first, as the native call tree is.
+        const auto ordered = [&](const auto& children) {
+            std::vector<std::size_t> result;
+            for (const auto& [key, index] : children) result.push_back(index);
+            std::stable_sort(result.begin(), result.end(), [&](std::size_t left, std::size_t right) {
+                return nodes[left].inclusiveSize > nodes[right].inclusiveSize;
+            });
+            return result;
+        };
+        std::size_t next = 0;
+        const auto flatten = [&](const auto& self, std::size_t index, const std::string& parent, std::int64_t depth) -> void {
+            const auto& node = nodes[index];
+            const auto id = "node:" + std::to_string(next++);
+            tree.row(id);
+            tree.text("parent_id", parent);
+            tree.integer("depth", depth);
+            tree.text("source_file", node.file);
+            tree.integer("source_line", node.line);
+            tree.integer("inclusive_size", node.inclusiveSize);
+            tree.integer("exclusive_size", node.exclusiveSize);
+            tree.integer("inclusive_count", node.inclusiveCount);
+            tree.integer("exclusive_count", node.exclusiveCount);
+            tree.integer("inclusive_size_diff", node.inclusiveSizeDiff);
+            tree.integer("exclusive_size_diff", node.exclusiveSizeDiff);
+            for (const auto child : ordered(node.children)) self(self, child, id, depth + 1);
+        };
+        for (const auto root : ordered(roots)) flatten(flatten, root, "", 0);
+        const auto treeIndex  = tree.finish();
+        const auto& flattened = draft.tables[treeIndex];
+        const auto  rootParent = draft.strings.find("");
+        std::vector<std::uint32_t> rootRows;
+        for (std::uint32_t row = 0; row < flattened.rows(); ++row) {
+            if (rootParent && flattened.columns.front().cells[row] == *rootParent) rootRows.push_back(row);
+        }
+        addView(draft, "calltree-roots", treeIndex, std::move(rootRows));
+        addView(draft, "calltree-children", treeIndex, allRows(flattened));
+    }
+
+    // The periodic snapshots a memory job took, and each allocation site's bytes fitted over them.
+    void buildMemoryGrowth(Draft& draft, const Json& data) {
+        const auto rowsOf = [&](std::string_view key) -> const Json& {
+            static const Json empty = Json::array();
+            const auto found = data.find(key);
+            return found != data.end() && found->is_array() ? *found : empty;
+        };
+
+        TableBuilder snapshots(draft, {
+            {"elapsed", ColumnType::Real, "seconds"},
+            {"size_diff", ColumnType::Integer, "bytes"},
+            {"count_diff"},
+            {"sites"},
+        });
+        for (const auto& row : rowsOf("snapshots")) {
+            if (!row.is_array() || row.size() < 4 || !numbersAt(row, {0, 1, 2, 3})) continue;
+            snapshots.row("snapshot:" + std::to_string(snapshots.rows()));
+            snapshots.real("elapsed", row[0].get<double>());
+            snapshots.integer("size_diff", row[1].get<std::int64_t>());
+            snapshots.integer("count_diff", row[2].get<std::int64_t>());
+            snapshots.integer("sites", row[3].get<std::int64_t>());
+        }
+        const auto snapshotTable = snapshots.finish();
+        addView(draft, "snapshots", snapshotTable, allRows(draft.tables[snapshotTable]));
+
+        TableBuilder sites(draft, {
+            {"slope", ColumnType::Real, "bytes/second"},
+            {"r_squared", ColumnType::Real},
+            {"pattern", ColumnType::Text},
+            {"points"},
+            {"first_size_diff", ColumnType::Integer, "bytes"},
+            {"last_size_diff", ColumnType::Integer, "bytes"},
+            {"peak_size_diff", ColumnType::Integer, "bytes"},
+            {"traceback", ColumnType::Stack},
+        });
+        for (const auto& row : rowsOf("sites")) {
+            if (!row.is_array() || row.size() < 9 || !numbersAt(row, {0, 1, 2, 3, 4, 5, 6}) || !stringsAt(row, {7})) continue;
+            sites.row("site:" + std::to_string(row[0].get<std::int64_t>()));
+            sites.real("slope", row[2].get<double>());
+            sites.real("r_squared", row[3].get<double>());
+            sites.text("pattern", row[7].get<std::string>().substr(0, 32));
+            sites.integer("points", row[1].get<std::int64_t>());
+            sites.integer("first_size_diff", row[4].get<std::int64_t>());
+            sites.integer("last_size_diff", row[5].get<std::int64_t>());
+            sites.integer("peak_size_diff", row[6].get<std::int64_t>());
+            if (row[8].is_array()) {
+                for (const auto& frame : row[8]) {
+                    if (!frame.is_array() || frame.size() < 2 || !frame[0].is_string() || !frame[1].is_number_integer()) continue;
+                    sites.frame(std::string_view(frame[0].get_ref<const std::string&>()).substr(0, 4096), frame[1].get<std::int64_t>());
+                }
+            }
+            sites.stack("traceback");
+        }
+        const auto siteTable = sites.finish();
+        addView(draft, "growth-rate", siteTable, allRows(draft.tables[siteTable]));
+    }
+
+    void buildPythonMemory(Draft& draft, const Json& data) {
+        TableBuilder allocations(draft, {
+            {"size_diff", ColumnType::Integer, "bytes"},
+            {"count_diff"},
+            {"direction", ColumnType::Text},
+            {"current_size", ColumnType::Integer, "bytes"},
+            {"current_count"},
+            {"traceback", ColumnType::Stack},
+        });
+        std::vector<std::uint32_t> growth;
+        std::vector<std::uint32_t> retained;
+        if (const auto found = data.find("rows"); found != data.end() && found->is_array()) {
+            for (const auto& row : *found) {
+                if (!row.is_array() || row.size() < 6 || !numbersAt(row, {0, 1, 2, 3, 4})) continue;
+                const auto sizeDiff    = row[1].get<std::int64_t>();
+                const auto currentSize = row[3].get<std::int64_t>();
+                const auto index       = static_cast<std::uint32_t>(allocations.rows());
+                if (sizeDiff != 0) growth.push_back(index);
+                if (currentSize > 0) retained.push_back(index);
+                allocations.row("allocation:" + std::to_string(row[0].get<std::int64_t>()));
+                allocations.integer("size_diff", sizeDiff);
+                allocations.integer("count_diff", row[2].get<std::int64_t>());
+                allocations.text("direction", sizeDiff > 0 ? "growth" : "release");
+                allocations.integer("current_size", currentSize);
+                allocations.integer("current_count", row[4].get<std::int64_t>());
+                if (row[5].is_array()) {
+                    for (const auto& frame : row[5]) {
+                        if (!frame.is_array() || frame.size() < 2 || !frame[0].is_string() || !frame[1].is_number_integer()) continue;
+                        const auto& file = frame[0].get_ref<const std::string&>();
+                        allocations.frame(std::string_view(file).substr(0, 4096), frame[1].get<std::int64_t>());
+                    }
+                }
+                allocations.stack("traceback");
+            }
+        }
+        // Both views share one table; retained hides the growth-only fields.
+        const auto table = allocations.finish();
+        addView(draft, "growth", table, std::move(growth));
+        addView(draft, "retained", table, std::move(retained), {"size_diff", "count_diff", "direction"});
+        buildAllocationTree(draft, data);
+        buildMemoryGrowth(draft, data);
+    }
+
+    void buildFrameTime(Draft& draft, const Json& data) {
+        const auto rowsOf = [&](std::string_view key) -> const Json& {
+            static const Json empty = Json::array();
+            const auto found = data.find(key);
+            return found != data.end() && found->is_array() ? *found : empty;
+        };
+
+        TableBuilder percentiles(draft, {
+            {"side", ColumnType::Text},
+            {"frames"},
+            {"lost"},
+            {"mean", ColumnType::Real, "milliseconds"},
+            {"minimum", ColumnType::Real, "milliseconds"},
+            {"p50", ColumnType::Real, "milliseconds"},
+            {"p90", ColumnType::Real, "milliseconds"},
+            {"p99", ColumnType::Real, "milliseconds"},
+            {"maximum", ColumnType::Real, "milliseconds"},
+        });
+        for (const auto& side : rowsOf("sides")) {
+            const auto name = jsonString(side, "side", 16);
+            if (name.empty()) continue;
+            percentiles.row("side:" + name);
+            percentiles.text("side", name);
+            percentiles.integer("frames", jsonInteger(side, "frames"));
+            percentiles.integer("lost", jsonInteger(side, "lost"));
+            for (const auto field : {"mean", "minimum", "p50", "p90", "p99", "maximum"}) {
+                percentiles.real(field, side.value(field, 0.0));
+            }
+        }
+        const auto percentileTable = percentiles.finish();
+        addView(draft, "percentiles", percentileTable, allRows(draft.tables[percentileTable]));
+
+        TableBuilder histogram(draft, {
+            {"side", ColumnType::Text},
+            {"lowest", ColumnType::Real, "milliseconds"},
+            {"highest", ColumnType::Real, "milliseconds"},
+            {"count"},
+            {"cumulative_percent", ColumnType::Real},
+        });
+        for (const auto& row : rowsOf("histogram")) {
+            if (!row.is_array() || row.size() < 5 || !stringsAt(row, {0}) || !numbersAt(row, {1, 2, 3, 4})) continue;
+            histogram.row("bucket:" + std::to_string(histogram.rows()));
+            histogram.text("side", row[0].get<std::string>());
+            histogram.real("lowest", row[1].get<double>());
+            histogram.real("highest", row[2].get<double>());
+            histogram.integer("count", row[3].get<std::int64_t>());
+            histogram.real("cumulative_percent", row[4].get<double>());
+        }
+        const auto histogramTable = histogram.finish();
+        addView(draft, "histogram", histogramTable, allRows(draft.tables[histogramTable]));
+
+        TableBuilder series(draft, {
+            {"side", ColumnType::Text},
+            {"second", ColumnType::Integer, "seconds"},
+            {"frames"},
+            {"mean", ColumnType::Real, "milliseconds"},
+            {"maximum", ColumnType::Real, "milliseconds"},
+        });
+        for (const auto& row : rowsOf("series")) {
+            if (!row.is_array() || row.size() < 5 || !stringsAt(row, {0}) || !numbersAt(row, {1, 2, 3, 4})) continue;
+            series.row("second:" + row[0].get<std::string>() + ':' + std::to_string(row[1].get<std::int64_t>()));
+            series.text("side", row[0].get<std::string>());
+            series.integer("second", row[1].get<std::int64_t>());
+            series.integer("frames", row[2].get<std::int64_t>());
+            series.real("mean", row[3].get<double>());
+            series.real("maximum", row[4].get<double>());
+        }
+        const auto seriesTable = series.finish();
+        addView(draft, "timeseries", seriesTable, allRows(draft.tables[seriesTable]));
+
+        // A frame no CPU job overlapped leaves both job fields absent.
+        TableBuilder worst(draft, {
+            {"side", ColumnType::Text},
+            {"end", ColumnType::Real, "seconds"},
+            {"duration", ColumnType::Real, "milliseconds"},
+            {"cpu_job_id", ColumnType::Text},
+            {"cpu_job_kind", ColumnType::Text},
+        });
+        for (const auto& row : rowsOf("worst")) {
+            if (!row.is_array() || row.size() < 5 || !stringsAt(row, {0}) || !numbersAt(row, {1, 2})) continue;
+            worst.row("frame:" + std::to_string(worst.rows()));
+            worst.text("side", row[0].get<std::string>());
+            worst.real("end", row[1].get<double>());
+            worst.real("duration", row[2].get<double>());
+            if (row[3].is_string() && row[4].is_string()) {
+                worst.text("cpu_job_id", row[3].get<std::string>());
+                worst.text("cpu_job_kind", row[4].get<std::string>());
+            }
+        }
+        const auto worstTable = worst.finish();
+        addView(draft, "worst-frames", worstTable, allRows(draft.tables[worstTable]));
+    }
+
+    void flattenNodes(
+        TableBuilder&      calltree,
+        const Json&        nodes,
+        const std::string& threadId,
+        const std::string& parent,
+        std::int64_t       depth
+    ) {
+        if (!nodes.is_array()) return;
+        for (const auto& node : nodes) {
+            const auto id = "node:" + std::to_string(jsonInteger(node, "id"));
+            calltree.row(id);
+            calltree.text("parent_id", parent);
+            calltree.text("thread_id", threadId);
+            calltree.integer("depth", depth);
+            calltree.text("name", jsonString(node, "name", 1024));
+            calltree.text("source_file", jsonString(node, "sourceFile"));
+            calltree.integer("source_line", jsonInteger(node, "sourceLine"));
+            calltree.integer("calls", jsonInteger(node, "calls"));
+            calltree.integer("total_time", jsonInteger(node, "totalNanoseconds"));
+            calltree.integer("self_time", jsonInteger(node, "selfNanoseconds"));
+            calltree.integer("mean_time", jsonInteger(node, "meanNanoseconds"));
+            calltree.integer("maximum_time", jsonInteger(node, "maximumNanoseconds"));
+            if (const auto children = node.is_object() ? node.find("children") : node.end(); children != node.end()) {
+                flattenNodes(calltree, *children, threadId, id, depth + 1);
+            }
+        }
+    }
+
+    void buildNative(Draft& draft, const Json& data) {
+        const auto zones   = data.find("zones");
+        const auto threads = data.find("threads");
+        const auto empty   = Json::array();
+        const auto& zoneRows   = zones != data.end() && zones->is_array() ? *zones : empty;
+        const auto& threadRows = threads != data.end() && threads->is_array() ? *threads : empty;
+
+        TableBuilder hotspots(draft, {
+            {"name", ColumnType::Text},
+            {"source_file", ColumnType::Text},
+            {"source_line"},
+            {"thread_id", ColumnType::Text},
+            {"thread_name", ColumnType::Text},
+            {"calls"},
+            {"total_time", ColumnType::Integer, "nanoseconds"},
+            {"self_time", ColumnType::Integer, "nanoseconds"},
+            {"mean_time", ColumnType::Integer, "nanoseconds"},
+            {"maximum_time", ColumnType::Integer, "nanoseconds"},
+        });
+        TableBuilder slowest(draft, {
+            {"zone_id", ColumnType::Text},
+            {"name", ColumnType::Text},
+            {"source_file", ColumnType::Text},
+            {"source_line"},
+            {"thread_id", ColumnType::Text},
+            {"thread_name", ColumnType::Text},
+            {"start_time", ColumnType::Integer, "nanoseconds"},
+            {"duration", ColumnType::Integer, "nanoseconds"},
+        });
+        struct Aggregate {
+            std::string           name;
+            std::string           file;
+            std::int64_t          line    = 0;
+            std::int64_t          calls   = 0;
+            std::int64_t          total   = 0;
+            std::int64_t          self    = 0;
+            std::int64_t          maximum = 0;
+            std::set<std::string> threads;
+        };
+        std::map<std::string, Aggregate> aggregates;
+        for (const auto& zone : zoneRows) {
+            if (!zone.is_object()) continue;
+            const auto zoneId     = std::to_string(jsonInteger(zone, "id"));
+            const auto name       = jsonString(zone, "name", 1024);
+            const auto file       = jsonString(zone, "sourceFile");
+            const auto line       = jsonInteger(zone, "sourceLine");
+            const auto threadId   = jsonString(zone, "threadId", 128);
+            const auto threadName = jsonString(zone, "threadName", 512);
+            hotspots.row("zone:" + zoneId);
+            hotspots.text("name", name);
+            hotspots.text("source_file", file);
+            hotspots.integer("source_line", line);
+            hotspots.text("thread_id", threadId);
+            hotspots.text("thread_name", threadName);
+            hotspots.integer("calls", jsonInteger(zone, "calls"));
+            hotspots.integer("total_time", jsonInteger(zone, "totalNanoseconds"));
+            hotspots.integer("self_time", jsonInteger(zone, "selfNanoseconds"));
+            hotspots.integer("mean_time", jsonInteger(zone, "meanNanoseconds"));
+            hotspots.integer("maximum_time", jsonInteger(zone, "maximumNanoseconds"));
+
+            auto& aggregate = aggregates[name + '\0' + file + '\0' + std::to_string(line)];
+            aggregate.name  = name;
+            aggregate.file  = file;
+            aggregate.line  = line;
+            aggregate.calls += jsonInteger(zone, "calls");
+            aggregate.total += jsonInteger(zone, "totalNanoseconds");
+            aggregate.self += jsonInteger(zone, "selfNanoseconds");
+            aggregate.maximum = std::max(aggregate.maximum, jsonInteger(zone, "maximumNanoseconds"));
+            aggregate.threads.insert(threadName.empty() ? threadId : threadName);
+
+            const auto samples = zone.find("slowestCalls");
+            if (samples == zone.end() || !samples->is_array()) continue;
+            std::size_t sampleIndex = 0;
+            for (const auto& sample : *samples) {
+                if (!sample.is_object()) continue;
+                slowest.row("sample:" + zoneId + ':' + std::to_string(sampleIndex++));
+                slowest.text("zone_id", "zone:" + zoneId);
+                slowest.text("name", name);
+                slowest.text("source_file", file);
+                slowest.integer("source_line", line);
+                slowest.text("thread_id", threadId);
+                slowest.text("thread_name", threadName);
+                slowest.integer("start_time", jsonInteger(sample, "startNanoseconds"));
+                slowest.integer("duration", jsonInteger(sample, "durationNanoseconds"));
+            }
+        }
+        const auto hotspotTable = hotspots.finish();
+        addView(draft, "hotspots", hotspotTable, allRows(draft.tables[hotspotTable]));
+        const auto slowestTable = slowest.finish();
+        addView(draft, "slowest-calls", slowestTable, allRows(draft.tables[slowestTable]));
+
+        TableBuilder sources(draft, {
+            {"name", ColumnType::Text},
+            {"source_file", ColumnType::Text},
+            {"source_line"},
+            {"thread_count"},
+            {"calls"},
+            {"total_time", ColumnType::Integer, "nanoseconds"},
+            {"self_time", ColumnType::Integer, "nanoseconds"},
+            {"mean_time", ColumnType::Integer, "nanoseconds"},
+            {"maximum_time", ColumnType::Integer, "nanoseconds"},
+        });
+        for (const auto& [key, aggregate] : aggregates) {
+            (void)key;
+            sources.row("source:" + std::to_string(sources.rows()));
+            sources.text("name", aggregate.name);
+            sources.text("source_file", aggregate.file);
+            sources.integer("source_line", aggregate.line);
+            sources.integer("thread_count", static_cast<std::int64_t>(aggregate.threads.size()));
+            sources.integer("calls", aggregate.calls);
+            sources.integer("total_time", aggregate.total);
+            sources.integer("self_time", aggregate.self);
+            sources.integer("mean_time", aggregate.calls == 0 ? 0 : aggregate.total / aggregate.calls);
+            sources.integer("maximum_time", aggregate.maximum);
+        }
+        const auto sourceTable = sources.finish();
+        addView(draft, "source-locations", sourceTable, allRows(draft.tables[sourceTable]));
+
+        TableBuilder threadTable(draft, {
+            {"name", ColumnType::Text},
+            {"calls"},
+            {"total_time", ColumnType::Integer, "nanoseconds"},
+        });
+        TableBuilder calltree(draft, {
+            {"parent_id", ColumnType::Text},
+            {"thread_id", ColumnType::Text},
+            {"depth"},
+            {"name", ColumnType::Text},
+            {"source_file", ColumnType::Text},
+            {"source_line"},
+            {"calls"},
+            {"total_time", ColumnType::Integer, "nanoseconds"},
+            {"self_time", ColumnType::Integer, "nanoseconds"},
+            {"mean_time", ColumnType::Integer, "nanoseconds"},
+            {"maximum_time", ColumnType::Integer, "nanoseconds"},
+        });
+        for (const auto& thread : threadRows) {
+            const auto threadId = jsonString(thread, "id", 128);
+            threadTable.row("thread:" + threadId);
+            threadTable.text("name", jsonString(thread, "name", 512));
+            threadTable.integer("calls", jsonInteger(thread, "calls"));
+            threadTable.integer("total_time", jsonInteger(thread, "totalNanoseconds"));
+            if (const auto roots = thread.is_object() ? thread.find("roots") : thread.end(); roots != thread.end()) {
+                flattenNodes(calltree, *roots, threadId, "", 0);
+            }
+        }
+        const auto threadIndex = threadTable.finish();
+        addView(draft, "threads", threadIndex, allRows(draft.tables[threadIndex]));
+        const auto calltreeIndex = calltree.finish();
+        const auto& nodes        = draft.tables[calltreeIndex];
+        const auto  rootParent   = draft.strings.find("");
+        std::vector<std::uint32_t> roots;
+        for (std::uint32_t row = 0; row < nodes.rows(); ++row) {
+            if (rootParent && nodes.columns.front().cells[row] == *rootParent) roots.push_back(row);
+        }
+        addView(draft, "calltree-roots", calltreeIndex, std::move(roots));
+        addView(draft, "calltree-children", calltreeIndex, allRows(nodes));
+    }
+
+    enum class SectionType : std::uint32_t {
+        Strings = 1,
+        Frames  = 2,
+        Stacks  = 3,
+        Table   = 4,
+        View    = 5,
+    };
+
+    constexpr char ImageMagic[8] = {'M', 'C', 'D', 'K', 'P', 'R', 'O', 'F'};
+
+    struct ImageHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t kind;
+        std::uint32_t sections;
+        std::uint32_t reserved;
+        std::uint64_t size;
+    };
+    static_assert(sizeof(ImageHeader) == 32);
+
+    struct SectionEntry {
+        std::uint32_t type;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+    static_assert(sizeof(SectionEntry) == 24);
+
+    struct ColumnDescriptor {
+        StringId      name;
+        StringId      unit;
+        std::uint8_t  type;
+        std::uint8_t  presence;
+        std::uint16_t reserved;
+        std::uint32_t padding;
+    };
+    static_assert(sizeof(ColumnDescriptor) == 16);
+
+    // Appends 8-byte aligned blocks after a header and section index whose size is known up front.
+    class ImageWriter {
+    public:
+        explicit ImageWriter(std::size_t sections)
+            : bytes_(sizeof(ImageHeader) + sections * sizeof(SectionEntry)) {
+            sections_.reserve(sections);
+        }
+
+        void begin(SectionType type) {
+            align();
+            sections_.push_back({.type = static_cast<std::uint32_t>(type), .reserved = 0, .offset = bytes_.size(), .size = 0});
+        }
+
+        void end() {
+            align();
+            sections_.back().size = bytes_.size() - sections_.back().offset;
+        }
+
+        template <class T>
+        void block(std::span<const T> values) {
+            align();
+            append(values.data(), values.size_bytes());
+        }
+
+        void text(std::string_view value) { append(value.data(), value.size()); }
+        void align() { bytes_.resize((bytes_.size() + 7) / 8 * 8); }
+
+        std::vector<std::byte> finish(ProfilerKind kind) {
+            ImageHeader header{};
+            std::memcpy(header.magic, ImageMagic, sizeof(ImageMagic));
+            header.version  = ProfileFormatVersion;
+            header.kind     = static_cast<std::uint32_t>(kind);
+            header.sections = static_cast<std::uint32_t>(sections_.size());
+            header.size     = bytes_.size();
+            std::memcpy(bytes_.data(), &header, sizeof(header));
+            std::memcpy(bytes_.data() + sizeof(header), sections_.data(), sections_.size() * sizeof(SectionEntry));
+            return std::move(bytes_);
+        }
+
+    private:
+        void append(const void* data, std::size_t size) {
+            const auto* begin = static_cast<const std::byte*>(data);
+            bytes_.insert(bytes_.end(), begin, begin + size);
+        }
+
+        std::vector<std::byte>    bytes_;
+        std::vector<SectionEntry> sections_;
+    };
+
+    template <class T>
+    std::span<const T> asSpan(const std::vector<T>& values) {
+        return {values.data(), values.size()};
+    }
+
+    std::vector<std::byte> encodeDraft(ProfilerKind kind, Draft& draft) {
+        // Names are interned before the string section is written, so every descriptor can refer to it.
+        for (const auto& table : draft.tables) {
+            for (const auto& column : table.columns) {
+                draft.strings.intern(column.name);
+                draft.strings.intern(column.unit);
+            }
+        }
+        for (const auto& view : draft.views) draft.strings.intern(view.name);
+
+        const auto&                strings = draft.strings.views();
+        std::vector<std::uint32_t> offsets{0};
+        offsets.reserve(strings.size() + 1);
+        std::uint64_t total = 0;
+        for (const auto value : strings) {
+            total += value.size();
+            if (total > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error("The capture's strings exceed the 4 GiB limit of the profile format.");
+            }
+            offsets.push_back(static_cast<std::uint32_t>(total));
+        }
+
+        ImageWriter writer(3 + draft.tables.size() + draft.views.size());
+        const auto  counted = [&](std::size_t count) {
+            const std::uint32_t head[2] = {static_cast<std::uint32_t>(count), 0};
+            writer.block(std::span<const std::uint32_t>(head));
+        };
+        writer.begin(SectionType::Strings);
+        counted(strings.size());
+        writer.block(asSpan(offsets));
+        writer.align();
+        for (const auto value : strings) writer.text(value);
+        writer.end();
+
+        writer.begin(SectionType::Frames);
+        counted(draft.frames.size());
+        writer.block(asSpan(draft.frames));
+        writer.end();
+
+        writer.begin(SectionType::Stacks);
+        counted(draft.stackOffsets.size() - 1);
+        writer.block(asSpan(draft.stackOffsets));
+        writer.end();
+
+        for (const auto& table : draft.tables) {
+            std::vector<ColumnDescriptor> descriptors;
+            for (const auto& column : table.columns) {
+                descriptors.push_back({
+                    .name     = *draft.strings.find(column.name),
+                    .unit     = *draft.strings.find(column.unit),
+                    .type     = static_cast<std::uint8_t>(column.type),
+                    .presence = static_cast<std::uint8_t>(column.present.empty() ? 0 : 1),
+                    .reserved = 0,
+                    .padding  = 0,
+                });
+            }
+            const std::uint32_t head[2] = {
+                static_cast<std::uint32_t>(table.rows()),
+                static_cast<std::uint32_t>(table.columns.size()),
+            };
+            writer.begin(SectionType::Table);
+            writer.block(std::span<const std::uint32_t>(head));
+            writer.block(asSpan(descriptors));
+            writer.block(asSpan(table.ids));
+            for (const auto& column : table.columns) {
+                writer.block(asSpan(column.cells));
+                if (!column.present.empty()) writer.block(asSpan(column.present));
+            }
+            writer.end();
+        }
+
+        for (const auto& view : draft.views) {
+            const std::uint32_t head[4] = {
+                *draft.strings.find(view.name),
+                view.table,
+                static_cast<std::uint32_t>(view.rows.size()),
+                static_cast<std::uint32_t>(view.columns.size()),
+            };
+            writer.begin(SectionType::View);
+            writer.block(std::span<const std::uint32_t>(head));
+            writer.block(asSpan(view.rows));
+            writer.block(asSpan(view.columns));
+            writer.end();
+        }
+        return writer.finish(kind);
+    }
+
+    // Hands out bounds-checked, 8-byte aligned arrays of one section, in order, without copying them.
+    class BlockReader {
+    public:
+        explicit BlockReader(std::span<const std::byte> bytes) : bytes_(bytes) {}
+
+        template <class T>
+        std::optional<std::span<const T>> take(std::size_t count) {
+            offset_ = (offset_ + 7) / 8 * 8;
+            if (offset_ > bytes_.size() || count > (bytes_.size() - offset_) / sizeof(T)) return std::nullopt;
+            const auto* begin = reinterpret_cast<const T*>(bytes_.data() + offset_);
+            offset_ += count * sizeof(T);
+            return std::span<const T>(begin, count);
+        }
+
+    private:
+        std::span<const std::byte> bytes_;
+        std::size_t                offset_ = 0;
+    };
+
+    std::expected<void, ProfilerError> openTable(ProfileStore& store, std::span<const std::byte> section) {
+        const auto invalid = std::unexpected(imageError("A table of the profile image is malformed."));
+        BlockReader reader(section);
+        const auto  head = reader.take<std::uint32_t>(2);
+        if (!head) return invalid;
+        const auto rows        = (*head)[0];
+        const auto descriptors = reader.take<ColumnDescriptor>((*head)[1]);
+        const auto ids         = reader.take<StringId>(rows);
+        if (!descriptors || !ids) return invalid;
+
+        ProfileTable table{.ids = *ids, .columns = {}};
+        for (const auto& descriptor : *descriptors) {
+            if (descriptor.type > static_cast<std::uint8_t>(ColumnType::Stack)) return invalid;
+            auto& column = table.columns.emplace_back();
+            column.name  = store.strings.view(descriptor.name);
+            column.unit  = store.strings.view(descriptor.unit);
+            column.type  = static_cast<ColumnType>(descriptor.type);
+            const auto cells = reader.take<std::int64_t>(rows);
+            if (!cells) return invalid;
+            column.cells = *cells;
+            if (descriptor.presence != 0) {
+                const auto present = reader.take<std::uint8_t>(rows);
+                if (!present) return invalid;
+                column.present = *present;
+            }
+        }
+        store.tables.push_back(std::move(table));
+        return {};
+    }
+
+    std::expected<void, ProfilerError> openView(ProfileStore& store, std::span<const std::byte> section) {
+        const auto invalid = std::unexpected(imageError("A view of the profile image is malformed."));
+        BlockReader reader(section);
+        const auto  head = reader.take<std::uint32_t>(4);
+        if (!head || (*head)[1] >= store.tables.size()) return invalid;
+        const auto& table   = store.tables[(*head)[1]];
+        const auto  rows    = reader.take<std::uint32_t>((*head)[2]);
+        const auto  columns = reader.take<std::uint32_t>((*head)[3]);
+        // Rows are checked by ProfileStore::rowsValid on first use; reading them here would load every view's pages.
+        if (!rows || !columns || std::any_of(columns->begin(), columns->end(), [&](std::uint32_t column) {
+                return column >= table.columns.size();
+            })) {
+            return invalid;
+        }
+        store.views.push_back({
+            .name    = std::string(store.strings.view((*head)[0])),
+            .table   = (*head)[1],
+            .rows    = *rows,
+            .columns = std::vector<std::uint32_t>(columns->begin(), columns->end()),
+        });
+        return {};
+    }
+
+    Json cellJson(const ProfileStore& store, const ProfileColumn& column, std::size_t row) {
+        switch (column.type) {
+        case ColumnType::Integer: return column.integer(row);
+        case ColumnType::Real: return column.real(row);
+        case ColumnType::Text: return store.strings.view(column.text(row));
+        case ColumnType::Stack: break;
+        }
+        Json frames = Json::array();
+        for (const auto& frame : store.stack(column.integer(row))) {
+            frames.push_back({{"file", store.strings.view(frame.file)}, {"line", frame.line}});
+        }
+        return frames;
+    }
+
+    // Calls apply(rows, less) with the strict order of one field. Returns false when no visible column has the
+    // field, in which case every record lacks it and the stable order stays as it is. Ranking text first pays off
+    // when every row is compared many times; a selection that compares most rows once reads the strings instead.
+    template <class Apply>
+    bool withFieldOrder(
+        const ProfileStore&         store,
+        const ProfileView&          view,
+        std::vector<std::uint32_t>& rows,
+        std::string_view            field,
+        bool                        descending,
+        bool                        rankText,
+        Apply&&                     apply
+    ) {
+        const auto* column = store.column(view, field);
+        if (!column) return false;
+        const auto byPresence = [&](std::uint32_t left, std::uint32_t right, auto&& compare) {
+            const bool l = column->has(left);
+            const bool r = column->has(right);
+            if (!l || !r) {
+                if (!l && !r) return false;
+                return descending ? l : !l;
+            }
+            return compare(left, right);
+        };
+        const auto ordered = [descending](const auto& left, const auto& right) {
+            return descending ? left > right : left < right;
+        };
+
+        if (column->type == ColumnType::Integer) {
+            apply(rows, [&](std::uint32_t left, std::uint32_t right) {
+                return byPresence(left, right, [&](std::uint32_t l, std::uint32_t r) {
+                    return ordered(column->integer(l), column->integer(r));
+                });
+            });
+            return true;
+        }
+        if (column->type == ColumnType::Text && !rankText) {
+            apply(rows, [&](std::uint32_t left, std::uint32_t right) {
+                return byPresence(left, right, [&](std::uint32_t l, std::uint32_t r) {
+                    return ordered(store.strings.view(column->text(l)), store.strings.view(column->text(r)));
+                });
+            });
+            return true;
+        }
+        if (column->type == ColumnType::Text) {
+            // Rank the distinct strings once, then every comparison is an integer comparison.
+            std::vector<StringId> distinct;
+            for (const auto row : rows) if (column->has(row)) distinct.push_back(column->text(row));
+            std::sort(distinct.begin(), distinct.end());
+            distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+            std::sort(distinct.begin(), distinct.end(), [&](StringId left, StringId right) {
+                return store.strings.view(left) < store.strings.view(right);
+            });
+            std::unordered_map<StringId, std::uint32_t> rank;
+            rank.reserve(distinct.size());
+            for (std::uint32_t index = 0; index < distinct.size(); ++index) rank.emplace(distinct[index], index);
+            std::vector<std::uint32_t> rowRank(store.tableOf(view).rows(), 0);
+            for (const auto row : rows) if (column->has(row)) rowRank[row] = rank.at(column->text(row));
+            apply(rows, [&](std::uint32_t left, std::uint32_t right) {
+                return byPresence(left, right, [&](std::uint32_t l, std::uint32_t r) {
+                    return ordered(rowRank[l], rowRank[r]);
+                });
+            });
+            return true;
+        }
+        // Reals compare numerically while both are finite; non-finite reals and stacks compare by their text.
+        std::unordered_map<std::uint32_t, std::string> texts;
+        const auto textOf = [&](std::uint32_t row) -> const std::string& {
+            auto [found, inserted] = texts.try_emplace(row);
+            if (inserted) appendCellText(store, *column, row, found->second);
+            return found->second;
+        };
+        apply(rows, [&](std::uint32_t left, std::uint32_t right) {
+            return byPresence(left, right, [&](std::uint32_t l, std::uint32_t r) {
+                const auto ln = cellNumber(*column, l);
+                const auto rn = cellNumber(*column, r);
+                if (ln && rn) return ordered(*ln, *rn);
+                return ordered(textOf(l), textOf(r));
+            });
+        });
+        return true;
+    }
+
+} // namespace
+
+    ProfileImage::ProfileImage(std::vector<std::byte> bytes)
+        : owned_(std::move(bytes)), data_(owned_.data()), size_(owned_.size()) {}
+
+    ProfileImage::~ProfileImage() {
+        if (!mapped_) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+    }
+
+    std::expected<std::shared_ptr<const ProfileImage>, ProfilerError>
+    ProfileImage::map(const std::filesystem::path& path) {
+        std::shared_ptr<ProfileImage> image(new ProfileImage());
+#ifdef _WIN32
+        // Shared delete access lets cleanup remove the artifact while another reader still has it mapped.
+        const HANDLE file = CreateFileW(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE) return std::unexpected(imageError("The profile image could not be opened."));
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+            CloseHandle(file);
+            return std::unexpected(imageError("The profile image is empty or unreadable."));
+        }
+        const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return std::unexpected(imageError("The profile image could not be mapped."));
+        void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // The view keeps the mapping alive.
+        if (!address) return std::unexpected(imageError("The profile image could not be mapped."));
+        image->size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+        const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) return std::unexpected(imageError("The profile image could not be opened."));
+        struct stat status{};
+        if (::fstat(file, &status) != 0 || status.st_size <= 0) {
+            ::close(file);
+            return std::unexpected(imageError("The profile image is empty or unreadable."));
+        }
+        void* address = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (address == MAP_FAILED) return std::unexpected(imageError("The profile image could not be mapped."));
+        image->size_ = static_cast<std::size_t>(status.st_size);
+#endif
+        image->data_   = static_cast<const std::byte*>(address);
+        image->mapped_ = true;
+        return image;
+    }
+
+    void StringTable::attach(std::span<const std::uint32_t> offsets, std::span<const char> bytes) noexcept {
+        offsets_ = offsets;
+        bytes_   = bytes;
+    }
+
+    bool numbersAt(const Json& row, std::initializer_list<std::size_t> indexes) {
+        return std::all_of(indexes.begin(), indexes.end(), [&](std::size_t index) { return row[index].is_number(); });
+    }
+
+    bool stringsAt(const Json& row, std::initializer_list<std::size_t> indexes) {
+        return std::all_of(indexes.begin(), indexes.end(), [&](std::size_t index) { return row[index].is_string(); });
+    }
+
+    std::optional<StringId> StringTable::find(std::string_view value) const {
+        std::call_once(indexed_, [this] {
+            index_.reserve(size());
+            for (StringId id = 0; id < size(); ++id) index_.emplace(view(id), id);
+        });
+        const auto found = index_.find(value);
+        return found == index_.end() ? std::nullopt : std::optional<StringId>(found->second);
+    }
+
+    bool containsFolded(std::string_view haystack, std::string_view lowerNeedle) {
+        const auto found = std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+            [](char left, char right) {
+                return static_cast<char>(std::tolower(static_cast<unsigned char>(left))) == right;
+            });
+        return found != haystack.end() || lowerNeedle.empty();
+    }
+
+    const ProfileView* ProfileStore::view(std::string_view name) const {
+        const auto found = std::find_if(views.begin(), views.end(), [&](const auto& item) { return item.name == name; });
+        return found == views.end() || !rowsValid(*found) ? nullptr : &*found;
+    }
+
+    bool ProfileStore::rowsValid(const ProfileView& view) const {
+        auto& checked = checkedViews[static_cast<std::size_t>(&view - views.data())];
+        if (const auto state = checked.load(std::memory_order_acquire); state != 0) return state > 0;
+        // Concurrent first uses may both check; they store the same answer.
+        const auto rows  = tables[view.table].rows();
+        const bool valid =
+            std::all_of(view.rows.begin(), view.rows.end(), [&](std::uint32_t row) { return row < rows; });
+        checked.store(valid ? 1 : -1, std::memory_order_release);
+        return valid;
+    }
+
+    std::span<const ProfileFrame> ProfileStore::stack(std::int64_t index) const noexcept {
+        if (index < 0 || static_cast<std::uint64_t>(index) + 1 >= stackOffsets.size()) return {};
+        const auto begin = stackOffsets[static_cast<std::size_t>(index)];
+        const auto end   = stackOffsets[static_cast<std::size_t>(index) + 1];
+        return begin <= end && end <= frames.size() ? frames.subspan(begin, end - begin) : std::span<const ProfileFrame>();
+    }
+
+    const ProfileColumn* ProfileStore::column(const ProfileView& view, std::string_view name) const {
+        const auto& columns = tableOf(view).columns;
+        for (const auto index : view.columns) {
+            if (columns[index].name == name) return &columns[index];
+        }
+        return nullptr;
+    }
+
+    std::vector<std::byte> encodeProfile(ProfilerKind kind, const nlohmann::json& data) {
+        Draft draft;
+        if (data.is_object()) {
+            if (kind == ProfilerKind::PythonCpu) buildPythonCpu(draft, data);
+            else if (kind == ProfilerKind::PythonMemory) buildPythonMemory(draft, data);
+            else if (kind == ProfilerKind::FrameTime) buildFrameTime(draft, data);
+            else buildNative(draft, data);
+        }
+        return encodeDraft(kind, draft);
+    }
+
+    std::expected<std::shared_ptr<const ProfileStore>, ProfilerError>
+    openProfileStore(std::shared_ptr<const ProfileImage> image) {
+        if (!image) return std::unexpected(imageError("The profile image is missing."));
+        const auto  bytes = image->bytes();
+        ImageHeader header{};
+        if (bytes.size() < sizeof(header)) return std::unexpected(imageError("The profile image is truncated."));
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, ImageMagic, sizeof(ImageMagic)) != 0) {
+            return std::unexpected(imageError("The file is not a profile image."));
+        }
+        if (header.version != ProfileFormatVersion) {
+            return std::unexpected(imageError("Profile image version " + std::to_string(header.version) + " is not supported."));
+        }
+        if (header.kind > static_cast<std::uint32_t>(ProfilerKind::FrameTime) || header.size != bytes.size()) {
+            return std::unexpected(imageError("The profile image header is inconsistent."));
+        }
+        BlockReader index(bytes);
+        const auto  entries = index.take<ImageHeader>(1) ? index.take<SectionEntry>(header.sections) : std::nullopt;
+        if (!entries) return std::unexpected(imageError("The profile image section index is truncated."));
+
+        std::optional<std::span<const std::byte>> strings;
+        std::optional<std::span<const std::byte>> frames;
+        std::optional<std::span<const std::byte>> stacks;
+        std::vector<std::span<const std::byte>>   tables;
+        std::vector<std::span<const std::byte>>   views;
+        for (const auto& entry : *entries) {
+            if (entry.offset % 8 != 0 || entry.offset > bytes.size() || entry.size > bytes.size() - entry.offset) {
+                return std::unexpected(imageError("A profile image section lies outside the file."));
+            }
+            const auto section = bytes.subspan(static_cast<std::size_t>(entry.offset), static_cast<std::size_t>(entry.size));
+            auto*      unique  = static_cast<std::optional<std::span<const std::byte>>*>(nullptr);
+            switch (static_cast<SectionType>(entry.type)) {
+            case SectionType::Strings: unique = &strings; break;
+            case SectionType::Frames: unique = &frames; break;
+            case SectionType::Stacks: unique = &stacks; break;
+            case SectionType::Table: tables.push_back(section); break;
+            case SectionType::View: views.push_back(section); break;
+            default: break; // Sections a later writer added without changing the layout of these ones.
+            }
+            if (unique && *unique) return std::unexpected(imageError("A profile image section is duplicated."));
+            if (unique) *unique = section;
+        }
+        if (!strings || !frames || !stacks) {
+            return std::unexpected(imageError("The profile image lacks a string, frame or stack section."));
+        }
+
+        auto store   = std::make_shared<ProfileStore>();
+        store->image = image;
+        store->kind  = static_cast<ProfilerKind>(header.kind);
+
+        BlockReader stringReader(*strings);
+        const auto  stringHead = stringReader.take<std::uint32_t>(2);
+        const auto  offsets =
+            stringHead ? stringReader.take<std::uint32_t>(std::size_t{(*stringHead)[0]} + 1) : std::nullopt;
+        const auto characters = offsets ? stringReader.take<char>(offsets->back()) : std::nullopt;
+        if (!characters) return std::unexpected(imageError("The string section of the profile image is malformed."));
+        store->strings.attach(*offsets, *characters);
+
+        BlockReader frameReader(*frames);
+        const auto  frameHead = frameReader.take<std::uint32_t>(2);
+        const auto  frameRows = frameHead ? frameReader.take<ProfileFrame>((*frameHead)[0]) : std::nullopt;
+        if (!frameRows) return std::unexpected(imageError("The frame section of the profile image is malformed."));
+        store->frames = *frameRows;
+
+        BlockReader stackReader(*stacks);
+        const auto  stackHead = stackReader.take<std::uint32_t>(2);
+        const auto  stackOffsets =
+            stackHead ? stackReader.take<std::uint32_t>(std::size_t{(*stackHead)[0]} + 1) : std::nullopt;
+        if (!stackOffsets) return std::unexpected(imageError("The stack section of the profile image is malformed."));
+        store->stackOffsets = *stackOffsets;
+
+        for (const auto section : tables) {
+            if (auto opened = openTable(*store, section); !opened) return std::unexpected(std::move(opened.error()));
+        }
+        for (const auto section : views) {
+            if (auto opened = openView(*store, section); !opened) return std::unexpected(std::move(opened.error()));
+        }
+        store->checkedViews = std::vector<std::atomic<std::int8_t>>(store->views.size());
+        return store;
+    }
+
+    std::expected<std::shared_ptr<const ProfileStore>, ProfilerError>
+    buildProfileStore(ProfilerKind kind, const nlohmann::json& data) {
+        try {
+            return openProfileStore(std::make_shared<const ProfileImage>(encodeProfile(kind, data)));
+        } catch (const std::length_error& error) {
+            return std::unexpected(imageError(error.what()));
+        }
+    }
+
+    void appendCellText(const ProfileStore& store, const ProfileColumn& column, std::size_t row, std::string& output) {
+        if (!column.has(row)) return;
+        char buffer[32];
+        switch (column.type) {
+        case ColumnType::Integer: {
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), column.integer(row));
+            output.append(buffer, result.ptr);
+            break;
+        }
+        case ColumnType::Real: {
+            // The general format with six digits is what a default-formatted stream writes.
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), column.real(row), std::chars_format::general, 6);
+            output.append(buffer, result.ptr);
+            break;
+        }
+        case ColumnType::Text:
+            output += store.strings.view(column.text(row));
+            break;
+        case ColumnType::Stack: {
+            bool first = true;
+            for (const auto& frame : store.stack(column.integer(row))) {
+                if (!first) output += " <- ";
+                first = false;
+                output += store.strings.view(frame.file);
+                output += ':';
+                const auto result = std::to_chars(buffer, buffer + sizeof(buffer), frame.line);
+                output.append(buffer, result.ptr);
+            }
+            break;
+        }
+        }
+    }
+
+    std::string cellText(const ProfileStore& store, const ProfileColumn& column, std::size_t row) {
+        std::string result;
+        appendCellText(store, column, row, result);
+        return result;
+    }
+
+    std::optional<long double> cellNumber(const ProfileColumn& column, std::size_t row) {
+        if (!column.has(row)) return std::nullopt;
+        if (column.type == ColumnType::Integer) return static_cast<long double>(column.integer(row));
+        if (column.type == ColumnType::Real && std::isfinite(column.real(row))) return column.real(row);
+        return std::nullopt;
+    }
+
+    ProfilerField cellField(const ProfileStore& store, const ProfileColumn& column, std::size_t row) {
+        ProfilerField field{.value = std::int64_t{0}, .unit = column.unit};
+        switch (column.type) {
+        case ColumnType::Integer: field.value = column.integer(row); break;
+        case ColumnType::Real: field.value = column.real(row); break;
+        case ColumnType::Text: field.value = std::string(store.strings.view(column.text(row))); break;
+        case ColumnType::Stack: {
+            ProfilerStackTrace trace;
+            for (const auto& frame : store.stack(column.integer(row))) {
+                trace.push_back({std::string(store.strings.view(frame.file)), frame.line});
+            }
+            field.value = std::move(trace);
+            break;
+        }
+        }
+        return field;
+    }
+
+    QueryRecord materializeRecord(const ProfileStore& store, const ProfileView& view, std::size_t row) {
+        const auto& table = store.tableOf(view);
+        QueryRecord record{.id = std::string(store.strings.view(table.ids[row]))};
+        for (const auto index : view.columns) {
+            const auto& column = table.columns[index];
+            if (column.has(row)) record.fields.emplace(column.name, cellField(store, column, row));
+        }
+        return record;
+    }
+
+    nlohmann::json profileJson(const ProfileStore& store) {
+        Json views = Json::object();
+        for (const auto& view : store.views) {
+            if (!store.rowsValid(view)) continue;
+            const auto& table   = store.tableOf(view);
+            Json        records = Json::array();
+            for (const auto row : view.rows) {
+                Json fields = Json::object();
+                for (const auto index : view.columns) {
+                    const auto& column = table.columns[index];
+                    if (!column.has(row)) continue;
+                    fields[column.name] = {
+                        {"value", cellJson(store, column, row)},
+                        {"unit", column.unit.empty() ? Json(nullptr) : Json(column.unit)},
+                    };
+                }
+                records.push_back({{"id", store.strings.view(table.ids[row])}, {"fields", std::move(fields)}});
+            }
+            views[view.name] = std::move(records);
+        }
+        return Json{{"views", std::move(views)}};
+    }
+
+    RowTextMatcher::RowTextMatcher(const ProfileStore& store, const ProfileView& view, std::string_view lowerNeedle)
+        : store_(store), view_(view), needle_(lowerNeedle), textMatches_(view.columns.size()) {}
+
+    bool RowTextMatcher::operator()(std::uint32_t row) {
+        const auto& table = store_.tableOf(view_);
+        if (containsFolded(store_.strings.view(table.ids[row]), needle_)) return true;
+        for (std::size_t visible = 0; visible < view_.columns.size(); ++visible) {
+            const auto& column = table.columns[view_.columns[visible]];
+            if (!column.has(row)) continue;
+            auto* memo = static_cast<std::int8_t*>(nullptr);
+            if (column.type == ColumnType::Text && column.text(row) < store_.strings.size()) {
+                auto& matches = textMatches_[visible];
+                if (matches.empty()) matches.assign(store_.strings.size(), -1);
+                memo = &matches[column.text(row)];
+                if (*memo >= 0) {
+                    if (*memo != 0) return true;
+                    continue;
+                }
+            }
+            text_.assign(column.name);
+            text_ += ' ';
+            appendCellText(store_, column, row, text_);
+            const bool matched = containsFolded(text_, needle_);
+            if (memo) *memo = matched ? 1 : 0;
+            if (matched) return true;
+        }
+        return false;
+    }
+
+    std::vector<std::uint32_t>
+    filterRows(const ProfileStore& store, const ProfileView& view, std::string_view lowerNeedle) {
+        if (lowerNeedle.empty()) return {view.rows.begin(), view.rows.end()};
+        RowTextMatcher             matches(store, view, lowerNeedle);
+        std::vector<std::uint32_t> result;
+        for (const auto row : view.rows) {
+            if (matches(row)) result.push_back(row);
+        }
+        return result;
+    }
+
+    void sortRows(
+        const ProfileStore&         store,
+        const ProfileView&          view,
+        std::vector<std::uint32_t>& rows,
+        std::string_view            field,
+        bool                        descending
+    ) {
+        withFieldOrder(store, view, rows, field, descending, true, [](std::vector<std::uint32_t>& values, const auto& less) {
+            std::stable_sort(values.begin(), values.end(), less);
+        });
+    }
+
+    void selectTopRows(
+        const ProfileStore&         store,
+        const ProfileView&          view,
+        std::vector<std::uint32_t>& rows,
+        std::string_view            field,
+        bool                        descending,
+        std::size_t                 count
+    ) {
+        if (count >= rows.size()) {
+            sortRows(store, view, rows, field, descending);
+            return;
+        }
+        const bool ordered = withFieldOrder(
+            store, view, rows, field, descending, false, [count](std::vector<std::uint32_t>& values, const auto& less) {
+                // Ties fall back to the input position, which is the order a stable sort keeps them in.
+                std::vector<std::uint32_t> positions(values.size());
+                std::iota(positions.begin(), positions.end(), 0U);
+                const auto middle = positions.begin() + static_cast<std::ptrdiff_t>(count);
+                std::partial_sort(positions.begin(), middle, positions.end(), [&](std::uint32_t left, std::uint32_t right) {
+                    if (less(values[left], values[right])) return true;
+                    if (less(values[right], values[left])) return false;
+                    return left < right;
+                });
+                std::vector<std::uint32_t> selected;
+                selected.reserve(count);
+                for (auto position = positions.begin(); position != middle; ++position) selected.push_back(values[*position]);
+                values = std::move(selected);
+            }
+        );
+        if (!ordered) rows.resize(count);
+    }
+
+} // namespace mcdk::performance
@@ -0,0 +1,112 @@
+#include <performance/profile_trend.hpp>
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace mcdk::performance {
+namespace {
+
+    struct Moments {
+        double mean     = 0;
+        double variance = 0;
+    };
+
+    Moments momentsOf(std::span<const double> values) {
+        Moments result;
+        if (values.empty()) return result;
+        // Two passes keep the variance of large, nearly equal timings from cancelling away.
+        result.mean = std::accumulate(values.begin(), values.end(), 0.0L) / static_cast<long double>(values.size());
+        if (values.size() < 2) return result;
+        long double squares = 0;
+        for (const auto value : values) squares += (value - result.mean) * (value - result.mean);
+        result.variance = static_cast<double>(squares / static_cast<long double>(values.size() - 1));
+        return result;
+    }
+
+    // The continued fraction of the regularized incomplete beta function, by the modified Lentz method.
+    double betaFraction(double a, double b, double x) {
+        constexpr double Tiny = 1e-300;
+        constexpr double Epsilon = 1e-15;
+        double c = 1;
+        double d = 1 - (a + b) * x / (a + 1);
+        if (std::abs(d) < Tiny) d = Tiny;
+        d = 1 / d;
+        double result = d;
+        for (int m = 1; m <= 300; ++m) {
+            const double even = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+            d = 1 + even * d;
+            c = 1 + even / c;
+            if (std::abs(d) < Tiny) d = Tiny;
+            if (std::abs(c) < Tiny) c = Tiny;
+            d = 1 / d;
+            result *= d * c;
+            const double odd = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+            d = 1 + odd * d;
+            c = 1 + odd / c;
+            if (std::abs(d) < Tiny) d = Tiny;
+            if (std::abs(c) < Tiny) c = Tiny;
+            d = 1 / d;
+            const double step = d * c;
+            result *= step;
+            if (std::abs(step - 1) < Epsilon) break;
+        }
+        return result;
+    }
+
+    double regularizedBeta(double a, double b, double x) {
+        if (x <= 0) return 0;
+        if (x >= 1) return 1;
+        const double front = std::exp(
+            std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log1p(-x)
+        );
+        // The fraction converges quickly only on the side of the mean; the symmetry relation covers the other.
+        if (x < (a + 1) / (a + b + 2)) return front * betaFraction(a, b, x) / a;
+        return 1 - front * betaFraction(b, a, 1 - x) / b;
+    }
+
+} // namespace
+
+    double studentTwoSided(double t, double degreesOfFreedom) {
+        if (std::isnan(t) || !(degreesOfFreedom > 0)) return 1;
+        if (std::isinf(t)) return 0;
+        return regularizedBeta(degreesOfFreedom / 2, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t));
+    }
+
+    std::optional<TrendTest> trendTest(std::span<const double> baseline, std::span<const double> candidate) {
+        if (baseline.size() < 2 || candidate.empty()) return std::nullopt;
+        const auto before = momentsOf(baseline);
+        const auto after  = momentsOf(candidate);
+        TrendTest result{
+            .baselineRuns      = baseline.size(),
+            .candidateRuns     = candidate.size(),
+            .baselineMean      = before.mean,
+            .baselineVariance  = before.variance,
+            .candidateMean     = after.mean,
+            .candidateVariance = after.variance,
+        };
+        const auto left  = static_cast<double>(baseline.size());
+        const auto right = static_cast<double>(candidate.size());
+        double squaredError = 0;
+        if (candidate.size() == 1) {
+            squaredError            = before.variance * (1 + 1 / left);
+            result.degreesOfFreedom = left - 1;
+        } else {
+            const auto a            = before.variance / left;
+            const auto b            = after.variance / right;
+            squaredError            = a + b;
+            const auto denominator  = a * a / (left - 1) + b * b / (right - 1);
+            result.degreesOfFreedom = denominator > 0 ? squaredError * squaredError / denominator : left + right - 2;
+        }
+        const auto difference = after.mean - before.mean;
+        if (squaredError > 0) {
+            result.t = difference / std::sqrt(squaredError);
+        } else if (difference != 0) {
+            // Identical runs on each side that still differ: no noise can explain the shift.
+            result.t = std::copysign(std::numeric_limits<double>::infinity(), difference);
+        }
+        result.pValue = studentTwoSided(result.t, result.degreesOfFreedom);
+        return result;
+    }
+
+} // namespace mcdk::performance
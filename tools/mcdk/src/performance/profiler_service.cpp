@@ -1,6 +1,17 @@
 #include <performance/profiler_service_factory.hpp>
 
+#include <performance/collector_rows.hpp>
 #include <performance/native_bridge_loader.hpp>
+#include <performance/profile_filter.hpp>
+#include <performance/profile_flame.hpp>
+#include <performance/profile_frames.hpp>
+#include <performance/profile_interchange.hpp>
+#include <performance/profile_memory.hpp>
+#include <performance/profile_recorder.hpp>
+#include <performance/profile_sampling.hpp>
+#include <performance/profile_store.hpp>
+#include <performance/profile_trend.hpp>
+#include <performance/query_cache.hpp>
 
 #include <algorithm>
 #include <array>
@@ -12,9 +23,11 @@
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <map>
 #include <mutex>
+#include <numeric>
 #include <random>
-#include <set>
+#include <regex>
 #include <sstream>
 #include <thread>
 #include <type_traits>
@@ -30,6 +43,23 @@ namespace {
 
     constexpr std::size_t MaximumQueryRecords = 50;
     constexpr std::size_t MaximumQueryBytes   = 64 * 1024;
+    constexpr std::size_t MaximumTrendRuns    = 50;
+    // The index of committed disk jobs in the storage root, so history never reads the job directories.
+    constexpr std::string_view CatalogFile   = "catalog.json";
+    constexpr int              CatalogSchema = 1;
+    // The game stops a flight recorder's profiler on its own unless it is drained within this lease.
+    constexpr std::chrono::seconds RecorderLease{30};
+    constexpr std::size_t MinimumRecorderBytes = 1024 * 1024;
+    constexpr std::size_t MaximumRecorderBytes = 256 * 1024 * 1024;
+    // How often a trigger drains its tick watcher or reads the game log.
+    constexpr std::chrono::milliseconds TriggerPollInterval{500};
+    constexpr std::size_t MaximumArmedTriggers    = 4;
+    constexpr std::size_t MaximumRetainedTriggers = 16;
+    constexpr std::size_t MaximumTriggerLogLines  = 1024;
+    // A log pattern trigger keeps reading while more lines are waiting, for at most this long per poll.
+    constexpr std::chrono::milliseconds TriggerLogReadBudget{100};
+    // How often a frame-time job drains its tick watchers; well within their lease and their 8192-frame buffer.
+    constexpr std::chrono::milliseconds FrameDrainInterval{500};
 
     ProfilerError failure(std::string code, std::string message, bool retryable = false) {
         if (code.size() > 128) code.resize(128);
@@ -72,6 +102,22 @@ namespace {
         return value;
     }
 
+    // A capture's game-side stop timer and the lease after which the game stops profiling on its own. A flight
+    // recorder has no stop timer; each drain renews its lease instead.
+    std::string replacePythonCpuTimers(std::string code, const StartRequest& request) {
+        const bool recorder = request.mode == ProfileMode::Recorder;
+        code = replaceToken(
+            std::move(code), "@TIMER@",
+            recorder ? "_timer=None"
+                     : "_timer=threading.Timer(_mcdev_pp_duration,_mcdev_pp_stop); _timer.daemon=True; _timer.start()"
+        );
+        code = replaceToken(
+            std::move(code), "@TTL@",
+            std::to_string(recorder ? RecorderLease.count() : request.duration.count() + 60)
+        );
+        return replaceToken(std::move(code), "@DURATION@", std::to_string(request.duration.count()));
+    }
+
     std::string pythonCpuStartCode(const StartRequest& request, std::string_view owner) {
         std::string code = R"PY(import yappi,threading,time
 _mcdev_pp_clock='@CLOCK@'
@@ -90,7 +136,7 @@ else:
  globals()['_mcdev_pp_owned']=True; globals()['_mcdev_pp_owner']=_mcdev_pp_owner
  globals()['_mcdev_pp_started']=time.time()
  globals()['_mcdev_pp_stopped']=None
- globals()['_mcdev_pp_clock']=_mcdev_pp_clock
+ globals()['_mcdev_pp_clock']=_mcdev_pp_clock; globals()['_mcdev_pp_ctx']={}
  def _mcdev_pp_stop(_owner=_mcdev_pp_owner):
   try:
    if globals().get('_mcdev_pp_owner')==_owner and globals().get('_mcdev_pp_owned',False) and yappi.is_running():
@@ -102,12 +148,12 @@ else:
     if yappi.is_running(): yappi.stop()
     yappi.clear_stats(); globals()['_mcdev_pp_owned']=False; globals()['_mcdev_pp_owner']=None
   except: pass
- _timer=threading.Timer(_mcdev_pp_duration,_mcdev_pp_stop); _timer.daemon=True; _timer.start()
- _ttl=threading.Timer(_mcdev_pp_duration+60,_mcdev_pp_expire); _ttl.daemon=True; _ttl.start()
+ @TIMER@
+ _ttl=threading.Timer(@TTL@,_mcdev_pp_expire); _ttl.daemon=True; _ttl.start()
  globals()['_mcdev_pp_timer']=_timer; globals()['_mcdev_pp_ttl']=_ttl
  _result={'ok':True,'running':True,'clock':_mcdev_pp_clock})PY";
         code = replaceToken(std::move(code), "@CLOCK@", request.clock == ProfileClock::Wall ? "WALL" : "CPU");
-        code = replaceToken(std::move(code), "@DURATION@", std::to_string(request.duration.count()));
+        code = replacePythonCpuTimers(std::move(code), request);
         code = replaceToken(std::move(code), "@OWNER@", owner);
         return replaceToken(std::move(code), "@THREADS@", request.target == ProfileTarget::All ? "True" : "False");
     }
@@ -118,20 +164,13 @@ else:
              + "_marker()\n_result=True";
     }
 
-    std::string pythonCpuCollectCode(const StartRequest& request, std::string_view owner) {
+    // The body of a collection that builds _result from the owned yappi stats. Client and server contexts are found
+    // through the start markers and remembered, because a flight recorder clears the markers' stats with its first drain.
+    std::string pythonCpuStatsCode(const StartRequest& request) {
         const auto target = request.target == ProfileTarget::Client ? "client"
                           : request.target == ProfileTarget::Server ? "server" : "all";
-        std::string code = R"PY(import yappi,time
-_mcdev_pp_owner='@OWNER@'
-if globals().get('_mcdev_pp_owner')!=_mcdev_pp_owner or not globals().get('_mcdev_pp_owned',False):
- _result={'ok':False,'reason':'not_owned'}
-else:
- _timer=globals().get('_mcdev_pp_timer'); _ttl=globals().get('_mcdev_pp_ttl')
- if _timer: _timer.cancel()
- if _ttl: _ttl.cancel()
- if yappi.is_running(): yappi.stop(); globals()['_mcdev_pp_stopped']=time.time()
- _stats=yappi.get_func_stats(); _stats.sort('ttot','desc')
- _ctx={}
+        std::string code = R"PY( _stats=yappi.get_func_stats(); _stats.sort('ttot','desc')
+ _ctx=globals().get('_mcdev_pp_ctx') or {}; globals()['_mcdev_pp_ctx']=_ctx
  for _s in _stats:
   if _s.name=='_mcdev_pp_client_marker': _ctx[int(_s.ctx_id or 0)]='client'
   elif _s.name=='_mcdev_pp_server_marker': _ctx[int(_s.ctx_id or 0)]='server'
@@ -147,7 +186,7 @@ else:
   _side=_ctx.get(int(_s.ctx_id or 0)) if '@TARGET@'=='all' else '@TARGET@'
   if '@TARGET@'=='all': _project=_project and _side is not None
   if _project and not _s.name.startswith('_mcdev_pp_'): _all.append(_s); _sides[_s.index]=_side
- _keep=_all[:512]; _ids=dict((_s.index,_i) for _i,_s in enumerate(_keep)); _nodes=[]
+ _keep=_all[:@MAX_FUNCTIONS@]; _ids=dict((_s.index,_i) for _i,_s in enumerate(_keep)); _nodes=[]
  for _i,_s in enumerate(_keep):
   _nodes.append([_i,(_s.module or '')[:4096],int(_s.lineno or 0),(_s.name or '')[:1024],int(_s.ncall or 0),int(_s.nactualcall or 0),float(_s.tsub or 0),float(_s.ttot or 0),int(_s.ctx_id or 0),(_s.ctx_name or '')[:512],_sides.get(_s.index)])
  _edges=[]
@@ -155,15 +194,48 @@ else:
   for _child in _parent.children:
    if _child.index in _ids and _sides.get(_parent.index)==_sides.get(_child.index):
     _edges.append([_ids[_parent.index],_ids[_child.index],int(_child.ncall or 0),float(_child.tsub or 0),float(_child.ttot or 0)])
-    if len(_edges)>=2048: break
-  if len(_edges)>=2048: break
+    if len(_edges)>=@MAX_CALLS@: break
+  if len(_edges)>=@MAX_CALLS@: break
  _end=globals().get('_mcdev_pp_stopped') or time.time()
- _result={'ok':True,'clock':globals().get('_mcdev_pp_clock','CPU'),'elapsed':max(0,_end-globals().get('_mcdev_pp_started',_end)),'total':len(_all),'truncated':len(_all)>len(_keep) or len(_edges)>=2048,'targets':list(set(_ctx.values())),'nodes':_nodes,'edges':_edges}
- yappi.clear_stats(); globals()['_mcdev_pp_owned']=False; globals()['_mcdev_pp_owner']=None; globals()['_mcdev_pp_timer']=None; globals()['_mcdev_pp_ttl']=None)PY";
-        code = replaceToken(std::move(code), "@OWNER@", owner);
+ _result={'ok':True,'clock':globals().get('_mcdev_pp_clock','CPU'),'elapsed':max(0,_end-globals().get('_mcdev_pp_started',_end)),'total':len(_all),'truncated':len(_all)>len(_keep) or len(_edges)>=@MAX_CALLS@,'targets':list(set(_ctx.values())),'nodes':_nodes,'edges':_edges}
+)PY";
+        code = replaceToken(std::move(code), "@MAX_FUNCTIONS@", std::to_string(CollectorMaximumFunctions));
+        code = replaceToken(std::move(code), "@MAX_CALLS@", std::to_string(CollectorMaximumCalls));
         return replaceToken(std::move(code), "@TARGET@", target);
     }
 
+    std::string pythonCpuCollectCode(const StartRequest& request, std::string_view owner) {
+        std::string code = R"PY(import yappi,time
+_mcdev_pp_owner='@OWNER@'
+if globals().get('_mcdev_pp_owner')!=_mcdev_pp_owner or not globals().get('_mcdev_pp_owned',False):
+ _result={'ok':False,'reason':'not_owned'}
+else:
+ _timer=globals().get('_mcdev_pp_timer'); _ttl=globals().get('_mcdev_pp_ttl')
+ if _timer: _timer.cancel()
+ if _ttl: _ttl.cancel()
+ if yappi.is_running(): yappi.stop(); globals()['_mcdev_pp_stopped']=time.time()
+@STATS@ yappi.clear_stats(); globals()['_mcdev_pp_owned']=False; globals()['_mcdev_pp_owner']=None; globals()['_mcdev_pp_timer']=None; globals()['_mcdev_pp_ttl']=None)PY";
+        code = replaceToken(std::move(code), "@STATS@", pythonCpuStatsCode(request));
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    // Collects a flight recorder's stats since its previous drain while yappi keeps running, then clears them and
+    // renews the lease.
+    std::string pythonCpuDrainCode(const StartRequest& request, std::string_view owner) {
+        std::string code = R"PY(import yappi,threading,time
+_mcdev_pp_owner='@OWNER@'
+if globals().get('_mcdev_pp_owner')!=_mcdev_pp_owner or not globals().get('_mcdev_pp_owned',False) or not yappi.is_running():
+ _result={'ok':False,'reason':'not_owned'}
+else:
+ _ttl=globals().get('_mcdev_pp_ttl')
+ if _ttl: _ttl.cancel()
+@STATS@ yappi.clear_stats(); globals()['_mcdev_pp_started']=_end
+ _ttl=threading.Timer(@TTL@,_mcdev_pp_expire); _ttl.daemon=True; _ttl.start(); globals()['_mcdev_pp_ttl']=_ttl)PY";
+        code = replaceToken(std::move(code), "@STATS@", pythonCpuStatsCode(request));
+        code = replaceToken(std::move(code), "@TTL@", std::to_string(RecorderLease.count()));
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
     std::string pythonCpuCleanupCode(std::string_view owner) {
         std::string code = R"PY(import yappi
 _mcdev_pp_owner='@OWNER@'
@@ -178,6 +250,157 @@ _result=True)PY";
         return replaceToken(std::move(code), "@OWNER@", owner);
     }
 
+    // The sampling engine: a daemon thread wakes every interval, reads the profiled threads' stacks from
+    // sys._current_frames() and counts each stack of project frames into a trie keyed by code object and thread. A
+    // frame's self count grows only when it was the innermost frame, so time in library code is nobody's self time,
+    // as with yappi. Stacks deeper than 128 project frames keep their outermost ones and fold the leaf's self count
+    // into the deepest frame kept, and samples that would grow the trie past 32768 nodes are dropped and counted. The target side's game thread is the one running this code; with
+    // target=all the server marker adds its own thread.
+    std::string pythonSamplerStartCode(const StartRequest& request, std::string_view owner) {
+        std::string code = R"PY(import sys,threading,time
+_mcdev_pp_duration=@DURATION@
+_mcdev_pp_owner='@OWNER@'
+if globals().get('_mcdev_pp_owned',False):
+ _result={'ok':False,'reason':'busy'}
+else:
+ _old=globals().get('_mcdev_pp_timer')
+ if _old: _old.cancel()
+ _ttl=globals().get('_mcdev_pp_ttl')
+ if _ttl: _ttl.cancel()
+ try:
+  import common.minecraftMod as _mod
+  _inst=_mod.instance()
+  _scripts=set(_n for _n in ((getattr(_inst,'clientScriptNameList',[]) or [])+(getattr(_inst,'serverScriptNameList',[]) or [])) if _n)
+ except: _scripts=set()
+ _sampler={'stop':threading.Event(),'lock':threading.Lock(),'interval':@INTERVAL@,'scripts':_scripts,'threads':{threading.current_thread().ident:'@SIDE@'},'contexts':{},'root':[0,0,{}],'functions':{},'table':[],'nodes':0,'ticks':0,'dropped':0}
+ def _mcdev_pp_sample(_state=_sampler):
+  _project={}
+  try:
+   while not _state['stop'].wait(_state['interval']):
+    _frames=sys._current_frames()
+    with _state['lock']:
+     _state['ticks']+=1
+     for _tid,_side in list(_state['threads'].items()):
+      _frame=_frames.get(_tid); _stack=[]; _leaf=True
+      while _frame is not None:
+       _code=_frame.f_code; _file=_code.co_filename or ''
+       _mine=_project.get(_file)
+       if _mine is None:
+        _parts=set(_file.replace('\\','/').split('/'))
+        _mine=_project[_file]=any(_n in _parts or _file==_n or _file.startswith(_n+'.') for _n in _state['scripts'])
+       if _mine: _stack.append((_code,_leaf))
+       _leaf=False; _frame=_frame.f_back
+      if len(_stack)>128: _stack[-128]=(_stack[-128][0],_stack[0][1]); del _stack[:-128]
+      _node=_state['root']
+      for _code,_self in reversed(_stack):
+       _index=_state['functions'].get((_code,_tid))
+       if _index is None:
+        _index=_state['functions'][(_code,_tid)]=len(_state['table'])
+        _state['table'].append([(_code.co_filename or '')[:4096],int(_code.co_firstlineno or 0),(_code.co_name or '')[:1024],_state['contexts'].setdefault(_tid,len(_state['contexts'])+1),_tid,_side])
+       _child=_node[2].get(_index)
+       if _child is None:
+        if _state['nodes']>=32768: _state['dropped']+=1; break
+        _child=_node[2][_index]=[0,0,{}]; _state['nodes']+=1
+       _child[1]+=1
+       if _self: _child[0]+=1
+       _node=_child
+    _frames=None
+  except: _state['stop'].set()
+ def _mcdev_pp_stop(_owner=_mcdev_pp_owner,_state=_sampler):
+  try:
+   if globals().get('_mcdev_pp_owner')==_owner and not _state['stop'].is_set():
+    _state['stop'].set(); globals()['_mcdev_pp_stopped']=time.time()
+  except: pass
+ def _mcdev_pp_expire(_owner=_mcdev_pp_owner,_state=_sampler):
+  try:
+   if globals().get('_mcdev_pp_owner')==_owner:
+    _state['stop'].set(); globals()['_mcdev_pp_owned']=False; globals()['_mcdev_pp_owner']=None; globals()['_mcdev_pp_sampler']=None
+  except: pass
+ globals()['_mcdev_pp_owned']=True; globals()['_mcdev_pp_owner']=_mcdev_pp_owner
+ globals()['_mcdev_pp_started']=time.time()
+ globals()['_mcdev_pp_stopped']=None
+ globals()['_mcdev_pp_clock']='WALL'; globals()['_mcdev_pp_sampler']=_sampler
+ _thread=threading.Thread(target=_mcdev_pp_sample,name='mcdev-pp-sampler'); _thread.daemon=True; _thread.start()
+ @TIMER@
+ _ttl=threading.Timer(@TTL@,_mcdev_pp_expire); _ttl.daemon=True; _ttl.start()
+ globals()['_mcdev_pp_timer']=_timer; globals()['_mcdev_pp_ttl']=_ttl
+ _result={'ok':True,'running':True,'clock':'WALL'})PY";
+        std::ostringstream interval;
+        interval << std::setprecision(6) << 1.0 / request.sampleHertz;
+        code = replaceToken(std::move(code), "@INTERVAL@", interval.str());
+        code = replaceToken(std::move(code), "@SIDE@", request.target == ProfileTarget::Server ? "server" : "client");
+        code = replacePythonCpuTimers(std::move(code), request);
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    std::string pythonSamplerMarkerCode(std::string_view owner) {
+        std::string code = R"PY(import threading
+_state=globals().get('_mcdev_pp_sampler')
+if _state and globals().get('_mcdev_pp_owner')=='@OWNER@': _state['threads'][threading.current_thread().ident]='server'
+_result=True)PY";
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    // The body of a collection that takes the trie sampled so far, leaving the sampler an empty one, and builds
+    // _result from it in pre-order so every parent precedes its children.
+    constexpr std::string_view PythonSamplerStacksCode = R"PY( _state=globals().get('_mcdev_pp_sampler')
+ with _state['lock']:
+  _root=_state['root']; _table=_state['table']; _ticks=_state['ticks']; _dropped=_state['dropped']
+  _state['root']=[0,0,{}]; _state['functions']={}; _state['table']=[]; _state['nodes']=0; _state['ticks']=0; _state['dropped']=0
+ _names=dict((_t.ident,_t.name) for _t in threading.enumerate())
+ _functions=[[_f[0],_f[1],_f[2],_f[3],(_names.get(_f[4]) or '')[:512],_f[5]] for _f in _table]
+ _stacks=[]; _todo=[(-1,_item) for _item in _root[2].items()]
+ while _todo:
+  _parent,(_index,_node)=_todo.pop(); _stacks.append([_parent,_index,_node[0],_node[1]])
+  _todo.extend((len(_stacks)-1,_item) for _item in _node[2].items())
+ _end=globals().get('_mcdev_pp_stopped') or time.time()
+ _result={'ok':True,'clock':'WALL','elapsed':max(0,_end-globals().get('_mcdev_pp_started',_end)),'targets':list(set(_state['threads'].values())),'sampler':{'interval':_state['interval'],'ticks':_ticks,'dropped':_dropped},'functions':_functions,'stacks':_stacks}
+)PY";
+
+    std::string pythonSamplerCollectCode(std::string_view owner) {
+        std::string code = R"PY(import threading,time
+_mcdev_pp_owner='@OWNER@'
+if globals().get('_mcdev_pp_owner')!=_mcdev_pp_owner or not globals().get('_mcdev_pp_owned',False) or not globals().get('_mcdev_pp_sampler'):
+ _result={'ok':False,'reason':'not_owned'}
+else:
+ _timer=globals().get('_mcdev_pp_timer'); _ttl=globals().get('_mcdev_pp_ttl')
+ if _timer: _timer.cancel()
+ if _ttl: _ttl.cancel()
+ if not globals()['_mcdev_pp_sampler']['stop'].is_set(): globals()['_mcdev_pp_sampler']['stop'].set(); globals()['_mcdev_pp_stopped']=time.time()
+@STACKS@ globals()['_mcdev_pp_owned']=False; globals()['_mcdev_pp_owner']=None; globals()['_mcdev_pp_timer']=None; globals()['_mcdev_pp_ttl']=None; globals()['_mcdev_pp_sampler']=None)PY";
+        code = replaceToken(std::move(code), "@STACKS@", PythonSamplerStacksCode);
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    // Takes a sampling flight recorder's stacks since its previous drain while the sampler keeps running, and renews
+    // the lease.
+    std::string pythonSamplerDrainCode(std::string_view owner) {
+        std::string code = R"PY(import threading,time
+_mcdev_pp_owner='@OWNER@'
+if globals().get('_mcdev_pp_owner')!=_mcdev_pp_owner or not globals().get('_mcdev_pp_owned',False) or not globals().get('_mcdev_pp_sampler') or globals()['_mcdev_pp_sampler']['stop'].is_set():
+ _result={'ok':False,'reason':'not_owned'}
+else:
+ _ttl=globals().get('_mcdev_pp_ttl')
+ if _ttl: _ttl.cancel()
+@STACKS@ globals()['_mcdev_pp_started']=_end
+ _ttl=threading.Timer(@TTL@,_mcdev_pp_expire); _ttl.daemon=True; _ttl.start(); globals()['_mcdev_pp_ttl']=_ttl)PY";
+        code = replaceToken(std::move(code), "@STACKS@", PythonSamplerStacksCode);
+        code = replaceToken(std::move(code), "@TTL@", std::to_string(RecorderLease.count()));
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    std::string pythonSamplerCleanupCode(std::string_view owner) {
+        std::string code = R"PY(_mcdev_pp_owner='@OWNER@'
+_timer=globals().get('_mcdev_pp_timer'); _ttl=globals().get('_mcdev_pp_ttl'); _state=globals().get('_mcdev_pp_sampler')
+if globals().get('_mcdev_pp_owner')==_mcdev_pp_owner:
+ if _timer: _timer.cancel()
+ if _ttl: _ttl.cancel()
+ if _state: _state['stop'].set()
+ globals()['_mcdev_pp_owned']=False; globals()['_mcdev_pp_owner']=None; globals()['_mcdev_pp_timer']=None; globals()['_mcdev_pp_ttl']=None; globals()['_mcdev_pp_sampler']=None
+_result=True)PY";
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
     std::string pythonMemoryStartCode(const StartRequest& request, std::string_view owner) {
         std::string code = R"PY(import tracemalloc,time,threading
 _mcdev_pm_owner='@OWNER@'
@@ -188,12 +411,28 @@ else:
  if _ttl: _ttl.cancel()
  tracemalloc.start(@DEPTH@)
  globals()['_mcdev_pm_owned']=True; globals()['_mcdev_pm_owner']=_mcdev_pm_owner; globals()['_mcdev_pm_depth']=@DEPTH@
- globals()['_mcdev_pm_started']=time.time(); globals()['_mcdev_pm_base']=tracemalloc.take_snapshot()
+ globals()['_mcdev_pm_started']=time.time(); globals()['_mcdev_pm_base']=tracemalloc.take_snapshot(); globals()['_mcdev_pm_sites']={}
+ def _mcdev_pm_project(_stats):
+  try:
+   import common.minecraftMod as _mod
+   _inst=_mod.instance(); _scripts=set(_n for _n in ((getattr(_inst,'clientScriptNameList',[]) or [])+(getattr(_inst,'serverScriptNameList',[]) or [])) if _n)
+  except: _scripts=[]
+  _all=[]
+  for _s in _stats:
+   _project=False; _origin=(_s.traceback[0].filename or '').replace('\\','/').lower()
+   if 'qumodlibs' in set(_origin.split('/')): continue
+   for _f in _s.traceback:
+    _file=_f.filename or ''; _norm=_file.replace('\\','/').lower(); _parts=set(_norm.split('/'))
+    if any(_n.lower() in _parts or _norm==_n.lower() or _norm.startswith(_n.lower()+'.') for _n in _scripts): _project=True; break
+   if _project: _all.append(_s)
+  _all.sort(key=lambda _s:abs(_s.size_diff),reverse=True)
+  return _all
+ globals()['_mcdev_pm_project']=_mcdev_pm_project
  def _mcdev_pm_expire(_owner=_mcdev_pm_owner):
   try:
    if globals().get('_mcdev_pm_owner')==_owner:
     if globals().get('_mcdev_pm_owned',False) and tracemalloc.is_tracing(): tracemalloc.stop()
-    globals()['_mcdev_pm_owned']=False; globals()['_mcdev_pm_owner']=None; globals()['_mcdev_pm_base']=None
+    globals()['_mcdev_pm_owned']=False; globals()['_mcdev_pm_owner']=None; globals()['_mcdev_pm_base']=None; globals()['_mcdev_pm_sites']=None
   except: pass
  _ttl=threading.Timer(@TTL@,_mcdev_pm_expire); _ttl.daemon=True; _ttl.start(); globals()['_mcdev_pm_ttl']=_ttl
  _result={'ok':True,'depth':@DEPTH@})PY";
@@ -211,25 +450,33 @@ else:
  _ttl=globals().get('_mcdev_pm_ttl')
  if _ttl: _ttl.cancel()
  @GC@
- _base=globals().get('_mcdev_pm_base'); _now=tracemalloc.take_snapshot(); _stats=_now.compare_to(_base,'traceback')
- try:
-  import common.minecraftMod as _mod
-  _inst=_mod.instance(); _scripts=set(_n for _n in ((getattr(_inst,'clientScriptNameList',[]) or [])+(getattr(_inst,'serverScriptNameList',[]) or [])) if _n)
- except: _scripts=[]
- _all=[]
- for _s in _stats:
-  _project=False; _origin=(_s.traceback[0].filename or '').replace('\\','/').lower()
-  if 'qumodlibs' in set(_origin.split('/')): continue
-  for _f in _s.traceback:
-   _file=_f.filename or ''; _norm=_file.replace('\\','/').lower(); _parts=set(_norm.split('/'))
-   if any(_n.lower() in _parts or _norm==_n.lower() or _norm.startswith(_n.lower()+'.') for _n in _scripts): _project=True; break
-  if _project: _all.append(_s)
- _all.sort(key=lambda _s:abs(_s.size_diff),reverse=True); _keep=_all[:512]; _rows=[]
+ _base=globals().get('_mcdev_pm_base'); _now=tracemalloc.take_snapshot(); _all=_mcdev_pm_project(_now.compare_to(_base,'traceback'))
+ _keep=_all[:512]; _rows=[]; _sites=globals().get('_mcdev_pm_sites') or {}
  for _i,_s in enumerate(_keep):
   _frames=[[(_f.filename or '')[:1024],int(_f.lineno or 0)] for _f in _s.traceback]
-  _rows.append([_i,int(_s.size_diff),int(_s.count_diff),int(_s.size),int(_s.count),_frames])
+  _rows.append([_i,int(_s.size_diff),int(_s.count_diff),int(_s.size),int(_s.count),_frames,_sites.setdefault(_s.traceback,len(_sites))])
  _result={'ok':True,'elapsed':max(0,time.time()-globals().get('_mcdev_pm_started',time.time())),'depth':int(globals().get('_mcdev_pm_depth',1)),'sizeDiff':sum(_s.size_diff for _s in _all),'countDiff':sum(_s.count_diff for _s in _all),'size':sum(_s.size for _s in _all),'count':sum(_s.count for _s in _all),'total':len(_all),'truncated':len(_all)>len(_keep),'rows':_rows}
- tracemalloc.stop(); globals()['_mcdev_pm_owned']=False; globals()['_mcdev_pm_owner']=None; globals()['_mcdev_pm_base']=None; globals()['_mcdev_pm_ttl']=None)PY";
+ tracemalloc.stop(); globals()['_mcdev_pm_owned']=False; globals()['_mcdev_pm_owner']=None; globals()['_mcdev_pm_base']=None; globals()['_mcdev_pm_ttl']=None; globals()['_mcdev_pm_sites']=None)PY";
+        code = replaceToken(std::move(code), "@GC@", collectGarbage ? "gc.collect()" : "pass");
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    // One periodic snapshot of a running memory job: the largest project sites by bytes held since the baseline,
+    // under ids kept for the whole job. Frames travel only with a site's first appearance.
+    std::string pythonMemorySnapshotCode(bool collectGarbage, std::string_view owner) {
+        std::string code = R"PY(import tracemalloc,time,gc
+_mcdev_pm_owner='@OWNER@'
+if globals().get('_mcdev_pm_owner')!=_mcdev_pm_owner or not globals().get('_mcdev_pm_owned',False) or not tracemalloc.is_tracing():
+ _result={'ok':False,'reason':'not_owned'}
+else:
+ @GC@
+ _all=_mcdev_pm_project(tracemalloc.take_snapshot().compare_to(globals().get('_mcdev_pm_base'),'traceback')); _sites=globals()['_mcdev_pm_sites']; _rows=[]; _new=[]
+ for _s in _all[:512]:
+  _id=_sites.get(_s.traceback)
+  if _id is None:
+   _id=len(_sites); _sites[_s.traceback]=_id; _new.append([_id,[[(_f.filename or '')[:1024],int(_f.lineno or 0)] for _f in _s.traceback]])
+  _rows.append([_id,int(_s.size_diff),int(_s.count_diff)])
+ _result={'ok':True,'elapsed':max(0,time.time()-globals().get('_mcdev_pm_started',time.time())),'sizeDiff':sum(_s.size_diff for _s in _all),'countDiff':sum(_s.count_diff for _s in _all),'rows':_rows,'sites':_new})PY";
         code = replaceToken(std::move(code), "@GC@", collectGarbage ? "gc.collect()" : "pass");
         return replaceToken(std::move(code), "@OWNER@", owner);
     }
@@ -241,15 +488,110 @@ _ttl=globals().get('_mcdev_pm_ttl')
 if globals().get('_mcdev_pm_owner')==_mcdev_pm_owner:
  if _ttl: _ttl.cancel()
  if globals().get('_mcdev_pm_owned',False) and tracemalloc.is_tracing(): tracemalloc.stop()
- globals()['_mcdev_pm_owned']=False; globals()['_mcdev_pm_owner']=None; globals()['_mcdev_pm_base']=None; globals()['_mcdev_pm_ttl']=None
+ globals()['_mcdev_pm_owned']=False; globals()['_mcdev_pm_owner']=None; globals()['_mcdev_pm_base']=None; globals()['_mcdev_pm_ttl']=None; globals()['_mcdev_pm_sites']=None
+_result=True)PY";
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    // Installs a tick watcher for a trigger or a frame-time job on the side's game thread: a zero-delay timer that
+    // re-arms itself every tick and records the intervals between ticks until the host acknowledges them. It removes
+    // itself once the lease passes undrained.
+    std::string tickWatchStartCode(ProfileTarget side, std::string_view owner) {
+        std::string code = R"PY(import sys,time
+_mcdev_tw_owner='@OWNER@'
+_watch=globals().setdefault('_mcdev_tw',{})
+if _mcdev_tw_owner not in _watch:
+ _clock=getattr(time,'perf_counter',None) or (time.clock if sys.platform=='win32' else time.time)
+ _entry=_watch[_mcdev_tw_owner]={'last':None,'intervals':[],'base':0,'generation':0,'ticks':0,'seen':0,'idle':0,'lease':time.time()+@LEASE@}
+ def _mcdev_tw_tick(_generation,_owner=_mcdev_tw_owner,_entry=_entry,_clock=_clock):
+  if globals().get('_mcdev_tw',{}).get(_owner) is not _entry or _entry['generation']!=_generation: return
+  if time.time()>_entry['lease']:
+   globals()['_mcdev_tw'].pop(_owner,None); return
+  _now=_clock(); _entry['ticks']+=1
+  if _entry['last'] is not None:
+   _entry['intervals'].append((_now-_entry['last'])*1000.0)
+   if len(_entry['intervals'])>8192: del _entry['intervals'][:1024]; _entry['base']+=1024
+  _entry['last']=_now
+  globals()['@COMP@'].AddTimer(0,lambda:_entry['tick'](_generation))
+ _entry['tick']=_mcdev_tw_tick
+ @COMP@.AddTimer(0,lambda _tick=_mcdev_tw_tick:_tick(0))
+_result={'ok':True})PY";
+        code = replaceToken(std::move(code), "@COMP@", side == ProfileTarget::Server ? "_SR_GAME_COMP" : "_CL_GAME_COMP");
+        code = replaceToken(std::move(code), "@LEASE@", std::to_string(RecorderLease.count()));
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    // Drops the intervals before the host's cursor and returns the rest with the index of the first, so a drain
+    // whose reply was lost is delivered again, and renews the lease. Drains run on the watched thread between its
+    // ticks; several in a row without a tick mean the watcher's timer was lost with its game component, so the drain
+    // starts a new generation of it. A spurious restart after a stall is harmless, as the old generation then ends.
+    std::string tickWatchDrainCode(ProfileTarget side, std::string_view owner, std::uint64_t cursor) {
+        std::string code = R"PY(import time
+_entry=globals().get('_mcdev_tw',{}).get('@OWNER@')
+if _entry is None:
+ _result={'ok':False,'reason':'not_watching'}
+else:
+ if _entry['ticks']!=_entry['seen']: _entry['seen']=_entry['ticks']; _entry['idle']=0
+ else: _entry['idle']+=1
+ if _entry['idle']>=3:
+  _entry['generation']+=1; _entry['idle']=0
+  @COMP@.AddTimer(0,lambda _tick=_entry['tick'],_generation=_entry['generation']:_tick(_generation))
+ _skip=max(0,min(@CURSOR@-_entry['base'],len(_entry['intervals'])))
+ del _entry['intervals'][:_skip]; _entry['base']+=_skip; _entry['lease']=time.time()+@LEASE@
+ _result={'ok':True,'first':_entry['base'],'intervals':[round(_value,3) for _value in _entry['intervals']]})PY";
+        code = replaceToken(std::move(code), "@COMP@", side == ProfileTarget::Server ? "_SR_GAME_COMP" : "_CL_GAME_COMP");
+        code = replaceToken(std::move(code), "@CURSOR@", std::to_string(cursor));
+        code = replaceToken(std::move(code), "@LEASE@", std::to_string(RecorderLease.count()));
+        return replaceToken(std::move(code), "@OWNER@", owner);
+    }
+
+    std::string tickWatchStopCode(std::string_view owner) {
+        std::string code = R"PY(globals().get('_mcdev_tw',{}).pop('@OWNER@',None)
 _result=True)PY";
         return replaceToken(std::move(code), "@OWNER@", owner);
     }
 
+    Json triggerContextJson(const TriggerContext& context) {
+        return Json{
+            {"trigger_id", context.triggerId},
+            {"condition", toString(context.condition)},
+            {"detail", context.detail},
+            {"fired_at", context.firedAt},
+        };
+    }
+
+    std::optional<TriggerContext> triggerContextFrom(const Json& manifest) {
+        const auto found = manifest.find("trigger");
+        if (found == manifest.end() || !found->is_object()) return std::nullopt;
+        return TriggerContext{
+            .triggerId = found->value("trigger_id", ""),
+            .condition = found->value("condition", "") == "log_pattern" ? TriggerCondition::LogPattern : TriggerCondition::TickTime,
+            .detail    = found->value("detail", ""),
+            .firedAt   = found->value("fired_at", ""),
+        };
+    }
+
     bool validProfilerPayload(const Json& value) {
         return value.is_object() && value.value("ok", false);
     }
 
+    ProfilerKind kindNamed(std::string_view name) {
+        if (name == "python.memory") return ProfilerKind::PythonMemory;
+        if (name == "native.cpu") return ProfilerKind::NativeCpu;
+        if (name == "frame.time") return ProfilerKind::FrameTime;
+        return ProfilerKind::PythonCpu;
+    }
+
+    // The sides a frame-time job watches, and the tick watcher each one owns.
+    std::vector<ProfileTarget> frameSides(ProfileTarget target) {
+        if (target == ProfileTarget::All) return {ProfileTarget::Server, ProfileTarget::Client};
+        return {target};
+    }
+
+    std::string frameWatcher(std::string_view jobId, ProfileTarget side) {
+        return std::string(jobId) + (side == ProfileTarget::Server ? ".server" : ".client");
+    }
+
     std::string lower(std::string value) {
         std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
             return static_cast<char>(std::tolower(c));
@@ -289,19 +631,6 @@ _result=True)PY";
         return result;
     }
 
-    std::optional<long double> numericFieldValue(const ProfilerField& field) {
-        return std::visit([](const auto& value) -> std::optional<long double> {
-            using Value = std::decay_t<decltype(value)>;
-            if constexpr (std::is_same_v<Value, std::int64_t>) {
-                return static_cast<long double>(value);
-            } else if constexpr (std::is_same_v<Value, double>) {
-                return std::isfinite(value) ? std::optional<long double>(value) : std::nullopt;
-            } else {
-                return std::nullopt;
-            }
-        }, field.value);
-    }
-
     void addField(QueryRecord& record, std::string name, ProfilerFieldValue value, std::string unit = {}) {
         record.fields.emplace(std::move(name), ProfilerField{std::move(value), std::move(unit)});
     }
@@ -312,13 +641,29 @@ _result=True)PY";
         return result;
     }
 
-    std::expected<void, ProfilerError> writeAtomic(const std::filesystem::path& path, std::string_view contents) {
+    // One side of a comparison: the metric summed per identity key, with the first row that carried each key.
+    struct CompareSide {
+        struct Value {
+            long double value = 0;
+            std::string unit;
+            std::optional<std::uint32_t> source;
+        };
+        std::map<std::string, Value> values;
+        std::size_t footprint = 0;
+
+        [[nodiscard]] std::size_t bytes() const noexcept { return footprint; }
+    };
+
+    // Streams an artifact into a temporary sibling and renames it into place, so readers never see a partial file.
+    // Artifacts are committed once; only an index that is rewritten in place may replace an existing file.
+    template <class Write>
+    std::expected<void, ProfilerError> writeAtomicWith(const std::filesystem::path& path, Write&& write, bool replace = false) {
         static std::atomic<std::uint64_t> temporarySequence = 0;
         const auto temporary = path.string() + ".tmp-"
                              + std::to_string(temporarySequence.fetch_add(1, std::memory_order_relaxed));
         std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
         if (!output) return std::unexpected(failure("PERSIST_OPEN_FAILED", "Unable to open a temporary profile artifact."));
-        output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        std::forward<Write>(write)(static_cast<std::ostream&>(output));
         output.flush();
         if (!output) {
             output.close();
@@ -328,7 +673,7 @@ _result=True)PY";
         }
         output.close();
         std::error_code error;
-        if (std::filesystem::exists(path, error)) {
+        if (!replace && std::filesystem::exists(path, error)) {
             std::filesystem::remove(temporary, error);
             return std::unexpected(failure("PERSIST_CONFLICT", "A profile artifact already exists."));
         }
@@ -340,29 +685,32 @@ _result=True)PY";
         return {};
     }
 
-    std::string jsonString(const Json& value, std::string_view key, std::size_t maximum = 4096) {
-        if (!value.is_object() || !value.contains(key) || !value[key].is_string()) return {};
-        auto result = value[key].get<std::string>();
-        if (result.size() > maximum) result.resize(maximum);
-        return result;
+    std::expected<void, ProfilerError>
+    writeAtomic(const std::filesystem::path& path, std::string_view contents, bool replace = false) {
+        return writeAtomicWith(path, [&](std::ostream& output) {
+            output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        }, replace);
     }
 
-    std::int64_t jsonInteger(const Json& value, std::string_view key) {
-        if (!value.is_object() || !value.contains(key) || !value[key].is_number()) return 0;
-        const auto& number = value[key];
-        if (number.is_number_unsigned()) {
-            const auto unsignedValue = number.get<std::uint64_t>();
-            return unsignedValue > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())
-                 ? std::numeric_limits<std::int64_t>::max()
-                 : static_cast<std::int64_t>(unsignedValue);
+    std::uintmax_t directoryBytes(const std::filesystem::path& directory) {
+        std::uintmax_t bytes = 0;
+        std::error_code error;
+        for (std::filesystem::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+            if (it->is_regular_file(error)) bytes += it->file_size(error);
         }
-        if (number.is_number_integer()) return std::max<std::int64_t>(0, number.get<std::int64_t>());
-        return number.get<double>() < 0 ? 0 : static_cast<std::int64_t>(number.get<double>());
+        return bytes;
     }
 
-    double jsonNumber(const Json& value, std::string_view key) {
-        if (!value.is_object() || !value.contains(key) || !value[key].is_number()) return 0;
-        return std::max(0.0, value[key].get<double>());
+    std::expected<ExportResult, ProfilerError> exportedFile(const std::filesystem::path& path) {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+        auto digest = calculateFileSha256(path);
+        if (!digest) return std::unexpected(digest.error());
+        return ExportResult{
+            .path = std::filesystem::absolute(path),
+            .size = error ? 0 : size,
+            .sha256 = std::move(*digest),
+        };
     }
 
 } // namespace
@@ -373,20 +721,52 @@ class DefaultProfilerService final : public ProfilerService {
         StartRequest request;
         Clock::time_point deadline;
         Clock::time_point lastAccess;
+        // The capture window frame-time jobs place their frames in: from the backend start to the deadline, or to an
+        // earlier stop request.
+        Clock::time_point startedAt;
+        Clock::time_point stoppedAt = Clock::time_point::max();
         std::condition_variable condition;
         std::atomic<bool> stopRequested = false;
         std::atomic<bool> discardRequested = false;
-        Json data;
+        std::shared_ptr<const ProfileStore> store; // Guarded by mutex_; requests read it through storeOf().
+        // Guarded by mutex_: a committed disk job whose store is not mapped, because it was dropped under the resident
+        // budget or was recovered from disk and not queried yet; storeOf() maps it.
+        bool evicted = false;
         Json summary;
         std::filesystem::path directory;
         std::filesystem::path temporaryTrace;
         NativeCaptureHandle nativeCapture;
+        std::unique_ptr<FlightRecorder> recorder; // Only for a flight recorder; drains hold recorderMutex.
+        std::mutex recorderMutex;
+        std::thread worker;
+    };
+
+    // One committed disk job as the catalog index records it.
+    struct CatalogEntry {
+        JobSnapshot snapshot;
+        Json summary;
+    };
+
+    struct Trigger {
+        TriggerSnapshot snapshot; // Guarded by mutex_.
+        TriggerRequest request;
+        std::optional<std::regex> pattern;
+        std::condition_variable condition;
+        std::atomic<bool> disarmRequested = false;
+        std::atomic<bool> finished = false;
+        // Watch state, owned by the worker.
+        Clock::time_point cooldownUntil;
+        bool watching = false;
+        std::uint64_t tickCursor = 0; // Intervals received from the watcher so far.
+        std::uint32_t streak = 0;
+        double streakPeak = 0;
+        std::uint64_t logCursor = 0;
         std::thread worker;
     };
 
 public:
     explicit DefaultProfilerService(ProfilerServiceOptions options)
-    : options_(std::move(options)), native_(options_.executableDirectory) {
+    : options_(std::move(options)), native_(options_.executableDirectory), queryCache_(options_.queryCacheBytes) {
         std::error_code error;
         options_.storageRoot = std::filesystem::absolute(options_.storageRoot, error).lexically_normal();
         if (error || options_.storageRoot.empty()) throw std::runtime_error("The profiler storage root is invalid.");
@@ -399,52 +779,8 @@ public:
 
     std::expected<JobSnapshot, ProfilerError> start(const StartRequest& request) override {
         collectExpiredMemoryJobs();
-        if (request.duration < std::chrono::seconds(1) || request.duration > std::chrono::seconds(300)) {
-            return std::unexpected(failure("INVALID_DURATION", "duration_seconds must be between 1 and 300."));
-        }
-        if (request.kind == ProfilerKind::PythonMemory && request.target != ProfileTarget::Client) {
-            return std::unexpected(failure("INVALID_TARGET", "Python memory profiling only supports target=client."));
-        }
-        if (request.tracebackDepth < 1 || request.tracebackDepth > 16) {
-            return std::unexpected(failure("INVALID_TRACEBACK_DEPTH", "traceback_depth must be between 1 and 16."));
-        }
-
-        auto job = std::make_shared<Job>();
-        job->snapshot.id        = makeJobId();
-        job->snapshot.kind      = request.kind;
-        job->snapshot.storage   = request.storage;
-        job->snapshot.state     = JobState::Starting;
-        job->snapshot.createdAt = utcNow();
-        job->request             = request;
-        job->deadline            = Clock::now() + request.duration;
-        job->lastAccess          = monotonicNow();
-        if (request.storage == ProfileStorage::Disk) {
-            job->directory = options_.storageRoot / job->snapshot.id;
-        }
-        job->temporaryTrace      = options_.storageRoot / ".runtime" / job->snapshot.id / "capture.tracy";
-
-        {
-            std::lock_guard lock(mutex_);
-            if (shuttingDown_.load(std::memory_order_acquire)) {
-                return std::unexpected(failure("PROFILER_STOPPED", "The profiler service is shutting down."));
-            }
-            if (active_) return std::unexpected(failure("PROFILER_BUSY", "Another profiler job is active.", true));
-            jobs_.emplace(job->snapshot.id, job);
-            active_ = job;
-        }
-
-        auto started = startBackend(*job);
-        if (!started) {
-            finishFailed(job, started.error());
-            return std::unexpected(started.error());
-        }
-        {
-            std::lock_guard lock(mutex_);
-            job->snapshot.state = JobState::Running;
-            job->snapshot.statusMessage = "Capture is running and will stop at the server deadline.";
-        }
-        job->worker = std::thread([this, job] { runJob(job); });
-        return snapshotOf(job);
+        if (auto valid = validateStart(request); !valid) return std::unexpected(valid.error());
+        return startJob(request, std::nullopt);
     }
 
     std::expected<JobSnapshot, ProfilerError> status(const JobId& id) const override {
@@ -460,7 +796,10 @@ public:
             std::lock_guard lock(mutex_);
             if (job->snapshot.state == JobState::Running || job->snapshot.state == JobState::Starting) {
                 job->stopRequested = true;
-                job->snapshot.statusMessage = "Early stop requested; finalization keeps the capture result.";
+                job->stoppedAt = std::min(job->stoppedAt, Clock::now());
+                job->snapshot.statusMessage = job->recorder
+                    ? "Stop requested; the flight recorder completes with its last window."
+                    : "Early stop requested; finalization keeps the capture result.";
                 if (job->nativeCapture.value) native_.stop(job->nativeCapture);
             }
         }
@@ -471,26 +810,76 @@ public:
     std::expected<void, ProfilerError> discard(const JobId& id) override {
         const auto job = findJob(id);
         if (!job) return std::unexpected(failure("JOB_NOT_FOUND", "Profiler job was not found."));
+        bool cataloged = false;
         {
             std::lock_guard lock(mutex_);
-            if (job->snapshot.state == JobState::Completed || job->snapshot.state == JobState::Failed
-                || job->snapshot.state == JobState::Discarded || job->snapshot.state == JobState::Aborted) {
+            if (isTerminal(job->snapshot.state)) {
+                // Releasing the mapping first lets Windows delete the image unless a request still reads it.
+                job->store.reset();
+                job->evicted = false;
+                queryCache_.eraseJob(id);
                 std::error_code ignored;
                 if (!job->directory.empty()) std::filesystem::remove_all(job->directory, ignored);
                 std::filesystem::remove_all(options_.storageRoot / ".exports" / job->snapshot.id, ignored);
                 job->snapshot.state = JobState::Discarded;
                 job->snapshot.statusMessage = "Capture artifacts were discarded.";
-                return {};
+                cataloged = catalog_.erase(id) > 0;
+            } else {
+                job->discardRequested = true;
+                job->stopRequested = true;
+                job->stoppedAt = std::min(job->stoppedAt, Clock::now());
+                job->snapshot.statusMessage = "Discard requested; backend cleanup is in progress.";
+                if (job->nativeCapture.value) native_.stop(job->nativeCapture);
             }
-            job->discardRequested = true;
-            job->stopRequested = true;
-            job->snapshot.statusMessage = "Discard requested; backend cleanup is in progress.";
-            if (job->nativeCapture.value) native_.stop(job->nativeCapture);
         }
+        if (cataloged) saveCatalog();
         job->condition.notify_all();
         return {};
     }
 
+    std::expected<JobSnapshot, ProfilerError> snapshot(const JobId& id) override {
+        const auto recorder = findJob(id);
+        if (!recorder) return std::unexpected(failure("JOB_NOT_FOUND", "Profiler job was not found."));
+        if (!recorder->recorder) {
+            return std::unexpected(failure("JOB_NOT_RECORDER", "Only flight recorder jobs can be snapshotted."));
+        }
+        if (snapshotOf(recorder).state != JobState::Running) {
+            return std::unexpected(failure("RECORDER_NOT_RUNNING", "The flight recorder is not running."));
+        }
+        // The latest seconds are drained first; a failed drain still freezes what the ring retained.
+        Json window;
+        {
+            std::lock_guard drainLock(recorder->recorderMutex);
+            (void)drainRecorder(*recorder);
+            if (recorder->recorder->segments() == 0) {
+                return std::unexpected(failure("RECORDER_EMPTY", "The flight recorder has not retained any data yet.", true));
+            }
+            window = recorder->recorder->merged();
+        }
+        window["recorder"]["source_job_id"] = recorder->snapshot.id;
+
+        auto job = std::make_shared<Job>();
+        job->snapshot.id        = makeJobId();
+        job->snapshot.kind      = recorder->request.kind;
+        job->snapshot.storage   = recorder->request.storage;
+        job->snapshot.state     = JobState::Finalizing;
+        job->snapshot.createdAt = utcNow();
+        job->request            = recorder->request;
+        job->request.mode       = ProfileMode::Capture;
+        job->lastAccess         = monotonicNow();
+        if (job->request.storage == ProfileStorage::Disk) job->directory = options_.storageRoot / job->snapshot.id;
+        job->temporaryTrace = options_.storageRoot / ".runtime" / job->snapshot.id / "capture.tracy";
+        {
+            std::lock_guard lock(mutex_);
+            if (shuttingDown_.load(std::memory_order_acquire)) {
+                return std::unexpected(failure("PROFILER_STOPPED", "The profiler service is shutting down."));
+            }
+            jobs_.emplace(job->snapshot.id, job);
+        }
+        commitCapture(job, window);
+        return snapshotOf(job);
+    }
+
     std::expected<QueryPage, ProfilerError> query(const QueryRequest& request) const override {
         const auto job = findJob(request.jobId);
         if (!job) return std::unexpected(failure("JOB_NOT_FOUND", "Profiler job was not found."));
@@ -498,45 +887,24 @@ public:
         if (snapshot.state != JobState::Completed) {
             return std::unexpected(failure("JOB_NOT_QUERYABLE", "Profiler results are queryable only after completion.", true));
         }
-        auto records = recordsFor(*job, request.view);
-        if (!records) return std::unexpected(records.error());
-        const auto filter = request.filter ? lower(*request.filter) : std::string{};
-        if (request.view == "calltree-children") {
-            if (filter.empty()) {
-                return std::unexpected(failure(
-                    "CALLTREE_PARENT_REQUIRED",
-                    "calltree-children requires filter to be one complete parent node id."
-                ));
-            }
-            std::erase_if(*records, [&](const QueryRecord& record) {
-                const auto parent = record.fields.find("parent_id");
-                return parent == record.fields.end() || lower(fieldText(parent->second)) != filter;
-            });
-        } else if (!filter.empty()) {
-            std::erase_if(*records, [&](const QueryRecord& record) {
-                if (lower(record.id).find(filter) != std::string::npos) return false;
-                for (const auto& [name, field] : record.fields) {
-                    if (lower(name + " " + fieldText(field)).find(filter) != std::string::npos) return false;
-                }
-                return true;
-            });
+        const auto loaded = storeOf(job);
+        if (!loaded) return std::unexpected(loaded.error());
+        const auto& profile = *loaded;
+        const auto* view = viewFor(profile.get(), request.view);
+        if (!view) return std::unexpected(viewInvalid());
+        const auto& store = *profile;
+        // Call-tree children are addressed by their parent id; every other view accepts a filter expression.
+        std::expected<std::optional<FilterExpression>, ProfilerError> expression = std::nullopt;
+        if (request.view != "calltree-children" && request.filter) expression = FilterExpression::parse(*request.filter);
+        if (!expression) return std::unexpected(expression.error());
+        const auto filter = !request.filter ? std::string{} : *expression ? *request.filter : lower(*request.filter);
+        if (request.view == "calltree-children" && filter.empty()) {
+            return std::unexpected(failure(
+                "CALLTREE_PARENT_REQUIRED",
+                "calltree-children requires filter to be one complete parent node id."
+            ));
         }
-        const auto sortField = request.sort.empty() ? defaultSort(request.view) : request.sort;
-        std::stable_sort(records->begin(), records->end(), [&](const QueryRecord& left, const QueryRecord& right) {
-            const auto l = left.fields.find(sortField);
-            const auto r = right.fields.find(sortField);
-            if (l == left.fields.end() || r == right.fields.end()) {
-                if (l == left.fields.end() && r == right.fields.end()) return false;
-                return request.descending ? l != left.fields.end() : l == left.fields.end();
-            }
-            const auto ln = numericFieldValue(l->second);
-            const auto rn = numericFieldValue(r->second);
-            if (ln && rn) return request.descending ? *ln > *rn : *ln < *rn;
-            const auto lv = fieldText(l->second);
-            const auto rv = fieldText(r->second);
-            return request.descending ? lv > rv : lv < rv;
-        });
-
+        const auto sortField = request.sort.empty() ? defaultSort(job->request.kind, request.view) : request.sort;
         const auto binding = request.jobId + "|" + request.view + "|" + filter + "|" + sortField
                            + (request.descending ? "|desc" : "|asc");
         std::size_t offset = 0;
@@ -551,24 +919,55 @@ public:
                 return std::unexpected(failure("CURSOR_INVALID", "Cursor offset is invalid."));
             }
         }
-        if (offset > records->size()) {
+
+        // Every page of one query shares the filtered, sorted index, so a cursor resumes without sorting again. A
+        // first page only selects the largest page the service returns; the first cursor orders the rest.
+        const auto cacheKey = QueryCache::key(
+            request.jobId, {"query", request.view, filter, sortField, request.descending ? "desc" : "asc"}
+        );
+        auto ordered = queryCache_.find<RowIndex>(cacheKey, profile);
+        if (!ordered || (offset > 0 && !ordered->complete())) {
+            RowIndex index;
+            if (request.view == "calltree-children") {
+                const auto* parent = store.column(*view, "parent_id");
+                for (const auto row : view->rows) {
+                    if (parent && parent->has(row) && lower(cellText(store, *parent, row)) == filter) {
+                        index.rows.push_back(row);
+                    }
+                }
+            } else if (*expression) {
+                auto selected = (*expression)->select(store, *view);
+                if (!selected) return std::unexpected(selected.error());
+                index.rows = std::move(*selected);
+            } else {
+                index.rows = filterRows(store, *view, filter);
+            }
+            index.total = index.rows.size();
+            if (offset == 0) selectTopRows(store, *view, index.rows, sortField, request.descending, MaximumQueryRecords);
+            else sortRows(store, *view, index.rows, sortField, request.descending);
+            index.rows.shrink_to_fit();
+            ordered = queryCache_.insert(cacheKey, profile, std::move(index));
+        }
+        const auto& rows = ordered->rows;
+        if (offset > ordered->total) {
             return std::unexpected(failure("CURSOR_INVALID", "Cursor offset exceeds the available result set."));
         }
         QueryPage page;
-        page.totalAvailable = records->size();
+        page.totalAvailable = ordered->total;
         const auto limit = std::clamp<std::size_t>(request.limit, 1, MaximumQueryRecords);
         std::size_t bytes = 0;
-        for (std::size_t index = offset; index < records->size() && page.records.size() < limit; ++index) {
-            const auto estimate = recordBytes((*records)[index]);
+        for (std::size_t index = offset; index < rows.size() && page.records.size() < limit; ++index) {
+            auto record = materializeRecord(store, *view, rows[index]);
+            const auto estimate = recordBytes(record);
             if (page.records.empty() && estimate > MaximumQueryBytes) {
                 return std::unexpected(failure("QUERY_RECORD_TOO_LARGE", "A profiler record exceeds the query response budget."));
             }
             if (!page.records.empty() && bytes + estimate > MaximumQueryBytes) break;
             bytes += estimate;
-            page.records.push_back(std::move((*records)[index]));
+            page.records.push_back(std::move(record));
         }
         const auto consumed = offset + page.records.size();
-        page.truncated = consumed < records->size();
+        page.truncated = consumed < ordered->total;
         if (page.truncated) page.nextCursor = cursorSignature(binding) + ':' + std::to_string(consumed);
         return page;
     }
@@ -585,127 +984,84 @@ public:
         if (baseline->request.kind != candidate->request.kind) {
             return std::unexpected(failure("COMPARE_KIND_MISMATCH", "Profiler comparison requires two jobs of the same kind."));
         }
-        if ((baseline->request.kind == ProfilerKind::PythonCpu && request.view != "hotspots")
-            || (baseline->request.kind == ProfilerKind::PythonMemory
-                && request.view != "growth" && request.view != "retained")
-            || (baseline->request.kind == ProfilerKind::NativeCpu
-                && request.view != "hotspots" && request.view != "source-locations" && request.view != "threads")) {
-            return std::unexpected(failure(
-                "COMPARE_VIEW_INVALID",
-                "This view has no stable cross-capture identity. Compare hotspots, growth, retained, source-locations, or threads as appropriate."
-            ));
-        }
-
-        auto baselineRecords = recordsFor(*baseline, request.view);
-        auto candidateRecords = recordsFor(*candidate, request.view);
-        if (!baselineRecords) return std::unexpected(baselineRecords.error());
-        if (!candidateRecords) return std::unexpected(candidateRecords.error());
-        const auto metric = request.metric.empty() ? defaultSort(request.view) : request.metric;
-        const auto metricAllowed = [&] {
-            if (baseline->request.kind == ProfilerKind::PythonCpu) {
-                return metric == "calls" || metric == "actual_calls" || metric == "self_time"
-                    || metric == "total_time";
-            }
-            if (baseline->request.kind == ProfilerKind::PythonMemory) {
-                if (request.view == "growth") {
-                    return metric == "size_diff" || metric == "count_diff" || metric == "current_size"
-                        || metric == "current_count";
-                }
-                return metric == "current_size" || metric == "current_count";
-            }
-            if (request.view == "threads") return metric == "calls" || metric == "total_time";
-            return metric == "calls" || metric == "total_time" || metric == "self_time"
-                || metric == "mean_time" || metric == "maximum_time";
-        };
-        if (!metricAllowed()) {
-            return std::unexpected(failure(
-                "COMPARE_METRIC_INVALID",
-                "The requested metric is not a comparable performance metric for this profiler view."
-            ));
+        const auto kind = baseline->request.kind;
+        if (!comparableView(kind, request.view)) return std::unexpected(compareViewInvalid());
+
+        const auto baselineLoaded = storeOf(baseline);
+        if (!baselineLoaded) return std::unexpected(baselineLoaded.error());
+        const auto candidateLoaded = storeOf(candidate);
+        if (!candidateLoaded) return std::unexpected(candidateLoaded.error());
+        const auto& baselineStore = *baselineLoaded;
+        const auto& candidateStore = *candidateLoaded;
+        const auto* baselineView = viewFor(baselineStore.get(), request.view);
+        const auto* candidateView = viewFor(candidateStore.get(), request.view);
+        if (!baselineView || !candidateView) return std::unexpected(viewInvalid());
+        const auto metric = request.metric.empty() ? defaultSort(kind, request.view) : request.metric;
+        if (!comparableMetric(kind, request.view, metric)) return std::unexpected(compareMetricInvalid());
+
+        const auto baselineSide = compareSide(request.baselineJobId, baselineStore, *baselineView, metric);
+        const auto candidateSide = compareSide(request.candidateJobId, candidateStore, *candidateView, metric);
+        const auto& before = baselineSide->values;
+        const auto& after = candidateSide->values;
+        if (before.empty() && after.empty()) {
+            return std::unexpected(failure("COMPARE_METRIC_INVALID", "The requested metric is not numeric or is absent from this view."));
         }
 
-        const auto valueOf = [](const QueryRecord& record, std::string_view name) -> const ProfilerField* {
-            const auto found = record.fields.find(std::string(name));
-            return found == record.fields.end() ? nullptr : &found->second;
-        };
-        const auto stableKey = [&](const QueryRecord& record) {
-            const auto join = [&](std::initializer_list<std::string_view> names) {
-                std::string key;
-                for (const auto name : names) {
-                    key.push_back('\x1f');
-                    if (const auto* field = valueOf(record, name)) key += fieldText(*field);
-                }
-                return key;
-            };
-            if (baseline->request.kind == ProfilerKind::PythonCpu) {
-                return join({"target", "module", "line", "name", "context_name"});
-            }
-            if (baseline->request.kind == ProfilerKind::PythonMemory) return join({"traceback"});
-            if (request.view == "threads") return join({"name"});
-            if (request.view == "source-locations") return join({"name", "source_file", "source_line"});
-            return join({"name", "source_file", "source_line", "thread_name"});
-        };
-
-        struct SideValue {
-            long double value = 0;
-            std::string unit;
-            const QueryRecord* source = nullptr;
-        };
-        const auto collect = [&](const std::vector<QueryRecord>& records) {
-            std::map<std::string, SideValue> values;
-            for (const auto& record : records) {
-                const auto* field = valueOf(record, metric);
-                if (!field) continue;
-                const auto numeric = numericFieldValue(*field);
-                if (!numeric) continue;
-                auto& value = values[stableKey(record)];
-                value.value += *numeric;
-                value.unit = field->unit;
-                if (!value.source) value.source = &record;
-            }
-            return values;
-        };
-        const auto before = collect(*baselineRecords);
-        const auto after = collect(*candidateRecords);
-        if (before.empty() && after.empty()) {
-            return std::unexpected(failure("COMPARE_METRIC_INVALID", "The requested metric is not numeric or is absent from this view."));
-        }
-
-        struct Difference {
-            QueryRecord record;
-            long double magnitude = 0;
+        // Both sides are ordered by key, so one merge pass classifies every key. Only the differences that can reach
+        // the response are materialized.
+        struct Difference {
+            const CompareSide::Value* left = nullptr;
+            const CompareSide::Value* right = nullptr;
+            long double magnitude = 0;
+            std::size_t position = 0; // Key order.
         };
         std::vector<Difference> differences;
-        std::set<std::string> keys;
-        for (const auto& [key, ignored] : before) { (void)ignored; keys.insert(key); }
-        for (const auto& [key, ignored] : after) { (void)ignored; keys.insert(key); }
         CompareResult result;
         result.metric = metric;
-        static constexpr std::array<std::string_view, 10> IdentityFields = {
-            "name", "module", "line", "target", "context_name",
-            "source_file", "source_line", "thread_name", "thread_count", "traceback"
-        };
-        for (const auto& key : keys) {
-            const auto left = before.find(key);
-            const auto right = after.find(key);
-            const bool hasLeft = left != before.end();
-            const bool hasRight = right != after.end();
-            if (hasLeft && hasRight) ++result.matched;
-            else if (hasRight) ++result.added;
-            else ++result.removed;
-            const auto baselineValue = hasLeft ? left->second.value : 0.0L;
-            const auto candidateValue = hasRight ? right->second.value : 0.0L;
+        for (auto left = before.begin(), right = after.begin(); left != before.end() || right != after.end();) {
+            Difference difference;
+            if (right == after.end() || (left != before.end() && left->first < right->first)) {
+                difference.left = &(left++)->second;
+                ++result.removed;
+            } else if (left == before.end() || right->first < left->first) {
+                difference.right = &(right++)->second;
+                ++result.added;
+            } else {
+                difference.left = &(left++)->second;
+                difference.right = &(right++)->second;
+                ++result.matched;
+            }
+            const auto delta = (difference.right ? difference.right->value : 0.0L)
+                             - (difference.left ? difference.left->value : 0.0L);
+            difference.magnitude = std::abs(delta);
+            difference.position = differences.size();
+            if (delta != 0) differences.push_back(difference);
+        }
+        const auto limit = std::clamp<std::size_t>(request.limit, 1, MaximumQueryRecords);
+        // Equal magnitudes keep key order, as a stable sort of every difference would.
+        const auto selected = std::min(limit, differences.size());
+        std::partial_sort(
+            differences.begin(), differences.begin() + static_cast<std::ptrdiff_t>(selected), differences.end(),
+            [&](const Difference& left, const Difference& right) {
+                if (left.magnitude != right.magnitude) return left.magnitude > right.magnitude;
+                return left.position < right.position;
+            }
+        );
+        std::size_t bytes = 0;
+        for (std::size_t index = 0; index < selected; ++index) {
+            const auto& difference = differences[index];
+            const bool hasLeft = difference.left != nullptr;
+            const bool hasRight = difference.right != nullptr;
+            const auto baselineValue = hasLeft ? difference.left->value : 0.0L;
+            const auto candidateValue = hasRight ? difference.right->value : 0.0L;
             const auto delta = candidateValue - baselineValue;
-            const auto* source = hasRight ? right->second.source : left->second.source;
-            const auto unit = hasRight ? right->second.unit : left->second.unit;
+            const auto source = hasRight ? difference.right->source : difference.left->source;
+            const auto& sourceStore = hasRight ? *candidateStore : *baselineStore;
+            const auto& sourceView = hasRight ? *candidateView : *baselineView;
+            const auto& unit = hasRight ? difference.right->unit : difference.left->unit;
             QueryRecord record;
-            if (source) {
-                for (const auto fieldName : IdentityFields) {
-                    if (const auto found = source->fields.find(std::string(fieldName)); found != source->fields.end()) {
-                        record.fields.emplace(found->first, found->second);
-                    }
-                }
-            }
+            record.id = "diff:" + std::to_string(result.records.size());
+            if (source) addIdentityFields(record, sourceStore, sourceView, *source);
             addField(record, "change", hasLeft && hasRight ? "matched" : hasRight ? "added" : "removed");
             addField(record, "baseline", static_cast<double>(baselineValue), unit);
             addField(record, "candidate", static_cast<double>(candidateValue), unit);
@@ -713,17 +1069,8 @@ public:
             if (baselineValue != 0) {
                 addField(record, "delta_percent", static_cast<double>(delta / std::abs(baselineValue) * 100.0L), "percent");
             }
-            if (delta != 0) differences.push_back({std::move(record), std::abs(delta)});
-        }
-        std::stable_sort(differences.begin(), differences.end(), [](const auto& left, const auto& right) {
-            return left.magnitude > right.magnitude;
-        });
-        const auto limit = std::clamp<std::size_t>(request.limit, 1, MaximumQueryRecords);
-        std::size_t bytes = 0;
-        for (auto& difference : differences) {
-            difference.record.id = "diff:" + std::to_string(result.records.size());
-            const auto estimate = recordBytes(difference.record);
-            if (result.records.size() >= limit || (!result.records.empty() && bytes + estimate > MaximumQueryBytes)) {
+            const auto estimate = recordBytes(record);
+            if (!result.records.empty() && bytes + estimate > MaximumQueryBytes) {
                 result.truncated = true;
                 break;
             }
@@ -731,66 +1078,249 @@ public:
                 return std::unexpected(failure("COMPARE_RECORD_TOO_LARGE", "A comparison record exceeds the response budget."));
             }
             bytes += estimate;
-            result.records.push_back(std::move(difference.record));
+            result.records.push_back(std::move(record));
         }
         result.truncated = result.truncated || result.records.size() < differences.size();
         return result;
     }
 
+    std::expected<TrendResult, ProfilerError> trend(const TrendRequest& request) const override {
+        if (request.runs < 3 || request.runs > MaximumTrendRuns) {
+            return std::unexpected(failure("TREND_RUNS_INVALID", "A trend covers 3 to 50 runs."));
+        }
+        if (request.candidateRuns < 1 || request.candidateRuns + 2 > request.runs) {
+            return std::unexpected(failure("TREND_RUNS_INVALID", "Candidate runs must leave at least two baseline runs."));
+        }
+        if (!(request.thresholdPercent >= 0 && request.thresholdPercent <= 1000)
+            || !(request.significance > 0 && request.significance <= 0.5)) {
+            return std::unexpected(failure("TREND_THRESHOLD_INVALID", "The threshold or significance level is out of range."));
+        }
+        if (!comparableView(request.kind, request.view)) return std::unexpected(compareViewInvalid());
+        const auto metric = request.metric.empty() ? defaultSort(request.kind, request.view) : request.metric;
+        if (!comparableMetric(request.kind, request.view, metric)) return std::unexpected(compareMetricInvalid());
+
+        // The catalog comes from its index alone. Only the runs taken are mapped, and each folded side stays cached,
+        // so a trend repeated after one more run folds only that run.
+        struct Run {
+            JobId id;
+            std::shared_ptr<const ProfileStore> store;
+            const ProfileView* view = nullptr;
+            std::shared_ptr<const CompareSide> side;
+        };
+        std::vector<Run> runs;
+        for (const auto& snapshot : catalog()) {
+            if (runs.size() == request.runs) break;
+            if (snapshot.kind != request.kind || snapshot.state != JobState::Completed || snapshot.partial) continue;
+            const auto job = findJob(snapshot.id);
+            // A run whose profile cannot be loaded is left out like one without the view.
+            auto store = job ? storeOf(job).value_or(nullptr) : nullptr;
+            const auto* view = viewFor(store.get(), request.view);
+            if (!view) continue;
+            auto side = compareSide(snapshot.id, store, *view, metric);
+            runs.push_back({snapshot.id, std::move(store), view, std::move(side)});
+        }
+        if (runs.size() < request.candidateRuns + 2) {
+            return std::unexpected(failure(
+                "TREND_RUNS_INSUFFICIENT",
+                "Only " + std::to_string(runs.size()) + " committed " + toString(request.kind)
+                    + " jobs are in history; this trend needs at least " + std::to_string(request.candidateRuns + 2) + '.',
+                true
+            ));
+        }
+        std::reverse(runs.begin(), runs.end());
+
+        struct Series {
+            std::vector<double> baseline;
+            std::vector<double> candidate;
+            std::size_t run = 0; // The newest run that has the identity supplies its fields.
+            std::optional<std::uint32_t> source;
+            std::string_view unit;
+        };
+        std::map<std::string_view, Series> series;
+        const auto firstCandidate = runs.size() - request.candidateRuns;
+        for (std::size_t index = 0; index < runs.size(); ++index) {
+            for (const auto& [key, value] : runs[index].side->values) {
+                auto& entry = series[key];
+                (index < firstCandidate ? entry.baseline : entry.candidate).push_back(static_cast<double>(value.value));
+                entry.run = index;
+                entry.source = value.source;
+                entry.unit = value.unit;
+            }
+        }
+        if (series.empty()) {
+            return std::unexpected(failure("COMPARE_METRIC_INVALID", "The requested metric is not numeric or is absent from this view."));
+        }
+
+        // A run without an identity did not measure it; it is left out of that identity's statistics.
+        struct Verdict {
+            const Series* series = nullptr;
+            std::optional<TrendTest> test;
+            std::string_view name;
+            int rank = 0;
+            double baselineMean = 0;
+            double candidateMean = 0;
+            long double magnitude = 0;
+            std::size_t position = 0; // Key order.
+        };
+        const auto mean = [](const std::vector<double>& values) {
+            return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+        };
+        TrendResult result{.metric = metric, .series = series.size()};
+        std::vector<Verdict> verdicts;
+        verdicts.reserve(series.size());
+        for (const auto& [key, entry] : series) {
+            Verdict verdict{.series = &entry, .test = trendTest(entry.baseline, entry.candidate), .position = verdicts.size()};
+            verdict.baselineMean = verdict.test ? verdict.test->baselineMean : mean(entry.baseline);
+            verdict.candidateMean = verdict.test ? verdict.test->candidateMean : mean(entry.candidate);
+            const auto delta = verdict.candidateMean - verdict.baselineMean;
+            verdict.magnitude = std::abs(static_cast<long double>(delta));
+            if (entry.baseline.empty()) {
+                verdict.name = "added";
+                verdict.rank = 2;
+            } else if (entry.candidate.empty()) {
+                verdict.name = "removed";
+                verdict.rank = 3;
+            } else if (!verdict.test) {
+                verdict.name = "insufficient";
+                verdict.rank = 5;
+            } else {
+                // Every comparable metric is a cost, so a significant rise past the threshold is a regression.
+                const auto percent = verdict.baselineMean != 0
+                                   ? delta / std::abs(verdict.baselineMean) * 100.0
+                                   : delta * std::numeric_limits<double>::infinity();
+                const bool significant = verdict.test->pValue <= request.significance;
+                if (significant && delta > 0 && percent >= request.thresholdPercent) {
+                    verdict.name = "regressed";
+                    verdict.rank = 0;
+                    ++result.regressed;
+                } else if (significant && delta < 0 && -percent >= request.thresholdPercent) {
+                    verdict.name = "improved";
+                    verdict.rank = 1;
+                    ++result.improved;
+                } else {
+                    verdict.name = "stable";
+                    verdict.rank = 4;
+                }
+            }
+            verdicts.push_back(verdict);
+        }
+        const auto limit = std::clamp<std::size_t>(request.limit, 1, MaximumQueryRecords);
+        const auto selected = std::min(limit, verdicts.size());
+        std::partial_sort(
+            verdicts.begin(), verdicts.begin() + static_cast<std::ptrdiff_t>(selected), verdicts.end(),
+            [](const Verdict& left, const Verdict& right) {
+                if (left.rank != right.rank) return left.rank < right.rank;
+                if (left.magnitude != right.magnitude) return left.magnitude > right.magnitude;
+                return left.position < right.position;
+            }
+        );
+        for (const auto& run : runs) result.jobIds.push_back(run.id);
+        std::size_t bytes = 0;
+        for (std::size_t index = 0; index < selected; ++index) {
+            const auto& verdict = verdicts[index];
+            const auto& entry = *verdict.series;
+            const std::string unit(entry.unit);
+            QueryRecord record;
+            record.id = "trend:" + std::to_string(result.records.size());
+            if (entry.source) addIdentityFields(record, *runs[entry.run].store, *runs[entry.run].view, *entry.source);
+            addField(record, "verdict", std::string(verdict.name));
+            addField(record, "runs", static_cast<std::int64_t>(entry.baseline.size() + entry.candidate.size()));
+            if (!entry.baseline.empty()) addField(record, "baseline_mean", verdict.baselineMean, unit);
+            if (!entry.candidate.empty()) addField(record, "candidate_mean", verdict.candidateMean, unit);
+            addField(record, "delta", verdict.candidateMean - verdict.baselineMean, unit);
+            if (!entry.baseline.empty() && !entry.candidate.empty() && verdict.baselineMean != 0) {
+                addField(
+                    record, "delta_percent",
+                    (verdict.candidateMean - verdict.baselineMean) / std::abs(verdict.baselineMean) * 100.0, "percent"
+                );
+            }
+            if (verdict.test) {
+                // Variances are in the metric's unit squared.
+                const auto squared = unit.empty() ? std::string{} : unit + "^2";
+                addField(record, "baseline_variance", verdict.test->baselineVariance, squared);
+                if (verdict.test->candidateRuns > 1) addField(record, "candidate_variance", verdict.test->candidateVariance, squared);
+                if (std::isfinite(verdict.test->t)) addField(record, "t", verdict.test->t);
+                addField(record, "p_value", verdict.test->pValue);
+            }
+            const auto estimate = recordBytes(record);
+            if (!result.records.empty() && bytes + estimate > MaximumQueryBytes) break;
+            if (result.records.empty() && estimate > MaximumQueryBytes) {
+                return std::unexpected(failure("TREND_RECORD_TOO_LARGE", "A trend record exceeds the response budget."));
+            }
+            bytes += estimate;
+            result.records.push_back(std::move(record));
+        }
+        result.truncated = result.records.size() < verdicts.size();
+        return result;
+    }
+
     std::expected<DetailResult, ProfilerError> detail(const DetailRequest& request) const override {
         const auto job = findJob(request.jobId);
         if (!job) return std::unexpected(failure("JOB_NOT_FOUND", "Profiler job was not found."));
         if (snapshotOf(job).state != JobState::Completed) {
             return std::unexpected(failure("JOB_NOT_QUERYABLE", "Profiler details are available only after completion.", true));
         }
-        auto records = recordsFor(*job, request.view);
-        if (!records) return std::unexpected(records.error());
-        const auto found = std::find_if(records->begin(), records->end(), [&](const auto& record) {
-            return record.id == request.recordId;
-        });
-        if (found == records->end()) return std::unexpected(failure("RECORD_NOT_FOUND", "Profile record was not found."));
-        DetailResult result{.record = *found};
+        const auto loaded = storeOf(job);
+        if (!loaded) return std::unexpected(loaded.error());
+        const auto& profile = *loaded;
+        const auto* view = viewFor(profile.get(), request.view);
+        if (!view) return std::unexpected(viewInvalid());
+        const auto& store = *profile;
+        const auto& table = store.tableOf(*view);
+        const auto recordId = store.strings.find(request.recordId);
+        const auto recordIds = [&](std::uint32_t row) { return table.ids[row]; };
+        // Equal ids keep view order in the index, so the first match is the row a scan of the view finds first.
+        const auto matches = recordId ? rowsWithText(*rowsByText(request.jobId, profile, *view, ""), recordIds, *recordId)
+                                      : std::span<const std::uint32_t>{};
+        if (matches.empty()) return std::unexpected(failure("RECORD_NOT_FOUND", "Profile record was not found."));
+        const auto found = matches.front();
+        DetailResult result{.record = materializeRecord(store, *view, found)};
         std::size_t bytes = recordBytes(result.record);
         if (bytes > MaximumQueryBytes) {
             return std::unexpected(failure("DETAIL_RECORD_TOO_LARGE", "The requested record exceeds the detail response budget."));
         }
         if (request.view != "calltree-roots" && request.view != "calltree-children") return result;
 
-        auto relationRecords = recordsFor(*job, "calltree-children");
-        if (!relationRecords) return std::unexpected(relationRecords.error());
-        const auto parent = found->fields.find("parent_id");
-        const auto selectedParent = parent == found->fields.end() ? std::string{} : fieldText(parent->second);
-        const auto selectedThreadField = found->fields.find("thread_id");
-        const auto selectedThread = selectedThreadField == found->fields.end()
-                                ? std::string{} : fieldText(selectedThreadField->second);
-        const auto appendRelated = [&](const QueryRecord& record) {
+        // Node ids, parent ids and thread ids share the string table, so relations are integer comparisons. An
+        // allocation tree has no threads, so every node under the same parent is a sibling.
+        const auto* relations = viewFor(profile.get(), "calltree-children");
+        if (!relations) return std::unexpected(viewInvalid());
+        const auto* parentColumn = store.column(*relations, "parent_id");
+        const auto* threadColumn = store.column(*relations, "thread_id");
+        if (!parentColumn) return result;
+        const auto emptyId = store.strings.find("");
+        const auto selectedParent = parentColumn->text(found);
+        const bool hasParent = !emptyId || selectedParent != *emptyId;
+        const auto selectedThread = threadColumn ? threadColumn->text(found) : StringId{0};
+        const auto appendRelated = [&](std::uint32_t row) {
             if (result.related.size() == 20) {
                 result.truncated = true;
                 return false;
             }
+            auto record = materializeRecord(store, *relations, row);
             const auto estimate = recordBytes(record);
             if (bytes + estimate > MaximumQueryBytes) {
                 result.truncated = true;
                 return false;
             }
             bytes += estimate;
-            result.related.push_back(record);
+            result.related.push_back(std::move(record));
             return true;
         };
-        for (int relation = 0; relation < 3 && !result.truncated; ++relation) {
-            for (const auto& record : *relationRecords) {
-                if (record.id == request.recordId) continue;
-                const auto candidateParentField = record.fields.find("parent_id");
-                const auto candidateParent = candidateParentField == record.fields.end()
-                                         ? std::string{} : fieldText(candidateParentField->second);
-                const auto candidateThreadField = record.fields.find("thread_id");
-                const auto candidateThread = candidateThreadField == record.fields.end()
-                                         ? std::string{} : fieldText(candidateThreadField->second);
-                const bool isParent = relation == 0 && !selectedParent.empty() && record.id == selectedParent;
-                const bool isChild = relation == 1 && candidateParent == request.recordId;
-                const bool isSibling = relation == 2 && !selectedParent.empty()
-                    && candidateParent == selectedParent && candidateThread == selectedThread;
-                if ((isParent || isChild || isSibling) && !appendRelated(record)) break;
+        // Parents come from the id index and children and siblings from the parent index, each in view order.
+        const auto relationIds = rowsByText(request.jobId, profile, *relations, "");
+        const auto byParent = rowsByText(request.jobId, profile, *relations, "parent_id");
+        const auto parentIds = [&](std::uint32_t row) { return parentColumn->text(row); };
+        const auto groups = std::array{
+            hasParent ? rowsWithText(*relationIds, recordIds, selectedParent) : std::span<const std::uint32_t>{},
+            rowsWithText(*byParent, parentIds, *recordId),
+            hasParent ? rowsWithText(*byParent, parentIds, selectedParent) : std::span<const std::uint32_t>{},
+        };
+        for (std::size_t relation = 0; relation < groups.size() && !result.truncated; ++relation) {
+            for (const auto row : groups[relation]) {
+                if (table.ids[row] == *recordId) continue;
+                if (relation == 2 && threadColumn && threadColumn->text(row) != selectedThread) continue;
+                if (!appendRelated(row)) break;
             }
         }
         return result;
@@ -798,20 +1328,7 @@ public:
 
     std::expected<HistoryPage, ProfilerError> history(const HistoryRequest& request) const override {
         collectExpiredMemoryJobs();
-        scanHistoryOnce();
-        std::vector<JobSnapshot> values;
-        {
-            std::lock_guard lock(mutex_);
-            values = historyCache_;
-            for (const auto& [id, job] : jobs_) {
-                if (job->request.storage != ProfileStorage::Disk) continue;
-                const auto snapshot = job->snapshot;
-                const auto existing = std::find_if(values.begin(), values.end(), [&](const auto& item) { return item.id == id; });
-                if (existing == values.end()) values.push_back(snapshot);
-                else *existing = snapshot;
-            }
-        }
-        std::sort(values.begin(), values.end(), [](const auto& left, const auto& right) { return left.createdAt > right.createdAt; });
+        const auto values = catalog();
         std::size_t offset = 0;
         if (request.cursor) {
             const auto [pointer, error] = std::from_chars(
@@ -837,17 +1354,66 @@ public:
         if (snapshotOf(job).state != JobState::Completed) {
             return std::unexpected(failure("JOB_NOT_EXPORTABLE", "Only completed jobs can be exported.", true));
         }
+        const auto loaded = storeOf(job);
+        if (!loaded) return std::unexpected(loaded.error());
+        const auto& profile = *loaded;
+        if (!profile) return std::unexpected(failure("JOB_NOT_EXPORTABLE", "Only completed jobs can be exported.", true));
+        if (request.format == ExportFormat::ChromeTrace && job->request.kind != ProfilerKind::NativeCpu) {
+            return std::unexpected(failure("EXPORT_FORMAT_UNSUPPORTED", "Chrome trace export needs a Native CPU job."));
+        }
+        if (job->request.kind == ProfilerKind::FrameTime
+            && (request.format == ExportFormat::Folded || request.format == ExportFormat::FlameGraph
+                || request.format == ExportFormat::Pprof)) {
+            return std::unexpected(failure("EXPORT_FORMAT_UNSUPPORTED", "Frame-time jobs have no stacks; export markdown, svg or json."));
+        }
         const bool svg = request.format == ExportFormat::Svg;
+        const bool json = request.format == ExportFormat::Json;
         const auto reportDirectory = job->request.storage == ProfileStorage::Disk
                                    ? job->directory
                                    : options_.storageRoot / ".exports" / job->snapshot.id;
-        const auto path = reportDirectory / (svg ? "report.svg" : "report.md");
+        const auto path = reportDirectory / [&] {
+            switch (request.format) {
+            case ExportFormat::Svg: return "report.svg";
+            case ExportFormat::Json: return "report.json";
+            case ExportFormat::Folded: return "report.folded";
+            case ExportFormat::FlameGraph: return "report.flame.svg";
+            case ExportFormat::Pprof: return "report.pb.gz";
+            case ExportFormat::ChromeTrace: return "report.trace.json";
+            case ExportFormat::Markdown: break;
+            }
+            return "report.md";
+        }();
         std::error_code createError;
         std::filesystem::create_directories(reportDirectory, createError);
         if (createError) {
             return std::unexpected(failure("EXPORT_CREATE_FAILED", "Unable to create the controlled report directory."));
         }
 
+        // Stack and interchange exports stream straight from the store; a large capture is never held as one document.
+        if (request.format == ExportFormat::Folded || request.format == ExportFormat::FlameGraph
+            || request.format == ExportFormat::Pprof || request.format == ExportFormat::ChromeTrace) {
+            if (!std::filesystem::is_regular_file(path)) {
+                const auto kind = job->request.kind;
+                const auto title = kind == ProfilerKind::PythonCpu    ? "Python CPU Flame Graph"
+                                 : kind == ProfilerKind::PythonMemory ? "Python Retained Memory Flame Graph"
+                                                                      : "Native CPU Flame Graph";
+                const auto subtitle = "Job " + job->snapshot.id + " | "
+                                    + (kind == ProfilerKind::PythonMemory ? "weighted by retained bytes"
+                                                                          : "weighted by time");
+                auto written = writeAtomicWith(path, [&](std::ostream& output) {
+                    switch (request.format) {
+                    case ExportFormat::Folded: writeFoldedStacks(*profile, output); break;
+                    case ExportFormat::FlameGraph: writeFlameGraph(*profile, title, subtitle, output); break;
+                    case ExportFormat::Pprof: writePprof(*profile, output); break;
+                    case ExportFormat::ChromeTrace: writeChromeTrace(*profile, output); break;
+                    default: break;
+                    }
+                });
+                if (!written) return std::unexpected(written.error());
+            }
+            return exportedFile(path);
+        }
+
         struct ReportRow {
             std::string label;
             std::string context;
@@ -897,26 +1463,32 @@ public:
         std::string title;
         std::string primaryHeading;
         std::string secondaryHeading;
+        const auto& store = *profile;
+        const auto columnOf = [&](const ProfileView& view, std::string_view name) -> const ProfileColumn& {
+            return *store.column(view, name);
+        };
         if (job->request.kind == ProfilerKind::PythonCpu) {
             title = "Python Performance Profile";
             primaryHeading = "Total";
             secondaryHeading = "Self";
-            for (const auto& row : job->data.value("nodes", Json::array())) {
-                if (!row.is_array() || row.size() < 11 || !row[6].is_number() || !row[7].is_number()) continue;
-                const auto self = row[6].get<double>();
-                const auto total = row[7].get<double>();
-                const auto module = row[1].is_string() ? row[1].get<std::string>() : std::string{};
-                const auto line = row[2].is_number_integer() ? row[2].get<std::int64_t>() : 0;
-                const auto name = row[3].is_string() ? row[3].get<std::string>() : "unknown";
-                const auto context = row[9].is_string() ? row[9].get<std::string>() : "Thread";
-                const auto target = row[10].is_string() ? row[10].get<std::string>() : "unknown";
+            const auto& view = *store.view("hotspots");
+            const auto& name = columnOf(view, "name");
+            const auto& module = columnOf(view, "module");
+            const auto& line = columnOf(view, "line");
+            const auto& context = columnOf(view, "context_name");
+            const auto& target = columnOf(view, "target");
+            const auto& self = columnOf(view, "self_time");
+            const auto& total = columnOf(view, "total_time");
+            for (const auto row : view.rows) {
+                const auto lineNumber = line.integer(row);
                 rows.push_back({
-                    .label = name,
-                    .context = module + (line > 0 ? ":" + std::to_string(line) : "") + " | " + target + " / " + context,
-                    .primaryText = formatSeconds(total),
-                    .secondaryText = formatSeconds(self),
-                    .magnitude = std::max(0.0, total),
-                    .secondaryMagnitude = std::max(0.0, self),
+                    .label = cellText(store, name, row),
+                    .context = cellText(store, module, row) + (lineNumber > 0 ? ":" + std::to_string(lineNumber) : "")
+                             + " | " + cellText(store, target, row) + " / " + cellText(store, context, row),
+                    .primaryText = formatSeconds(total.real(row)),
+                    .secondaryText = formatSeconds(self.real(row)),
+                    .magnitude = std::max(0.0, total.real(row)),
+                    .secondaryMagnitude = std::max(0.0, self.real(row)),
                     .showSecondary = true,
                 });
             }
@@ -924,45 +1496,83 @@ public:
             title = "Python Memory Profile";
             primaryHeading = "Retained change";
             secondaryHeading = "Current retained";
-            for (const auto& row : job->data.value("rows", Json::array())) {
-                if (!row.is_array() || row.size() < 6 || !row[1].is_number_integer() || !row[3].is_number_integer()) continue;
-                const auto difference = row[1].get<std::int64_t>();
-                const auto current = row[3].get<std::int64_t>();
+            // Every captured allocation, including the ones neither the growth nor the retained view selects.
+            const auto& view = *store.view("growth");
+            const auto& table = store.tableOf(view);
+            const auto& difference = columnOf(view, "size_diff");
+            const auto& count = columnOf(view, "count_diff");
+            const auto& current = columnOf(view, "current_size");
+            const auto& traceback = columnOf(view, "traceback");
+            for (std::size_t row = 0; row < table.rows(); ++row) {
                 std::string location = "unknown allocation site";
-                if (row[5].is_array() && !row[5].empty() && row[5][0].is_array() && row[5][0].size() >= 2) {
-                    const auto file = row[5][0][0].is_string() ? row[5][0][0].get<std::string>() : std::string{};
-                    const auto line = row[5][0][1].is_number_integer() ? row[5][0][1].get<std::int64_t>() : 0;
-                    location = file + (line > 0 ? ":" + std::to_string(line) : "");
+                if (const auto frames = store.stack(traceback.integer(row)); !frames.empty()) {
+                    const auto& frame = frames.front();
+                    location = std::string(store.strings.view(frame.file))
+                             + (frame.line > 0 ? ":" + std::to_string(frame.line) : "");
                 }
-                const auto count = row[2].is_number_integer() ? row[2].get<std::int64_t>() : 0;
                 rows.push_back({
                     .label = location,
-                    .context = (count > 0 ? "+" : "") + std::to_string(count) + " blocks",
-                    .primaryText = formatBytes(difference),
-                    .secondaryText = formatBytes(current),
-                    .magnitude = static_cast<long double>(std::llabs(difference)),
-                    .negative = difference < 0,
+                    .context = (count.integer(row) > 0 ? "+" : "") + std::to_string(count.integer(row)) + " blocks",
+                    .primaryText = formatBytes(difference.integer(row)),
+                    .secondaryText = formatBytes(current.integer(row)),
+                    .magnitude = static_cast<long double>(std::llabs(difference.integer(row))),
+                    .negative = difference.integer(row) < 0,
+                });
+            }
+        } else if (job->request.kind == ProfilerKind::FrameTime) {
+            title = "Frame Time Profile";
+            primaryHeading = "Duration";
+            secondaryHeading = "Of median";
+            const auto& sides = *store.view("percentiles");
+            std::unordered_map<std::string, double> medians;
+            for (const auto row : sides.rows) {
+                medians[cellText(store, columnOf(sides, "side"), row)] = columnOf(sides, "p50").real(row);
+            }
+            const auto& view = *store.view("worst-frames");
+            const auto& side = columnOf(view, "side");
+            const auto& end = columnOf(view, "end");
+            const auto& duration = columnOf(view, "duration");
+            const auto& cpuJob = columnOf(view, "cpu_job_id");
+            const auto& cpuKind = columnOf(view, "cpu_job_kind");
+            for (const auto row : view.rows) {
+                const auto sideName = cellText(store, side, row);
+                std::ostringstream label;
+                label << sideName << " frame ending at +" << std::fixed << std::setprecision(3) << end.real(row) << " s";
+                const auto median = medians[sideName];
+                std::ostringstream ratio;
+                ratio << std::fixed << std::setprecision(1) << (median > 0 ? duration.real(row) / median : 0.0) << "x";
+                rows.push_back({
+                    .label = label.str(),
+                    .context = cpuJob.has(row) ? "CPU job " + cellText(store, cpuJob, row) + " (" + cellText(store, cpuKind, row) + ")"
+                                               : "no overlapping CPU job",
+                    .primaryText = formatSeconds(duration.real(row) / 1000.0),
+                    .secondaryText = ratio.str(),
+                    .magnitude = std::max(0.0, duration.real(row)),
                 });
             }
         } else {
             title = "Native Performance Profile";
             primaryHeading = "Total";
             secondaryHeading = "Self";
-            for (const auto& zone : job->data.value("zones", Json::array())) {
-                if (!zone.is_object()) continue;
-                const auto total = jsonInteger(zone, "totalNanoseconds");
-                const auto self = jsonInteger(zone, "selfNanoseconds");
-                const auto file = jsonString(zone, "sourceFile");
-                const auto line = jsonInteger(zone, "sourceLine");
-                const auto thread = jsonString(zone, "threadName", 512);
+            const auto& view = *store.view("hotspots");
+            const auto& name = columnOf(view, "name");
+            const auto& file = columnOf(view, "source_file");
+            const auto& line = columnOf(view, "source_line");
+            const auto& threadId = columnOf(view, "thread_id");
+            const auto& threadName = columnOf(view, "thread_name");
+            const auto& total = columnOf(view, "total_time");
+            const auto& self = columnOf(view, "self_time");
+            for (const auto row : view.rows) {
+                const auto thread = store.strings.view(threadName.text(row));
+                const auto lineNumber = line.integer(row);
                 rows.push_back({
-                    .label = jsonString(zone, "name", 1024),
-                    .context = (thread.empty() ? jsonString(zone, "threadId", 128) : thread) + " | "
-                             + file + (line > 0 ? ":" + std::to_string(line) : ""),
-                    .primaryText = formatNanoseconds(total),
-                    .secondaryText = formatNanoseconds(self),
-                    .magnitude = static_cast<long double>(std::max<std::int64_t>(0, total)),
-                    .secondaryMagnitude = static_cast<long double>(std::max<std::int64_t>(0, self)),
+                    .label = cellText(store, name, row),
+                    .context = std::string(thread.empty() ? store.strings.view(threadId.text(row)) : thread) + " | "
+                             + cellText(store, file, row) + (lineNumber > 0 ? ":" + std::to_string(lineNumber) : ""),
+                    .primaryText = formatNanoseconds(total.integer(row)),
+                    .secondaryText = formatNanoseconds(self.integer(row)),
+                    .magnitude = static_cast<long double>(std::max<std::int64_t>(0, total.integer(row))),
+                    .secondaryMagnitude = static_cast<long double>(std::max<std::int64_t>(0, self.integer(row))),
                     .showSecondary = true,
                 });
             }
@@ -1020,6 +1630,14 @@ public:
             }
             if (rows.empty()) output << "<text x=\"20\" y=\"150\" class=\"meta\">No retained profiler records were captured.</text>\n";
             output << "</svg>\n";
+        } else if (json) {
+            // Every view in full, in the shape the MCP query tool returns records.
+            auto document = profileJson(store);
+            document["job_id"] = job->snapshot.id;
+            document["kind"] = toString(job->snapshot.kind);
+            document["completed_at"] = job->snapshot.completedAt;
+            document["summary"] = job->summary;
+            output << document.dump(-1, ' ', false, Json::error_handler_t::replace) << '\n';
         } else {
             output << "# " << title << "\n\n- Job: `" << job->snapshot.id << "`\n- Kind: `"
                    << toString(job->snapshot.kind) << "`\n- Storage: `" << toString(job->snapshot.storage)
@@ -1038,25 +1656,19 @@ public:
                 output << "- Python memory values cover tracemalloc allocations, not process RSS or native memory.\n";
             } else if (job->request.kind == ProfilerKind::NativeCpu) {
                 output << "- Native rows are emitted Tracy zones; uninstrumented native work may not appear.\n";
+            } else if (job->request.kind == ProfilerKind::FrameTime) {
+                output << "- Frame times are intervals between the side's game-thread ticks; query percentiles, histogram and timeseries for the distribution.\n";
             }
         }
         if (!std::filesystem::is_regular_file(path)) {
             if (auto written = writeAtomic(path, output.str()); !written) return std::unexpected(written.error());
         }
-        std::error_code error;
-        const auto size = std::filesystem::file_size(path, error);
-        auto digest = calculateFileSha256(path);
-        if (!digest) return std::unexpected(digest.error());
-        return ExportResult{
-            .path = std::filesystem::absolute(path),
-            .size = error ? 0 : size,
-            .sha256 = std::move(*digest),
-        };
+        return exportedFile(path);
     }
 
     std::expected<CleanupResult, ProfilerError> cleanup(const CleanupRequest& request) override {
         collectExpiredMemoryJobs();
-        scanHistoryOnce();
+        loadCatalogOnce();
         CleanupResult result;
         std::vector<std::filesystem::directory_entry> directories;
         std::error_code error;
@@ -1080,13 +1692,11 @@ public:
             return left.last_write_time(ignored) > right.last_write_time(ignored);
         });
         constexpr std::uintmax_t MaximumRetainedBytes = 2ull * 1024 * 1024 * 1024;
+        bool uncataloged = false;
         const auto oldestAllowed = std::filesystem::file_time_type::clock::now() - std::chrono::hours(24 * 30);
         std::uintmax_t retainedBytes = 0;
         for (std::size_t index = 0; index < directories.size(); ++index) {
-            std::uintmax_t bytes = 0;
-            for (std::filesystem::recursive_directory_iterator it(directories[index].path(), error), end; !error && it != end; it.increment(error)) {
-                if (it->is_regular_file(error)) bytes += it->file_size(error);
-            }
+            const auto bytes = directoryBytes(directories[index].path());
             const bool expired = directories[index].last_write_time(error) < oldestAllowed;
             const bool overCount = index >= 50;
             const bool overBytes = retainedBytes + bytes > MaximumRetainedBytes;
@@ -1096,8 +1706,26 @@ public:
             }
             ++result.removedJobs;
             result.removedBytes += bytes;
-            if (!request.dryRun) std::filesystem::remove_all(directories[index].path(), error);
+            if (request.dryRun) continue;
+            std::shared_ptr<Job> evicted;
+            {
+                // A loaded disk job maps its image from this directory; drop it so the files can go.
+                std::lock_guard lock(mutex_);
+                uncataloged |= catalog_.erase(directories[index].path().filename().string()) > 0;
+                const auto loaded = jobs_.find(directories[index].path().filename().string());
+                if (loaded != jobs_.end() && loaded->second->request.storage == ProfileStorage::Disk
+                    && loaded->second->snapshot.state == JobState::Completed && loaded->second != active_
+                    && loaded->second != activeFrames_) {
+                    evicted = loaded->second;
+                    evicted->store.reset();
+                    jobs_.erase(loaded);
+                }
+            }
+            if (evicted) queryCache_.eraseJob(evicted->snapshot.id);
+            if (evicted && evicted->worker.joinable()) evicted->worker.join();
+            std::filesystem::remove_all(directories[index].path(), error);
         }
+        if (uncataloged) saveCatalog();
         return result;
     }
 
@@ -1114,6 +1742,9 @@ public:
         if (!request.kind || *request.kind == ProfilerKind::PythonMemory) {
             add(ProfilerKind::PythonMemory, ipcAvailable, ipcAvailable ? "Game IPC executor is configured; tracemalloc availability is verified at start." : "Game IPC executor is unavailable.");
         }
+        if (!request.kind || *request.kind == ProfilerKind::FrameTime) {
+            add(ProfilerKind::FrameTime, ipcAvailable, ipcAvailable ? "Game IPC executor is configured; tick watchers need no game-side module." : "Game IPC executor is unavailable.");
+        }
         if (!request.kind || *request.kind == ProfilerKind::NativeCpu) {
             if (request.deep) {
                 const auto endpoint = native_.discover(options_.currentGameProcessId ? options_.currentGameProcessId() : 0);
@@ -1126,12 +1757,126 @@ public:
         return result;
     }
 
+    std::expected<TriggerSnapshot, ProfilerError> arm(const TriggerRequest& request) override {
+        if (request.condition == TriggerCondition::TickTime) {
+            if (request.side != ProfileTarget::Server && request.side != ProfileTarget::Client) {
+                return std::unexpected(failure("INVALID_TRIGGER_SIDE", "A tick trigger watches either the server or the client."));
+            }
+            if (!(request.tickMilliseconds >= 1 && request.tickMilliseconds <= 10000)) {
+                return std::unexpected(failure("INVALID_TRIGGER_THRESHOLD", "tick_ms must be between 1 and 10000."));
+            }
+            if (request.consecutiveTicks < 1 || request.consecutiveTicks > 1200) {
+                return std::unexpected(failure("INVALID_TRIGGER_THRESHOLD", "consecutive_ticks must be between 1 and 1200."));
+            }
+        } else {
+            if (request.logPattern.empty() || request.logPattern.size() > 256) {
+                return std::unexpected(failure("INVALID_TRIGGER_PATTERN", "pattern must be between 1 and 256 bytes."));
+            }
+            if (!options_.readGameLog) {
+                return std::unexpected(failure("GAME_LOG_UNAVAILABLE", "The game log is not available to log pattern triggers."));
+            }
+        }
+        if (request.cooldown < std::chrono::seconds(0) || request.cooldown > std::chrono::hours(1)) {
+            return std::unexpected(failure("INVALID_TRIGGER_COOLDOWN", "cooldown_seconds must be between 0 and 3600."));
+        }
+        if (request.maximumCaptures < 1 || request.maximumCaptures > 20) {
+            return std::unexpected(failure("INVALID_TRIGGER_CAPTURES", "max_captures must be between 1 and 20."));
+        }
+        if (request.capture.mode != ProfileMode::Capture) {
+            return std::unexpected(failure("TRIGGER_CAPTURE_INVALID", "A trigger starts bounded captures, not flight recorders."));
+        }
+        if (auto valid = validateStart(request.capture); !valid) return std::unexpected(valid.error());
+
+        auto trigger = std::make_shared<Trigger>();
+        trigger->request                  = request;
+        trigger->snapshot.id              = "trigger-" + makeJobId();
+        trigger->snapshot.condition       = request.condition;
+        trigger->snapshot.maximumCaptures = request.maximumCaptures;
+        trigger->snapshot.armedAt         = utcNow();
+        trigger->snapshot.statusMessage   = "Trigger is armed and watching.";
+        if (request.condition == TriggerCondition::LogPattern) {
+            if (request.logRegex) {
+                try {
+                    trigger->pattern.emplace(request.logPattern, std::regex::ECMAScript | std::regex::optimize);
+                } catch (const std::regex_error&) {
+                    return std::unexpected(failure("INVALID_TRIGGER_PATTERN", "pattern is not a valid regular expression."));
+                }
+            }
+            // Only lines logged after arming count.
+            trigger->logCursor = options_.readGameLog(std::numeric_limits<std::uint64_t>::max(), 0).nextCursor;
+        }
+        std::shared_ptr<Trigger> evicted;
+        {
+            std::lock_guard lock(mutex_);
+            if (shuttingDown_.load(std::memory_order_acquire)) {
+                return std::unexpected(failure("PROFILER_STOPPED", "The profiler service is shutting down."));
+            }
+            const auto armed = std::count_if(triggers_.begin(), triggers_.end(), [](const auto& entry) {
+                return entry->snapshot.state == TriggerState::Armed;
+            });
+            if (static_cast<std::size_t>(armed) >= MaximumArmedTriggers) {
+                return std::unexpected(failure("TRIGGER_LIMIT", "At most 4 triggers can be armed at once; disarm one first."));
+            }
+            if (triggers_.size() >= MaximumRetainedTriggers) {
+                const auto done = std::find_if(triggers_.begin(), triggers_.end(), [](const auto& entry) {
+                    return entry->finished.load(std::memory_order_acquire);
+                });
+                if (done != triggers_.end()) {
+                    evicted = *done;
+                    triggers_.erase(done);
+                }
+            }
+            triggers_.push_back(trigger);
+            trigger->worker = std::thread([this, trigger] { runTrigger(trigger); });
+        }
+        if (evicted && evicted->worker.joinable()) evicted->worker.join();
+        std::lock_guard lock(mutex_);
+        return trigger->snapshot;
+    }
+
+    std::expected<std::vector<TriggerSnapshot>, ProfilerError> triggers() const override {
+        std::lock_guard lock(mutex_);
+        std::vector<TriggerSnapshot> values;
+        for (const auto& trigger : triggers_) values.push_back(trigger->snapshot);
+        return values;
+    }
+
+    std::expected<TriggerSnapshot, ProfilerError> disarm(const TriggerId& id) override {
+        std::shared_ptr<Trigger> trigger;
+        {
+            std::lock_guard lock(mutex_);
+            const auto found = std::find_if(triggers_.begin(), triggers_.end(), [&](const auto& entry) {
+                return entry->snapshot.id == id;
+            });
+            if (found == triggers_.end()) return std::unexpected(failure("TRIGGER_NOT_FOUND", "Profiler trigger was not found."));
+            trigger = *found;
+            if (trigger->snapshot.state == TriggerState::Armed) {
+                trigger->disarmRequested = true;
+                trigger->snapshot.state = TriggerState::Disarmed;
+                trigger->snapshot.statusMessage = "Trigger was disarmed; captures it started are kept.";
+            }
+        }
+        trigger->condition.notify_all();
+        std::lock_guard lock(mutex_);
+        return trigger->snapshot;
+    }
+
     void shutdown() noexcept override {
         std::vector<std::shared_ptr<Job>> jobs;
+        std::vector<std::shared_ptr<Trigger>> triggers;
         {
             std::lock_guard lock(mutex_);
             if (shuttingDown_.load(std::memory_order_acquire)) return;
             shuttingDown_.store(true, std::memory_order_release);
+            triggers = triggers_;
+        }
+        // Triggers stop first so none of them starts a job after the jobs below are collected.
+        for (const auto& trigger : triggers) {
+            trigger->condition.notify_all();
+            if (trigger->worker.joinable()) trigger->worker.join();
+        }
+        {
+            std::lock_guard lock(mutex_);
             for (auto& [id, job] : jobs_) {
                 if (job->worker.joinable()) {
                     job->stopRequested = true;
@@ -1146,6 +1891,103 @@ public:
     }
 
 private:
+    static std::expected<void, ProfilerError> validateStart(const StartRequest& request) {
+        if (request.duration < std::chrono::seconds(1) || request.duration > std::chrono::seconds(300)) {
+            return std::unexpected(failure("INVALID_DURATION", "duration_seconds must be between 1 and 300."));
+        }
+        if (request.kind == ProfilerKind::PythonMemory && request.target != ProfileTarget::Client) {
+            return std::unexpected(failure("INVALID_TARGET", "Python memory profiling only supports target=client."));
+        }
+        if (request.tracebackDepth < 1 || request.tracebackDepth > 16) {
+            return std::unexpected(failure("INVALID_TRACEBACK_DEPTH", "traceback_depth must be between 1 and 16."));
+        }
+        if (request.snapshotInterval != std::chrono::seconds::zero()
+            && (request.kind != ProfilerKind::PythonMemory || request.snapshotInterval < std::chrono::seconds(1)
+                || request.snapshotInterval >= request.duration)) {
+            return std::unexpected(failure(
+                "INVALID_SNAPSHOT_INTERVAL",
+                "snapshot_interval_seconds needs python.memory and must be at least 1 and shorter than duration_seconds."
+            ));
+        }
+        if (request.mode == ProfileMode::Recorder) {
+            // Only yappi can be drained while it keeps running; tracemalloc and Tracy captures are single windows.
+            if (request.kind != ProfilerKind::PythonCpu) {
+                return std::unexpected(failure("RECORDER_KIND_UNSUPPORTED", "Flight recorder mode supports python.cpu only."));
+            }
+            if (request.recorderBytes < MinimumRecorderBytes || request.recorderBytes > MaximumRecorderBytes) {
+                return std::unexpected(failure("INVALID_RECORDER_BUDGET", "The flight recorder budget must be between 1 and 256 MiB."));
+            }
+        }
+        if (request.engine == ProfileEngine::Sampling) {
+            if (request.kind != ProfilerKind::PythonCpu) {
+                return std::unexpected(failure("ENGINE_KIND_UNSUPPORTED", "The sampling engine supports python.cpu only."));
+            }
+            // Samples land whether or not the thread is on a CPU, so they measure wall time only.
+            if (request.clock != ProfileClock::Wall) {
+                return std::unexpected(failure("SAMPLING_CLOCK_UNSUPPORTED", "The sampling engine measures wall time; use clock=wall."));
+            }
+            if (request.sampleHertz < 10 || request.sampleHertz > 1000) {
+                return std::unexpected(failure("INVALID_SAMPLE_RATE", "sample_hz must be between 10 and 1000."));
+            }
+        }
+        return {};
+    }
+
+    std::expected<JobSnapshot, ProfilerError> startJob(const StartRequest& request, std::optional<TriggerContext> trigger) {
+        auto job = std::make_shared<Job>();
+        job->snapshot.id        = makeJobId();
+        job->snapshot.kind      = request.kind;
+        job->snapshot.storage   = request.storage;
+        job->snapshot.mode      = request.mode;
+        job->snapshot.state     = JobState::Starting;
+        job->snapshot.createdAt = utcNow();
+        job->snapshot.trigger   = std::move(trigger);
+        job->request             = request;
+        job->deadline            = Clock::now() + request.duration;
+        job->lastAccess          = monotonicNow();
+        if (request.storage == ProfileStorage::Disk) {
+            job->directory = options_.storageRoot / job->snapshot.id;
+        }
+        job->temporaryTrace      = options_.storageRoot / ".runtime" / job->snapshot.id / "capture.tracy";
+        if (request.mode == ProfileMode::Recorder) {
+            job->recorder = std::make_unique<FlightRecorder>(request.duration, request.recorderBytes);
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            if (shuttingDown_.load(std::memory_order_acquire)) {
+                return std::unexpected(failure("PROFILER_STOPPED", "The profiler service is shutting down."));
+            }
+            // A frame-time job only times ticks, so it runs beside the one CPU or memory capture it can then link to.
+            auto& slot = request.kind == ProfilerKind::FrameTime ? activeFrames_ : active_;
+            if (slot) {
+                return std::unexpected(failure(
+                    "PROFILER_BUSY",
+                    request.kind == ProfilerKind::FrameTime ? "Another frame-time job is active." : "Another profiler job is active.",
+                    true
+                ));
+            }
+            jobs_.emplace(job->snapshot.id, job);
+            slot = job;
+        }
+
+        auto started = startBackend(*job);
+        if (!started) {
+            finishFailed(job, started.error());
+            return std::unexpected(started.error());
+        }
+        {
+            std::lock_guard lock(mutex_);
+            job->startedAt = Clock::now();
+            job->snapshot.state = JobState::Running;
+            job->snapshot.statusMessage = job->recorder
+                ? "Flight recorder is running; it keeps a rolling window until stopped."
+                : "Capture is running and will stop at the server deadline.";
+        }
+        job->worker = std::thread([this, job] { runJob(job); });
+        return snapshotOf(job);
+    }
+
     std::expected<Json, ProfilerError> execute(std::string code, ProfileTarget side, std::chrono::milliseconds timeout) const {
         if (!options_.executeCode) return std::unexpected(failure("GAME_EXECUTOR_UNAVAILABLE", "Game IPC executor is unavailable.", true));
         auto value = options_.executeCode(std::move(code), side, timeout);
@@ -1156,16 +1998,30 @@ private:
     std::expected<void, ProfilerError> startBackend(Job& job) {
         if (job.request.kind == ProfilerKind::PythonCpu) {
             const auto side = job.request.target == ProfileTarget::Server ? ProfileTarget::Server : ProfileTarget::Client;
-            auto started = execute(pythonCpuStartCode(job.request, job.snapshot.id), side, std::chrono::seconds(12));
+            const bool sampling = job.request.engine == ProfileEngine::Sampling;
+            auto started = execute(
+                sampling ? pythonSamplerStartCode(job.request, job.snapshot.id) : pythonCpuStartCode(job.request, job.snapshot.id),
+                side,
+                std::chrono::seconds(12)
+            );
             if (!started || !validProfilerPayload(*started)) {
-                cleanupPython(job.request.kind, side, job.snapshot.id);
-                return std::unexpected(started ? failure("PYTHON_PROFILER_START_FAILED", "Yappi is busy or could not start.", true) : started.error());
+                cleanupPython(job.request, side, job.snapshot.id);
+                return std::unexpected(
+                    started ? failure("PYTHON_PROFILER_START_FAILED", sampling ? "The sampler is busy or could not start." : "Yappi is busy or could not start.", true)
+                            : started.error()
+                );
             }
             if (job.request.target == ProfileTarget::All) {
-                const auto client = execute(pythonCpuMarkerCode(ProfileTarget::Client), ProfileTarget::Client, std::chrono::seconds(5));
-                const auto server = execute(pythonCpuMarkerCode(ProfileTarget::Server), ProfileTarget::Server, std::chrono::seconds(5));
+                // The sampler already follows the client thread that started it.
+                const auto client = sampling ? std::expected<Json, ProfilerError>(true)
+                                             : execute(pythonCpuMarkerCode(ProfileTarget::Client), ProfileTarget::Client, std::chrono::seconds(5));
+                const auto server = execute(
+                    sampling ? pythonSamplerMarkerCode(job.snapshot.id) : pythonCpuMarkerCode(ProfileTarget::Server),
+                    ProfileTarget::Server,
+                    std::chrono::seconds(5)
+                );
                 if (!client || !server) {
-                    cleanupPython(job.request.kind, ProfileTarget::Client, job.snapshot.id);
+                    cleanupPython(job.request, ProfileTarget::Client, job.snapshot.id);
                     return std::unexpected(failure("PYTHON_PROFILER_MARKER_FAILED", "Client/server context markers could not both execute.", true));
                 }
             }
@@ -1178,11 +2034,21 @@ private:
                 std::chrono::seconds(12)
             );
             if (!started || !validProfilerPayload(*started)) {
-                cleanupPython(job.request.kind, ProfileTarget::Client, job.snapshot.id);
+                cleanupPython(job.request, ProfileTarget::Client, job.snapshot.id);
                 return std::unexpected(started ? failure("PYTHON_MEMORY_START_FAILED", "tracemalloc is busy or could not start.", true) : started.error());
             }
             return {};
         }
+        if (job.request.kind == ProfilerKind::FrameTime) {
+            for (const auto side : frameSides(job.request.target)) {
+                const auto started = execute(tickWatchStartCode(side, frameWatcher(job.snapshot.id, side)), side, std::chrono::seconds(5));
+                if (!started || !validProfilerPayload(*started)) {
+                    stopFrameWatchers(job);
+                    return std::unexpected(started ? failure("FRAME_TIMER_START_FAILED", "The tick watcher could not start.", true) : started.error());
+                }
+            }
+            return {};
+        }
         if (!native_.available()) {
             const auto retry = native_.initialize();
             if (!retry) return std::unexpected(retry.error());
@@ -1194,20 +2060,33 @@ private:
         return {};
     }
 
-    void cleanupPython(ProfilerKind kind, ProfileTarget side, std::string_view owner) const noexcept {
+    void cleanupPython(const StartRequest& request, ProfileTarget side, std::string_view owner) const noexcept {
         try {
             (void)execute(
-                kind == ProfilerKind::PythonMemory ? pythonMemoryCleanupCode(owner) : pythonCpuCleanupCode(owner),
+                request.kind == ProfilerKind::PythonMemory    ? pythonMemoryCleanupCode(owner)
+                : request.engine == ProfileEngine::Sampling ? pythonSamplerCleanupCode(owner)
+                                                            : pythonCpuCleanupCode(owner),
                 side,
                 std::chrono::seconds(8)
             );
         } catch (...) {}
     }
 
+    void stopFrameWatchers(const Job& job) const noexcept {
+        for (const auto side : frameSides(job.request.target)) {
+            try {
+                (void)execute(tickWatchStopCode(frameWatcher(job.snapshot.id, side)), side, std::chrono::seconds(5));
+            } catch (...) {}
+        }
+    }
+
     void runJob(const std::shared_ptr<Job>& job) noexcept {
         try {
             if (job->request.kind == ProfilerKind::NativeCpu) waitNative(job);
+            else if (job->request.kind == ProfilerKind::FrameTime) runFrameTimes(job);
+            else if (job->recorder) runRecorder(job);
             else {
+                const auto timeline = takeMemorySnapshots(job);
                 std::unique_lock lock(mutex_);
                 job->condition.wait_until(lock, job->deadline, [&] {
                     return job->stopRequested.load(std::memory_order_acquire)
@@ -1216,7 +2095,7 @@ private:
                 job->snapshot.state = JobState::Finalizing;
                 job->snapshot.statusMessage = "Capture deadline reached; collecting bounded results.";
                 lock.unlock();
-                finalizePython(job);
+                finalizePython(job, timeline);
             }
         } catch (const std::exception& error) {
             finishFailed(job, failure("PROFILER_WORKER_EXCEPTION", error.what()));
@@ -1225,11 +2104,374 @@ private:
         }
     }
 
-    void finalizePython(const std::shared_ptr<Job>& job) {
+    // Drains the game into the ring every segment until the recorder is stopped, and then completes the job with its
+    // last window as a capture completes at its deadline. Drains that fail for longer than the lease end the recorder,
+    // since the game has stopped profiling by then.
+    void runRecorder(const std::shared_ptr<Job>& job) {
+        const auto side = job->request.target == ProfileTarget::Server ? ProfileTarget::Server : ProfileTarget::Client;
+        const auto segment = std::clamp<Clock::duration>(
+            job->request.duration / 10, std::chrono::seconds(1), std::chrono::seconds(5)
+        );
+        auto drainedAt = Clock::now();
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                if (job->condition.wait_for(lock, segment, [&] {
+                        return job->stopRequested.load(std::memory_order_acquire)
+                            || shuttingDown_.load(std::memory_order_acquire);
+                    })) {
+                    job->snapshot.state = JobState::Finalizing;
+                    break;
+                }
+            }
+            std::lock_guard drainLock(job->recorderMutex);
+            auto drained = drainRecorder(*job);
+            if (drained) drainedAt = Clock::now();
+            else if (!drained.error().retryable || Clock::now() - drainedAt >= RecorderLease) {
+                cleanupPython(job->request, side, job->snapshot.id);
+                finishFailed(job, drained.error());
+                return;
+            }
+        }
+        if (job->discardRequested.load(std::memory_order_acquire)
+            || shuttingDown_.load(std::memory_order_acquire)) {
+            cleanupPython(job->request, side, job->snapshot.id);
+            finishDiscarded(
+                job,
+                shuttingDown_.load(std::memory_order_acquire) ? JobState::Aborted : JobState::Discarded
+            );
+            return;
+        }
+        Json window;
+        {
+            std::lock_guard drainLock(job->recorderMutex);
+            (void)drainRecorder(*job);
+            window = job->recorder->merged();
+        }
+        cleanupPython(job->request, side, job->snapshot.id);
+        commitCapture(job, window);
+    }
+
+    // Drains the job's tick watchers into a timeline until the deadline or a stop, then completes with the frame-time
+    // views. A watcher the game lost, for example across a world reload, is installed again; a watcher that dropped
+    // frames before a drain reached it reports them as lost.
+    void runFrameTimes(const std::shared_ptr<Job>& job) {
+        const auto sides = frameSides(job->request.target);
+        std::vector<std::uint64_t> cursors(sides.size(), 0);
+        FrameTimeline timeline;
+        bool drained = false;
+        ProfilerError lastError = failure("FRAME_DRAIN_FAILED", "No tick watcher could be drained.", true);
+        const auto seconds = [&](Clock::time_point time) {
+            return std::chrono::duration<double>(time - job->startedAt).count();
+        };
+        const auto drain = [&] {
+            for (std::size_t index = 0; index < sides.size(); ++index) {
+                const auto side = sides[index];
+                const auto owner = frameWatcher(job->snapshot.id, side);
+                auto result = execute(tickWatchDrainCode(side, owner, cursors[index]), side, std::chrono::seconds(5));
+                if (!result) {
+                    lastError = result.error();
+                    continue;
+                }
+                if (!validProfilerPayload(*result)) {
+                    cursors[index] = 0;
+                    (void)execute(tickWatchStartCode(side, owner), side, std::chrono::seconds(5));
+                    continue;
+                }
+                drained = true;
+                const auto first = result->value("first", std::uint64_t{0});
+                const auto intervals = result->value("intervals", Json::array());
+                if (first > cursors[index]) timeline.lose(side, first - cursors[index]);
+                std::vector<double> durations;
+                durations.reserve(intervals.size());
+                for (const auto& interval : intervals) {
+                    if (interval.is_number()) durations.push_back(interval.get<double>());
+                }
+                timeline.append(side, durations, seconds(Clock::now()));
+                cursors[index] = first + intervals.size();
+            }
+        };
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                const auto wake = std::min(job->deadline, Clock::now() + FrameDrainInterval);
+                if (job->condition.wait_until(lock, wake, [&] {
+                        return job->stopRequested.load(std::memory_order_acquire)
+                            || shuttingDown_.load(std::memory_order_acquire);
+                    })
+                    || Clock::now() >= job->deadline) {
+                    job->snapshot.state = JobState::Finalizing;
+                    job->snapshot.statusMessage = "Capture deadline reached; building the frame-time histograms.";
+                    break;
+                }
+            }
+            drain();
+        }
+        if (job->discardRequested.load(std::memory_order_acquire)
+            || shuttingDown_.load(std::memory_order_acquire)) {
+            stopFrameWatchers(*job);
+            finishDiscarded(
+                job,
+                shuttingDown_.load(std::memory_order_acquire) ? JobState::Aborted : JobState::Discarded
+            );
+            return;
+        }
+        drain();
+        stopFrameWatchers(*job);
+        if (!drained) {
+            finishFailed(job, lastError);
+            return;
+        }
+        Clock::time_point end;
+        {
+            std::lock_guard lock(mutex_);
+            end = std::min({Clock::now(), job->deadline, job->stoppedAt});
+        }
+        const auto windows = overlappingCpuJobs(*job, end);
+        commitCapture(job, timeline.payload(seconds(end), windows));
+    }
+
+    // The capture-mode CPU jobs whose windows overlapped a frame-time job, relative to its start. Flight recorders
+    // are left out: what they finally keep is only their last window.
+    std::vector<FrameCpuWindow> overlappingCpuJobs(const Job& frames, Clock::time_point end) const {
+        std::vector<FrameCpuWindow> windows;
+        std::lock_guard lock(mutex_);
+        for (const auto& [id, job] : jobs_) {
+            if ((job->request.kind != ProfilerKind::PythonCpu && job->request.kind != ProfilerKind::NativeCpu)
+                || job->recorder || job->startedAt == Clock::time_point{}
+                || job->snapshot.state == JobState::Failed || job->snapshot.state == JobState::Discarded
+                || job->snapshot.state == JobState::Aborted) {
+                continue;
+            }
+            const auto stopped = std::min(job->deadline, job->stoppedAt);
+            if (stopped < frames.startedAt || job->startedAt > end) continue;
+            windows.push_back({
+                .jobId = id,
+                .kind  = job->request.kind,
+                .start = std::chrono::duration<double>(job->startedAt - frames.startedAt).count(),
+                .end   = std::chrono::duration<double>(stopped - frames.startedAt).count(),
+            });
+        }
+        std::sort(windows.begin(), windows.end(), [](const auto& left, const auto& right) { return left.start < right.start; });
+        return windows;
+    }
+
+    // Moves the game's stats since the previous drain into the recorder's ring. Callers hold recorderMutex.
+    std::expected<void, ProfilerError> drainRecorder(Job& job) {
+        const auto side = job.request.target == ProfileTarget::Server ? ProfileTarget::Server : ProfileTarget::Client;
+        const bool sampling = job.request.engine == ProfileEngine::Sampling;
+        auto drained = execute(
+            sampling ? pythonSamplerDrainCode(job.snapshot.id) : pythonCpuDrainCode(job.request, job.snapshot.id),
+            side,
+            std::chrono::seconds(30)
+        );
+        if (!drained) return std::unexpected(drained.error());
+        if (!validProfilerPayload(*drained)) {
+            return std::unexpected(failure("PYTHON_RECORDER_LOST", "The game no longer runs this flight recorder's profiler."));
+        }
+        job.recorder->append(sampling ? foldSampledStacks(*drained) : *drained, Clock::now());
+        std::ostringstream message;
+        message << std::fixed << std::setprecision(1) << "Flight recorder is running and holds "
+                << job.recorder->covered() << " s in " << job.recorder->segments() << " segments ("
+                << static_cast<double>(job.recorder->bytes()) / (1024 * 1024) << " of "
+                << static_cast<double>(job.request.recorderBytes) / (1024 * 1024) << " MiB).";
+        std::lock_guard lock(mutex_);
+        if (job.snapshot.state == JobState::Running && !job.stopRequested.load(std::memory_order_acquire)) {
+            job.snapshot.statusMessage = message.str();
+        }
+        return {};
+    }
+
+    // Polls a trigger's condition until it is disarmed, has started its last capture, or the service shuts down. A
+    // game that is not ready yet only delays the watch, so a trigger can be armed before the world loads.
+    void runTrigger(const std::shared_ptr<Trigger>& trigger) noexcept {
+        try {
+            while (true) {
+                {
+                    std::unique_lock lock(mutex_);
+                    if (trigger->condition.wait_for(lock, TriggerPollInterval, [&] {
+                            return trigger->disarmRequested.load(std::memory_order_acquire)
+                                || shuttingDown_.load(std::memory_order_acquire);
+                        })) {
+                        break;
+                    }
+                }
+                const auto detail = trigger->request.condition == TriggerCondition::TickTime ? pollTicks(*trigger)
+                                                                                              : pollLog(*trigger);
+                if (detail && !fireTrigger(*trigger, *detail)) break;
+            }
+        } catch (const std::exception& error) {
+            std::lock_guard lock(mutex_);
+            trigger->snapshot.state = TriggerState::Failed;
+            trigger->snapshot.statusMessage = std::string("PROFILER_WORKER_EXCEPTION: ") + error.what();
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            trigger->snapshot.state = TriggerState::Failed;
+            trigger->snapshot.statusMessage = "PROFILER_WORKER_EXCEPTION: Trigger worker raised an unknown exception.";
+        }
+        if (trigger->watching) {
+            try {
+                (void)execute(tickWatchStopCode(trigger->snapshot.id), trigger->request.side, std::chrono::seconds(3));
+            } catch (...) {}
+        }
+        trigger->finished = true;
+    }
+
+    void setTriggerStatus(Trigger& trigger, std::string message) {
+        std::lock_guard lock(mutex_);
+        if (trigger.snapshot.state == TriggerState::Armed) trigger.snapshot.statusMessage = std::move(message);
+    }
+
+    // Drains the tick watcher, installing it first when the game does not run it yet, and returns the streak once the
+    // tick interval has exceeded the threshold for the consecutive ticks. Intervals the watcher discarded unread
+    // break a streak.
+    std::optional<std::string> pollTicks(Trigger& trigger) {
+        const auto& request = trigger.request;
+        if (!trigger.watching) {
+            const auto installed = execute(tickWatchStartCode(request.side, trigger.snapshot.id), request.side, std::chrono::seconds(5));
+            if (!installed || !validProfilerPayload(*installed)) {
+                setTriggerStatus(trigger, installed ? "Waiting to install the tick watcher in the game." : installed.error().code + ": " + installed.error().message);
+                return std::nullopt;
+            }
+            trigger.watching   = true;
+            trigger.tickCursor = 0;
+            trigger.streak     = 0;
+            setTriggerStatus(trigger, "Trigger is armed and watching.");
+        }
+        const auto drained = execute(
+            tickWatchDrainCode(request.side, trigger.snapshot.id, trigger.tickCursor), request.side, std::chrono::seconds(5)
+        );
+        if (!drained) {
+            setTriggerStatus(trigger, drained.error().code + ": " + drained.error().message);
+            return std::nullopt;
+        }
+        if (!validProfilerPayload(*drained)) {
+            trigger.watching = false;
+            return std::nullopt;
+        }
+        const auto first = drained->value("first", std::uint64_t{0});
+        if (first > trigger.tickCursor) trigger.streak = 0;
+        const auto intervals = drained->value("intervals", Json::array());
+        trigger.tickCursor = first + intervals.size();
+        for (const auto& interval : intervals) {
+            const auto milliseconds = interval.is_number() ? interval.get<double>() : 0.0;
+            if (milliseconds <= request.tickMilliseconds) {
+                trigger.streak = 0;
+                continue;
+            }
+            trigger.streakPeak = trigger.streak == 0 ? milliseconds : std::max(trigger.streakPeak, milliseconds);
+            if (++trigger.streak < request.consecutiveTicks) continue;
+            std::ostringstream detail;
+            detail << std::fixed << std::setprecision(1)
+                   << (request.side == ProfileTarget::Server ? "Server" : "Client") << " tick time exceeded "
+                   << request.tickMilliseconds << " ms for " << trigger.streak << " consecutive ticks (peak "
+                   << trigger.streakPeak << " ms).";
+            trigger.streak = 0;
+            return detail.str();
+        }
+        return std::nullopt;
+    }
+
+    // Reads the log lines since the previous poll, batch by batch within the read budget, and returns the first one
+    // that matches. Lines the log evicted before they were read are counted in the trigger's snapshot.
+    std::optional<std::string> pollLog(Trigger& trigger) {
+        const auto budgetEnd = Clock::now() + TriggerLogReadBudget;
+        while (true) {
+            auto batch = options_.readGameLog(trigger.logCursor, MaximumTriggerLogLines);
+            trigger.logCursor = batch.nextCursor;
+            if (batch.dropped > 0) {
+                std::lock_guard lock(mutex_);
+                trigger.snapshot.missedLogLines += batch.dropped;
+            }
+            for (auto& line : batch.lines) {
+                if (line.size() > 4096) line.resize(4096);
+                const bool matched = trigger.pattern ? std::regex_search(line, *trigger.pattern)
+                                                     : line.find(trigger.request.logPattern) != std::string::npos;
+                if (!matched) continue;
+                if (line.size() > 512) line.resize(512);
+                return "Log line matched: " + line;
+            }
+            if (!batch.hasMore || Clock::now() >= budgetEnd) return std::nullopt;
+        }
+    }
+
+    // Starts the trigger's capture unless it is cooling down, and returns false once the trigger is done: it has
+    // started its last capture, or its capture fails for a reason that retrying cannot fix.
+    bool fireTrigger(Trigger& trigger, const std::string& detail) {
+        const auto now = Clock::now();
+        if (now < trigger.cooldownUntil) {
+            std::lock_guard lock(mutex_);
+            ++trigger.snapshot.suppressed;
+            return true;
+        }
+        TriggerContext context{
+            .triggerId = trigger.snapshot.id,
+            .condition = trigger.request.condition,
+            .detail    = detail,
+            .firedAt   = utcNow(),
+        };
+        auto started = startJob(trigger.request.capture, context);
+        std::lock_guard lock(mutex_);
+        if (!started) {
+            ++trigger.snapshot.suppressed;
+            if (trigger.snapshot.state != TriggerState::Armed || shuttingDown_.load(std::memory_order_acquire)) return false;
+            if (!started.error().retryable) {
+                trigger.snapshot.state = TriggerState::Failed;
+                trigger.snapshot.statusMessage = started.error().code + ": " + started.error().message;
+                return false;
+            }
+            trigger.snapshot.statusMessage = "The condition held but its capture could not start: " + started.error().message;
+            return true;
+        }
+        trigger.cooldownUntil = now + trigger.request.cooldown;
+        ++trigger.snapshot.captures;
+        trigger.snapshot.jobs.push_back(started->id);
+        trigger.snapshot.lastFiredAt = context.firedAt;
+        if (trigger.snapshot.state != TriggerState::Armed) return false;
+        if (trigger.snapshot.captures >= trigger.request.maximumCaptures) {
+            trigger.snapshot.state = TriggerState::Exhausted;
+            trigger.snapshot.statusMessage = "Trigger started its last capture, " + started->id + ".";
+            return false;
+        }
+        trigger.snapshot.statusMessage = "Trigger started capture " + started->id + " and is cooling down.";
+        return true;
+    }
+
+    // Snapshots a memory job every interval until its deadline. A snapshot that fails is skipped, since the final
+    // collection decides whether the job completes; one the game no longer owns ends the series.
+    MemoryTimeline takeMemorySnapshots(const std::shared_ptr<Job>& job) {
+        MemoryTimeline timeline;
+        const auto interval = job->request.snapshotInterval;
+        if (job->request.kind != ProfilerKind::PythonMemory || interval <= std::chrono::seconds::zero()) return timeline;
+        auto next = Clock::now() + interval;
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                if (next >= job->deadline || job->condition.wait_until(lock, next, [&] {
+                        return job->stopRequested.load(std::memory_order_acquire)
+                            || shuttingDown_.load(std::memory_order_acquire);
+                    })) {
+                    break;
+                }
+            }
+            const auto snapshot = execute(
+                pythonMemorySnapshotCode(job->request.collectGarbage, job->snapshot.id),
+                job->request.target == ProfileTarget::Server ? ProfileTarget::Server : ProfileTarget::Client,
+                std::chrono::seconds(30)
+            );
+            if (snapshot && !validProfilerPayload(*snapshot)) break;
+            if (snapshot) timeline.append(*snapshot);
+            // A snapshot slower than the interval delays the next one rather than queueing several.
+            for (const auto now = Clock::now(); next <= now;) next += interval;
+        }
+        return timeline;
+    }
+
+    void finalizePython(const std::shared_ptr<Job>& job, const MemoryTimeline& timeline = {}) {
         if (job->discardRequested.load(std::memory_order_acquire)
             || shuttingDown_.load(std::memory_order_acquire)) {
             cleanupPython(
-                job->request.kind,
+                job->request,
                 job->request.target == ProfileTarget::Server ? ProfileTarget::Server : ProfileTarget::Client,
                 job->snapshot.id
             );
@@ -1241,20 +2483,19 @@ private:
         }
         const auto side = job->request.target == ProfileTarget::Server ? ProfileTarget::Server : ProfileTarget::Client;
         auto result = execute(
-            job->request.kind == ProfilerKind::PythonMemory
-                ? pythonMemoryCollectCode(job->request.collectGarbage, job->snapshot.id)
-                : pythonCpuCollectCode(job->request, job->snapshot.id),
+            job->request.kind == ProfilerKind::PythonMemory ? pythonMemoryCollectCode(job->request.collectGarbage, job->snapshot.id)
+            : job->request.engine == ProfileEngine::Sampling ? pythonSamplerCollectCode(job->snapshot.id)
+                                                             : pythonCpuCollectCode(job->request, job->snapshot.id),
             side,
             std::chrono::seconds(30)
         );
         if (!result || !validProfilerPayload(*result)) {
-            cleanupPython(job->request.kind, side, job->snapshot.id);
+            cleanupPython(job->request, side, job->snapshot.id);
             finishFailed(job, result ? failure("PYTHON_COLLECT_FAILED", "Python profiler returned no owned capture.") : result.error());
             return;
         }
-        job->data = std::move(*result);
-        job->summary = summarize(*job);
-        persistAndComplete(job);
+        if (job->request.kind == ProfilerKind::PythonMemory) commitCapture(job, timeline.payload(std::move(*result)));
+        else commitCapture(job, job->request.engine == ProfileEngine::Sampling ? foldSampledStacks(*result) : *result);
     }
 
     void waitNative(const std::shared_ptr<Job>& job) {
@@ -1327,35 +2568,67 @@ private:
         parsed["gamePid"] = job->nativeCapture.endpoint.pid;
         parsed["tracyPort"] = job->nativeCapture.endpoint.port;
         parsed["processIdentity"] = job->nativeCapture.endpoint.identity;
-        job->data = std::move(parsed);
-        job->summary = summarize(*job);
-        persistAndComplete(job);
+        commitCapture(job, parsed);
     }
 
-    Json summarize(const Job& job) const {
-        Json result{{"kind", toString(job.request.kind)}, {"capture_truncated", job.data.value("truncated", false)}};
-        if (job.request.kind == ProfilerKind::PythonCpu) {
-            result["elapsed_seconds"] = job.data.value("elapsed", 0.0);
-            result["total_functions"] = job.data.value("total", 0);
-            result["captured_functions"] = job.data.value("nodes", Json::array()).size();
-            result["captured_calls"] = job.data.value("edges", Json::array()).size();
-        } else if (job.request.kind == ProfilerKind::PythonMemory) {
-            result["elapsed_seconds"] = job.data.value("elapsed", 0.0);
-            result["net_size_diff_bytes"] = job.data.value("sizeDiff", 0);
-            result["net_count_diff"] = job.data.value("countDiff", 0);
-            result["total_allocations"] = job.data.value("total", 0);
-            result["captured_allocations"] = job.data.value("rows", Json::array()).size();
+    static Json summarize(const StartRequest& request, const Json& data) {
+        const auto kind = request.kind;
+        Json result{{"kind", toString(kind)}, {"capture_truncated", data.value("truncated", false)}};
+        if (kind == ProfilerKind::PythonCpu) {
+            result["engine"] = toString(request.engine);
+            result["elapsed_seconds"] = data.value("elapsed", 0.0);
+            result["total_functions"] = data.value("total", 0);
+            result["captured_functions"] = data.value("nodes", Json::array()).size();
+            result["captured_calls"] = data.value("edges", Json::array()).size();
+            if (data.contains("recorder")) result["flight_recorder"] = data["recorder"];
+            if (data.contains("sampling")) result["sampling"] = data["sampling"];
+        } else if (kind == ProfilerKind::PythonMemory) {
+            result["elapsed_seconds"] = data.value("elapsed", 0.0);
+            result["net_size_diff_bytes"] = data.value("sizeDiff", 0);
+            result["net_count_diff"] = data.value("countDiff", 0);
+            result["total_allocations"] = data.value("total", 0);
+            result["captured_allocations"] = data.value("rows", Json::array()).size();
+            if (data.contains("snapshots")) {
+                result["snapshots"] = data["snapshots"].size();
+                const auto sites = data.value("sites", Json::array());
+                result["growing_sites"] = std::count_if(sites.begin(), sites.end(), [](const Json& site) {
+                    return site.is_array() && site.size() > 7 && site[7] == "growing";
+                });
+            }
+        } else if (kind == ProfilerKind::FrameTime) {
+            result["elapsed_seconds"] = data.value("elapsed", 0.0);
+            result["sides"] = data.value("sides", Json::array());
+            result["overlapping_cpu_jobs"] = Json::array();
+            for (const auto& window : data.value("cpu_jobs", Json::array())) {
+                if (window.is_array() && !window.empty() && window[0].is_string()) result["overlapping_cpu_jobs"].push_back(window[0]);
+            }
         } else {
-            result["captured_seconds"] = job.data.value("capturedSeconds", 0.0);
-            result["total_zones"] = job.data.value("totalZones", 0);
-            result["indexed_zones"] = job.data.value("zones", Json::array()).size();
-            result["call_tree_truncated"] = job.data.value("callTreeTruncated", false);
-            result["thread_count"] = job.data.value("threads", Json::array()).size();
+            result["captured_seconds"] = data.value("capturedSeconds", 0.0);
+            result["total_zones"] = data.value("totalZones", 0);
+            result["indexed_zones"] = data.value("zones", Json::array()).size();
+            result["call_tree_truncated"] = data.value("callTreeTruncated", false);
+            result["thread_count"] = data.value("threads", Json::array()).size();
         }
         return result;
     }
 
-    void persistAndComplete(const std::shared_ptr<Job>& job) {
+    // Builds the encoded profile once; disk jobs persist exactly those bytes and later map them back.
+    void commitCapture(const std::shared_ptr<Job>& job, const Json& data) {
+        job->summary = summarize(job->request, data);
+        if (job->snapshot.trigger) job->summary["trigger"] = triggerContextJson(*job->snapshot.trigger);
+        auto store = buildProfileStore(job->request.kind, data);
+        if (!store) {
+            finishFailed(job, store.error());
+            return;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            job->store = *store;
+        }
+        persistAndComplete(job, **store);
+    }
+
+    void persistAndComplete(const std::shared_ptr<Job>& job, const ProfileStore& store) {
         if (job->request.storage == ProfileStorage::Memory) {
             std::error_code ignored;
             std::filesystem::remove_all(job->temporaryTrace.parent_path(), ignored);
@@ -1366,7 +2639,7 @@ private:
             job->snapshot.statusMessage =
                 "Capture completed in temporary memory; it expires after 20 minutes without access.";
             job->lastAccess = monotonicNow();
-            if (active_ == job) active_.reset();
+            release(job);
             return;
         }
         {
@@ -1384,8 +2657,13 @@ private:
             finishFailed(job, failure("PERSIST_CREATE_FAILED", "Unable to create the controlled job directory."));
             return;
         }
-        if (auto data = writeAtomic(job->directory / "data.json", job->data.dump()); !data) {
-            finishFailed(job, data.error()); return;
+        const auto image = store.image->bytes();
+        if (auto written = writeAtomic(
+                job->directory / "data.mcprof",
+                std::string_view(reinterpret_cast<const char*>(image.data()), image.size())
+            );
+            !written) {
+            finishFailed(job, written.error()); return;
         }
         if (auto summary = writeAtomic(job->directory / "summary.json", job->summary.dump(2)); !summary) {
             finishFailed(job, summary.error()); return;
@@ -1400,24 +2678,36 @@ private:
         }
         const auto completedAt = utcNow();
         Json manifest{
-            {"schema", 1}, {"job_id", job->snapshot.id}, {"kind", toString(job->snapshot.kind)},
+            {"schema", 2}, {"job_id", job->snapshot.id}, {"kind", toString(job->snapshot.kind)},
             {"storage", "disk"},
             {"state", "completed"}, {"created_at", job->snapshot.createdAt}, {"completed_at", completedAt},
-            {"partial", job->snapshot.partial}, {"artifacts", Json::array({"data.json", "summary.json"})}
+            {"partial", job->snapshot.partial}, {"artifacts", Json::array({"data.mcprof", "summary.json"})}
         };
+        if (job->snapshot.trigger) manifest["trigger"] = triggerContextJson(*job->snapshot.trigger);
         if (job->request.kind == ProfilerKind::NativeCpu) manifest["artifacts"].push_back("capture.tracy");
         if (auto committed = writeAtomic(job->directory / "manifest.json", manifest.dump(2)); !committed) {
             finishFailed(job, committed.error()); return;
         }
         std::filesystem::remove_all(job->temporaryTrace.parent_path(), error);
+        const auto storedBytes = directoryBytes(job->directory);
         {
             std::lock_guard lock(mutex_);
             job->snapshot.state = JobState::Completed;
             job->snapshot.completedAt = completedAt;
+            job->snapshot.storedBytes = storedBytes;
             job->snapshot.statusMessage = "Capture completed and committed to controlled storage.";
             job->lastAccess = monotonicNow();
-            if (active_ == job) active_.reset();
+            release(job);
+            catalog_.insert_or_assign(job->snapshot.id, CatalogEntry{job->snapshot, job->summary});
         }
+        saveCatalog();
+        trimResidentJobs(job);
+    }
+
+    // Frees the job's active slot. Callers hold mutex_.
+    void release(const std::shared_ptr<Job>& job) {
+        if (active_ == job) active_.reset();
+        if (activeFrames_ == job) activeFrames_.reset();
     }
 
     void finishFailed(const std::shared_ptr<Job>& job, const ProfilerError& error) {
@@ -1428,7 +2718,7 @@ private:
         job->snapshot.statusMessage = error.code + ": " + error.message;
         job->snapshot.completedAt = utcNow();
         job->lastAccess = monotonicNow();
-        if (active_ == job) active_.reset();
+        release(job);
     }
 
     void finishDiscarded(const std::shared_ptr<Job>& job, JobState state) {
@@ -1441,7 +2731,7 @@ private:
         job->snapshot.completedAt = utcNow();
         job->lastAccess = monotonicNow();
         job->snapshot.statusMessage = state == JobState::Aborted ? "Capture was aborted during shutdown." : "Capture was discarded and artifacts were removed.";
-        if (active_ == job) active_.reset();
+        release(job);
     }
 
     std::shared_ptr<Job> findJob(const JobId& id) const {
@@ -1454,45 +2744,91 @@ private:
                 return found->second;
             }
         }
-        if (id.empty() || id.size() > 128 || !std::all_of(id.begin(), id.end(), [](unsigned char value) {
-                return std::isalnum(value) || value == '-';
-            })) {
-            return nullptr;
-        }
+        if (!validJobId(id)) return nullptr;
         const auto directory = options_.storageRoot / id;
         std::error_code error;
         if (std::filesystem::is_symlink(std::filesystem::symlink_status(directory, error))) return nullptr;
-        std::ifstream manifestInput(directory / "manifest.json", std::ios::binary);
-        std::ifstream dataInput(directory / "data.json", std::ios::binary);
-        std::ifstream summaryInput(directory / "summary.json", std::ios::binary);
-        auto manifest = Json::parse(manifestInput, nullptr, false);
-        auto data = Json::parse(dataInput, nullptr, false);
-        auto summary = Json::parse(summaryInput, nullptr, false);
-        if (!manifest.is_object() || manifest.value("job_id", "") != id
-            || manifest.value("state", "") != "completed" || !data.is_object() || !summary.is_object()) {
-            return nullptr;
+        // The catalog describes the job; a job committed since the catalog loaded, by another MCDK on the same
+        // storage root, is read from its manifest and added.
+        loadCatalogOnce();
+        std::optional<CatalogEntry> entry;
+        {
+            std::lock_guard lock(mutex_);
+            if (const auto found = catalog_.find(id); found != catalog_.end()) entry = found->second;
         }
+        if (!entry) {
+            entry = readCommittedJob(directory);
+            if (!entry) return nullptr;
+            {
+                std::lock_guard lock(mutex_);
+                catalog_.insert_or_assign(id, *entry);
+            }
+            saveCatalog();
+        }
+        // Status and history only need the catalog entry; the profile is mapped when a request first reads it.
         auto job = std::make_shared<Job>();
-        job->snapshot.id = id;
-        const auto kind = manifest.value("kind", "");
-        job->snapshot.kind = kind == "python.memory" ? ProfilerKind::PythonMemory
-                           : kind == "native.cpu" ? ProfilerKind::NativeCpu : ProfilerKind::PythonCpu;
+        job->snapshot = std::move(entry->snapshot);
+        job->snapshot.statusMessage = "Recovered committed profiler job.";
         job->request.kind = job->snapshot.kind;
         job->request.storage = ProfileStorage::Disk;
-        job->snapshot.storage = ProfileStorage::Disk;
-        job->snapshot.state = JobState::Completed;
-        job->snapshot.partial = manifest.value("partial", false);
-        job->snapshot.createdAt = manifest.value("created_at", "");
-        job->snapshot.completedAt = manifest.value("completed_at", "");
-        job->snapshot.statusMessage = "Recovered committed profiler job.";
+        job->request.mode = job->snapshot.mode;
         job->directory = directory;
-        job->data = std::move(data);
-        job->summary = std::move(summary);
+        job->evicted = true;
+        job->summary = std::move(entry->summary);
         job->lastAccess = monotonicNow();
         std::lock_guard lock(mutex_);
         const auto [found, inserted] = jobs_.emplace(id, job);
         found->second->lastAccess = monotonicNow();
-        return inserted ? job : found->second;
+        return found->second;
+    }
+
+    static bool validJobId(const JobId& id) {
+        return !id.empty() && id.size() <= 128 && std::all_of(id.begin(), id.end(), [](unsigned char value) {
+            return std::isalnum(value) || value == '-';
+        });
+    }
+
+    // A committed job from its own manifest and summary; null unless the job completed and was fully written.
+    static std::optional<CatalogEntry> readCommittedJob(const std::filesystem::path& directory) {
+        std::ifstream manifestInput(directory / "manifest.json", std::ios::binary);
+        std::ifstream summaryInput(directory / "summary.json", std::ios::binary);
+        auto manifest = Json::parse(manifestInput, nullptr, false);
+        auto summary = Json::parse(summaryInput, nullptr, false);
+        if (!manifest.is_object() || manifest.value("job_id", "") != directory.filename().string()
+            || manifest.value("state", "") != "completed" || !summary.is_object()) {
+            return std::nullopt;
+        }
+        CatalogEntry entry{.summary = std::move(summary)};
+        auto& snapshot = entry.snapshot;
+        snapshot.id = manifest.value("job_id", "");
+        snapshot.kind = kindNamed(manifest.value("kind", ""));
+        snapshot.storage = ProfileStorage::Disk;
+        snapshot.state = JobState::Completed;
+        snapshot.partial = manifest.value("partial", false);
+        snapshot.createdAt = manifest.value("created_at", "");
+        snapshot.completedAt = manifest.value("completed_at", "");
+        snapshot.storedBytes = directoryBytes(directory);
+        snapshot.trigger = triggerContextFrom(manifest);
+        snapshot.statusMessage = "Recovered committed profiler job.";
+        return entry;
+    }
+
+    // Maps the encoded profile of a committed job; jobs committed before the binary format fall back to data.json.
+    static std::expected<std::shared_ptr<const ProfileStore>, ProfilerError>
+    loadStore(const std::filesystem::path& directory, ProfilerKind kind) {
+        std::error_code error;
+        if (std::filesystem::exists(directory / "data.mcprof", error)) {
+            auto image = ProfileImage::map(directory / "data.mcprof");
+            auto store = image ? openProfileStore(std::move(*image)) : std::unexpected(image.error());
+            if (store && (*store)->kind != kind) {
+                return std::unexpected(failure("PROFILE_IMAGE_INVALID", "The profile image holds another profiler kind."));
+            }
+            return store;
+        }
+        std::ifstream dataInput(directory / "data.json", std::ios::binary);
+        const auto data = Json::parse(dataInput, nullptr, false);
+        if (!data.is_object()) return std::unexpected(failure("PROFILE_IMAGE_INVALID", "data.json is missing or malformed."));
+        return buildProfileStore(kind, data);
     }
 
     [[nodiscard]] Clock::time_point monotonicNow() const {
@@ -1514,7 +2850,7 @@ private:
                 const bool idleExpired = now >= job->lastAccess
                     && now - job->lastAccess >= options_.memoryIdleTimeout;
                 if (job->request.storage == ProfileStorage::Memory && isTerminal(job->snapshot.state)
-                    && active_ != job && idleExpired) {
+                    && active_ != job && activeFrames_ != job && idleExpired) {
                     expired.push_back(job);
                     it = jobs_.erase(it);
                 } else {
@@ -1523,6 +2859,7 @@ private:
             }
         }
         for (const auto& job : expired) {
+            queryCache_.eraseJob(job->snapshot.id);
             if (job->worker.joinable() && job->worker.get_id() != std::this_thread::get_id()) {
                 job->worker.join();
             }
@@ -1534,10 +2871,16 @@ private:
         return job->snapshot;
     }
 
-    static std::string defaultSort(std::string_view view) {
+    static std::string defaultSort(ProfilerKind kind, std::string_view view) {
+        if (kind == ProfilerKind::PythonMemory && view.starts_with("calltree-")) return "inclusive_size";
         if (view == "growth") return "size_diff";
+        if (view == "growth-rate") return "slope";
+        if (view == "snapshots") return "elapsed";
         if (view == "retained") return "current_size";
-        if (view == "slowest-calls") return "duration";
+        if (view == "slowest-calls" || view == "worst-frames") return "duration";
+        if (view == "percentiles") return "p99";
+        if (view == "histogram") return "count";
+        if (view == "timeseries") return "maximum";
         return "total_time";
     }
 
@@ -1547,247 +2890,302 @@ private:
         return output.str();
     }
 
-    std::expected<std::vector<QueryRecord>, ProfilerError> recordsFor(const Job& job, std::string_view view) const {
-        std::vector<QueryRecord> records;
-        if (job.request.kind == ProfilerKind::PythonCpu) {
-            if (view == "hotspots") {
-                for (const auto& row : job.data.value("nodes", Json::array())) {
-                    if (!row.is_array() || row.size() < 11) continue;
-                    QueryRecord record{.id = "fn:" + std::to_string(row[0].get<std::int64_t>())};
-                    addField(record, "module", row[1].get<std::string>());
-                    addField(record, "line", row[2].get<std::int64_t>());
-                    addField(record, "name", row[3].get<std::string>());
-                    addField(record, "calls", row[4].get<std::int64_t>());
-                    addField(record, "actual_calls", row[5].get<std::int64_t>());
-                    addField(record, "self_time", row[6].get<double>(), "seconds");
-                    addField(record, "total_time", row[7].get<double>(), "seconds");
-                    addField(record, "context_id", row[8].get<std::int64_t>());
-                    addField(record, "context_name", row[9].get<std::string>());
-                    addField(record, "target", row[10].is_string() ? row[10].get<std::string>() : "unknown");
-                    records.push_back(std::move(record));
-                }
-                return records;
-            }
-            if (view == "calls") {
-                std::map<std::int64_t, const Json*> nodes;
-                if (const auto found = job.data.find("nodes"); found != job.data.end() && found->is_array()) {
-                    for (const auto& row : *found) {
-                        if (row.is_array() && row.size() >= 11 && row[0].is_number_integer()) {
-                            nodes.emplace(row[0].get<std::int64_t>(), &row);
-                        }
-                    }
-                }
-                for (const auto& row : job.data.value("edges", Json::array())) {
-                    if (!row.is_array() || row.size() < 5) continue;
-                    QueryRecord record{.id = "edge:" + std::to_string(records.size())};
-                    const auto callerId = row[0].get<std::int64_t>();
-                    const auto calleeId = row[1].get<std::int64_t>();
-                    addField(record, "caller_id", "fn:" + std::to_string(callerId));
-                    addField(record, "callee_id", "fn:" + std::to_string(calleeId));
-                    if (const auto caller = nodes.find(callerId); caller != nodes.end()) {
-                        addField(record, "caller_name", (*caller->second)[3].get<std::string>());
-                        addField(record, "caller_module", (*caller->second)[1].get<std::string>());
-                        addField(record, "caller_target", (*caller->second)[10].is_string() ? (*caller->second)[10].get<std::string>() : "unknown");
-                    }
-                    if (const auto callee = nodes.find(calleeId); callee != nodes.end()) {
-                        addField(record, "callee_name", (*callee->second)[3].get<std::string>());
-                        addField(record, "callee_module", (*callee->second)[1].get<std::string>());
-                        addField(record, "callee_target", (*callee->second)[10].is_string() ? (*callee->second)[10].get<std::string>() : "unknown");
-                    }
-                    addField(record, "calls", row[2].get<std::int64_t>());
-                    addField(record, "self_time", row[3].get<double>(), "seconds");
-                    addField(record, "total_time", row[4].get<double>(), "seconds");
-                    records.push_back(std::move(record));
-                }
-                return records;
-            }
-        } else if (job.request.kind == ProfilerKind::PythonMemory) {
-            if (view == "growth" || view == "retained") {
-                for (const auto& row : job.data.value("rows", Json::array())) {
-                    if (!row.is_array() || row.size() < 6) continue;
-                    const auto sizeDiff = row[1].get<std::int64_t>();
-                    const auto currentSize = row[3].get<std::int64_t>();
-                    if ((view == "growth" && sizeDiff == 0) || (view == "retained" && currentSize <= 0)) continue;
-                    QueryRecord record{.id = "allocation:" + std::to_string(row[0].get<std::int64_t>())};
-                    if (view == "growth") {
-                        addField(record, "size_diff", sizeDiff, "bytes");
-                        addField(record, "count_diff", row[2].get<std::int64_t>());
-                        addField(record, "direction", sizeDiff > 0 ? "growth" : "release");
-                    }
-                    addField(record, "current_size", currentSize, "bytes");
-                    addField(record, "current_count", row[4].get<std::int64_t>());
-                    ProfilerStackTrace traceback;
-                    if (row[5].is_array()) {
-                        for (const auto& frame : row[5]) {
-                            if (!frame.is_array() || frame.size() < 2 || !frame[0].is_string() || !frame[1].is_number_integer()) continue;
-                            auto file = frame[0].get<std::string>();
-                            if (file.size() > 4096) file.resize(4096);
-                            traceback.push_back({std::move(file), frame[1].get<std::int64_t>()});
-                        }
-                    }
-                    addField(record, "traceback", std::move(traceback));
-                    records.push_back(std::move(record));
-                }
-                return records;
+    // Completed jobs carry a store until they are discarded, so every request holds its own reference; a discarded
+    // job's is null. A disk job that is not mapped maps its image now, and two requests racing to do so keep the first
+    // mapping. A job whose image cannot be mapped reports why as PROFILE_UNAVAILABLE.
+    std::expected<std::shared_ptr<const ProfileStore>, ProfilerError> storeOf(const std::shared_ptr<Job>& job) const {
+        {
+            std::lock_guard lock(mutex_);
+            if (!job->evicted) return job->store;
+        }
+        auto store = loadStore(job->directory, job->request.kind);
+        if (!store) {
+            return std::unexpected(failure(
+                "PROFILE_UNAVAILABLE",
+                "The stored profile of job " + job->snapshot.id + " could not be loaded: " + store.error().message
+            ));
+        }
+        std::shared_ptr<const ProfileStore> result;
+        {
+            std::lock_guard lock(mutex_);
+            if (job->evicted) {
+                job->store = std::move(*store);
+                job->evicted = false;
             }
-        } else {
-            if (view == "hotspots") {
-                for (const auto& zone : job.data.value("zones", Json::array())) {
-                    if (!zone.is_object()) continue;
-                    QueryRecord record{.id = "zone:" + std::to_string(jsonInteger(zone, "id"))};
-                    addField(record, "name", jsonString(zone, "name", 1024));
-                    addField(record, "source_file", jsonString(zone, "sourceFile"));
-                    addField(record, "source_line", jsonInteger(zone, "sourceLine"));
-                    addField(record, "thread_id", jsonString(zone, "threadId", 128));
-                    addField(record, "thread_name", jsonString(zone, "threadName", 512));
-                    addField(record, "calls", jsonInteger(zone, "calls"));
-                    addField(record, "total_time", jsonInteger(zone, "totalNanoseconds"), "nanoseconds");
-                    addField(record, "self_time", jsonInteger(zone, "selfNanoseconds"), "nanoseconds");
-                    addField(record, "mean_time", jsonInteger(zone, "meanNanoseconds"), "nanoseconds");
-                    addField(record, "maximum_time", jsonInteger(zone, "maximumNanoseconds"), "nanoseconds");
-                    records.push_back(std::move(record));
-                }
-                return records;
-            }
-            if (view == "source-locations") {
-                struct Aggregate {
-                    std::string name;
-                    std::string file;
-                    std::int64_t line = 0;
-                    std::int64_t calls = 0;
-                    std::int64_t total = 0;
-                    std::int64_t self = 0;
-                    std::int64_t maximum = 0;
-                    std::set<std::string> threads;
-                };
-                std::map<std::string, Aggregate> aggregates;
-                for (const auto& zone : job.data.value("zones", Json::array())) {
-                    if (!zone.is_object()) continue;
-                    const auto name = jsonString(zone, "name", 1024);
-                    const auto file = jsonString(zone, "sourceFile");
-                    const auto line = jsonInteger(zone, "sourceLine");
-                    const auto key = name + '\0' + file + '\0' + std::to_string(line);
-                    auto& aggregate = aggregates[key];
-                    aggregate.name = name;
-                    aggregate.file = file;
-                    aggregate.line = line;
-                    aggregate.calls += jsonInteger(zone, "calls");
-                    aggregate.total += jsonInteger(zone, "totalNanoseconds");
-                    aggregate.self += jsonInteger(zone, "selfNanoseconds");
-                    aggregate.maximum = std::max(aggregate.maximum, jsonInteger(zone, "maximumNanoseconds"));
-                    auto thread = jsonString(zone, "threadName", 512);
-                    if (thread.empty()) thread = jsonString(zone, "threadId", 128);
-                    aggregate.threads.insert(std::move(thread));
-                }
-                for (auto& [key, aggregate] : aggregates) {
-                    (void)key;
-                    QueryRecord record{.id = "source:" + std::to_string(records.size())};
-                    addField(record, "name", std::move(aggregate.name));
-                    addField(record, "source_file", std::move(aggregate.file));
-                    addField(record, "source_line", aggregate.line);
-                    addField(record, "thread_count", static_cast<std::int64_t>(aggregate.threads.size()));
-                    addField(record, "calls", aggregate.calls);
-                    addField(record, "total_time", aggregate.total, "nanoseconds");
-                    addField(record, "self_time", aggregate.self, "nanoseconds");
-                    addField(record, "mean_time", aggregate.calls == 0 ? 0 : aggregate.total / aggregate.calls, "nanoseconds");
-                    addField(record, "maximum_time", aggregate.maximum, "nanoseconds");
-                    records.push_back(std::move(record));
-                }
-                return records;
-            }
-            if (view == "slowest-calls") {
-                for (const auto& zone : job.data.value("zones", Json::array())) {
-                    if (!zone.is_object() || !zone.value("slowestCalls", Json::array()).is_array()) continue;
-                    std::size_t sampleIndex = 0;
-                    for (const auto& sample : zone["slowestCalls"]) {
-                        if (!sample.is_object()) continue;
-                        QueryRecord record{
-                            .id = "sample:" + std::to_string(jsonInteger(zone, "id")) + ':' + std::to_string(sampleIndex++)
-                        };
-                        addField(record, "zone_id", "zone:" + std::to_string(jsonInteger(zone, "id")));
-                        addField(record, "name", jsonString(zone, "name", 1024));
-                        addField(record, "source_file", jsonString(zone, "sourceFile"));
-                        addField(record, "source_line", jsonInteger(zone, "sourceLine"));
-                        addField(record, "thread_id", jsonString(zone, "threadId", 128));
-                        addField(record, "thread_name", jsonString(zone, "threadName", 512));
-                        addField(record, "start_time", jsonInteger(sample, "startNanoseconds"), "nanoseconds");
-                        addField(record, "duration", jsonInteger(sample, "durationNanoseconds"), "nanoseconds");
-                        records.push_back(std::move(record));
-                    }
+            job->lastAccess = monotonicNow();
+            result = job->store;
+        }
+        if (result) trimResidentJobs(job);
+        return result;
+    }
+
+    // Drops the stores of the least recently accessed committed disk jobs until the resident ones fit the budget.
+    // Memory jobs cannot be reloaded, so they stay until they expire; the job just accessed is always kept.
+    void trimResidentJobs(const std::shared_ptr<Job>& keep) const {
+        std::vector<JobId> evicted;
+        {
+            std::lock_guard lock(mutex_);
+            std::vector<Job*> resident;
+            std::size_t total = 0;
+            for (const auto& [id, job] : jobs_) {
+                if (job->request.storage != ProfileStorage::Disk || job->snapshot.state != JobState::Completed
+                    || !job->store || job == active_ || job == activeFrames_) {
+                    continue;
                 }
-                return records;
-            }
-            if (view == "threads") {
-                for (const auto& thread : job.data.value("threads", Json::array())) {
-                    QueryRecord record{.id = "thread:" + jsonString(thread, "id", 128)};
-                    addField(record, "name", jsonString(thread, "name", 512));
-                    addField(record, "calls", jsonInteger(thread, "calls"));
-                    addField(record, "total_time", jsonInteger(thread, "totalNanoseconds"), "nanoseconds");
-                    records.push_back(std::move(record));
+                total += job->store->image->bytes().size();
+                resident.push_back(job.get());
+            }
+            if (total <= options_.residentJobBytes) return;
+            std::sort(resident.begin(), resident.end(), [](const Job* left, const Job* right) {
+                return left->lastAccess < right->lastAccess;
+            });
+            for (auto* job : resident) {
+                if (total <= options_.residentJobBytes) break;
+                if (job == keep.get()) continue;
+                total -= job->store->image->bytes().size();
+                job->store.reset();
+                job->evicted = true;
+                evicted.push_back(job->snapshot.id);
+            }
+        }
+        // Cached indexes would hold the dropped store alive.
+        for (const auto& id : evicted) queryCache_.eraseJob(id);
+    }
+
+    // Rows of the view stably ordered by one text column, or by record id when column is empty, so rows with equal
+    // text stay in view order. Detail lookups binary-search it instead of scanning the view.
+    std::shared_ptr<const RowIndex> rowsByText(
+        const std::string& jobId,
+        const std::shared_ptr<const ProfileStore>& store,
+        const ProfileView& view,
+        std::string_view column
+    ) const {
+        return queryCache_.obtain<RowIndex>(QueryCache::key(jobId, {"by-text", view.name, column}), store, [&] {
+            RowIndex result;
+            const auto& ids = store->tableOf(view).ids;
+            const auto* keyColumn = column.empty() ? nullptr : store->column(view, column);
+            if (!column.empty() && !keyColumn) return result;
+            const auto keyOf = [&](std::uint32_t row) { return keyColumn ? keyColumn->text(row) : ids[row]; };
+            result.rows.assign(view.rows.begin(), view.rows.end());
+            std::stable_sort(result.rows.begin(), result.rows.end(), [&](std::uint32_t left, std::uint32_t right) {
+                return keyOf(left) < keyOf(right);
+            });
+            return result;
+        });
+    }
+
+    template <class KeyOf>
+    static std::span<const std::uint32_t> rowsWithText(const RowIndex& index, KeyOf keyOf, StringId text) {
+        const auto [begin, end] = std::ranges::equal_range(index.rows, text, std::ranges::less{}, keyOf);
+        return {begin, end};
+    }
+
+    // A null result means the job was discarded or its kind has no such view.
+    static const ProfileView* viewFor(const ProfileStore* store, std::string_view view) {
+        return store ? store->view(view) : nullptr;
+    }
+
+    // Views whose rows keep a stable identity across captures, so that compare and trend can align them.
+    static bool comparableView(ProfilerKind kind, std::string_view view) {
+        switch (kind) {
+        case ProfilerKind::PythonCpu: return view == "hotspots";
+        case ProfilerKind::PythonMemory: return view == "growth" || view == "retained";
+        case ProfilerKind::NativeCpu: return view == "hotspots" || view == "source-locations" || view == "threads";
+        case ProfilerKind::FrameTime: return view == "percentiles";
+        }
+        return false;
+    }
+
+    static bool comparableMetric(ProfilerKind kind, std::string_view view, std::string_view metric) {
+        if (kind == ProfilerKind::PythonCpu) {
+            return metric == "calls" || metric == "actual_calls" || metric == "self_time" || metric == "total_time";
+        }
+        if (kind == ProfilerKind::PythonMemory) {
+            if (view == "growth") {
+                return metric == "size_diff" || metric == "count_diff" || metric == "current_size"
+                    || metric == "current_count";
+            }
+            return metric == "current_size" || metric == "current_count";
+        }
+        if (kind == ProfilerKind::FrameTime) {
+            return metric == "mean" || metric == "p50" || metric == "p90" || metric == "p99" || metric == "maximum";
+        }
+        if (view == "threads") return metric == "calls" || metric == "total_time";
+        return metric == "calls" || metric == "total_time" || metric == "self_time" || metric == "mean_time"
+            || metric == "maximum_time";
+    }
+
+    static std::vector<std::string_view> compareIdentity(ProfilerKind kind, std::string_view view) {
+        if (kind == ProfilerKind::PythonCpu) return {"target", "module", "line", "name", "context_name"};
+        if (kind == ProfilerKind::PythonMemory) return {"traceback"};
+        if (kind == ProfilerKind::FrameTime) return {"side"};
+        if (view == "threads") return {"name"};
+        if (view == "source-locations") return {"name", "source_file", "source_line"};
+        return {"name", "source_file", "source_line", "thread_name"};
+    }
+
+    static ProfilerError compareViewInvalid() {
+        return failure(
+            "COMPARE_VIEW_INVALID",
+            "This view has no stable cross-capture identity. Compare hotspots, growth, retained, source-locations, threads, or percentiles as appropriate."
+        );
+    }
+
+    static ProfilerError compareMetricInvalid() {
+        return failure("COMPARE_METRIC_INVALID", "The requested metric is not a comparable performance metric for this profiler view.");
+    }
+
+    // The metric of one job's view summed per identity. It depends only on the job, view and metric, so comparing one
+    // baseline with many candidates, or a trend over a sliding window of runs, folds each job once.
+    std::shared_ptr<const CompareSide> compareSide(
+        const JobId&                               jobId,
+        const std::shared_ptr<const ProfileStore>& profile,
+        const ProfileView&                         view,
+        const std::string&                         metric
+    ) const {
+        return queryCache_.obtain<CompareSide>(QueryCache::key(jobId, {"compare", view.name, metric}), profile, [&] {
+            CompareSide side;
+            const auto& store = *profile;
+            const auto* column = store.column(view, metric);
+            if (!column) return side;
+            std::vector<const ProfileColumn*> keyColumns;
+            for (const auto name : compareIdentity(store.kind, view.name)) keyColumns.push_back(store.column(view, name));
+            std::string key;
+            for (const auto row : view.rows) {
+                const auto numeric = cellNumber(*column, row);
+                if (!numeric) continue;
+                key.clear();
+                for (const auto* keyColumn : keyColumns) {
+                    key.push_back('\x1f');
+                    if (keyColumn) appendCellText(store, *keyColumn, row, key);
                 }
-                return records;
+                const auto [entry, inserted] = side.values.try_emplace(key);
+                auto& value = entry->second;
+                value.value += *numeric;
+                value.unit = column->unit;
+                if (!value.source) value.source = row;
+                if (inserted) side.footprint += key.size() + value.unit.size() + 96;
             }
-            if (view == "calltree-roots" || view == "calltree-children") {
-                for (const auto& thread : job.data.value("threads", Json::array())) {
-                    flattenNodes(thread.value("roots", Json::array()), jsonString(thread, "id", 128), "", 0, records);
+            return side;
+        });
+    }
+
+    // The fields that name a compared row, copied from the row that carried its identity.
+    static void addIdentityFields(QueryRecord& record, const ProfileStore& store, const ProfileView& view, std::uint32_t row) {
+        static constexpr std::array<std::string_view, 10> IdentityFields = {
+            "name", "module", "line", "target", "context_name",
+            "source_file", "source_line", "thread_name", "thread_count", "traceback"
+        };
+        for (const auto fieldName : IdentityFields) {
+            const auto* column = store.column(view, fieldName);
+            if (column && column->has(row)) record.fields.emplace(column->name, cellField(store, *column, row));
+        }
+    }
+
+    static ProfilerError viewInvalid() {
+        return failure("VIEW_INVALID", "The requested view is not available for this profiler kind.");
+    }
+
+    // Every disk job, newest first: the catalog, overlaid with this session's disk jobs that are still running. Job
+    // ids start with their creation time in milliseconds, so they order jobs created within the same second.
+    std::vector<JobSnapshot> catalog() const {
+        loadCatalogOnce();
+        std::vector<JobSnapshot> values;
+        {
+            std::lock_guard lock(mutex_);
+            values.reserve(catalog_.size());
+            for (const auto& [id, entry] : catalog_) {
+                if (!jobs_.contains(id)) values.push_back(entry.snapshot);
+            }
+            for (const auto& [id, job] : jobs_) {
+                if (job->request.storage == ProfileStorage::Disk) values.push_back(job->snapshot);
+            }
+        }
+        std::sort(values.begin(), values.end(), [](const auto& left, const auto& right) {
+            return left.createdAt != right.createdAt ? left.createdAt > right.createdAt : left.id > right.id;
+        });
+        return values;
+    }
+
+    // Reads the catalog index once per session and reconciles it with the job directories by name, so only jobs
+    // committed without updating it, by an older build or before a crash, read their manifests. A missing or
+    // unreadable index is rebuilt from every manifest.
+    void loadCatalogOnce() const {
+        bool changed = false;
+        {
+            std::lock_guard lock(mutex_);
+            if (catalogLoaded_) return;
+            catalogLoaded_ = true;
+            std::ifstream input(options_.storageRoot / CatalogFile, std::ios::binary);
+            const auto index = Json::parse(input, nullptr, false);
+            if (index.is_object() && index.value("schema", 0) == CatalogSchema && index.contains("jobs")
+                && index["jobs"].is_array()) {
+                for (const auto& item : index["jobs"]) {
+                    if (auto entry = catalogEntryFrom(item)) catalog_.insert_or_assign(entry->snapshot.id, std::move(*entry));
                 }
-                if (view == "calltree-roots") {
-                    std::erase_if(records, [](const auto& record) {
-                        const auto parent = record.fields.find("parent_id");
-                        return parent != record.fields.end() && !fieldText(parent->second).empty();
-                    });
+            } else {
+                changed = true;
+            }
+            std::unordered_map<JobId, bool> present;
+            std::error_code error;
+            for (std::filesystem::directory_iterator it(options_.storageRoot, error), end; !error && it != end; it.increment(error)) {
+                const auto name = it->path().filename().string();
+                if (!it->is_directory(error) || it->is_symlink(error) || !validJobId(name)) continue;
+                present.emplace(name, true);
+                if (catalog_.contains(name)) continue;
+                if (auto entry = readCommittedJob(it->path())) {
+                    catalog_.insert_or_assign(name, std::move(*entry));
+                    changed = true;
                 }
-                return records;
+            }
+            // A listing cut short proves nothing about the jobs it did not reach.
+            if (!error) {
+                changed |= std::erase_if(catalog_, [&](const auto& item) { return !present.contains(item.first); }) > 0;
             }
         }
-        return std::unexpected(failure("VIEW_INVALID", "The requested view is not available for this profiler kind."));
+        if (changed) saveCatalog();
     }
 
-    static void flattenNodes(const Json& nodes, const std::string& threadId, const std::string& parent, std::int64_t depth, std::vector<QueryRecord>& output) {
-        if (!nodes.is_array()) return;
-        for (const auto& node : nodes) {
-            const auto id = "node:" + std::to_string(jsonInteger(node, "id"));
-            QueryRecord record{.id = id};
-            addField(record, "parent_id", parent);
-            addField(record, "thread_id", threadId);
-            addField(record, "depth", depth);
-            addField(record, "name", jsonString(node, "name", 1024));
-            addField(record, "source_file", jsonString(node, "sourceFile"));
-            addField(record, "source_line", jsonInteger(node, "sourceLine"));
-            addField(record, "calls", jsonInteger(node, "calls"));
-            addField(record, "total_time", jsonInteger(node, "totalNanoseconds"), "nanoseconds");
-            addField(record, "self_time", jsonInteger(node, "selfNanoseconds"), "nanoseconds");
-            addField(record, "mean_time", jsonInteger(node, "meanNanoseconds"), "nanoseconds");
-            addField(record, "maximum_time", jsonInteger(node, "maximumNanoseconds"), "nanoseconds");
-            output.push_back(std::move(record));
-            flattenNodes(node.value("children", Json::array()), threadId, id, depth + 1, output);
+    // Rewrites the index from the in-memory catalog. The manifests stay authoritative, so a failed write only costs
+    // the next session a reconciliation.
+    void saveCatalog() const {
+        std::lock_guard writeLock(catalogWriteMutex_);
+        Json jobs = Json::array();
+        {
+            std::lock_guard lock(mutex_);
+            for (const auto& [id, entry] : catalog_) jobs.push_back(catalogJson(entry));
         }
+        (void)writeAtomic(options_.storageRoot / CatalogFile, Json{{"schema", CatalogSchema}, {"jobs", std::move(jobs)}}.dump(), true);
     }
 
-    void scanHistoryOnce() const {
-        std::lock_guard lock(mutex_);
-        if (historyScanned_) return;
-        historyScanned_ = true;
-        std::error_code error;
-        for (std::filesystem::directory_iterator it(options_.storageRoot, error), end; !error && it != end; it.increment(error)) {
-            if (!it->is_directory(error) || it->is_symlink(error)) continue;
-            const auto manifestPath = it->path() / "manifest.json";
-            std::ifstream input(manifestPath, std::ios::binary);
-            Json manifest = Json::parse(input, nullptr, false);
-            if (!manifest.is_object() || manifest.value("state", "") != "completed") continue;
-            JobSnapshot snapshot;
-            snapshot.id = manifest.value("job_id", "");
-            const auto kind = manifest.value("kind", "");
-            snapshot.kind = kind == "python.memory" ? ProfilerKind::PythonMemory
-                          : kind == "native.cpu" ? ProfilerKind::NativeCpu : ProfilerKind::PythonCpu;
-            snapshot.storage = ProfileStorage::Disk;
-            snapshot.state = JobState::Completed;
-            snapshot.partial = manifest.value("partial", false);
-            snapshot.createdAt = manifest.value("created_at", "");
-            snapshot.completedAt = manifest.value("completed_at", "");
-            snapshot.statusMessage = "Recovered committed profiler job.";
-            if (!snapshot.id.empty()) historyCache_.push_back(std::move(snapshot));
-        }
+    static Json catalogJson(const CatalogEntry& entry) {
+        const auto& snapshot = entry.snapshot;
+        Json result{
+            {"job_id", snapshot.id}, {"kind", toString(snapshot.kind)}, {"mode", toString(snapshot.mode)},
+            {"created_at", snapshot.createdAt}, {"completed_at", snapshot.completedAt}, {"partial", snapshot.partial},
+            {"stored_bytes", snapshot.storedBytes}, {"summary", entry.summary},
+        };
+        if (snapshot.trigger) result["trigger"] = triggerContextJson(*snapshot.trigger);
+        return result;
+    }
+
+    static std::optional<CatalogEntry> catalogEntryFrom(const Json& item) {
+        if (!item.is_object() || !item.contains("summary") || !item["summary"].is_object()) return std::nullopt;
+        CatalogEntry entry{.summary = item["summary"]};
+        auto& snapshot = entry.snapshot;
+        snapshot.id = item.value("job_id", "");
+        if (!validJobId(snapshot.id)) return std::nullopt;
+        snapshot.kind = kindNamed(item.value("kind", ""));
+        snapshot.mode = item.value("mode", "") == "recorder" ? ProfileMode::Recorder : ProfileMode::Capture;
+        snapshot.storage = ProfileStorage::Disk;
+        snapshot.state = JobState::Completed;
+        snapshot.partial = item.value("partial", false);
+        snapshot.createdAt = item.value("created_at", "");
+        snapshot.completedAt = item.value("completed_at", "");
+        snapshot.storedBytes = item.value("stored_bytes", std::uintmax_t{0});
+        snapshot.trigger = triggerContextFrom(item);
+        snapshot.statusMessage = "Recovered committed profiler job.";
+        return entry;
     }
 
     ProfilerServiceOptions options_;
@@ -1795,8 +3193,12 @@ private:
     mutable std::mutex mutex_;
     mutable std::unordered_map<JobId, std::shared_ptr<Job>> jobs_;
     std::shared_ptr<Job> active_;
-    mutable bool historyScanned_ = false;
-    mutable std::vector<JobSnapshot> historyCache_;
+    std::shared_ptr<Job> activeFrames_;
+    std::vector<std::shared_ptr<Trigger>> triggers_;
+    mutable bool catalogLoaded_ = false;
+    mutable std::map<JobId, CatalogEntry> catalog_; // Guarded by mutex_.
+    mutable std::mutex catalogWriteMutex_;           // Orders index rewrites.
+    mutable QueryCache queryCache_;
     std::atomic<bool> shuttingDown_ = false;
 };
 
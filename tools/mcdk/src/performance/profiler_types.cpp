@@ -10,6 +10,8 @@ namespace mcdk::performance {
             return "python.memory";
         case ProfilerKind::NativeCpu:
             return "native.cpu";
+        case ProfilerKind::FrameTime:
+            return "frame.time";
         }
         return "unknown";
     }
@@ -24,6 +26,50 @@ namespace mcdk::performance {
         return "unknown";
     }
 
+    const char* toString(ProfileMode value) noexcept {
+        switch (value) {
+        case ProfileMode::Capture:
+            return "capture";
+        case ProfileMode::Recorder:
+            return "recorder";
+        }
+        return "unknown";
+    }
+
+    const char* toString(ProfileEngine value) noexcept {
+        switch (value) {
+        case ProfileEngine::Tracing:
+            return "tracing";
+        case ProfileEngine::Sampling:
+            return "sampling";
+        }
+        return "unknown";
+    }
+
+    const char* toString(TriggerCondition value) noexcept {
+        switch (value) {
+        case TriggerCondition::TickTime:
+            return "tick_time";
+        case TriggerCondition::LogPattern:
+            return "log_pattern";
+        }
+        return "unknown";
+    }
+
+    const char* toString(TriggerState value) noexcept {
+        switch (value) {
+        case TriggerState::Armed:
+            return "armed";
+        case TriggerState::Exhausted:
+            return "exhausted";
+        case TriggerState::Disarmed:
+            return "disarmed";
+        case TriggerState::Failed:
+            return "failed";
+        }
+        return "unknown";
+    }
+
     const char* toString(JobState value) noexcept {
         switch (value) {
         case JobState::Created:
@@ -0,0 +1,77 @@
+#include <performance/query_cache.hpp>
+
+namespace mcdk::performance {
+namespace {
+
+    // Bookkeeping of one entry beyond its key and value: list node, hash node and control blocks.
+    constexpr std::size_t EntryOverhead = 128;
+
+} // namespace
+
+    std::string QueryCache::key(std::string_view jobId, std::initializer_list<std::string_view> parts) {
+        std::string result(jobId);
+        result += '|';
+        for (const auto part : parts) {
+            result += std::to_string(part.size());
+            result += ':';
+            result += part;
+        }
+        return result;
+    }
+
+    std::shared_ptr<const void> QueryCache::lookup(const std::string& key, const std::shared_ptr<const ProfileStore>& store) {
+        std::lock_guard lock(mutex_);
+        const auto found = index_.find(key);
+        if (found == index_.end()) return nullptr;
+        const auto entry = found->second;
+        if (entry->store.lock() != store) {
+            erase(entry);
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, entry);
+        return entry->value;
+    }
+
+    void QueryCache::remember(
+        const std::string&                         key,
+        const std::shared_ptr<const ProfileStore>& store,
+        std::shared_ptr<const void>                value,
+        std::size_t                                bytes
+    ) {
+        bytes += key.size() + EntryOverhead;
+        if (bytes > maximumBytes_) return;
+        std::lock_guard lock(mutex_);
+        if (const auto found = index_.find(key); found != index_.end()) erase(found->second);
+        entries_.push_front({.key = key, .store = store, .value = std::move(value), .bytes = bytes});
+        index_.emplace(entries_.front().key, entries_.begin());
+        bytes_ += bytes;
+        while (bytes_ > maximumBytes_) erase(std::prev(entries_.end()));
+    }
+
+    void QueryCache::eraseJob(std::string_view jobId) {
+        std::lock_guard lock(mutex_);
+        for (auto entry = entries_.begin(); entry != entries_.end();) {
+            const std::string_view key = entry->key;
+            const auto             next = std::next(entry);
+            if (key.size() > jobId.size() && key.starts_with(jobId) && key[jobId.size()] == '|') erase(entry);
+            entry = next;
+        }
+    }
+
+    std::size_t QueryCache::bytes() const {
+        std::lock_guard lock(mutex_);
+        return bytes_;
+    }
+
+    std::size_t QueryCache::size() const {
+        std::lock_guard lock(mutex_);
+        return entries_.size();
+    }
+
+    void QueryCache::erase(Entries::iterator entry) {
+        bytes_ -= entry->bytes;
+        index_.erase(entry->key);
+        entries_.erase(entry);
+    }
+
+} // namespace mcdk::performance
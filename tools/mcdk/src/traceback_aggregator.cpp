@@ -0,0 +1,237 @@
+#include <traceback_aggregator.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace mcdk {
+
+    namespace {
+        constexpr std::string_view TRACEBACK_HEADER = "Traceback (most recent call last):";
+        constexpr std::string_view FILE_PREFIX      = "File \"";
+
+        bool isSpace(char ch) { return ch == ' ' || ch == '\t'; }
+        bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+        bool isHexDigit(char ch) { return isDigit(ch) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F'); }
+
+        bool isIdentifierChar(char ch) {
+            return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || isDigit(ch) || ch == '_' || ch == '.';
+        }
+
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && (isSpace(text.front()) || text.front() == '\r')) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && (isSpace(text.back()) || text.back() == '\r')) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        // Parses `File "<file>", line <n>[, in <function>]` starting at the File keyword.
+        std::optional<TracebackFrame> parseFrame(std::string_view text) {
+            text.remove_prefix(FILE_PREFIX.size());
+            const auto quote = text.find('"');
+            if (quote == std::string_view::npos) {
+                return std::nullopt;
+            }
+            TracebackFrame frame;
+            frame.file = std::string(text.substr(0, quote));
+            text.remove_prefix(quote + 1);
+            if (!text.starts_with(", line ")) {
+                return std::nullopt;
+            }
+            text.remove_prefix(7);
+            std::size_t digits = 0;
+            while (digits < text.size() && isDigit(text[digits])) {
+                frame.line = frame.line * 10 + static_cast<std::uint32_t>(text[digits] - '0');
+                ++digits;
+            }
+            if (digits == 0) {
+                return std::nullopt;
+            }
+            text.remove_prefix(digits);
+            if (text.starts_with(", in ")) {
+                frame.function = std::string(trim(text.substr(5)));
+            }
+            return frame;
+        }
+
+        void hashBytes(std::uint64_t& hash, std::string_view bytes) {
+            for (const auto byte : bytes) {
+                hash ^= static_cast<unsigned char>(byte);
+                hash *= 0x100000001b3ull;
+            }
+            hash ^= 0xFF; // Field separator, so ("ab", "c") and ("a", "bc") differ.
+            hash *= 0x100000001b3ull;
+        }
+
+        std::int64_t nowMs() {
+            const auto now = std::chrono::system_clock::now().time_since_epoch();
+            return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+        }
+    } // namespace
+
+    TracebackAggregator::TracebackAggregator(std::size_t maxGroups) : mMaxGroups(std::max<std::size_t>(maxGroups, 1)) {}
+
+    std::optional<PythonTraceback> TracebackAggregator::feed(std::string_view line) { return feed(line, nowMs()); }
+
+    std::optional<PythonTraceback> TracebackAggregator::feed(std::string_view line, std::int64_t timestampMs) {
+        std::lock_guard lock(mMutex);
+        if (line.find(TRACEBACK_HEADER) != std::string_view::npos) {
+            // A header inside an unfinished traceback means the previous one was cut off; it has no exception line
+            // to group by, so it is dropped.
+            mPending.emplace();
+            return std::nullopt;
+        }
+        if (!mPending) {
+            return std::nullopt;
+        }
+
+        const auto text = trim(line);
+        if (text.empty()) {
+            return std::nullopt;
+        }
+        if (const auto file = line.find(FILE_PREFIX); file != std::string_view::npos) {
+            if (auto frame = parseFrame(line.substr(file))) {
+                mPending->frames.push_back(std::move(*frame));
+                return std::nullopt;
+            }
+        }
+        if (isSpace(line.front())) {
+            // Source line under a frame, or the caret marker of a SyntaxError.
+            if (!mPending->frames.empty() && mPending->frames.back().source.empty()) {
+                mPending->frames.back().source = std::string(text);
+            }
+            return std::nullopt;
+        }
+
+        // The first unindented line after the frames is the exception: "Type: message" or just "Type".
+        auto       traceback = std::move(*mPending);
+        const auto colon     = text.find(':');
+        mPending.reset();
+        if (colon != std::string_view::npos && colon > 0
+            && std::ranges::all_of(text.substr(0, colon), isIdentifierChar)) {
+            traceback.exceptionType = std::string(text.substr(0, colon));
+            traceback.message       = std::string(trim(text.substr(colon + 1)));
+        } else {
+            traceback.exceptionType = std::string(text);
+        }
+        record(traceback, timestampMs);
+        return traceback;
+    }
+
+    std::string TracebackAggregator::normalizeMessage(std::string_view message) {
+        std::string normalized;
+        normalized.reserve(message.size());
+        for (std::size_t index = 0; index < message.size();) {
+            const char ch = message[index];
+            if (ch == '\'' || ch == '"') {
+                const auto close = message.find(ch, index + 1);
+                if (close != std::string_view::npos) {
+                    normalized += ch;
+                    normalized += '?';
+                    normalized += ch;
+                    index = close + 1;
+                    continue;
+                }
+            }
+            if (ch == '0' && index + 2 < message.size() && (message[index + 1] == 'x' || message[index + 1] == 'X')
+                && isHexDigit(message[index + 2])) {
+                index += 2;
+                while (index < message.size() && isHexDigit(message[index])) {
+                    ++index;
+                }
+                normalized += "0x?";
+                continue;
+            }
+            if (isDigit(ch)) {
+                while (index < message.size() && (isDigit(message[index]) || message[index] == '.')) {
+                    ++index;
+                }
+                normalized += '#';
+                continue;
+            }
+            normalized += ch;
+            ++index;
+        }
+        return normalized;
+    }
+
+    std::uint64_t TracebackAggregator::signatureOf(const PythonTraceback& traceback) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        hashBytes(hash, traceback.exceptionType);
+        hashBytes(hash, normalizeMessage(traceback.message));
+        for (const auto& frame : traceback.frames) {
+            hashBytes(hash, frame.file);
+            hashBytes(hash, frame.function);
+        }
+        return hash;
+    }
+
+    void TracebackAggregator::record(PythonTraceback traceback, std::int64_t timestampMs) {
+        ++mTotalCount;
+        const auto signature = signatureOf(traceback);
+        auto       it        = mGroups.find(signature);
+        if (it == mGroups.end()) {
+            if (mGroups.size() >= mMaxGroups) {
+                const auto stalest = std::ranges::min_element(mGroups, {}, [](const auto& entry) {
+                    return entry.second.lastSeenMs;
+                });
+                mGroups.erase(stalest);
+            }
+            it = mGroups
+                     .emplace(
+                         signature,
+                         TracebackGroup{
+                             .signature         = signature,
+                             .normalizedMessage = normalizeMessage(traceback.message),
+                             .firstSeenMs       = timestampMs,
+                         }
+                     )
+                     .first;
+        }
+        auto& group      = it->second;
+        group.latest     = std::move(traceback);
+        group.lastSeenMs = timestampMs;
+        ++group.count;
+    }
+
+    std::vector<TracebackGroup> TracebackAggregator::groups(Order order, std::size_t maxCount) const {
+        std::vector<TracebackGroup> result;
+        {
+            std::lock_guard lock(mMutex);
+            result.reserve(mGroups.size());
+            for (const auto& [signature, group] : mGroups) {
+                result.push_back(group);
+            }
+        }
+        if (order == Order::MostFrequent) {
+            std::ranges::sort(result, [](const TracebackGroup& left, const TracebackGroup& right) {
+                return left.count != right.count ? left.count > right.count : left.lastSeenMs > right.lastSeenMs;
+            });
+        } else {
+            std::ranges::sort(result, [](const TracebackGroup& left, const TracebackGroup& right) {
+                return left.lastSeenMs != right.lastSeenMs ? left.lastSeenMs > right.lastSeenMs
+                                                           : left.count > right.count;
+            });
+        }
+        if (result.size() > maxCount) {
+            result.resize(maxCount);
+        }
+        return result;
+    }
+
+    std::uint64_t TracebackAggregator::totalCount() const {
+        std::lock_guard lock(mMutex);
+        return mTotalCount;
+    }
+
+    void TracebackAggregator::clear() {
+        std::lock_guard lock(mMutex);
+        mPending.reset();
+        mGroups.clear();
+        mTotalCount = 0;
+    }
+
+} // namespace mcdk
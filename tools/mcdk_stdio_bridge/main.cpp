@@ -23,14 +23,18 @@
 #include <cctype>
 #include <chrono>
 #include <clocale>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -58,6 +62,7 @@ namespace {
     constexpr int         ConnectTimeoutSeconds    = 1;
     constexpr int         ReadWriteTimeoutSeconds  = 30;
     constexpr int         InitializationTimeoutSec = 3;
+    constexpr int         EventStreamTimeoutSec    = 60; // The server sends a heartbeat every 10 s on a quiet stream.
 
     struct BridgeConfig {
         std::string host = DefaultHost;
@@ -217,7 +222,17 @@ namespace {
 
     class GameMcpClient {
     public:
-        explicit GameMcpClient(BridgeConfig config) : config_(std::move(config)) {}
+        using NotificationHandler = std::function<void(const json& notification)>;
+
+        GameMcpClient(BridgeConfig config, NotificationHandler onNotification)
+        : config_(std::move(config)),
+          onNotification_(std::move(onNotification)) {}
+
+        // The reader calls onNotification_, so it must be gone before the handler's owner is.
+        ~GameMcpClient() { stopEventStream(); }
+
+        GameMcpClient(const GameMcpClient&)            = delete;
+        GameMcpClient& operator=(const GameMcpClient&) = delete;
 
         json callTool(const std::string& name, const json& arguments) {
             std::string error;
@@ -236,8 +251,7 @@ namespace {
                     response,
                     error
                 )) {
-                connected_ = false;
-                sessionId_.clear();
+                resetSession();
                 if (!ensureConnected(error)) {
                     return makeToolErrorResult(error);
                 }
@@ -251,8 +265,7 @@ namespace {
                         response,
                         error
                     )) {
-                    connected_ = false;
-                    sessionId_.clear();
+                    resetSession();
                     return makeToolErrorResult(error);
                 }
             }
@@ -278,17 +291,143 @@ namespace {
                     "MCDK game MCP returned an invalid response: " + dumpJsonReplacingInvalidUtf8(response)
                 );
             }
+            if (name == mcdk::mcp_tool_definitions::SubscribeLogsName && !response["result"].value("isError", false)) {
+                followEventStream();
+            }
             return response["result"];
         }
 
     private:
+        // One reader per game session; a new session (or a stream the server ended) gets a new one.
+        struct EventStream {
+            std::atomic<bool>       cancelled = false;
+            std::atomic<bool>       finished  = false;
+            std::mutex              mutex;
+            std::condition_variable wake;
+            httplib::Client*        client = nullptr; // The reader's current connection, guarded by mutex.
+            std::thread             thread;
+
+            // Shuts the open connection down so a reader blocked on the socket returns immediately.
+            void cancel() {
+                std::lock_guard lock(mutex);
+                cancelled = true;
+                if (client) {
+                    client->stop();
+                }
+                wake.notify_all();
+            }
+        };
+
         bool ensureConnected(std::string& error) {
             if (connected_ && ping()) {
                 return true;
             }
+            resetSession();
+            return initialize(error);
+        }
+
+        void resetSession() {
             connected_ = false;
             sessionId_.clear();
-            return initialize(error);
+            stopEventStream();
+        }
+
+        void stopEventStream() {
+            if (!eventStream_) {
+                return;
+            }
+            eventStream_->cancel();
+            if (eventStream_->thread.joinable()) {
+                eventStream_->thread.join();
+            }
+            eventStream_.reset();
+        }
+
+        // Relays the session's server-sent notifications (pushed log lines) to stdout. Cancelling the stream shuts
+        // its socket down, so the reader can be joined without waiting for the next event or heartbeat.
+        void followEventStream() {
+            if (eventStream_ && !eventStream_->finished) {
+                return;
+            }
+            stopEventStream();
+            eventStream_         = std::make_unique<EventStream>();
+            eventStream_->thread =
+                std::thread(readEventStream, eventStream_.get(), baseUrl(), sessionId_, onNotification_);
+        }
+
+        static void readEventStream(
+            EventStream*        stream,
+            std::string         url,
+            std::string         sessionId,
+            NotificationHandler onNotification
+        ) {
+            std::string pending;
+            const auto  onData = [&](const char* data, size_t length) {
+                for (size_t index = 0; index < length; ++index) {
+                    if (data[index] != '\r') {
+                        pending += data[index];
+                    }
+                }
+                for (auto end = pending.find("\n\n"); end != std::string::npos; end = pending.find("\n\n")) {
+                    dispatchEvent(std::string_view(pending).substr(0, end), onNotification);
+                    pending.erase(0, end + 2);
+                }
+                return !stream->cancelled;
+            };
+
+            while (!stream->cancelled) {
+                httplib::Client client(url);
+                client.set_connection_timeout(ConnectTimeoutSeconds, 0);
+                client.set_read_timeout(EventStreamTimeoutSec, 0);
+                {
+                    std::lock_guard lock(stream->mutex);
+                    if (stream->cancelled) {
+                        break;
+                    }
+                    stream->client = &client;
+                }
+                pending.clear();
+                const auto result = client.Get(
+                    StreamableEndpoint,
+                    httplib::Headers{{"Mcp-Session-Id", sessionId}, {"Accept", "text/event-stream"}},
+                    onData
+                );
+                std::unique_lock lock(stream->mutex);
+                stream->client = nullptr;
+                // The game is gone or no longer knows the session: the next tool call reconnects and resubscribes.
+                if (stream->cancelled || (result && result->status == 404)
+                    || (!result && result.error() == httplib::Error::Connection)) {
+                    break;
+                }
+                stream->wake.wait_for(lock, std::chrono::seconds(1), [stream] { return stream->cancelled.load(); });
+            }
+            stream->finished = true;
+        }
+
+        static void dispatchEvent(std::string_view event, const NotificationHandler& onNotification) {
+            std::string payload;
+            while (!event.empty()) {
+                const auto end  = event.find('\n');
+                auto       line = event.substr(0, end);
+                event.remove_prefix(end == std::string_view::npos ? event.size() : end + 1);
+                if (line.starts_with("data:")) {
+                    line.remove_prefix(5);
+                    if (line.starts_with(' ')) {
+                        line.remove_prefix(1);
+                    }
+                    if (!payload.empty()) {
+                        payload += '\n';
+                    }
+                    payload += line;
+                }
+            }
+            if (payload.empty()) {
+                return; // Heartbeat comment.
+            }
+            const auto message = json::parse(payload, nullptr, false);
+            if (message.is_object() && message.contains("method")) {
+                onNotification(message);
+            }
         }
 
         bool initialize(std::string& error) {
@@ -390,20 +529,22 @@ namespace {
                  + baseUrl() + StreamableEndpoint + ". Detail: " + detail;
         }
 
-        BridgeConfig config_;
-        std::string  sessionId_;
-        bool         connected_ = false;
-        int          nextId_    = 1;
+        BridgeConfig                 config_;
+        NotificationHandler          onNotification_;
+        std::string                  sessionId_;
+        bool                         connected_ = false;
+        int                          nextId_    = 1;
+        std::unique_ptr<EventStream> eventStream_;
     };
 
     class BridgeServer {
     public:
-        explicit BridgeServer(BridgeConfig config) : gameClient_(std::move(config)) {}
+        explicit BridgeServer(BridgeConfig config)
+        : gameClient_(std::move(config), [this](const json& notification) { transport_.writeMessage(notification); }) {}
 
         void run() {
-            StdioTransport transport;
             while (true) {
-                auto message = transport.readMessage();
+                auto message = transport_.readMessage();
                 if (!message.has_value()) {
                     break;
                 }
@@ -412,7 +553,7 @@ namespace {
                 }
                 auto response = handleMessage(*message);
                 if (response.has_value()) {
-                    transport.writeMessage(*response);
+                    transport_.writeMessage(*response);
                 }
             }
         }
@@ -438,12 +579,12 @@ namespace {
                     id,
                     json{
                         {"protocolVersion", mcp::MCP_VERSION},
-                        {"capabilities", {{"tools", json::object()}}},
+                        {"capabilities", {{"tools", json::object()}, {"logging", json::object()}}},
                         {"serverInfo", {{"name", BridgeName}, {"version", BridgeVersion}}}
                     }
                 );
             }
-            if (method == "ping") {
+            if (method == "ping" || method == "logging/setLevel") {
                 return makeSuccessResponse(id, json::object());
             }
             if (method == "tools/list") {
@@ -506,7 +647,8 @@ namespace {
             return makeErrorResponse(id, mcp::error_code::method_not_found, "Method not found: " + method);
         }
 
-        GameMcpClient gameClient_;
+        StdioTransport transport_; // Shared with the event stream reader, which writes notifications.
+        GameMcpClient  gameClient_;
     };
 
 } // namespace
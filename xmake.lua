@@ -145,6 +145,7 @@ if has_config("build_mcdk") then
         set_languages("c++23")
         add_files(
             "tools/mcdk/src/config.cpp",
+            "tools/mcdk/src/console_writer.cpp",
             "tools/mcdk/src/env.cpp",
             "tools/mcdk/src/hotreload.cpp",
             "tools/mcdk/src/ipc_code_execution.cpp",
@@ -153,12 +154,19 @@ if has_config("build_mcdk") then
             "tools/mcdk/src/jsonui_reload_support.cpp",
             "tools/mcdk/src/level.cpp",
             "tools/mcdk/src/log_buffer.cpp",
+            "tools/mcdk/src/log_classifier.cpp",
+            "tools/mcdk/src/log_collapse.cpp",
+            "tools/mcdk/src/log_search.cpp",
+            "tools/mcdk/src/log_spool.cpp",
+            "tools/mcdk/src/log_stream.cpp",
             "tools/mcdk/src/mcp_tool_definitions.cpp",
             "tools/mcdk/src/mod_dir_config.cpp",
             "tools/mcdk/src/mod_register.cpp",
+            "tools/mcdk/src/output_capture.cpp",
             "tools/mcdk/src/reload_code.cpp",
             "tools/mcdk/src/rpc_registry.cpp",
             "tools/mcdk/src/style_processor.cpp",
+            "tools/mcdk/src/traceback_aggregator.cpp",
             "tools/mcdk/src/utils.cpp",
             "tools/mcdk/src/world_project.cpp"
         )